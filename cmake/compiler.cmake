@@ -4,6 +4,13 @@ set(CMAKE_CXX_STANDARD_REQUIRED TRUE)
 set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAG} -mavx2")
 
 ## Global compile definitions
+option(KORIN_BUILD_TRACE "If true compile scoped timers in" OFF)
+
+if(KORIN_BUILD_TRACE)
+
+	add_compile_definitions("BUILD_TRACE=1")
+
+endif(KORIN_BUILD_TRACE)
 
 ## Per configuration compile definitions
 set(CMAKE_CXX_FLAGS_DEBUG			"${CMAKE_CXX_FLAGS_DEBUG} -DBUILD_DEBUG -ggdb -O0")
@@ -0,0 +1,540 @@
+#include "hal/file.h"
+#include "hal/platform_math.h"
+#include "hal/platform_memory.h"
+#include "hal/memory_base.h"
+
+#if PLATFORM_LINUX
+	#include <errno.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+	#include <linux/io_uring.h>
+
+	#define FILE_USE_IO_URING 1
+#else
+	#define FILE_USE_IO_URING 0
+#endif
+
+/// Buffers are page aligned
+static constexpr sizet fileBufferAlignment = 4096;
+
+File::File()
+	: handle{PlatformFiles::invalidHandle}
+	, malloc{gMalloc}
+	, buffer{nullptr}
+	, bufferSize{0}
+	, bufferPos{0}
+	, bufferEnd{0}
+	, filePos{0}
+	, writing{false}
+	, error{false}
+	, hint{FileAccessHint::Normal}
+{
+	//
+}
+
+File::File(const ansichar * path, FileOpenMode mode, uint64 inBufferSize)
+	: File{}
+{
+	open(path, mode, inBufferSize);
+}
+
+File::File(File && other)
+	: handle{other.handle}
+	, malloc{other.malloc}
+	, buffer{other.buffer}
+	, bufferSize{other.bufferSize}
+	, bufferPos{other.bufferPos}
+	, bufferEnd{other.bufferEnd}
+	, filePos{other.filePos}
+	, writing{other.writing}
+	, error{other.error}
+	, hint{other.hint}
+{
+	other.handle = PlatformFiles::invalidHandle;
+	other.buffer = nullptr;
+	other.bufferSize = other.bufferPos = other.bufferEnd = 0;
+	other.writing = false;
+}
+
+File::~File()
+{
+	close();
+	if (buffer) malloc->free(buffer);
+}
+
+bool File::open(const ansichar * path, FileOpenMode mode, uint64 inBufferSize)
+{
+	close();
+
+	handle = PlatformFiles::open(path, mode);
+	if (!isOpen()) return false;
+
+	// Reuse buffer if possible
+	inBufferSize = PlatformMath::max(inBufferSize, 1ull);
+	if (inBufferSize != bufferSize)
+	{
+		if (buffer) malloc->free(buffer);
+		buffer = static_cast<ubyte*>(malloc->alloc(inBufferSize, fileBufferAlignment));
+		bufferSize = inBufferSize;
+	}
+
+	bufferPos = bufferEnd = 0;
+	filePos = mode == FileOpenMode::Append ? PlatformMath::max(PlatformFiles::getSize(handle), 0ll) : 0;
+	writing = false;
+	error = false;
+	hint = FileAccessHint::Normal;
+
+	return true;
+}
+
+bool File::close()
+{
+	if (!isOpen()) return !error;
+
+	flush();
+	if (!PlatformFiles::close(handle)) error = true;
+
+	handle = PlatformFiles::invalidHandle;
+	bufferPos = bufferEnd = filePos = 0;
+
+	return !error;
+}
+
+uint64 File::getSize() const
+{
+	const int64 size = PlatformFiles::getSize(handle);
+	return PlatformMath::max(static_cast<uint64>(PlatformMath::max(size, 0ll)), tell());
+}
+
+bool File::seek(uint64 pos)
+{
+	if (writing)
+	{
+		if (!flush()) return false;
+	}
+	else if (pos <= filePos && pos >= filePos - bufferEnd)
+	{
+		// Seek inside the buffer
+		bufferPos = pos - (filePos - bufferEnd);
+		return true;
+	}
+
+	if (!PlatformFiles::seek(handle, pos)) return false;
+
+	bufferPos = bufferEnd = 0;
+	filePos = pos;
+
+	return true;
+}
+
+uint64 File::read(void * dst, uint64 size)
+{
+	if (writing && !flush()) return 0;
+
+	ubyte * out = static_cast<ubyte*>(dst);
+	uint64 numRead = 0;
+
+	while (numRead < size)
+	{
+		if (bufferPos == bufferEnd)
+		{
+			if (size - numRead >= bufferSize)
+			{
+				// Large reads skip the buffer
+				const int64 n = PlatformFiles::read(handle, out + numRead, size - numRead);
+				if (n < 0) error = true;
+				if (n <= 0) break;
+
+				numRead += n;
+				filePos += n;
+				bufferPos = bufferEnd = 0;
+
+				continue;
+			}
+
+			if (!fillBuffer()) break;
+		}
+
+		const uint64 n = PlatformMath::min(bufferEnd - bufferPos, size - numRead);
+		Memory::memcpy(out + numRead, buffer + bufferPos, n);
+		bufferPos += n;
+		numRead += n;
+	}
+
+	return numRead;
+}
+
+bool File::readInto(StringView & outView, uint64 maxSize)
+{
+	if (writing && !flush()) return false;
+
+	if (bufferPos == bufferEnd && !fillBuffer())
+	{
+		outView = StringView{};
+		return false;
+	}
+
+	const uint64 n = PlatformMath::min(bufferEnd - bufferPos, maxSize);
+	outView = StringView{reinterpret_cast<const ansichar*>(buffer + bufferPos), n};
+	bufferPos += n;
+
+	return n > 0;
+}
+
+uint64 File::readAll(String & out)
+{
+	// Drop the terminator while reading
+	Array<ansichar> & array = out.getArray();
+	array.resize(out.getLength());
+
+	const uint64 numRead = readAll(array);
+	array.resize(array.getCount() + 1);
+	array[array.getCount() - 1] = '\0';
+
+	return numRead;
+}
+
+uint64 File::write(const void * src, uint64 size)
+{
+	if (!writing && !beginWrite()) return 0;
+
+	if (bufferEnd + size > bufferSize)
+	{
+		if (!flush()) return 0;
+
+		if (size >= bufferSize)
+		{
+			// Large writes skip the buffer
+			const int64 n = PlatformFiles::write(handle, src, size);
+			if (n < 0)
+			{
+				error = true;
+				return 0;
+			}
+
+			filePos += n;
+			return n;
+		}
+	}
+
+	Memory::memcpy(buffer + bufferEnd, src, size);
+	bufferEnd += size;
+
+	return size;
+}
+
+bool File::flush()
+{
+	if (!writing || bufferEnd == 0) return !error;
+
+	const int64 n = PlatformFiles::write(handle, buffer, bufferEnd);
+	if (n < 0 || static_cast<uint64>(n) != bufferEnd) error = true;
+	else filePos += n;
+
+	bufferEnd = 0;
+	return !error;
+}
+
+int64 File::writeAt(const void * src, uint64 size, uint64 offset)
+{
+	// Buffered writes may overlap
+	if (!flush()) return -1;
+	return PlatformFiles::writeAt(handle, src, size, offset);
+}
+
+void File::setAccessHint(FileAccessHint inHint)
+{
+	hint = inHint;
+	PlatformFiles::advise(handle, hint);
+}
+
+bool File::beginWrite()
+{
+	const uint64 pos = tell();
+	if (bufferEnd > 0 && !PlatformFiles::seek(handle, pos)) return false;
+
+	bufferPos = bufferEnd = 0;
+	filePos = pos;
+	writing = true;
+
+	return true;
+}
+
+bool File::fillBuffer()
+{
+	writing = false;
+	bufferPos = bufferEnd = 0;
+
+	const int64 n = PlatformFiles::read(handle, buffer, bufferSize);
+	if (n < 0) error = true;
+	if (n <= 0) return false;
+
+	bufferEnd = n;
+	filePos += n;
+
+	// Start reading the next chunk
+	if (hint == FileAccessHint::Sequential && bufferEnd == bufferSize) prefetch(filePos, bufferSize);
+
+	return true;
+}
+
+#if FILE_USE_IO_URING
+/**
+ * Submission and completion rings of an
+ * io_uring instance, mapped from the
+ * kernel.
+ */
+struct AsyncFileIO::Ring
+{
+	/// Ring file descriptor
+	int32 fd;
+
+	/// Max number of requests in flight
+	uint32 numEntries;
+
+	/// Submission ring
+	uint32 * sqHead, * sqTail, * sqMask, * sqArray;
+	io_uring_sqe * sqes;
+
+	/// Completion ring
+	uint32 * cqHead, * cqTail, * cqMask;
+	io_uring_cqe * cqes;
+
+	/// Mapped memory
+	void * sqRing, * cqRing;
+	sizet sqRingSize, cqRingSize, sqesSize;
+
+	/**
+	 * Creates a ring, returns null if not
+	 * supported.
+	 */
+	static Ring * create(uint32 queueDepth)
+	{
+		io_uring_params params;
+		Memory::memset(&params, 0, sizeof(params));
+
+		const int32 fd = ::syscall(__NR_io_uring_setup, queueDepth, &params);
+		if (fd < 0) return nullptr;
+
+		Ring * ring = new Ring;
+		ring->fd = fd;
+		ring->numEntries = PlatformMath::min(params.sq_entries, params.cq_entries);
+		ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+		ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+		// Both rings may share one mapping
+		const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+		if (singleMap) ring->sqRingSize = ring->cqRingSize = PlatformMath::max(ring->sqRingSize, ring->cqRingSize);
+
+		ring->sqRing = ::mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		ring->cqRing = singleMap ? ring->sqRing : ::mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		ring->sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+
+		if (ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || ring->sqes == MAP_FAILED)
+		{
+			delete ring;
+			return nullptr;
+		}
+
+		ubyte * sq = static_cast<ubyte*>(ring->sqRing);
+		ring->sqHead = reinterpret_cast<uint32*>(sq + params.sq_off.head);
+		ring->sqTail = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+		ring->sqMask = reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+		ring->sqArray = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+
+		ubyte * cq = static_cast<ubyte*>(ring->cqRing);
+		ring->cqHead = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+		ring->cqTail = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+		ring->cqMask = reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+		ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+		return ring;
+	}
+
+	/**
+	 * Unmaps the rings.
+	 */
+	~Ring()
+	{
+		if (sqes != MAP_FAILED) ::munmap(sqes, sqesSize);
+		if (cqRing != MAP_FAILED && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+		if (sqRing != MAP_FAILED) ::munmap(sqRing, sqRingSize);
+		::close(fd);
+	}
+};
+#else
+struct AsyncFileIO::Ring
+{
+	static FORCE_INLINE Ring * create(uint32 queueDepth)
+	{
+		return nullptr;
+	}
+};
+#endif
+
+AsyncFileIO::AsyncFileIO(uint32 queueDepth, bool useIoUring)
+	: ring{useIoUring ? Ring::create(PlatformMath::max(queueDepth, 1u)) : nullptr}
+{
+	//
+}
+
+AsyncFileIO::~AsyncFileIO()
+{
+	delete ring;
+}
+
+bool AsyncFileIO::read(const File & file, FileIORequest * requests, uint64 n)
+{
+	return ring ? runRing(file.getHandle(), requests, n, false) : runBlocking(file.getHandle(), requests, n, false);
+}
+
+bool AsyncFileIO::write(File & file, FileIORequest * requests, uint64 n)
+{
+	if (!file.flush()) return false;
+	return ring ? runRing(file.getHandle(), requests, n, true) : runBlocking(file.getHandle(), requests, n, true);
+}
+
+bool AsyncFileIO::runBlocking(File::FileHandle handle, FileIORequest * requests, uint64 n, bool isWrite)
+{
+	bool ok = true;
+	for (uint64 i = 0; i < n; ++i)
+	{
+		FileIORequest & request = requests[i];
+		request.result = isWrite
+			? PlatformFiles::writeAt(handle, request.data, request.size, request.offset)
+			: PlatformFiles::readAt(handle, request.data, request.size, request.offset);
+		ok &= request.result >= 0;
+	}
+
+	return ok;
+}
+
+bool AsyncFileIO::runRing(File::FileHandle handle, FileIORequest * requests, uint64 n, bool isWrite)
+{
+#if FILE_USE_IO_URING
+	// Requests larger than this are split
+	// by the blocking fallback
+	constexpr uint64 maxRequestSize = 1u << 30;
+
+	uint64 numSubmitted = 0, numCompleted = 0;
+	uint32 numInFlight = 0;
+	bool ok = true;
+
+	// Mark requests as not completed
+	for (uint64 i = 0; i < n; ++i) requests[i].result = -ECANCELED;
+
+	// Reaps the available completions
+	auto reap = [&]() {
+
+		uint32 head = *ring->cqHead;
+		const uint32 cqTail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+		for (; head != cqTail; ++head, ++numCompleted, --numInFlight)
+		{
+			const io_uring_cqe & cqe = ring->cqes[head & *ring->cqMask];
+			FileIORequest & request = requests[cqe.user_data];
+
+			if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP)
+			{
+				// Opcode not supported by kernel
+				runBlocking(handle, &request, 1, isWrite);
+			}
+			else if (cqe.res > 0 && static_cast<uint64>(cqe.res) < request.size)
+			{
+				// Finish short transfers
+				FileIORequest rest;
+				rest.data = static_cast<ubyte*>(request.data) + cqe.res;
+				rest.size = request.size - cqe.res;
+				rest.offset = request.offset + cqe.res;
+				runBlocking(handle, &rest, 1, isWrite);
+
+				request.result = rest.result < 0 ? rest.result : cqe.res + rest.result;
+			}
+			else request.result = cqe.res;
+
+			ok &= request.result >= 0;
+		}
+
+		__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+	};
+
+	// Submits entries not yet consumed by
+	// the kernel and waits for one, returns
+	// false if the ring is unusable
+	auto enter = [&](uint32 numToSubmit) {
+
+		const int32 res = ::syscall(__NR_io_uring_enter, ring->fd, numToSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+		return res >= 0 || errno == EINTR || errno == EAGAIN || errno == EBUSY;
+	};
+
+	while (numCompleted < n)
+	{
+		// Fill the submission ring
+		uint32 tail = *ring->sqTail;
+		for (; numSubmitted < n && numInFlight < ring->numEntries; ++numSubmitted, ++numInFlight, ++tail)
+		{
+			const FileIORequest & request = requests[numSubmitted];
+			const uint32 idx = tail & *ring->sqMask;
+
+			io_uring_sqe * sqe = ring->sqes + idx;
+			Memory::memset(sqe, 0, sizeof(*sqe));
+			sqe->opcode = isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+			sqe->fd = handle;
+			sqe->off = request.offset;
+			sqe->addr = reinterpret_cast<uintp>(request.data);
+			sqe->len = PlatformMath::min(request.size, maxRequestSize);
+			sqe->user_data = numSubmitted;
+
+			ring->sqArray[idx] = idx;
+		}
+
+		__atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+
+		const uint32 sqHead = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+		if (UNLIKELY(!enter(tail - sqHead)))
+		{
+			// Take back the entries the kernel
+			// didn't consume. It only consumes
+			// them inside io_uring_enter
+			const uint32 numUnconsumed = tail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+			__atomic_store_n(ring->sqTail, tail - numUnconsumed, __ATOMIC_RELEASE);
+			numSubmitted -= numUnconsumed;
+			numInFlight -= numUnconsumed;
+
+			// Wait for the requests owned by
+			// the kernel, so that none of them
+			// completes after we return
+			reap();
+			while (numInFlight > 0 && enter(0)) reap();
+
+			// Never reuse the ring, it may
+			// still hold completions
+			delete ring;
+			ring = nullptr;
+
+			if (numInFlight > 0)
+			{
+				// The kernel may still run them,
+				// they can't be run again
+				for (uint64 i = 0; i < numSubmitted; ++i)
+				{
+					if (requests[i].result == -ECANCELED) requests[i].result = -EIO;
+				}
+
+				ok = false;
+			}
+
+			// Run the requests the kernel never
+			// saw with blocking calls
+			return runBlocking(handle, requests + numSubmitted, n - numSubmitted, isWrite) && ok;
+		}
+
+		reap();
+	}
+
+	return ok;
+#else
+	return runBlocking(handle, requests, n, isWrite);
+#endif
+}
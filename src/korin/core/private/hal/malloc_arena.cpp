@@ -0,0 +1,173 @@
+#include "hal/malloc_arena.h"
+#include "hal/platform_math.h"
+#include "hal/platform_memory.h"
+#include "misc/assert.h"
+#include "profiling/scoped_timer.h"
+
+MallocArena::MallocArena(sizet inBlockSize, MallocBase * inMalloc)
+	: malloc{inMalloc}
+	, blockSize{PlatformMath::max(inBlockSize, sizeof(Block) * 2)}
+	, blocks{nullptr}
+	, cursor{nullptr}
+	, limit{nullptr}
+	, lastAlloc{nullptr}
+	, numBytes{0}
+{
+	//
+}
+
+MallocArena::MallocArena(MallocArena && other)
+	: malloc{other.malloc}
+	, blockSize{other.blockSize}
+	, blocks{other.blocks}
+	, cursor{other.cursor}
+	, limit{other.limit}
+	, lastAlloc{other.lastAlloc}
+	, numBytes{other.numBytes}
+{
+	other.blocks = nullptr;
+	other.cursor = other.limit = nullptr;
+	other.lastAlloc = nullptr;
+	other.numBytes = 0;
+}
+
+MallocArena & MallocArena::operator=(MallocArena && other)
+{
+	if (this != &other)
+	{
+		reset();
+
+		malloc = other.malloc;
+		blockSize = other.blockSize;
+		blocks = other.blocks;
+		cursor = other.cursor;
+		limit = other.limit;
+		lastAlloc = other.lastAlloc;
+		numBytes = other.numBytes;
+
+		other.blocks = nullptr;
+		other.cursor = other.limit = nullptr;
+		other.lastAlloc = nullptr;
+		other.numBytes = 0;
+	}
+
+	return *this;
+}
+
+MallocArena::~MallocArena()
+{
+	reset();
+}
+
+void MallocArena::reset()
+{
+	while (blocks)
+	{
+		Block * next = blocks->next;
+		malloc->free(blocks);
+		blocks = next;
+	}
+
+	cursor = limit = nullptr;
+	lastAlloc = nullptr;
+	numBytes = 0;
+}
+
+void MallocArena::absorb(MallocArena & other)
+{
+	if (!other.blocks) return;
+
+	CHECKF(malloc == other.malloc, "Arenas must use the same allocator")
+
+	if (!blocks)
+	{
+		// Take over the current block too
+		blocks = other.blocks;
+		cursor = other.cursor;
+		limit = other.limit;
+	}
+	else
+	{
+		// Insert after our current block
+		Block * tail = other.blocks;
+		while (tail->next) tail = tail->next;
+
+		tail->next = blocks->next;
+		blocks->next = other.blocks;
+	}
+
+	numBytes += other.numBytes;
+
+	other.blocks = nullptr;
+	other.cursor = other.limit = nullptr;
+	other.lastAlloc = nullptr;
+	other.numBytes = 0;
+}
+
+void * MallocArena::realloc(void * orig, sizet size, sizet alignment)
+{
+	if (!orig) return alloc(size, alignment);
+
+	if (orig == lastAlloc && static_cast<ubyte*>(orig) + size <= limit)
+	{
+		// Grow or shrink last allocation in
+		// place
+		numBytes += size - (cursor - static_cast<ubyte*>(orig));
+		cursor = static_cast<ubyte*>(orig) + size;
+
+		return orig;
+	}
+
+	// The size of orig is unknown, copy up
+	// to the end of the used part of the
+	// block it lives in
+	Block * block = blocks;
+	while (block && !(orig > static_cast<void*>(block) && orig < static_cast<void*>(reinterpret_cast<ubyte*>(block) + block->size))) block = block->next;
+
+	const ubyte * origEnd = block == blocks ? cursor : reinterpret_cast<ubyte*>(block) + (block ? block->size : 0);
+	const sizet origAvail = block ? origEnd - static_cast<ubyte*>(orig) : 0;
+
+	void * out = alloc(size, alignment);
+	if (out) Memory::memmov(out, orig, PlatformMath::min(size, origAvail));
+
+	return out;
+}
+
+void MallocArena::free(void * orig)
+{
+	// Memory is released all at once
+}
+
+void * MallocArena::allocSlow(sizet size, sizet alignment)
+{
+	SCOPED_TIMER("MallocArena::allocSlow");
+
+	const sizet headerSize = (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+	const sizet newBlockSize = PlatformMath::max(blockSize, headerSize + size);
+
+	Block * block = static_cast<Block*>(malloc->alloc(newBlockSize, PlatformMath::max(alignment, sizet(alignof(Block)))));
+	if (UNLIKELY(!block)) return nullptr;
+
+	block->size = newBlockSize;
+
+	ubyte * out = reinterpret_cast<ubyte*>(block) + headerSize;
+	numBytes += size;
+
+	if (blocks && newBlockSize > blockSize && limit - cursor > static_cast<int64>(blockSize / 4))
+	{
+		// Large allocation, keep bumping in
+		// the current block
+		block->next = blocks->next;
+		blocks->next = block;
+		lastAlloc = nullptr;
+
+		return out;
+	}
+
+	block->next = blocks;
+	blocks = block;
+	cursor = out + size;
+	limit = reinterpret_cast<ubyte*>(block) + newBlockSize;
+
+	return lastAlloc = out;
+}
@@ -1,4 +1,5 @@
 #include "hal/malloc_binned.h"
+#include "profiling/scoped_timer.h"
 
 //////////////////////////////////////////////////
 // MallocBinned
@@ -41,14 +42,51 @@ void * MallocBinned::alloc(sizet size, sizet alignment)
 	}
 }
 
+MallocBinned::~MallocBinned()
+{
+	for (uint32 i = 0; i < numBuckets; ++i)
+		delete buckets[i];
+}
+
 void * MallocBinned::realloc(void * orig, sizet size, sizet alignment)
 {
-	// TODO
+	if (!orig)
+		return alloc(size, alignment);
+
+	if (size == 0)
+	{
+		free(orig);
+		return nullptr;
+	}
+
+	for (uint32 i = 0; i < numBuckets; ++i)
+	{
+		MallocPooled * bucket = buckets[i];
+		if (bucket->hasBlock(orig))
+		{
+			// Keep block if it still fits
+			if (size <= bucket->poolInfo.blockSize && alignment <= bucket->poolInfo.blockAlignment)
+				return orig;
+
+			// Move to another bucket
+			void * out = alloc(size, alignment);
+			if (out)
+			{
+				Memory::memcpy(out, orig, PlatformMath::min(size, bucket->poolInfo.blockSize));
+				bucket->free(orig);
+			}
+
+			return out;
+		}
+	}
+
 	return nullptr;
 }
 
 void MallocBinned::free(void * orig)
 {
+	SCOPED_TIMER("MallocBinned::free");
+
 	// The only way is to ask each bucket
 	// whether it allocated the block
 	for (uint32 i = 0; i < numBuckets; ++i)
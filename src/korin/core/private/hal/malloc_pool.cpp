@@ -1,6 +1,7 @@
 #include "hal/malloc_pool.h"
 #include "misc/assert.h"
 #include "hal/platform_math.h"
+#include "profiling/scoped_timer.h"
 
 //////////////////////////////////////////////////
 // MemoryPool
@@ -205,6 +206,8 @@ void * MallocPooled::alloc(sizet size, sizet alignment)
 		// Create a new pool if necessary
 		if (pool->isExhausted())
 		{
+			SCOPED_TIMER("MallocPooled::createPool");
+
 			void * buffer = nullptr;
 			if (posix_memalign(&buffer, poolInfo.blockAlignment, poolAllocSize) == 0)
 				pool = createPool(buffer);
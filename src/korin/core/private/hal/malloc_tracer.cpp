@@ -0,0 +1,298 @@
+#include "hal/malloc_tracer.h"
+#include "hal/platform_math.h"
+#include "hal/platform_memory.h"
+#include "hal/file.h"
+#include "containers/map.h"
+
+namespace
+{
+	/**
+	 * Reads a varint, returns false if the
+	 * data ends.
+	 */
+	FORCE_INLINE bool getVarint(const ubyte *& it, const ubyte * end, uint64 & outValue)
+	{
+		outValue = 0;
+		for (uint32 shift = 0; it < end && shift < 64; shift += 7)
+		{
+			const ubyte byte = *it++;
+			outValue |= static_cast<uint64>(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Reads a pointer delta, returns false
+	 * if the data ends.
+	 */
+	FORCE_INLINE bool getPointer(const ubyte *& it, const ubyte * end, uintp & prevPtr, uintp & outPtr)
+	{
+		uint64 zigzag;
+		if (!getVarint(it, end, zigzag)) return false;
+
+		const int64 delta = static_cast<int64>(zigzag >> 1) ^ -static_cast<int64>(zigzag & 1);
+		outPtr = prevPtr += delta;
+
+		return true;
+	}
+} // namespace
+
+//////////////////////////////////////////////////
+// MallocTracer
+//////////////////////////////////////////////////
+
+MallocTracer::MallocTracer(MallocBase * inMalloc, File & inFile)
+	: malloc{inMalloc}
+	, file{inFile}
+	, lock{}
+	, prevPtr{0}
+	, numRecords{0}
+{
+	const ubyte header[] = {magic & 0xff, (magic >> 8) & 0xff, (magic >> 16) & 0xff, magic >> 24, version};
+	file.write(header, sizeof(header));
+}
+
+void * MallocTracer::alloc(sizet size, sizet alignment)
+{
+	ScopeLock<SpinLock> scope{lock};
+
+	void * out = malloc->alloc(size, alignment);
+	record(OpType::Alloc, alignment, nullptr, size, out);
+
+	return out;
+}
+
+void * MallocTracer::realloc(void * orig, sizet size, sizet alignment)
+{
+	ScopeLock<SpinLock> scope{lock};
+
+	void * out = malloc->realloc(orig, size, alignment);
+	record(OpType::Realloc, alignment, orig, size, out);
+
+	return out;
+}
+
+void MallocTracer::free(void * orig)
+{
+	ScopeLock<SpinLock> scope{lock};
+
+	malloc->free(orig);
+	record(OpType::Free, 0, orig, 0, nullptr);
+}
+
+void MallocTracer::record(OpType type, sizet alignment, const void * orig, sizet size, const void * out)
+{
+	// Op, two pointers and a size
+	ubyte buffer[1 + 3 * 10];
+	ubyte * it = buffer;
+
+	const ubyte alignmentLog2 = alignment ? PlatformMath::log2(static_cast<uint64>(alignment)) : 0;
+	*it++ = type | (alignmentLog2 << 2);
+
+	if (type != OpType::Alloc) it = putPointer(it, orig);
+	if (type != OpType::Free)
+	{
+		it = putVarint(it, size);
+		it = putPointer(it, out);
+	}
+
+	file.write(buffer, it - buffer);
+	++numRecords;
+}
+
+//////////////////////////////////////////////////
+// MallocTrace
+//////////////////////////////////////////////////
+
+MallocTrace::MallocTrace()
+	: ops{}
+	, numSlots{0}
+	, peakBytes{0}
+	, maxSize{0}
+{
+	//
+}
+
+bool MallocTrace::load(const ubyte * data, sizet size)
+{
+	ops.empty();
+	numSlots = 0;
+	peakBytes = 0;
+	maxSize = 0;
+
+	static constexpr uint32 magic = MallocTracer::magic;
+	if (size < 5 || data[0] != (magic & 0xff) || data[1] != ((magic >> 8) & 0xff) || data[2] != ((magic >> 16) & 0xff) || data[3] != (magic >> 24) || data[4] != MallocTracer::version)
+		return false;
+
+	// Live blocks, with slot and size
+	Map<uintp, Pair<uint32, sizet>> live;
+	Array<uint32> freeSlots;
+	uint64 liveBytes = 0;
+	uintp prevPtr = 0;
+
+	const ubyte * it = data + 5, * end = data + size;
+	while (it < end)
+	{
+		const ubyte op = *it++;
+		const ubyte type = op & 0x3;
+		const ubyte alignmentLog2 = op >> 2;
+
+		uintp orig = 0, out = 0;
+		uint64 requested = 0;
+
+		if (type != MallocTracer::Alloc && !getPointer(it, end, prevPtr, orig)) return false;
+		if (type != MallocTracer::Free && (!getVarint(it, end, requested) || !getPointer(it, end, prevPtr, out))) return false;
+		if (type < MallocTracer::Alloc) return false;
+
+		// Find the original block
+		Pair<uint32, sizet> block{~0u, sizet{0}};
+		if (orig) live.find(orig, block);
+
+		if (type == MallocTracer::Free || !out)
+		{
+			// A failed realloc keeps the block,
+			// unless it requested zero Bytes.
+			// Blocks allocated before tracing
+			// are skipped
+			if (block.first == ~0u || (type == MallocTracer::Realloc && requested > 0)) continue;
+
+			live.remove(orig);
+			liveBytes -= block.second;
+
+			ops.add(MallocTraceOp{0, block.first, MallocTracer::Free, 0});
+			freeSlots.add(block.first);
+			continue;
+		}
+
+		// Realloc of a block allocated before
+		// tracing is replayed as an alloc
+		MallocTracer::OpType replayType = static_cast<MallocTracer::OpType>(type);
+		uint32 slot = block.first;
+
+		if (slot != ~0u)
+		{
+			live.remove(orig);
+			liveBytes -= block.second;
+		}
+		else
+		{
+			replayType = MallocTracer::Alloc;
+			if (freeSlots.getCount()) freeSlots.popLast(slot);
+			else slot = numSlots++;
+		}
+
+		ops.add(MallocTraceOp{requested, slot, replayType, alignmentLog2});
+		live.insert(out, Pair<uint32, sizet>{slot, requested});
+
+		liveBytes += requested;
+		peakBytes = PlatformMath::max(peakBytes, liveBytes);
+		maxSize = PlatformMath::max(maxSize, requested);
+	}
+
+	return true;
+}
+
+bool MallocTrace::load(File & file)
+{
+	Array<ubyte> data;
+	file.readAll(data);
+
+	return load(*data, data.getCount());
+}
+
+//////////////////////////////////////////////////
+// MallocReplay
+//////////////////////////////////////////////////
+
+MallocReplay::MallocReplay(const MallocTrace & inTrace, MallocBase & inMalloc)
+	: trace{inTrace}
+	, malloc{inMalloc}
+	, slotMalloc{gMalloc}
+	, blocks{static_cast<void**>(slotMalloc->alloc(sizeof(void*) * (trace.getNumSlots() + 1)))}
+	, sizes{static_cast<sizet*>(slotMalloc->alloc(sizeof(sizet) * (trace.getNumSlots() + 1)))}
+	, next{0}
+	, numFailed{0}
+	, liveBytes{0}
+{
+	Memory::memset(blocks, 0, sizeof(void*) * trace.getNumSlots());
+	Memory::memset(sizes, 0, sizeof(sizet) * trace.getNumSlots());
+}
+
+MallocReplay::~MallocReplay()
+{
+	for (uint32 slot = 0; slot < trace.getNumSlots(); ++slot)
+	{
+		if (blocks[slot]) malloc.free(blocks[slot]);
+	}
+
+	slotMalloc->free(blocks);
+	slotMalloc->free(sizes);
+}
+
+uint64 MallocReplay::run(uint64 maxNumOps)
+{
+	const MallocTraceOp * ops = *trace.getOps();
+	const uint64 end = PlatformMath::min(next + maxNumOps, trace.getOps().getCount());
+	const uint64 begin = next;
+
+	for (; next < end; ++next)
+	{
+		const MallocTraceOp & op = ops[next];
+		void *& block = blocks[op.slot];
+		sizet & size = sizes[op.slot];
+
+		switch (op.type)
+		{
+			case MallocTracer::Alloc:
+			{
+				block = malloc.alloc(PlatformMath::max(op.size, sizet(1)), sizet(1) << op.alignmentLog2);
+				if (UNLIKELY(!block))
+				{
+					++numFailed;
+					break;
+				}
+
+				touch(block, 0, op.size);
+				liveBytes += size = op.size;
+				break;
+			}
+
+			case MallocTracer::Realloc:
+			{
+				if (UNLIKELY(!block))
+				{
+					++numFailed;
+					break;
+				}
+
+				void * out = malloc.realloc(block, PlatformMath::max(op.size, sizet(1)), sizet(1) << op.alignmentLog2);
+				if (UNLIKELY(!out))
+				{
+					++numFailed;
+					break;
+				}
+
+				if (op.size > size) touch(out, size, op.size);
+				liveBytes += op.size - size;
+
+				block = out;
+				size = op.size;
+				break;
+			}
+
+			case MallocTracer::Free:
+			{
+				if (block) malloc.free(block);
+				liveBytes -= size;
+
+				block = nullptr;
+				size = 0;
+				break;
+			}
+		}
+	}
+
+	return next - begin;
+}
@@ -0,0 +1,148 @@
+#include "profiling/perf_counters.h"
+
+#if PLATFORM_LINUX
+	#include <unistd.h>
+	#include <string.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+
+	#define PERF_USE_EVENT_OPEN 1
+#else
+	#define PERF_USE_EVENT_OPEN 0
+#endif
+
+#if PERF_USE_EVENT_OPEN
+namespace
+{
+	/**
+	 * Returns the perf type and config of
+	 * an event.
+	 */
+	void getPerfEventConfig(PerfEvent event, uint32 & outType, uint64 & outConfig)
+	{
+		// Config of cache events is id, op
+		// and result, one Byte each
+		static constexpr uint64 readMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+		switch (event)
+		{
+			case PerfEvent::Cycles: outType = PERF_TYPE_HARDWARE; outConfig = PERF_COUNT_HW_CPU_CYCLES; break;
+			case PerfEvent::Instructions: outType = PERF_TYPE_HARDWARE; outConfig = PERF_COUNT_HW_INSTRUCTIONS; break;
+			case PerfEvent::CacheMisses: outType = PERF_TYPE_HARDWARE; outConfig = PERF_COUNT_HW_CACHE_MISSES; break;
+			case PerfEvent::BranchMisses: outType = PERF_TYPE_HARDWARE; outConfig = PERF_COUNT_HW_BRANCH_MISSES; break;
+			case PerfEvent::L1DMisses: outType = PERF_TYPE_HW_CACHE; outConfig = PERF_COUNT_HW_CACHE_L1D | readMiss; break;
+			case PerfEvent::DTlbMisses: outType = PERF_TYPE_HW_CACHE; outConfig = PERF_COUNT_HW_CACHE_DTLB | readMiss; break;
+			case PerfEvent::PageFaults: outType = PERF_TYPE_SOFTWARE; outConfig = PERF_COUNT_SW_PAGE_FAULTS; break;
+			case PerfEvent::TaskClock: outType = PERF_TYPE_SOFTWARE; outConfig = PERF_COUNT_SW_TASK_CLOCK; break;
+			default: outType = PERF_TYPE_MAX; outConfig = 0; break;
+		}
+	}
+
+	/**
+	 * Opens a disabled counter for the
+	 * calling thread. Returns -1 if the
+	 * event is not supported.
+	 */
+	int32 openPerfEvent(PerfEvent event)
+	{
+		perf_event_attr attr;
+		::memset(&attr, 0, sizeof(attr));
+
+		attr.size = sizeof(attr);
+		getPerfEventConfig(event, attr.type, attr.config);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+		return fd < 0 ? -1 : static_cast<int32>(fd);
+	}
+} // namespace
+#endif
+
+PerfCounters::PerfCounters()
+	: values{}
+{
+	for (uint32 idx = 0; idx < numEvents; ++idx)
+	{
+#if PERF_USE_EVENT_OPEN
+		fds[idx] = openPerfEvent(static_cast<PerfEvent>(idx));
+#else
+		fds[idx] = -1;
+#endif
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+#if PERF_USE_EVENT_OPEN
+	for (uint32 idx = 0; idx < numEvents; ++idx)
+	{
+		if (fds[idx] >= 0) ::close(fds[idx]);
+	}
+#endif
+}
+
+bool PerfCounters::isAnyAvailable() const
+{
+	for (uint32 idx = 0; idx < numEvents; ++idx)
+	{
+		if (fds[idx] >= 0) return true;
+	}
+
+	return false;
+}
+
+void PerfCounters::start()
+{
+#if PERF_USE_EVENT_OPEN
+	for (uint32 idx = 0; idx < numEvents; ++idx)
+	{
+		if (fds[idx] < 0) continue;
+
+		::ioctl(fds[idx], PERF_EVENT_IOC_RESET, 0);
+		::ioctl(fds[idx], PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+}
+
+void PerfCounters::stop()
+{
+#if PERF_USE_EVENT_OPEN
+	for (uint32 idx = 0; idx < numEvents; ++idx)
+	{
+		if (fds[idx] >= 0) ::ioctl(fds[idx], PERF_EVENT_IOC_DISABLE, 0);
+	}
+
+	for (uint32 idx = 0; idx < numEvents; ++idx)
+	{
+		values[idx] = 0;
+		if (fds[idx] < 0) continue;
+
+		// Value, time enabled, time running
+		uint64 data[3];
+		if (::read(fds[idx], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+
+		// Scale multiplexed counters
+		values[idx] = data[2] < data[1] ? static_cast<uint64>(static_cast<float64>(data[0]) * data[1] / data[2]) : data[0];
+	}
+#endif
+}
+
+const ansichar * PerfCounters::getName(PerfEvent event)
+{
+	switch (event)
+	{
+		case PerfEvent::Cycles: return "cycles";
+		case PerfEvent::Instructions: return "instructions";
+		case PerfEvent::CacheMisses: return "cache-misses";
+		case PerfEvent::BranchMisses: return "branch-misses";
+		case PerfEvent::L1DMisses: return "l1d-misses";
+		case PerfEvent::DTlbMisses: return "dtlb-misses";
+		case PerfEvent::PageFaults: return "page-faults";
+		case PerfEvent::TaskClock: return "task-clock";
+		default: return "unknown";
+	}
+}
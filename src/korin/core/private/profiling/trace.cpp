@@ -0,0 +1,252 @@
+#include "profiling/trace.h"
+#include "hal/malloc_ansi.h"
+#include "hal/file.h"
+#include "serialization/json_writer.h"
+
+#include <string.h>
+#include <time.h>
+
+namespace
+{
+	/**
+	 * Trace buffers are allocated outside
+	 * of gMalloc, which may be traced.
+	 */
+	MallocAnsi traceMalloc;
+
+	/// Number of threads that recorded events
+	volatile uint32 numTraceThreads = 0;
+
+	/**
+	 * Returns the monotonic clock in
+	 * nanoseconds.
+	 */
+	uint64 getMonotonicNanoseconds()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+
+	/**
+	 * Reference points for the calibration
+	 * of the tick counter, taken at load
+	 * time.
+	 */
+	struct TraceClockOrigin
+	{
+		uint64 ticks = Trace::now();
+		uint64 ns = getMonotonicNanoseconds();
+	} traceClockOrigin;
+
+	/**
+	 * Allocates an empty chunk.
+	 */
+	TraceBuffer::Chunk * createChunk()
+	{
+		TraceBuffer::Chunk * chunk = static_cast<TraceBuffer::Chunk*>(traceMalloc.alloc(sizeof(TraceBuffer::Chunk), alignof(TraceBuffer::Chunk)));
+		chunk->next = nullptr;
+		chunk->numEvents = 0;
+
+		return chunk;
+	}
+
+	/**
+	 * Calls the given function with each
+	 * published event of a buffer.
+	 */
+	template<typename CallbackT>
+	void forEachEvent(const TraceBuffer * buffer, CallbackT && callback)
+	{
+		for (const TraceBuffer::Chunk * chunk = buffer->head; chunk; chunk = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&chunk->next))
+		{
+			const uint32 numEvents = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&chunk->numEvents);
+			for (uint32 idx = 0; idx < numEvents; ++idx) callback(chunk->events[idx]);
+		}
+	}
+} // namespace
+
+float64 Trace::getTicksPerSecond()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	static const float64 ticksPerSecond = []() {
+
+		// Wait until at least 10 ms passed
+		// since load, to reduce the error
+		uint64 ns = getMonotonicNanoseconds();
+		while (ns - traceClockOrigin.ns < 10000000ull) ns = getMonotonicNanoseconds();
+
+		return (now() - traceClockOrigin.ticks) * 1e9 / (ns - traceClockOrigin.ns);
+	}();
+
+	return ticksPerSecond;
+#else
+	return 1e9;
+#endif
+}
+
+void Trace::setThreadName(const ansichar * name)
+{
+	TraceBuffer * buffer = threadBuffer;
+	if (!buffer) buffer = createBuffer();
+
+	::strncpy(buffer->threadName, name, sizeof(buffer->threadName) - 1);
+}
+
+uint64 Trace::getNumEvents()
+{
+	uint64 numEvents = 0;
+	for (const TraceBuffer * buffer = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&buffers); buffer; buffer = buffer->next)
+	{
+		for (const TraceBuffer::Chunk * chunk = buffer->head; chunk; chunk = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&chunk->next))
+			numEvents += PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&chunk->numEvents);
+	}
+
+	return numEvents;
+}
+
+uint64 Trace::getNumDropped()
+{
+	uint64 numDropped = 0;
+	for (const TraceBuffer * buffer = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&buffers); buffer; buffer = buffer->next)
+		numDropped += PlatformAtomics::read<PlatformAtomics::AtomicOrder::Relaxed>(&buffer->numDropped);
+
+	return numDropped;
+}
+
+void Trace::reset()
+{
+	for (TraceBuffer * buffer = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&buffers); buffer; buffer = buffer->next)
+	{
+		// Keep the first chunk
+		TraceBuffer::Chunk * chunk = buffer->head->next;
+		while (chunk)
+		{
+			TraceBuffer::Chunk * next = chunk->next;
+			traceMalloc.free(chunk);
+			chunk = next;
+		}
+
+		buffer->head->next = nullptr;
+		buffer->head->numEvents = 0;
+		buffer->tail = buffer->head;
+		buffer->numChunks = 1;
+		buffer->numDropped = 0;
+	}
+}
+
+void Trace::collect(Map<String, TraceHistogram> & out)
+{
+	const float64 nsPerTick = 1e9 / getTicksPerSecond();
+
+	// Names are usually literals, look up
+	// each pointer once
+	Map<uintp, TraceHistogram*> histograms;
+
+	for (const TraceBuffer * buffer = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&buffers); buffer; buffer = buffer->next)
+	{
+		forEachEvent(buffer, [&](const TraceEvent & event) {
+
+			TraceHistogram *& histogram = histograms[reinterpret_cast<uintp>(event.name)];
+			if (!histogram) histogram = &out[String{event.name}];
+
+			histogram->add(static_cast<uint64>((event.end - event.begin) * nsPerTick));
+		});
+	}
+}
+
+void Trace::writeChromeTrace(JsonWriter & json)
+{
+	const float64 usPerTick = 1e6 / getTicksPerSecond();
+	const TraceBuffer * head = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Acquire>(&buffers);
+
+	// Timestamps are relative to the
+	// first event
+	uint64 origin = ~0ull;
+	for (const TraceBuffer * buffer = head; buffer; buffer = buffer->next)
+		forEachEvent(buffer, [&origin](const TraceEvent & event) { origin = PlatformMath::min(origin, event.begin); });
+
+	json.beginObject();
+	json.field("displayTimeUnit", "ns");
+	json.key("traceEvents").beginArray();
+
+	for (const TraceBuffer * buffer = head; buffer; buffer = buffer->next)
+	{
+		if (buffer->threadName[0])
+		{
+			json.beginObject();
+			json.field("name", "thread_name");
+			json.field("ph", "M");
+			json.field("pid", 1);
+			json.field("tid", buffer->threadId);
+			json.key("args").beginObject().field("name", static_cast<const ansichar*>(buffer->threadName)).endObject();
+			json.endObject();
+		}
+
+		forEachEvent(buffer, [&](const TraceEvent & event) {
+
+			json.beginObject();
+			json.field("name", event.name);
+			json.field("cat", "korin");
+			json.field("ph", "X");
+			json.field("pid", 1);
+			json.field("tid", buffer->threadId);
+			json.field("ts", (event.begin - origin) * usPerTick);
+			json.field("dur", (event.end - event.begin) * usPerTick);
+			json.endObject();
+		});
+	}
+
+	json.endArray();
+	json.endObject();
+}
+
+void Trace::exportChromeTrace(String & out)
+{
+	JsonWriter json{out};
+	writeChromeTrace(json);
+}
+
+void Trace::exportChromeTrace(File & out)
+{
+	JsonWriter json{out};
+	writeChromeTrace(json);
+}
+
+TraceBuffer * TraceRecorder::createBuffer()
+{
+	TraceBuffer * buffer = static_cast<TraceBuffer*>(traceMalloc.alloc(sizeof(TraceBuffer), alignof(TraceBuffer)));
+	buffer->head = buffer->tail = createChunk();
+	buffer->numChunks = 1;
+	buffer->numDropped = 0;
+	buffer->threadId = PlatformAtomics::add(&numTraceThreads, 1) + 1;
+	buffer->threadName[0] = '\0';
+
+	// Push to the global list, buffers are
+	// never removed so that the events of
+	// terminated threads are kept
+	TraceBuffer * next = PlatformAtomics::read<PlatformAtomics::AtomicOrder::Relaxed>(&buffers);
+	do buffer->next = next;
+	while (!__atomic_compare_exchange_n(&buffers, &next, buffer, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	return threadBuffer = buffer;
+}
+
+TraceBuffer::Chunk * TraceRecorder::addChunk(TraceBuffer * buffer)
+{
+	if (buffer->numChunks == TraceBuffer::maxNumChunks)
+	{
+		PlatformAtomics::store<PlatformAtomics::AtomicOrder::Relaxed>(&buffer->numDropped, buffer->numDropped + 1);
+		return nullptr;
+	}
+
+	TraceBuffer::Chunk * chunk = createChunk();
+	++buffer->numChunks;
+
+	// Readers may be walking the list,
+	// publish the chunk once it is empty
+	PlatformAtomics::store<PlatformAtomics::AtomicOrder::Release>(&buffer->tail->next, chunk);
+	buffer->tail = chunk;
+
+	return chunk;
+}
@@ -166,6 +166,8 @@ namespace Re
 
 	void Regex::compile(const ansichar * pattern, sizet patternLen)
 	{
+		SCOPED_TIMER("Regex::compile");
+
 		using SymbolT = typename Regex::State::SymbolT;
 		using AnyT = typename Regex::State::AnyT;
 		using RangeT = typename Regex::State::RangeT;
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "../core_types.h"
+#include "../templates/types.h"
+#include "../templates/utility.h"
+#include "../templates/iterator.h"
+
+/**
+ * Heap algorithms on random access
+ * ranges. Heaps are implicit d-ary
+ * trees stored in level order, the
+ * first item is the one that compares
+ * greatest, i.e. the max-heap with
+ * respect to the compare function.
+ * Pass an inverse compare function
+ * to obtain a min-heap.
+ *
+ * All functions are templated on the
+ * arity of the tree, which defaults
+ * to 2 (binary heap). Higher arities
+ * trade more comparisons during pop
+ * for shallower, more cache friendly
+ * trees.
+ */
+struct Heap
+{
+	/**
+	 * Returns the index of the parent
+	 * of the given item.
+	 *
+	 * @param idx index of child item
+	 * @return index of parent item
+	 */
+	template<uint32 arity = 2>
+	static constexpr FORCE_INLINE int64 getParent(int64 idx)
+	{
+		static_assert(arity > 1, "Heap arity must be at least 2");
+		return (idx - 1) / arity;
+	}
+
+	/**
+	 * Returns the index of the first
+	 * child of the given item.
+	 *
+	 * @param idx index of parent item
+	 * @return index of first child
+	 */
+	template<uint32 arity = 2>
+	static constexpr FORCE_INLINE int64 getFirstChild(int64 idx)
+	{
+		static_assert(arity > 1, "Heap arity must be at least 2");
+		return idx * arity + 1;
+	}
+
+	/**
+	 * Moves the item at the given index
+	 * up the heap until its parent is
+	 * greater or equal.
+	 *
+	 * @param begin first item of the heap
+	 * @param idx index of item to move
+	 * @param cmp compare function
+	 * @return final index of the item
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static int64 siftUp(It begin, int64 idx, CompareT && cmp)
+	{
+		using T = typename IteratorValue<It>::Type;
+
+		// Move items down rather than
+		// swapping, we fill the hole
+		// at the end
+		T item = move(*(begin + idx));
+		while (idx > 0)
+		{
+			const int64 parent = getParent<arity>(idx);
+			if (cmp(*(begin + parent), item) >= 0) break;
+
+			*(begin + idx) = move(*(begin + parent));
+			idx = parent;
+		}
+
+		*(begin + idx) = move(item);
+		return idx;
+	}
+
+	/**
+	 * Moves the item at the given index
+	 * down the heap until all its children
+	 * are smaller or equal.
+	 *
+	 * @param begin first item of the heap
+	 * @param count number of items in
+	 * 	the heap
+	 * @param idx index of item to move
+	 * @param cmp compare function
+	 * @return final index of the item
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static int64 siftDown(It begin, int64 count, int64 idx, CompareT && cmp)
+	{
+		using T = typename IteratorValue<It>::Type;
+
+		T item = move(*(begin + idx));
+		for (;;)
+		{
+			const int64 first = getFirstChild<arity>(idx);
+			if (first >= count) break;
+
+			// Find greatest child
+			const int64 last = first + arity < count ? first + arity : count;
+			int64 child = first;
+			for (int64 i = first + 1; i < last; ++i)
+				if (cmp(*(begin + i), *(begin + child)) > 0) child = i;
+
+			if (cmp(item, *(begin + child)) >= 0) break;
+
+			*(begin + idx) = move(*(begin + child));
+			idx = child;
+		}
+
+		*(begin + idx) = move(item);
+		return idx;
+	}
+
+	/**
+	 * Rearranges the items of the range
+	 * so that they form a heap, in O(N)
+	 * time.
+	 *
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static void make(It begin, It end, CompareT && cmp)
+	{
+		const int64 count = static_cast<int64>(end - begin);
+		if (count < 2) return;
+
+		// Sift down all internal nodes,
+		// starting from the last one
+		for (int64 idx = getParent<arity>(count - 1); idx >= 0; --idx)
+			siftDown<arity>(begin, count, idx, cmp);
+	}
+
+	/**
+	 * Given a heap in [begin, end - 1),
+	 * inserts the last item of the
+	 * range into the heap.
+	 *
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static FORCE_INLINE void push(It begin, It end, CompareT && cmp)
+	{
+		const int64 count = static_cast<int64>(end - begin);
+		if (count > 1) siftUp<arity>(begin, count - 1, cmp);
+	}
+
+	/**
+	 * Moves the greatest item to the end
+	 * of the range and rearranges the
+	 * remaining items into a heap.
+	 *
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static FORCE_INLINE void pop(It begin, It end, CompareT && cmp)
+	{
+		const int64 count = static_cast<int64>(end - begin);
+		if (count < 2) return;
+
+		swap(*begin, *(begin + (count - 1)));
+		siftDown<arity>(begin, count - 1, 0, cmp);
+	}
+
+	/**
+	 * Sorts a heap in ascending order,
+	 * in O(N log N) time.
+	 *
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static void sort(It begin, It end, CompareT && cmp)
+	{
+		for (int64 count = static_cast<int64>(end - begin); count > 1; --count)
+		{
+			swap(*begin, *(begin + (count - 1)));
+			siftDown<arity>(begin, count - 1, 0, cmp);
+		}
+	}
+
+	/**
+	 * Returns true if the range is
+	 * a valid heap.
+	 *
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 * @return true if range is a heap
+	 */
+	template<uint32 arity = 2, typename It, typename CompareT>
+	static bool isHeap(It begin, It end, CompareT && cmp)
+	{
+		const int64 count = static_cast<int64>(end - begin);
+		for (int64 idx = 1; idx < count; ++idx)
+			if (cmp(*(begin + getParent<arity>(idx)), *(begin + idx)) < 0) return false;
+
+		return true;
+	}
+};
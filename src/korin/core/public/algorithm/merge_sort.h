@@ -0,0 +1,782 @@
+#pragma once
+
+#include "../core_types.h"
+#include "../misc/assert.h"
+#include "../templates/types.h"
+#include "../templates/utility.h"
+#include "../hal/platform_memory.h"
+#include "../hal/platform_math.h"
+
+/**
+ * Implementation of an adaptive, stable
+ * merge sort (a.k.a. Timsort).
+ *
+ * The input is scanned for natural
+ * runs (strictly descending runs are
+ * reversed in place), short runs are
+ * extended with a binary insertion
+ * sort and runs are merged according
+ * to the Timsort stack invariants.
+ * Merges switch to galloping mode
+ * when one run keeps winning.
+ *
+ * Merges use a temporary buffer that
+ * is requested to the provided
+ * allocator and grows as needed, up
+ * to half the size of the input. If
+ * no allocator is provided or if the
+ * allocator fails, runs are merged in
+ * place using rotations, which is
+ * still stable but slower.
+ *
+ * @param It random access iterator type
+ * @param T type of the sorted items
+ * @param CompareT three way compare type
+ */
+template<typename It, typename T, typename CompareT>
+class MergeSort
+{
+	/// Runs shorter than this are
+	/// sorted with insertion sort
+	static constexpr int64 minMerge = 32;
+
+	/// Initial galloping threshold
+	static constexpr int64 minGallop = 7;
+
+	/// Max number of pending runs,
+	/// enough for 2^64 items
+	static constexpr int32 maxNumRuns = 85;
+
+public:
+	/**
+	 * Initialize sort state.
+	 *
+	 * @param inBegin first item
+	 * @param inCount number of items
+	 * @param inCmp compare function
+	 * @param inMalloc allocator used for
+	 * 	the merge buffer, may be null
+	 */
+	FORCE_INLINE MergeSort(It inBegin, int64 inCount, CompareT & inCmp, MallocBase * inMalloc)
+		: a{inBegin}
+		, count{inCount}
+		, cmp{inCmp}
+		, malloc{inMalloc}
+		, buffer{nullptr}
+		, bufferCapacity{0}
+		, currMinGallop{minGallop}
+		, numRuns{0}
+	{
+		//
+	}
+
+	/**
+	 * Releases the merge buffer.
+	 */
+	FORCE_INLINE ~MergeSort()
+	{
+		if (buffer) malloc->free(buffer);
+	}
+
+	/**
+	 * Sorts the whole range.
+	 */
+	void sort()
+	{
+		if (count < 2)
+			// Nothing to sort
+			return;
+
+		if (count < minMerge)
+		{
+			// Small input, no merges required
+			const int64 runLen = makeRun(0, count);
+			insertionSort(0, count, runLen);
+			return;
+		}
+
+		const int64 minRun = computeMinRun(count);
+		for (int64 lo = 0, remaining = count; remaining > 0;)
+		{
+			// Find next natural run
+			int64 runLen = makeRun(lo, lo + remaining);
+
+			if (runLen < minRun)
+			{
+				// Extend run to min run length
+				const int64 forcedLen = remaining < minRun ? remaining : minRun;
+				insertionSort(lo, lo + forcedLen, lo + runLen);
+				runLen = forcedLen;
+			}
+
+			// Push run and restore invariants
+			pushRun(lo, runLen);
+			mergeCollapse();
+
+			lo += runLen;
+			remaining -= runLen;
+		}
+
+		mergeForceCollapse();
+		CHECK(numRuns == 1)
+	}
+
+	/**
+	 * Stable in place merge of two
+	 * adjacent sorted ranges, without
+	 * any extra memory.
+	 *
+	 * @param lo,mid,hi ranges bounds,
+	 * 	i.e. [lo, mid) and [mid, hi)
+	 */
+	void mergeInPlace(int64 lo, int64 mid, int64 hi)
+	{
+		const int64 len1 = mid - lo;
+		const int64 len2 = hi - mid;
+
+		if (len1 == 0 || len2 == 0)
+			return;
+
+		if (len1 + len2 == 2)
+		{
+			if (cmp(a[mid], a[lo]) < 0) swap(a[lo], a[mid]);
+			return;
+		}
+
+		int64 cut1, cut2;
+		if (len1 > len2)
+		{
+			// Split first run in half and find
+			// first item not less than cut
+			cut1 = lo + len1 / 2;
+			cut2 = lowerBound(mid, hi, a[cut1]);
+		}
+		else
+		{
+			// Split second run in half and find
+			// first item greater than cut
+			cut2 = mid + len2 / 2;
+			cut1 = upperBound(lo, mid, a[cut2]);
+		}
+
+		// Swap middle blocks and recurse
+		rotate(cut1, mid, cut2);
+		const int64 newMid = cut1 + (cut2 - mid);
+
+		mergeInPlace(lo, cut1, newMid);
+		mergeInPlace(newMid, cut2, hi);
+	}
+
+protected:
+	/**
+	 * Computes min run length, such that
+	 * n / minRun is equal to or slightly
+	 * less than a power of two.
+	 */
+	static constexpr FORCE_INLINE int64 computeMinRun(int64 n)
+	{
+		int64 r = 0;
+		for (; n >= minMerge; n >>= 1) r |= n & 1;
+		return n + r;
+	}
+
+	/**
+	 * Finds the run that starts at lo and
+	 * makes it ascending. Strictly
+	 * descending runs are reversed, which
+	 * preserves stability.
+	 *
+	 * @param lo,hi search range
+	 * @return length of the run
+	 */
+	int64 makeRun(int64 lo, int64 hi)
+	{
+		int64 runHi = lo + 1;
+		if (runHi == hi) return 1;
+
+		if (cmp(a[runHi++], a[lo]) < 0)
+		{
+			// Strictly descending
+			while (runHi < hi && cmp(a[runHi], a[runHi - 1]) < 0) ++runHi;
+			reverse(lo, runHi);
+		}
+		else
+		{
+			// Ascending
+			while (runHi < hi && cmp(a[runHi], a[runHi - 1]) >= 0) ++runHi;
+		}
+
+		return runHi - lo;
+	}
+
+	/**
+	 * Binary insertion sort of the range
+	 * [lo, hi), where [lo, start) is
+	 * already sorted.
+	 */
+	void insertionSort(int64 lo, int64 hi, int64 start)
+	{
+		if (start == lo) ++start;
+
+		for (; start < hi; ++start)
+		{
+			T pivot{move(a[start])};
+
+			// Find insertion point, after
+			// all items equal to pivot
+			int64 left = lo, right = start;
+			while (left < right)
+			{
+				const int64 mid = (left + right) >> 1;
+				if (cmp(pivot, a[mid]) < 0) right = mid;
+				else left = mid + 1;
+			}
+
+			for (int64 k = start; k > left; --k) a[k] = move(a[k - 1]);
+			a[left] = move(pivot);
+		}
+	}
+
+	/**
+	 * Reverses range [lo, hi).
+	 */
+	FORCE_INLINE void reverse(int64 lo, int64 hi)
+	{
+		for (--hi; lo < hi; ++lo, --hi) swap(a[lo], a[hi]);
+	}
+
+	/**
+	 * Rotates range [lo, hi) so that
+	 * mid becomes the first item.
+	 */
+	FORCE_INLINE void rotate(int64 lo, int64 mid, int64 hi)
+	{
+		if (lo == mid || mid == hi) return;
+
+		reverse(lo, mid);
+		reverse(mid, hi);
+		reverse(lo, hi);
+	}
+
+	/**
+	 * Returns index of first item in
+	 * [lo, hi) not less than key.
+	 */
+	FORCE_INLINE int64 lowerBound(int64 lo, int64 hi, const T & key)
+	{
+		while (lo < hi)
+		{
+			const int64 mid = (lo + hi) >> 1;
+			if (cmp(a[mid], key) < 0) lo = mid + 1;
+			else hi = mid;
+		}
+
+		return lo;
+	}
+
+	/**
+	 * Returns index of first item in
+	 * [lo, hi) greater than key.
+	 */
+	FORCE_INLINE int64 upperBound(int64 lo, int64 hi, const T & key)
+	{
+		while (lo < hi)
+		{
+			const int64 mid = (lo + hi) >> 1;
+			if (cmp(key, a[mid]) < 0) hi = mid;
+			else lo = mid + 1;
+		}
+
+		return lo;
+	}
+
+	/**
+	 * Locates the position at which to
+	 * insert key in the sorted range
+	 * src[base, base + len). If the range
+	 * contains items equal to key, returns
+	 * the index of the leftmost one.
+	 *
+	 * The search starts at hint and
+	 * proceeds with exponential steps.
+	 *
+	 * @return offset relative to base
+	 */
+	template<typename SrcT>
+	int64 gallopLeft(const T & key, SrcT src, int64 base, int64 len, int64 hint)
+	{
+		int64 lastOfs = 0, ofs = 1;
+
+		if (cmp(key, src[base + hint]) > 0)
+		{
+			// Gallop right
+			const int64 maxOfs = len - hint;
+			while (ofs < maxOfs && cmp(key, src[base + hint + ofs]) > 0)
+			{
+				lastOfs = ofs;
+				ofs = (ofs << 1) + 1;
+			}
+
+			if (ofs > maxOfs) ofs = maxOfs;
+
+			lastOfs += hint;
+			ofs += hint;
+		}
+		else
+		{
+			// Gallop left
+			const int64 maxOfs = hint + 1;
+			while (ofs < maxOfs && cmp(key, src[base + hint - ofs]) <= 0)
+			{
+				lastOfs = ofs;
+				ofs = (ofs << 1) + 1;
+			}
+
+			if (ofs > maxOfs) ofs = maxOfs;
+
+			const int64 tmp = lastOfs;
+			lastOfs = hint - ofs;
+			ofs = hint - tmp;
+		}
+
+		// Binary search in (lastOfs, ofs]
+		for (++lastOfs; lastOfs < ofs;)
+		{
+			const int64 mid = lastOfs + ((ofs - lastOfs) >> 1);
+			if (cmp(key, src[base + mid]) > 0) lastOfs = mid + 1;
+			else ofs = mid;
+		}
+
+		return ofs;
+	}
+
+	/**
+	 * Like gallopLeft, except that if the
+	 * range contains items equal to key,
+	 * returns the index after the
+	 * rightmost one.
+	 *
+	 * @return offset relative to base
+	 */
+	template<typename SrcT>
+	int64 gallopRight(const T & key, SrcT src, int64 base, int64 len, int64 hint)
+	{
+		int64 lastOfs = 0, ofs = 1;
+
+		if (cmp(key, src[base + hint]) < 0)
+		{
+			// Gallop left
+			const int64 maxOfs = hint + 1;
+			while (ofs < maxOfs && cmp(key, src[base + hint - ofs]) < 0)
+			{
+				lastOfs = ofs;
+				ofs = (ofs << 1) + 1;
+			}
+
+			if (ofs > maxOfs) ofs = maxOfs;
+
+			const int64 tmp = lastOfs;
+			lastOfs = hint - ofs;
+			ofs = hint - tmp;
+		}
+		else
+		{
+			// Gallop right
+			const int64 maxOfs = len - hint;
+			while (ofs < maxOfs && cmp(key, src[base + hint + ofs]) >= 0)
+			{
+				lastOfs = ofs;
+				ofs = (ofs << 1) + 1;
+			}
+
+			if (ofs > maxOfs) ofs = maxOfs;
+
+			lastOfs += hint;
+			ofs += hint;
+		}
+
+		// Binary search in (lastOfs, ofs]
+		for (++lastOfs; lastOfs < ofs;)
+		{
+			const int64 mid = lastOfs + ((ofs - lastOfs) >> 1);
+			if (cmp(key, src[base + mid]) < 0) ofs = mid;
+			else lastOfs = mid + 1;
+		}
+
+		return ofs;
+	}
+
+	/**
+	 * Makes sure the merge buffer can hold
+	 * at least n items. Returns null if
+	 * memory is not available.
+	 */
+	T * ensureCapacity(int64 n)
+	{
+		if (n <= bufferCapacity)
+			return buffer;
+
+		if (!malloc)
+			return nullptr;
+
+		// Grow geometrically, but never
+		// more than half the input
+		int64 capacity = bufferCapacity ? bufferCapacity : 256;
+		while (capacity < n) capacity <<= 1;
+		if (capacity > (count >> 1)) capacity = PlatformMath::max(count >> 1, n);
+
+		T * inBuffer = reinterpret_cast<T*>(malloc->alloc(capacity * sizeof(T), alignof(T)));
+		if (!inBuffer)
+			return nullptr;
+
+		if (buffer) malloc->free(buffer);
+
+		buffer = inBuffer;
+		bufferCapacity = capacity;
+
+		return buffer;
+	}
+
+	/**
+	 * Push a new run on the stack.
+	 */
+	FORCE_INLINE void pushRun(int64 runBase, int64 runLen)
+	{
+		CHECK(numRuns < maxNumRuns)
+
+		runs[numRuns].base = runBase;
+		runs[numRuns].len = runLen;
+		++numRuns;
+	}
+
+	/**
+	 * Merges runs until the stack
+	 * invariants are satisfied:
+	 *
+	 * ```
+	 * runs[i - 2].len > runs[i - 1].len + runs[i].len
+	 * runs[i - 1].len > runs[i].len
+	 * ```
+	 */
+	void mergeCollapse()
+	{
+		while (numRuns > 1)
+		{
+			int32 n = numRuns - 2;
+
+			if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len) || (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len))
+			{
+				if (runs[n - 1].len < runs[n + 1].len) --n;
+			}
+			else if (runs[n].len > runs[n + 1].len)
+				break;
+
+			mergeAt(n);
+		}
+	}
+
+	/**
+	 * Merges all runs on the stack.
+	 */
+	void mergeForceCollapse()
+	{
+		while (numRuns > 1)
+		{
+			int32 n = numRuns - 2;
+			if (n > 0 && runs[n - 1].len < runs[n + 1].len) --n;
+
+			mergeAt(n);
+		}
+	}
+
+	/**
+	 * Merges the run at i with the run at
+	 * i + 1. i must be either the second
+	 * or third last run.
+	 */
+	void mergeAt(int32 i)
+	{
+		int64 base1 = runs[i].base, len1 = runs[i].len;
+		int64 base2 = runs[i + 1].base, len2 = runs[i + 1].len;
+
+		// Record merged run
+		runs[i].len = len1 + len2;
+		if (i == numRuns - 3) runs[i + 1] = runs[i + 2];
+		--numRuns;
+
+		// Items of first run that are
+		// already in place can be ignored
+		const int64 k = gallopRight(a[base2], a, base1, len1, 0);
+		base1 += k;
+		len1 -= k;
+		if (len1 == 0) return;
+
+		// Same for last items of second run
+		len2 = gallopLeft(a[base1 + len1 - 1], a, base2, len2, len2 - 1);
+		if (len2 == 0) return;
+
+		if (len1 <= len2)
+		{
+			if (T * tmp = ensureCapacity(len1)) mergeLo(tmp, base1, len1, base2, len2);
+			else mergeInPlace(base1, base2, base2 + len2);
+		}
+		else
+		{
+			if (T * tmp = ensureCapacity(len2)) mergeHi(tmp, base1, len1, base2, len2);
+			else mergeInPlace(base1, base2, base2 + len2);
+		}
+	}
+
+	/**
+	 * Merges two adjacent runs, copying
+	 * the first (shorter) run in the
+	 * temporary buffer. a[base1] must
+	 * be greater than a[base2] and the
+	 * last item of the first run must
+	 * be greater than all items of the
+	 * second run.
+	 */
+	void mergeLo(T * tmp, int64 base1, int64 len1, int64 base2, int64 len2)
+	{
+		for (int64 i = 0; i < len1; ++i) new (tmp + i) T{move(a[base1 + i])};
+		const int64 numTmp = len1;
+
+		int64 cursor1 = 0, cursor2 = base2, dest = base1;
+		a[dest++] = move(a[cursor2++]);
+
+		if (--len2 == 0)
+		{
+			for (int64 i = 0; i < len1; ++i) a[dest + i] = move(tmp[cursor1 + i]);
+			Memory::destroyElements(tmp, tmp + numTmp);
+			return;
+		}
+
+		if (len1 == 1)
+		{
+			for (int64 i = 0; i < len2; ++i) a[dest + i] = move(a[cursor2 + i]);
+			a[dest + len2] = move(tmp[cursor1]);
+			Memory::destroyElements(tmp, tmp + numTmp);
+			return;
+		}
+
+		int64 gallop = currMinGallop;
+		for (bool bDone = false; !bDone;)
+		{
+			int64 count1 = 0, count2 = 0;
+
+			// Straight merge until a run
+			// starts winning consistently
+			do
+			{
+				if (cmp(a[cursor2], tmp[cursor1]) < 0)
+				{
+					a[dest++] = move(a[cursor2++]);
+					++count2, count1 = 0;
+					if (--len2 == 0) { bDone = true; break; }
+				}
+				else
+				{
+					a[dest++] = move(tmp[cursor1++]);
+					++count1, count2 = 0;
+					if (--len1 == 1) { bDone = true; break; }
+				}
+			} while ((count1 | count2) < gallop);
+
+			if (bDone) break;
+
+			// Galloping mode
+			do
+			{
+				count1 = gallopRight(a[cursor2], tmp, cursor1, len1, 0);
+				if (count1 != 0)
+				{
+					for (int64 i = 0; i < count1; ++i) a[dest + i] = move(tmp[cursor1 + i]);
+					dest += count1, cursor1 += count1, len1 -= count1;
+					if (len1 <= 1) { bDone = true; break; }
+				}
+
+				a[dest++] = move(a[cursor2++]);
+				if (--len2 == 0) { bDone = true; break; }
+
+				count2 = gallopLeft(tmp[cursor1], a, cursor2, len2, 0);
+				if (count2 != 0)
+				{
+					// Ranges may overlap, but dest
+					// is always behind cursor2
+					for (int64 i = 0; i < count2; ++i) a[dest + i] = move(a[cursor2 + i]);
+					dest += count2, cursor2 += count2, len2 -= count2;
+					if (len2 == 0) { bDone = true; break; }
+				}
+
+				a[dest++] = move(tmp[cursor1++]);
+				if (--len1 == 1) { bDone = true; break; }
+
+				--gallop;
+			} while (count1 >= minGallop || count2 >= minGallop);
+
+			if (bDone) break;
+
+			// Penalize leaving galloping mode
+			if (gallop < 0) gallop = 0;
+			gallop += 2;
+		}
+
+		currMinGallop = gallop < 1 ? 1 : gallop;
+
+		if (len1 == 1)
+		{
+			for (int64 i = 0; i < len2; ++i) a[dest + i] = move(a[cursor2 + i]);
+			a[dest + len2] = move(tmp[cursor1]);
+		}
+		else
+		{
+			// Only reached with a consistent
+			// compare function if len1 > 1
+			for (int64 i = 0; i < len1; ++i) a[dest + i] = move(tmp[cursor1 + i]);
+		}
+
+		Memory::destroyElements(tmp, tmp + numTmp);
+	}
+
+	/**
+	 * Like mergeLo, but copies the second
+	 * (shorter) run in the temporary
+	 * buffer and merges right to left.
+	 */
+	void mergeHi(T * tmp, int64 base1, int64 len1, int64 base2, int64 len2)
+	{
+		for (int64 i = 0; i < len2; ++i) new (tmp + i) T{move(a[base2 + i])};
+		const int64 numTmp = len2;
+
+		int64 cursor1 = base1 + len1 - 1, cursor2 = len2 - 1, dest = base2 + len2 - 1;
+		a[dest--] = move(a[cursor1--]);
+
+		if (--len1 == 0)
+		{
+			for (int64 i = 0; i < len2; ++i) a[dest - (len2 - 1) + i] = move(tmp[i]);
+			Memory::destroyElements(tmp, tmp + numTmp);
+			return;
+		}
+
+		if (len2 == 1)
+		{
+			dest -= len1, cursor1 -= len1;
+			for (int64 i = len1; i > 0; --i) a[dest + i] = move(a[cursor1 + i]);
+			a[dest] = move(tmp[cursor2]);
+			Memory::destroyElements(tmp, tmp + numTmp);
+			return;
+		}
+
+		int64 gallop = currMinGallop;
+		for (bool bDone = false; !bDone;)
+		{
+			int64 count1 = 0, count2 = 0;
+
+			// Straight merge until a run
+			// starts winning consistently
+			do
+			{
+				if (cmp(tmp[cursor2], a[cursor1]) < 0)
+				{
+					a[dest--] = move(a[cursor1--]);
+					++count1, count2 = 0;
+					if (--len1 == 0) { bDone = true; break; }
+				}
+				else
+				{
+					a[dest--] = move(tmp[cursor2--]);
+					++count2, count1 = 0;
+					if (--len2 == 1) { bDone = true; break; }
+				}
+			} while ((count1 | count2) < gallop);
+
+			if (bDone) break;
+
+			// Galloping mode
+			do
+			{
+				count1 = len1 - gallopRight(tmp[cursor2], a, base1, len1, len1 - 1);
+				if (count1 != 0)
+				{
+					dest -= count1, cursor1 -= count1, len1 -= count1;
+
+					// Ranges may overlap, but dest
+					// is always ahead of cursor1
+					for (int64 i = count1; i > 0; --i) a[dest + i] = move(a[cursor1 + i]);
+					if (len1 == 0) { bDone = true; break; }
+				}
+
+				a[dest--] = move(tmp[cursor2--]);
+				if (--len2 == 1) { bDone = true; break; }
+
+				count2 = len2 - gallopLeft(a[cursor1], tmp, 0, len2, len2 - 1);
+				if (count2 != 0)
+				{
+					dest -= count2, cursor2 -= count2, len2 -= count2;
+					for (int64 i = 1; i <= count2; ++i) a[dest + i] = move(tmp[cursor2 + i]);
+					if (len2 <= 1) { bDone = true; break; }
+				}
+
+				a[dest--] = move(a[cursor1--]);
+				if (--len1 == 0) { bDone = true; break; }
+
+				--gallop;
+			} while (count1 >= minGallop || count2 >= minGallop);
+
+			if (bDone) break;
+
+			// Penalize leaving galloping mode
+			if (gallop < 0) gallop = 0;
+			gallop += 2;
+		}
+
+		currMinGallop = gallop < 1 ? 1 : gallop;
+
+		if (len2 == 1)
+		{
+			dest -= len1, cursor1 -= len1;
+			for (int64 i = len1; i > 0; --i) a[dest + i] = move(a[cursor1 + i]);
+			a[dest] = move(tmp[cursor2]);
+		}
+		else
+		{
+			// Only reached with a consistent
+			// compare function if len2 > 1
+			for (int64 i = 0; i < len2; ++i) a[dest - (len2 - 1) + i] = move(tmp[i]);
+		}
+
+		Memory::destroyElements(tmp, tmp + numTmp);
+	}
+
+protected:
+	/// Begin of the sorted range
+	It a;
+
+	/// Number of items to sort
+	const int64 count;
+
+	/// Compare function
+	CompareT & cmp;
+
+	/// Allocator for merge buffer
+	MallocBase * malloc;
+
+	/// Merge buffer (uninitialized)
+	T * buffer;
+
+	/// Merge buffer capacity
+	int64 bufferCapacity;
+
+	/// Current galloping threshold
+	int64 currMinGallop;
+
+	/// Stack of pending runs
+	struct
+	{
+		int64 base;
+		int64 len;
+	} runs[maxNumRuns];
+
+	/// Number of pending runs
+	int32 numRuns;
+};
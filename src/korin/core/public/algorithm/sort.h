@@ -3,6 +3,14 @@
 #include "../core_types.h"
 #include "../templates/types.h"
 #include "../templates/utility.h"
+#include "../templates/iterator.h"
+#include "../templates/functional.h"
+#include "../hal/platform_memory.h"
+#include "../hal/platform_math.h"
+#include "./merge_sort.h"
+#include "./heap.h"
+#include "./sorting_network.h"
+#include "../profiling/scoped_timer.h"
 
 struct Sort
 {
@@ -37,6 +45,8 @@ struct Sort
 		It i = begin, j = begin;
 		for (; i != end; ++i)
 			if (cmp(*i, pivot) < 0) swap(*i, *j), ++j;
+		
+		return j;
 	}
 
 	/**
@@ -53,6 +63,10 @@ struct Sort
 	template<typename It, typename CompareT>
 	static void quicksort(It begin, It end, CompareT && cmp/* = ThreeWayCompare() */)
 	{
+		if (sortSmall(begin, end, cmp))
+			// Sorted with a sorting network
+			return;
+
 		It i = begin, j = begin, p = begin;
 
 		if (i == end || ++i == end)
@@ -125,4 +139,338 @@ struct Sort
 		argquicksort(begin, k, args, forward<CompareT>(cmp));
 		argquicksort(j, end, y, forward<CompareT>(cmp));
 	}
-};
\ No newline at end of file
+
+	/**
+	 * Introsort algorithm.
+	 * Given a random access iterator,
+	 * sorts the container in place in
+	 * O(N log N) time complexity, also
+	 * in the worst case.
+	 * 
+	 * Runs a median-of-three quicksort
+	 * that switches to heap sort if the
+	 * recursion gets too deep. Small
+	 * ranges are sorted with insertion
+	 * sort, or with a SIMD sorting
+	 * network for contiguous ranges of
+	 * int32, float32 and uint64 items
+	 * with the default compare function.
+	 * @see SortingNetwork
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 */
+	template<typename It, typename CompareT>
+	static void introsort(It begin, It end, CompareT && cmp/* = ThreeWayCompare() */)
+	{
+		SCOPED_TIMER("Sort::introsort");
+
+		const int64 count = static_cast<int64>(end - begin);
+		introsort(begin, 0, count, PlatformMath::log2(static_cast<uint64>(count)) * 2, cmp);
+	}
+
+	/**
+	 * Merge sort algorithm.
+	 * Given a random access iterator,
+	 * sorts the container in place in
+	 * O(N log N) time complexity. The
+	 * sort is stable, i.e. equivalent
+	 * items retain their relative
+	 * order, and adaptive, i.e. it
+	 * runs in O(N) on presorted or
+	 * reverse sorted inputs.
+	 * @see MergeSort
+	 * 
+	 * Merges use a temporary buffer of
+	 * at most N / 2 items, allocated
+	 * with the provided allocator. If
+	 * the allocator is null or fails
+	 * the sort falls back to in place
+	 * merges, with O(N log^2 N) time
+	 * complexity.
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 * @param malloc allocator used for
+	 * 	the merge buffer
+	 */
+	template<typename It, typename CompareT>
+	static void mergesort(It begin, It end, CompareT && cmp/* = ThreeWayCompare() */, MallocBase * malloc = gMalloc)
+	{
+		SCOPED_TIMER("Sort::mergesort");
+
+		using T = typename IteratorValue<It>::Type;
+		using MergeSortT = MergeSort<It, T, typename RemoveReference<CompareT>::Type>;
+
+		MergeSortT{begin, static_cast<int64>(end - begin), cmp, malloc}.sort();
+	}
+
+	/**
+	 * Selection algorithm (introselect).
+	 * Given a random access iterator,
+	 * rearranges the items so that the
+	 * item pointed by nth is the one that
+	 * would be in that position if the
+	 * range were sorted. All the items
+	 * before it are smaller or equal and
+	 * all the items after it are greater
+	 * or equal.
+	 * 
+	 * Runs a median-of-three quickselect
+	 * in O(N) average time. If recursion
+	 * gets too deep it falls back to a
+	 * heap select, so that the worst
+	 * case is O(N log N).
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param nth iterator to the item
+	 * 	to select
+	 * @param cmp compare function
+	 */
+	template<typename It, typename CompareT>
+	static void nthElement(It begin, It nth, It end, CompareT && cmp/* = ThreeWayCompare() */)
+	{
+		if (!(nth < end)) return;
+
+		// Iterators may not be assignable,
+		// keep track of offsets instead
+		const int64 n = static_cast<int64>(nth - begin);
+		int64 lo = 0, hi = static_cast<int64>(end - begin);
+
+		int64 depthLimit = PlatformMath::log2(static_cast<uint64>(hi)) * 2;
+		while (hi - lo > selectThreshold)
+		{
+			if (depthLimit-- == 0)
+			{
+				// Too many bad pivots, select
+				// with a heap instead
+				heapSelect(begin + lo, nth + 1, begin + hi, cmp);
+				swap(*(begin + lo), *nth);
+				return;
+			}
+
+			const int64 cut = static_cast<int64>(partitionPivot(begin + lo, begin + hi, cmp) - begin);
+			if (cut <= n) lo = cut;
+			else hi = cut;
+		}
+
+		insertionSort(begin + lo, begin + hi, cmp);
+	}
+
+	/**
+	 * Partial sort algorithm.
+	 * Given a random access iterator,
+	 * rearranges the items so that the
+	 * range [begin, middle) contains the
+	 * smallest items in ascending order.
+	 * The order of the remaining items
+	 * is unspecified.
+	 * 
+	 * Runs in O(N log K) time, where K
+	 * is the size of the sorted range.
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param middle end of the sorted range
+	 * @param cmp compare function
+	 */
+	template<typename It, typename CompareT>
+	static void partialSort(It begin, It middle, It end, CompareT && cmp/* = ThreeWayCompare() */)
+	{
+		heapSelect(begin, middle, end, cmp);
+		Heap::sort(begin, middle, cmp);
+	}
+
+protected:
+	/// Ranges smaller than this are
+	/// sorted with insertion sort
+	static constexpr int64 selectThreshold = 16;
+
+	/**
+	 * Sets value to true if ranges of
+	 * type It can be sorted with a
+	 * sorting network, i.e. if items
+	 * are contiguous, of a supported type
+	 * and compared in natural order.
+	 */
+	template<typename It, typename CompareT>
+	struct CanUseSortingNetwork
+	{
+		using T = typename IteratorValue<It>::Type;
+
+		enum
+		{
+			value = IsSortingNetworkType<T>::value
+				&& IsSameType<typename RemoveConst<typename RemoveReference<CompareT>::Type>::Type, ThreeWayCompare>::value
+				&& (IsPointer<It>::value || IsBaseOf<ContiguousIterator<T>, It>::value)
+		};
+	};
+
+	/**
+	 * Sorts the range with a sorting
+	 * network if possible.
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 * @return true if range was sorted
+	 * @{
+	 */
+	template<typename It, typename CompareT>
+	static FORCE_INLINE typename EnableIf<CanUseSortingNetwork<It, CompareT>::value, bool>::Type sortSmall(It begin, It end, CompareT && cmp)
+	{
+		const int64 count = static_cast<int64>(end - begin);
+		if (count > SortingNetwork::maxCount) return false;
+
+		if (count > 1) SortingNetwork::sort(&*begin, static_cast<uint32>(count));
+		return true;
+	}
+
+	template<typename It, typename CompareT>
+	static FORCE_INLINE typename EnableIf<!CanUseSortingNetwork<It, CompareT>::value, bool>::Type sortSmall(It begin, It end, CompareT && cmp)
+	{
+		return false;
+	}
+	/// @}
+
+	/**
+	 * Introsort implementation, sorts
+	 * items in [begin + lo, begin + hi).
+	 * 
+	 * @param begin first item
+	 * @param lo,hi bounds of range
+	 * @param depthLimit number of
+	 * 	partitions before switching
+	 * 	to heap sort
+	 * @param cmp compare function
+	 */
+	template<typename It, typename CompareT>
+	static void introsort(It begin, int64 lo, int64 hi, int64 depthLimit, CompareT && cmp)
+	{
+		while (hi - lo > selectThreshold)
+		{
+			if (sortSmall(begin + lo, begin + hi, cmp))
+				// Sorted with a sorting network
+				return;
+
+			if (depthLimit-- == 0)
+			{
+				// Too many bad pivots
+				Heap::make(begin + lo, begin + hi, cmp);
+				Heap::sort(begin + lo, begin + hi, cmp);
+				return;
+			}
+
+			// Recurse on the smaller partition,
+			// loop on the larger one
+			const int64 cut = static_cast<int64>(partitionPivot(begin + lo, begin + hi, cmp) - begin);
+			if (cut - lo < hi - cut)
+			{
+				introsort(begin, lo, cut, depthLimit, cmp);
+				lo = cut;
+			}
+			else
+			{
+				introsort(begin, cut, hi, depthLimit, cmp);
+				hi = cut;
+			}
+		}
+
+		if (!sortSmall(begin + lo, begin + hi, cmp)) insertionSort(begin + lo, begin + hi, cmp);
+	}
+
+	/**
+	 * Insertion sort, used for small
+	 * ranges.
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 */
+	template<typename It, typename CompareT>
+	static void insertionSort(It begin, It end, CompareT && cmp)
+	{
+		using T = typename IteratorValue<It>::Type;
+
+		if (end - begin < 2) return;
+
+		for (It i = begin + 1; i < end; ++i)
+		{
+			T item = move(*i);
+			It j = i;
+			for (; begin < j && cmp(item, *(j - 1)) < 0; --j)
+				*j = move(*(j - 1));
+
+			*j = move(item);
+		}
+	}
+
+	/**
+	 * Moves the K smallest items at the
+	 * beginning of the range, organized
+	 * as a max-heap.
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param middle end of the heap,
+	 * 	i.e. begin + K
+	 * @param cmp compare function
+	 */
+	template<typename It, typename CompareT>
+	static void heapSelect(It begin, It middle, It end, CompareT && cmp)
+	{
+		const int64 count = static_cast<int64>(middle - begin);
+		if (count == 0) return;
+
+		Heap::make(begin, middle, cmp);
+		for (It i = middle; i < end; ++i)
+		{
+			if (cmp(*i, *begin) < 0)
+			{
+				// Replace greatest item
+				swap(*i, *begin);
+				Heap::siftDown(begin, count, 0, cmp);
+			}
+		}
+	}
+
+	/**
+	 * Hoare partition around the median
+	 * of the first, middle and last item.
+	 * Requires at least three items.
+	 * 
+	 * @param begin,end begin and end iterators
+	 * @param cmp compare function
+	 * @return iterator to the first item
+	 * 	of the right partition, such that
+	 * 	all items in [begin, cut) are
+	 * 	smaller or equal than all items
+	 * 	in [cut, end)
+	 */
+	template<typename It, typename CompareT>
+	static It partitionPivot(It begin, It end, CompareT && cmp)
+	{
+		It a = begin + 1, b = begin + (end - begin) / 2, c = end - 1;
+
+		// Move median of three to first
+		// position. The other two are
+		// sentinels for the scans below
+		if (cmp(*a, *b) < 0)
+		{
+			if (cmp(*b, *c) < 0) swap(*begin, *b);
+			else if (cmp(*a, *c) < 0) swap(*begin, *c);
+			else swap(*begin, *a);
+		}
+		else if (cmp(*a, *c) < 0) swap(*begin, *a);
+		else if (cmp(*b, *c) < 0) swap(*begin, *c);
+		else swap(*begin, *b);
+
+		It i = begin + 1, j = end;
+		for (;;)
+		{
+			while (cmp(*i, *begin) < 0) ++i;
+			--j;
+			while (cmp(*begin, *j) < 0) --j;
+			if (!(i < j)) return i;
+
+			swap(*i, *j);
+			++i;
+		}
+	}
+};
@@ -0,0 +1,479 @@
+#pragma once
+
+#include "../core_types.h"
+#include "../misc/assert.h"
+#include "../templates/types.h"
+#include "../templates/enable_if.h"
+
+#if PLATFORM_USE_SIMD && defined(__AVX2__)
+	#define SORTING_NETWORK_USE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define SORTING_NETWORK_USE_AVX2 0
+#endif
+
+/**
+ * Sets value to true if items of type
+ * T can be sorted using a SIMD sorting
+ * network.
+ */
+template<typename T>
+struct IsSortingNetworkType
+{
+	enum {value = false};
+};
+
+#if SORTING_NETWORK_USE_AVX2
+
+template<> struct IsSortingNetworkType<int32>	{ enum {value = true}; };
+template<> struct IsSortingNetworkType<float32>	{ enum {value = true}; };
+template<> struct IsSortingNetworkType<uint64>	{ enum {value = true}; };
+
+/**
+ * Vector operations used by the sorting
+ * networks. Each specialization wraps
+ * a 256-bit register of items of type
+ * T and provides min/max, lane
+ * permutations and compare-exchange
+ * operations.
+ *
+ * A compare-exchange with a given mask
+ * compares each lane i with lane
+ * i ^ mask, and moves the smaller item
+ * in the lower lane.
+ *
+ * @param T type of the items
+ */
+template<typename T>
+struct SortingNetworkVector;
+
+template<>
+struct SortingNetworkVector<int32>
+{
+	using T = int32;
+	using Type = __m256i;
+
+	/// Number of items per register
+	static constexpr uint32 numLanes = 8;
+
+	static FORCE_INLINE Type loadu(const T * src)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+	}
+
+	static FORCE_INLINE void storeu(T * dst, Type v)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+	}
+
+	/**
+	 * Loads the first n items, remaining
+	 * lanes are padded with the greatest
+	 * value, so that they sort last.
+	 */
+	static FORCE_INLINE Type loadPadded(const T * src, int32 n)
+	{
+		const Type mask = getMask(n);
+		return _mm256_blendv_epi8(_mm256_set1_epi32(0x7fffffff), _mm256_maskload_epi32(src, mask), mask);
+	}
+
+	/**
+	 * Stores the first n items.
+	 */
+	static FORCE_INLINE void storePartial(T * dst, Type v, int32 n)
+	{
+		_mm256_maskstore_epi32(dst, getMask(n), v);
+	}
+
+	static FORCE_INLINE Type getMask(int32 n)
+	{
+		return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	}
+
+	static FORCE_INLINE Type min(Type a, Type b)
+	{
+		return _mm256_min_epi32(a, b);
+	}
+
+	static FORCE_INLINE Type max(Type a, Type b)
+	{
+		return _mm256_max_epi32(a, b);
+	}
+
+	template<uint32 mask>
+	static FORCE_INLINE Type permute(Type v)
+	{
+		return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0 ^ mask, 1 ^ mask, 2 ^ mask, 3 ^ mask, 4 ^ mask, 5 ^ mask, 6 ^ mask, 7 ^ mask));
+	}
+
+	template<uint32 mask>
+	static FORCE_INLINE Type exchange(Type v)
+	{
+		constexpr int32 blendMask = getBlendMask(mask);
+		const Type p = permute<mask>(v);
+		return _mm256_blend_epi32(min(v, p), max(v, p), blendMask);
+	}
+
+	static constexpr int32 getBlendMask(uint32 mask)
+	{
+		// Upper lane of each pair takes max
+		int32 out = 0;
+		for (uint32 i = 0; i < numLanes; ++i) if ((i ^ mask) < i) out |= 1 << i;
+		return out;
+	}
+};
+
+template<>
+struct SortingNetworkVector<float32>
+{
+	using T = float32;
+	using Type = __m256;
+
+	/// Number of items per register
+	static constexpr uint32 numLanes = 8;
+
+	static FORCE_INLINE Type loadu(const T * src)
+	{
+		return _mm256_loadu_ps(src);
+	}
+
+	static FORCE_INLINE void storeu(T * dst, Type v)
+	{
+		_mm256_storeu_ps(dst, v);
+	}
+
+	/**
+	 * Loads the first n items, remaining
+	 * lanes are padded with the greatest
+	 * value, so that they sort last.
+	 */
+	static FORCE_INLINE Type loadPadded(const T * src, int32 n)
+	{
+		const __m256i mask = SortingNetworkVector<int32>::getMask(n);
+		return _mm256_blendv_ps(_mm256_set1_ps(__builtin_inff()), _mm256_maskload_ps(src, mask), _mm256_castsi256_ps(mask));
+	}
+
+	/**
+	 * Stores the first n items.
+	 */
+	static FORCE_INLINE void storePartial(T * dst, Type v, int32 n)
+	{
+		_mm256_maskstore_ps(dst, SortingNetworkVector<int32>::getMask(n), v);
+	}
+
+	static FORCE_INLINE Type min(Type a, Type b)
+	{
+		return _mm256_min_ps(a, b);
+	}
+
+	static FORCE_INLINE Type max(Type a, Type b)
+	{
+		return _mm256_max_ps(a, b);
+	}
+
+	template<uint32 mask>
+	static FORCE_INLINE Type permute(Type v)
+	{
+		return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(0 ^ mask, 1 ^ mask, 2 ^ mask, 3 ^ mask, 4 ^ mask, 5 ^ mask, 6 ^ mask, 7 ^ mask));
+	}
+
+	template<uint32 mask>
+	static FORCE_INLINE Type exchange(Type v)
+	{
+		constexpr int32 blendMask = SortingNetworkVector<int32>::getBlendMask(mask);
+		const Type p = permute<mask>(v);
+		return _mm256_blend_ps(min(v, p), max(v, p), blendMask);
+	}
+};
+
+template<>
+struct SortingNetworkVector<uint64>
+{
+	using T = uint64;
+	using Type = __m256i;
+
+	/// Number of items per register
+	static constexpr uint32 numLanes = 4;
+
+	static FORCE_INLINE Type loadu(const T * src)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+	}
+
+	static FORCE_INLINE void storeu(T * dst, Type v)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+	}
+
+	/**
+	 * Loads the first n items, remaining
+	 * lanes are padded with the greatest
+	 * value, so that they sort last.
+	 */
+	static FORCE_INLINE Type loadPadded(const T * src, int32 n)
+	{
+		const Type mask = getMask(n);
+		return _mm256_blendv_epi8(_mm256_set1_epi64x(-1ll), _mm256_maskload_epi64(reinterpret_cast<const long long*>(src), mask), mask);
+	}
+
+	/**
+	 * Stores the first n items.
+	 */
+	static FORCE_INLINE void storePartial(T * dst, Type v, int32 n)
+	{
+		_mm256_maskstore_epi64(reinterpret_cast<long long*>(dst), getMask(n), v);
+	}
+
+	static FORCE_INLINE Type getMask(int32 n)
+	{
+		return _mm256_cmpgt_epi64(_mm256_set1_epi64x(n), _mm256_setr_epi64x(0, 1, 2, 3));
+	}
+
+	/**
+	 * AVX2 only has a signed 64-bit compare,
+	 * flip the sign bits to compare
+	 * unsigned items.
+	 */
+	static FORCE_INLINE Type greater(Type a, Type b)
+	{
+		const Type bias = _mm256_set1_epi64x(0x8000000000000000ll);
+		return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+	}
+
+	static FORCE_INLINE Type min(Type a, Type b)
+	{
+		return _mm256_blendv_epi8(a, b, greater(a, b));
+	}
+
+	static FORCE_INLINE Type max(Type a, Type b)
+	{
+		return _mm256_blendv_epi8(b, a, greater(a, b));
+	}
+
+	template<uint32 mask>
+	static FORCE_INLINE Type permute(Type v)
+	{
+		return _mm256_permute4x64_epi64(v, (0 ^ mask) | (1 ^ mask) << 2 | (2 ^ mask) << 4 | (3 ^ mask) << 6);
+	}
+
+	template<uint32 mask>
+	static FORCE_INLINE Type exchange(Type v)
+	{
+		constexpr int32 blendMask = getBlendMask(mask);
+		const Type p = permute<mask>(v);
+		const Type gt = greater(v, p);
+		return _mm256_blend_epi32(_mm256_blendv_epi8(v, p, gt), _mm256_blendv_epi8(p, v, gt), blendMask);
+	}
+
+	static constexpr int32 getBlendMask(uint32 mask)
+	{
+		// Each 64-bit lane spans two
+		// 32-bit blend lanes
+		int32 out = 0;
+		for (uint32 i = 0; i < numLanes; ++i) if ((i ^ mask) < i) out |= 3 << (i * 2);
+		return out;
+	}
+};
+
+#endif
+
+/**
+ * AVX2 bitonic sorting networks for
+ * small arrays of int32, float32 and
+ * uint64 items, up to 64 items.
+ *
+ * Items are loaded in one or more
+ * registers (padded with the greatest
+ * value), each register is sorted with
+ * an in-register bitonic network and
+ * registers are then merged with
+ * bitonic merges. The sequence of
+ * operations does not depend on the
+ * values, so there are no branch
+ * mispredictions.
+ *
+ * Items are sorted in ascending order.
+ * Float NaNs are not supported.
+ */
+struct SortingNetwork
+{
+	/// Max number of items that can be
+	/// sorted with a single network
+	static constexpr uint32 maxCount = 64;
+
+#if SORTING_NETWORK_USE_AVX2
+	/**
+	 * Sorts a small array in ascending
+	 * order.
+	 *
+	 * @param items pointer to first item
+	 * @param count number of items, at
+	 * 	most maxCount
+	 * @{
+	 */
+	template<typename T>
+	static FORCE_INLINE typename EnableIf<IsSortingNetworkType<T>::value>::Type sort(T * items, uint32 count)
+	{
+		using VectorT = SortingNetworkVector<T>;
+
+		CHECKF(count <= maxCount, "Sorting network supports at most %u items", maxCount)
+
+		if (count < 2) return;
+		else if (count <= VectorT::numLanes) sortItems<VectorT, 1>(items, count);
+		else if (count <= VectorT::numLanes * 2) sortItems<VectorT, 2>(items, count);
+		else if (count <= VectorT::numLanes * 4) sortItems<VectorT, 4>(items, count);
+		else if (count <= VectorT::numLanes * 8) sortItems<VectorT, 8>(items, count);
+		else sortItems<VectorT, maxCount / VectorT::numLanes>(items, count);
+	}
+
+	template<uint32 count, typename T>
+	static FORCE_INLINE typename EnableIf<IsSortingNetworkType<T>::value>::Type sort(T * items)
+	{
+		using VectorT = SortingNetworkVector<T>;
+
+		static_assert(count <= maxCount, "Too many items for sorting network");
+
+		constexpr uint32 numRegs = (count + VectorT::numLanes - 1) / VectorT::numLanes;
+		constexpr uint32 numRegs2 = numRegs <= 1 ? 1 : numRegs <= 2 ? 2 : numRegs <= 4 ? 4 : numRegs <= 8 ? 8 : 16;
+		if (count > 1) sortItems<VectorT, numRegs2>(items, count);
+	}
+	/// @}
+
+protected:
+	/**
+	 * Sorts the items of a register with
+	 * an in-register bitonic network.
+	 * @{
+	 */
+	template<typename VectorT>
+	static FORCE_INLINE typename EnableIf<VectorT::numLanes == 8, typename VectorT::Type>::Type sortLanes(typename VectorT::Type v)
+	{
+		v = VectorT::template exchange<1>(v);
+		v = VectorT::template exchange<3>(v);
+		v = VectorT::template exchange<1>(v);
+		v = VectorT::template exchange<7>(v);
+		v = VectorT::template exchange<2>(v);
+		return VectorT::template exchange<1>(v);
+	}
+
+	template<typename VectorT>
+	static FORCE_INLINE typename EnableIf<VectorT::numLanes == 4, typename VectorT::Type>::Type sortLanes(typename VectorT::Type v)
+	{
+		v = VectorT::template exchange<1>(v);
+		v = VectorT::template exchange<3>(v);
+		return VectorT::template exchange<1>(v);
+	}
+	/// @}
+
+	/**
+	 * Sorts the items of a bitonic
+	 * register.
+	 * @{
+	 */
+	template<typename VectorT>
+	static FORCE_INLINE typename EnableIf<VectorT::numLanes == 8, typename VectorT::Type>::Type mergeLanes(typename VectorT::Type v)
+	{
+		v = VectorT::template exchange<4>(v);
+		v = VectorT::template exchange<2>(v);
+		return VectorT::template exchange<1>(v);
+	}
+
+	template<typename VectorT>
+	static FORCE_INLINE typename EnableIf<VectorT::numLanes == 4, typename VectorT::Type>::Type mergeLanes(typename VectorT::Type v)
+	{
+		v = VectorT::template exchange<2>(v);
+		return VectorT::template exchange<1>(v);
+	}
+	/// @}
+
+	/**
+	 * Sorts the items of an array of
+	 * registers, as if they were a
+	 * single contiguous sequence.
+	 *
+	 * @param v array of registers
+	 */
+	template<typename VectorT, uint32 numRegs>
+	static FORCE_INLINE void sortRegisters(typename VectorT::Type * v)
+	{
+		using Type = typename VectorT::Type;
+		constexpr uint32 lastLane = VectorT::numLanes - 1;
+
+		for (uint32 i = 0; i < numRegs; ++i) v[i] = sortLanes<VectorT>(v[i]);
+
+		// Merge sorted blocks of width registers
+		for (uint32 width = 1; width < numRegs; width <<= 1)
+		{
+			for (uint32 block = 0; block < numRegs; block += width * 2)
+			{
+				// Compare each item with the
+				// mirrored item of the block
+				for (uint32 i = 0; i < width; ++i)
+				{
+					Type & a = v[block + i];
+					Type & b = v[block + width * 2 - 1 - i];
+					const Type r = VectorT::template permute<lastLane>(b);
+
+					b = VectorT::template permute<lastLane>(VectorT::max(a, r));
+					a = VectorT::min(a, r);
+				}
+
+				// Half cleaners across registers
+				for (uint32 dist = width >> 1; dist > 0; dist >>= 1)
+				{
+					for (uint32 i = block; i < block + width * 2; ++i)
+					{
+						if ((i - block) & dist) continue;
+
+						const Type a = v[i];
+						v[i] = VectorT::min(a, v[i + dist]);
+						v[i + dist] = VectorT::max(a, v[i + dist]);
+					}
+				}
+
+				// Half cleaners within registers
+				for (uint32 i = block; i < block + width * 2; ++i) v[i] = mergeLanes<VectorT>(v[i]);
+			}
+		}
+	}
+
+	/**
+	 * Loads items into registers, sorts
+	 * them and stores them back.
+	 *
+	 * @param items pointer to first item
+	 * @param count number of items
+	 */
+	template<typename VectorT, uint32 numRegs>
+	static void sortItems(typename VectorT::T * items, uint32 count)
+	{
+		using Type = typename VectorT::Type;
+		constexpr uint32 numLanes = VectorT::numLanes;
+
+		const uint32 numFullRegs = count / numLanes;
+		const int32 numTailItems = static_cast<int32>(count % numLanes);
+
+		Type v[numRegs];
+
+		// Loops have a constant trip count
+		// so that they are unrolled and
+		// registers are never spilled.
+		// Last registers are padded with
+		// the greatest value, so that real
+		// items end up first
+		for (uint32 i = 0; i < numRegs; ++i)
+		{
+			if (i < numFullRegs) v[i] = VectorT::loadu(items + i * numLanes);
+			else v[i] = VectorT::loadPadded(items + numFullRegs * numLanes, i == numFullRegs ? numTailItems : 0);
+		}
+
+		sortRegisters<VectorT, numRegs>(v);
+
+		for (uint32 i = 0; i < numRegs; ++i)
+		{
+			if (i < numFullRegs) VectorT::storeu(items + i * numLanes, v[i]);
+			else if (i == numFullRegs && numTailItems) VectorT::storePartial(items + i * numLanes, v[i], numTailItems);
+		}
+	}
+#endif
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "../core_types.h"
+#include "../misc/assert.h"
+#include "../misc/utility.h"
+#include "../templates/utility.h"
+#include "../templates/functional.h"
+#include "../containers/array.h"
+#include "./heap.h"
+
+/**
+ * Streaming accumulator that retains
+ * the K greatest items pushed into it,
+ * in O(N log K) time and O(K) space.
+ *
+ * Items are kept in a min-heap, whose
+ * top is the smallest retained item.
+ * Once the accumulator is full, each
+ * new item is compared against it and
+ * most items are rejected with a
+ * single comparison.
+ *
+ * Items are stored inline, so that no
+ * allocation is ever performed.
+ *
+ * @param T type of the items
+ * @param K max number of retained items
+ * @param CompareT three way compare type
+ */
+template<typename T, uint32 K, typename CompareT = ThreeWayCompare>
+class TopK
+{
+	static_assert(K > 0, "K must be greater than zero");
+
+	using InverseCompareT = InverseCompare<CompareT>;
+
+public:
+	/**
+	 * Default constructor.
+	 *
+	 * @param inCmp compare function
+	 */
+	FORCE_INLINE explicit TopK(CompareT inCmp = CompareT{})
+		: cmp{inCmp}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Copy constructor.
+	 */
+	FORCE_INLINE TopK(const TopK & other)
+		: cmp{other.cmp}
+		, count{other.count}
+	{
+		Memory::constructCopyElements(getItems(), other.getItems(), count);
+	}
+
+	/**
+	 * Copy assignment.
+	 */
+	FORCE_INLINE TopK & operator=(const TopK & other)
+	{
+		if (this != &other)
+		{
+			reset();
+
+			cmp = other.cmp;
+			count = other.count;
+			Memory::constructCopyElements(getItems(), other.getItems(), count);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys retained items.
+	 */
+	FORCE_INLINE ~TopK()
+	{
+		reset();
+	}
+
+	/**
+	 * Returns the number of retained
+	 * items, at most K.
+	 */
+	FORCE_INLINE uint32 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns true if no item was
+	 * pushed yet.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns true if K items are
+	 * retained.
+	 */
+	FORCE_INLINE bool isFull() const
+	{
+		return count == K;
+	}
+
+	/**
+	 * Returns the smallest retained item.
+	 * Once the accumulator is full, items
+	 * that are not greater than this are
+	 * rejected.
+	 */
+	FORCE_INLINE const T & getThreshold() const
+	{
+		CHECK(count > 0)
+		return getItems()[0];
+	}
+
+	/**
+	 * Returns a pointer to the retained
+	 * items. Items are not sorted.
+	 * @{
+	 */
+	FORCE_INLINE const T * begin() const
+	{
+		return getItems();
+	}
+
+	FORCE_INLINE const T * end() const
+	{
+		return getItems() + count;
+	}
+	/// @}
+
+	/**
+	 * Pushes a new item. The item is
+	 * retained if there is room or if
+	 * it is greater than the smallest
+	 * retained item, which is evicted.
+	 *
+	 * @param item item to push
+	 * @return true if item was retained
+	 */
+	template<typename ItemT>
+	FORCE_INLINE bool push(ItemT && item)
+	{
+		T * items = getItems();
+		if (count < K)
+		{
+			new (items + count) T(forward<ItemT>(item));
+			++count;
+
+			Heap::push(items, items + count, InverseCompareT{cmp});
+			return true;
+		}
+
+		if (cmp(item, items[0]) <= 0)
+			// Fast rejection
+			return false;
+
+		items[0] = forward<ItemT>(item);
+		Heap::siftDown(items, static_cast<int64>(count), 0, InverseCompareT{cmp});
+		return true;
+	}
+
+	/**
+	 * Pushes all the items in the range.
+	 *
+	 * @param begin,end begin and end iterators
+	 */
+	template<typename It>
+	void pushRange(It begin, It end)
+	{
+		// Fill the heap first, so that the
+		// loop below only needs the
+		// threshold check
+		for (; count < K && begin != end; ++begin) push(*begin);
+
+		T * items = getItems();
+		for (; begin != end; ++begin)
+		{
+			if (cmp(*begin, items[0]) > 0)
+			{
+				items[0] = *begin;
+				Heap::siftDown(items, static_cast<int64>(count), 0, InverseCompareT{cmp});
+			}
+		}
+	}
+
+	/**
+	 * Returns the retained items sorted
+	 * from greatest to smallest.
+	 *
+	 * @param malloc allocator of the
+	 * 	returned array
+	 * @return array of sorted items
+	 */
+	Array<T> getSorted(MallocBase * malloc = gMalloc) const
+	{
+		Array<T> out{malloc};
+		for (const T & item : *this) out.add(item);
+
+		// A min-heap sorted with the
+		// inverse compare function
+		// is in descending order
+		Heap::sort(out.begin(), out.end(), InverseCompareT{cmp});
+		return out;
+	}
+
+	/**
+	 * Removes all retained items.
+	 */
+	FORCE_INLINE void reset()
+	{
+		Memory::destroyElements(getItems(), getItems() + count);
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, reset)
+
+protected:
+	/**
+	 * Returns pointer to items storage.
+	 * @{
+	 */
+	FORCE_INLINE T * getItems()
+	{
+		return reinterpret_cast<T*>(storage);
+	}
+
+	FORCE_INLINE const T * getItems() const
+	{
+		return reinterpret_cast<const T*>(storage);
+	}
+	/// @}
+
+	/// Compare function
+	CompareT cmp;
+
+	/// Number of retained items
+	uint32 count;
+
+	/// Items storage
+	alignas(T) ubyte storage[K * sizeof(T)];
+};
@@ -188,6 +188,18 @@ struct ArrayIteratorBase : public IteratorTraitsT
 		return (it -= n);
 	}
 
+	/**
+	 * Returns the distance between two
+	 * iterators of the same array.
+	 *
+	 * @param other another iterator
+	 * @return signed distance in items
+	 */
+	FORCE_INLINE int64 operator-(const ArrayIteratorBase & other) const
+	{
+		return idx - other.idx;
+	}
+
 	/**
 	 * Subscript operation, returns i-th
 	 * element realtive to this iterator.
@@ -319,6 +331,7 @@ protected:
 			if (buffer)
 			{
 				Memory::constructCopyElements(inBuffer, buffer, count);
+				Memory::destroyElements(buffer, buffer + count);
 				malloc.free(buffer);
 			}
 
@@ -807,7 +820,7 @@ public:
 		--count;
 
 		// Destroy element
-		Memory::destroyElements(buffer + count, buffer + count);
+		Memory::destroyElements(buffer + count, buffer + count + 1);
 	}
 
 	/**
@@ -877,6 +890,51 @@ public:
 		count = capacity = 0;
 	}
 
+	/**
+	 * Makes sure the array can hold at least
+	 * the given number of items without
+	 * reallocating. Unlike growing the array,
+	 * the exact capacity is allocated.
+	 *
+	 * @param inCapacity required capacity
+	 */
+	void reserve(uint64 inCapacity)
+	{
+		if (inCapacity > capacity)
+		{
+			T * inBuffer = malloc.alloc(inCapacity);
+
+			if (buffer)
+			{
+				Memory::constructCopyElements(inBuffer, buffer, count);
+				Memory::destroyElements(buffer, buffer + count);
+				malloc.free(buffer);
+			}
+
+			buffer = inBuffer;
+			capacity = inCapacity;
+		}
+	}
+
+	/**
+	 * Sets the number of items. New items
+	 * are default constructed, items past
+	 * the new count are destroyed.
+	 *
+	 * @param inCount new number of items
+	 */
+	void resize(uint64 inCount)
+	{
+		if (inCount > count)
+		{
+			resizeIfNecessary(inCount);
+			Memory::constructDefaultElements(buffer + count, buffer + inCount);
+		}
+		else Memory::destroyElements(buffer + inCount, buffer + count);
+
+		count = inCount;
+	}
+
 	/**
 	 * Prints array to string.
 	 */
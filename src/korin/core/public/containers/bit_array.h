@@ -0,0 +1,1001 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/iterator.h"
+#include "templates/utility.h"
+#include "hal/platform_math.h"
+#include "./containers_types.h"
+#include "./array.h"
+
+#if PLATFORM_USE_SIMD && defined(__AVX2__)
+	#define BIT_ARRAY_USE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define BIT_ARRAY_USE_AVX2 0
+#endif
+
+/**
+ * Word-parallel operations on arrays
+ * of 64-bit words. When AVX2 is
+ * available, words are processed
+ * four at a time.
+ */
+struct BitWords
+{
+	/// Number of bits in a word
+	static constexpr uint64 numWordBits = 64;
+
+	/**
+	 * Bitwise operations, applied both
+	 * to single words and to vectors
+	 * of words.
+	 * @{
+	 */
+	struct And
+	{
+		FORCE_INLINE uint64 operator()(uint64 a, uint64 b) const { return a & b; }
+#if BIT_ARRAY_USE_AVX2
+		FORCE_INLINE __m256i operator()(__m256i a, __m256i b) const { return _mm256_and_si256(a, b); }
+#endif
+	};
+
+	struct Or
+	{
+		FORCE_INLINE uint64 operator()(uint64 a, uint64 b) const { return a | b; }
+#if BIT_ARRAY_USE_AVX2
+		FORCE_INLINE __m256i operator()(__m256i a, __m256i b) const { return _mm256_or_si256(a, b); }
+#endif
+	};
+
+	struct Xor
+	{
+		FORCE_INLINE uint64 operator()(uint64 a, uint64 b) const { return a ^ b; }
+#if BIT_ARRAY_USE_AVX2
+		FORCE_INLINE __m256i operator()(__m256i a, __m256i b) const { return _mm256_xor_si256(a, b); }
+#endif
+	};
+
+	struct AndNot
+	{
+		FORCE_INLINE uint64 operator()(uint64 a, uint64 b) const { return a & ~b; }
+#if BIT_ARRAY_USE_AVX2
+		// Note that andnot negates the
+		// first operand
+		FORCE_INLINE __m256i operator()(__m256i a, __m256i b) const { return _mm256_andnot_si256(b, a); }
+#endif
+	};
+	/// @}
+
+	/**
+	 * Applies a bitwise operation to two
+	 * arrays of words, and stores the
+	 * result in the first one.
+	 *
+	 * @param dst destination words
+	 * @param src source words
+	 * @param n number of words
+	 * @param op operation to apply
+	 */
+	template<typename OpT>
+	static FORCE_INLINE void apply(uint64 * RESTRICT dst, const uint64 * RESTRICT src, uint64 n, OpT op)
+	{
+		uint64 i = 0;
+
+#if BIT_ARRAY_USE_AVX2
+		for (; i + 4 <= n; i += 4)
+		{
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), op(a, b));
+		}
+#endif
+
+		for (; i < n; ++i) dst[i] = op(dst[i], src[i]);
+	}
+
+	/**
+	 * Returns the number of set bits in
+	 * a single word.
+	 */
+	static constexpr FORCE_INLINE uint64 count(uint64 word)
+	{
+		return __builtin_popcountll(word);
+	}
+
+	/**
+	 * Returns the number of set bits in
+	 * an array of words.
+	 *
+	 * When AVX2 is available it uses the
+	 * nibble lookup method: the bits of
+	 * each nibble are counted with a
+	 * byte shuffle, and byte counts are
+	 * summed with a sum of absolute
+	 * differences against zero.
+	 *
+	 * @param src source words
+	 * @param n number of words
+	 * @return number of set bits
+	 */
+	static uint64 count(const uint64 * src, uint64 n)
+	{
+		uint64 i = 0;
+		uint64 total = 0;
+
+#if BIT_ARRAY_USE_AVX2
+		const __m256i lookup = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+		);
+		const __m256i lowMask = _mm256_set1_epi8(0x0f);
+		__m256i acc = _mm256_setzero_si256();
+
+		for (; i + 4 <= n; i += 4)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			const __m256i lo = _mm256_and_si256(v, lowMask);
+			const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+			const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+			acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+		}
+
+		total = _mm256_extract_epi64(acc, 0)
+			+ _mm256_extract_epi64(acc, 1)
+			+ _mm256_extract_epi64(acc, 2)
+			+ _mm256_extract_epi64(acc, 3);
+#endif
+
+		for (; i < n; ++i) total += count(src[i]);
+		return total;
+	}
+
+	/**
+	 * Returns the position of the lowest
+	 * set bit of a non-zero word.
+	 */
+	static constexpr FORCE_INLINE uint64 findFirst(uint64 word)
+	{
+		return __builtin_ctzll(word);
+	}
+
+	/**
+	 * Returns the position of the k-th
+	 * lowest set bit of a word. The word
+	 * must have more than k set bits.
+	 */
+	static FORCE_INLINE uint64 select(uint64 word, uint64 k)
+	{
+		for (; k > 0; --k) word &= word - 1;
+		return findFirst(word);
+	}
+
+	/**
+	 * Returns a mask with the bits in
+	 * [begin, 64) set.
+	 */
+	static constexpr FORCE_INLINE uint64 getMaskFrom(uint64 begin)
+	{
+		return ~0ull << begin;
+	}
+
+	/**
+	 * Returns a mask with the bits in
+	 * [0, end) set, end must be less
+	 * than 64.
+	 */
+	static constexpr FORCE_INLINE uint64 getMaskTo(uint64 end)
+	{
+		return (1ull << end) - 1;
+	}
+};
+
+/**
+ * Iterator over the indices of the set
+ * bits of a bit array, in ascending
+ * order.
+ */
+struct BitArrayIterator : public ForwardIterator<const uint64>
+{
+	/**
+	 * Creates an iterator that points to
+	 * the first set bit at or after the
+	 * start of the given word.
+	 *
+	 * @param inWords words of the array
+	 * @param inNumWords number of words
+	 * @param inWordIdx index of first word
+	 */
+	FORCE_INLINE BitArrayIterator(const uint64 * inWords, uint64 inNumWords, uint64 inWordIdx)
+		: words{inWords}
+		, numWords{inNumWords}
+		, wordIdx{inWordIdx}
+		, word{inWordIdx < inNumWords ? inWords[inWordIdx] : 0}
+	{
+		skipEmptyWords();
+	}
+
+	/**
+	 * Returns the index of the current
+	 * set bit.
+	 */
+	FORCE_INLINE uint64 operator*() const
+	{
+		return wordIdx * BitWords::numWordBits + BitWords::findFirst(word);
+	}
+
+	/**
+	 * Returns true if both iterators
+	 * point to the same bit.
+	 * @{
+	 */
+	FORCE_INLINE bool operator==(const BitArrayIterator & other) const
+	{
+		return wordIdx == other.wordIdx && word == other.word;
+	}
+
+	FORCE_INLINE bool operator!=(const BitArrayIterator & other) const
+	{
+		return !(*this == other);
+	}
+	/// @}
+
+	/**
+	 * Moves to the next set bit.
+	 * @{
+	 */
+	FORCE_INLINE BitArrayIterator & operator++()
+	{
+		// Clear lowest set bit
+		word &= word - 1;
+		skipEmptyWords();
+
+		return *this;
+	}
+
+	FORCE_INLINE BitArrayIterator operator++(int32)
+	{
+		BitArrayIterator it{*this};
+		++(*this);
+		return it;
+	}
+	/// @}
+
+protected:
+	/**
+	 * Moves to the next non-empty word
+	 * if current word is empty.
+	 */
+	FORCE_INLINE void skipEmptyWords()
+	{
+		while (word == 0 && wordIdx < numWords)
+		{
+			if (++wordIdx < numWords) word = words[wordIdx];
+		}
+	}
+
+	/// Words of the array
+	const uint64 * words;
+
+	/// Number of words
+	uint64 numWords;
+
+	/// Index of current word
+	uint64 wordIdx;
+
+	/// Bits of current word not yet
+	/// visited
+	uint64 word;
+};
+
+/**
+ * A dynamic array of bits, packed in
+ * 64-bit words. Bulk operations work
+ * on whole words (and with AVX2 on
+ * four words at a time).
+ *
+ * Besides indexed access, it can be
+ * used as a compact set of small
+ * integers: set bits are iterated in
+ * ascending order, and the first or
+ * next set bit are found by scanning
+ * whole words.
+ *
+ * Bits past the count in the last word
+ * are always zero.
+ *
+ * @param MallocT allocator type
+ */
+template<typename MallocT>
+class BitArrayBase
+{
+	template<typename> friend class BitArrayBase;
+
+	using WordsT = Array<uint64, MallocT>;
+
+public:
+	using ConstIterator = BitArrayIterator;
+
+	/// Number of bits in a word
+	static constexpr uint64 numWordBits = BitWords::numWordBits;
+
+	/**
+	 * Creates an empty bit array.
+	 */
+	FORCE_INLINE BitArrayBase()
+		: words{}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Creates an empty bit array that
+	 * uses the given allocator.
+	 *
+	 * @param inMalloc allocator used by
+	 * 	the underlying array
+	 */
+	FORCE_INLINE explicit BitArrayBase(MallocBase * inMalloc)
+		: words{inMalloc}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Creates a bit array with the given
+	 * number of bits.
+	 *
+	 * @param inCount number of bits
+	 * @param value initial value of bits
+	 */
+	FORCE_INLINE explicit BitArrayBase(uint64 inCount, bool value = false)
+		: BitArrayBase{}
+	{
+		resize(inCount, value);
+	}
+
+	/**
+	 * Returns the number of bits.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	/// @}
+
+	/**
+	 * Returns the number of words.
+	 */
+	FORCE_INLINE uint64 getNumWords() const
+	{
+		return words.getCount();
+	}
+
+	/**
+	 * Returns pointer to the words.
+	 * @{
+	 */
+	FORCE_INLINE const uint64 * getWords() const
+	{
+		return *words;
+	}
+
+	FORCE_INLINE uint64 * getWords()
+	{
+		return *words;
+	}
+	/// @}
+
+	/**
+	 * Returns true if the array has no
+	 * bits.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Changes the number of bits. New
+	 * bits are initialized with the
+	 * given value.
+	 *
+	 * @param inCount new number of bits
+	 * @param value value of new bits
+	 */
+	void resize(uint64 inCount, bool value = false)
+	{
+		const uint64 prevCount = count;
+		const uint64 numWords = getNumWordsFor(inCount);
+
+		if (numWords < words.getCount())
+		{
+			words.removeAt(numWords, words.getCount() - numWords);
+		}
+		else
+		{
+			while (words.getCount() < numWords) words.add(0ull);
+		}
+
+		count = inCount;
+
+		if (inCount > prevCount && value)
+		{
+			setRange(prevCount, inCount);
+		}
+		else
+		{
+			clearTrailingBits();
+		}
+	}
+
+	/**
+	 * Appends a bit at the end of the
+	 * array.
+	 *
+	 * @param value value of the bit
+	 */
+	FORCE_INLINE void add(bool value)
+	{
+		if ((count & (numWordBits - 1)) == 0) words.add(0ull);
+		set(count++, value);
+	}
+
+	/**
+	 * Returns the value of the idx-th
+	 * bit.
+	 * @{
+	 */
+	FORCE_INLINE bool test(uint64 idx) const
+	{
+		CHECK(idx < count)
+		return (words[idx / numWordBits] >> (idx % numWordBits)) & 1;
+	}
+
+	FORCE_INLINE bool operator[](uint64 idx) const
+	{
+		return test(idx);
+	}
+
+	METHOD_ALIAS_CONST(get, test)
+	/// @}
+
+	/**
+	 * Sets the value of the idx-th bit.
+	 *
+	 * @param idx bit index
+	 * @param value bit value
+	 */
+	FORCE_INLINE void set(uint64 idx, bool value = true)
+	{
+		CHECK(idx < count)
+
+		const uint64 mask = 1ull << (idx % numWordBits);
+		uint64 & word = words[idx / numWordBits];
+		word = value ? word | mask : word & ~mask;
+	}
+
+	/**
+	 * Clears the idx-th bit.
+	 */
+	FORCE_INLINE void unset(uint64 idx)
+	{
+		set(idx, false);
+	}
+
+	/**
+	 * Flips the idx-th bit.
+	 */
+	FORCE_INLINE void flip(uint64 idx)
+	{
+		CHECK(idx < count)
+		words[idx / numWordBits] ^= 1ull << (idx % numWordBits);
+	}
+
+	/**
+	 * Sets the idx-th bit and returns
+	 * its previous value. Useful to mark
+	 * states as visited.
+	 *
+	 * @param idx bit index
+	 * @return true if bit was already set
+	 */
+	FORCE_INLINE bool testAndSet(uint64 idx)
+	{
+		CHECK(idx < count)
+
+		const uint64 mask = 1ull << (idx % numWordBits);
+		uint64 & word = words[idx / numWordBits];
+		const bool prev = (word & mask) != 0;
+		word |= mask;
+		return prev;
+	}
+
+	/**
+	 * Sets or clears all bits in the
+	 * range [begin, end).
+	 *
+	 * @param begin,end range of bits
+	 * @{
+	 */
+	FORCE_INLINE void setRange(uint64 begin, uint64 end)
+	{
+		applyRange<true>(begin, end);
+	}
+
+	FORCE_INLINE void unsetRange(uint64 begin, uint64 end)
+	{
+		applyRange<false>(begin, end);
+	}
+	/// @}
+
+	/**
+	 * Sets or clears all bits.
+	 * @{
+	 */
+	FORCE_INLINE void setAll()
+	{
+		for (uint64 & word : words) word = ~0ull;
+		clearTrailingBits();
+	}
+
+	FORCE_INLINE void unsetAll()
+	{
+		for (uint64 & word : words) word = 0ull;
+	}
+	/// @}
+
+	/**
+	 * Returns the number of set bits.
+	 */
+	FORCE_INLINE uint64 countSet() const
+	{
+		return BitWords::count(*words, words.getCount());
+	}
+
+	/**
+	 * Returns true if any bit is set.
+	 */
+	FORCE_INLINE bool isAnySet() const
+	{
+		return findFirstSet() >= 0;
+	}
+
+	/**
+	 * Returns the index of the first set
+	 * bit at or after the given index,
+	 * or -1 if there is none.
+	 *
+	 * @param idx index of first bit to
+	 * 	test
+	 * @return index of set bit or -1
+	 * @{
+	 */
+	int64 findNextSet(uint64 idx) const
+	{
+		if (idx >= count) return -1;
+
+		uint64 wordIdx = idx / numWordBits;
+		uint64 word = words[wordIdx] & BitWords::getMaskFrom(idx % numWordBits);
+
+		for (;;)
+		{
+			if (word) return static_cast<int64>(wordIdx * numWordBits + BitWords::findFirst(word));
+			if (++wordIdx == words.getCount()) return -1;
+
+			word = words[wordIdx];
+		}
+	}
+
+	FORCE_INLINE int64 findFirstSet() const
+	{
+		return findNextSet(0);
+	}
+	/// @}
+
+	/**
+	 * Returns the index of the first
+	 * unset bit at or after the given
+	 * index, or -1 if there is none.
+	 *
+	 * @param idx index of first bit to
+	 * 	test
+	 * @return index of unset bit or -1
+	 * @{
+	 */
+	int64 findNextUnset(uint64 idx) const
+	{
+		if (idx >= count) return -1;
+
+		uint64 wordIdx = idx / numWordBits;
+		uint64 word = ~words[wordIdx] & BitWords::getMaskFrom(idx % numWordBits);
+
+		for (;;)
+		{
+			if (word)
+			{
+				// Trailing bits are unset, but
+				// are not part of the array
+				const uint64 found = wordIdx * numWordBits + BitWords::findFirst(word);
+				return found < count ? static_cast<int64>(found) : -1;
+			}
+
+			if (++wordIdx == words.getCount()) return -1;
+
+			word = ~words[wordIdx];
+		}
+	}
+
+	FORCE_INLINE int64 findFirstUnset() const
+	{
+		return findNextUnset(0);
+	}
+	/// @}
+
+	/**
+	 * Returns the number of set bits in
+	 * the range [0, idx).
+	 *
+	 * @param idx end of range
+	 * @return number of set bits
+	 */
+	uint64 rank(uint64 idx) const
+	{
+		CHECK(idx <= count)
+
+		const uint64 wordIdx = idx / numWordBits;
+		uint64 total = BitWords::count(*words, wordIdx);
+
+		if (idx % numWordBits)
+		{
+			total += BitWords::count(words[wordIdx] & BitWords::getMaskTo(idx % numWordBits));
+		}
+
+		return total;
+	}
+
+	/**
+	 * Returns the index of the k-th set
+	 * bit (starting from 0), or -1 if
+	 * there are not enough set bits.
+	 * Runs in linear time, use a rank
+	 * index for repeated queries.
+	 *
+	 * @param k rank of the bit
+	 * @return index of bit or -1
+	 */
+	int64 select(uint64 k) const
+	{
+		for (uint64 wordIdx = 0; wordIdx < words.getCount(); ++wordIdx)
+		{
+			const uint64 wordCount = BitWords::count(words[wordIdx]);
+			if (k < wordCount) return static_cast<int64>(wordIdx * numWordBits + BitWords::select(words[wordIdx], k));
+
+			k -= wordCount;
+		}
+
+		return -1;
+	}
+
+	/**
+	 * Bitwise operations with another
+	 * bit array of the same size.
+	 *
+	 * @param other another bit array
+	 * @return ref to self
+	 * @{
+	 */
+	template<typename OtherMallocT>
+	FORCE_INLINE BitArrayBase & operator&=(const BitArrayBase<OtherMallocT> & other)
+	{
+		return apply(other, BitWords::And{});
+	}
+
+	template<typename OtherMallocT>
+	FORCE_INLINE BitArrayBase & operator|=(const BitArrayBase<OtherMallocT> & other)
+	{
+		return apply(other, BitWords::Or{});
+	}
+
+	template<typename OtherMallocT>
+	FORCE_INLINE BitArrayBase & operator^=(const BitArrayBase<OtherMallocT> & other)
+	{
+		return apply(other, BitWords::Xor{});
+	}
+
+	template<typename OtherMallocT>
+	FORCE_INLINE BitArrayBase & andNot(const BitArrayBase<OtherMallocT> & other)
+	{
+		return apply(other, BitWords::AndNot{});
+	}
+	/// @}
+
+	/**
+	 * Returns true if both arrays have
+	 * the same bits.
+	 * @{
+	 */
+	template<typename OtherMallocT>
+	bool operator==(const BitArrayBase<OtherMallocT> & other) const
+	{
+		if (count != other.count) return false;
+
+		for (uint64 i = 0; i < words.getCount(); ++i)
+			if (words[i] != other.words[i]) return false;
+
+		return true;
+	}
+
+	template<typename OtherMallocT>
+	FORCE_INLINE bool operator!=(const BitArrayBase<OtherMallocT> & other) const
+	{
+		return !(*this == other);
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator over the
+	 * indices of the set bits.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{*words, words.getCount(), 0};
+	}
+
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{*words, words.getCount(), words.getCount()};
+	}
+	/// @}
+
+	/**
+	 * Removes all bits.
+	 * @{
+	 */
+	FORCE_INLINE void empty()
+	{
+		words.empty();
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+	/**
+	 * Removes all bits and deallocates
+	 * storage.
+	 */
+	FORCE_INLINE void reset()
+	{
+		words.reset();
+		count = 0;
+	}
+
+protected:
+	/**
+	 * Returns the number of words
+	 * required to store the given
+	 * number of bits.
+	 */
+	static constexpr FORCE_INLINE uint64 getNumWordsFor(uint64 numBits)
+	{
+		return (numBits + numWordBits - 1) / numWordBits;
+	}
+
+	/**
+	 * Clears the bits of the last word
+	 * that are past the count.
+	 */
+	FORCE_INLINE void clearTrailingBits()
+	{
+		if (count % numWordBits)
+		{
+			words[words.getCount() - 1] &= BitWords::getMaskTo(count % numWordBits);
+		}
+	}
+
+	/**
+	 * Sets or clears all the bits in
+	 * the range [begin, end).
+	 */
+	template<bool value>
+	void applyRange(uint64 begin, uint64 end)
+	{
+		CHECK(begin <= end && end <= count)
+		if (begin == end) return;
+
+		const uint64 firstWord = begin / numWordBits;
+		const uint64 lastWord = (end - 1) / numWordBits;
+		const uint64 firstMask = BitWords::getMaskFrom(begin % numWordBits);
+		const uint64 lastMask = ~0ull >> (numWordBits - 1 - (end - 1) % numWordBits);
+
+		if (firstWord == lastWord)
+		{
+			const uint64 mask = firstMask & lastMask;
+			words[firstWord] = value ? words[firstWord] | mask : words[firstWord] & ~mask;
+			return;
+		}
+
+		words[firstWord] = value ? words[firstWord] | firstMask : words[firstWord] & ~firstMask;
+		for (uint64 i = firstWord + 1; i < lastWord; ++i) words[i] = value ? ~0ull : 0ull;
+		words[lastWord] = value ? words[lastWord] | lastMask : words[lastWord] & ~lastMask;
+	}
+
+	/**
+	 * Applies a bitwise operation with
+	 * another array of the same size.
+	 */
+	template<typename OtherMallocT, typename OpT>
+	FORCE_INLINE BitArrayBase & apply(const BitArrayBase<OtherMallocT> & other, OpT op)
+	{
+		CHECKF(count == other.count, "Bit arrays must have the same size")
+
+		BitWords::apply(*words, *other.words, words.getCount(), op);
+		return *this;
+	}
+
+	/// Underlying words
+	WordsT words;
+
+	/// Number of bits
+	uint64 count;
+};
+
+/**
+ * An auxiliary index that answers rank
+ * queries in constant time and select
+ * queries in logarithmic time on an
+ * immutable bit array.
+ *
+ * It stores the number of set bits
+ * that precede each block of eight
+ * words (a cache line). The index
+ * must be rebuilt after the bit array
+ * is modified.
+ */
+class BitRankIndex
+{
+public:
+	/// Number of words per block
+	static constexpr uint64 numBlockWords = 8;
+
+	/// Number of bits per block
+	static constexpr uint64 numBlockBits = numBlockWords * BitWords::numWordBits;
+
+	/**
+	 * Creates an empty index.
+	 */
+	FORCE_INLINE BitRankIndex()
+		: words{nullptr}
+		, numWords{0}
+		, numBits{0}
+		, blockRanks{}
+	{
+		//
+	}
+
+	/**
+	 * Creates an index for the given
+	 * bit array.
+	 *
+	 * @param bits bit array to index
+	 */
+	template<typename MallocT>
+	FORCE_INLINE explicit BitRankIndex(const BitArrayBase<MallocT> & bits)
+		: BitRankIndex{}
+	{
+		build(bits);
+	}
+
+	/**
+	 * Rebuilds the index for the given
+	 * bit array.
+	 *
+	 * @param bits bit array to index
+	 */
+	template<typename MallocT>
+	void build(const BitArrayBase<MallocT> & bits)
+	{
+		words = bits.getWords();
+		numWords = bits.getNumWords();
+		numBits = bits.getCount();
+
+		blockRanks.empty();
+
+		uint64 total = 0;
+		for (uint64 i = 0; i < numWords; i += numBlockWords)
+		{
+			blockRanks.add(total);
+			total += BitWords::count(words + i, PlatformMath::min(numBlockWords, numWords - i));
+		}
+
+		// Sentinel block with total count
+		blockRanks.add(total);
+	}
+
+	/**
+	 * Returns total number of set bits.
+	 */
+	FORCE_INLINE uint64 getNumSet() const
+	{
+		return blockRanks.getCount() ? blockRanks[blockRanks.getCount() - 1] : 0;
+	}
+
+	/**
+	 * Returns the number of set bits in
+	 * the range [0, idx).
+	 *
+	 * @param idx end of range
+	 * @return number of set bits
+	 */
+	uint64 rank(uint64 idx) const
+	{
+		CHECK(idx <= numBits)
+
+		const uint64 blockIdx = idx / numBlockBits;
+		const uint64 wordIdx = idx / BitWords::numWordBits;
+
+		uint64 total = blockRanks[blockIdx];
+		for (uint64 i = blockIdx * numBlockWords; i < wordIdx; ++i) total += BitWords::count(words[i]);
+
+		if (idx % BitWords::numWordBits)
+		{
+			total += BitWords::count(words[wordIdx] & BitWords::getMaskTo(idx % BitWords::numWordBits));
+		}
+
+		return total;
+	}
+
+	/**
+	 * Returns the index of the k-th set
+	 * bit (starting from 0), or -1 if
+	 * there are not enough set bits.
+	 *
+	 * @param k rank of the bit
+	 * @return index of bit or -1
+	 */
+	int64 select(uint64 k) const
+	{
+		if (k >= getNumSet()) return -1;
+
+		// Find last block whose rank is
+		// not greater than k
+		uint64 lo = 0, hi = blockRanks.getCount() - 1;
+		while (hi - lo > 1)
+		{
+			const uint64 mid = (lo + hi) / 2;
+			if (blockRanks[mid] <= k) lo = mid;
+			else hi = mid;
+		}
+
+		k -= blockRanks[lo];
+		for (uint64 i = lo * numBlockWords;; ++i)
+		{
+			const uint64 wordCount = BitWords::count(words[i]);
+			if (k < wordCount) return static_cast<int64>(i * BitWords::numWordBits + BitWords::select(words[i], k));
+
+			k -= wordCount;
+		}
+	}
+
+protected:
+	/// Words of the indexed array
+	const uint64 * words;
+
+	/// Number of words
+	uint64 numWords;
+
+	/// Number of bits
+	uint64 numBits;
+
+	/// Number of set bits before each
+	/// block, plus total count
+	Array<uint64> blockRanks;
+};
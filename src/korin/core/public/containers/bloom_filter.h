@@ -0,0 +1,471 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "templates/hash.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_math.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+
+#if PLATFORM_USE_SIMD && defined(__AVX2__)
+	#define BLOOM_FILTER_USE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define BLOOM_FILTER_USE_AVX2 0
+#endif
+
+/**
+ * A blocked Bloom filter. Each key maps
+ * to a single cache-line-sized block,
+ * and sets one bit in each of the eight
+ * 64-bit words of the block, so that a
+ * query touches one cache line only.
+ * With AVX2 the bit mask of a key is
+ * computed and tested in two 256-bit
+ * registers.
+ *
+ * The filter may report false positives
+ * but never false negatives. With 10
+ * bits per key the false positive rate
+ * is about 1%.
+ *
+ * @param T type of the keys
+ * @param HashT hash function type
+ */
+template<typename T, typename HashT>
+class BloomFilter<T, HashT, void>
+{
+protected:
+	/// Number of bits per block
+	static constexpr uint32 bitsPerBlock = 512;
+
+	/// Number of words per block
+	static constexpr uint32 wordsPerBlock = bitsPerBlock / 64;
+
+	/// Number of keys hashed before
+	/// probing, in batch operations
+	static constexpr uint32 batchSize = 16;
+
+	/**
+	 * A block of the filter, as large
+	 * as a cache line.
+	 */
+	struct alignas(64) Block
+	{
+		uint64 words[wordsPerBlock];
+	};
+
+	/**
+	 * Odd multipliers used to derive the
+	 * bit of each word from the key hash.
+	 */
+	static constexpr uint32 salts[wordsPerBlock] = {
+		0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+		0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+	};
+
+	/**
+	 * Returns the block that the hash
+	 * maps to, using the high 32 bits.
+	 */
+	FORCE_INLINE uint64 getBlockIndex(uint64 hash) const
+	{
+		return ((hash >> 32) * numBlocks) >> 32;
+	}
+
+#if BLOOM_FILTER_USE_AVX2
+	/**
+	 * Computes the mask of the key in
+	 * two 256-bit halves.
+	 *
+	 * @param hash hash of the key
+	 * @param outLo,outHi mask of words
+	 * 	0-3 and 4-7
+	 */
+	static FORCE_INLINE void makeMask(uint64 hash, __m256i & outLo, __m256i & outHi)
+	{
+		const __m256i key = _mm256_set1_epi32(static_cast<int32>(hash));
+		const __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salts));
+		const __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(key, salt), 26);
+		const __m256i one = _mm256_set1_epi64x(1);
+
+		outLo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(shifts)));
+		outHi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(shifts, 1)));
+	}
+#endif
+
+	/**
+	 * Sets the bits of the key in its
+	 * block.
+	 */
+	FORCE_INLINE void insertHashImpl(uint64 hash)
+	{
+		Block & block = blocks[getBlockIndex(hash)];
+
+#if BLOOM_FILTER_USE_AVX2
+		__m256i lo, hi;
+		makeMask(hash, lo, hi);
+
+		__m256i * words = reinterpret_cast<__m256i*>(block.words);
+		_mm256_store_si256(words, _mm256_or_si256(_mm256_load_si256(words), lo));
+		_mm256_store_si256(words + 1, _mm256_or_si256(_mm256_load_si256(words + 1), hi));
+#else
+		const uint32 key = static_cast<uint32>(hash);
+		for (uint32 i = 0; i < wordsPerBlock; ++i)
+			block.words[i] |= 1ull << ((key * salts[i]) >> 26);
+#endif
+	}
+
+	/**
+	 * Returns true if all the bits of the
+	 * key are set in its block.
+	 */
+	FORCE_INLINE bool containsHashImpl(uint64 hash) const
+	{
+		const Block & block = blocks[getBlockIndex(hash)];
+
+#if BLOOM_FILTER_USE_AVX2
+		__m256i lo, hi;
+		makeMask(hash, lo, hi);
+
+		const __m256i * words = reinterpret_cast<const __m256i*>(block.words);
+		return _mm256_testc_si256(_mm256_load_si256(words), lo) & _mm256_testc_si256(_mm256_load_si256(words + 1), hi);
+#else
+		const uint32 key = static_cast<uint32>(hash);
+		uint64 missing = 0;
+		for (uint32 i = 0; i < wordsPerBlock; ++i)
+		{
+			const uint64 mask = 1ull << ((key * salts[i]) >> 26);
+			missing |= mask & ~block.words[i];
+		}
+
+		return missing == 0;
+#endif
+	}
+
+	/**
+	 * Allocates and clears the blocks of
+	 * the filter.
+	 *
+	 * @param numKeys expected number of
+	 * 	keys
+	 * @param bitsPerKey bits of the filter
+	 * 	per key
+	 */
+	void allocate(uint64 numKeys, uint32 bitsPerKey)
+	{
+		numBlocks = PlatformMath::max((numKeys * bitsPerKey + bitsPerBlock - 1) / bitsPerBlock, 1ull);
+		CHECKF(numBlocks <= 0xffffffffull, "Too many blocks in Bloom filter")
+
+		blocks = malloc.alloc(numBlocks);
+		empty();
+	}
+
+	/**
+	 * Creates an empty filter with no
+	 * blocks, that uses the given
+	 * allocator. Call allocate before
+	 * using it.
+	 */
+	FORCE_INLINE explicit BloomFilter(MallocBase * inMalloc)
+		: malloc{inMalloc}
+		, blocks{nullptr}
+		, numBlocks{0}
+		, count{0}
+		, hash{}
+	{
+		//
+	}
+
+	/**
+	 * Deallocates the blocks.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		if (blocks)
+		{
+			malloc.free(blocks);
+			blocks = nullptr;
+		}
+
+		numBlocks = count = 0;
+	}
+
+public:
+	/// Default number of bits per key
+	static constexpr uint32 defaultBitsPerKey = 10;
+
+	/**
+	 * Creates an empty filter sized for
+	 * the given number of keys.
+	 *
+	 * @param numKeys expected number of
+	 * 	keys
+	 * @param [bitsPerKey] bits of the
+	 * 	filter per key
+	 * @param [inMalloc] allocator used
+	 * 	for the blocks
+	 */
+	FORCE_INLINE explicit BloomFilter(uint64 numKeys, uint32 bitsPerKey = defaultBitsPerKey, MallocBase * inMalloc = gMalloc)
+		: BloomFilter{inMalloc}
+	{
+		allocate(numKeys, bitsPerKey);
+	}
+
+	/**
+	 * Filters are not copyable.
+	 * @{
+	 */
+	BloomFilter(const BloomFilter&) = delete;
+	BloomFilter & operator=(const BloomFilter&) = delete;
+	/// @}
+
+	/**
+	 * Move constructor.
+	 */
+	BloomFilter(BloomFilter && other)
+		: malloc{move(other.malloc)}
+		, blocks{other.blocks}
+		, numBlocks{other.numBlocks}
+		, count{other.count}
+		, hash{move(other.hash)}
+	{
+		other.blocks = nullptr;
+		other.numBlocks = other.count = 0;
+	}
+
+	/**
+	 * Destructor, deallocates blocks.
+	 */
+	FORCE_INLINE ~BloomFilter()
+	{
+		destroy();
+	}
+
+	/**
+	 * Returns the number of inserted
+	 * keys, including duplicates.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns the number of blocks.
+	 */
+	FORCE_INLINE uint64 getNumBlocks() const
+	{
+		return numBlocks;
+	}
+
+	/**
+	 * Returns the size of the filter, in
+	 * bits.
+	 */
+	FORCE_INLINE uint64 getNumBits() const
+	{
+		return numBlocks * bitsPerBlock;
+	}
+
+	/**
+	 * Inserts a key in the filter.
+	 *
+	 * @param key key to insert
+	 * @{
+	 */
+	FORCE_INLINE void insert(const T & key)
+	{
+		insertHash(hash(key));
+	}
+
+	METHOD_ALIAS(add, insert)
+	/// @}
+
+	/**
+	 * Inserts a key given its hash.
+	 *
+	 * @param keyHash hash of the key
+	 */
+	FORCE_INLINE void insertHash(uint64 keyHash)
+	{
+		insertHashImpl(keyHash);
+		++count;
+	}
+
+	/**
+	 * Inserts a batch of keys. Hashes
+	 * are computed and blocks prefetched
+	 * ahead of the updates.
+	 *
+	 * @param keys pointer to first key
+	 * @param numKeys number of keys
+	 */
+	void insert(const T * keys, uint64 numKeys)
+	{
+		uint64 hashes[batchSize];
+		for (uint64 i = 0; i < numKeys; i += batchSize)
+		{
+			const uint32 n = static_cast<uint32>(PlatformMath::min(numKeys - i, static_cast<uint64>(batchSize)));
+			for (uint32 j = 0; j < n; ++j)
+			{
+				hashes[j] = hash(keys[i + j]);
+				PlatformMemory::prefetch(blocks + getBlockIndex(hashes[j]));
+			}
+
+			for (uint32 j = 0; j < n; ++j) insertHashImpl(hashes[j]);
+		}
+
+		count += numKeys;
+	}
+
+	/**
+	 * Returns true if the key may be in
+	 * the filter, false if it is surely
+	 * not.
+	 *
+	 * @param key key to test
+	 * @return false if key is not in the
+	 * 	filter
+	 * @{
+	 */
+	FORCE_INLINE bool contains(const T & key) const
+	{
+		return containsHashImpl(hash(key));
+	}
+
+	METHOD_ALIAS_CONST(mayContain, contains)
+	/// @}
+
+	/**
+	 * Tests a key given its hash.
+	 *
+	 * @param keyHash hash of the key
+	 * @return false if key is not in the
+	 * 	filter
+	 */
+	FORCE_INLINE bool containsHash(uint64 keyHash) const
+	{
+		return containsHashImpl(keyHash);
+	}
+
+	/**
+	 * Tests a batch of keys. Hashes are
+	 * computed and blocks prefetched
+	 * ahead of the tests.
+	 *
+	 * @param keys pointer to first key
+	 * @param numKeys number of keys
+	 * @param outResults result of each
+	 * 	test, as per contains
+	 * @return number of keys that may be
+	 * 	in the filter
+	 */
+	uint64 contains(const T * keys, uint64 numKeys, bool * outResults) const
+	{
+		uint64 numPositives = 0;
+		uint64 hashes[batchSize];
+
+		for (uint64 i = 0; i < numKeys; i += batchSize)
+		{
+			const uint32 n = static_cast<uint32>(PlatformMath::min(numKeys - i, static_cast<uint64>(batchSize)));
+			for (uint32 j = 0; j < n; ++j)
+			{
+				hashes[j] = hash(keys[i + j]);
+				PlatformMemory::prefetch(blocks + getBlockIndex(hashes[j]));
+			}
+
+			for (uint32 j = 0; j < n; ++j)
+			{
+				const bool result = containsHashImpl(hashes[j]);
+				outResults[i + j] = result;
+				numPositives += result;
+			}
+		}
+
+		return numPositives;
+	}
+
+	/**
+	 * Removes all keys.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint64 i = 0; i < numBlocks; ++i) blocks[i] = Block{};
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/// Blocks allocator
+	MallocObject<Block> malloc;
+
+	/// Blocks of the filter
+	Block * blocks;
+
+	/// Number of blocks
+	uint64 numBlocks;
+
+	/// Number of inserted keys
+	uint64 count;
+
+	/// Hash function
+	HashT hash;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param T type of the keys
+ * @param HashT hash function type
+ * @param MallocT allocator type
+ */
+template<typename T, typename HashT, typename MallocT>
+class BloomFilter : public BloomFilter<T, HashT, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = BloomFilter<T, HashT, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty filter that uses it.
+	 *
+	 * @param numKeys expected number of
+	 * 	keys
+	 * @param bitsPerKey bits of the filter
+	 * 	per key
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE BloomFilter(uint64 numKeys, uint32 bitsPerKey, MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		Base::allocate(numKeys, bitsPerKey);
+	}
+
+	/**
+	 * Destructor, destroy blocks here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~BloomFilter()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
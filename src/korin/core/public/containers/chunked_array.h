@@ -0,0 +1,743 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/iterator.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_math.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+#include "./array.h"
+
+/**
+ * Iterator used to iterate over the
+ * items of a chunked array. It keeps
+ * a pointer to the array, which makes
+ * it assignable.
+ *
+ * @param ChunkedArrayT type of array
+ * @param IteratorTraitsT type that
+ * 	define the iterator types
+ */
+template<typename ChunkedArrayT, typename IteratorTraitsT>
+struct ChunkedArrayIteratorBase : public IteratorTraitsT
+{
+	using RefT = typename IteratorTraitsT::RefT;
+	using PtrT = typename IteratorTraitsT::PtrT;
+
+	/**
+	 * Construct for array, pointing at
+	 * idx-th element.
+	 *
+	 * @param inArray ref to array
+	 * @param [inIdx = 0] start index
+	 */
+	FORCE_INLINE ChunkedArrayIteratorBase(ChunkedArrayT & inArray, int64 inIdx = 0)
+		: array{&inArray}
+		, idx{inIdx}
+	{
+		//
+	}
+
+	/**
+	 * Dereference iterator, return ref to
+	 * idx-th item.
+	 */
+	FORCE_INLINE RefT operator*() const
+	{
+		return (*array)[idx];
+	}
+
+	/**
+	 * Dereference iterator, return pointer
+	 * to idx-th item.
+	 */
+	FORCE_INLINE PtrT operator->() const
+	{
+		return &(**this);
+	}
+
+	/**
+	 * Returns true if both iterators point
+	 * to the same position.
+	 * @{
+	 */
+	FORCE_INLINE bool operator==(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx == other.idx;
+	}
+
+	FORCE_INLINE bool operator!=(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx != other.idx;
+	}
+	/// @}
+
+	/**
+	 * Moves iterator to the next item.
+	 * @{
+	 */
+	FORCE_INLINE ChunkedArrayIteratorBase & operator++()
+	{
+		++idx;
+		return *this;
+	}
+
+	FORCE_INLINE ChunkedArrayIteratorBase operator++(int32)
+	{
+		ChunkedArrayIteratorBase it{*this};
+
+		++idx;
+		return it;
+	}
+	/// @}
+
+	/**
+	 * Moves iterator to the previous item.
+	 * @{
+	 */
+	FORCE_INLINE ChunkedArrayIteratorBase & operator--()
+	{
+		--idx;
+		return *this;
+	}
+
+	FORCE_INLINE ChunkedArrayIteratorBase operator--(int32)
+	{
+		ChunkedArrayIteratorBase it{*this};
+
+		--idx;
+		return it;
+	}
+	/// @}
+
+	/**
+	 * Increments or decrements iterator
+	 * by the given amount.
+	 *
+	 * @param n increment amount
+	 * @return ref to self or new iterator
+	 * @{
+	 */
+	FORCE_INLINE ChunkedArrayIteratorBase & operator+=(int64 n)
+	{
+		idx += n;
+		return *this;
+	}
+
+	FORCE_INLINE ChunkedArrayIteratorBase operator+(int64 n) const
+	{
+		ChunkedArrayIteratorBase it{*this};
+		return (it += n);
+	}
+
+	FORCE_INLINE ChunkedArrayIteratorBase & operator-=(int64 n)
+	{
+		idx -= n;
+		return *this;
+	}
+
+	FORCE_INLINE ChunkedArrayIteratorBase operator-(int64 n) const
+	{
+		ChunkedArrayIteratorBase it{*this};
+		return (it -= n);
+	}
+	/// @}
+
+	/**
+	 * Returns the distance between two
+	 * iterators of the same array.
+	 *
+	 * @param other another iterator
+	 * @return signed distance in items
+	 */
+	FORCE_INLINE int64 operator-(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx - other.idx;
+	}
+
+	/**
+	 * Subscript operation, returns i-th
+	 * element realtive to this iterator.
+	 *
+	 * @param i index relative to this
+	 * 	iterator
+	 * @return ref to i-th item
+	 */
+	FORCE_INLINE RefT operator[](int64 i) const
+	{
+		return (*array)[idx + i];
+	}
+
+	/**
+	 * Ordering operations.
+	 *
+	 * @param other another iterator
+	 * @return true if the comparison
+	 * 	stands
+	 * @{
+	 */
+	FORCE_INLINE bool operator<(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx < other.idx;
+	}
+
+	FORCE_INLINE bool operator>(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx > other.idx;
+	}
+
+	FORCE_INLINE bool operator<=(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx <= other.idx;
+	}
+
+	FORCE_INLINE bool operator>=(const ChunkedArrayIteratorBase & other) const
+	{
+		return idx >= other.idx;
+	}
+	/** @} */
+
+private:
+	/// Underlying array
+	ChunkedArrayT * array;
+
+	/// Current index
+	int64 idx;
+};
+
+/**
+ * A dynamic array whose items are
+ * stored in fixed-size chunks. The
+ * array grows by appending chunks, so
+ * items are never relocated and refs
+ * to them stay valid until they are
+ * removed.
+ *
+ * Indexed access is O(1): the number
+ * of items per chunk is a power of
+ * two, so the chunk and the position
+ * in the chunk are computed with a
+ * shift and a mask.
+ *
+ * Chunks are allocated with the given
+ * allocator, while the table of chunk
+ * pointers uses the global allocator.
+ * Chunks can thus be served by a pool
+ * allocator (e.g. `MallocPool`) whose
+ * block size is at least chunkBytes.
+ *
+ * Only removeAtSwap and removeIf move
+ * items around, and removed chunks are
+ * kept for reuse until compact is
+ * called.
+ *
+ * @param T type of the items
+ * @param chunkSize number of items per
+ * 	chunk, a power of two. If zero it
+ * 	is computed so that a chunk is
+ * 	about 4 KiB
+ */
+template<typename T, uint32 chunkSize>
+class ChunkedArray<T, chunkSize, void>
+{
+	template<typename, uint32, typename> friend class ChunkedArray;
+
+	/// Target size of a chunk, in bytes
+	static constexpr sizet targetChunkBytes = 4096;
+
+	/**
+	 * Returns the largest power of two
+	 * not greater than n, or one.
+	 */
+	static constexpr uint32 floorPow2(sizet n)
+	{
+		return n <= 1 ? 1 : 2 * floorPow2(n / 2);
+	}
+
+public:
+	/// Actual number of items per chunk
+	static constexpr uint32 itemsPerChunk = chunkSize ? chunkSize : floorPow2(targetChunkBytes / sizeof(T));
+
+	/// Size of a chunk, in bytes
+	static constexpr sizet chunkBytes = itemsPerChunk * sizeof(T);
+
+	static_assert((itemsPerChunk & (itemsPerChunk - 1)) == 0, "Chunk size must be a power of two");
+
+	using ChunkedArrayT = ChunkedArray<T, chunkSize, void>;
+	using ItemT = T;
+	using ConstIterator = ChunkedArrayIteratorBase<const ChunkedArrayT, RandomAccessIterator<const T>>;
+	using Iterator = ChunkedArrayIteratorBase<ChunkedArrayT, RandomAccessIterator<T>>;
+
+protected:
+	/// Shift and mask used to split an
+	/// index in chunk and offset
+	/// @{
+	static constexpr uint32 chunkShift = PlatformMath::log2(itemsPerChunk);
+	static constexpr uint64 chunkMask = itemsPerChunk - 1;
+	/// @}
+
+	/**
+	 * Destroys all items and
+	 * deallocates all chunks.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		empty();
+		compact();
+	}
+
+	/**
+	 * Allocates a new chunk and appends
+	 * it to the table.
+	 */
+	void appendChunk()
+	{
+		T * chunk = malloc.alloc(itemsPerChunk);
+		CHECKF(chunk != nullptr, "Failed to allocate chunk of %llu bytes", static_cast<uint64>(chunkBytes))
+
+		chunks.add(chunk);
+	}
+
+public:
+	/**
+	 * Default constructor, creates empty
+	 * array with global allocator.
+	 */
+	FORCE_INLINE ChunkedArray()
+		: malloc{}
+		, chunks{}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Default constructor with custom
+	 * allocator for the chunks.
+	 *
+	 * @param inMalloc pointer to external
+	 * 	allocator
+	 */
+	FORCE_INLINE explicit ChunkedArray(MallocBase * inMalloc)
+		: malloc{inMalloc}
+		, chunks{}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Copy constructor.
+	 */
+	ChunkedArray(const ChunkedArray & other)
+		: ChunkedArray{}
+	{
+		for (const T & item : other) add(item);
+	}
+
+	/**
+	 * Move constructor.
+	 */
+	ChunkedArray(ChunkedArray && other)
+		: malloc{move(other.malloc)}
+		, chunks{move(other.chunks)}
+		, count{other.count}
+	{
+		other.count = 0;
+	}
+
+	/**
+	 * Destructor, destroys items and
+	 * deallocates chunks.
+	 */
+	FORCE_INLINE ~ChunkedArray()
+	{
+		destroy();
+	}
+
+	/**
+	 * Copy assignment.
+	 */
+	ChunkedArray & operator=(const ChunkedArray & other)
+	{
+		if (this != &other)
+		{
+			empty();
+			for (const T & item : other) add(item);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Move assignment.
+	 */
+	ChunkedArray & operator=(ChunkedArray && other)
+	{
+		destroy();
+
+		malloc = move(other.malloc);
+		chunks = move(other.chunks);
+		count = other.count;
+
+		other.count = 0;
+
+		return *this;
+	}
+
+	/**
+	 * Returns number of items.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getNum, getCount)
+	/** @} */
+
+	/**
+	 * Returns number of items that fit
+	 * in the allocated chunks.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return chunks.getCount() * itemsPerChunk;
+	}
+
+	/**
+	 * Returns true if array is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns the number of allocated
+	 * chunks.
+	 */
+	FORCE_INLINE uint64 getNumChunks() const
+	{
+		return chunks.getCount();
+	}
+
+	/**
+	 * Returns a pointer to the items of
+	 * the idx-th chunk. Chunks are
+	 * contiguous, and can be processed
+	 * in bulk.
+	 *
+	 * @param idx chunk index
+	 * @return pointer to first item
+	 * @{
+	 */
+	FORCE_INLINE T * getChunk(uint64 idx)
+	{
+		return chunks[idx];
+	}
+
+	FORCE_INLINE const T * getChunk(uint64 idx) const
+	{
+		return chunks[idx];
+	}
+	/// @}
+
+	/**
+	 * Returns the number of items in the
+	 * idx-th chunk.
+	 */
+	FORCE_INLINE uint64 getChunkCount(uint64 idx) const
+	{
+		const uint64 start = idx * itemsPerChunk;
+		return start >= count ? 0 : PlatformMath::min(count - start, static_cast<uint64>(itemsPerChunk));
+	}
+
+	/**
+	 * Returns array item at idx-th position
+	 *
+	 * @param idx item position
+	 * @return reference to element
+	 * @{
+	 */
+	FORCE_INLINE T & operator[](uint64 idx)
+	{
+		return chunks[idx >> chunkShift][idx & chunkMask];
+	}
+
+	METHOD_ALIAS(getAt, operator[])
+
+	FORCE_INLINE const T & operator[](uint64 idx) const
+	{
+		return chunks[idx >> chunkShift][idx & chunkMask];
+	}
+
+	METHOD_ALIAS_CONST(getAt, operator[])
+	/** @} */
+
+	/**
+	 * Returns the last item.
+	 * @{
+	 */
+	FORCE_INLINE T & getLast()
+	{
+		CHECK(count > 0)
+		return (*this)[count - 1];
+	}
+
+	FORCE_INLINE const T & getLast() const
+	{
+		CHECK(count > 0)
+		return (*this)[count - 1];
+	}
+	/// @}
+
+	/**
+	 * Returns a new iterator that points
+	 * to the first item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{*this, 0};
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return Iterator{*this, 0};
+	}
+	/** @} */
+
+	/**
+	 * Returns a new iterator that points
+	 * past the last item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{*this, static_cast<int64>(count)};
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return Iterator{*this, static_cast<int64>(count)};
+	}
+	/** @} */
+
+	/**
+	 * Makes sure the allocated chunks
+	 * can hold at least the given number
+	 * of items.
+	 *
+	 * @param inCount required count
+	 */
+	void reserve(uint64 inCount)
+	{
+		while (getCapacity() < inCount) appendChunk();
+	}
+
+	/**
+	 * Inserts an item at the end of the
+	 * array. Other items are not moved.
+	 *
+	 * @param item item to insert
+	 * @return ref to inserted item
+	 */
+	template<typename ItemT>
+	FORCE_INLINE T & insertLast(ItemT && item)
+	{
+		const uint64 offset = count & chunkMask;
+		const uint64 chunkIdx = count >> chunkShift;
+
+		// Only check capacity when we
+		// cross a chunk boundary
+		if (offset == 0 && chunkIdx == chunks.getCount()) appendChunk();
+
+		T * slot = chunks[chunkIdx] + offset;
+		++count;
+
+		return *(new (slot) T{forward<ItemT>(item)});
+	}
+
+	METHOD_ALIAS(add, insertLast)
+	METHOD_ALIAS(push, insertLast)
+
+	/**
+	 * Removes the last item.
+	 */
+	FORCE_INLINE void removeLast()
+	{
+		CHECK(count > 0)
+
+		--count;
+		(*this)[count].~T();
+	}
+
+	/**
+	 * Moves out the last item and
+	 * removes it.
+	 *
+	 * @param outItem item moved out
+	 */
+	FORCE_INLINE void popLast(T & outItem)
+	{
+		outItem = move(getLast());
+		removeLast();
+	}
+
+	/**
+	 * Removes the idx-th item by moving
+	 * the last item in its place. Only
+	 * refs to the last item are
+	 * invalidated.
+	 *
+	 * @param idx position of item
+	 */
+	FORCE_INLINE void removeAtSwap(uint64 idx)
+	{
+		CHECK(idx < count)
+
+		if (idx != count - 1) (*this)[idx] = move(getLast());
+		removeLast();
+	}
+
+	/**
+	 * Removes all the items for which
+	 * the predicate returns true. The
+	 * remaining items are moved down,
+	 * preserving their order, which
+	 * invalidates refs to them. Unused
+	 * chunks are then deallocated.
+	 *
+	 * @param pred predicate called with
+	 * 	a const ref to each item
+	 * @return number of removed items
+	 */
+	template<typename PredT>
+	uint64 removeIf(PredT && pred)
+	{
+		uint64 dst = 0;
+		for (uint64 src = 0; src < count; ++src)
+		{
+			T & item = (*this)[src];
+			if (pred(static_cast<const T&>(item))) continue;
+
+			if (dst != src) (*this)[dst] = move(item);
+			++dst;
+		}
+
+		const uint64 numRemoved = count - dst;
+		while (count > dst) removeLast();
+
+		compact();
+		return numRemoved;
+	}
+
+	/**
+	 * Deallocates the chunks that hold
+	 * no item.
+	 */
+	void compact()
+	{
+		const uint64 numUsedChunks = (count + itemsPerChunk - 1) >> chunkShift;
+		while (chunks.getCount() > numUsedChunks)
+		{
+			T * chunk = nullptr;
+			chunks.popLast(chunk);
+			malloc.free(chunk);
+		}
+
+		if (chunks.getCount() == 0) chunks.reset();
+	}
+
+	/**
+	 * Destroys all items, chunks are
+	 * kept for reuse.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint64 i = 0; i < chunks.getCount(); ++i)
+		{
+			T * chunk = chunks[i];
+			Memory::destroyElements(chunk, chunk + getChunkCount(i));
+		}
+
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/** @} */
+
+	/**
+	 * Destroys all items and deallocates
+	 * all chunks.
+	 */
+	FORCE_INLINE void reset()
+	{
+		destroy();
+	}
+
+protected:
+	/// Chunks allocator
+	MallocObject<T> malloc;
+
+	/// Table of chunk pointers
+	Array<T*> chunks;
+
+	/// Number of items
+	uint64 count;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param T type of items
+ * @param chunkSize number of items per
+ * 	chunk
+ * @param MallocT allocator type
+ */
+template<typename T, uint32 chunkSize, typename MallocT>
+class ChunkedArray : public ChunkedArray<T, chunkSize, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = ChunkedArray<T, chunkSize, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty array that uses it.
+	 *
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE ChunkedArray(MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		//
+	}
+
+	/**
+	 * Destructor, destroy chunks here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~ChunkedArray()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
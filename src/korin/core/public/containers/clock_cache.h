@@ -0,0 +1,538 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "templates/hash.h"
+#include "templates/function.h"
+#include "hal/platform_memory.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+#include "./hash_index.h"
+
+/**
+ * A fixed capacity cache that uses the
+ * CLOCK policy, an approximation of LRU.
+ *
+ * Each entry has a reference bit, set
+ * when the entry is read. To make room
+ * for a new entry, a hand sweeps the
+ * entries in a circle, clearing set
+ * bits, and evicts the first entry
+ * whose bit was already clear.
+ *
+ * Compared to LRUCache a hit writes a
+ * single byte instead of relinking the
+ * recency list, and the cache stores
+ * one byte of state and one free list
+ * link per entry instead of two
+ * indices.
+ *
+ * @param K type of the keys
+ * @param V type of the values
+ * @param HashT hash function type
+ */
+template<typename K, typename V, typename HashT>
+class ClockCache<K, V, HashT, void>
+{
+public:
+	using KeyT = K;
+	using ValueT = V;
+	using HashFnT = HashT;
+	using EvictionCallbackT = Function<void(const K&, V&)>;
+
+protected:
+	/**
+	 * State of an entry.
+	 */
+	enum EntryState : ubyte
+	{
+		Free,
+		Used,
+		Referenced
+	};
+
+	/**
+	 * An entry of the cache.
+	 */
+	struct Entry
+	{
+		/// Hash of the key
+		uint64 hash;
+
+		/// Key of the entry
+		K key;
+
+		/// Cached value
+		V value;
+
+		/**
+		 * Creates a new entry.
+		 */
+		template<typename KeyU, typename ValueU>
+		FORCE_INLINE Entry(uint64 inHash, KeyU && inKey, ValueU && inValue)
+			: hash{inHash}
+			, key{forward<KeyU>(inKey)}
+			, value{forward<ValueU>(inValue)}
+		{
+			//
+		}
+	};
+
+	/// Invalid entry index
+	static constexpr uint32 invalidIdx = HashIndex::invalidEntry;
+
+	/**
+	 * Returns the index of the entry with
+	 * the given key, or invalid.
+	 */
+	template<typename KeyU>
+	FORCE_INLINE uint32 findEntry(uint64 keyHash, const KeyU & key) const
+	{
+		return index.find(keyHash, [this, &key](uint32 idx) {
+
+			return entries[idx].key == key;
+		});
+	}
+
+	/**
+	 * Removes an entry and puts it back
+	 * in the free list.
+	 */
+	FORCE_INLINE void removeEntry(uint32 idx)
+	{
+		index.remove(entries[idx].hash, idx);
+		entries[idx].~Entry();
+
+		freeLinks[idx] = freeHead;
+		states[idx] = Free;
+		freeHead = idx;
+		--count;
+	}
+
+	/**
+	 * Moves the hand until it finds an
+	 * entry that was not referenced
+	 * since the last sweep.
+	 *
+	 * @return index of the victim
+	 */
+	FORCE_INLINE uint32 findVictim()
+	{
+		for (;;)
+		{
+			const uint32 idx = hand;
+			hand = hand + 1 == capacity ? 0 : hand + 1;
+
+			if (states[idx] == Referenced) states[idx] = Used;
+			else if (states[idx] == Used) return idx;
+		}
+	}
+
+	/**
+	 * Chains all the entries in the free
+	 * list.
+	 */
+	void resetStates()
+	{
+		for (uint32 idx = 0; idx < capacity; ++idx)
+		{
+			freeLinks[idx] = idx + 1;
+			states[idx] = Free;
+		}
+
+		freeLinks[capacity - 1] = invalidIdx;
+		freeHead = 0;
+		hand = 0;
+	}
+
+	/**
+	 * Allocates the storage of the cache.
+	 *
+	 * @param inCapacity max number of
+	 * 	entries
+	 */
+	void allocate(uint32 inCapacity)
+	{
+		CHECKF(inCapacity > 0, "Cache capacity must be greater than zero")
+
+		capacity = inCapacity;
+		entries = entriesMalloc.alloc(capacity);
+		freeLinks = linksMalloc.alloc(capacity + (capacity + 3) / 4);
+		CHECKF(entries && freeLinks, "Could not allocate cache storage")
+
+		// States are stored after the links
+		states = reinterpret_cast<EntryState*>(freeLinks + capacity);
+
+		index.allocate(capacity);
+		resetStates();
+	}
+
+	/**
+	 * Creates a cache with no storage,
+	 * that uses the given allocator. Call
+	 * allocate before using it.
+	 */
+	FORCE_INLINE explicit ClockCache(MallocBase * inMalloc)
+		: entriesMalloc{inMalloc}
+		, linksMalloc{inMalloc}
+		, index{inMalloc}
+		, entries{nullptr}
+		, freeLinks{nullptr}
+		, states{nullptr}
+		, capacity{0}
+		, count{0}
+		, freeHead{invalidIdx}
+		, hand{0}
+		, hash{}
+		, onEvict{}
+	{
+		//
+	}
+
+	/**
+	 * Destroys all entries and
+	 * deallocates the storage.
+	 */
+	void destroy()
+	{
+		if (entries)
+		{
+			empty();
+			entriesMalloc.free(entries);
+			linksMalloc.free(freeLinks);
+			entries = nullptr;
+			freeLinks = nullptr;
+			states = nullptr;
+		}
+
+		index.destroy();
+		capacity = 0;
+	}
+
+public:
+	/**
+	 * Creates an empty cache.
+	 *
+	 * @param inCapacity max number of
+	 * 	entries
+	 * @param [inMalloc] allocator used
+	 * 	for the storage
+	 */
+	FORCE_INLINE explicit ClockCache(uint32 inCapacity, MallocBase * inMalloc = gMalloc)
+		: ClockCache{inMalloc}
+	{
+		allocate(inCapacity);
+	}
+
+	/**
+	 * Caches are not copyable.
+	 * @{
+	 */
+	ClockCache(const ClockCache&) = delete;
+	ClockCache & operator=(const ClockCache&) = delete;
+	/// @}
+
+	/**
+	 * Destructor, destroys all entries.
+	 */
+	FORCE_INLINE ~ClockCache()
+	{
+		destroy();
+	}
+
+	/**
+	 * Returns the number of entries.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns the max number of entries.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return capacity;
+	}
+
+	/**
+	 * Returns true if cache is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns true if the next insertion
+	 * of a new key evicts an entry.
+	 */
+	FORCE_INLINE bool isFull() const
+	{
+		return count == capacity;
+	}
+
+	/**
+	 * Sets a function called with the key
+	 * and value of each entry evicted to
+	 * make room for a new one. Entries
+	 * removed explicitly are not passed
+	 * to the callback.
+	 *
+	 * @param fn callable object
+	 */
+	template<typename FnT>
+	FORCE_INLINE void setEvictionCallback(FnT && fn)
+	{
+		onEvict = EvictionCallbackT{typename DecayType<FnT>::Type{forward<FnT>(fn)}};
+	}
+
+	/**
+	 * Returns the value associated with
+	 * the key, and sets its reference
+	 * bit.
+	 *
+	 * @param key key of the entry
+	 * @return ptr to value, or nullptr
+	 */
+	template<typename KeyU>
+	FORCE_INLINE V * get(const KeyU & key)
+	{
+		const uint32 idx = findEntry(hash(key), key);
+		if (idx == invalidIdx) return nullptr;
+
+		states[idx] = Referenced;
+		return &entries[idx].value;
+	}
+
+	/**
+	 * Returns the value associated with
+	 * the key, without setting its
+	 * reference bit.
+	 *
+	 * @param key key of the entry
+	 * @return ptr to value, or nullptr
+	 */
+	template<typename KeyU>
+	FORCE_INLINE const V * peek(const KeyU & key) const
+	{
+		const uint32 idx = findEntry(hash(key), key);
+		return idx != invalidIdx ? &entries[idx].value : nullptr;
+	}
+
+	/**
+	 * Returns true if the cache contains
+	 * the key.
+	 *
+	 * @param key key to find
+	 * @return true if found
+	 */
+	template<typename KeyU>
+	FORCE_INLINE bool has(const KeyU & key) const
+	{
+		return findEntry(hash(key), key) != invalidIdx;
+	}
+
+	/**
+	 * Inserts or updates an entry. If the
+	 * key is new and the cache is full,
+	 * an entry is evicted first. New
+	 * entries start with a clear
+	 * reference bit.
+	 *
+	 * @param key key of the entry
+	 * @param value value to cache
+	 * @return ref to cached value
+	 * @{
+	 */
+	template<typename KeyU, typename ValueU>
+	V & insert(KeyU && key, ValueU && value)
+	{
+		const uint64 keyHash = hash(key);
+		uint32 idx = findEntry(keyHash, key);
+		if (idx != invalidIdx)
+		{
+			entries[idx].value = forward<ValueU>(value);
+			states[idx] = Referenced;
+			return entries[idx].value;
+		}
+
+		if (count == capacity) evict();
+
+		idx = freeHead;
+		freeHead = freeLinks[idx];
+
+		new (entries + idx) Entry{keyHash, forward<KeyU>(key), forward<ValueU>(value)};
+		states[idx] = Used;
+		index.insert(keyHash, idx);
+		++count;
+
+		return entries[idx].value;
+	}
+
+	METHOD_ALIAS(put, insert)
+	/// @}
+
+	/**
+	 * Removes the entry with the given
+	 * key.
+	 *
+	 * @param key key of the entry
+	 * @return true if entry was found
+	 */
+	template<typename KeyU>
+	bool remove(const KeyU & key)
+	{
+		const uint32 idx = findEntry(hash(key), key);
+		if (idx == invalidIdx) return false;
+
+		removeEntry(idx);
+		return true;
+	}
+
+	/**
+	 * Evicts the entry under the hand,
+	 * and passes it to the eviction
+	 * callback.
+	 *
+	 * @return true if an entry was
+	 * 	evicted
+	 */
+	bool evict()
+	{
+		if (count == 0) return false;
+
+		const uint32 idx = findVictim();
+		if (onEvict) onEvict(entries[idx].key, entries[idx].value);
+
+		removeEntry(idx);
+		return true;
+	}
+
+	/**
+	 * Calls a function on each entry, in
+	 * storage order.
+	 *
+	 * @param fn function called with the
+	 * 	key and the value
+	 */
+	template<typename FnT>
+	void forEach(FnT && fn) const
+	{
+		for (uint32 idx = 0; idx < capacity; ++idx)
+		{
+			if (states[idx] != Free) fn(static_cast<const K&>(entries[idx].key), static_cast<const V&>(entries[idx].value));
+		}
+	}
+
+	/**
+	 * Removes all entries, without
+	 * calling the eviction callback.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint32 idx = 0; idx < capacity; ++idx)
+		{
+			if (states[idx] != Free) entries[idx].~Entry();
+		}
+
+		index.empty();
+		resetStates();
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/// Entries allocator
+	MallocObject<Entry> entriesMalloc;
+
+	/// Free links and states allocator
+	MallocObject<uint32> linksMalloc;
+
+	/// Index of the entries
+	HashIndex index;
+
+	/// Entries storage
+	Entry * entries;
+
+	/// Next free entry of each free
+	/// entry
+	uint32 * freeLinks;
+
+	/// State of each entry
+	EntryState * states;
+
+	/// Max number of entries
+	uint32 capacity;
+
+	/// Number of entries
+	uint32 count;
+
+	/// First free entry
+	uint32 freeHead;
+
+	/// Position of the clock hand
+	uint32 hand;
+
+	/// Hash function
+	HashT hash;
+
+	/// Called on evicted entries
+	EvictionCallbackT onEvict;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param K type of the keys
+ * @param V type of the values
+ * @param HashT hash function type
+ * @param MallocT allocator type
+ */
+template<typename K, typename V, typename HashT, typename MallocT>
+class ClockCache : public ClockCache<K, V, HashT, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = ClockCache<K, V, HashT, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty cache that uses it.
+	 *
+	 * @param inCapacity max number of
+	 * 	entries
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE explicit ClockCache(uint32 inCapacity, MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		Base::allocate(inCapacity);
+	}
+
+	/**
+	 * Destructor, destroy entries here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~ClockCache()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
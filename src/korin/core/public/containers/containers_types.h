@@ -2,16 +2,37 @@
 
 #include "core_types.h"
 #include "templates/functional.h"
+#include "templates/hash.h"
+
+struct IntrusiveLink;
 
 template<typename, typename = void>											class Array;
 template<typename>															class StringBase;
 template<typename>															class Link;
 template<typename, typename = void>											class List;
+template<typename T, IntrusiveLink T::*>									class IntrusiveList;
+template<typename, typename = void>											class Deque;
+template<typename, typename = void, uint32 = 0>								class UnrolledList;
 template<typename, typename = ThreeWayCompare>								class BinaryNode;
 template<typename, typename = ThreeWayCompare, typename = void>				class BinaryTree;
 template<typename, typename, typename = NullCompare>						class Pair;
 template<uint64, typename...>												class TupleBase;
 template<typename, typename, typename = ThreeWayCompare, typename = void>	class Map;
 template<typename, typename = ThreeWayCompare, typename = void>				class Set;
+template<typename, typename = ThreeWayCompare, typename = void, uint32 = 4>	class PriorityQueue;
+template<typename, typename = ThreeWayCompare, typename = void, uint32 = 4>	class IndexedPriorityQueue;
+template<typename = void>													class BitArrayBase;
+template<typename, typename = void>											class SlotMap;
+template<typename, uint32 = 0, typename = void>								class ChunkedArray;
+template<typename...>														class SoAArray;
+template<typename T, typename = Hash<T>, typename = void>					class BloomFilter;
+template<typename T, typename = Hash<T>, typename = void>					class CuckooFilter;
+template<typename K, typename, typename = Hash<K>, typename = void>			class LRUCache;
+template<typename K, typename, typename = Hash<K>, typename = void>			class ClockCache;
+template<typename, uint32 = 16>												class ShardedCache;
+template<typename, typename = void>											class RadixTree;
+template<typename>															class MappedArray;
+template<typename, typename, typename = ThreeWayCompare>						class MappedFlatMap;
 
-using String = StringBase<ansichar>;
\ No newline at end of file
+using String = StringBase<ansichar>;
+using BitArray = BitArrayBase<>;
\ No newline at end of file
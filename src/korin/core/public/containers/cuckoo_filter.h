@@ -0,0 +1,618 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "templates/hash.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_math.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+
+/**
+ * A cuckoo filter. Like a Bloom filter
+ * it answers membership queries with
+ * false positives but no false
+ * negatives, but keys can also be
+ * removed.
+ *
+ * The filter stores a 16-bit fingerprint
+ * of each key in one of two candidate
+ * buckets of four slots. The second
+ * bucket is derived from the first one
+ * and the fingerprint alone, so that
+ * fingerprints can be relocated without
+ * knowing the key. A bucket fits in a
+ * 64-bit word and is searched with
+ * word-parallel operations.
+ *
+ * Inserts fail once the filter is full,
+ * which usually happens above 95% load.
+ * Removing a key that was never
+ * inserted may remove another key with
+ * the same fingerprint.
+ *
+ * @param T type of the keys
+ * @param HashT hash function type
+ */
+template<typename T, typename HashT>
+class CuckooFilter<T, HashT, void>
+{
+protected:
+	/// Number of slots per bucket
+	static constexpr uint32 slotsPerBucket = 4;
+
+	/// Max number of relocations before
+	/// an insert fails
+	static constexpr uint32 maxKicks = 500;
+
+	/// Number of keys hashed before
+	/// probing, in batch operations
+	static constexpr uint32 batchSize = 16;
+
+	/// Lowest bit of each slot
+	static constexpr uint64 slotLowBits = 0x0001000100010001ull;
+
+	/// Highest bit of each slot
+	static constexpr uint64 slotHighBits = 0x8000800080008000ull;
+
+	/**
+	 * A fingerprint that could not be
+	 * placed when the filter got full.
+	 */
+	struct Victim
+	{
+		/// Bucket of the fingerprint
+		uint64 idx;
+
+		/// Fingerprint, zero if none
+		uint16 fingerprint;
+	};
+
+	/**
+	 * Returns the fingerprint of the key,
+	 * from the high 16 bits of the hash.
+	 * Zero marks empty slots, so it is
+	 * never returned.
+	 */
+	static FORCE_INLINE uint16 getFingerprint(uint64 hash)
+	{
+		const uint16 fingerprint = static_cast<uint16>(hash >> 48);
+		return fingerprint + (fingerprint == 0);
+	}
+
+	/**
+	 * Returns the alternate bucket of a
+	 * fingerprint. The function is its
+	 * own inverse.
+	 */
+	FORCE_INLINE uint64 getAltIndex(uint64 idx, uint16 fingerprint) const
+	{
+		return (idx ^ HashUtils::fmix64(fingerprint)) & bucketMask;
+	}
+
+	/**
+	 * Returns a mask with the highest bit
+	 * set for each slot of the bucket that
+	 * stores the fingerprint. Only the
+	 * lowest matching slot is exact.
+	 */
+	static FORCE_INLINE uint64 matchSlots(uint64 bucket, uint16 fingerprint)
+	{
+		const uint64 x = bucket ^ (slotLowBits * fingerprint);
+		return (x - slotLowBits) & ~x & slotHighBits;
+	}
+
+	/**
+	 * Returns the index of the lowest
+	 * slot set in a mask.
+	 */
+	static FORCE_INLINE uint32 getFirstSlot(uint64 mask)
+	{
+		return static_cast<uint32>(__builtin_ctzll(mask)) >> 4;
+	}
+
+	/**
+	 * Stores a fingerprint in the idx-th
+	 * bucket, if it has a free slot.
+	 *
+	 * @return true if stored
+	 */
+	FORCE_INLINE bool insertInBucket(uint64 idx, uint16 fingerprint)
+	{
+		const uint64 freeSlots = matchSlots(buckets[idx], 0);
+		if (freeSlots == 0) return false;
+
+		buckets[idx] |= static_cast<uint64>(fingerprint) << (getFirstSlot(freeSlots) * 16);
+		return true;
+	}
+
+	/**
+	 * Removes a fingerprint from the
+	 * idx-th bucket, if found.
+	 *
+	 * @return true if removed
+	 */
+	FORCE_INLINE bool removeFromBucket(uint64 idx, uint16 fingerprint)
+	{
+		const uint64 slots = matchSlots(buckets[idx], fingerprint);
+		if (slots == 0) return false;
+
+		buckets[idx] &= ~(0xffffull << (getFirstSlot(slots) * 16));
+		return true;
+	}
+
+	/**
+	 * Returns a pseudo-random number, used
+	 * to pick the fingerprint to kick out.
+	 */
+	FORCE_INLINE uint64 getRandom()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return seed;
+	}
+
+	/**
+	 * Inserts a fingerprint, relocating
+	 * other fingerprints if both buckets
+	 * are full. If no slot is found the
+	 * last kicked out fingerprint is
+	 * stored as victim.
+	 */
+	bool insertHashImpl(uint64 hash)
+	{
+		if (victim.fingerprint)
+			// Filter is full
+			return false;
+
+		uint16 fingerprint = getFingerprint(hash);
+		uint64 idx = hash & bucketMask;
+		if (insertInBucket(idx, fingerprint)) return true;
+
+		idx = getAltIndex(idx, fingerprint);
+		if (insertInBucket(idx, fingerprint)) return true;
+
+		for (uint32 kick = 0; kick < maxKicks; ++kick)
+		{
+			// Swap with a random slot and move
+			// the evicted fingerprint to its
+			// alternate bucket
+			const uint32 shift = (getRandom() & (slotsPerBucket - 1)) * 16;
+			const uint16 evicted = static_cast<uint16>(buckets[idx] >> shift);
+
+			buckets[idx] = (buckets[idx] & ~(0xffffull << shift)) | (static_cast<uint64>(fingerprint) << shift);
+			fingerprint = evicted;
+
+			idx = getAltIndex(idx, fingerprint);
+			if (insertInBucket(idx, fingerprint)) return true;
+		}
+
+		victim = Victim{idx, fingerprint};
+		return true;
+	}
+
+	/**
+	 * Returns true if the fingerprint of
+	 * the hash is in one of its buckets.
+	 */
+	FORCE_INLINE bool containsHashImpl(uint64 hash) const
+	{
+		const uint16 fingerprint = getFingerprint(hash);
+		const uint64 idx1 = hash & bucketMask;
+		const uint64 idx2 = getAltIndex(idx1, fingerprint);
+
+		return (matchSlots(buckets[idx1], fingerprint) | matchSlots(buckets[idx2], fingerprint)) != 0
+			|| (victim.fingerprint == fingerprint && (victim.idx == idx1 || victim.idx == idx2));
+	}
+
+	/**
+	 * Allocates and clears the buckets.
+	 *
+	 * @param capacity number of keys
+	 */
+	void allocate(uint64 capacity)
+	{
+		numBuckets = 1;
+		while (numBuckets * slotsPerBucket < capacity) numBuckets *= 2;
+
+		// Full tables are slow to fill up
+		if (static_cast<float64>(capacity) / (numBuckets * slotsPerBucket) > 0.96) numBuckets *= 2;
+
+		bucketMask = numBuckets - 1;
+		buckets = malloc.alloc(numBuckets);
+		empty();
+	}
+
+	/**
+	 * Creates an empty filter with no
+	 * buckets, that uses the given
+	 * allocator. Call allocate before
+	 * using it.
+	 */
+	FORCE_INLINE explicit CuckooFilter(MallocBase * inMalloc)
+		: malloc{inMalloc}
+		, buckets{nullptr}
+		, numBuckets{0}
+		, bucketMask{0}
+		, count{0}
+		, victim{0, 0}
+		, seed{0x2545f4914f6cdd1dull}
+		, hash{}
+	{
+		//
+	}
+
+	/**
+	 * Deallocates the buckets.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		if (buckets)
+		{
+			malloc.free(buckets);
+			buckets = nullptr;
+		}
+
+		numBuckets = bucketMask = count = 0;
+		victim = Victim{0, 0};
+	}
+
+public:
+	/**
+	 * Creates an empty filter that can
+	 * hold at least the given number of
+	 * keys.
+	 *
+	 * @param capacity number of keys
+	 * @param [inMalloc] allocator used
+	 * 	for the buckets
+	 */
+	FORCE_INLINE explicit CuckooFilter(uint64 capacity, MallocBase * inMalloc = gMalloc)
+		: CuckooFilter{inMalloc}
+	{
+		allocate(capacity);
+	}
+
+	/**
+	 * Filters are not copyable.
+	 * @{
+	 */
+	CuckooFilter(const CuckooFilter&) = delete;
+	CuckooFilter & operator=(const CuckooFilter&) = delete;
+	/// @}
+
+	/**
+	 * Move constructor.
+	 */
+	CuckooFilter(CuckooFilter && other)
+		: malloc{move(other.malloc)}
+		, buckets{other.buckets}
+		, numBuckets{other.numBuckets}
+		, bucketMask{other.bucketMask}
+		, count{other.count}
+		, victim{other.victim}
+		, seed{other.seed}
+		, hash{move(other.hash)}
+	{
+		other.buckets = nullptr;
+		other.numBuckets = other.bucketMask = other.count = 0;
+		other.victim = Victim{0, 0};
+	}
+
+	/**
+	 * Destructor, deallocates buckets.
+	 */
+	FORCE_INLINE ~CuckooFilter()
+	{
+		destroy();
+	}
+
+	/**
+	 * Returns the number of keys in the
+	 * filter.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns the number of slots.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return numBuckets * slotsPerBucket;
+	}
+
+	/**
+	 * Returns the ratio of used slots.
+	 */
+	FORCE_INLINE float32 getLoadFactor() const
+	{
+		return numBuckets ? static_cast<float32>(count) / getCapacity() : 0.f;
+	}
+
+	/**
+	 * Returns true if the last insert
+	 * could not find a slot, in which
+	 * case all inserts fail until a key
+	 * is removed.
+	 */
+	FORCE_INLINE bool isFull() const
+	{
+		return victim.fingerprint != 0;
+	}
+
+	/**
+	 * Inserts a key in the filter.
+	 *
+	 * @param key key to insert
+	 * @return false if filter is full
+	 * @{
+	 */
+	FORCE_INLINE bool insert(const T & key)
+	{
+		return insertHash(hash(key));
+	}
+
+	METHOD_ALIAS(add, insert)
+	/// @}
+
+	/**
+	 * Inserts a key given its hash.
+	 *
+	 * @param keyHash hash of the key
+	 * @return false if filter is full
+	 */
+	FORCE_INLINE bool insertHash(uint64 keyHash)
+	{
+		const bool inserted = insertHashImpl(keyHash);
+		count += inserted;
+		return inserted;
+	}
+
+	/**
+	 * Inserts a batch of keys. Hashes
+	 * are computed and buckets prefetched
+	 * ahead of the inserts.
+	 *
+	 * @param keys pointer to first key
+	 * @param numKeys number of keys
+	 * @return number of inserted keys,
+	 * 	inserts stop when the filter is
+	 * 	full
+	 */
+	uint64 insert(const T * keys, uint64 numKeys)
+	{
+		uint64 hashes[batchSize];
+		for (uint64 i = 0; i < numKeys; i += batchSize)
+		{
+			const uint32 n = static_cast<uint32>(PlatformMath::min(numKeys - i, static_cast<uint64>(batchSize)));
+			for (uint32 j = 0; j < n; ++j)
+			{
+				hashes[j] = hash(keys[i + j]);
+				PlatformMemory::prefetch(buckets + (hashes[j] & bucketMask));
+			}
+
+			for (uint32 j = 0; j < n; ++j)
+			{
+				if (!insertHash(hashes[j])) return i + j;
+			}
+		}
+
+		return numKeys;
+	}
+
+	/**
+	 * Returns true if the key may be in
+	 * the filter, false if it is surely
+	 * not.
+	 *
+	 * @param key key to test
+	 * @return false if key is not in the
+	 * 	filter
+	 * @{
+	 */
+	FORCE_INLINE bool contains(const T & key) const
+	{
+		return containsHashImpl(hash(key));
+	}
+
+	METHOD_ALIAS_CONST(mayContain, contains)
+	/// @}
+
+	/**
+	 * Tests a key given its hash.
+	 *
+	 * @param keyHash hash of the key
+	 * @return false if key is not in the
+	 * 	filter
+	 */
+	FORCE_INLINE bool containsHash(uint64 keyHash) const
+	{
+		return containsHashImpl(keyHash);
+	}
+
+	/**
+	 * Tests a batch of keys. Hashes are
+	 * computed and both buckets of each
+	 * key prefetched ahead of the tests.
+	 *
+	 * @param keys pointer to first key
+	 * @param numKeys number of keys
+	 * @param outResults result of each
+	 * 	test, as per contains
+	 * @return number of keys that may be
+	 * 	in the filter
+	 */
+	uint64 contains(const T * keys, uint64 numKeys, bool * outResults) const
+	{
+		uint64 numPositives = 0;
+		uint64 hashes[batchSize];
+
+		for (uint64 i = 0; i < numKeys; i += batchSize)
+		{
+			const uint32 n = static_cast<uint32>(PlatformMath::min(numKeys - i, static_cast<uint64>(batchSize)));
+			for (uint32 j = 0; j < n; ++j)
+			{
+				const uint64 keyHash = hashes[j] = hash(keys[i + j]);
+				const uint64 idx = keyHash & bucketMask;
+
+				PlatformMemory::prefetch(buckets + idx);
+				PlatformMemory::prefetch(buckets + getAltIndex(idx, getFingerprint(keyHash)));
+			}
+
+			for (uint32 j = 0; j < n; ++j)
+			{
+				const bool result = containsHashImpl(hashes[j]);
+				outResults[i + j] = result;
+				numPositives += result;
+			}
+		}
+
+		return numPositives;
+	}
+
+	/**
+	 * Removes a key from the filter. The
+	 * key must have been inserted,
+	 * otherwise another key may be
+	 * removed.
+	 *
+	 * @param key key to remove
+	 * @return true if a matching
+	 * 	fingerprint was removed
+	 */
+	FORCE_INLINE bool remove(const T & key)
+	{
+		return removeHash(hash(key));
+	}
+
+	/**
+	 * Removes a key given its hash.
+	 *
+	 * @param keyHash hash of the key
+	 * @return true if a matching
+	 * 	fingerprint was removed
+	 */
+	bool removeHash(uint64 keyHash)
+	{
+		const uint16 fingerprint = getFingerprint(keyHash);
+		const uint64 idx1 = keyHash & bucketMask;
+		const uint64 idx2 = getAltIndex(idx1, fingerprint);
+
+		if (victim.fingerprint == fingerprint && (victim.idx == idx1 || victim.idx == idx2))
+		{
+			victim = Victim{0, 0};
+			--count;
+			return true;
+		}
+
+		if (!removeFromBucket(idx1, fingerprint) && !removeFromBucket(idx2, fingerprint)) return false;
+
+		--count;
+		if (victim.fingerprint)
+		{
+			// Now there is a free slot, try to
+			// place the victim again
+			const Victim prev = victim;
+			victim = Victim{0, 0};
+
+			insertHashImpl((static_cast<uint64>(prev.fingerprint) << 48) | prev.idx);
+		}
+
+		return true;
+	}
+
+	/**
+	 * Removes all keys.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint64 i = 0; i < numBuckets; ++i) buckets[i] = 0;
+
+		count = 0;
+		victim = Victim{0, 0};
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/// Buckets allocator
+	MallocObject<uint64> malloc;
+
+	/// Buckets, four 16-bit slots each
+	uint64 * buckets;
+
+	/// Number of buckets, a power of two
+	uint64 numBuckets;
+
+	/// Mask used to wrap bucket indices
+	uint64 bucketMask;
+
+	/// Number of keys
+	uint64 count;
+
+	/// Fingerprint that could not be
+	/// placed, if any
+	Victim victim;
+
+	/// State of the random generator
+	uint64 seed;
+
+	/// Hash function
+	HashT hash;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param T type of the keys
+ * @param HashT hash function type
+ * @param MallocT allocator type
+ */
+template<typename T, typename HashT, typename MallocT>
+class CuckooFilter : public CuckooFilter<T, HashT, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = CuckooFilter<T, HashT, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty filter that uses it.
+	 *
+	 * @param capacity number of keys
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE CuckooFilter(uint64 capacity, MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		Base::allocate(capacity);
+	}
+
+	/**
+	 * Destructor, destroy buckets here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~CuckooFilter()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
@@ -0,0 +1,772 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/iterator.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "hal/platform_memory.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+
+/**
+ * Iterator used to iterate over the
+ * items of a deque. Unlike the array
+ * iterator, it keeps a pointer to the
+ * deque, which makes it assignable.
+ *
+ * @param DequeT type of deque
+ * @param IteratorTraitsT type that
+ * 	define the iterator types
+ */
+template<typename DequeT, typename IteratorTraitsT = RandomAccessIterator<typename DequeT::ItemT>>
+struct DequeIteratorBase : public IteratorTraitsT
+{
+	using RefT = typename IteratorTraitsT::RefT;
+	using PtrT = typename IteratorTraitsT::PtrT;
+
+	/**
+	 * Construct for deque, pointing at
+	 * idx-th element.
+	 *
+	 * @param inDeque ref to deque
+	 * @param [inIdx = 0] start index
+	 */
+	FORCE_INLINE DequeIteratorBase(DequeT & inDeque, int64 inIdx = 0)
+		: deque{&inDeque}
+		, idx{inIdx}
+	{
+		//
+	}
+
+	/**
+	 * Dereference iterator, return ref to
+	 * idx-th item.
+	 */
+	FORCE_INLINE RefT operator*() const
+	{
+		return (*deque)[idx];
+	}
+
+	/**
+	 * Dereference iterator, return pointer
+	 * to idx-th item.
+	 */
+	FORCE_INLINE PtrT operator->() const
+	{
+		return &(**this);
+	}
+
+	/**
+	 * Returns true if both iterators point
+	 * to the same position. Unlike the
+	 * array iterator, it does not
+	 * dereference the iterators.
+	 *
+	 * @param other another iterator
+	 * @return true if they point to the
+	 * 	same position
+	 * @{
+	 */
+	FORCE_INLINE bool operator==(const DequeIteratorBase & other) const
+	{
+		return idx == other.idx;
+	}
+
+	FORCE_INLINE bool operator!=(const DequeIteratorBase & other) const
+	{
+		return idx != other.idx;
+	}
+	/// @}
+
+	/**
+	 * Moves iterator to the next item.
+	 * @{
+	 */
+	FORCE_INLINE DequeIteratorBase & operator++()
+	{
+		++idx;
+		return *this;
+	}
+
+	FORCE_INLINE DequeIteratorBase operator++(int32)
+	{
+		DequeIteratorBase it{*this};
+
+		++idx;
+		return it;
+	}
+	/// @}
+
+	/**
+	 * Moves iterator to the previous item.
+	 * @{
+	 */
+	FORCE_INLINE DequeIteratorBase & operator--()
+	{
+		--idx;
+		return *this;
+	}
+
+	FORCE_INLINE DequeIteratorBase operator--(int32)
+	{
+		DequeIteratorBase it{*this};
+
+		--idx;
+		return it;
+	}
+	/// @}
+
+	/**
+	 * Increments or decrements iterator
+	 * by the given amount.
+	 *
+	 * @param n increment amount
+	 * @return ref to self or new iterator
+	 * @{
+	 */
+	FORCE_INLINE DequeIteratorBase & operator+=(int64 n)
+	{
+		idx += n;
+		return *this;
+	}
+
+	FORCE_INLINE DequeIteratorBase operator+(int64 n) const
+	{
+		DequeIteratorBase it{*this};
+		return (it += n);
+	}
+
+	FORCE_INLINE DequeIteratorBase & operator-=(int64 n)
+	{
+		idx -= n;
+		return *this;
+	}
+
+	FORCE_INLINE DequeIteratorBase operator-(int64 n) const
+	{
+		DequeIteratorBase it{*this};
+		return (it -= n);
+	}
+	/// @}
+
+	/**
+	 * Returns the distance between two
+	 * iterators of the same deque.
+	 *
+	 * @param other another iterator
+	 * @return signed distance in items
+	 */
+	FORCE_INLINE int64 operator-(const DequeIteratorBase & other) const
+	{
+		return idx - other.idx;
+	}
+
+	/**
+	 * Subscript operation, returns i-th
+	 * element realtive to this iterator.
+	 *
+	 * @param i index relative to this
+	 * 	iterator
+	 * @return ref to i-th item
+	 */
+	FORCE_INLINE RefT operator[](int64 i) const
+	{
+		return (*deque)[idx + i];
+	}
+
+	/**
+	 * Ordering operations.
+	 *
+	 * @param other another iterator
+	 * @return true if the comparison
+	 * 	stands
+	 * @{
+	 */
+	FORCE_INLINE bool operator<(const DequeIteratorBase & other) const
+	{
+		return idx < other.idx;
+	}
+
+	FORCE_INLINE bool operator>(const DequeIteratorBase & other) const
+	{
+		return idx > other.idx;
+	}
+
+	FORCE_INLINE bool operator<=(const DequeIteratorBase & other) const
+	{
+		return idx <= other.idx;
+	}
+
+	FORCE_INLINE bool operator>=(const DequeIteratorBase & other) const
+	{
+		return idx >= other.idx;
+	}
+	/** @} */
+
+private:
+	/// Underlying deque
+	DequeT * deque;
+
+	/// Current index, relative to the
+	/// first item of the deque
+	int64 idx;
+};
+
+/// Deque iterator types
+/// @{
+template<typename DequeT>
+using DequeConstIterator = DequeIteratorBase<const DequeT, RandomAccessIterator<const typename DequeT::ItemT>>;
+
+template<typename DequeT>
+using DequeIterator = DequeIteratorBase<DequeT, RandomAccessIterator<typename DequeT::ItemT>>;
+/// @}
+
+/**
+ * A double-ended queue implemented as
+ * a circular buffer. Items can be
+ * pushed and popped at both ends in
+ * amortized O(1) time, and accessed by
+ * index in O(1) time.
+ *
+ * The capacity of the buffer is always
+ * a power of two, so that the physical
+ * position of an item is computed with
+ * a mask rather than a modulo. Unlike
+ * the list, items are stored in a
+ * single contiguous block (possibly
+ * wrapped around) and no allocation
+ * happens unless the deque grows.
+ *
+ * References to items are invalidated
+ * when the deque grows.
+ *
+ * @param T type of the items
+ */
+template<typename T>
+class Deque<T, void>
+{
+	template<typename, typename> friend class Deque;
+
+public:
+	using DequeT = Deque<T, void>;
+	using ItemT = T;
+	using ConstIterator = DequeConstIterator<DequeT>;
+	using Iterator = DequeIterator<DequeT>;
+
+	/// Capacity of the buffer after the
+	/// first allocation
+	static constexpr uint64 minCapacity = 8;
+
+protected:
+	/**
+	 * Returns the physical position of
+	 * the idx-th item.
+	 */
+	FORCE_INLINE uint64 getSlot(uint64 idx) const
+	{
+		return (head + idx) & (capacity - 1);
+	}
+
+	/**
+	 * Destroys deque, destroys all items
+	 * and deallocates buffer.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		if (buffer)
+		{
+			empty();
+
+			malloc.free(buffer);
+			buffer = nullptr;
+		}
+
+		head = count = capacity = 0;
+	}
+
+	/**
+	 * Moves all items to a new buffer of
+	 * the given capacity. Items are
+	 * unwrapped, so that the first item
+	 * is at the start of the new buffer.
+	 *
+	 * @param inCapacity new capacity, a
+	 * 	power of two
+	 */
+	void relocate(uint64 inCapacity)
+	{
+		T * inBuffer = malloc.alloc(inCapacity);
+
+		for (uint64 i = 0; i < count; ++i)
+		{
+			T & item = buffer[getSlot(i)];
+			new (inBuffer + i) T{move(item)};
+			item.~T();
+		}
+
+		if (buffer) malloc.free(buffer);
+
+		buffer = inBuffer;
+		capacity = inCapacity;
+		head = 0;
+	}
+
+	/**
+	 * Grows buffer if new count exceeds
+	 * current capacity.
+	 *
+	 * @param inCount required count
+	 * @return true if buffer was resized
+	 */
+	FORCE_INLINE bool resizeIfNecessary(uint64 inCount)
+	{
+		if (inCount > capacity)
+		{
+			uint64 inCapacity = capacity ? capacity : minCapacity;
+			while (inCapacity < inCount) inCapacity *= 2;
+
+			relocate(inCapacity);
+			return true;
+		}
+
+		return false;
+	}
+
+public:
+	/**
+	 * Default constructor, creates empty
+	 * deque with global allocator.
+	 */
+	FORCE_INLINE Deque()
+		: malloc{}
+		, buffer{nullptr}
+		, capacity{0}
+		, head{0}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Default constructor with custom
+	 * allocator.
+	 *
+	 * @param inMalloc pointer to external
+	 * 	allocator
+	 */
+	FORCE_INLINE explicit Deque(MallocBase * inMalloc)
+		: malloc{inMalloc}
+		, buffer{nullptr}
+		, capacity{0}
+		, head{0}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Copy constructor.
+	 */
+	Deque(const Deque & other)
+		: Deque{}
+	{
+		resizeIfNecessary(other.count);
+
+		for (uint64 i = 0; i < other.count; ++i)
+		{
+			new (buffer + i) T{other[i]};
+		}
+
+		count = other.count;
+	}
+
+	/**
+	 * Move constructor.
+	 */
+	Deque(Deque && other)
+		: malloc{move(other.malloc)}
+		, buffer{other.buffer}
+		, capacity{other.capacity}
+		, head{other.head}
+		, count{other.count}
+	{
+		other.buffer = nullptr;
+		other.capacity = other.head = other.count = 0;
+	}
+
+	/**
+	 * Deque destructor, destroys items and
+	 * deallocates buffer.
+	 */
+	FORCE_INLINE ~Deque()
+	{
+		destroy();
+	}
+
+	/**
+	 * Copy assignment.
+	 */
+	Deque & operator=(const Deque & other)
+	{
+		if (this != &other)
+		{
+			empty();
+			resizeIfNecessary(other.count);
+
+			for (uint64 i = 0; i < other.count; ++i)
+			{
+				new (buffer + i) T{other[i]};
+			}
+
+			count = other.count;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Move assignment.
+	 */
+	Deque & operator=(Deque && other)
+	{
+		// Destroy first
+		destroy();
+
+		malloc = move(other.malloc);
+		buffer = other.buffer;
+		capacity = other.capacity;
+		head = other.head;
+		count = other.count;
+
+		other.buffer = nullptr;
+		other.capacity = other.head = other.count = 0;
+
+		return *this;
+	}
+
+	/**
+	 * Returns number of items.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getNum, getCount)
+	/** @} */
+
+	/**
+	 * Returns the number of items that
+	 * fit in the buffer.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return capacity;
+	}
+
+	/**
+	 * Returns true if deque is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns idx-th item, starting from
+	 * the front of the deque.
+	 *
+	 * @param idx item position
+	 * @return ref to item
+	 * @{
+	 */
+	FORCE_INLINE T & operator[](uint64 idx)
+	{
+		return buffer[getSlot(idx)];
+	}
+
+	METHOD_ALIAS(getAt, operator[])
+
+	FORCE_INLINE const T & operator[](uint64 idx) const
+	{
+		return buffer[getSlot(idx)];
+	}
+
+	METHOD_ALIAS_CONST(getAt, operator[])
+	/** @} */
+
+	/**
+	 * Returns the first item.
+	 * @{
+	 */
+	FORCE_INLINE T & getFront()
+	{
+		CHECK(count > 0)
+		return buffer[head];
+	}
+
+	FORCE_INLINE const T & getFront() const
+	{
+		CHECK(count > 0)
+		return buffer[head];
+	}
+	/** @} */
+
+	/**
+	 * Returns the last item.
+	 * @{
+	 */
+	FORCE_INLINE T & getBack()
+	{
+		CHECK(count > 0)
+		return buffer[getSlot(count - 1)];
+	}
+
+	FORCE_INLINE const T & getBack() const
+	{
+		CHECK(count > 0)
+		return buffer[getSlot(count - 1)];
+	}
+	/** @} */
+
+	/**
+	 * Returns a new iterator that points
+	 * to the first item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{*this, 0};
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return Iterator{*this, 0};
+	}
+	/** @} */
+
+	/**
+	 * Returns a new iterator that points
+	 * past the last item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{*this, static_cast<int64>(count)};
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return Iterator{*this, static_cast<int64>(count)};
+	}
+	/** @} */
+
+	/**
+	 * Makes sure the buffer can hold at
+	 * least the given number of items
+	 * without growing.
+	 *
+	 * @param inCount required count
+	 */
+	FORCE_INLINE void reserve(uint64 inCount)
+	{
+		resizeIfNecessary(inCount);
+	}
+
+	/**
+	 * Inserts an item at the back of
+	 * the deque.
+	 *
+	 * @param item item to insert
+	 * @return ref to inserted item
+	 */
+	template<typename ItemT>
+	FORCE_INLINE T & pushBack(ItemT && item)
+	{
+		resizeIfNecessary(count + 1);
+
+		T * slot = buffer + getSlot(count);
+		++count;
+
+		return *(new (slot) T{forward<ItemT>(item)});
+	}
+
+	METHOD_ALIAS(push, pushBack)
+
+	/**
+	 * Inserts an item at the front of
+	 * the deque.
+	 *
+	 * @param item item to insert
+	 * @return ref to inserted item
+	 */
+	template<typename ItemT>
+	FORCE_INLINE T & pushFront(ItemT && item)
+	{
+		resizeIfNecessary(count + 1);
+
+		head = (head - 1) & (capacity - 1);
+		++count;
+
+		return *(new (buffer + head) T{forward<ItemT>(item)});
+	}
+
+	/**
+	 * Removes the last item.
+	 *
+	 * @return true if an item was
+	 * 	removed
+	 */
+	FORCE_INLINE bool removeBack()
+	{
+		if (count == 0) return false;
+
+		--count;
+		buffer[getSlot(count)].~T();
+		return true;
+	}
+
+	/**
+	 * Removes the first item.
+	 *
+	 * @return true if an item was
+	 * 	removed
+	 */
+	FORCE_INLINE bool removeFront()
+	{
+		if (count == 0) return false;
+
+		buffer[head].~T();
+		head = (head + 1) & (capacity - 1);
+		--count;
+		return true;
+	}
+
+	/**
+	 * Moves out the last item and
+	 * removes it.
+	 *
+	 * @param outItem popped item
+	 * @return true if an item was
+	 * 	popped
+	 */
+	FORCE_INLINE bool popBack(T & outItem)
+	{
+		if (count == 0) return false;
+
+		outItem = move(getBack());
+		return removeBack();
+	}
+
+	/**
+	 * Moves out the first item and
+	 * removes it.
+	 *
+	 * @param outItem popped item
+	 * @return true if an item was
+	 * 	popped
+	 */
+	FORCE_INLINE bool popFront(T & outItem)
+	{
+		if (count == 0) return false;
+
+		outItem = move(getFront());
+		return removeFront();
+	}
+
+	METHOD_ALIAS(pop, popFront)
+
+	/**
+	 * Removes all items, but keeps the
+	 * buffer.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint64 i = 0; i < count; ++i)
+		{
+			buffer[getSlot(i)].~T();
+		}
+
+		head = count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/** @} */
+
+	/**
+	 * Resets deque.
+	 * Destroys all items and deallocates
+	 * the buffer.
+	 */
+	FORCE_INLINE void reset()
+	{
+		destroy();
+	}
+
+protected:
+	/// Object allocator
+	MallocObject<T> malloc;
+
+	/// Circular buffer
+	T * buffer;
+
+	/// Buffer capacity, always zero or
+	/// a power of two
+	uint64 capacity;
+
+	/// Position of the first item
+	uint64 head;
+
+	/// Number of items
+	uint64 count;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param T type of items
+ * @param MallocT allocator type
+ */
+template<typename T, typename MallocT>
+class Deque : public Deque<T, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = Deque<T, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty deque that uses it.
+	 *
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE Deque(MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		//
+	}
+
+	/**
+	 * Destructor, destroy buffer here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~Deque()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
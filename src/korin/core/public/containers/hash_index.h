@@ -0,0 +1,262 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "hal/platform_math.h"
+#include "hal/malloc_object.h"
+
+/**
+ * A fixed-size open addressing table
+ * that maps hashes to 32-bit entry
+ * indices. It does not store the keys,
+ * the owner compares them through a
+ * predicate. Used by containers that
+ * keep their items in preallocated
+ * storage, like caches.
+ *
+ * Each slot stores the high 32 bits of
+ * the hash, used both to compute the
+ * home slot and to skip most key
+ * comparisons. Collisions are resolved
+ * with linear probing, and removal
+ * shifts the following slots back, so
+ * that no tombstone is ever needed.
+ */
+class HashIndex
+{
+public:
+	/// Value returned for missing entries
+	static constexpr uint32 invalidEntry = 0xffffffffu;
+
+protected:
+	/**
+	 * A slot of the table.
+	 */
+	struct Slot
+	{
+		/// High 32 bits of the hash
+		uint32 tag;
+
+		/// Index of the entry, or invalid
+		uint32 entry;
+	};
+
+	/**
+	 * Returns the tag of a hash.
+	 */
+	static FORCE_INLINE uint32 getTag(uint64 hash)
+	{
+		return static_cast<uint32>(hash >> 32);
+	}
+
+	/**
+	 * Returns the home slot of a tag.
+	 */
+	FORCE_INLINE uint32 getHome(uint32 tag) const
+	{
+		return static_cast<uint32>((static_cast<uint64>(tag) * numSlots) >> 32);
+	}
+
+public:
+	/**
+	 * Creates an index with no slots, that
+	 * uses the given allocator. Call
+	 * allocate before using it.
+	 *
+	 * @param [inMalloc] allocator used
+	 * 	for the table
+	 */
+	FORCE_INLINE explicit HashIndex(MallocBase * inMalloc = gMalloc)
+		: malloc{inMalloc}
+		, slots{nullptr}
+		, numSlots{0}
+	{
+		//
+	}
+
+	/**
+	 * Creates an index with room for the
+	 * given number of entries.
+	 *
+	 * @param maxEntries max number of
+	 * 	entries
+	 * @param [inMalloc] allocator used
+	 * 	for the table
+	 */
+	FORCE_INLINE explicit HashIndex(uint32 maxEntries, MallocBase * inMalloc = gMalloc)
+		: HashIndex{inMalloc}
+	{
+		allocate(maxEntries);
+	}
+
+	/**
+	 * Indices are not copyable.
+	 * @{
+	 */
+	HashIndex(const HashIndex&) = delete;
+	HashIndex & operator=(const HashIndex&) = delete;
+	/// @}
+
+	/**
+	 * Move constructor.
+	 */
+	FORCE_INLINE HashIndex(HashIndex && other)
+		: malloc{move(other.malloc)}
+		, slots{other.slots}
+		, numSlots{other.numSlots}
+	{
+		other.slots = nullptr;
+		other.numSlots = 0;
+	}
+
+	/**
+	 * Destructor, deallocates the table.
+	 */
+	FORCE_INLINE ~HashIndex()
+	{
+		destroy();
+	}
+
+	/**
+	 * Allocates an empty table with room
+	 * for the given number of entries.
+	 * The table is kept at most half
+	 * full, so that probe sequences stay
+	 * short.
+	 *
+	 * @param maxEntries max number of
+	 * 	entries
+	 */
+	void allocate(uint32 maxEntries)
+	{
+		CHECKF(maxEntries <= (1u << 30), "Too many entries in hash index")
+
+		if (slots) malloc.free(slots);
+
+		numSlots = 8;
+		while (numSlots < maxEntries * 2ull) numSlots <<= 1;
+
+		slots = malloc.alloc(numSlots);
+		CHECKF(slots != nullptr, "Could not allocate hash index")
+
+		empty();
+	}
+
+	/**
+	 * Deallocates the table.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		if (slots)
+		{
+			malloc.free(slots);
+			slots = nullptr;
+		}
+
+		numSlots = 0;
+	}
+
+	/**
+	 * Returns the number of slots.
+	 */
+	FORCE_INLINE uint64 getNumSlots() const
+	{
+		return numSlots;
+	}
+
+	/**
+	 * Finds the entry with the given hash
+	 * for which the predicate returns
+	 * true.
+	 *
+	 * @param hash hash of the key
+	 * @param isMatch predicate called on
+	 * 	candidate entries
+	 * @return entry index, or invalid
+	 */
+	template<typename PredT>
+	FORCE_INLINE uint32 find(uint64 hash, PredT && isMatch) const
+	{
+		const uint32 tag = getTag(hash);
+		const uint32 mask = numSlots - 1;
+
+		for (uint32 idx = getHome(tag);; idx = (idx + 1) & mask)
+		{
+			const Slot & slot = slots[idx];
+			if (slot.entry == invalidEntry) return invalidEntry;
+			if (slot.tag == tag && isMatch(slot.entry)) return slot.entry;
+		}
+	}
+
+	/**
+	 * Inserts an entry. The caller must
+	 * ensure it is not in the index.
+	 *
+	 * @param hash hash of the key
+	 * @param entry index of the entry
+	 */
+	FORCE_INLINE void insert(uint64 hash, uint32 entry)
+	{
+		const uint32 tag = getTag(hash);
+		const uint32 mask = numSlots - 1;
+
+		uint32 idx = getHome(tag);
+		while (slots[idx].entry != invalidEntry) idx = (idx + 1) & mask;
+
+		slots[idx] = Slot{tag, entry};
+	}
+
+	/**
+	 * Removes an entry from the index.
+	 *
+	 * @param hash hash of the key
+	 * @param entry index of the entry
+	 * @return true if entry was found
+	 */
+	bool remove(uint64 hash, uint32 entry)
+	{
+		const uint32 tag = getTag(hash);
+		const uint32 mask = numSlots - 1;
+
+		uint32 hole = getHome(tag);
+		for (;; hole = (hole + 1) & mask)
+		{
+			if (slots[hole].entry == invalidEntry) return false;
+			if (slots[hole].entry == entry) break;
+		}
+
+		// Shift back following slots that
+		// are not at their home slot
+		for (uint32 idx = (hole + 1) & mask; slots[idx].entry != invalidEntry; idx = (idx + 1) & mask)
+		{
+			const uint32 home = getHome(slots[idx].tag);
+			if (((idx - home) & mask) >= ((idx - hole) & mask))
+			{
+				slots[hole] = slots[idx];
+				hole = idx;
+			}
+		}
+
+		slots[hole].entry = invalidEntry;
+		return true;
+	}
+
+	/**
+	 * Removes all entries.
+	 */
+	FORCE_INLINE void empty()
+	{
+		for (uint32 idx = 0; idx < numSlots; ++idx) slots[idx] = Slot{0, invalidEntry};
+	}
+
+protected:
+	/// Table allocator
+	MallocObject<Slot> malloc;
+
+	/// Slots of the table
+	Slot * slots;
+
+	/// Number of slots, a power of two
+	uint32 numSlots;
+};
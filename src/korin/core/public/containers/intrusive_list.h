@@ -0,0 +1,582 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/iterator.h"
+#include "templates/utility.h"
+#include "./containers_types.h"
+
+/**
+ * Hook that must be embedded in the
+ * items of an intrusive list. An item
+ * can be in as many lists as the
+ * hooks it has, but each hook can be
+ * linked in at most one list.
+ */
+struct IntrusiveLink
+{
+	/// Pointer to next link
+	IntrusiveLink * next;
+
+	/// Pointer to previous link
+	IntrusiveLink * prev;
+
+	/**
+	 * Creates an unlinked hook.
+	 */
+	FORCE_INLINE IntrusiveLink()
+		: next{nullptr}
+		, prev{nullptr}
+	{
+		//
+	}
+
+	/**
+	 * Hooks are never copied, the copy
+	 * of a linked item is unlinked.
+	 * @{
+	 */
+	FORCE_INLINE IntrusiveLink(const IntrusiveLink &)
+		: IntrusiveLink{}
+	{
+		//
+	}
+
+	FORCE_INLINE IntrusiveLink & operator=(const IntrusiveLink &)
+	{
+		return *this;
+	}
+	/// @}
+
+	/**
+	 * Returns true if hook is linked in
+	 * a list.
+	 */
+	FORCE_INLINE bool isLinked() const
+	{
+		return next != nullptr;
+	}
+};
+
+/**
+ * Iterator used to iterate over the
+ * items of an intrusive list. It has
+ * the same interface of the list
+ * iterator.
+ *
+ * @param ListT type of intrusive list
+ * @param LinkT type of hook, possibly
+ * 	const qualified
+ * @param IteratorTraitsT type that
+ * 	define the iterator types
+ */
+template<typename ListT, typename LinkT, typename IteratorTraitsT>
+struct IntrusiveListIteratorBase
+{
+	friend ListT;
+
+	using RefT = typename IteratorTraitsT::RefT;
+	using PtrT = typename IteratorTraitsT::PtrT;
+
+	/**
+	 * Create iterator that points
+	 * on link.
+	 *
+	 * @param inLink current link
+	 */
+	FORCE_INLINE explicit IntrusiveListIteratorBase(LinkT * inLink = nullptr)
+		: link{inLink}
+	{
+		//
+	}
+
+	/**
+	 * Returns ref to item that owns
+	 * the current link.
+	 */
+	FORCE_INLINE RefT operator*() const
+	{
+		return *ListT::getOwner(link);
+	}
+
+	/**
+	 * Returns ptr to item that owns
+	 * the current link.
+	 */
+	FORCE_INLINE PtrT operator->() const
+	{
+		return ListT::getOwner(link);
+	}
+
+	/**
+	 * Returns true if both iterators
+	 * point to the same link.
+	 */
+	FORCE_INLINE bool operator==(const IntrusiveListIteratorBase & other) const
+	{
+		return link == other.link;
+	}
+
+	/**
+	 * Returns true if iterators point
+	 * to different links.
+	 */
+	FORCE_INLINE bool operator!=(const IntrusiveListIteratorBase & other) const
+	{
+		return !(*this == other);
+	}
+
+	/**
+	 * Advances iterator to the next
+	 * link and returns a ref to the
+	 * iterator.
+	 */
+	FORCE_INLINE IntrusiveListIteratorBase & operator++()
+	{
+		link = link->next;
+		return *this;
+	}
+
+	/**
+	 * Advances iterator to the next
+	 * link and returns a new iterator
+	 * that points to the current link.
+	 */
+	FORCE_INLINE IntrusiveListIteratorBase operator++(int32)
+	{
+		IntrusiveListIteratorBase it{*this};
+		link = link->next;
+		return it;
+	}
+
+	/**
+	 * Move iterator backward and
+	 * returns a ref to the iterator.
+	 */
+	FORCE_INLINE IntrusiveListIteratorBase & operator--()
+	{
+		link = link->prev;
+		return *this;
+	}
+
+	/**
+	 * Moves iterator to the previous
+	 * link and returns a new iterator
+	 * that points to the current link.
+	 */
+	FORCE_INLINE IntrusiveListIteratorBase operator--(int32)
+	{
+		IntrusiveListIteratorBase it{*this};
+		link = link->prev;
+		return it;
+	}
+
+private:
+	/// Current link
+	LinkT * link;
+};
+
+/**
+ * A doubly linked list whose links
+ * are embedded in the items, rather
+ * than allocated by the list. Pushing
+ * and removing items never allocates,
+ * and any item can be unlinked in
+ * O(1) time without searching it.
+ *
+ * The list does not own its items:
+ * items must outlive the list or be
+ * removed before being destroyed.
+ *
+ * ```
+ * struct Timer
+ * {
+ * 	uint64 deadline;
+ * 	IntrusiveLink link;
+ * };
+ *
+ * IntrusiveList<Timer, &Timer::link> timers;
+ * timers.pushBack(timer);
+ * ```
+ *
+ * @param T type of the items
+ * @param hook pointer to the hook
+ * 	member of T
+ */
+template<typename T, IntrusiveLink T::*hook>
+class IntrusiveList
+{
+public:
+	using ItemT = T;
+	using Iterator = IntrusiveListIteratorBase<IntrusiveList, IntrusiveLink, BidirectionalIterator<T>>;
+	using ConstIterator = IntrusiveListIteratorBase<IntrusiveList, const IntrusiveLink, BidirectionalIterator<const T>>;
+
+	/**
+	 * Returns the hook of the item.
+	 * @{
+	 */
+	static FORCE_INLINE IntrusiveLink * getLink(T & item)
+	{
+		return &(item.*hook);
+	}
+
+	static FORCE_INLINE const IntrusiveLink * getLink(const T & item)
+	{
+		return &(item.*hook);
+	}
+	/// @}
+
+	/**
+	 * Returns the item that owns the
+	 * hook.
+	 * @{
+	 */
+	static FORCE_INLINE T * getOwner(IntrusiveLink * link)
+	{
+		return reinterpret_cast<T*>(reinterpret_cast<ubyte*>(link) - getHookOffset());
+	}
+
+	static FORCE_INLINE const T * getOwner(const IntrusiveLink * link)
+	{
+		return reinterpret_cast<const T*>(reinterpret_cast<const ubyte*>(link) - getHookOffset());
+	}
+	/// @}
+
+	/**
+	 * Creates an empty list.
+	 */
+	FORCE_INLINE IntrusiveList()
+		: root{}
+		, length{0}
+	{
+		root.next = root.prev = &root;
+	}
+
+	/**
+	 * Lists cannot be copied, because
+	 * an item can be linked only once
+	 * per hook.
+	 * @{
+	 */
+	IntrusiveList(const IntrusiveList &) = delete;
+	IntrusiveList & operator=(const IntrusiveList &) = delete;
+	/// @}
+
+	/**
+	 * Move constructor, items are
+	 * relinked to the new list.
+	 */
+	FORCE_INLINE IntrusiveList(IntrusiveList && other)
+		: IntrusiveList{}
+	{
+		takeFrom(other);
+	}
+
+	/**
+	 * Move assignment.
+	 */
+	FORCE_INLINE IntrusiveList & operator=(IntrusiveList && other)
+	{
+		empty();
+		takeFrom(other);
+
+		return *this;
+	}
+
+	/**
+	 * Destructor, unlinks all items.
+	 */
+	FORCE_INLINE ~IntrusiveList()
+	{
+		empty();
+	}
+
+	/**
+	 * Returns the first item of the
+	 * list, or nullptr if empty.
+	 * @{
+	 */
+	FORCE_INLINE const T * getHead() const
+	{
+		return length ? getOwner(root.next) : nullptr;
+	}
+
+	FORCE_INLINE T * getHead()
+	{
+		return length ? getOwner(root.next) : nullptr;
+	}
+	/// @}
+
+	/**
+	 * Returns the last item of the
+	 * list, or nullptr if empty.
+	 * @{
+	 */
+	FORCE_INLINE const T * getTail() const
+	{
+		return length ? getOwner(root.prev) : nullptr;
+	}
+
+	FORCE_INLINE T * getTail()
+	{
+		return length ? getOwner(root.prev) : nullptr;
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator that points
+	 * to the first item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{root.next};
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return Iterator{root.next};
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator that points
+	 * past the last item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{&root};
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return Iterator{&root};
+	}
+	/// @}
+
+	/**
+	 * Returns the number of items in
+	 * the list.
+	 */
+	FORCE_INLINE uint64 getLength() const
+	{
+		return length;
+	}
+
+	/**
+	 * Returns true if list is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return length == 0;
+	}
+
+	/**
+	 * Returns true if the item is linked
+	 * in a list with this hook. It does
+	 * not tell whether it is this list.
+	 */
+	static FORCE_INLINE bool isLinked(const T & item)
+	{
+		return getLink(item)->isLinked();
+	}
+
+	/**
+	 * Links item at the end of the
+	 * list. The item must not be
+	 * linked already.
+	 *
+	 * @param item item to link
+	 * @return ref to item
+	 */
+	FORCE_INLINE T & pushBack(T & item)
+	{
+		linkBefore(&root, getLink(item));
+		return item;
+	}
+
+	/**
+	 * Links item at the start of the
+	 * list. The item must not be
+	 * linked already.
+	 *
+	 * @param item item to link
+	 * @return ref to item
+	 */
+	FORCE_INLINE T & pushFront(T & item)
+	{
+		linkBefore(root.next, getLink(item));
+		return item;
+	}
+
+	/**
+	 * Links item before the item
+	 * pointed by the iterator.
+	 *
+	 * @param it iterator to next item,
+	 * 	may be end()
+	 * @param item item to link
+	 * @return ref to item
+	 */
+	FORCE_INLINE T & insert(Iterator it, T & item)
+	{
+		linkBefore(it.link, getLink(item));
+		return item;
+	}
+
+	/**
+	 * Unlinks item from the list. The
+	 * item must be linked in this list.
+	 *
+	 * @param item item to unlink
+	 */
+	FORCE_INLINE void remove(T & item)
+	{
+		unlink(getLink(item));
+	}
+
+	/**
+	 * Unlinks item pointed by the
+	 * iterator.
+	 *
+	 * @param it iterator to item
+	 * @return iterator to next item
+	 */
+	FORCE_INLINE Iterator remove(Iterator it)
+	{
+		IntrusiveLink * next = it.link->next;
+		unlink(it.link);
+		return Iterator{next};
+	}
+
+	/**
+	 * Unlinks the last item.
+	 *
+	 * @return the unlinked item, or
+	 * 	nullptr if list is empty
+	 */
+	FORCE_INLINE T * popBack()
+	{
+		if (length == 0) return nullptr;
+
+		IntrusiveLink * link = root.prev;
+		unlink(link);
+		return getOwner(link);
+	}
+
+	/**
+	 * Unlinks the first item.
+	 *
+	 * @return the unlinked item, or
+	 * 	nullptr if list is empty
+	 */
+	FORCE_INLINE T * popFront()
+	{
+		if (length == 0) return nullptr;
+
+		IntrusiveLink * link = root.next;
+		unlink(link);
+		return getOwner(link);
+	}
+
+	/**
+	 * Unlinks all items, items are not
+	 * destroyed.
+	 * @{
+	 */
+	void empty()
+	{
+		IntrusiveLink * link = root.next;
+		while (link != &root)
+		{
+			IntrusiveLink * next = link->next;
+			link->next = link->prev = nullptr;
+			link = next;
+		}
+
+		root.next = root.prev = &root;
+		length = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/**
+	 * Returns the offset of the hook
+	 * from the start of the item.
+	 */
+	static FORCE_INLINE sizet getHookOffset()
+	{
+		// Folded to a constant, no item
+		// is actually constructed. Does
+		// not work for hooks reached
+		// through a virtual base, whose
+		// offset is only known at runtime
+		alignas(T) ubyte storage[sizeof(T)];
+		const T * item = reinterpret_cast<const T*>(storage);
+		return reinterpret_cast<const ubyte*>(&(item->*hook)) - storage;
+	}
+
+	/**
+	 * Links a new link before the
+	 * given one.
+	 *
+	 * @param next link that will follow
+	 * @param link link to insert
+	 */
+	FORCE_INLINE void linkBefore(IntrusiveLink * next, IntrusiveLink * link)
+	{
+		CHECKF(!link->isLinked(), "Item is already linked in a list")
+
+		link->next = next;
+		link->prev = next->prev;
+		next->prev->next = link;
+		next->prev = link;
+		++length;
+	}
+
+	/**
+	 * Unlinks the given link.
+	 *
+	 * @param link link to remove
+	 */
+	FORCE_INLINE void unlink(IntrusiveLink * link)
+	{
+		CHECKF(link->isLinked(), "Item is not linked in a list")
+
+		link->prev->next = link->next;
+		link->next->prev = link->prev;
+		link->next = link->prev = nullptr;
+		--length;
+	}
+
+	/**
+	 * Relinks all the items of another
+	 * list into this empty list.
+	 *
+	 * @param other list to take from
+	 */
+	FORCE_INLINE void takeFrom(IntrusiveList & other)
+	{
+		if (other.length > 0)
+		{
+			root.next = other.root.next;
+			root.prev = other.root.prev;
+			root.next->prev = root.prev->next = &root;
+			length = other.length;
+
+			other.root.next = other.root.prev = &other.root;
+			other.length = 0;
+		}
+	}
+
+	/// Sentinel link, its next is the
+	/// head and its prev the tail
+	IntrusiveLink root;
+
+	/// Number of linked items
+	uint64 length;
+};
@@ -0,0 +1,540 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "templates/hash.h"
+#include "templates/function.h"
+#include "hal/platform_memory.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+#include "./hash_index.h"
+
+/**
+ * A fixed capacity cache that evicts the
+ * least recently used entry when full.
+ *
+ * All the storage is allocated when the
+ * cache is created: entries live in a
+ * flat array, the recency list links
+ * them with 32-bit indices, and a hash
+ * index maps keys to entries. Lookups
+ * and updates are O(1) and never
+ * allocate.
+ *
+ * @param K type of the keys
+ * @param V type of the values
+ * @param HashT hash function type
+ */
+template<typename K, typename V, typename HashT>
+class LRUCache<K, V, HashT, void>
+{
+public:
+	using KeyT = K;
+	using ValueT = V;
+	using HashFnT = HashT;
+	using EvictionCallbackT = Function<void(const K&, V&)>;
+
+protected:
+	/**
+	 * An entry of the cache.
+	 */
+	struct Entry
+	{
+		/// Hash of the key
+		uint64 hash;
+
+		/// Key of the entry
+		K key;
+
+		/// Cached value
+		V value;
+
+		/**
+		 * Creates a new entry.
+		 */
+		template<typename KeyU, typename ValueU>
+		FORCE_INLINE Entry(uint64 inHash, KeyU && inKey, ValueU && inValue)
+			: hash{inHash}
+			, key{forward<KeyU>(inKey)}
+			, value{forward<ValueU>(inValue)}
+		{
+			//
+		}
+	};
+
+	/**
+	 * A node of the recency list. Free
+	 * entries are chained with the next
+	 * index.
+	 */
+	struct Node
+	{
+		/// Index of the more recent entry
+		uint32 prev;
+
+		/// Index of the less recent entry
+		uint32 next;
+	};
+
+	/// Invalid entry index
+	static constexpr uint32 invalidIdx = HashIndex::invalidEntry;
+
+	/**
+	 * Returns the index of the entry with
+	 * the given key, or invalid.
+	 */
+	template<typename KeyU>
+	FORCE_INLINE uint32 findEntry(uint64 keyHash, const KeyU & key) const
+	{
+		return index.find(keyHash, [this, &key](uint32 idx) {
+
+			return entries[idx].key == key;
+		});
+	}
+
+	/**
+	 * Links an entry at the front of the
+	 * recency list.
+	 */
+	FORCE_INLINE void linkFront(uint32 idx)
+	{
+		const uint32 first = nodes[capacity].next;
+		nodes[idx] = Node{capacity, first};
+		nodes[first].prev = idx;
+		nodes[capacity].next = idx;
+	}
+
+	/**
+	 * Unlinks an entry from the recency
+	 * list.
+	 */
+	FORCE_INLINE void unlink(uint32 idx)
+	{
+		const Node node = nodes[idx];
+		nodes[node.prev].next = node.next;
+		nodes[node.next].prev = node.prev;
+	}
+
+	/**
+	 * Moves an entry to the front of the
+	 * recency list.
+	 */
+	FORCE_INLINE void promote(uint32 idx)
+	{
+		if (nodes[capacity].next != idx)
+		{
+			unlink(idx);
+			linkFront(idx);
+		}
+	}
+
+	/**
+	 * Removes an entry and puts it back
+	 * in the free list.
+	 */
+	FORCE_INLINE void removeEntry(uint32 idx)
+	{
+		index.remove(entries[idx].hash, idx);
+		unlink(idx);
+
+		entries[idx].~Entry();
+		nodes[idx].next = freeHead;
+		freeHead = idx;
+		--count;
+	}
+
+	/**
+	 * Chains all the entries in the free
+	 * list and empties the recency list.
+	 */
+	void resetLists()
+	{
+		for (uint32 idx = 0; idx < capacity; ++idx) nodes[idx].next = idx + 1;
+		nodes[capacity - 1].next = invalidIdx;
+		nodes[capacity] = Node{capacity, capacity};
+		freeHead = 0;
+	}
+
+	/**
+	 * Allocates the storage of the cache.
+	 *
+	 * @param inCapacity max number of
+	 * 	entries
+	 */
+	void allocate(uint32 inCapacity)
+	{
+		CHECKF(inCapacity > 0, "Cache capacity must be greater than zero")
+
+		capacity = inCapacity;
+		entries = entriesMalloc.alloc(capacity);
+		nodes = nodesMalloc.alloc(capacity + 1);
+		CHECKF(entries && nodes, "Could not allocate cache storage")
+
+		index.allocate(capacity);
+		resetLists();
+	}
+
+	/**
+	 * Creates a cache with no storage,
+	 * that uses the given allocator. Call
+	 * allocate before using it.
+	 */
+	FORCE_INLINE explicit LRUCache(MallocBase * inMalloc)
+		: entriesMalloc{inMalloc}
+		, nodesMalloc{inMalloc}
+		, index{inMalloc}
+		, entries{nullptr}
+		, nodes{nullptr}
+		, capacity{0}
+		, count{0}
+		, freeHead{invalidIdx}
+		, hash{}
+		, onEvict{}
+	{
+		//
+	}
+
+	/**
+	 * Destroys all entries and
+	 * deallocates the storage.
+	 */
+	void destroy()
+	{
+		if (entries)
+		{
+			empty();
+			entriesMalloc.free(entries);
+			nodesMalloc.free(nodes);
+			entries = nullptr;
+			nodes = nullptr;
+		}
+
+		index.destroy();
+		capacity = 0;
+	}
+
+public:
+	/**
+	 * Creates an empty cache.
+	 *
+	 * @param inCapacity max number of
+	 * 	entries
+	 * @param [inMalloc] allocator used
+	 * 	for the storage
+	 */
+	FORCE_INLINE explicit LRUCache(uint32 inCapacity, MallocBase * inMalloc = gMalloc)
+		: LRUCache{inMalloc}
+	{
+		allocate(inCapacity);
+	}
+
+	/**
+	 * Caches are not copyable.
+	 * @{
+	 */
+	LRUCache(const LRUCache&) = delete;
+	LRUCache & operator=(const LRUCache&) = delete;
+	/// @}
+
+	/**
+	 * Destructor, destroys all entries.
+	 */
+	FORCE_INLINE ~LRUCache()
+	{
+		destroy();
+	}
+
+	/**
+	 * Returns the number of entries.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns the max number of entries.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return capacity;
+	}
+
+	/**
+	 * Returns true if cache is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns true if the next insertion
+	 * of a new key evicts an entry.
+	 */
+	FORCE_INLINE bool isFull() const
+	{
+		return count == capacity;
+	}
+
+	/**
+	 * Sets a function called with the key
+	 * and value of each entry evicted to
+	 * make room for a new one. Entries
+	 * removed explicitly are not passed
+	 * to the callback.
+	 *
+	 * @param fn callable object
+	 */
+	template<typename FnT>
+	FORCE_INLINE void setEvictionCallback(FnT && fn)
+	{
+		// Bind a copy, Function would only
+		// hold a reference to lvalues
+		onEvict = EvictionCallbackT{typename DecayType<FnT>::Type{forward<FnT>(fn)}};
+	}
+
+	/**
+	 * Returns the value associated with
+	 * the key, and marks it as the most
+	 * recently used.
+	 *
+	 * @param key key of the entry
+	 * @return ptr to value, or nullptr
+	 */
+	template<typename KeyU>
+	FORCE_INLINE V * get(const KeyU & key)
+	{
+		const uint32 idx = findEntry(hash(key), key);
+		if (idx == invalidIdx) return nullptr;
+
+		promote(idx);
+		return &entries[idx].value;
+	}
+
+	/**
+	 * Returns the value associated with
+	 * the key, without changing its
+	 * recency.
+	 *
+	 * @param key key of the entry
+	 * @return ptr to value, or nullptr
+	 */
+	template<typename KeyU>
+	FORCE_INLINE const V * peek(const KeyU & key) const
+	{
+		const uint32 idx = findEntry(hash(key), key);
+		return idx != invalidIdx ? &entries[idx].value : nullptr;
+	}
+
+	/**
+	 * Returns true if the cache contains
+	 * the key. Does not change its
+	 * recency.
+	 *
+	 * @param key key to find
+	 * @return true if found
+	 */
+	template<typename KeyU>
+	FORCE_INLINE bool has(const KeyU & key) const
+	{
+		return findEntry(hash(key), key) != invalidIdx;
+	}
+
+	/**
+	 * Inserts or updates an entry and
+	 * marks it as the most recently used.
+	 * If the key is new and the cache is
+	 * full, the least recently used entry
+	 * is evicted first.
+	 *
+	 * @param key key of the entry
+	 * @param value value to cache
+	 * @return ref to cached value
+	 * @{
+	 */
+	template<typename KeyU, typename ValueU>
+	V & insert(KeyU && key, ValueU && value)
+	{
+		const uint64 keyHash = hash(key);
+		uint32 idx = findEntry(keyHash, key);
+		if (idx != invalidIdx)
+		{
+			entries[idx].value = forward<ValueU>(value);
+			promote(idx);
+			return entries[idx].value;
+		}
+
+		if (count == capacity) evict();
+
+		idx = freeHead;
+		freeHead = nodes[idx].next;
+
+		new (entries + idx) Entry{keyHash, forward<KeyU>(key), forward<ValueU>(value)};
+		index.insert(keyHash, idx);
+		linkFront(idx);
+		++count;
+
+		return entries[idx].value;
+	}
+
+	METHOD_ALIAS(put, insert)
+	/// @}
+
+	/**
+	 * Removes the entry with the given
+	 * key.
+	 *
+	 * @param key key of the entry
+	 * @return true if entry was found
+	 */
+	template<typename KeyU>
+	bool remove(const KeyU & key)
+	{
+		const uint32 idx = findEntry(hash(key), key);
+		if (idx == invalidIdx) return false;
+
+		removeEntry(idx);
+		return true;
+	}
+
+	/**
+	 * Evicts the least recently used
+	 * entry, and passes it to the
+	 * eviction callback.
+	 *
+	 * @return true if an entry was
+	 * 	evicted
+	 */
+	bool evict()
+	{
+		if (count == 0) return false;
+
+		const uint32 idx = nodes[capacity].prev;
+		if (onEvict) onEvict(entries[idx].key, entries[idx].value);
+
+		removeEntry(idx);
+		return true;
+	}
+
+	/**
+	 * Calls a function on each entry, from
+	 * the most to the least recently
+	 * used.
+	 *
+	 * @param fn function called with the
+	 * 	key and the value
+	 */
+	template<typename FnT>
+	void forEach(FnT && fn) const
+	{
+		for (uint32 idx = nodes[capacity].next; idx != capacity; idx = nodes[idx].next)
+		{
+			fn(static_cast<const K&>(entries[idx].key), static_cast<const V&>(entries[idx].value));
+		}
+	}
+
+	/**
+	 * Removes all entries, without
+	 * calling the eviction callback.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint32 idx = nodes[capacity].next; idx != capacity; idx = nodes[idx].next)
+		{
+			entries[idx].~Entry();
+		}
+
+		index.empty();
+		resetLists();
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/// Entries allocator
+	MallocObject<Entry> entriesMalloc;
+
+	/// Nodes allocator
+	MallocObject<Node> nodesMalloc;
+
+	/// Index of the entries
+	HashIndex index;
+
+	/// Entries storage
+	Entry * entries;
+
+	/// Recency list nodes, the last node
+	/// is the sentinel
+	Node * nodes;
+
+	/// Max number of entries
+	uint32 capacity;
+
+	/// Number of entries
+	uint32 count;
+
+	/// First free entry
+	uint32 freeHead;
+
+	/// Hash function
+	HashT hash;
+
+	/// Called on evicted entries
+	EvictionCallbackT onEvict;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param K type of the keys
+ * @param V type of the values
+ * @param HashT hash function type
+ * @param MallocT allocator type
+ */
+template<typename K, typename V, typename HashT, typename MallocT>
+class LRUCache : public LRUCache<K, V, HashT, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = LRUCache<K, V, HashT, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty cache that uses it.
+	 *
+	 * @param inCapacity max number of
+	 * 	entries
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE explicit LRUCache(uint32 inCapacity, MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		Base::allocate(inCapacity);
+	}
+
+	/**
+	 * Destructor, destroy entries here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~LRUCache()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
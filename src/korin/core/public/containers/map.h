@@ -38,6 +38,21 @@ public:
 		//
 	}
 
+	/**
+	 * Returns a ref to the underlying tree.
+	 * @{
+	 */
+	FORCE_INLINE const TreeT & getTree() const
+	{
+		return tree;
+	}
+
+	FORCE_INLINE TreeT & getTree()
+	{
+		return tree;
+	}
+	/// @}
+
 	/**
 	 * Returns number of pairs.
 	 * @{
@@ -0,0 +1,297 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/functional.h"
+#include "templates/string_view.h"
+#include "./containers_types.h"
+
+/**
+ * Base class of the views stored in a
+ * mapped image. A view points to its data
+ * with an offset relative to its own
+ * address, so that the image can be
+ * mapped at any address.
+ *
+ * Views only exist inside an image, they
+ * can't be copied out of it.
+ */
+class MappedView
+{
+	friend class MappedImageWriter;
+
+public:
+	MappedView() = default;
+	MappedView(const MappedView&) = delete;
+	MappedView & operator=(const MappedView&) = delete;
+
+protected:
+	/**
+	 * Returns a pointer to the data of the
+	 * view.
+	 */
+	template<typename T>
+	FORCE_INLINE const T * getTarget() const
+	{
+		return reinterpret_cast<const T*>(reinterpret_cast<const ubyte*>(this) + offset);
+	}
+
+	/// Offset of the data, relative to
+	/// the address of the view
+	int64 offset = 0;
+};
+
+/**
+ * A read-only array of items stored in a
+ * mapped image. Items must be trivially
+ * copyable or views themselves.
+ *
+ * @param T type of the items
+ */
+template<typename T>
+class MappedArray : public MappedView
+{
+	friend class MappedImageWriter;
+
+public:
+	using ItemT = T;
+
+	/**
+	 * Returns the number of items.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	/// @}
+
+	/**
+	 * Returns true if array has no items.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns the size of the items in
+	 * Bytes.
+	 */
+	FORCE_INLINE sizet getBytes() const
+	{
+		return count * sizeof(T);
+	}
+
+	/**
+	 * Returns pointer to the first item.
+	 */
+	FORCE_INLINE const T * operator*() const
+	{
+		return getTarget<T>();
+	}
+
+	/**
+	 * Returns the i-th item.
+	 */
+	FORCE_INLINE const T & operator[](uint64 idx) const
+	{
+		return getTarget<T>()[idx];
+	}
+
+	/**
+	 * Returns pointers to the first and
+	 * past the last item.
+	 * @{
+	 */
+	FORCE_INLINE const T * begin() const
+	{
+		return getTarget<T>();
+	}
+
+	FORCE_INLINE const T * end() const
+	{
+		return getTarget<T>() + count;
+	}
+	/// @}
+
+	/**
+	 * Returns the index of the first item
+	 * not less than the key. The array
+	 * must be sorted.
+	 *
+	 * @param key search key
+	 * @return index of item, or count if
+	 * 	all items are less than key
+	 */
+	template<typename U, typename CompareT = ThreeWayCompare>
+	uint64 findLowerBound(const U & key) const
+	{
+		const T * items = getTarget<T>();
+		uint64 lo = 0, n = count;
+
+		while (n > 0)
+		{
+			const uint64 half = n / 2;
+			if (CompareT{}(items[lo + half], key) < 0)
+			{
+				lo += half + 1;
+				n -= half + 1;
+			}
+			else n = half;
+		}
+
+		return lo;
+	}
+
+	/**
+	 * Returns the index of an item equal to
+	 * the key, or -1. The array must be
+	 * sorted.
+	 *
+	 * @param key search key
+	 * @return index of item or -1
+	 */
+	template<typename U, typename CompareT = ThreeWayCompare>
+	FORCE_INLINE int64 findSorted(const U & key) const
+	{
+		const uint64 idx = findLowerBound<U, CompareT>(key);
+		return idx < count && CompareT{}(getTarget<T>()[idx], key) == 0 ? static_cast<int64>(idx) : -1;
+	}
+
+protected:
+	/// Number of items
+	uint64 count = 0;
+};
+
+/**
+ * A read-only string stored in a mapped
+ * image. Strings are not terminated.
+ */
+class MappedString : public MappedView
+{
+	friend class MappedImageWriter;
+
+public:
+	/**
+	 * Returns the length of the string.
+	 */
+	FORCE_INLINE uint64 getLength() const
+	{
+		return length;
+	}
+
+	/**
+	 * Returns pointer to the first
+	 * character.
+	 */
+	FORCE_INLINE const ansichar * operator*() const
+	{
+		return getTarget<ansichar>();
+	}
+
+	/**
+	 * Returns a view of the string.
+	 * @{
+	 */
+	FORCE_INLINE StringView getView() const
+	{
+		return StringView{getTarget<ansichar>(), length};
+	}
+
+	FORCE_INLINE operator StringView() const
+	{
+		return getView();
+	}
+	/// @}
+
+	/**
+	 * Compares the string with a view.
+	 * @{
+	 */
+	friend FORCE_INLINE bool operator==(const MappedString & a, const StringView & b) { return a.getView() == b; }
+	friend FORCE_INLINE bool operator!=(const MappedString & a, const StringView & b) { return a.getView() != b; }
+	friend FORCE_INLINE bool operator<(const MappedString & a, const StringView & b) { return a.getView() < b; }
+	friend FORCE_INLINE bool operator>(const MappedString & a, const StringView & b) { return a.getView() > b; }
+	friend FORCE_INLINE bool operator<(const StringView & a, const MappedString & b) { return a < b.getView(); }
+	friend FORCE_INLINE bool operator>(const StringView & a, const MappedString & b) { return a > b.getView(); }
+	friend FORCE_INLINE bool operator<(const MappedString & a, const MappedString & b) { return a.getView() < b.getView(); }
+	friend FORCE_INLINE bool operator>(const MappedString & a, const MappedString & b) { return a.getView() > b.getView(); }
+	/// @}
+
+protected:
+	/// Length of the string
+	uint64 length = 0;
+};
+
+/**
+ * A read-only table of strings stored in
+ * a mapped image. The characters of all
+ * strings are stored contiguously, and
+ * each string costs 8 Bytes of offset.
+ */
+class MappedStringTable
+{
+	friend class MappedImageWriter;
+
+public:
+	/**
+	 * Returns the number of strings.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return offsets.isEmpty() ? 0 : offsets.getCount() - 1;
+	}
+
+	/**
+	 * Returns true if table has no
+	 * strings.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return getCount() == 0;
+	}
+
+	/**
+	 * Returns a view of the i-th string.
+	 */
+	FORCE_INLINE StringView operator[](uint64 idx) const
+	{
+		return StringView{*chars + offsets[idx], offsets[idx + 1] - offsets[idx]};
+	}
+
+	/**
+	 * Returns the index of a string, or -1.
+	 * The strings must be sorted.
+	 *
+	 * @param string string to find
+	 * @return index of string or -1
+	 */
+	int64 findSorted(const StringView & string) const
+	{
+		uint64 lo = 0, n = getCount();
+		while (n > 0)
+		{
+			const uint64 half = n / 2;
+			if ((*this)[lo + half] < string)
+			{
+				lo += half + 1;
+				n -= half + 1;
+			}
+			else n = half;
+		}
+
+		return lo < getCount() && (*this)[lo] == string ? static_cast<int64>(lo) : -1;
+	}
+
+protected:
+	/// Offsets of the strings, plus the
+	/// end of the last string
+	MappedArray<uint64> offsets;
+
+	/// Characters of all strings
+	MappedArray<ansichar> chars;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core_types.h"
+#include "templates/functional.h"
+#include "./containers_types.h"
+#include "./mapped_array.h"
+
+/**
+ * A read-only map stored in a mapped
+ * image. Keys are stored sorted in an
+ * array, separate from the values, and
+ * lookups are binary searches over the
+ * keys.
+ *
+ * Use MappedString for string keys and
+ * values.
+ *
+ * @param K type of the keys
+ * @param V type of the values
+ * @param CompareT type used to compare
+ * 	keys
+ */
+template<typename K, typename V, typename CompareT>
+class MappedFlatMap
+{
+	friend class MappedImageWriter;
+
+public:
+	using KeyT = K;
+	using ValT = V;
+
+	MappedFlatMap() = default;
+	MappedFlatMap(const MappedFlatMap&) = delete;
+	MappedFlatMap & operator=(const MappedFlatMap&) = delete;
+
+	/**
+	 * Returns number of pairs.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return keys.getCount();
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	/// @}
+
+	/**
+	 * Returns true if map is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return keys.isEmpty();
+	}
+
+	/**
+	 * Returns the sorted keys and the
+	 * values.
+	 * @{
+	 */
+	FORCE_INLINE const MappedArray<K> & getKeys() const
+	{
+		return keys;
+	}
+
+	FORCE_INLINE const MappedArray<V> & getValues() const
+	{
+		return values;
+	}
+	/// @}
+
+	/**
+	 * Returns the index of the pair with
+	 * the given key, or -1.
+	 *
+	 * @param key search key
+	 * @return index of pair or -1
+	 */
+	template<typename AnyKeyT>
+	FORCE_INLINE int64 findIndex(const AnyKeyT & key) const
+	{
+		return keys.template findSorted<AnyKeyT, CompareT>(key);
+	}
+
+	/**
+	 * Returns a pointer to the value with
+	 * the given key, or null.
+	 *
+	 * @param key search key
+	 * @return ptr to value or null
+	 */
+	template<typename AnyKeyT>
+	FORCE_INLINE const V * find(const AnyKeyT & key) const
+	{
+		const int64 idx = findIndex(key);
+		return idx < 0 ? nullptr : &values[idx];
+	}
+
+	/**
+	 * Finds the value with the given key
+	 * and copies it.
+	 *
+	 * @param key search key
+	 * @param outVal found value
+	 * @return true if key was found
+	 */
+	template<typename AnyKeyT, typename AnyValT>
+	FORCE_INLINE bool find(const AnyKeyT & key, AnyValT & outVal) const
+	{
+		const int64 idx = findIndex(key);
+		if (idx < 0) return false;
+
+		outVal = values[idx];
+		return true;
+	}
+
+	/**
+	 * Returns true if map has key.
+	 */
+	template<typename AnyKeyT>
+	FORCE_INLINE bool has(const AnyKeyT & key) const
+	{
+		return findIndex(key) >= 0;
+	}
+
+protected:
+	/// Sorted keys
+	MappedArray<K> keys;
+
+	/// Values, in the order of the keys
+	MappedArray<V> values;
+};
@@ -2,6 +2,7 @@
 
 #include "core_types.h"
 #include "templates/utility.h"
+#include "templates/hash.h"
 
 /**
  * A struct with two elements (conceptually
@@ -142,3 +143,16 @@ struct Pair
 	}
 	/** @} */
 };
+
+/**
+ * Hash of pairs, combines the hashes of
+ * both elements.
+ */
+template<typename A, typename B, typename CompareT>
+struct Hash<Pair<A, B, CompareT>>
+{
+	FORCE_INLINE uint64 operator()(const Pair<A, B, CompareT> & pair) const
+	{
+		return HashUtils::hashValues(pair.first, pair.second);
+	}
+};
@@ -0,0 +1,633 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "misc/utility.h"
+#include "templates/utility.h"
+#include "templates/functional.h"
+#include "hal/platform_math.h"
+#include "algorithm/heap.h"
+#include "./array.h"
+
+/**
+ * A priority queue implemented as an
+ * implicit d-ary heap on top of a
+ * dynamic array. The item that
+ * compares smallest is at the top of
+ * the queue.
+ *
+ * Push and pop run in O(log N) time,
+ * top in O(1) time. Higher arities
+ * (the default is 4) make the tree
+ * shallower and keep the children of
+ * a node in the same cache line.
+ *
+ * @param T type of the items
+ * @param CompareT three way compare type
+ * @param MallocT allocator type
+ * @param arity number of children of
+ * 	each node
+ */
+template<typename T, typename CompareT, typename MallocT, uint32 arity>
+class PriorityQueue
+{
+	static_assert(arity > 1, "Priority queue arity must be at least 2");
+
+	using ArrayT = Array<T, MallocT>;
+	using InverseCompareT = InverseCompare<CompareT>;
+
+public:
+	using ConstIterator = typename ArrayT::ConstIterator;
+
+	/**
+	 * Creates an empty queue.
+	 *
+	 * @param inCmp compare function
+	 */
+	FORCE_INLINE PriorityQueue(CompareT inCmp = CompareT{})
+		: cmp{inCmp}
+		, items{}
+	{
+		//
+	}
+
+	/**
+	 * Creates an empty queue that uses
+	 * the given allocator.
+	 *
+	 * @param inMalloc allocator used by
+	 * 	the underlying array
+	 * @param inCmp compare function
+	 */
+	FORCE_INLINE explicit PriorityQueue(MallocBase * inMalloc, CompareT inCmp = CompareT{})
+		: cmp{inCmp}
+		, items{inMalloc}
+	{
+		//
+	}
+
+	/**
+	 * Returns a ref to the underlying
+	 * array. Items are in heap order.
+	 */
+	FORCE_INLINE const ArrayT & getArray() const
+	{
+		return items;
+	}
+
+	/**
+	 * Returns number of items in the
+	 * queue.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return items.getCount();
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getNumItems, getCount)
+	/// @}
+
+	/**
+	 * Returns true if queue is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return items.getCount() == 0;
+	}
+
+	/**
+	 * Returns iterators to the items of
+	 * the queue, in heap order.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return items.begin();
+	}
+
+	FORCE_INLINE ConstIterator end() const
+	{
+		return items.end();
+	}
+	/// @}
+
+	/**
+	 * Returns the item with the highest
+	 * priority, i.e. the smallest one.
+	 */
+	FORCE_INLINE const T & top() const
+	{
+		CHECK(!isEmpty())
+		return items[0];
+	}
+
+	METHOD_ALIAS_CONST(peek, top)
+
+	/**
+	 * Pushes a new item in the queue.
+	 *
+	 * @param item item to push
+	 * @return ref to the top item
+	 */
+	template<typename ItemT>
+	FORCE_INLINE const T & push(ItemT && item)
+	{
+		items.add(forward<ItemT>(item));
+		Heap::siftUp<arity>(*items, static_cast<int64>(items.getCount() - 1), InverseCompareT{cmp});
+
+		return items[0];
+	}
+
+	/**
+	 * Pushes all items in the range. If
+	 * the range is large compared to
+	 * the queue the heap is rebuilt
+	 * from scratch in O(N) time,
+	 * otherwise each item is sifted up.
+	 *
+	 * @param begin,end begin and end iterators
+	 */
+	template<typename It>
+	void pushRange(It begin, It end)
+	{
+		const uint64 prevCount = items.getCount();
+		for (; begin != end; ++begin) items.add(*begin);
+
+		heapify(prevCount);
+	}
+
+	/**
+	 * Pushes all items in the array.
+	 * @see pushRange
+	 *
+	 * @param other array of items
+	 */
+	template<typename OtherMallocT>
+	void pushRange(const Array<T, OtherMallocT> & other)
+	{
+		const uint64 prevCount = items.getCount();
+		for (const T & item : other) items.add(item);
+
+		heapify(prevCount);
+	}
+
+	/**
+	 * Removes the top item.
+	 */
+	FORCE_INLINE void pop()
+	{
+		CHECK(!isEmpty())
+
+		Heap::pop<arity>(*items, *items + items.getCount(), InverseCompareT{cmp});
+		items.removeLast();
+	}
+
+	/**
+	 * Moves the top item out and removes
+	 * it from the queue.
+	 *
+	 * @param outItem moved out item
+	 */
+	FORCE_INLINE void pop(T & outItem)
+	{
+		CHECK(!isEmpty())
+
+		Heap::pop<arity>(*items, *items + items.getCount(), InverseCompareT{cmp});
+		items.popLast(outItem);
+	}
+
+	/**
+	 * Removes all items.
+	 * @{
+	 */
+	FORCE_INLINE void empty()
+	{
+		items.empty();
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+	/**
+	 * Removes all items and releases
+	 * storage.
+	 */
+	FORCE_INLINE void reset()
+	{
+		items.reset();
+	}
+
+protected:
+	/**
+	 * Restores the heap property after
+	 * items have been appended.
+	 *
+	 * @param prevCount number of items
+	 * 	that were already in the heap
+	 */
+	void heapify(uint64 prevCount)
+	{
+		const uint64 count = items.getCount();
+		const uint64 numAdded = count - prevCount;
+
+		if (numAdded * PlatformMath::log2(count | 1) > count)
+			// Bulk rebuild in O(N) time
+			Heap::make<arity>(*items, *items + count, InverseCompareT{cmp});
+		else for (uint64 i = prevCount; i < count; ++i)
+			Heap::siftUp<arity>(*items, static_cast<int64>(i), InverseCompareT{cmp});
+	}
+
+	/// Compare function
+	CompareT cmp;
+
+	/// Items in heap order
+	ArrayT items;
+};
+
+/**
+ * A priority queue of integer keys
+ * that tracks the position of each
+ * key in the heap. This allows to
+ * update or remove the priority of
+ * a key already in the queue, e.g.
+ * the decrease-key operation used
+ * by Dijkstra's algorithm, in
+ * O(log N) time.
+ *
+ * Keys are small integers, used to
+ * index a position table whose size
+ * is the greatest key pushed so far.
+ * The key with the smallest priority
+ * is at the top of the queue.
+ *
+ * @param T type of the priorities
+ * @param CompareT three way compare type
+ * @param MallocT allocator type
+ * @param arity number of children of
+ * 	each node
+ */
+template<typename T, typename CompareT, typename MallocT, uint32 arity>
+class IndexedPriorityQueue
+{
+	static_assert(arity > 1, "Priority queue arity must be at least 2");
+
+public:
+	/**
+	 * A key and its priority.
+	 */
+	struct Entry
+	{
+		/// Item key
+		uint32 key;
+
+		/// Item priority
+		T priority;
+	};
+
+protected:
+	/// Position of keys not in the queue
+	static constexpr int64 invalidPosition = -1;
+
+	using EntryArrayT = Array<Entry, MallocT>;
+	using PositionArrayT = Array<int64, MallocT>;
+
+public:
+	/**
+	 * Creates an empty queue.
+	 *
+	 * @param inCmp compare function
+	 */
+	FORCE_INLINE IndexedPriorityQueue(CompareT inCmp = CompareT{})
+		: cmp{inCmp}
+		, entries{}
+		, positions{}
+	{
+		//
+	}
+
+	/**
+	 * Creates an empty queue that uses
+	 * the given allocator.
+	 *
+	 * @param inMalloc allocator used by
+	 * 	the underlying arrays
+	 * @param inCmp compare function
+	 */
+	FORCE_INLINE explicit IndexedPriorityQueue(MallocBase * inMalloc, CompareT inCmp = CompareT{})
+		: cmp{inCmp}
+		, entries{inMalloc}
+		, positions{inMalloc}
+	{
+		//
+	}
+
+	/**
+	 * Returns number of keys in the
+	 * queue.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return entries.getCount();
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getNumItems, getCount)
+	/// @}
+
+	/**
+	 * Returns true if queue is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return entries.getCount() == 0;
+	}
+
+	/**
+	 * Returns true if key is in the
+	 * queue.
+	 *
+	 * @param key key to search
+	 */
+	FORCE_INLINE bool contains(uint32 key) const
+	{
+		return key < positions.getCount() && positions[key] != invalidPosition;
+	}
+
+	/**
+	 * Returns the priority of a key in
+	 * the queue.
+	 *
+	 * @param key key in the queue
+	 */
+	FORCE_INLINE const T & getPriority(uint32 key) const
+	{
+		CHECK(contains(key))
+		return entries[positions[key]].priority;
+	}
+
+	/**
+	 * Returns the entry with the highest
+	 * priority, i.e. the smallest one.
+	 */
+	FORCE_INLINE const Entry & top() const
+	{
+		CHECK(!isEmpty())
+		return entries[0];
+	}
+
+	METHOD_ALIAS_CONST(peek, top)
+
+	/**
+	 * Pushes a key that is not in the
+	 * queue.
+	 *
+	 * @param key key to push
+	 * @param priority key priority
+	 */
+	template<typename PriorityT>
+	void push(uint32 key, PriorityT && priority)
+	{
+		CHECKF(!contains(key), "Key %u is already in the queue", key)
+
+		// Grow position table
+		while (positions.getCount() <= key) positions.add(invalidPosition);
+
+		const int64 idx = static_cast<int64>(entries.getCount());
+		entries.add(Entry{key, forward<PriorityT>(priority)});
+		positions[key] = idx;
+
+		siftUp(idx);
+	}
+
+	/**
+	 * Lowers the priority of a key in the
+	 * queue, i.e. moves it closer to the
+	 * top.
+	 *
+	 * @param key key in the queue
+	 * @param priority new priority, must
+	 * 	be smaller or equal to the
+	 * 	current one
+	 */
+	template<typename PriorityT>
+	void decreaseKey(uint32 key, PriorityT && priority)
+	{
+		CHECK(contains(key))
+
+		const int64 idx = positions[key];
+		CHECKF(cmp(priority, entries[idx].priority) <= 0, "New priority must not be greater than current one")
+
+		entries[idx].priority = forward<PriorityT>(priority);
+		siftUp(idx);
+	}
+
+	/**
+	 * Pushes a key if it is not in the
+	 * queue, otherwise lowers its
+	 * priority if the new priority is
+	 * smaller.
+	 *
+	 * @param key key to push or update
+	 * @param priority key priority
+	 * @return true if queue was modified
+	 */
+	template<typename PriorityT>
+	bool pushOrDecrease(uint32 key, PriorityT && priority)
+	{
+		if (!contains(key))
+		{
+			push(key, forward<PriorityT>(priority));
+			return true;
+		}
+
+		const int64 idx = positions[key];
+		if (cmp(priority, entries[idx].priority) < 0)
+		{
+			entries[idx].priority = forward<PriorityT>(priority);
+			siftUp(idx);
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Changes the priority of a key in
+	 * the queue, in any direction.
+	 *
+	 * @param key key in the queue
+	 * @param priority new priority
+	 */
+	template<typename PriorityT>
+	void update(uint32 key, PriorityT && priority)
+	{
+		CHECK(contains(key))
+
+		const int64 idx = positions[key];
+		const int32 dir = cmp(priority, entries[idx].priority);
+
+		entries[idx].priority = forward<PriorityT>(priority);
+		if (dir < 0) siftUp(idx);
+		else if (dir > 0) siftDown(idx);
+	}
+
+	/**
+	 * Removes the top entry.
+	 */
+	FORCE_INLINE void pop()
+	{
+		CHECK(!isEmpty())
+		removeAt(0);
+	}
+
+	/**
+	 * Moves the top entry out and
+	 * removes it from the queue.
+	 *
+	 * @param outEntry moved out entry
+	 */
+	FORCE_INLINE void pop(Entry & outEntry)
+	{
+		CHECK(!isEmpty())
+
+		outEntry = move(entries[0]);
+		removeAt(0);
+	}
+
+	/**
+	 * Removes a key from the queue.
+	 *
+	 * @param key key to remove
+	 * @return true if key was in the
+	 * 	queue
+	 */
+	FORCE_INLINE bool remove(uint32 key)
+	{
+		if (!contains(key)) return false;
+
+		removeAt(positions[key]);
+		return true;
+	}
+
+	/**
+	 * Removes all keys.
+	 * @{
+	 */
+	void empty()
+	{
+		for (const Entry & entry : entries) positions[entry.key] = invalidPosition;
+		entries.empty();
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+	/**
+	 * Removes all keys and releases
+	 * storage.
+	 */
+	FORCE_INLINE void reset()
+	{
+		entries.reset();
+		positions.reset();
+	}
+
+protected:
+	/**
+	 * Removes the entry at the given
+	 * heap position.
+	 *
+	 * @param idx position of the entry
+	 */
+	void removeAt(int64 idx)
+	{
+		const int64 last = static_cast<int64>(entries.getCount() - 1);
+		positions[entries[idx].key] = invalidPosition;
+
+		if (idx != last)
+		{
+			// Move last entry in the hole
+			// and restore heap property
+			const int32 dir = cmp(entries[last].priority, entries[idx].priority);
+			entries[idx] = move(entries[last]);
+			positions[entries[idx].key] = idx;
+			entries.removeLast();
+
+			if (dir < 0) siftUp(idx);
+			else siftDown(idx);
+		}
+		else entries.removeLast();
+	}
+
+	/**
+	 * Moves an entry up the heap until
+	 * its parent is smaller or equal,
+	 * and updates the positions of all
+	 * moved entries.
+	 *
+	 * @param idx position of the entry
+	 */
+	void siftUp(int64 idx)
+	{
+		Entry entry = move(entries[idx]);
+		while (idx > 0)
+		{
+			const int64 parent = Heap::getParent<arity>(idx);
+			if (cmp(entries[parent].priority, entry.priority) <= 0) break;
+
+			entries[idx] = move(entries[parent]);
+			positions[entries[idx].key] = idx;
+			idx = parent;
+		}
+
+		entries[idx] = move(entry);
+		positions[entries[idx].key] = idx;
+	}
+
+	/**
+	 * Moves an entry down the heap until
+	 * all its children are greater or
+	 * equal, and updates the positions
+	 * of all moved entries.
+	 *
+	 * @param idx position of the entry
+	 */
+	void siftDown(int64 idx)
+	{
+		const int64 count = static_cast<int64>(entries.getCount());
+
+		Entry entry = move(entries[idx]);
+		for (;;)
+		{
+			const int64 first = Heap::getFirstChild<arity>(idx);
+			if (first >= count) break;
+
+			// Find smallest child
+			const int64 last = first + arity < count ? first + arity : count;
+			int64 child = first;
+			for (int64 i = first + 1; i < last; ++i)
+				if (cmp(entries[i].priority, entries[child].priority) < 0) child = i;
+
+			if (cmp(entry.priority, entries[child].priority) <= 0) break;
+
+			entries[idx] = move(entries[child]);
+			positions[entries[idx].key] = idx;
+			idx = child;
+		}
+
+		entries[idx] = move(entry);
+		positions[entries[idx].key] = idx;
+	}
+
+	/// Compare function
+	CompareT cmp;
+
+	/// Entries in heap order
+	EntryArrayT entries;
+
+	/// Heap position of each key
+	PositionArrayT positions;
+};
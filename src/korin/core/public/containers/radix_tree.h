@@ -0,0 +1,1527 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "templates/string_view.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_math.h"
+#include "hal/malloc_ansi.h"
+#include "./containers_types.h"
+
+#if PLATFORM_USE_SIMD && defined(__SSE2__)
+	#define RADIX_TREE_USE_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define RADIX_TREE_USE_SSE2 0
+#endif
+
+/**
+ * Iterator of a radix tree, visits the
+ * entries in lexicographic order of the
+ * keys. Each step seeks the next key
+ * from the root, so it costs O(k) where
+ * k is the length of the key.
+ *
+ * @param RadixTreeT type of the tree
+ * @param EntryT type of the entries
+ */
+template<typename RadixTreeT, typename EntryT>
+class RadixTreeIteratorBase
+{
+	template<typename, typename> friend class RadixTree;
+
+public:
+	using RefT = EntryT&;
+	using PtrT = EntryT*;
+
+	/**
+	 * Creates an iterator that points to
+	 * the given entry of the tree.
+	 */
+	FORCE_INLINE explicit RadixTreeIteratorBase(const RadixTreeT * inTree = nullptr, EntryT * inEntry = nullptr)
+		: tree{inTree}
+		, entry{inEntry}
+	{
+		//
+	}
+
+	/**
+	 * Returns ref to the entry.
+	 */
+	FORCE_INLINE RefT operator*() const
+	{
+		return *entry;
+	}
+
+	/**
+	 * Returns ptr to the entry.
+	 */
+	FORCE_INLINE PtrT operator->() const
+	{
+		return entry;
+	}
+
+	/**
+	 * Returns true if iterators point to
+	 * the same entry.
+	 * @{
+	 */
+	FORCE_INLINE bool operator==(const RadixTreeIteratorBase & other) const
+	{
+		return entry == other.entry;
+	}
+
+	FORCE_INLINE bool operator!=(const RadixTreeIteratorBase & other) const
+	{
+		return entry != other.entry;
+	}
+	/// @}
+
+	/**
+	 * Moves to the entry with the next
+	 * key.
+	 * @{
+	 */
+	FORCE_INLINE RadixTreeIteratorBase & operator++()
+	{
+		entry = tree->findNext(entry->getKey());
+		return *this;
+	}
+
+	FORCE_INLINE RadixTreeIteratorBase operator++(int32)
+	{
+		RadixTreeIteratorBase other{*this};
+		++(*this);
+		return other;
+	}
+	/// @}
+
+protected:
+	/// Iterated tree
+	const RadixTreeT * tree;
+
+	/// Current entry
+	EntryT * entry;
+};
+
+/**
+ * An adaptive radix tree (ART), a trie
+ * that maps byte strings to values.
+ *
+ * Inner nodes have one of four sizes,
+ * with 4, 16, 48 or 256 children, and
+ * grow or shrink as children are added
+ * or removed. Node16 compares all keys
+ * at once with SSE2. Chains of nodes
+ * with a single child are compressed in
+ * a prefix stored in the node, up to
+ * maxPrefixLength bytes; longer
+ * prefixes are checked against the key
+ * stored in the leaves.
+ *
+ * Lookups cost O(k) where k is the key
+ * length, independently of the number
+ * of keys. Keys are kept sorted, which
+ * allows ordered iteration, longest
+ * prefix matches and prefix scans.
+ *
+ * Keys are StringView, and can be
+ * passed as String, Name or C strings.
+ *
+ * @param V type of the values
+ */
+template<typename V>
+class RadixTree<V, void>
+{
+	template<typename, typename> friend class RadixTreeIteratorBase;
+
+public:
+	/**
+	 * An entry of the tree, stores the
+	 * value and a copy of the key.
+	 */
+	class Entry
+	{
+		friend RadixTree;
+
+	public:
+		/**
+		 * Returns the key of the entry.
+		 */
+		FORCE_INLINE StringView getKey() const
+		{
+			return StringView{reinterpret_cast<const ansichar*>(this + 1), keyLength};
+		}
+
+		/**
+		 * Returns the value of the entry.
+		 * @{
+		 */
+		FORCE_INLINE V & getValue()
+		{
+			return value;
+		}
+
+		FORCE_INLINE const V & getValue() const
+		{
+			return value;
+		}
+		/// @}
+
+	protected:
+		/**
+		 * Creates a new entry, the key is
+		 * copied by the tree.
+		 */
+		template<typename ValueU>
+		FORCE_INLINE Entry(uint32 inKeyLength, ValueU && inValue)
+			: value{forward<ValueU>(inValue)}
+			, keyLength{inKeyLength}
+		{
+			//
+		}
+
+		/// Value of the entry
+		V value;
+
+		/// Length of the key, that follows
+		/// the entry in memory
+		uint32 keyLength;
+	};
+
+	using Iterator = RadixTreeIteratorBase<RadixTree, Entry>;
+	using ConstIterator = RadixTreeIteratorBase<RadixTree, const Entry>;
+
+	/// Max number of prefix bytes stored in
+	/// inner nodes
+	static constexpr uint32 maxPrefixLength = 10;
+
+protected:
+	/**
+	 * Type of an inner node.
+	 */
+	enum NodeType : ubyte
+	{
+		Node4Type,
+		Node16Type,
+		Node48Type,
+		Node256Type
+	};
+
+	/**
+	 * Header of the inner nodes. Child
+	 * pointers with the lowest bit set
+	 * point to entries instead.
+	 */
+	struct Node
+	{
+		/// Type of the node
+		NodeType type;
+
+		/// Number of children
+		uint16 numChildren;
+
+		/// Length of the compressed path
+		uint32 prefixLength;
+
+		/// First bytes of the path
+		ubyte prefix[maxPrefixLength];
+
+		/// Entry whose key ends at this
+		/// node, if any
+		Entry * leaf;
+	};
+
+	/**
+	 * Node with up to 4 children, keys are
+	 * sorted.
+	 */
+	struct Node4 : public Node
+	{
+		static constexpr NodeType nodeType = Node4Type;
+		static constexpr uint32 capacity = 4;
+
+		ubyte keys[capacity];
+		Node * children[capacity];
+	};
+
+	/**
+	 * Node with up to 16 children, keys
+	 * are sorted.
+	 */
+	struct Node16 : public Node
+	{
+		static constexpr NodeType nodeType = Node16Type;
+		static constexpr uint32 capacity = 16;
+
+		ubyte keys[capacity];
+		Node * children[capacity];
+	};
+
+	/**
+	 * Node with up to 48 children, indexed
+	 * by a 256-byte map. A zero in the
+	 * map means no child.
+	 */
+	struct Node48 : public Node
+	{
+		static constexpr NodeType nodeType = Node48Type;
+		static constexpr uint32 capacity = 48;
+
+		ubyte childIndex[256];
+		Node * children[capacity];
+	};
+
+	/**
+	 * Node with one slot per byte.
+	 */
+	struct Node256 : public Node
+	{
+		static constexpr NodeType nodeType = Node256Type;
+		static constexpr uint32 capacity = 256;
+
+		Node * children[capacity];
+	};
+
+	/**
+	 * Mode of a seek operation.
+	 */
+	enum class SeekMode
+	{
+		/// First key greater or equal
+		Inclusive,
+
+		/// First key greater
+		Exclusive,
+
+		/// First key that is greater and
+		/// does not start with the key
+		PastPrefix
+	};
+
+	/**
+	 * Tagged pointer utilities.
+	 * @{
+	 */
+	static FORCE_INLINE bool isLeaf(const Node * ref)
+	{
+		return reinterpret_cast<uintp>(ref) & 1;
+	}
+
+	static FORCE_INLINE Entry * toLeaf(const Node * ref)
+	{
+		return reinterpret_cast<Entry*>(reinterpret_cast<uintp>(ref) & ~static_cast<uintp>(1));
+	}
+
+	static FORCE_INLINE Node * fromLeaf(Entry * leaf)
+	{
+		return reinterpret_cast<Node*>(reinterpret_cast<uintp>(leaf) | 1);
+	}
+	/// @}
+
+	/**
+	 * Returns the bytes of the key of an
+	 * entry.
+	 */
+	static FORCE_INLINE const ubyte * getKeyBytes(const Entry * leaf)
+	{
+		return reinterpret_cast<const ubyte*>(leaf + 1);
+	}
+
+	/**
+	 * Creates a new entry and copies the
+	 * key after it.
+	 */
+	template<typename ValueU>
+	Entry * createLeaf(const StringView & key, ValueU && value)
+	{
+		CHECKF(key.getLength() < 0xffffffffull, "Key is too long")
+
+		void * memory = malloc->alloc(sizeof(Entry) + key.getLength(), alignof(Entry));
+		CHECKF(memory != nullptr, "Could not allocate radix tree entry")
+
+		Entry * leaf = new (memory) Entry{static_cast<uint32>(key.getLength()), forward<ValueU>(value)};
+		if (key.getLength() > 0) Memory::memcpy(leaf + 1, *key, key.getLength());
+
+		return leaf;
+	}
+
+	/**
+	 * Destroys and deallocates an entry.
+	 */
+	FORCE_INLINE void destroyLeaf(Entry * leaf)
+	{
+		leaf->~Entry();
+		malloc->free(leaf);
+	}
+
+	/**
+	 * Allocates a new inner node.
+	 */
+	template<typename NodeT>
+	FORCE_INLINE NodeT * createNode()
+	{
+		void * memory = malloc->alloc(sizeof(NodeT), alignof(NodeT));
+		CHECKF(memory != nullptr, "Could not allocate radix tree node")
+
+		NodeT * node = new (memory) NodeT{};
+		node->type = NodeT::nodeType;
+
+		return node;
+	}
+
+	/**
+	 * Allocates a new inner node with the
+	 * same prefix and leaf of another.
+	 */
+	template<typename NodeT>
+	FORCE_INLINE NodeT * createNode(const Node * other)
+	{
+		NodeT * node = createNode<NodeT>();
+		node->numChildren = other->numChildren;
+		node->prefixLength = other->prefixLength;
+		node->leaf = other->leaf;
+		Memory::memcpy(node->prefix, other->prefix, maxPrefixLength);
+
+		return node;
+	}
+
+	/**
+	 * Deallocates an inner node.
+	 */
+	FORCE_INLINE void destroyNode(Node * node)
+	{
+		malloc->free(node);
+	}
+
+	/**
+	 * Destroys a subtree.
+	 */
+	void destroySubtree(Node * ref)
+	{
+		if (!ref) return;
+		if (isLeaf(ref))
+		{
+			destroyLeaf(toLeaf(ref));
+			return;
+		}
+
+		if (ref->leaf) destroyLeaf(ref->leaf);
+		forEachChild(ref, [this](Node * child) {
+
+			destroySubtree(child);
+		});
+
+		destroyNode(ref);
+	}
+
+	/**
+	 * Calls a function on each child of a
+	 * node, in key order.
+	 */
+	template<typename FnT>
+	static void forEachChild(const Node * node, FnT && fn)
+	{
+		switch (node->type)
+		{
+			case Node4Type:
+			{
+				const Node4 * n = static_cast<const Node4*>(node);
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) fn(n->children[idx]);
+				break;
+			}
+			case Node16Type:
+			{
+				const Node16 * n = static_cast<const Node16*>(node);
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) fn(n->children[idx]);
+				break;
+			}
+			case Node48Type:
+			{
+				const Node48 * n = static_cast<const Node48*>(node);
+				for (uint32 byte = 0; byte < 256; ++byte) if (n->childIndex[byte]) fn(n->children[n->childIndex[byte] - 1]);
+				break;
+			}
+			case Node256Type:
+			{
+				const Node256 * n = static_cast<const Node256*>(node);
+				for (uint32 byte = 0; byte < 256; ++byte) if (n->children[byte]) fn(n->children[byte]);
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Returns ptr to the child slot of
+	 * the given byte, or nullptr if the
+	 * node has no such child.
+	 */
+	static FORCE_INLINE Node ** findChild(Node * node, ubyte byte)
+	{
+		switch (node->type)
+		{
+			case Node4Type:
+			{
+				Node4 * n = static_cast<Node4*>(node);
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) if (n->keys[idx] == byte) return n->children + idx;
+				return nullptr;
+			}
+			case Node16Type:
+			{
+				Node16 * n = static_cast<Node16*>(node);
+#if RADIX_TREE_USE_SSE2
+				const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<ansichar>(byte)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+				const uint32 mask = static_cast<uint32>(_mm_movemask_epi8(cmp)) & ((1u << n->numChildren) - 1);
+				return mask ? n->children + __builtin_ctz(mask) : nullptr;
+#else
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) if (n->keys[idx] == byte) return n->children + idx;
+				return nullptr;
+#endif
+			}
+			case Node48Type:
+			{
+				Node48 * n = static_cast<Node48*>(node);
+				return n->childIndex[byte] ? n->children + n->childIndex[byte] - 1 : nullptr;
+			}
+			case Node256Type:
+			{
+				Node256 * n = static_cast<Node256*>(node);
+				return n->children[byte] ? n->children + byte : nullptr;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Returns the first child whose byte
+	 * is greater than the given one, pass
+	 * -1 to get the first child.
+	 */
+	static Node * findChildAfter(const Node * node, int32 byte)
+	{
+		switch (node->type)
+		{
+			case Node4Type:
+			{
+				const Node4 * n = static_cast<const Node4*>(node);
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) if (n->keys[idx] > byte) return n->children[idx];
+				return nullptr;
+			}
+			case Node16Type:
+			{
+				const Node16 * n = static_cast<const Node16*>(node);
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) if (n->keys[idx] > byte) return n->children[idx];
+				return nullptr;
+			}
+			case Node48Type:
+			{
+				const Node48 * n = static_cast<const Node48*>(node);
+				for (int32 idx = byte + 1; idx < 256; ++idx) if (n->childIndex[idx]) return n->children[n->childIndex[idx] - 1];
+				return nullptr;
+			}
+			case Node256Type:
+			{
+				const Node256 * n = static_cast<const Node256*>(node);
+				for (int32 idx = byte + 1; idx < 256; ++idx) if (n->children[idx]) return n->children[idx];
+				return nullptr;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Returns the entry with the smallest
+	 * key in a subtree.
+	 */
+	static Entry * findMinimum(const Node * ref)
+	{
+		while (ref)
+		{
+			if (isLeaf(ref)) return toLeaf(ref);
+			if (ref->leaf) return ref->leaf;
+
+			ref = findChildAfter(ref, -1);
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Inserts a child in a sorted key
+	 * array.
+	 */
+	template<typename NodeT>
+	static FORCE_INLINE void insertSorted(NodeT * n, ubyte byte, Node * child)
+	{
+		uint32 pos = 0;
+		while (pos < n->numChildren && n->keys[pos] < byte) ++pos;
+
+		Memory::memmov(n->keys + pos + 1, n->keys + pos, n->numChildren - pos);
+		Memory::memmov(n->children + pos + 1, n->children + pos, (n->numChildren - pos) * sizeof(Node*));
+		n->keys[pos] = byte;
+		n->children[pos] = child;
+		++n->numChildren;
+	}
+
+	/**
+	 * Adds a child to the node in the
+	 * given slot, growing the node if
+	 * it is full.
+	 *
+	 * @param ref slot of the node
+	 * @param byte byte of the child
+	 * @param child child to add
+	 */
+	void addChild(Node ** ref, ubyte byte, Node * child)
+	{
+		Node * node = *ref;
+		switch (node->type)
+		{
+			case Node4Type:
+			{
+				Node4 * n = static_cast<Node4*>(node);
+				if (n->numChildren < Node4::capacity)
+				{
+					insertSorted(n, byte, child);
+					return;
+				}
+
+				Node16 * grown = createNode<Node16>(n);
+				Memory::memcpy(grown->keys, n->keys, sizeof(n->keys));
+				Memory::memcpy(grown->children, n->children, sizeof(n->children));
+
+				*ref = grown;
+				destroyNode(n);
+				insertSorted(grown, byte, child);
+				return;
+			}
+			case Node16Type:
+			{
+				Node16 * n = static_cast<Node16*>(node);
+				if (n->numChildren < Node16::capacity)
+				{
+					insertSorted(n, byte, child);
+					return;
+				}
+
+				Node48 * grown = createNode<Node48>(n);
+				Memory::memcpy(grown->children, n->children, sizeof(n->children));
+				for (uint32 idx = 0; idx < n->numChildren; ++idx) grown->childIndex[n->keys[idx]] = idx + 1;
+
+				*ref = grown;
+				destroyNode(n);
+				addChild(ref, byte, child);
+				return;
+			}
+			case Node48Type:
+			{
+				Node48 * n = static_cast<Node48*>(node);
+				if (n->numChildren < Node48::capacity)
+				{
+					uint32 pos = 0;
+					while (n->children[pos]) ++pos;
+
+					n->children[pos] = child;
+					n->childIndex[byte] = pos + 1;
+					++n->numChildren;
+					return;
+				}
+
+				Node256 * grown = createNode<Node256>(n);
+				for (uint32 idx = 0; idx < 256; ++idx) if (n->childIndex[idx]) grown->children[idx] = n->children[n->childIndex[idx] - 1];
+
+				*ref = grown;
+				destroyNode(n);
+				addChild(ref, byte, child);
+				return;
+			}
+			case Node256Type:
+			{
+				Node256 * n = static_cast<Node256*>(node);
+				n->children[byte] = child;
+				++n->numChildren;
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Replaces a Node4 with a single child
+	 * and no leaf with its child, merging
+	 * the prefixes. A node with only a
+	 * leaf is replaced by the leaf.
+	 */
+	void collapse(Node ** ref)
+	{
+		Node4 * n = static_cast<Node4*>(*ref);
+		if (n->numChildren == 0)
+		{
+			*ref = n->leaf ? fromLeaf(n->leaf) : nullptr;
+			destroyNode(n);
+			return;
+		}
+
+		if (n->numChildren > 1 || n->leaf) return;
+
+		Node * child = n->children[0];
+		if (!isLeaf(child))
+		{
+			// Prefix of the child becomes
+			// this prefix + byte + its prefix
+			uint32 prefixLength = n->prefixLength;
+			if (prefixLength < maxPrefixLength) n->prefix[prefixLength++] = n->keys[0];
+			if (prefixLength < maxPrefixLength)
+			{
+				const uint32 numBytes = PlatformMath::min(child->prefixLength, maxPrefixLength - prefixLength);
+				Memory::memcpy(n->prefix + prefixLength, child->prefix, numBytes);
+				prefixLength += numBytes;
+			}
+
+			Memory::memcpy(child->prefix, n->prefix, PlatformMath::min(prefixLength, maxPrefixLength));
+			child->prefixLength += n->prefixLength + 1;
+		}
+
+		*ref = child;
+		destroyNode(n);
+	}
+
+	/**
+	 * Removes a child from the node in the
+	 * given slot, shrinking the node if
+	 * it becomes too sparse.
+	 *
+	 * @param ref slot of the node
+	 * @param byte byte of the child
+	 * @param slot slot of the child
+	 */
+	void removeChild(Node ** ref, ubyte byte, Node ** slot)
+	{
+		Node * node = *ref;
+		switch (node->type)
+		{
+			case Node4Type:
+			{
+				Node4 * n = static_cast<Node4*>(node);
+				const uint32 pos = static_cast<uint32>(slot - n->children);
+				Memory::memmov(n->keys + pos, n->keys + pos + 1, n->numChildren - pos - 1);
+				Memory::memmov(n->children + pos, n->children + pos + 1, (n->numChildren - pos - 1) * sizeof(Node*));
+				--n->numChildren;
+
+				collapse(ref);
+				return;
+			}
+			case Node16Type:
+			{
+				Node16 * n = static_cast<Node16*>(node);
+				const uint32 pos = static_cast<uint32>(slot - n->children);
+				Memory::memmov(n->keys + pos, n->keys + pos + 1, n->numChildren - pos - 1);
+				Memory::memmov(n->children + pos, n->children + pos + 1, (n->numChildren - pos - 1) * sizeof(Node*));
+				--n->numChildren;
+
+				if (n->numChildren == 3)
+				{
+					Node4 * shrunk = createNode<Node4>(n);
+					Memory::memcpy(shrunk->keys, n->keys, 3);
+					Memory::memcpy(shrunk->children, n->children, 3 * sizeof(Node*));
+
+					*ref = shrunk;
+					destroyNode(n);
+				}
+				return;
+			}
+			case Node48Type:
+			{
+				Node48 * n = static_cast<Node48*>(node);
+				n->children[n->childIndex[byte] - 1] = nullptr;
+				n->childIndex[byte] = 0;
+				--n->numChildren;
+
+				if (n->numChildren == 12)
+				{
+					Node16 * shrunk = createNode<Node16>(n);
+					uint32 pos = 0;
+					for (uint32 idx = 0; idx < 256; ++idx)
+					{
+						if (n->childIndex[idx])
+						{
+							shrunk->keys[pos] = static_cast<ubyte>(idx);
+							shrunk->children[pos++] = n->children[n->childIndex[idx] - 1];
+						}
+					}
+
+					*ref = shrunk;
+					destroyNode(n);
+				}
+				return;
+			}
+			case Node256Type:
+			{
+				Node256 * n = static_cast<Node256*>(node);
+				n->children[byte] = nullptr;
+				--n->numChildren;
+
+				if (n->numChildren == 37)
+				{
+					Node48 * shrunk = createNode<Node48>(n);
+					uint32 pos = 0;
+					for (uint32 idx = 0; idx < 256; ++idx)
+					{
+						if (n->children[idx])
+						{
+							shrunk->children[pos] = n->children[idx];
+							shrunk->childIndex[idx] = ++pos;
+						}
+					}
+
+					*ref = shrunk;
+					destroyNode(n);
+				}
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Returns the number of bytes of the
+	 * stored prefix that match the key.
+	 */
+	static FORCE_INLINE uint32 checkPrefix(const Node * node, const StringView & key, uint64 depth)
+	{
+		const uint64 maxCmp = PlatformMath::min(static_cast<uint64>(PlatformMath::min(node->prefixLength, maxPrefixLength)), key.getLength() - depth);
+
+		uint32 idx = 0;
+		while (idx < maxCmp && node->prefix[idx] == key.getByte(depth + idx)) ++idx;
+
+		return idx;
+	}
+
+	/**
+	 * Returns true if the stored prefix
+	 * of the node matches the key.
+	 * Prefixes longer than the stored
+	 * part are optimistically assumed to
+	 * match.
+	 */
+	static FORCE_INLINE bool matchPrefix(const Node * node, const StringView & key, uint64 depth)
+	{
+		return node->prefixLength == 0 || checkPrefix(node, key, depth) == PlatformMath::min(node->prefixLength, maxPrefixLength);
+	}
+
+	/**
+	 * Returns pointer to the full prefix
+	 * of a node, reading it from a leaf
+	 * if it is longer than the stored
+	 * part.
+	 */
+	static FORCE_INLINE const ubyte * getFullPrefix(const Node * node, uint64 depth)
+	{
+		return node->prefixLength > maxPrefixLength ? getKeyBytes(findMinimum(node)) + depth : node->prefix;
+	}
+
+	/**
+	 * Returns the index of the first byte
+	 * of the full prefix that does not
+	 * match the key.
+	 */
+	static uint32 findPrefixMismatch(const Node * node, const StringView & key, uint64 depth)
+	{
+		const ubyte * prefix = getFullPrefix(node, depth);
+		const uint64 maxCmp = PlatformMath::min(static_cast<uint64>(node->prefixLength), key.getLength() - depth);
+
+		uint32 idx = 0;
+		while (idx < maxCmp && prefix[idx] == key.getByte(depth + idx)) ++idx;
+
+		return idx;
+	}
+
+	/**
+	 * Places an entry in a node, either as
+	 * the node leaf if its key ends at
+	 * the given depth, or as a child.
+	 */
+	FORCE_INLINE void placeLeaf(Node ** ref, Entry * leaf, uint64 depth)
+	{
+		const StringView key = leaf->getKey();
+		if (key.getLength() == depth) (*ref)->leaf = leaf;
+		else addChild(ref, key.getByte(depth), fromLeaf(leaf));
+	}
+
+	/**
+	 * Recursive implementation of insert.
+	 *
+	 * @param ref slot of the subtree
+	 * @param key key to insert
+	 * @param depth depth of the subtree
+	 * @param value value to insert
+	 * @param outLeaf entry of the key
+	 * @return true if key was inserted,
+	 * 	false if updated
+	 */
+	template<typename ValueU>
+	bool insertImpl(Node ** ref, const StringView & key, uint64 depth, ValueU && value, Entry *& outLeaf)
+	{
+		Node * node = *ref;
+		if (!node)
+		{
+			outLeaf = createLeaf(key, forward<ValueU>(value));
+			*ref = fromLeaf(outLeaf);
+			return true;
+		}
+
+		if (isLeaf(node))
+		{
+			Entry * other = toLeaf(node);
+			const StringView otherKey = other->getKey();
+			if (otherKey == key)
+			{
+				other->value = forward<ValueU>(value);
+				outLeaf = other;
+				return false;
+			}
+
+			// Split the leaf with a node that
+			// holds their common prefix
+			const uint64 maxCmp = PlatformMath::min(otherKey.getLength(), key.getLength()) - depth;
+			uint32 common = 0;
+			while (common < maxCmp && otherKey.getByte(depth + common) == key.getByte(depth + common)) ++common;
+
+			Node4 * split = createNode<Node4>();
+			split->prefixLength = common;
+			Memory::memcpy(split->prefix, *key + depth, PlatformMath::min(common, maxPrefixLength));
+			*ref = split;
+
+			outLeaf = createLeaf(key, forward<ValueU>(value));
+			placeLeaf(ref, other, depth + common);
+			placeLeaf(ref, outLeaf, depth + common);
+			return true;
+		}
+
+		if (node->prefixLength)
+		{
+			const uint32 mismatch = findPrefixMismatch(node, key, depth);
+			if (mismatch < node->prefixLength)
+			{
+				// Split the prefix at the
+				// first mismatch
+				Node4 * split = createNode<Node4>();
+				split->prefixLength = mismatch;
+				Memory::memcpy(split->prefix, node->prefix, PlatformMath::min(mismatch, maxPrefixLength));
+				*ref = split;
+
+				ubyte byte;
+				if (node->prefixLength <= maxPrefixLength)
+				{
+					byte = node->prefix[mismatch];
+					node->prefixLength -= mismatch + 1;
+					Memory::memmov(node->prefix, node->prefix + mismatch + 1, node->prefixLength);
+				}
+				else
+				{
+					const ubyte * fullPrefix = getFullPrefix(node, depth);
+					byte = fullPrefix[mismatch];
+					node->prefixLength -= mismatch + 1;
+					Memory::memcpy(node->prefix, fullPrefix + mismatch + 1, PlatformMath::min(node->prefixLength, maxPrefixLength));
+				}
+
+				addChild(ref, byte, node);
+
+				outLeaf = createLeaf(key, forward<ValueU>(value));
+				placeLeaf(ref, outLeaf, depth + mismatch);
+				return true;
+			}
+
+			depth += node->prefixLength;
+		}
+
+		if (depth == key.getLength())
+		{
+			if (node->leaf)
+			{
+				node->leaf->value = forward<ValueU>(value);
+				outLeaf = node->leaf;
+				return false;
+			}
+
+			outLeaf = node->leaf = createLeaf(key, forward<ValueU>(value));
+			return true;
+		}
+
+		if (Node ** child = findChild(node, key.getByte(depth)))
+		{
+			return insertImpl(child, key, depth + 1, forward<ValueU>(value), outLeaf);
+		}
+
+		outLeaf = createLeaf(key, forward<ValueU>(value));
+		addChild(ref, key.getByte(depth), fromLeaf(outLeaf));
+		return true;
+	}
+
+	/**
+	 * Recursive implementation of remove.
+	 *
+	 * @param ref slot of the subtree
+	 * @param key key to remove
+	 * @param depth depth of the subtree
+	 * @return true if key was removed
+	 */
+	bool removeImpl(Node ** ref, const StringView & key, uint64 depth)
+	{
+		Node * node = *ref;
+		if (!node) return false;
+
+		if (isLeaf(node))
+		{
+			Entry * leaf = toLeaf(node);
+			if (leaf->getKey() != key) return false;
+
+			destroyLeaf(leaf);
+			*ref = nullptr;
+			return true;
+		}
+
+		if (!matchPrefix(node, key, depth)) return false;
+
+		depth += node->prefixLength;
+		if (depth > key.getLength()) return false;
+
+		if (depth == key.getLength())
+		{
+			if (!node->leaf || node->leaf->getKey() != key) return false;
+
+			destroyLeaf(node->leaf);
+			node->leaf = nullptr;
+			if (node->type == Node4Type) collapse(ref);
+			return true;
+		}
+
+		const ubyte byte = key.getByte(depth);
+		Node ** child = findChild(node, byte);
+		if (!child) return false;
+
+		if (isLeaf(*child))
+		{
+			Entry * leaf = toLeaf(*child);
+			if (leaf->getKey() != key) return false;
+
+			destroyLeaf(leaf);
+			removeChild(ref, byte, child);
+			return true;
+		}
+
+		return removeImpl(child, key, depth + 1);
+	}
+
+	/**
+	 * Returns the entry with the given
+	 * key, or nullptr.
+	 */
+	Entry * findLeaf(const StringView & key) const
+	{
+		const Node * node = root;
+		uint64 depth = 0;
+
+		while (node)
+		{
+			if (isLeaf(node))
+			{
+				Entry * leaf = toLeaf(node);
+				return leaf->getKey() == key ? leaf : nullptr;
+			}
+
+			if (!matchPrefix(node, key, depth)) return nullptr;
+
+			depth += node->prefixLength;
+			if (depth > key.getLength()) return nullptr;
+			if (depth == key.getLength()) return node->leaf && node->leaf->getKey() == key ? node->leaf : nullptr;
+
+			Node ** child = findChild(const_cast<Node*>(node), key.getByte(depth));
+			node = child ? *child : nullptr;
+			++depth;
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Returns the first entry after the
+	 * key in a subtree, according to the
+	 * seek mode.
+	 */
+	static Entry * seek(const Node * node, const StringView & key, uint64 depth, SeekMode mode)
+	{
+		if (!node) return nullptr;
+
+		if (isLeaf(node))
+		{
+			Entry * leaf = toLeaf(node);
+			const StringView leafKey = leaf->getKey();
+			const int32 cmp = leafKey.compare(key);
+
+			switch (mode)
+			{
+				case SeekMode::Inclusive: return cmp >= 0 ? leaf : nullptr;
+				case SeekMode::Exclusive: return cmp > 0 ? leaf : nullptr;
+				case SeekMode::PastPrefix: return cmp > 0 && !leafKey.startsWith(key) ? leaf : nullptr;
+			}
+
+			return nullptr;
+		}
+
+		if (node->prefixLength)
+		{
+			const ubyte * prefix = getFullPrefix(node, depth);
+			for (uint32 idx = 0; idx < node->prefixLength; ++idx)
+			{
+				// Every key in the subtree
+				// starts with the key
+				if (depth + idx == key.getLength()) return mode == SeekMode::PastPrefix ? nullptr : findMinimum(node);
+
+				const ubyte byte = key.getByte(depth + idx);
+				if (prefix[idx] > byte) return findMinimum(node);
+				if (prefix[idx] < byte) return nullptr;
+			}
+
+			depth += node->prefixLength;
+		}
+
+		if (depth == key.getLength())
+		{
+			if (mode == SeekMode::PastPrefix) return nullptr;
+			if (mode == SeekMode::Inclusive && node->leaf) return node->leaf;
+
+			return findMinimum(findChildAfter(node, -1));
+		}
+
+		const ubyte byte = key.getByte(depth);
+		if (Node ** child = findChild(const_cast<Node*>(node), byte))
+		{
+			if (Entry * found = seek(*child, key, depth + 1, mode)) return found;
+		}
+
+		return findMinimum(findChildAfter(node, byte));
+	}
+
+	/**
+	 * Returns the entry with the smallest
+	 * key greater than the given one.
+	 */
+	FORCE_INLINE Entry * findNext(const StringView & key) const
+	{
+		return seek(root, key, 0, SeekMode::Exclusive);
+	}
+
+	/**
+	 * Calls a function on each entry of a
+	 * subtree, in key order.
+	 */
+	template<typename FnT>
+	static void forEachImpl(const Node * node, FnT & fn)
+	{
+		if (isLeaf(node))
+		{
+			Entry * leaf = toLeaf(node);
+			fn(leaf->getKey(), leaf->value);
+			return;
+		}
+
+		if (node->leaf) fn(node->leaf->getKey(), node->leaf->value);
+		forEachChild(node, [&fn](const Node * child) {
+
+			forEachImpl(child, fn);
+		});
+	}
+
+public:
+	/**
+	 * Creates an empty tree.
+	 *
+	 * @param [inMalloc] allocator used
+	 * 	for nodes and entries
+	 */
+	FORCE_INLINE explicit RadixTree(MallocBase * inMalloc = gMalloc)
+		: malloc{inMalloc}
+		, root{nullptr}
+		, count{0}
+	{
+		CHECKF(!!inMalloc, "Provided allocator cannot be NULL")
+	}
+
+	/**
+	 * Trees are not copyable.
+	 * @{
+	 */
+	RadixTree(const RadixTree&) = delete;
+	RadixTree & operator=(const RadixTree&) = delete;
+	/// @}
+
+	/**
+	 * Move constructor.
+	 */
+	FORCE_INLINE RadixTree(RadixTree && other)
+		: malloc{other.malloc}
+		, root{other.root}
+		, count{other.count}
+	{
+		other.root = nullptr;
+		other.count = 0;
+	}
+
+	/**
+	 * Destructor, destroys all entries.
+	 */
+	FORCE_INLINE ~RadixTree()
+	{
+		empty();
+	}
+
+	/**
+	 * Returns the number of entries.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns true if tree is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns an iterator to the entry
+	 * with the smallest key.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{this, findMinimum(root)};
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return Iterator{this, findMinimum(root)};
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator past the last
+	 * entry.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{this};
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return Iterator{this};
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator to the first
+	 * entry whose key starts with the
+	 * given prefix. If there is none, it
+	 * is equal to end(prefix).
+	 *
+	 * @param prefix prefix of the keys
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin(const StringView & prefix) const
+	{
+		return ConstIterator{this, seek(root, prefix, 0, SeekMode::Inclusive)};
+	}
+
+	FORCE_INLINE Iterator begin(const StringView & prefix)
+	{
+		return Iterator{this, seek(root, prefix, 0, SeekMode::Inclusive)};
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator to the first
+	 * entry after all the keys that
+	 * start with the given prefix.
+	 *
+	 * @param prefix prefix of the keys
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end(const StringView & prefix) const
+	{
+		return ConstIterator{this, seek(root, prefix, 0, SeekMode::PastPrefix)};
+	}
+
+	FORCE_INLINE Iterator end(const StringView & prefix)
+	{
+		return Iterator{this, seek(root, prefix, 0, SeekMode::PastPrefix)};
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator to the entry
+	 * with the given key, or end.
+	 *
+	 * @param key key to find
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator find(const StringView & key) const
+	{
+		return ConstIterator{this, findLeaf(key)};
+	}
+
+	FORCE_INLINE Iterator find(const StringView & key)
+	{
+		return Iterator{this, findLeaf(key)};
+	}
+	/// @}
+
+	/**
+	 * Finds the value associated with
+	 * the key and copies it.
+	 *
+	 * @param key key to find
+	 * @param outVal copy of the value
+	 * @return true if found
+	 */
+	FORCE_INLINE bool find(const StringView & key, V & outVal) const
+	{
+		if (const Entry * leaf = findLeaf(key))
+		{
+			outVal = leaf->value;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Returns true if the tree contains
+	 * the key.
+	 */
+	FORCE_INLINE bool has(const StringView & key) const
+	{
+		return findLeaf(key) != nullptr;
+	}
+
+	/**
+	 * Returns an iterator to the entry
+	 * with the longest key that is a
+	 * prefix of the given key, or end.
+	 *
+	 * @param key key to match
+	 * @{
+	 */
+	ConstIterator findLongestPrefix(const StringView & key) const
+	{
+		Entry * best = nullptr;
+		const Node * node = root;
+		uint64 depth = 0;
+
+		while (node)
+		{
+			if (isLeaf(node))
+			{
+				Entry * leaf = toLeaf(node);
+				if (key.startsWith(leaf->getKey())) best = leaf;
+				break;
+			}
+
+			if (!matchPrefix(node, key, depth)) break;
+
+			depth += node->prefixLength;
+			if (depth > key.getLength()) break;
+
+			// Longer prefixes are optimistic,
+			// compare the whole key
+			if (node->leaf && key.startsWith(node->leaf->getKey())) best = node->leaf;
+			if (depth == key.getLength()) break;
+
+			Node ** child = findChild(const_cast<Node*>(node), key.getByte(depth));
+			node = child ? *child : nullptr;
+			++depth;
+		}
+
+		return ConstIterator{this, best};
+	}
+
+	FORCE_INLINE Iterator findLongestPrefix(const StringView & key)
+	{
+		return Iterator{this, const_cast<Entry*>(static_cast<const RadixTree*>(this)->findLongestPrefix(key).entry)};
+	}
+	/// @}
+
+	/**
+	 * Inserts a new entry, or updates the
+	 * value of an existing one.
+	 *
+	 * @param key key of the entry
+	 * @param value value to insert
+	 * @return ref to inserted value
+	 */
+	template<typename ValueU>
+	V & insert(const StringView & key, ValueU && value)
+	{
+		Entry * leaf = nullptr;
+		count += insertImpl(&root, key, 0, forward<ValueU>(value), leaf);
+
+		return leaf->value;
+	}
+
+	/**
+	 * Removes the entry with the given
+	 * key.
+	 *
+	 * @param key key of the entry
+	 * @return true if entry was found
+	 */
+	bool remove(const StringView & key)
+	{
+		if (removeImpl(&root, key, 0))
+		{
+			--count;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Calls a function with key and value
+	 * of each entry, in key order. This
+	 * is faster than iterators, which
+	 * seek each key from the root.
+	 *
+	 * @param fn function called with the
+	 * 	key and the value
+	 */
+	template<typename FnT>
+	void forEach(FnT && fn) const
+	{
+		if (root) forEachImpl(root, fn);
+	}
+
+	/**
+	 * Calls a function with key and value
+	 * of each entry whose key starts with
+	 * the given prefix, in key order.
+	 *
+	 * @param prefix prefix of the keys
+	 * @param fn function called with the
+	 * 	key and the value
+	 */
+	template<typename FnT>
+	void forEachPrefix(const StringView & prefix, FnT && fn) const
+	{
+		const Node * node = root;
+		uint64 depth = 0;
+
+		while (node)
+		{
+			if (isLeaf(node))
+			{
+				Entry * leaf = toLeaf(node);
+				if (leaf->getKey().startsWith(prefix)) fn(leaf->getKey(), leaf->value);
+				return;
+			}
+
+			if (node->prefixLength)
+			{
+				// Compare the part of the node
+				// prefix covered by the prefix
+				const ubyte * nodePrefix = getFullPrefix(node, depth);
+				const uint64 maxCmp = PlatformMath::min(static_cast<uint64>(node->prefixLength), prefix.getLength() - depth);
+				for (uint64 idx = 0; idx < maxCmp; ++idx) if (nodePrefix[idx] != prefix.getByte(depth + idx)) return;
+
+				depth += node->prefixLength;
+			}
+
+			if (depth >= prefix.getLength())
+			{
+				forEachImpl(node, fn);
+				return;
+			}
+
+			Node ** child = findChild(const_cast<Node*>(node), prefix.getByte(depth));
+			node = child ? *child : nullptr;
+			++depth;
+		}
+	}
+
+	/**
+	 * Removes all entries.
+	 * @{
+	 */
+	void empty()
+	{
+		destroySubtree(root);
+		root = nullptr;
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/// Allocator of nodes and entries,
+	/// which have different sizes
+	MallocBase * malloc;
+
+	/// Root of the tree
+	Node * root;
+
+	/// Number of entries
+	uint64 count;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param V type of the values
+ * @param MallocT allocator type
+ */
+template<typename V, typename MallocT>
+class RadixTree : public RadixTree<V, void>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = RadixTree<V, void>;
+
+public:
+	/**
+	 * Constructs allocator and creates an
+	 * empty tree that uses it.
+	 *
+	 * @param createArgs allocator creation
+	 * 	arguments
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE explicit RadixTree(MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		//
+	}
+
+	/**
+	 * Destructor, destroy entries here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~RadixTree()
+	{
+		Base::empty();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/utility.h"
+#include "templates/spin_lock.h"
+#include "hal/platform_math.h"
+#include "./containers_types.h"
+
+/**
+ * A cache that can be shared between
+ * threads. Keys are spread over a fixed
+ * number of independent caches, each
+ * protected by its own spin lock, so
+ * that threads that access different
+ * shards do not contend.
+ *
+ * Values are copied out while the lock
+ * is held, since a pointer into a shard
+ * could be invalidated by another
+ * thread. The eviction callback runs
+ * with the shard lock held.
+ *
+ * @param CacheT type of the underlying
+ * 	cache, e.g. LRUCache or ClockCache
+ * @param numShards number of shards, a
+ * 	power of two
+ */
+template<typename CacheT, uint32 numShards>
+class ShardedCache
+{
+	static_assert(numShards > 0 && (numShards & (numShards - 1)) == 0, "Number of shards must be a power of two");
+
+public:
+	using KeyT = typename CacheT::KeyT;
+	using ValueT = typename CacheT::ValueT;
+	using HashFnT = typename CacheT::HashFnT;
+
+protected:
+	/**
+	 * A shard of the cache. Shards are
+	 * aligned to the cache line, so that
+	 * locks do not share lines.
+	 */
+	struct alignas(64) Shard
+	{
+		/// Lock of the shard
+		mutable SpinLock lock;
+
+		/// Underlying cache
+		CacheT cache;
+
+		/**
+		 * Creates a new shard.
+		 */
+		FORCE_INLINE Shard(uint32 capacity, MallocBase * inMalloc)
+			: lock{}
+			, cache{capacity, inMalloc}
+		{
+			//
+		}
+	};
+
+	/**
+	 * Returns the shard of the given key.
+	 * The underlying caches index keys
+	 * with the high bits of the hash, so
+	 * we pick the shard with the low
+	 * bits.
+	 */
+	template<typename KeyU>
+	FORCE_INLINE Shard & getShard(const KeyU & key)
+	{
+		return getShards()[hash(key) & (numShards - 1)];
+	}
+
+	/**
+	 * Returns ptr to the first shard.
+	 * @{
+	 */
+	FORCE_INLINE Shard * getShards()
+	{
+		return reinterpret_cast<Shard*>(storage);
+	}
+
+	FORCE_INLINE const Shard * getShards() const
+	{
+		return reinterpret_cast<const Shard*>(storage);
+	}
+	/// @}
+
+public:
+	/**
+	 * Creates an empty cache. The
+	 * capacity is split evenly between
+	 * the shards.
+	 *
+	 * @param capacity total max number of
+	 * 	entries
+	 * @param [inMalloc] allocator used
+	 * 	by the shards
+	 */
+	explicit ShardedCache(uint32 capacity, MallocBase * inMalloc = gMalloc)
+		: hash{}
+	{
+		const uint32 shardCapacity = PlatformMath::max((capacity + numShards - 1) / numShards, 1u);
+		for (uint32 idx = 0; idx < numShards; ++idx) new (getShards() + idx) Shard{shardCapacity, inMalloc};
+	}
+
+	/**
+	 * Caches are not copyable.
+	 * @{
+	 */
+	ShardedCache(const ShardedCache&) = delete;
+	ShardedCache & operator=(const ShardedCache&) = delete;
+	/// @}
+
+	/**
+	 * Destructor, destroys the shards.
+	 */
+	~ShardedCache()
+	{
+		for (uint32 idx = 0; idx < numShards; ++idx) getShards()[idx].~Shard();
+	}
+
+	/**
+	 * Returns the number of entries. It
+	 * is only a snapshot if other threads
+	 * are using the cache.
+	 */
+	uint64 getCount() const
+	{
+		uint64 count = 0;
+		for (uint32 idx = 0; idx < numShards; ++idx)
+		{
+			const Shard & shard = getShards()[idx];
+			ScopeLock<SpinLock> scopeLock{shard.lock};
+			count += shard.cache.getCount();
+		}
+
+		return count;
+	}
+
+	/**
+	 * Returns the max number of entries.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return getShards()[0].cache.getCapacity() * numShards;
+	}
+
+	/**
+	 * Returns the number of shards.
+	 */
+	static constexpr FORCE_INLINE uint32 getNumShards()
+	{
+		return numShards;
+	}
+
+	/**
+	 * Sets the eviction callback of all
+	 * the shards. The callback must be
+	 * safe to call from any thread.
+	 *
+	 * @param fn callable object, copied
+	 * 	in each shard
+	 */
+	template<typename FnT>
+	void setEvictionCallback(const FnT & fn)
+	{
+		for (uint32 idx = 0; idx < numShards; ++idx)
+		{
+			Shard & shard = getShards()[idx];
+			ScopeLock<SpinLock> scopeLock{shard.lock};
+			shard.cache.setEvictionCallback(fn);
+		}
+	}
+
+	/**
+	 * Copies the value associated with
+	 * the key, and marks it as used.
+	 *
+	 * @param key key of the entry
+	 * @param outValue copy of the value
+	 * @return true if found
+	 */
+	template<typename KeyU>
+	FORCE_INLINE bool get(const KeyU & key, ValueT & outValue)
+	{
+		Shard & shard = getShard(key);
+		ScopeLock<SpinLock> scopeLock{shard.lock};
+
+		if (ValueT * value = shard.cache.get(key))
+		{
+			outValue = *value;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Returns true if the cache contains
+	 * the key.
+	 *
+	 * @param key key to find
+	 * @return true if found
+	 */
+	template<typename KeyU>
+	FORCE_INLINE bool has(const KeyU & key)
+	{
+		Shard & shard = getShard(key);
+		ScopeLock<SpinLock> scopeLock{shard.lock};
+
+		return shard.cache.has(key);
+	}
+
+	/**
+	 * Inserts or updates an entry.
+	 *
+	 * @param key key of the entry
+	 * @param value value to cache
+	 * @{
+	 */
+	template<typename KeyU, typename ValueU>
+	FORCE_INLINE void insert(KeyU && key, ValueU && value)
+	{
+		Shard & shard = getShard(key);
+		ScopeLock<SpinLock> scopeLock{shard.lock};
+
+		shard.cache.insert(forward<KeyU>(key), forward<ValueU>(value));
+	}
+
+	METHOD_ALIAS(put, insert)
+	/// @}
+
+	/**
+	 * Removes the entry with the given
+	 * key.
+	 *
+	 * @param key key of the entry
+	 * @return true if entry was found
+	 */
+	template<typename KeyU>
+	FORCE_INLINE bool remove(const KeyU & key)
+	{
+		Shard & shard = getShard(key);
+		ScopeLock<SpinLock> scopeLock{shard.lock};
+
+		return shard.cache.remove(key);
+	}
+
+	/**
+	 * Removes all entries.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint32 idx = 0; idx < numShards; ++idx)
+		{
+			Shard & shard = getShards()[idx];
+			ScopeLock<SpinLock> scopeLock{shard.lock};
+			shard.cache.empty();
+		}
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/// Storage of the shards
+	alignas(Shard) ubyte storage[sizeof(Shard) * numShards];
+
+	/// Hash function, must match the one
+	/// of the shards
+	HashFnT hash;
+};
@@ -0,0 +1,433 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/utility.h"
+#include "./containers_types.h"
+#include "./array.h"
+
+/**
+ * A 64-bit handle to an item of a slot
+ * map. The low 32 bits are the index
+ * of the slot, the high 32 bits the
+ * generation of the slot when the item
+ * was inserted. Generations start from
+ * one, so a zero handle is never valid.
+ */
+struct SlotHandle
+{
+	/// Packed index and generation
+	uint64 value;
+
+	/**
+	 * Creates an invalid handle.
+	 */
+	constexpr FORCE_INLINE SlotHandle()
+		: value{0}
+	{
+		//
+	}
+
+	/**
+	 * Creates a handle from a slot index
+	 * and generation.
+	 *
+	 * @param idx slot index
+	 * @param generation slot generation
+	 */
+	constexpr FORCE_INLINE SlotHandle(uint32 idx, uint32 generation)
+		: value{(static_cast<uint64>(generation) << 32) | idx}
+	{
+		//
+	}
+
+	/**
+	 * Creates a handle from its packed
+	 * value.
+	 */
+	static constexpr FORCE_INLINE SlotHandle fromValue(uint64 inValue)
+	{
+		return SlotHandle{static_cast<uint32>(inValue), static_cast<uint32>(inValue >> 32)};
+	}
+
+	/**
+	 * Returns the slot index.
+	 */
+	constexpr FORCE_INLINE uint32 getIndex() const
+	{
+		return static_cast<uint32>(value);
+	}
+
+	/**
+	 * Returns the slot generation.
+	 */
+	constexpr FORCE_INLINE uint32 getGeneration() const
+	{
+		return static_cast<uint32>(value >> 32);
+	}
+
+	/**
+	 * Returns false if handle is the
+	 * null handle.
+	 */
+	constexpr FORCE_INLINE bool isValid() const
+	{
+		return value != 0;
+	}
+
+	/**
+	 * Compares two handles.
+	 * @{
+	 */
+	constexpr FORCE_INLINE bool operator==(const SlotHandle & other) const
+	{
+		return value == other.value;
+	}
+
+	constexpr FORCE_INLINE bool operator!=(const SlotHandle & other) const
+	{
+		return value != other.value;
+	}
+	/// @}
+};
+
+/**
+ * A slot map stores items densely in a
+ * dynamic array and hands out stable
+ * generational handles to them.
+ * Insert, lookup and remove all run in
+ * O(1) time, and iteration visits a
+ * contiguous array of items.
+ *
+ * Each handle points to a slot, which
+ * stores the position of the item in
+ * the dense array. When an item is
+ * removed, the last item is moved in
+ * its place, and the slot generation
+ * is incremented, so that any handle
+ * to the removed item becomes stale.
+ * Free slots are kept in a list
+ * embedded in the slots themselves.
+ *
+ * @param T type of the items
+ * @param MallocT allocator type
+ */
+template<typename T, typename MallocT>
+class SlotMap
+{
+	/**
+	 * A slot of the map. When in use it
+	 * stores the position of the item,
+	 * when free the index of the next
+	 * free slot.
+	 */
+	struct Slot
+	{
+		/// Item position or next free slot
+		uint32 idx;
+
+		/// Incremented on every remove
+		uint32 generation;
+	};
+
+	using ItemArrayT = Array<T, MallocT>;
+	using SlotArrayT = Array<Slot, MallocT>;
+	using IndexArrayT = Array<uint32, MallocT>;
+
+	/// Marks the end of the free list
+	static constexpr uint32 invalidIdx = ~0u;
+
+public:
+	using ConstIterator = typename ItemArrayT::ConstIterator;
+	using Iterator = typename ItemArrayT::Iterator;
+
+	/**
+	 * Creates an empty map.
+	 */
+	FORCE_INLINE SlotMap()
+		: items{}
+		, slots{}
+		, itemSlots{}
+		, freeHead{invalidIdx}
+	{
+		//
+	}
+
+	/**
+	 * Creates an empty map that uses
+	 * the given allocator.
+	 *
+	 * @param inMalloc allocator used by
+	 * 	the underlying arrays
+	 */
+	FORCE_INLINE explicit SlotMap(MallocBase * inMalloc)
+		: items{inMalloc}
+		, slots{inMalloc}
+		, itemSlots{inMalloc}
+		, freeHead{invalidIdx}
+	{
+		//
+	}
+
+	/**
+	 * Returns number of items in the map.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return items.getCount();
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getNumItems, getCount)
+	/// @}
+
+	/**
+	 * Returns true if map is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return items.getCount() == 0;
+	}
+
+	/**
+	 * Returns a ref to the dense array of
+	 * items. Items are not in insertion
+	 * order.
+	 */
+	FORCE_INLINE const ItemArrayT & getItems() const
+	{
+		return items;
+	}
+
+	/**
+	 * Returns iterators to the dense
+	 * array of items.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return items.begin();
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return items.begin();
+	}
+
+	FORCE_INLINE ConstIterator end() const
+	{
+		return items.end();
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return items.end();
+	}
+	/// @}
+
+	/**
+	 * Returns the handle of the idx-th
+	 * item of the dense array.
+	 *
+	 * @param idx position of the item
+	 * @return handle to the item
+	 */
+	FORCE_INLINE SlotHandle getHandle(uint64 idx) const
+	{
+		CHECK(idx < items.getCount())
+
+		const uint32 slotIdx = itemSlots[idx];
+		return SlotHandle{slotIdx, slots[slotIdx].generation};
+	}
+
+	/**
+	 * Returns true if the handle points
+	 * to an item of the map.
+	 */
+	FORCE_INLINE bool contains(SlotHandle handle) const
+	{
+		const uint32 slotIdx = handle.getIndex();
+		return slotIdx < slots.getCount() && slots[slotIdx].generation == handle.getGeneration();
+	}
+
+	/**
+	 * Returns a pointer to the item, or
+	 * nullptr if the handle is stale.
+	 *
+	 * @param handle handle to the item
+	 * @return pointer to item or nullptr
+	 * @{
+	 */
+	FORCE_INLINE const T * get(SlotHandle handle) const
+	{
+		return contains(handle) ? &items[slots[handle.getIndex()].idx] : nullptr;
+	}
+
+	FORCE_INLINE T * get(SlotHandle handle)
+	{
+		return contains(handle) ? &items[slots[handle.getIndex()].idx] : nullptr;
+	}
+	/// @}
+
+	/**
+	 * Returns a ref to the item, the
+	 * handle must be valid.
+	 *
+	 * @param handle handle to the item
+	 * @return ref to the item
+	 * @{
+	 */
+	FORCE_INLINE const T & operator[](SlotHandle handle) const
+	{
+		CHECKF(contains(handle), "Stale slot map handle")
+		return items[slots[handle.getIndex()].idx];
+	}
+
+	FORCE_INLINE T & operator[](SlotHandle handle)
+	{
+		CHECKF(contains(handle), "Stale slot map handle")
+		return items[slots[handle.getIndex()].idx];
+	}
+	/// @}
+
+	/**
+	 * Inserts a new item and returns a
+	 * handle to it.
+	 *
+	 * @param item item to insert
+	 * @return handle to the item
+	 */
+	template<typename ItemT>
+	SlotHandle insert(ItemT && item)
+	{
+		const uint32 itemIdx = static_cast<uint32>(items.getCount());
+		uint32 slotIdx;
+
+		if (freeHead != invalidIdx)
+		{
+			// Pop slot from free list
+			slotIdx = freeHead;
+			freeHead = slots[slotIdx].idx;
+			slots[slotIdx].idx = itemIdx;
+		}
+		else
+		{
+			slotIdx = static_cast<uint32>(slots.getCount());
+			slots.add(Slot{itemIdx, 1});
+		}
+
+		items.add(forward<ItemT>(item));
+		itemSlots.add(slotIdx);
+
+		return SlotHandle{slotIdx, slots[slotIdx].generation};
+	}
+
+	METHOD_ALIAS(add, insert)
+
+	/**
+	 * Removes the item pointed by the
+	 * handle, if any.
+	 *
+	 * @param handle handle to the item
+	 * @param outItem removed item
+	 * @return true if item was removed
+	 * @{
+	 */
+	bool remove(SlotHandle handle)
+	{
+		if (!contains(handle)) return false;
+
+		removeSlot(handle.getIndex());
+		return true;
+	}
+
+	bool remove(SlotHandle handle, T & outItem)
+	{
+		if (!contains(handle)) return false;
+
+		outItem = move(items[slots[handle.getIndex()].idx]);
+		removeSlot(handle.getIndex());
+		return true;
+	}
+	/// @}
+
+	/**
+	 * Removes all items. All handles
+	 * become stale, but slots are kept.
+	 * @{
+	 */
+	void empty()
+	{
+		for (uint64 i = 0; i < itemSlots.getCount(); ++i)
+		{
+			freeSlot(itemSlots[i]);
+		}
+
+		items.empty();
+		itemSlots.empty();
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/**
+	 * Increments the generation of the
+	 * slot and pushes it on the free
+	 * list.
+	 *
+	 * @param slotIdx index of the slot
+	 */
+	FORCE_INLINE void freeSlot(uint32 slotIdx)
+	{
+		Slot & slot = slots[slotIdx];
+
+		// Skip zero, so that the null
+		// handle is never valid
+		if (++slot.generation == 0) slot.generation = 1;
+
+		slot.idx = freeHead;
+		freeHead = slotIdx;
+	}
+
+	/**
+	 * Removes the item of a slot in use,
+	 * moving the last item in its place.
+	 *
+	 * @param slotIdx index of the slot
+	 */
+	void removeSlot(uint32 slotIdx)
+	{
+		const uint32 itemIdx = slots[slotIdx].idx;
+		const uint32 lastIdx = static_cast<uint32>(items.getCount() - 1);
+
+		if (itemIdx != lastIdx)
+		{
+			// Move last item in the hole
+			// and update its slot
+			const uint32 lastSlotIdx = itemSlots[lastIdx];
+
+			items[itemIdx] = move(items[lastIdx]);
+			itemSlots[itemIdx] = lastSlotIdx;
+			slots[lastSlotIdx].idx = itemIdx;
+		}
+
+		items.removeLast();
+		itemSlots.removeLast();
+		freeSlot(slotIdx);
+	}
+
+	/// Dense array of items
+	ItemArrayT items;
+
+	/// Slots, indexed by handle
+	SlotArrayT slots;
+
+	/// Slot of each item
+	IndexArrayT itemSlots;
+
+	/// Index of first free slot
+	uint32 freeHead;
+};
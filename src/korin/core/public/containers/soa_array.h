@@ -0,0 +1,1073 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/iterator.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "hal/platform_memory.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+#include "./tuple.h"
+
+/**
+ * A view on a column of a SoA array.
+ * Items are contiguous and the first
+ * item is aligned to the column
+ * alignment of the array.
+ *
+ * @param T type of the column items
+ */
+template<typename T>
+class SoAColumn
+{
+public:
+	/**
+	 * Creates a view on count items.
+	 *
+	 * @param inData pointer to first item
+	 * @param inCount number of items
+	 */
+	FORCE_INLINE SoAColumn(T * inData, uint64 inCount)
+		: data{inData}
+		, count{inCount}
+	{
+		//
+	}
+
+	/**
+	 * Returns pointer to first item.
+	 */
+	FORCE_INLINE T * getData() const
+	{
+		return data;
+	}
+
+	/**
+	 * Returns number of items.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	/// @}
+
+	/**
+	 * Returns true if column has no
+	 * items.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns ref to idx-th item.
+	 */
+	FORCE_INLINE T & operator[](uint64 idx) const
+	{
+		return data[idx];
+	}
+
+	/**
+	 * Returns begin and end pointers.
+	 * @{
+	 */
+	FORCE_INLINE T * begin() const
+	{
+		return data;
+	}
+
+	FORCE_INLINE T * end() const
+	{
+		return data + count;
+	}
+	/// @}
+
+protected:
+	/// Pointer to first item
+	T * data;
+
+	/// Number of items
+	uint64 count;
+};
+
+/**
+ * A reference to a row of a SoA array.
+ * Assigning to a row reference assigns
+ * each field of the referenced row,
+ * rather than rebinding the reference.
+ *
+ * @param SoAArrayT type of the array,
+ * 	possibly const
+ */
+template<typename SoAArrayT>
+class SoARowRef
+{
+	template<typename> friend class SoARowRef;
+
+	using ValueT = typename RemoveConst<SoAArrayT>::Type::ValueT;
+	using IndicesT = typename RemoveConst<SoAArrayT>::Type::IndicesT;
+
+public:
+	/**
+	 * Creates a reference to the idx-th
+	 * row of the array.
+	 */
+	FORCE_INLINE SoARowRef(SoAArrayT & inArray, uint64 inIdx)
+		: array{&inArray}
+		, idx{inIdx}
+	{
+		//
+	}
+
+	/**
+	 * Copy constructor, creates a new
+	 * reference to the same row.
+	 */
+	SoARowRef(const SoARowRef&) = default;
+
+	/**
+	 * Returns the index of the row.
+	 */
+	FORCE_INLINE uint64 getIndex() const
+	{
+		return idx;
+	}
+
+	/**
+	 * Returns ref to the field at
+	 * position fieldIdx.
+	 */
+	template<uint64 fieldIdx>
+	FORCE_INLINE auto & get() const
+	{
+		return array->template getColumnData<fieldIdx>()[idx];
+	}
+
+	/**
+	 * Copies or moves the fields of
+	 * another row.
+	 * @{
+	 */
+	FORCE_INLINE SoARowRef & operator=(const SoARowRef & other)
+	{
+		copyFields(other, IndicesT{});
+		return *this;
+	}
+
+	FORCE_INLINE SoARowRef & operator=(SoARowRef && other)
+	{
+		moveFields(other, IndicesT{});
+		return *this;
+	}
+
+	template<typename OtherArrayT>
+	FORCE_INLINE SoARowRef & operator=(const SoARowRef<OtherArrayT> & other)
+	{
+		copyFields(other, IndicesT{});
+		return *this;
+	}
+
+	FORCE_INLINE SoARowRef & operator=(const ValueT & value)
+	{
+		copyFields(value, IndicesT{});
+		return *this;
+	}
+
+	FORCE_INLINE SoARowRef & operator=(ValueT && value)
+	{
+		moveFields(value, IndicesT{});
+		return *this;
+	}
+	/// @}
+
+	/**
+	 * Swaps the fields of two rows. Row
+	 * references are temporaries, so the
+	 * generic swap does not apply.
+	 */
+	friend FORCE_INLINE void swap(SoARowRef a, SoARowRef b)
+	{
+		a.swapFields(b, IndicesT{});
+	}
+
+protected:
+	/**
+	 * Copies or moves all fields from
+	 * another row or row value.
+	 * @{
+	 */
+	template<typename RowT, uint64 ...idxs>
+	FORCE_INLINE void copyFields(const RowT & other, IndexSequence<idxs...>)
+	{
+		((get<idxs>() = other.template get<idxs>()), ...);
+	}
+
+	template<typename RowT, uint64 ...idxs>
+	FORCE_INLINE void moveFields(RowT & other, IndexSequence<idxs...>)
+	{
+		((get<idxs>() = move(other.template get<idxs>())), ...);
+	}
+	/// @}
+
+	/**
+	 * Swaps all fields with another row.
+	 */
+	template<uint64 ...idxs>
+	FORCE_INLINE void swapFields(SoARowRef & other, IndexSequence<idxs...>)
+	{
+		(::swap(get<idxs>(), other.template get<idxs>()), ...);
+	}
+
+	/// Referenced array
+	SoAArrayT * array;
+
+	/// Index of the row
+	uint64 idx;
+};
+
+/**
+ * The value of a row of a SoA array,
+ * i.e. a tuple with one item per
+ * field. Used to move rows out of the
+ * array, for instance by sorting
+ * algorithms.
+ *
+ * @param FieldListT types of the fields
+ */
+template<typename ...FieldListT>
+class SoARow : public Tuple<FieldListT...>
+{
+	using BaseT = Tuple<FieldListT...>;
+	using IndicesT = typename MakeIndexSequence<sizeof...(FieldListT)>::Type;
+
+public:
+	/**
+	 * Default constructor, default
+	 * constructs all fields.
+	 */
+	SoARow() = default;
+
+	/**
+	 * Initializes the fields from the
+	 * given values.
+	 * @{
+	 */
+	FORCE_INLINE SoARow(const FieldListT & ...fields)
+		: BaseT{fields...}
+	{
+		//
+	}
+
+	FORCE_INLINE SoARow(FieldListT && ...fields)
+		: BaseT{move(fields)...}
+	{
+		//
+	}
+	/// @}
+
+	/**
+	 * Copies or moves the fields of a row
+	 * of an array.
+	 * @{
+	 */
+	template<typename SoAArrayT>
+	FORCE_INLINE SoARow(const SoARowRef<SoAArrayT> & row)
+		: SoARow{row, IndicesT{}}
+	{
+		//
+	}
+
+	template<typename SoAArrayT>
+	FORCE_INLINE SoARow(SoARowRef<SoAArrayT> && row)
+		: SoARow{move(row), IndicesT{}}
+	{
+		//
+	}
+	/// @}
+
+protected:
+	/**
+	 * Expands the fields of a row.
+	 * @{
+	 */
+	template<typename SoAArrayT, uint64 ...idxs>
+	FORCE_INLINE SoARow(const SoARowRef<SoAArrayT> & row, IndexSequence<idxs...>)
+		: BaseT{static_cast<const FieldListT&>(row.template get<idxs>())...}
+	{
+		//
+	}
+
+	template<typename SoAArrayT, uint64 ...idxs>
+	FORCE_INLINE SoARow(SoARowRef<SoAArrayT> && row, IndexSequence<idxs...>)
+		: BaseT{move(row.template get<idxs>())...}
+	{
+		//
+	}
+	/// @}
+};
+
+/**
+ * Iterator used to iterate over the
+ * rows of a SoA array. Dereferencing
+ * the iterator returns a row reference,
+ * so it defines ValueT for algorithms
+ * that need to move rows around.
+ * @see IteratorValue
+ *
+ * @param SoAArrayT type of the array,
+ * 	possibly const
+ */
+template<typename SoAArrayT>
+struct SoAArrayIteratorBase : public RandomAccessIterator<typename RemoveConst<SoAArrayT>::Type::ValueT>
+{
+	using ValueT = typename RemoveConst<SoAArrayT>::Type::ValueT;
+	using RefT = SoARowRef<SoAArrayT>;
+
+	/**
+	 * Construct for array, pointing at
+	 * idx-th row.
+	 *
+	 * @param inArray ref to array
+	 * @param [inIdx = 0] start index
+	 */
+	FORCE_INLINE SoAArrayIteratorBase(SoAArrayT & inArray, int64 inIdx = 0)
+		: array{&inArray}
+		, idx{inIdx}
+	{
+		//
+	}
+
+	/**
+	 * Dereference iterator, returns a
+	 * reference to idx-th row.
+	 */
+	FORCE_INLINE RefT operator*() const
+	{
+		return RefT{*array, static_cast<uint64>(idx)};
+	}
+
+	/**
+	 * Returns true if both iterators point
+	 * to the same position.
+	 * @{
+	 */
+	FORCE_INLINE bool operator==(const SoAArrayIteratorBase & other) const
+	{
+		return idx == other.idx;
+	}
+
+	FORCE_INLINE bool operator!=(const SoAArrayIteratorBase & other) const
+	{
+		return idx != other.idx;
+	}
+	/// @}
+
+	/**
+	 * Moves iterator to the next row.
+	 * @{
+	 */
+	FORCE_INLINE SoAArrayIteratorBase & operator++()
+	{
+		++idx;
+		return *this;
+	}
+
+	FORCE_INLINE SoAArrayIteratorBase operator++(int32)
+	{
+		SoAArrayIteratorBase it{*this};
+
+		++idx;
+		return it;
+	}
+	/// @}
+
+	/**
+	 * Moves iterator to the previous row.
+	 * @{
+	 */
+	FORCE_INLINE SoAArrayIteratorBase & operator--()
+	{
+		--idx;
+		return *this;
+	}
+
+	FORCE_INLINE SoAArrayIteratorBase operator--(int32)
+	{
+		SoAArrayIteratorBase it{*this};
+
+		--idx;
+		return it;
+	}
+	/// @}
+
+	/**
+	 * Increments or decrements iterator
+	 * by the given amount.
+	 *
+	 * @param n increment amount
+	 * @return ref to self or new iterator
+	 * @{
+	 */
+	FORCE_INLINE SoAArrayIteratorBase & operator+=(int64 n)
+	{
+		idx += n;
+		return *this;
+	}
+
+	FORCE_INLINE SoAArrayIteratorBase operator+(int64 n) const
+	{
+		SoAArrayIteratorBase it{*this};
+		return (it += n);
+	}
+
+	FORCE_INLINE SoAArrayIteratorBase & operator-=(int64 n)
+	{
+		idx -= n;
+		return *this;
+	}
+
+	FORCE_INLINE SoAArrayIteratorBase operator-(int64 n) const
+	{
+		SoAArrayIteratorBase it{*this};
+		return (it -= n);
+	}
+	/// @}
+
+	/**
+	 * Returns the distance between two
+	 * iterators of the same array.
+	 *
+	 * @param other another iterator
+	 * @return signed distance in rows
+	 */
+	FORCE_INLINE int64 operator-(const SoAArrayIteratorBase & other) const
+	{
+		return idx - other.idx;
+	}
+
+	/**
+	 * Subscript operation, returns i-th
+	 * row realtive to this iterator.
+	 */
+	FORCE_INLINE RefT operator[](int64 i) const
+	{
+		return RefT{*array, static_cast<uint64>(idx + i)};
+	}
+
+	/**
+	 * Ordering operations.
+	 *
+	 * @param other another iterator
+	 * @return true if the comparison
+	 * 	stands
+	 * @{
+	 */
+	FORCE_INLINE bool operator<(const SoAArrayIteratorBase & other) const
+	{
+		return idx < other.idx;
+	}
+
+	FORCE_INLINE bool operator>(const SoAArrayIteratorBase & other) const
+	{
+		return idx > other.idx;
+	}
+
+	FORCE_INLINE bool operator<=(const SoAArrayIteratorBase & other) const
+	{
+		return idx <= other.idx;
+	}
+
+	FORCE_INLINE bool operator>=(const SoAArrayIteratorBase & other) const
+	{
+		return idx >= other.idx;
+	}
+	/** @} */
+
+private:
+	/// Underlying array
+	SoAArrayT * array;
+
+	/// Current index
+	int64 idx;
+};
+
+/**
+ * A dynamic array that stores each
+ * field of its rows in a separate
+ * contiguous column (structure of
+ * arrays), so that kernels that only
+ * touch a few fields stream through
+ * dense memory and can be vectorized.
+ *
+ * All columns share a single buffer
+ * and are resized together. Each
+ * column starts at a multiple of
+ * columnAlignment bytes.
+ *
+ * Rows are accessed through row
+ * references, whose fields are read
+ * with get<idx>(). The row iterator
+ * works with the algorithms in
+ * algorithm/sort.h, provided that the
+ * compare function accepts both row
+ * references and row values, e.g. a
+ * generic lambda.
+ *
+ * Example:
+ * ```cpp
+ * SoAArray<uint32, float32> soa;
+ * soa.add(1u, 0.5f);
+ * soa.getColumn<1>()[0] *= 2.f;
+ * Sort::introsort(soa.begin(), soa.end(), [](const auto & a, const auto & b) {
+ * 	return ThreeWayCompare{}(a.template get<0>(), b.template get<0>());
+ * });
+ * ```
+ *
+ * @param FieldListT types of the fields
+ */
+template<typename ...FieldListT>
+class SoAArray
+{
+	template<typename> friend class SoARowRef;
+
+public:
+	/// Number of columns
+	static constexpr uint64 numColumns = sizeof...(FieldListT);
+
+	/// Alignment of each column, in bytes
+	static constexpr sizet columnAlignment = 64;
+
+	static_assert(numColumns > 0, "SoA array must have at least one field");
+
+	using ValueT = SoARow<FieldListT...>;
+	using RowRef = SoARowRef<SoAArray>;
+	using ConstRowRef = SoARowRef<const SoAArray>;
+	using Iterator = SoAArrayIteratorBase<SoAArray>;
+	using ConstIterator = SoAArrayIteratorBase<const SoAArray>;
+	using IndicesT = typename MakeIndexSequence<numColumns>::Type;
+
+	/// Type of the field at position idx
+	template<uint64 idx>
+	using FieldT = typename RemovePointer<typename RemoveReference<decltype(declVal<Tuple<FieldListT*...>&>().template get<idx>())>::Type>::Type;
+
+protected:
+	/// Minimum number of rows allocated
+	static constexpr uint64 minCapacity = 8;
+
+	/// Allocation unit of the buffer
+	struct alignas(columnAlignment) Block
+	{
+		ubyte bytes[columnAlignment];
+	};
+
+	static_assert(sizeof(Block) == columnAlignment, "Unexpected block size");
+
+	using ColumnsT = Tuple<FieldListT*...>;
+
+	/**
+	 * Returns the number of blocks
+	 * required to store a column of
+	 * items of type T.
+	 */
+	template<typename T>
+	static constexpr FORCE_INLINE uint64 getNumColumnBlocks(uint64 inCapacity)
+	{
+		static_assert(alignof(T) <= columnAlignment, "Field alignment exceeds column alignment");
+		return (inCapacity * sizeof(T) + columnAlignment - 1) / columnAlignment;
+	}
+
+	/**
+	 * Returns the number of blocks
+	 * required to store all columns.
+	 */
+	static constexpr FORCE_INLINE uint64 getNumBlocks(uint64 inCapacity)
+	{
+		return (getNumColumnBlocks<FieldListT>(inCapacity) + ...);
+	}
+
+	/**
+	 * Sets the column pointers in the
+	 * given buffer.
+	 *
+	 * @param outColumns column pointers
+	 * @param inBuffer buffer with enough
+	 * 	space for all columns
+	 * @param inCapacity number of rows
+	 */
+	template<uint64 ...idxs>
+	static FORCE_INLINE void setColumns(ColumnsT & outColumns, Block * inBuffer, uint64 inCapacity, IndexSequence<idxs...>)
+	{
+		uint64 offset = 0;
+		((outColumns.template get<idxs>() = reinterpret_cast<FieldT<idxs>*>(inBuffer + offset), offset += getNumColumnBlocks<FieldT<idxs>>(inCapacity)), ...);
+	}
+
+	/**
+	 * Moves count items of a column to a
+	 * new location, and destroys the
+	 * old items.
+	 * @{
+	 */
+	template<typename T>
+	static FORCE_INLINE typename EnableIf<IsTriviallyCopyable<T>::value>::Type relocateColumn(T * dst, T * src, uint64 n)
+	{
+		Memory::memcpy(dst, src, n * sizeof(T));
+	}
+
+	template<typename T>
+	static FORCE_INLINE typename EnableIf<!IsTriviallyCopyable<T>::value>::Type relocateColumn(T * dst, T * src, uint64 n)
+	{
+		for (uint64 i = 0; i < n; ++i)
+		{
+			new (dst + i) T{move(src[i])};
+			src[i].~T();
+		}
+	}
+	/// @}
+
+	/**
+	 * Reallocates the buffer with the
+	 * given capacity and moves all rows.
+	 *
+	 * @param inCapacity new capacity,
+	 * 	must fit all rows
+	 */
+	void resizeBuffer(uint64 inCapacity)
+	{
+		Block * inBuffer = malloc.alloc(getNumBlocks(inCapacity));
+		ColumnsT inColumns;
+
+		setColumns(inColumns, inBuffer, inCapacity, IndicesT{});
+
+		if (buffer)
+		{
+			relocateColumns(inColumns, IndicesT{});
+			malloc.free(buffer);
+		}
+
+		buffer = inBuffer;
+		columns = inColumns;
+		capacity = inCapacity;
+	}
+
+	/**
+	 * Relocates all columns.
+	 */
+	template<uint64 ...idxs>
+	FORCE_INLINE void relocateColumns(ColumnsT & dst, IndexSequence<idxs...>)
+	{
+		(relocateColumn(dst.template get<idxs>(), columns.template get<idxs>(), count), ...);
+	}
+
+	/**
+	 * Copies all rows of another array
+	 * into this empty array.
+	 */
+	template<uint64 ...idxs>
+	FORCE_INLINE void copyColumns(const SoAArray & other, IndexSequence<idxs...>)
+	{
+		(Memory::constructCopyElements(columns.template get<idxs>(), other.columns.template get<idxs>(), other.count), ...);
+	}
+
+	/**
+	 * Constructs the fields of a row.
+	 *
+	 * @param row index of the row
+	 * @param fields field values
+	 */
+	template<uint64 ...idxs, typename ...ArgsT>
+	FORCE_INLINE void constructRow(uint64 row, IndexSequence<idxs...>, ArgsT && ...fields)
+	{
+		(new (columns.template get<idxs>() + row) FieldT<idxs>{forward<ArgsT>(fields)}, ...);
+	}
+
+	/**
+	 * Destroys the rows in [from, to).
+	 */
+	template<uint64 ...idxs>
+	FORCE_INLINE void destroyRows(uint64 from, uint64 to, IndexSequence<idxs...>)
+	{
+		(Memory::destroyElements(columns.template get<idxs>() + from, columns.template get<idxs>() + to), ...);
+	}
+
+	/**
+	 * Sets all column pointers to null.
+	 */
+	template<uint64 ...idxs>
+	FORCE_INLINE void resetColumns(IndexSequence<idxs...>)
+	{
+		((columns.template get<idxs>() = nullptr), ...);
+	}
+
+	/**
+	 * Destroys all rows and deallocates
+	 * the buffer.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		if (buffer)
+		{
+			destroyRows(0, count, IndicesT{});
+
+			malloc.free(buffer);
+			buffer = nullptr;
+		}
+
+		resetColumns(IndicesT{});
+		count = capacity = 0;
+	}
+
+public:
+	/**
+	 * Default constructor, creates an
+	 * empty array.
+	 */
+	FORCE_INLINE SoAArray()
+		: malloc{}
+		, buffer{nullptr}
+		, columns{}
+		, count{0}
+		, capacity{0}
+	{
+		resetColumns(IndicesT{});
+	}
+
+	/**
+	 * Creates an empty array that uses
+	 * the given allocator.
+	 *
+	 * @param inMalloc pointer to external
+	 * 	allocator
+	 */
+	FORCE_INLINE explicit SoAArray(MallocBase * inMalloc)
+		: malloc{inMalloc}
+		, buffer{nullptr}
+		, columns{}
+		, count{0}
+		, capacity{0}
+	{
+		resetColumns(IndicesT{});
+	}
+
+	/**
+	 * Copy constructor.
+	 */
+	SoAArray(const SoAArray & other)
+		: SoAArray{}
+	{
+		if (other.count > 0)
+		{
+			resizeBuffer(other.count);
+			copyColumns(other, IndicesT{});
+			count = other.count;
+		}
+	}
+
+	/**
+	 * Move constructor.
+	 */
+	SoAArray(SoAArray && other)
+		: malloc{move(other.malloc)}
+		, buffer{other.buffer}
+		, columns{other.columns}
+		, count{other.count}
+		, capacity{other.capacity}
+	{
+		other.buffer = nullptr;
+		other.resetColumns(IndicesT{});
+		other.count = other.capacity = 0;
+	}
+
+	/**
+	 * Destructor, destroys all rows.
+	 */
+	FORCE_INLINE ~SoAArray()
+	{
+		destroy();
+	}
+
+	/**
+	 * Copy assignment.
+	 */
+	SoAArray & operator=(const SoAArray & other)
+	{
+		if (this != &other)
+		{
+			empty();
+			if (other.count > capacity) resizeBuffer(other.count);
+
+			copyColumns(other, IndicesT{});
+			count = other.count;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Move assignment.
+	 */
+	SoAArray & operator=(SoAArray && other)
+	{
+		destroy();
+
+		malloc = move(other.malloc);
+		buffer = other.buffer;
+		columns = other.columns;
+		count = other.count;
+		capacity = other.capacity;
+
+		other.buffer = nullptr;
+		other.resetColumns(IndicesT{});
+		other.count = other.capacity = 0;
+
+		return *this;
+	}
+
+	/**
+	 * Returns number of rows.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getNum, getCount)
+	/** @} */
+
+	/**
+	 * Returns number of rows that fit in
+	 * the allocated buffer.
+	 */
+	FORCE_INLINE uint64 getCapacity() const
+	{
+		return capacity;
+	}
+
+	/**
+	 * Returns true if array is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns a pointer to the first
+	 * item of the idx-th column.
+	 * @{
+	 */
+	template<uint64 idx>
+	FORCE_INLINE FieldT<idx> * getColumnData()
+	{
+		return columns.template get<idx>();
+	}
+
+	template<uint64 idx>
+	FORCE_INLINE const FieldT<idx> * getColumnData() const
+	{
+		return columns.template get<idx>();
+	}
+	/// @}
+
+	/**
+	 * Returns a view on the items of the
+	 * idx-th column.
+	 * @{
+	 */
+	template<uint64 idx>
+	FORCE_INLINE SoAColumn<FieldT<idx>> getColumn()
+	{
+		return SoAColumn<FieldT<idx>>{columns.template get<idx>(), count};
+	}
+
+	template<uint64 idx>
+	FORCE_INLINE SoAColumn<const FieldT<idx>> getColumn() const
+	{
+		return SoAColumn<const FieldT<idx>>{columns.template get<idx>(), count};
+	}
+	/// @}
+
+	/**
+	 * Returns a reference to the idx-th
+	 * row.
+	 * @{
+	 */
+	FORCE_INLINE RowRef operator[](uint64 idx)
+	{
+		return RowRef{*this, idx};
+	}
+
+	FORCE_INLINE ConstRowRef operator[](uint64 idx) const
+	{
+		return ConstRowRef{*this, idx};
+	}
+
+	FORCE_INLINE RowRef getRow(uint64 idx)
+	{
+		return RowRef{*this, idx};
+	}
+
+	FORCE_INLINE ConstRowRef getRow(uint64 idx) const
+	{
+		return ConstRowRef{*this, idx};
+	}
+	/// @}
+
+	/**
+	 * Returns a reference to the last
+	 * row.
+	 * @{
+	 */
+	FORCE_INLINE RowRef getLast()
+	{
+		CHECK(count > 0)
+		return RowRef{*this, count - 1};
+	}
+
+	FORCE_INLINE ConstRowRef getLast() const
+	{
+		CHECK(count > 0)
+		return ConstRowRef{*this, count - 1};
+	}
+	/// @}
+
+	/**
+	 * Returns a new iterator that points
+	 * to the first row.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{*this, 0};
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return Iterator{*this, 0};
+	}
+	/** @} */
+
+	/**
+	 * Returns a new iterator that points
+	 * past the last row.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{*this, static_cast<int64>(count)};
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return Iterator{*this, static_cast<int64>(count)};
+	}
+	/** @} */
+
+	/**
+	 * Makes sure the buffer can hold at
+	 * least the given number of rows.
+	 *
+	 * @param inCapacity required capacity
+	 */
+	FORCE_INLINE void reserve(uint64 inCapacity)
+	{
+		if (inCapacity > capacity) resizeBuffer(inCapacity);
+	}
+
+	/**
+	 * Appends a new row to the array.
+	 *
+	 * @param fields values of the fields,
+	 * 	one per column
+	 * @return ref to the new row
+	 */
+	template<typename ...ArgsT>
+	FORCE_INLINE RowRef add(ArgsT && ...fields)
+	{
+		static_assert(sizeof...(ArgsT) == numColumns, "Expected one value per field");
+
+		if (count == capacity)
+		{
+			uint64 inCapacity = capacity ? capacity : minCapacity;
+			while (inCapacity <= count) inCapacity *= 2;
+
+			resizeBuffer(inCapacity);
+		}
+
+		constructRow(count, IndicesT{}, forward<ArgsT>(fields)...);
+		return RowRef{*this, count++};
+	}
+
+	METHOD_ALIAS(push, add)
+
+	/**
+	 * Removes the last row.
+	 */
+	FORCE_INLINE void removeLast()
+	{
+		CHECK(count > 0)
+
+		--count;
+		destroyRows(count, count + 1, IndicesT{});
+	}
+
+	/**
+	 * Removes the idx-th row by moving
+	 * the last row in its place.
+	 *
+	 * @param idx index of the row
+	 */
+	FORCE_INLINE void removeAtSwap(uint64 idx)
+	{
+		CHECK(idx < count)
+
+		if (idx != count - 1) getRow(idx) = move(getLast());
+		removeLast();
+	}
+
+	/**
+	 * Destroys all rows, buffer is kept.
+	 * @{
+	 */
+	FORCE_INLINE void empty()
+	{
+		destroyRows(0, count, IndicesT{});
+		count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+	/**
+	 * Destroys all rows and deallocates
+	 * the buffer.
+	 */
+	FORCE_INLINE void reset()
+	{
+		destroy();
+	}
+
+protected:
+	/// Buffer allocator
+	MallocObject<Block> malloc;
+
+	/// Buffer shared by all columns
+	Block * buffer;
+
+	/// Pointer to each column
+	ColumnsT columns;
+
+	/// Number of rows
+	uint64 count;
+
+	/// Number of allocated rows
+	uint64 capacity;
+};
@@ -1093,6 +1093,43 @@ protected:
 		return dstRoot;
 	}
 
+	/**
+	 * Builds a balanced subtree with n
+	 * nodes, whose data is created in
+	 * order. All nodes at the given depth
+	 * are red, the others are black.
+	 *
+	 * @param n number of nodes
+	 * @param depth depth of the subtree
+	 * 	root
+	 * @param redDepth depth of the red
+	 * 	nodes
+	 * @param prev last node created
+	 * @param createData function that
+	 * 	returns the next data
+	 * @return subtree root
+	 */
+	template<typename CreateDataT>
+	NodeT * buildSubtree(uint64 n, uint32 depth, uint32 redDepth, NodeT *& prev, CreateDataT & createData)
+	{
+		if (n == 0) return nullptr;
+
+		const uint64 numLeft = (n - 1) / 2;
+		NodeT * left = buildSubtree(numLeft, depth + 1, redDepth, prev, createData);
+
+		NodeT * node = createNode(createData());
+		node->color = depth == redDepth ? BinaryNodeColor::RED : BinaryNodeColor::BLACK;
+
+		if ((node->left = left)) left->parent = node;
+		if ((node->prev = prev)) prev->next = node;
+		prev = node;
+
+		NodeT * right = buildSubtree(n - 1 - numLeft, depth + 1, redDepth, prev, createData);
+		if ((node->right = right)) right->parent = node;
+
+		return node;
+	}
+
 public:
 	/**
 	 * Copy constructor.
@@ -1180,6 +1217,40 @@ public:
 		numNodes = 0;
 	}
 
+	/**
+	 * Replaces the content of the tree with
+	 * n items, given in strictly increasing
+	 * order. The tree is built balanced in
+	 * O(n) time, without comparisons or
+	 * rotations.
+	 *
+	 * @param n number of items
+	 * @param createData function that
+	 * 	returns the next item
+	 */
+	template<typename CreateDataT>
+	void buildSorted(uint64 n, CreateDataT && createData)
+	{
+		empty();
+
+		// Leaves of the balanced tree are in
+		// the last two levels. Coloring the
+		// deepest level red gives the same
+		// number of black nodes on all paths
+		uint32 redDepth = 0;
+		while ((2ull << redDepth) - 1 < n) ++redDepth;
+
+		NodeT * prev = nullptr;
+		root = buildSubtree(n, 0, redDepth, prev, createData);
+		numNodes = n;
+
+		if (root)
+		{
+			root->parent = nullptr;
+			root->color = BinaryNodeColor::BLACK;
+		}
+	}
+
 protected:
 	/**
 	 * Destroy tree.
@@ -2,6 +2,8 @@
 
 #include "core_types.h"
 #include "templates/enable_if.h"
+#include "templates/types.h"
+#include "templates/hash.h"
 #include "./containers_types.h"
 
 /**
@@ -249,4 +251,24 @@ public:
 protected:
 	/// Contained item
 	HeadT item;
-};
\ No newline at end of file
+};
+
+/**
+ * Hash of tuples, combines the hashes of
+ * all items in order.
+ */
+template<typename ...ItemListT>
+struct Hash<Tuple<ItemListT...>>
+{
+	FORCE_INLINE uint64 operator()(const Tuple<ItemListT...> & tup) const
+	{
+		return hashItems(tup, typename MakeIndexSequence<sizeof...(ItemListT)>::Type{});
+	}
+
+protected:
+	template<uint64 ...idxs>
+	static FORCE_INLINE uint64 hashItems(const Tuple<ItemListT...> & tup, IndexSequence<idxs...>)
+	{
+		return HashUtils::hashValues(tup.template get<idxs>()...);
+	}
+};
@@ -0,0 +1,894 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "misc/assert.h"
+#include "templates/iterator.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "hal/platform_memory.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_object.h"
+#include "./containers_types.h"
+
+/**
+ * Node of an unrolled list, stores a
+ * small array of items together with
+ * the links to the adjacent nodes.
+ *
+ * @param T type of the items
+ * @param capacity max number of items
+ * 	in the node
+ */
+template<typename T, uint32 capacity>
+struct UnrolledNode
+{
+	using DataT = T;
+
+	/// Pointer to next node
+	UnrolledNode * next;
+
+	/// Pointer to previous node
+	UnrolledNode * prev;
+
+	/// Number of items in the node
+	uint32 count;
+
+	/// Items storage
+	alignas(T) ubyte storage[capacity * sizeof(T)];
+
+	/**
+	 * Creates an empty node.
+	 */
+	FORCE_INLINE UnrolledNode()
+		: next{nullptr}
+		, prev{nullptr}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Returns pointer to the items.
+	 * @{
+	 */
+	FORCE_INLINE T * getItems()
+	{
+		return reinterpret_cast<T*>(storage);
+	}
+
+	FORCE_INLINE const T * getItems() const
+	{
+		return reinterpret_cast<const T*>(storage);
+	}
+	/// @}
+};
+
+/**
+ * Iterator used to iterate over the
+ * items of an unrolled list. It keeps
+ * a pointer to the list, so that the
+ * end iterator can be decremented.
+ *
+ * @param ListT type of unrolled list
+ * @param NodeT type of node, possibly
+ * 	const qualified
+ * @param IteratorTraitsT type that
+ * 	define the iterator types
+ */
+template<typename ListT, typename NodeT, typename IteratorTraitsT>
+struct UnrolledListIteratorBase
+{
+	template<typename, typename, uint32> friend class UnrolledList;
+
+	using RefT = typename IteratorTraitsT::RefT;
+	using PtrT = typename IteratorTraitsT::PtrT;
+
+	/**
+	 * Create iterator that points to
+	 * the idx-th item of the node. A
+	 * null node is the end iterator.
+	 *
+	 * @param inList list being iterated
+	 * @param inNode current node
+	 * @param inIdx index in node
+	 */
+	FORCE_INLINE UnrolledListIteratorBase(ListT * inList, NodeT * inNode = nullptr, uint32 inIdx = 0)
+		: list{inList}
+		, node{inNode}
+		, idx{inIdx}
+	{
+		//
+	}
+
+	/**
+	 * Returns ref to current item.
+	 */
+	FORCE_INLINE RefT operator*() const
+	{
+		return node->getItems()[idx];
+	}
+
+	/**
+	 * Returns ptr to current item.
+	 */
+	FORCE_INLINE PtrT operator->() const
+	{
+		return &(**this);
+	}
+
+	/**
+	 * Returns true if both iterators
+	 * point to the same item.
+	 */
+	FORCE_INLINE bool operator==(const UnrolledListIteratorBase & other) const
+	{
+		return node == other.node && idx == other.idx;
+	}
+
+	/**
+	 * Returns true if iterators point
+	 * to different items.
+	 */
+	FORCE_INLINE bool operator!=(const UnrolledListIteratorBase & other) const
+	{
+		return !(*this == other);
+	}
+
+	/**
+	 * Advances iterator to the next
+	 * item and returns a ref to the
+	 * iterator.
+	 */
+	FORCE_INLINE UnrolledListIteratorBase & operator++()
+	{
+		if (++idx == node->count)
+		{
+			node = node->next;
+			idx = 0;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Advances iterator to the next
+	 * item and returns a new iterator
+	 * that points to the current item.
+	 */
+	FORCE_INLINE UnrolledListIteratorBase operator++(int32)
+	{
+		UnrolledListIteratorBase it{*this};
+		++(*this);
+		return it;
+	}
+
+	/**
+	 * Move iterator backward and
+	 * returns a ref to the iterator.
+	 */
+	FORCE_INLINE UnrolledListIteratorBase & operator--()
+	{
+		if (!node)
+		{
+			node = list->tail;
+			idx = node->count - 1;
+		}
+		else if (idx == 0)
+		{
+			node = node->prev;
+			idx = node->count - 1;
+		}
+		else --idx;
+
+		return *this;
+	}
+
+	/**
+	 * Moves iterator to the previous
+	 * item and returns a new iterator
+	 * that points to the current item.
+	 */
+	FORCE_INLINE UnrolledListIteratorBase operator--(int32)
+	{
+		UnrolledListIteratorBase it{*this};
+		--(*this);
+		return it;
+	}
+
+private:
+	/// Iterated list
+	ListT * list;
+
+	/// Current node
+	NodeT * node;
+
+	/// Index of item in current node
+	uint32 idx;
+};
+
+/**
+ * An unrolled linked list is a doubly
+ * linked list of nodes, each storing
+ * a small array of items. Nodes are
+ * sized to fit in two cache lines by
+ * default.
+ *
+ * Inserting or removing an item in
+ * the middle only shifts the items of
+ * one node. A full node is split in
+ * two halves, and a node that falls
+ * below half capacity is merged with
+ * or borrows items from the next one,
+ * so that nodes are always at least
+ * half full (except possibly the
+ * last one).
+ *
+ * Inserting and removing items
+ * invalidates iterators and refs to
+ * items of the affected nodes.
+ *
+ * @param T type of the items
+ * @param nodeCapacity max number of
+ * 	items per node, if zero it is
+ * 	computed from the size of T
+ */
+template<typename T, uint32 nodeCapacity>
+class UnrolledList<T, void, nodeCapacity>
+{
+	template<typename, typename, typename> friend struct UnrolledListIteratorBase;
+
+public:
+	/// Size of a node, in bytes, used
+	/// to compute the node capacity
+	static constexpr sizet targetNodeSize = 128;
+
+	/// Actual max number of items per
+	/// node
+	static constexpr uint32 itemsPerNode = nodeCapacity
+		? nodeCapacity
+		: (targetNodeSize - 2 * sizeof(void*) - sizeof(uint64)) / sizeof(T) > 4
+			? (targetNodeSize - 2 * sizeof(void*) - sizeof(uint64)) / sizeof(T)
+			: 4;
+
+	static_assert(itemsPerNode > 1, "Node capacity must be at least 2");
+
+	using ListT = UnrolledList<T, void, nodeCapacity>;
+	using ItemT = T;
+	using NodeT = UnrolledNode<T, itemsPerNode>;
+	using Iterator = UnrolledListIteratorBase<ListT, NodeT, BidirectionalIterator<T>>;
+	using ConstIterator = UnrolledListIteratorBase<const ListT, const NodeT, BidirectionalIterator<const T>>;
+
+	/**
+	 * Default constructor, creates empty
+	 * list with global allocator.
+	 */
+	FORCE_INLINE UnrolledList()
+		: malloc{}
+		, head{nullptr}
+		, tail{nullptr}
+		, numNodes{0}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Allocator initializer.
+	 *
+	 * @param inMalloc pointer to external
+	 * 	allocator
+	 */
+	FORCE_INLINE explicit UnrolledList(MallocBase * inMalloc)
+		: malloc{inMalloc}
+		, head{nullptr}
+		, tail{nullptr}
+		, numNodes{0}
+		, count{0}
+	{
+		//
+	}
+
+	/**
+	 * Copy constructor.
+	 */
+	UnrolledList(const UnrolledList & other)
+		: UnrolledList{}
+	{
+		for (const T & item : other) pushBack(item);
+	}
+
+	/**
+	 * Move constructor.
+	 */
+	FORCE_INLINE UnrolledList(UnrolledList && other)
+		: malloc{move(other.malloc)}
+		, head{other.head}
+		, tail{other.tail}
+		, numNodes{other.numNodes}
+		, count{other.count}
+	{
+		other.head = other.tail = nullptr;
+		other.numNodes = other.count = 0;
+	}
+
+	/**
+	 * Copy assignment.
+	 */
+	UnrolledList & operator=(const UnrolledList & other)
+	{
+		if (this != &other)
+		{
+			empty();
+			for (const T & item : other) pushBack(item);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Move assignment.
+	 */
+	UnrolledList & operator=(UnrolledList && other)
+	{
+		empty();
+
+		malloc = move(other.malloc);
+		head = other.head;
+		tail = other.tail;
+		numNodes = other.numNodes;
+		count = other.count;
+
+		other.head = other.tail = nullptr;
+		other.numNodes = other.count = 0;
+
+		return *this;
+	}
+
+	/**
+	 * Destructor, destroys all nodes.
+	 */
+	FORCE_INLINE ~UnrolledList()
+	{
+		destroy();
+	}
+
+	/**
+	 * Returns number of items.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getCount)
+	METHOD_ALIAS_CONST(getLength, getCount)
+	/// @}
+
+	/**
+	 * Returns number of allocated nodes.
+	 */
+	FORCE_INLINE uint64 getNumNodes() const
+	{
+		return numNodes;
+	}
+
+	/**
+	 * Returns true if list is empty.
+	 */
+	FORCE_INLINE bool isEmpty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * Returns the first item.
+	 * @{
+	 */
+	FORCE_INLINE T & getFront()
+	{
+		CHECK(count > 0)
+		return head->getItems()[0];
+	}
+
+	FORCE_INLINE const T & getFront() const
+	{
+		CHECK(count > 0)
+		return head->getItems()[0];
+	}
+	/// @}
+
+	/**
+	 * Returns the last item.
+	 * @{
+	 */
+	FORCE_INLINE T & getBack()
+	{
+		CHECK(count > 0)
+		return tail->getItems()[tail->count - 1];
+	}
+
+	FORCE_INLINE const T & getBack() const
+	{
+		CHECK(count > 0)
+		return tail->getItems()[tail->count - 1];
+	}
+	/// @}
+
+	/**
+	 * Returns the idx-th item, in
+	 * O(N / itemsPerNode) time.
+	 *
+	 * @param idx item position
+	 * @return ref to item
+	 * @{
+	 */
+	FORCE_INLINE T & operator[](uint64 idx)
+	{
+		return *findAt(idx);
+	}
+
+	METHOD_ALIAS(getAt, operator[])
+
+	FORCE_INLINE const T & operator[](uint64 idx) const
+	{
+		return *const_cast<UnrolledList*>(this)->findAt(idx);
+	}
+
+	METHOD_ALIAS_CONST(getAt, operator[])
+	/// @}
+
+	/**
+	 * Returns an iterator that points
+	 * to the idx-th item, or to the end
+	 * if idx is out of bounds.
+	 *
+	 * @param idx item position
+	 * @return iterator to item
+	 */
+	Iterator findAt(uint64 idx)
+	{
+		NodeT * node = head;
+		for (; node && idx >= node->count; node = node->next)
+		{
+			idx -= node->count;
+		}
+
+		return Iterator{this, node, node ? static_cast<uint32>(idx) : 0};
+	}
+
+	/**
+	 * Returns an iterator that points
+	 * to the first item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator begin() const
+	{
+		return ConstIterator{this, head, 0};
+	}
+
+	FORCE_INLINE Iterator begin()
+	{
+		return Iterator{this, head, 0};
+	}
+	/// @}
+
+	/**
+	 * Returns an iterator that points
+	 * past the last item.
+	 * @{
+	 */
+	FORCE_INLINE ConstIterator end() const
+	{
+		return ConstIterator{this};
+	}
+
+	FORCE_INLINE Iterator end()
+	{
+		return Iterator{this};
+	}
+	/// @}
+
+	/**
+	 * Inserts an item before the item
+	 * pointed by the iterator.
+	 *
+	 * @param it iterator to next item,
+	 * 	may be end()
+	 * @param item item to insert
+	 * @return iterator to inserted item
+	 */
+	template<typename ItemT>
+	Iterator insert(Iterator it, ItemT && item)
+	{
+		NodeT * node = it.node;
+		uint32 idx = it.idx;
+
+		if (!node)
+		{
+			// Append to last node
+			if (!tail || tail->count == itemsPerNode) linkNode(createNode(), tail);
+
+			node = tail;
+			idx = node->count;
+		}
+		else if (node->count == itemsPerNode)
+		{
+			// Split node in two halves, and
+			// insert in the correct one
+			NodeT * other = splitNode(node);
+			if (idx > node->count)
+			{
+				idx -= node->count;
+				node = other;
+			}
+		}
+
+		T * items = node->getItems();
+		relocateItems(items + idx + 1, items + idx, node->count - idx);
+		new (items + idx) T{forward<ItemT>(item)};
+
+		++node->count;
+		++count;
+
+		return Iterator{this, node, idx};
+	}
+
+	/**
+	 * Inserts an item at the end of the
+	 * list.
+	 *
+	 * @param item item to insert
+	 * @return ref to inserted item
+	 */
+	template<typename ItemT>
+	FORCE_INLINE T & pushBack(ItemT && item)
+	{
+		return *insert(end(), forward<ItemT>(item));
+	}
+
+	METHOD_ALIAS(push, pushBack)
+
+	/**
+	 * Inserts an item at the start of
+	 * the list.
+	 *
+	 * @param item item to insert
+	 * @return ref to inserted item
+	 */
+	template<typename ItemT>
+	FORCE_INLINE T & pushFront(ItemT && item)
+	{
+		return *insert(begin(), forward<ItemT>(item));
+	}
+
+	/**
+	 * Removes the item pointed by the
+	 * iterator.
+	 *
+	 * @param it iterator to item
+	 * @return iterator to next item
+	 */
+	Iterator remove(Iterator it)
+	{
+		NodeT * node = it.node;
+		uint32 idx = it.idx;
+		CHECK(node != nullptr)
+
+		T * items = node->getItems();
+		items[idx].~T();
+		relocateItems(items + idx, items + idx + 1, node->count - idx - 1);
+
+		--node->count;
+		--count;
+
+		if (node->count == 0)
+		{
+			// Remove empty node
+			NodeT * next = node->next;
+			unlinkNode(node);
+			destroyNode(node);
+
+			return Iterator{this, next, 0};
+		}
+
+		if (node->count < itemsPerNode / 2) rebalanceNode(node);
+
+		// Items are appended to the node
+		// so the next item is either at
+		// the same position or at the
+		// start of the next node
+		if (idx == node->count) return Iterator{this, node->next, 0};
+		return Iterator{this, node, idx};
+	}
+
+	/**
+	 * Removes the last item.
+	 *
+	 * @return true if an item was
+	 * 	removed
+	 */
+	FORCE_INLINE bool removeBack()
+	{
+		if (count == 0) return false;
+
+		remove(Iterator{this, tail, tail->count - 1});
+		return true;
+	}
+
+	/**
+	 * Removes the first item.
+	 *
+	 * @return true if an item was
+	 * 	removed
+	 */
+	FORCE_INLINE bool removeFront()
+	{
+		if (count == 0) return false;
+
+		remove(begin());
+		return true;
+	}
+
+	/**
+	 * Moves out the last item and
+	 * removes it.
+	 *
+	 * @param outItem popped item
+	 * @return true if an item was
+	 * 	popped
+	 */
+	FORCE_INLINE bool popBack(T & outItem)
+	{
+		if (count == 0) return false;
+
+		outItem = move(getBack());
+		return removeBack();
+	}
+
+	/**
+	 * Moves out the first item and
+	 * removes it.
+	 *
+	 * @param outItem popped item
+	 * @return true if an item was
+	 * 	popped
+	 */
+	FORCE_INLINE bool popFront(T & outItem)
+	{
+		if (count == 0) return false;
+
+		outItem = move(getFront());
+		return removeFront();
+	}
+
+	/**
+	 * Removes all items and nodes.
+	 * @{
+	 */
+	void empty()
+	{
+		while (head)
+		{
+			NodeT * node = head;
+			head = head->next;
+
+			Memory::destroyElements(node->getItems(), node->getItems() + node->count);
+			destroyNode(node);
+		}
+
+		head = tail = nullptr;
+		numNodes = count = 0;
+	}
+
+	METHOD_ALIAS(clear, empty)
+	/// @}
+
+protected:
+	/**
+	 * Destroys list.
+	 */
+	FORCE_INLINE void destroy()
+	{
+		empty();
+	}
+
+	/**
+	 * Moves items from src to dst,
+	 * constructing the items in dst and
+	 * destroying the items in src. The
+	 * two ranges may overlap.
+	 *
+	 * @param dst destination items
+	 * @param src source items
+	 * @param n number of items
+	 */
+	static FORCE_INLINE void relocateItems(T * dst, T * src, uint32 n)
+	{
+		if (dst < src)
+		{
+			for (uint32 i = 0; i < n; ++i)
+			{
+				new (dst + i) T{move(src[i])};
+				src[i].~T();
+			}
+		}
+		else if (dst > src)
+		{
+			for (uint32 i = n; i > 0; --i)
+			{
+				new (dst + i - 1) T{move(src[i - 1])};
+				src[i - 1].~T();
+			}
+		}
+	}
+
+	/**
+	 * Allocates a new empty node.
+	 */
+	FORCE_INLINE NodeT * createNode()
+	{
+		++numNodes;
+		return new (malloc.alloc()) NodeT{};
+	}
+
+	/**
+	 * Deallocates an empty node.
+	 */
+	FORCE_INLINE void destroyNode(NodeT * node)
+	{
+		--numNodes;
+		node->~NodeT();
+		malloc.free(node);
+	}
+
+	/**
+	 * Links a node after another one, or
+	 * at the start of the list.
+	 *
+	 * @param node node to link
+	 * @param prev node that precedes,
+	 * 	may be null
+	 */
+	FORCE_INLINE void linkNode(NodeT * node, NodeT * prev)
+	{
+		NodeT * next = prev ? prev->next : head;
+
+		node->prev = prev;
+		node->next = next;
+		(prev ? prev->next : head) = node;
+		(next ? next->prev : tail) = node;
+	}
+
+	/**
+	 * Unlinks a node from the list.
+	 *
+	 * @param node node to unlink
+	 */
+	FORCE_INLINE void unlinkNode(NodeT * node)
+	{
+		(node->prev ? node->prev->next : head) = node->next;
+		(node->next ? node->next->prev : tail) = node->prev;
+	}
+
+	/**
+	 * Moves the upper half of a node to
+	 * a new node, linked after it.
+	 *
+	 * @param node node to split
+	 * @return new node
+	 */
+	NodeT * splitNode(NodeT * node)
+	{
+		NodeT * other = createNode();
+		linkNode(other, node);
+
+		const uint32 half = node->count / 2;
+		const uint32 numMoved = node->count - half;
+
+		relocateItems(other->getItems(), node->getItems() + half, numMoved);
+		node->count = half;
+		other->count = numMoved;
+
+		return other;
+	}
+
+	/**
+	 * Refills a node that is less than
+	 * half full, by merging the next node
+	 * into it if they fit in a single
+	 * node, or by borrowing items from
+	 * the next node otherwise.
+	 *
+	 * @param node node to rebalance
+	 */
+	void rebalanceNode(NodeT * node)
+	{
+		NodeT * next = node->next;
+		if (!next) return;
+
+		T * items = node->getItems() + node->count;
+		T * nextItems = next->getItems();
+
+		if (node->count + next->count <= itemsPerNode)
+		{
+			// Merge next node into this one
+			relocateItems(items, nextItems, next->count);
+			node->count += next->count;
+			next->count = 0;
+
+			unlinkNode(next);
+			destroyNode(next);
+		}
+		else
+		{
+			// Borrow items to balance nodes
+			const uint32 numMoved = (next->count - node->count) / 2;
+
+			relocateItems(items, nextItems, numMoved);
+			relocateItems(nextItems, nextItems + numMoved, next->count - numMoved);
+			node->count += numMoved;
+			next->count -= numMoved;
+		}
+	}
+
+	/// Nodes allocator
+	MallocObject<NodeT> malloc;
+
+	/// First node of the list
+	NodeT * head;
+
+	/// Last node of the list
+	NodeT * tail;
+
+	/// Number of allocated nodes
+	uint64 numNodes;
+
+	/// Total number of items
+	uint64 count;
+};
+
+/**
+ * Generalization that handles allocator
+ * management.
+ *
+ * @param T type of items
+ * @param MallocT allocator type
+ * @param nodeCapacity max number of
+ * 	items per node
+ */
+template<typename T, typename MallocT, uint32 nodeCapacity>
+class UnrolledList : public UnrolledList<T, void, nodeCapacity>
+{
+	static_assert(IsBaseOf<MallocBase, MallocT>::value, "Allocator must be a subclass of MallocBase");
+
+	using Base = UnrolledList<T, void, nodeCapacity>;
+
+public:
+	/**
+	 * Constructs the allocator on
+	 * the stack and passes it to
+	 * the list.
+	 */
+	template<typename ...MallocCreateArgsT>
+	FORCE_INLINE UnrolledList(MallocCreateArgsT && ...mallocCreateArgs)
+		: Base{&autoMalloc}
+		, autoMalloc{forward<MallocCreateArgsT>(mallocCreateArgs)...}
+	{
+		//
+	}
+
+	/**
+	 * Destructor, destroy nodes here,
+	 * because we need the allocator.
+	 */
+	FORCE_INLINE ~UnrolledList()
+	{
+		Base::destroy();
+	}
+
+protected:
+	/// Managed allocator
+	MallocT autoMalloc;
+};
@@ -14,6 +14,8 @@ struct GenericPlatformAtomics
 	enum AtomicOrder
 	{
 		Relaxed,
-		Sequential
+		Sequential,
+		Acquire,
+		Release
 	};
 };
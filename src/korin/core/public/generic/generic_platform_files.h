@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_crt.h"
+
+/**
+ * A read-only view of a file mapped in
+ * memory.
+ */
+struct MappedFileRegion
+{
+	/// Pointer to the first byte, null if
+	/// the file is not mapped
+	const void * data = nullptr;
+
+	/// Size of the region in Bytes
+	uint64 size = 0;
+};
+
+/**
+ * Modes used to open a file.
+ */
+enum class FileOpenMode : ubyte
+{
+	/// Open existing file for reading
+	Read,
+
+	/// Create or truncate file for
+	/// writing
+	Write,
+
+	/// Create file or append to it
+	Append,
+
+	/// Create file or open it for reading
+	/// and writing
+	ReadWrite
+};
+
+/**
+ * Hints about how a file will be
+ * accessed, used to tune readahead.
+ */
+enum class FileAccessHint : ubyte
+{
+	Normal,
+	Sequential,
+	Random
+};
+
+/**
+ * Platform independent file utilities,
+ * implemented with the C standard library.
+ */
+struct GenericPlatformFiles
+{
+	/**
+	 * Writes a buffer to a file, replacing
+	 * its content.
+	 *
+	 * @param path path of the file
+	 * @param data pointer to the bytes
+	 * @param size number of bytes
+	 * @return true if all bytes were
+	 * 	written
+	 */
+	static bool writeFile(const ansichar * path, const void * data, uint64 size)
+	{
+		FILE * fp = ::fopen(path, "wb");
+		if (!fp) return false;
+
+		const bool ok = size == 0 || ::fwrite(data, 1, size, fp) == size;
+		return ::fclose(fp) == 0 && ok;
+	}
+
+	/**
+	 * Deletes a file.
+	 *
+	 * @param path path of the file
+	 * @return true if file was deleted
+	 */
+	static FORCE_INLINE bool deleteFile(const ansichar * path)
+	{
+		return ::remove(path) == 0;
+	}
+
+	/**
+	 * Maps a whole file in memory, read
+	 * only. Not supported by default.
+	 *
+	 * @param path path of the file
+	 * @return mapped region, or an empty
+	 * 	region on failure
+	 */
+	static FORCE_INLINE MappedFileRegion mapFile(const ansichar * path)
+	{
+		return {};
+	}
+
+	/**
+	 * Unmaps a region created by mapFile.
+	 *
+	 * @param region mapped region
+	 */
+	static FORCE_INLINE void unmapFile(const MappedFileRegion & region)
+	{
+		//
+	}
+};
@@ -40,6 +40,19 @@ struct GenericPlatformMemory
 		return ::memmove(dst, src, size);
 	}
 
+	/**
+	 * Fill memory with a byte value
+	 *
+	 * @param [in] dst destination memory
+	 * @param [in] value byte value
+	 * @param [in] size memory size (in Bytes)
+	 * @return destination address
+	 */
+	static FORCE_INLINE void * memset(void * dst, ubyte value, sizet size)
+	{
+		return ::memset(dst, value, size);
+	}
+
 	/**
 	 * Compare two chunks of memory.
 	 * 
@@ -51,11 +64,23 @@ struct GenericPlatformMemory
 	 * 	mem0 is greater than the corresponding
 	 * 	byte in mem1
 	 */
-	static FORCE_INLINE bool memcmp(const void * mem0, const void * mem1, sizet size)
+	static FORCE_INLINE int32 memcmp(const void * mem0, const void * mem1, sizet size)
 	{
 		return ::memcmp(mem0, mem1, size);
 	}
 
+	/**
+	 * Hints the processor to fetch the
+	 * cache line that contains the given
+	 * address, ahead of an access.
+	 * 
+	 * @param ptr address to prefetch
+	 */
+	static FORCE_INLINE void prefetch(const void * ptr)
+	{
+		__builtin_prefetch(ptr);
+	}
+
 	/**
 	 * Default constructs elements in range
 	 * 
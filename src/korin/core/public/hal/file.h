@@ -0,0 +1,403 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "templates/string_view.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "platform_memory.h"
+#include "platform_files.h"
+
+/**
+ * A file with buffered sequential reads
+ * and writes. Reads and writes larger than
+ * the buffer go straight to the file.
+ *
+ * ```cpp
+ * File file{"data.csv"};
+ * file.setAccessHint(FileAccessHint::Sequential);
+ *
+ * StringView chunk;
+ * while (file.readInto(chunk)) process(chunk);
+ * ```
+ *
+ * The buffer is allocated with the
+ * gMalloc set when the file is created.
+ */
+class File
+{
+public:
+	using FileHandle = PlatformFiles::FileHandle;
+
+	/// Default size of the buffer
+	static constexpr uint64 defaultBufferSize = 1 << 18;
+
+	/**
+	 * Creates a closed file.
+	 */
+	File();
+
+	/**
+	 * Opens a file.
+	 *
+	 * @param path path of the file
+	 * @param [mode] open mode
+	 * @param [bufferSize] size of the
+	 * 	buffer in Bytes
+	 */
+	explicit File(const ansichar * path, FileOpenMode mode = FileOpenMode::Read, uint64 bufferSize = defaultBufferSize);
+
+	File(const File&) = delete;
+	File & operator=(const File&) = delete;
+
+	/**
+	 * Move constructor.
+	 */
+	File(File && other);
+
+	/**
+	 * Flushes and closes the file.
+	 */
+	~File();
+
+	/**
+	 * Opens a file, closing the current
+	 * one.
+	 *
+	 * @see File
+	 * @return true if file was opened
+	 */
+	bool open(const ansichar * path, FileOpenMode mode = FileOpenMode::Read, uint64 bufferSize = defaultBufferSize);
+
+	/**
+	 * Flushes and closes the file.
+	 *
+	 * @return true if no error occured
+	 */
+	bool close();
+
+	/**
+	 * Returns true if file is open.
+	 */
+	FORCE_INLINE bool isOpen() const
+	{
+		return handle != PlatformFiles::invalidHandle;
+	}
+
+	/**
+	 * Returns true if a read or write
+	 * failed.
+	 */
+	FORCE_INLINE bool hasError() const
+	{
+		return error;
+	}
+
+	/**
+	 * Returns the platform handle of the
+	 * file.
+	 */
+	FORCE_INLINE FileHandle getHandle() const
+	{
+		return handle;
+	}
+
+	/**
+	 * Returns the current position.
+	 */
+	FORCE_INLINE uint64 tell() const
+	{
+		return writing ? filePos + bufferEnd : filePos - (bufferEnd - bufferPos);
+	}
+
+	/**
+	 * Returns the size of the file,
+	 * including buffered writes.
+	 */
+	uint64 getSize() const;
+
+	/**
+	 * Moves the current position. Seeking
+	 * inside the read buffer keeps the
+	 * buffer.
+	 *
+	 * @param pos new position
+	 * @return true on success
+	 */
+	bool seek(uint64 pos);
+
+	/**
+	 * Reads bytes from the current
+	 * position.
+	 *
+	 * @param dst destination buffer
+	 * @param size number of bytes
+	 * @return number of bytes read, less
+	 * 	than size at the end of the file
+	 */
+	uint64 read(void * dst, uint64 size);
+
+	/**
+	 * Reads up to maxSize bytes and returns
+	 * a view of them inside the buffer,
+	 * without copying. The view is valid
+	 * until the next call.
+	 *
+	 * @param outView view of the bytes
+	 * @param [maxSize] max number of bytes
+	 * @return true if any byte was read
+	 */
+	bool readInto(StringView & outView, uint64 maxSize = ~0ull);
+
+	/**
+	 * Appends the rest of the file to an
+	 * array or a string. The bytes are
+	 * read directly into the container.
+	 *
+	 * @param out container to append to
+	 * @return number of bytes read
+	 * @{
+	 */
+	template<typename T, typename MallocT>
+	uint64 readAll(Array<T, MallocT> & out)
+	{
+		static_assert(sizeof(T) == 1, "Array items must be bytes");
+
+		const uint64 pos = tell(), size = getSize();
+		const uint64 count = out.getCount();
+		const uint64 expected = size > pos ? size - pos : 0;
+
+		out.reserve(count + expected);
+		out.resize(count + expected);
+
+		uint64 numRead = count + read(*out + count, expected);
+		out.resize(numRead);
+
+		// The file may have grown since
+		StringView view;
+		while (numRead == count + expected && readInto(view))
+		{
+			out.resize(out.getCount() + view.getLength());
+			Memory::memcpy(*out + out.getCount() - view.getLength(), *view, view.getLength());
+		}
+
+		return out.getCount() - count;
+	}
+
+	uint64 readAll(String & out);
+	/// @}
+
+	/**
+	 * Writes bytes at the current
+	 * position.
+	 *
+	 * @param src source buffer
+	 * @param size number of bytes
+	 * @return number of bytes written
+	 * @{
+	 */
+	uint64 write(const void * src, uint64 size);
+
+	FORCE_INLINE uint64 write(const StringView & string)
+	{
+		return write(*string, string.getLength());
+	}
+	/// @}
+
+	/**
+	 * Writes buffered bytes to the file.
+	 *
+	 * @return true if no error occured
+	 */
+	bool flush();
+
+	/**
+	 * Reads or writes at the given offset,
+	 * bypassing the buffer and without
+	 * moving the current position.
+	 *
+	 * @param data buffer
+	 * @param size number of bytes
+	 * @param offset offset in the file
+	 * @return number of bytes, or -1 on
+	 * 	error
+	 * @{
+	 */
+	FORCE_INLINE int64 readAt(void * dst, uint64 size, uint64 offset) const
+	{
+		return PlatformFiles::readAt(handle, dst, size, offset);
+	}
+
+	int64 writeAt(const void * src, uint64 size, uint64 offset);
+	/// @}
+
+	/**
+	 * Tells the system how the file will
+	 * be read. Sequential files are also
+	 * prefetched one buffer ahead.
+	 *
+	 * @param inHint access pattern
+	 */
+	void setAccessHint(FileAccessHint inHint);
+
+	/**
+	 * Starts reading a range of the file
+	 * in the background.
+	 *
+	 * @param offset,size range to read
+	 */
+	FORCE_INLINE void prefetch(uint64 offset, uint64 size) const
+	{
+		PlatformFiles::prefetch(handle, offset, size);
+	}
+
+protected:
+	/**
+	 * Drops the read buffer and moves the
+	 * file to the current position, before
+	 * writing.
+	 */
+	bool beginWrite();
+
+	/**
+	 * Reads the next chunk of the file into
+	 * the buffer.
+	 *
+	 * @return true if any byte was read
+	 */
+	bool fillBuffer();
+
+	/// Platform handle
+	FileHandle handle;
+
+	/// Allocator of the buffer
+	MallocBase * malloc;
+
+	/// Buffer memory
+	ubyte * buffer;
+
+	/// Size of the buffer
+	uint64 bufferSize;
+
+	/// Position of the next byte to read
+	/// in the buffer
+	uint64 bufferPos;
+
+	/// End of the valid bytes in the
+	/// buffer
+	uint64 bufferEnd;
+
+	/// Position of the platform file
+	uint64 filePos;
+
+	/// True if buffer holds bytes to write
+	bool writing;
+
+	/// True if a read or write failed
+	bool error;
+
+	/// Access hint
+	FileAccessHint hint;
+};
+
+/**
+ * A read or write of a range of a file,
+ * submitted in a batch.
+ */
+struct FileIORequest
+{
+	/// Buffer to read into or write from
+	void * data = nullptr;
+
+	/// Number of bytes
+	uint64 size = 0;
+
+	/// Offset in the file
+	uint64 offset = 0;
+
+	/// Number of bytes transferred, or a
+	/// negative error code
+	int64 result = 0;
+};
+
+/**
+ * Runs batches of reads and writes at
+ * random offsets, with many requests in
+ * flight at once. Uses io_uring where the
+ * kernel supports it, otherwise runs the
+ * requests with pread and pwrite. If the
+ * ring fails, the requests in flight are
+ * waited for, the ring is released and
+ * the rest of the batch, and following
+ * batches, use pread and pwrite.
+ */
+class AsyncFileIO
+{
+public:
+	/**
+	 * Creates the submission queue.
+	 *
+	 * @param [queueDepth] max number of
+	 * 	requests in flight
+	 * @param [useIoUring] if false always
+	 * 	use pread and pwrite
+	 */
+	explicit AsyncFileIO(uint32 queueDepth = 64, bool useIoUring = true);
+
+	AsyncFileIO(const AsyncFileIO&) = delete;
+	AsyncFileIO & operator=(const AsyncFileIO&) = delete;
+
+	/**
+	 * Destroys the submission queue.
+	 */
+	~AsyncFileIO();
+
+	/**
+	 * Returns true if requests run on
+	 * io_uring.
+	 */
+	FORCE_INLINE bool isUsingIoUring() const
+	{
+		return ring != nullptr;
+	}
+
+	/**
+	 * Runs a batch of reads and waits for
+	 * all of them. Short reads only happen
+	 * at the end of the file.
+	 *
+	 * @param file file to read
+	 * @param requests reads to run
+	 * @param n number of requests
+	 * @return true if no read failed
+	 */
+	bool read(const File & file, FileIORequest * requests, uint64 n);
+
+	/**
+	 * Runs a batch of writes and waits for
+	 * all of them. The file is flushed
+	 * first.
+	 *
+	 * @param file file to write
+	 * @param requests writes to run
+	 * @param n number of requests
+	 * @return true if no write failed
+	 */
+	bool write(File & file, FileIORequest * requests, uint64 n);
+
+protected:
+	/// Rings shared with the kernel
+	struct Ring;
+
+	/**
+	 * Runs a batch on the ring or with
+	 * blocking calls.
+	 * @{
+	 */
+	bool runRing(File::FileHandle handle, FileIORequest * requests, uint64 n, bool isWrite);
+	bool runBlocking(File::FileHandle handle, FileIORequest * requests, uint64 n, bool isWrite);
+	/// @}
+
+	/// The ring, or null if not supported
+	Ring * ring;
+};
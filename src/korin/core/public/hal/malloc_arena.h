@@ -0,0 +1,142 @@
+#pragma once
+
+#include "core_types.h"
+#include "memory_base.h"
+
+/**
+ * A bump allocator. Memory is taken from
+ * large blocks in order and is only
+ * released all at once, when the arena is
+ * reset or destroyed. free is a no-op.
+ *
+ * Useful for many small allocations that
+ * share a lifetime, like the strings of a
+ * parsed document.
+ *
+ * Blocks are requested to the allocator
+ * given at construction, gMalloc by
+ * default, so an arena can be installed
+ * as gMalloc itself.
+ */
+class MallocArena final : public MallocBase
+{
+public:
+	/// Default size of a block
+	static constexpr sizet defaultBlockSize = 1 << 16;
+
+	/**
+	 * Creates an empty arena.
+	 *
+	 * @param [inBlockSize] size of the
+	 * 	blocks
+	 * @param [inMalloc] allocator that
+	 * 	serves the blocks
+	 */
+	explicit MallocArena(sizet inBlockSize = defaultBlockSize, MallocBase * inMalloc = gMalloc);
+
+	MallocArena(const MallocArena&) = delete;
+	MallocArena & operator=(const MallocArena&) = delete;
+
+	/**
+	 * Move constructor.
+	 */
+	MallocArena(MallocArena && other);
+
+	/**
+	 * Move assignment, releases the memory
+	 * of this arena.
+	 */
+	MallocArena & operator=(MallocArena && other);
+
+	/**
+	 * Releases all blocks.
+	 */
+	virtual ~MallocArena() override;
+
+	/**
+	 * Returns the number of bytes
+	 * allocated, excluding padding.
+	 */
+	FORCE_INLINE sizet getNumBytes() const
+	{
+		return numBytes;
+	}
+
+	/**
+	 * Releases all blocks. All memory
+	 * allocated by the arena becomes
+	 * invalid.
+	 */
+	void reset();
+
+	/**
+	 * Takes the blocks of another arena,
+	 * which is left empty. Memory allocated
+	 * by the other arena stays valid. Both
+	 * arenas must use the same allocator.
+	 *
+	 * @param other arena to take blocks
+	 * 	from
+	 */
+	void absorb(MallocArena & other);
+
+	//////////////////////////////////////////////////
+	// MallocBase interface
+	//////////////////////////////////////////////////
+
+	virtual FORCE_INLINE void * alloc(sizet size, sizet alignment = DEFAULT_ALIGNMENT) override
+	{
+		ubyte * out = reinterpret_cast<ubyte*>((reinterpret_cast<uintp>(cursor) + alignment - 1) & ~(alignment - 1));
+		if (UNLIKELY(!cursor || out + size > limit)) return allocSlow(size, alignment);
+
+		cursor = out + size;
+		numBytes += size;
+
+		return lastAlloc = out;
+	}
+
+	virtual void * realloc(void * orig, sizet size, sizet alignment = DEFAULT_ALIGNMENT) override;
+	virtual void free(void * orig) override;
+
+protected:
+	/**
+	 * Header at the start of each block.
+	 */
+	struct Block
+	{
+		/// Next block in the list
+		Block * next;
+
+		/// Size of the block, including the
+		/// header
+		sizet size;
+	};
+
+	/**
+	 * Allocates a new block, large enough
+	 * for the given allocation.
+	 */
+	void * allocSlow(sizet size, sizet alignment);
+
+	/// Allocator that serves the blocks
+	MallocBase * malloc;
+
+	/// Size of new blocks
+	sizet blockSize;
+
+	/// List of blocks, the current block
+	/// is the first
+	Block * blocks;
+
+	/// Next free byte in current block
+	ubyte * cursor;
+
+	/// End of current block
+	ubyte * limit;
+
+	/// Last allocation, can grow in place
+	void * lastAlloc;
+
+	/// Allocated bytes
+	sizet numBytes;
+};
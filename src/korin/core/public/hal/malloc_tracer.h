@@ -0,0 +1,335 @@
+#pragma once
+
+#include "core_types.h"
+#include "memory_base.h"
+#include "../containers/array.h"
+#include "../templates/spin_lock.h"
+
+class File;
+
+/**
+ * Allocator that forwards requests to
+ * another allocator and records them in a
+ * binary trace file, to be replayed with
+ * MallocTrace. Install it as the global
+ * allocator to trace a whole process:
+ *
+ * ```cpp
+ * File file{"malloc.trace", FileOpenMode::Write};
+ * MallocTracer tracer{gMalloc, file};
+ *
+ * MallocBase * prev = gMalloc;
+ * gMalloc = &tracer;
+ * run();
+ * gMalloc = prev;
+ * ```
+ *
+ * The file must be created before the
+ * tracer is installed, since it allocates
+ * its buffer. Requests are serialized with
+ * a spin lock.
+ *
+ * Each record is an op Byte, with the type
+ * in the low 2 bits and the log2 of the
+ * alignment in the high 6 bits, followed by
+ * varints: the zigzag delta of the pointer
+ * from the previous one, for realloc and
+ * free the original pointer, and for alloc
+ * and realloc the size and the returned
+ * pointer.
+ */
+class MallocTracer : public MallocBase
+{
+public:
+	/// Trace file magic, "KMTR"
+	static constexpr uint32 magic = 0x52544d4b;
+
+	/// Trace file version
+	static constexpr ubyte version = 1;
+
+	/**
+	 * Op types.
+	 */
+	enum OpType : ubyte
+	{
+		Alloc = 1,
+		Realloc = 2,
+		Free = 3
+	};
+
+	/**
+	 * Creates a tracer and writes the
+	 * file header.
+	 *
+	 * @param inMalloc allocator that
+	 * 	serves the requests
+	 * @param inFile file open for writing
+	 */
+	MallocTracer(MallocBase * inMalloc, File & inFile);
+
+	/**
+	 * Returns the number of recorded
+	 * requests.
+	 */
+	FORCE_INLINE uint64 getNumRecords() const
+	{
+		return numRecords;
+	}
+
+	//////////////////////////////////////////////////
+	// MallocBase interface
+	//////////////////////////////////////////////////
+
+	virtual void * alloc(sizet size, sizet alignment = DEFAULT_ALIGNMENT) override;
+	virtual void * realloc(void * orig, sizet size, sizet alignment = DEFAULT_ALIGNMENT) override;
+	virtual void free(void * orig) override;
+
+protected:
+	/**
+	 * Writes a record.
+	 */
+	void record(OpType type, sizet alignment, const void * orig, sizet size, const void * out);
+
+	/**
+	 * Appends a varint to the given
+	 * buffer, returns the end.
+	 */
+	static FORCE_INLINE ubyte * putVarint(ubyte * it, uint64 value)
+	{
+		while (value >= 0x80)
+		{
+			*it++ = static_cast<ubyte>(value) | 0x80;
+			value >>= 7;
+		}
+
+		*it++ = static_cast<ubyte>(value);
+		return it;
+	}
+
+	/**
+	 * Appends the zigzag delta of a
+	 * pointer from the previous one.
+	 */
+	FORCE_INLINE ubyte * putPointer(ubyte * it, const void * ptr)
+	{
+		const int64 delta = static_cast<int64>(reinterpret_cast<uintp>(ptr) - prevPtr);
+		prevPtr = reinterpret_cast<uintp>(ptr);
+
+		return putVarint(it, (static_cast<uint64>(delta) << 1) ^ static_cast<uint64>(delta >> 63));
+	}
+
+	/// Allocator that serves the requests
+	MallocBase * malloc;
+
+	/// Trace file
+	File & file;
+
+	/// Serializes requests
+	SpinLock lock;
+
+	/// Previous pointer
+	uintp prevPtr;
+
+	/// Number of records
+	uint64 numRecords;
+};
+
+/**
+ * A request of an allocation trace. Blocks
+ * are identified by a slot, slots of freed
+ * blocks are reused.
+ */
+struct MallocTraceOp
+{
+	/// Requested size
+	sizet size;
+
+	/// Block slot
+	uint32 slot;
+
+	/// Op type
+	MallocTracer::OpType type;
+
+	/// Log2 of the alignment
+	ubyte alignmentLog2;
+};
+
+/**
+ * An allocation trace recorded by
+ * MallocTracer, decoded for replay. Requests
+ * that failed when recorded and frees of
+ * unknown blocks are dropped.
+ */
+class MallocTrace
+{
+public:
+	/**
+	 * Creates an empty trace.
+	 */
+	MallocTrace();
+
+	/**
+	 * Decodes a trace.
+	 *
+	 * @return false if the data is not a
+	 * 	valid trace
+	 * @{
+	 */
+	bool load(const ubyte * data, sizet size);
+	bool load(File & file);
+	/// @}
+
+	/**
+	 * Returns the requests.
+	 */
+	FORCE_INLINE const Array<MallocTraceOp> & getOps() const
+	{
+		return ops;
+	}
+
+	/**
+	 * Returns the max number of live
+	 * blocks.
+	 */
+	FORCE_INLINE uint32 getNumSlots() const
+	{
+		return numSlots;
+	}
+
+	/**
+	 * Returns the max number of live
+	 * requested Bytes.
+	 */
+	FORCE_INLINE uint64 getPeakBytes() const
+	{
+		return peakBytes;
+	}
+
+	/**
+	 * Returns the largest request.
+	 */
+	FORCE_INLINE sizet getMaxSize() const
+	{
+		return maxSize;
+	}
+
+protected:
+	/// Decoded requests
+	Array<MallocTraceOp> ops;
+
+	/// Max number of live blocks
+	uint32 numSlots;
+
+	/// Max live requested Bytes
+	uint64 peakBytes;
+
+	/// Largest request
+	sizet maxSize;
+};
+
+/**
+ * Replays a trace against an allocator.
+ * Each new block is written once per page,
+ * like a program filling its data, so that
+ * resident memory can be compared. Blocks
+ * still live when the replay is destroyed
+ * are freed.
+ *
+ * ```cpp
+ * MallocReplay replay{trace, allocator};
+ * while (!replay.isDone())
+ * {
+ * 	replay.run(4096);
+ * 	sampleRss();
+ * }
+ * ```
+ */
+class MallocReplay
+{
+public:
+	/**
+	 * Creates a replay.
+	 *
+	 * @param inTrace trace to replay
+	 * @param inMalloc allocator to test
+	 */
+	MallocReplay(const MallocTrace & inTrace, MallocBase & inMalloc);
+
+	MallocReplay(const MallocReplay&) = delete;
+	MallocReplay & operator=(const MallocReplay&) = delete;
+
+	/**
+	 * Frees the live blocks.
+	 */
+	~MallocReplay();
+
+	/**
+	 * Replays the next requests.
+	 *
+	 * @param maxNumOps max number of
+	 * 	requests to replay
+	 * @return number of replayed requests
+	 */
+	uint64 run(uint64 maxNumOps = ~0ull);
+
+	/**
+	 * Returns true if all requests were
+	 * replayed.
+	 */
+	FORCE_INLINE bool isDone() const
+	{
+		return next == trace.getOps().getCount();
+	}
+
+	/**
+	 * Returns the number of requests the
+	 * allocator failed.
+	 */
+	FORCE_INLINE uint64 getNumFailed() const
+	{
+		return numFailed;
+	}
+
+	/**
+	 * Returns the number of live requested
+	 * Bytes.
+	 */
+	FORCE_INLINE uint64 getLiveBytes() const
+	{
+		return liveBytes;
+	}
+
+protected:
+	/**
+	 * Writes a Byte in each page of a
+	 * block, from the given offset.
+	 */
+	static FORCE_INLINE void touch(void * block, sizet begin, sizet end)
+	{
+		ubyte * bytes = static_cast<ubyte*>(block);
+		for (sizet offset = begin; offset < end; offset += 4096) bytes[offset] = static_cast<ubyte>(offset);
+	}
+
+	/// Replayed trace
+	const MallocTrace & trace;
+
+	/// Tested allocator
+	MallocBase & malloc;
+
+	/// Allocator of the slots, gMalloc at
+	/// construction
+	MallocBase * slotMalloc;
+
+	/// Block and size of each slot
+	void ** blocks;
+	sizet * sizes;
+
+	/// Next request
+	uint64 next;
+
+	/// Number of failed requests
+	uint64 numFailed;
+
+	/// Live requested Bytes
+	uint64 liveBytes;
+};
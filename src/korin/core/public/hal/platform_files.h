@@ -0,0 +1,13 @@
+#pragma once
+
+#include "core_types.h"
+
+#if PLATFORM_WINDOWS
+	#include "windows/windows_platform_files.h"
+#elif PLATFORM_APPLE
+	#include "apple/apple_platform_files.h"
+#elif PLATFORM_LINUX
+	#include "linux/linux_platform_files.h"
+#else
+	#error "Unknown platform"
+#endif
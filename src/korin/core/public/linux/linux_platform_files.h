@@ -0,0 +1,13 @@
+#pragma once
+
+#include "unix/unix_platform_files.h"
+
+/**
+ * Linux specific file utilities
+ */
+struct LinuxPlatformFiles : public UnixPlatformFiles
+{
+	//
+};
+
+using PlatformFiles = LinuxPlatformFiles;
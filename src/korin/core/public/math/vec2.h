@@ -3,6 +3,7 @@
 #include "core_types.h"
 #include "misc/assert.h"
 #include "hal/platform_math.h"
+#include "templates/hash.h"
 #include "math_types.h"
 
 /**
@@ -384,4 +385,17 @@ template<>
 FORCE_INLINE float32 Vec2<float32>::getSize() const
 {
 	return PlatformMath::sqrt(getSquaredSize());
-}
\ No newline at end of file
+}
+
+/**
+ * Hash of vectors, combines the hashes
+ * of the components.
+ */
+template<typename T>
+struct Hash<Vec2<T>>
+{
+	FORCE_INLINE uint64 operator()(const Vec2<T> & v) const
+	{
+		return HashUtils::hashValues(v.x, v.y);
+	}
+};
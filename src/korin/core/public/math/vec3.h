@@ -3,6 +3,7 @@
 #include "core_types.h"
 #include "misc/assert.h"
 #include "hal/platform_math.h"
+#include "templates/hash.h"
 #include "math_types.h"
 
 /**
@@ -421,4 +422,17 @@ template<>
 FORCE_INLINE bool Vec3<float32>::isNearlyZero() const
 {
 	return getSquaredSize() < 4 * FLT_EPSILON;
-}
\ No newline at end of file
+}
+
+/**
+ * Hash of vectors, combines the hashes
+ * of the components.
+ */
+template<typename T>
+struct Hash<Vec3<T>>
+{
+	FORCE_INLINE uint64 operator()(const Vec3<T> & v) const
+	{
+		return HashUtils::hashValues(v.x, v.y, v.z);
+	}
+};
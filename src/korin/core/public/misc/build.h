@@ -11,4 +11,9 @@
 
 #ifndef BUILD_RELEASE
 	#define BUILD_RELEASE 0
-#endif
\ No newline at end of file
+#endif
+
+// Set to one to compile scoped timers in
+#ifndef BUILD_TRACE
+	#define BUILD_TRACE 0
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "core_types.h"
+
+/**
+ * Events counted by PerfCounters.
+ */
+enum class PerfEvent : ubyte
+{
+	Cycles,
+	Instructions,
+	CacheMisses,
+	BranchMisses,
+	L1DMisses,
+	DTlbMisses,
+	PageFaults,
+	TaskClock,
+	Count
+};
+
+/**
+ * Reads the hardware and software
+ * performance counters of the calling
+ * thread, with perf_event_open on Linux.
+ * Each event is opened on its own, so
+ * events the CPU or the kernel don't
+ * support are skipped, e.g. hardware
+ * events in most virtual machines. If the
+ * kernel multiplexes events, the counts
+ * are scaled by the time each event ran.
+ *
+ * ```cpp
+ * PerfCounters counters;
+ * counters.start();
+ * work();
+ * counters.stop();
+ *
+ * if (counters.isAvailable(PerfEvent::Instructions))
+ * 	printf("IPC %.2f\n", counters.getIpc());
+ * ```
+ *
+ * Counters exclude the kernel, so they can
+ * be read with the default paranoid level
+ * of 2.
+ */
+class PerfCounters
+{
+public:
+	/// Number of events
+	static constexpr uint32 numEvents = static_cast<uint32>(PerfEvent::Count);
+
+	/**
+	 * Opens the counters of the calling
+	 * thread.
+	 */
+	PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters & operator=(const PerfCounters&) = delete;
+
+	/**
+	 * Closes the counters.
+	 */
+	~PerfCounters();
+
+	/**
+	 * Returns true if the event can be
+	 * counted.
+	 */
+	FORCE_INLINE bool isAvailable(PerfEvent event) const
+	{
+		return fds[static_cast<uint32>(event)] >= 0;
+	}
+
+	/**
+	 * Returns true if any event can be
+	 * counted.
+	 */
+	bool isAnyAvailable() const;
+
+	/**
+	 * Resets and enables all counters.
+	 */
+	void start();
+
+	/**
+	 * Disables all counters and reads
+	 * their values.
+	 */
+	void stop();
+
+	/**
+	 * Returns the value of a counter read
+	 * by the last stop, 0 if the event is
+	 * not available. Task clock is in
+	 * nanoseconds.
+	 */
+	FORCE_INLINE uint64 get(PerfEvent event) const
+	{
+		return values[static_cast<uint32>(event)];
+	}
+
+	/**
+	 * Returns the instructions per cycle,
+	 * 0 if not available.
+	 */
+	FORCE_INLINE float64 getIpc() const
+	{
+		const uint64 cycles = get(PerfEvent::Cycles);
+		return cycles ? static_cast<float64>(get(PerfEvent::Instructions)) / cycles : 0.0;
+	}
+
+	/**
+	 * Returns the short name of an event,
+	 * e.g. "cycles" or "dtlb-misses".
+	 */
+	static const ansichar * getName(PerfEvent event);
+
+protected:
+	/// Event file descriptors, -1 if not
+	/// available
+	int32 fds[numEvents];
+
+	/// Values read by the last stop
+	uint64 values[numEvents];
+};
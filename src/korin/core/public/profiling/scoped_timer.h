@@ -0,0 +1,228 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_atomics.h"
+
+#if !defined(__x86_64__) && !defined(__i386__)
+	#include <time.h>
+#endif
+
+/**
+ * Times the enclosing scope and records
+ * it in the trace of the calling thread.
+ * The name must be a string literal, or
+ * any string that outlives the trace.
+ * Expands to nothing unless the build
+ * defines BUILD_TRACE:
+ *
+ * ```cpp
+ * void rebuild()
+ * {
+ * 	SCOPED_TIMER("Index::rebuild");
+ * 	...
+ * }
+ * ```
+ */
+#if BUILD_TRACE
+	#define SCOPED_TIMER(name) ScopedTimer TRACE_CONCAT(scopedTimer, __LINE__){name}
+#else
+	#define SCOPED_TIMER(name)
+#endif
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * A timed scope.
+ */
+struct TraceEvent
+{
+	/// Scope name
+	const ansichar * name;
+
+	/// Ticks at scope entry and exit
+	uint64 begin, end;
+};
+
+/**
+ * Events recorded by a thread. Events are
+ * stored in chunks, only the owner thread
+ * appends to them and publishes the count
+ * with a release store, so readers can
+ * collect the trace while it runs.
+ */
+struct TraceBuffer
+{
+	/// Number of events per chunk
+	static constexpr uint32 chunkSize = 1 << 12;
+
+	/// Max number of chunks per thread
+	static constexpr uint32 maxNumChunks = 256;
+
+	/**
+	 * A chunk of events.
+	 */
+	struct Chunk
+	{
+		/// Next chunk
+		Chunk * next;
+
+		/// Number of published events
+		uint32 numEvents;
+
+		/// Events
+		TraceEvent events[chunkSize];
+	};
+
+	/// Next buffer in the global list
+	TraceBuffer * next;
+
+	/// First and last chunks
+	Chunk * head, * tail;
+
+	/// Number of chunks
+	uint32 numChunks;
+
+	/// Number of events dropped because
+	/// the buffer was full
+	uint64 numDropped;
+
+	/// Trace thread id
+	uint32 threadId;
+
+	/// Thread name, empty if not set
+	ansichar threadName[64];
+};
+
+/**
+ * Records the scopes timed by
+ * ScopedTimer. See Trace for reading the
+ * recorded events.
+ */
+struct TraceRecorder
+{
+	/**
+	 * Returns the current tick count.
+	 * On x86 it reads the timestamp
+	 * counter, which runs at a constant
+	 * rate on modern CPUs, elsewhere it
+	 * returns nanoseconds.
+	 */
+	static FORCE_INLINE uint64 now()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __builtin_ia32_rdtsc();
+#else
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+	}
+
+	/**
+	 * Enables or disables recording at
+	 * runtime. Enabled by default.
+	 * @{
+	 */
+	static FORCE_INLINE void setEnabled(bool value)
+	{
+		PlatformAtomics::store<PlatformAtomics::AtomicOrder::Relaxed>(&enabled, value);
+	}
+
+	static FORCE_INLINE bool isEnabled()
+	{
+		return PlatformAtomics::read<PlatformAtomics::AtomicOrder::Relaxed>(&enabled);
+	}
+	/// @}
+
+	/**
+	 * Records a scope in the trace of the
+	 * calling thread.
+	 *
+	 * @param name scope name, must outlive
+	 * 	the trace
+	 * @param begin,end ticks at scope entry
+	 * 	and exit
+	 */
+	static FORCE_INLINE void record(const ansichar * name, uint64 begin, uint64 end)
+	{
+		if (UNLIKELY(!isEnabled())) return;
+
+		TraceBuffer * buffer = threadBuffer;
+		if (UNLIKELY(!buffer)) buffer = createBuffer();
+
+		TraceBuffer::Chunk * chunk = buffer->tail;
+		uint32 numEvents = chunk->numEvents;
+		if (UNLIKELY(numEvents == TraceBuffer::chunkSize))
+		{
+			chunk = addChunk(buffer);
+			if (UNLIKELY(!chunk)) return;
+
+			numEvents = 0;
+		}
+
+		chunk->events[numEvents] = TraceEvent{name, begin, end};
+		PlatformAtomics::store<PlatformAtomics::AtomicOrder::Release>(&chunk->numEvents, numEvents + 1);
+	}
+
+protected:
+	/**
+	 * Creates the buffer of the calling
+	 * thread and adds it to the global
+	 * list.
+	 */
+	static TraceBuffer * createBuffer();
+
+	/**
+	 * Appends a chunk to the buffer.
+	 * Returns null and counts the event as
+	 * dropped if the buffer is full.
+	 */
+	static TraceBuffer::Chunk * addChunk(TraceBuffer * buffer);
+
+	/// Buffer of the calling thread
+	static inline thread_local TraceBuffer * threadBuffer = nullptr;
+
+	/// Head of the global list of buffers
+	static inline TraceBuffer * volatile buffers = nullptr;
+
+	/// True if recording is enabled
+	static inline volatile bool enabled = true;
+};
+
+/**
+ * Records the time spent in its scope.
+ * Use SCOPED_TIMER, which is removed when
+ * tracing is disabled.
+ */
+class ScopedTimer
+{
+public:
+	/**
+	 * Starts the timer.
+	 */
+	explicit FORCE_INLINE ScopedTimer(const ansichar * inName)
+		: name{inName}
+		, begin{TraceRecorder::now()}
+	{
+		//
+	}
+
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer & operator=(const ScopedTimer&) = delete;
+
+	/**
+	 * Records the scope.
+	 */
+	FORCE_INLINE ~ScopedTimer()
+	{
+		TraceRecorder::record(name, begin, TraceRecorder::now());
+	}
+
+protected:
+	/// Scope name
+	const ansichar * name;
+
+	/// Ticks at scope entry
+	uint64 begin;
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_math.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "./scoped_timer.h"
+
+class File;
+class JsonWriter;
+
+/**
+ * Histogram of scope durations, in
+ * nanoseconds. Buckets are log-linear:
+ * each power of two is split in 8
+ * buckets, so percentiles are within
+ * 12.5% of the true value.
+ */
+class TraceHistogram
+{
+public:
+	/// Number of buckets per power of two
+	static constexpr uint32 numSubBuckets = 8;
+
+	/// Total number of buckets
+	static constexpr uint32 numBuckets = (64 - 2) * numSubBuckets;
+
+	/**
+	 * Creates an empty histogram.
+	 */
+	FORCE_INLINE TraceHistogram()
+		: count{0}
+		, total{0}
+		, min{~0ull}
+		, max{0}
+		, buckets{}
+	{
+		//
+	}
+
+	/**
+	 * Adds a duration.
+	 */
+	FORCE_INLINE void add(uint64 ns)
+	{
+		++count;
+		total += ns;
+		min = PlatformMath::min(min, ns);
+		max = PlatformMath::max(max, ns);
+		++buckets[getBucketIdx(ns)];
+	}
+
+	/**
+	 * Returns the number of durations.
+	 */
+	FORCE_INLINE uint64 getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * Returns the sum of all durations.
+	 */
+	FORCE_INLINE uint64 getTotal() const
+	{
+		return total;
+	}
+
+	/**
+	 * Returns the shortest and longest
+	 * durations, 0 if empty.
+	 * @{
+	 */
+	FORCE_INLINE uint64 getMin() const
+	{
+		return count ? min : 0;
+	}
+
+	FORCE_INLINE uint64 getMax() const
+	{
+		return max;
+	}
+	/// @}
+
+	/**
+	 * Returns the mean duration.
+	 */
+	FORCE_INLINE float64 getMean() const
+	{
+		return count ? static_cast<float64>(total) / count : 0.0;
+	}
+
+	/**
+	 * Returns an estimate of the given
+	 * percentile, the midpoint of the
+	 * bucket that contains it. The 100th
+	 * percentile is exact.
+	 *
+	 * @param p percentile in [0, 1]
+	 */
+	uint64 getPercentile(float64 p) const
+	{
+		if (count == 0) return 0;
+
+		const uint64 rank = PlatformMath::max(static_cast<uint64>(p * count + 0.5), 1ull);
+		if (rank >= count) return max;
+
+		uint64 seen = 0;
+
+		for (uint32 idx = 0; idx < numBuckets; ++idx)
+		{
+			seen += buckets[idx];
+			if (seen >= rank)
+			{
+				const uint64 lo = getBucketMin(idx);
+				const uint64 hi = getBucketMin(idx + 1);
+				return PlatformMath::min(PlatformMath::max(lo + (hi - lo) / 2, getMin()), max);
+			}
+		}
+
+		return max;
+	}
+
+	/**
+	 * Returns the number of durations in
+	 * a bucket.
+	 */
+	FORCE_INLINE uint64 getBucketCount(uint32 idx) const
+	{
+		return buckets[idx];
+	}
+
+	/**
+	 * Merges another histogram.
+	 */
+	void merge(const TraceHistogram & other)
+	{
+		count += other.count;
+		total += other.total;
+		min = PlatformMath::min(min, other.min);
+		max = PlatformMath::max(max, other.max);
+
+		for (uint32 idx = 0; idx < numBuckets; ++idx) buckets[idx] += other.buckets[idx];
+	}
+
+	/**
+	 * Returns the index of the bucket of
+	 * the given duration.
+	 */
+	static FORCE_INLINE uint32 getBucketIdx(uint64 ns)
+	{
+		if (ns < numSubBuckets) return static_cast<uint32>(ns);
+
+		// 3 bits after the leading one
+		// select the sub bucket
+		const uint32 msb = 63 - __builtin_clzll(ns);
+		return (msb - 2) * numSubBuckets + ((ns >> (msb - 3)) & (numSubBuckets - 1));
+	}
+
+	/**
+	 * Returns the smallest duration of a
+	 * bucket.
+	 */
+	static FORCE_INLINE uint64 getBucketMin(uint32 idx)
+	{
+		if (idx < numSubBuckets) return idx;
+		if (idx >= numBuckets) return ~0ull;
+
+		const uint32 msb = idx / numSubBuckets + 2;
+		return static_cast<uint64>(numSubBuckets + idx % numSubBuckets) << (msb - 3);
+	}
+
+protected:
+	/// Number of durations
+	uint64 count;
+
+	/// Sum of durations
+	uint64 total;
+
+	/// Shortest and longest durations
+	uint64 min, max;
+
+	/// Durations per bucket
+	uint64 buckets[numBuckets];
+};
+
+/**
+ * Instrumentation of hot paths. Scopes
+ * are timed with the CPU timestamp
+ * counter and recorded in per-thread
+ * buffers, without locks. The recorded
+ * events can be aggregated in per-scope
+ * histograms or exported in the Chrome
+ * trace event format, to be viewed in
+ * chrome://tracing or Perfetto.
+ *
+ * ```cpp
+ * Trace::setThreadName("worker");
+ * { SCOPED_TIMER("work"); work(); }
+ *
+ * Map<String, TraceHistogram> stats;
+ * Trace::collect(stats);
+ * printf("p99 %llu ns\n", stats["work"].getPercentile(0.99));
+ *
+ * File file{"trace.json", FileOpenMode::Write};
+ * Trace::exportChromeTrace(file);
+ * ```
+ */
+struct Trace : public TraceRecorder
+{
+	/**
+	 * Returns the number of ticks per
+	 * second. The first call calibrates
+	 * the counter against the monotonic
+	 * clock, and may wait a few ms.
+	 */
+	static float64 getTicksPerSecond();
+
+	/**
+	 * Converts ticks to nanoseconds.
+	 */
+	static FORCE_INLINE uint64 toNanoseconds(uint64 ticks)
+	{
+		return static_cast<uint64>(ticks * (1e9 / getTicksPerSecond()));
+	}
+
+	/**
+	 * Sets the name of the calling thread,
+	 * shown in the exported trace.
+	 */
+	static void setThreadName(const ansichar * name);
+
+	/**
+	 * Returns the number of recorded
+	 * events, of all threads.
+	 */
+	static uint64 getNumEvents();
+
+	/**
+	 * Returns the number of events dropped
+	 * because a thread buffer was full.
+	 */
+	static uint64 getNumDropped();
+
+	/**
+	 * Removes all the recorded events.
+	 * Must not be called while other
+	 * threads are recording.
+	 */
+	static void reset();
+
+	/**
+	 * Aggregates the recorded events in a
+	 * histogram per scope name. Events are
+	 * added to existing histograms.
+	 *
+	 * @param out map from scope name to
+	 * 	histogram of its durations
+	 */
+	static void collect(Map<String, TraceHistogram> & out);
+
+	/**
+	 * Writes the recorded events as a
+	 * Chrome trace event object, with one
+	 * complete event per scope and the
+	 * thread names as metadata.
+	 * @{
+	 */
+	static void writeChromeTrace(JsonWriter & json);
+	static void exportChromeTrace(String & out);
+	static void exportChromeTrace(File & out);
+	/// @}
+};
@@ -3,6 +3,7 @@
 #include "core_types.h"
 #include "./regex_types.h"
 #include "./automaton.h"
+#include "profiling/scoped_timer.h"
 
 
 
@@ -105,6 +106,7 @@ namespace Re
 		 */
 		FORCE_INLINE bool accept(const ansichar * input) const
 		{
+			SCOPED_TIMER("Regex::accept");
 			return automaton.acceptString(input);
 		}
 
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "templates/enable_if.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+
+class Archive;
+
+/**
+ * Sets value to true if type has a
+ * serialize(Archive&) member function.
+ * @{
+ */
+template<typename T, typename = void>
+struct HasSerializeMember
+{
+	enum {value = false};
+};
+
+template<typename T>
+struct HasSerializeMember<T, decltype(void(declVal<T&>().serialize(declVal<Archive&>())))>
+{
+	enum {value = true};
+};
+/// @}
+
+/**
+ * Sets value to true if values of type T
+ * are serialized by copying their bytes.
+ * That is the case for trivially copyable
+ * types that don't define a serialize
+ * member function, except pointers.
+ *
+ * Arrays of such types are serialized
+ * with a single memory copy.
+ */
+template<typename T>
+struct IsBitwiseSerializable
+{
+	enum {value = IsTriviallyCopyable<T>::value && !IsPointer<T>::value && !HasSerializeMember<T>::value};
+};
+
+/**
+ * Serializes a value with its serialize
+ * member function.
+ *
+ * Types customize their serialization by
+ * defining a `void serialize(Archive&)`
+ * member function. The same function
+ * loads and saves the value:
+ *
+ * ```cpp
+ * void serialize(Archive & ar)
+ * {
+ * 	ar << position << name;
+ * 	if (ar.getVersion() >= 2) ar << color;
+ * }
+ * ```
+ *
+ * Types that can't be changed overload
+ * the free function `serialize(Archive&,
+ * T&)` instead.
+ */
+template<typename T>
+FORCE_INLINE typename EnableIf<HasSerializeMember<T>::value>::Type serialize(Archive & ar, T & value)
+{
+	value.serialize(ar);
+}
+
+/**
+ * Serializes a bitwise serializable
+ * value.
+ */
+template<typename T>
+FORCE_INLINE typename EnableIf<IsBitwiseSerializable<T>::value>::Type serialize(Archive & ar, T & value);
+
+/**
+ * Base class of all archives. An archive
+ * either loads or saves values, with the
+ * same serialize functions. Values are
+ * stored in native byte order.
+ */
+class Archive
+{
+public:
+	/// Magic number at the start of
+	/// archives with a header, "KRNA"
+	static constexpr uint32 headerMagic = 0x414e524b;
+
+	/**
+	 * Creates an archive.
+	 *
+	 * @param inIsLoading true if the
+	 * 	archive loads values
+	 */
+	FORCE_INLINE explicit Archive(bool inIsLoading)
+		: version{0}
+		, loading{inIsLoading}
+		, error{false}
+	{
+		//
+	}
+
+	/**
+	 * Virtual destructor.
+	 */
+	virtual ~Archive()
+	{
+		//
+	}
+
+	/**
+	 * Returns true if the archive loads
+	 * values.
+	 */
+	FORCE_INLINE bool isLoading() const
+	{
+		return loading;
+	}
+
+	/**
+	 * Returns true if the archive saves
+	 * values.
+	 */
+	FORCE_INLINE bool isSaving() const
+	{
+		return !loading;
+	}
+
+	/**
+	 * Returns the version of the data,
+	 * set by serializeHeader.
+	 */
+	FORCE_INLINE uint32 getVersion() const
+	{
+		return version;
+	}
+
+	/**
+	 * Returns true if an error occured,
+	 * e.g. if the data is truncated or
+	 * corrupted. Once an error occurs,
+	 * loaded values are zero or empty.
+	 */
+	FORCE_INLINE bool hasError() const
+	{
+		return error;
+	}
+
+	/**
+	 * Marks the archive as failed.
+	 */
+	FORCE_INLINE void setError()
+	{
+		error = true;
+	}
+
+	/**
+	 * Loads or saves a sequence of bytes.
+	 * If loading fails, the bytes are set
+	 * to zero and the error is set.
+	 *
+	 * @param data pointer to the bytes
+	 * @param size number of bytes
+	 */
+	virtual void serializeBytes(void * data, sizet size) = 0;
+
+	/**
+	 * Returns the number of bytes left to
+	 * load. Loaders use it to reject sizes
+	 * that exceed the data, before they
+	 * allocate memory.
+	 */
+	virtual uint64 getRemainingBytes() const
+	{
+		return static_cast<uint64>(-1);
+	}
+
+	/**
+	 * Loads or saves the header of the
+	 * archive, made of a magic number and
+	 * the version of the data.
+	 *
+	 * When saving, writes the given
+	 * version. When loading, reads the
+	 * version of the data, which can be
+	 * queried with getVersion, and fails
+	 * if the magic number is wrong or the
+	 * version is newer than the given one.
+	 *
+	 * @param inVersion version of the data
+	 * 	when saving, max supported version
+	 * 	when loading
+	 * @return true if header is valid
+	 */
+	bool serializeHeader(uint32 inVersion)
+	{
+		uint32 magic = headerMagic;
+		version = inVersion;
+
+		*this << magic << version;
+
+		if (magic != headerMagic || version > inVersion)
+		{
+			setError();
+			return false;
+		}
+
+		return !error;
+	}
+
+	/**
+	 * Loads or saves a value.
+	 *
+	 * @param value value to serialize
+	 * @return ref to self
+	 */
+	template<typename T>
+	FORCE_INLINE Archive & operator<<(T & value);
+
+	/**
+	 * Saves a value. Fails if the archive
+	 * loads values.
+	 *
+	 * @param value value to save
+	 * @return ref to self
+	 */
+	template<typename T>
+	FORCE_INLINE Archive & operator<<(const T & value);
+
+protected:
+	/// Version of the data
+	uint32 version;
+
+	/// True if loading values
+	bool loading;
+
+	/// True if an error occured
+	bool error;
+};
+
+template<typename T>
+FORCE_INLINE typename EnableIf<IsBitwiseSerializable<T>::value>::Type serialize(Archive & ar, T & value)
+{
+	ar.serializeBytes(&value, sizeof(T));
+}
+
+template<typename T>
+FORCE_INLINE Archive & Archive::operator<<(T & value)
+{
+	serialize(*this, value);
+	return *this;
+}
+
+template<typename T>
+FORCE_INLINE Archive & Archive::operator<<(const T & value)
+{
+	CHECKF(isSaving(), "Cannot load into a const value")
+
+	// Saving does not modify the value
+	serialize(*this, const_cast<T&>(value));
+	return *this;
+}
+
+/**
+ * Loads or saves n values. Bitwise
+ * serializable values are copied with a
+ * single call.
+ *
+ * @param ar archive
+ * @param items pointer to the values
+ * @param n number of values
+ * @{
+ */
+template<typename T>
+FORCE_INLINE typename EnableIf<IsBitwiseSerializable<T>::value>::Type serializeItems(Archive & ar, T * items, uint64 n)
+{
+	if (n > 0) ar.serializeBytes(items, n * sizeof(T));
+}
+
+template<typename T>
+FORCE_INLINE typename EnableIf<!IsBitwiseSerializable<T>::value>::Type serializeItems(Archive & ar, T * items, uint64 n)
+{
+	for (uint64 i = 0; i < n; ++i) ar << items[i];
+}
+/// @}
+
+/**
+ * Loads or saves the number of items of
+ * a container. When loading, fails if the
+ * count exceeds the remaining data, in
+ * which case count is set to zero.
+ *
+ * @param ar archive
+ * @param count number of items
+ * @param minItemSize min number of bytes
+ * 	of a serialized item
+ * @return true if count is valid
+ */
+FORCE_INLINE bool serializeCount(Archive & ar, uint64 & count, uint64 minItemSize)
+{
+	ar << count;
+
+	if (ar.isLoading() && (ar.hasError() || count > ar.getRemainingBytes() / minItemSize))
+	{
+		ar.setError();
+		count = 0;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_memory.h"
+
+#if PLATFORM_USE_SIMD && defined(__AVX2__)
+	#define CHAR_BLOCK_USE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define CHAR_BLOCK_USE_AVX2 0
+#endif
+
+/**
+ * A block of 64 characters, used by
+ * parsers to find the characters of a
+ * class as a 64-bit mask. With AVX2 each
+ * mask takes two compares, otherwise the
+ * block is compared 8 Bytes at a time
+ * with word operations.
+ *
+ * ```cpp
+ * CharBlock block{it};
+ * const uint64 quotes = block.match('"');
+ * const uint64 inQuotes = CharBlock::prefixXor(quotes);
+ * ```
+ */
+class CharBlock
+{
+public:
+	/// Number of characters in a block
+	static constexpr uint32 size = 64;
+
+	/**
+	 * Loads a block.
+	 *
+	 * @param data ptr to 64 characters
+	 */
+	explicit FORCE_INLINE CharBlock(const ansichar * data)
+	{
+#if CHAR_BLOCK_USE_AVX2
+		lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+		hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+#else
+		Memory::memcpy(words, data, size);
+#endif
+	}
+
+	/**
+	 * Returns a mask with the i-th bit set
+	 * if the i-th character is equal to the
+	 * given one.
+	 */
+	FORCE_INLINE uint64 match(ansichar c) const
+	{
+#if CHAR_BLOCK_USE_AVX2
+		const __m256i v = _mm256_set1_epi8(c);
+		const uint64 maskLo = static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v)));
+		const uint64 maskHi = static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v)));
+
+		return maskLo | (maskHi << 32);
+#else
+		uint64 mask = 0;
+		for (uint32 i = 0; i < 8; ++i) mask |= matchWord(words[i], c) << (i * 8);
+
+		return mask;
+#endif
+	}
+
+	/**
+	 * Returns a mask where each bit is the
+	 * xor of all the bits up to it. Given
+	 * the mask of quotes, it returns the
+	 * bits between pairs of quotes, with the
+	 * opening quote.
+	 */
+	static FORCE_INLINE uint64 prefixXor(uint64 x)
+	{
+		x ^= x << 1;
+		x ^= x << 2;
+		x ^= x << 4;
+		x ^= x << 8;
+		x ^= x << 16;
+		x ^= x << 32;
+		return x;
+	}
+
+protected:
+#if !CHAR_BLOCK_USE_AVX2
+	/**
+	 * Returns a mask with a bit set for each
+	 * of the 8 Bytes of the word equal to
+	 * the given character.
+	 */
+	static FORCE_INLINE uint64 matchWord(uint64 word, ansichar c)
+	{
+		static_assert(PLATFORM_LITTLE_ENDIAN, "Byte masks assume little endian words");
+
+		// High bit of each matching Byte
+		const uint64 x = word ^ (0x0101010101010101ull * static_cast<ubyte>(c));
+		const uint64 matches = ~(((x & 0x7f7f7f7f7f7f7f7full) + 0x7f7f7f7f7f7f7f7full) | x) & 0x8080808080808080ull;
+
+		// Gather the high bits in the top Byte
+		return (matches * 0x0002040810204081ull) >> 56;
+	}
+#endif
+
+#if CHAR_BLOCK_USE_AVX2
+	/// First and second half
+	__m256i lo, hi;
+#else
+	/// Block as words
+	uint64 words[8];
+#endif
+};
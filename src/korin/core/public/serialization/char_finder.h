@@ -0,0 +1,151 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "hal/platform_memory.h"
+#include "templates/string_view.h"
+
+#if PLATFORM_USE_SIMD && defined(__AVX2__)
+	#define CHAR_FINDER_USE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define CHAR_FINDER_USE_AVX2 0
+#endif
+
+/**
+ * Finds the first occurence of any of a
+ * small set of characters in a buffer.
+ * With AVX2 the buffer is scanned 32
+ * Bytes at a time, otherwise a single
+ * character is found with memchr and a
+ * set with a lookup table.
+ *
+ * ```cpp
+ * CharFinder finder{",\n"};
+ * const ansichar * it = finder.find(begin, end);
+ * ```
+ */
+class CharFinder
+{
+public:
+	/// Max number of characters in the set
+	static constexpr uint32 maxChars = 4;
+
+	/**
+	 * Creates a finder for a single
+	 * character.
+	 *
+	 * @param c character to find
+	 */
+	explicit FORCE_INLINE CharFinder(ansichar c)
+		: CharFinder{StringView{&c, 1}}
+	{
+		//
+	}
+
+	/**
+	 * Creates a finder for a set of
+	 * characters.
+	 *
+	 * @param inChars characters to find
+	 */
+	explicit CharFinder(const StringView & inChars)
+		: chars{}
+		, numChars{static_cast<uint32>(inChars.getLength())}
+		, table{}
+	{
+		CHECKF(numChars > 0 && numChars <= maxChars, "CharFinder supports 1 to 4 characters")
+
+		for (uint32 i = 0; i < maxChars; ++i)
+		{
+			// Unused slots repeat the first
+			// character
+			chars[i] = inChars[i < numChars ? i : 0];
+			table[static_cast<ubyte>(chars[i])] = true;
+		}
+	}
+
+	/**
+	 * Returns true if the character is in
+	 * the set.
+	 */
+	FORCE_INLINE bool has(ansichar c) const
+	{
+		return table[static_cast<ubyte>(c)];
+	}
+
+	/**
+	 * Returns a pointer to the first
+	 * character of the set in the range, or
+	 * end if not found.
+	 *
+	 * @param begin,end range to search
+	 * @return ptr to character or end
+	 */
+	FORCE_INLINE const ansichar * find(const ansichar * begin, const ansichar * end) const
+	{
+#if CHAR_FINDER_USE_AVX2
+		return findAvx2(begin, end);
+#else
+		return findScalar(begin, end);
+#endif
+	}
+
+	FORCE_INLINE ansichar * find(ansichar * begin, ansichar * end) const
+	{
+		return const_cast<ansichar*>(find(static_cast<const ansichar*>(begin), static_cast<const ansichar*>(end)));
+	}
+
+protected:
+	/**
+	 * Scalar search.
+	 */
+	const ansichar * findScalar(const ansichar * begin, const ansichar * end) const
+	{
+		if (numChars == 1)
+		{
+			const void * found = begin < end ? ::memchr(begin, chars[0], end - begin) : nullptr;
+			return found ? static_cast<const ansichar*>(found) : end;
+		}
+
+		for (; begin < end && !has(*begin); ++begin);
+		return begin;
+	}
+
+#if CHAR_FINDER_USE_AVX2
+	/**
+	 * Vector search, 32 Bytes at a time.
+	 */
+	const ansichar * findAvx2(const ansichar * begin, const ansichar * end) const
+	{
+		const __m256i c0 = _mm256_set1_epi8(chars[0]);
+		const __m256i c1 = _mm256_set1_epi8(chars[1]);
+		const __m256i c2 = _mm256_set1_epi8(chars[2]);
+		const __m256i c3 = _mm256_set1_epi8(chars[3]);
+
+		for (; begin + 32 <= end; begin += 32)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+			const __m256i eq = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, c0), _mm256_cmpeq_epi8(v, c1)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, c2), _mm256_cmpeq_epi8(v, c3))
+			);
+
+			const uint32 mask = static_cast<uint32>(_mm256_movemask_epi8(eq));
+			if (mask) return begin + __builtin_ctz(mask);
+		}
+
+		for (; begin < end && !has(*begin); ++begin);
+		return begin;
+	}
+#endif
+
+	/// Characters to find
+	ansichar chars[maxChars];
+
+	/// Number of characters in the set
+	uint32 numChars;
+
+	/// True for characters in the set
+	bool table[256];
+};
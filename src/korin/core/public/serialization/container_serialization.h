@@ -0,0 +1,151 @@
+#pragma once
+
+#include "core_types.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/pair.h"
+#include "containers/set.h"
+#include "containers/map.h"
+#include "./archive.h"
+
+/**
+ * Serializes an array as its number of
+ * items followed by the items. Arrays of
+ * bitwise serializable items are loaded
+ * and saved with a single copy.
+ */
+template<typename T, typename MallocT>
+void serialize(Archive & ar, Array<T, MallocT> & array)
+{
+	uint64 count = array.getCount();
+	if (!serializeCount(ar, count, IsBitwiseSerializable<T>::value ? sizeof(T) : 1))
+	{
+		array.empty();
+		return;
+	}
+
+	if (ar.isLoading())
+	{
+		array.empty();
+		array.reserve(count);
+		array.resize(count);
+	}
+
+	serializeItems(ar, *array, count);
+}
+
+/**
+ * Serializes a string as its length
+ * followed by its characters.
+ */
+template<typename CharT>
+void serialize(Archive & ar, StringBase<CharT> & string)
+{
+	uint64 length = string.getLength();
+	if (!serializeCount(ar, length, sizeof(CharT)))
+	{
+		string = StringBase<CharT>{};
+		return;
+	}
+
+	if (ar.isLoading())
+	{
+		string.getArray().reserve(length + 1);
+		string.getArray().resize(length + 1);
+		string[length] = CharT{};
+	}
+
+	if (length > 0) ar.serializeBytes(*string, length * sizeof(CharT));
+}
+
+/**
+ * Serializes a pair as its first and
+ * second element.
+ */
+template<typename A, typename B, typename CompareT>
+FORCE_INLINE void serialize(Archive & ar, Pair<A, B, CompareT> & pair)
+{
+	ar << pair.first << pair.second;
+}
+
+/**
+ * Serializes a set as its number of items
+ * followed by the items in order. Loading
+ * builds the tree in O(n) time, items must
+ * be default constructible.
+ */
+template<typename T, typename CompareT, typename MallocT>
+void serialize(Archive & ar, Set<T, CompareT, MallocT> & set)
+{
+	uint64 count = set.getCount();
+	if (!serializeCount(ar, count, 1))
+	{
+		set.getTree().empty();
+		return;
+	}
+
+	if (ar.isSaving())
+	{
+		for (const T & item : set) ar << item;
+		return;
+	}
+
+	set.getTree().buildSorted(count, [&ar]() {
+
+		T item{};
+		ar << item;
+		return item;
+	});
+
+	// Items must be sorted and unique
+	const T * prev = nullptr;
+	for (const T & item : set)
+	{
+		if (prev && CompareT{}(*prev, item) >= 0) ar.setError();
+		prev = &item;
+	}
+
+	if (ar.hasError()) set.getTree().empty();
+}
+
+/**
+ * Serializes a map as its number of pairs
+ * followed by the pairs in order. Loading
+ * builds the tree in O(n) time, keys and
+ * values must be default constructible.
+ */
+template<typename KeyT, typename ValT, typename CompareT, typename MallocT>
+void serialize(Archive & ar, Map<KeyT, ValT, CompareT, MallocT> & map)
+{
+	using PairT = Pair<KeyT, ValT, CompareT>;
+
+	uint64 count = map.getCount();
+	if (!serializeCount(ar, count, 1))
+	{
+		map.getTree().empty();
+		return;
+	}
+
+	if (ar.isSaving())
+	{
+		for (const PairT & pair : map) ar << pair;
+		return;
+	}
+
+	map.getTree().buildSorted(count, [&ar]() {
+
+		PairT pair{KeyT{}, ValT{}};
+		ar << pair;
+		return pair;
+	});
+
+	// Keys must be sorted and unique
+	const PairT * prev = nullptr;
+	for (const PairT & pair : map)
+	{
+		if (prev && CompareT{}(prev->first, pair.first) >= 0) ar.setError();
+		prev = &pair;
+	}
+
+	if (ar.hasError()) map.getTree().empty();
+}
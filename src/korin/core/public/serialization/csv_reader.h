@@ -0,0 +1,732 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "hal/platform_math.h"
+#include "hal/platform_memory.h"
+#include "hal/malloc_arena.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "templates/string_view.h"
+#include "templates/utility.h"
+#include "./char_finder.h"
+#include "./char_block.h"
+#include "./number_parser.h"
+
+/**
+ * Type of the values of a CSV column.
+ */
+enum class CsvColumnType : ubyte
+{
+	Int64,
+	Float64,
+	String
+};
+
+/**
+ * Columns parsed from a CSV file. Numeric
+ * columns are stored as arrays of numbers,
+ * string columns as views of strings
+ * copied in an arena owned by the table.
+ */
+class CsvTable
+{
+	friend class CsvReader;
+
+public:
+	/**
+	 * Creates an empty table.
+	 */
+	FORCE_INLINE CsvTable()
+		: columns{}
+		, arena{}
+		, numRows{0}
+		, numErrors{0}
+	{
+		//
+	}
+
+	/**
+	 * Returns the number of rows.
+	 */
+	FORCE_INLINE uint64 getNumRows() const
+	{
+		return numRows;
+	}
+
+	/**
+	 * Returns the number of columns.
+	 */
+	FORCE_INLINE uint64 getNumColumns() const
+	{
+		return columns.getCount();
+	}
+
+	/**
+	 * Returns the number of values that
+	 * could not be parsed and of rows with
+	 * the wrong number of fields.
+	 */
+	FORCE_INLINE uint64 getNumErrors() const
+	{
+		return numErrors;
+	}
+
+	/**
+	 * Returns the name of a column, empty
+	 * if the file has no header.
+	 */
+	FORCE_INLINE const String & getName(uint64 column) const
+	{
+		return columns[column].name;
+	}
+
+	/**
+	 * Returns the type of a column.
+	 */
+	FORCE_INLINE CsvColumnType getType(uint64 column) const
+	{
+		return columns[column].type;
+	}
+
+	/**
+	 * Returns the index of the column with
+	 * the given name, or -1 if not found.
+	 */
+	int64 findColumn(const StringView & name) const
+	{
+		for (uint64 i = 0; i < columns.getCount(); ++i) if (StringView{columns[i].name} == name) return i;
+		return -1;
+	}
+
+	/**
+	 * Returns the values of a column. The
+	 * column must have the right type.
+	 * @{
+	 */
+	FORCE_INLINE const Array<int64> & getInts(uint64 column) const
+	{
+		CHECKF(columns[column].type == CsvColumnType::Int64, "Column is not an integer column")
+		return columns[column].ints;
+	}
+
+	FORCE_INLINE const Array<float64> & getFloats(uint64 column) const
+	{
+		CHECKF(columns[column].type == CsvColumnType::Float64, "Column is not a float column")
+		return columns[column].floats;
+	}
+
+	FORCE_INLINE const Array<StringView> & getStrings(uint64 column) const
+	{
+		CHECKF(columns[column].type == CsvColumnType::String, "Column is not a string column")
+		return columns[column].strings;
+	}
+	/// @}
+
+	/**
+	 * Appends the rows of another table
+	 * with the same columns, e.g. a chunk
+	 * parsed by another thread. The other
+	 * table is left empty, its strings are
+	 * moved to this table.
+	 *
+	 * @param other table to append
+	 */
+	void append(CsvTable && other)
+	{
+		if (columns.isEmpty())
+		{
+			*this = move(other);
+			return;
+		}
+
+		CHECKF(columns.getCount() == other.columns.getCount(), "Tables have different columns")
+
+		for (uint64 i = 0; i < columns.getCount(); ++i)
+		{
+			appendItems(columns[i].ints, other.columns[i].ints);
+			appendItems(columns[i].floats, other.columns[i].floats);
+			appendItems(columns[i].strings, other.columns[i].strings);
+		}
+
+		arena.absorb(other.arena);
+		numRows += other.numRows;
+		numErrors += other.numErrors;
+
+		other.columns.reset();
+		other.numRows = other.numErrors = 0;
+	}
+
+protected:
+	/**
+	 * Values of a column, only the array of
+	 * the column type is used.
+	 */
+	struct Column
+	{
+		/// Column name
+		String name;
+
+		/// Type of the values
+		CsvColumnType type = CsvColumnType::String;
+
+		/// Values of an integer column
+		Array<int64> ints;
+
+		/// Values of a float column
+		Array<float64> floats;
+
+		/// Values of a string column
+		Array<StringView> strings;
+	};
+
+	/**
+	 * Appends trivial items to an array.
+	 */
+	template<typename T>
+	static void appendItems(Array<T> & dst, const Array<T> & src)
+	{
+		if (src.isEmpty()) return;
+
+		const uint64 offset = dst.getCount();
+		dst.reserve(offset + src.getCount());
+		dst.resize(offset + src.getCount());
+		Memory::memcpy(*dst + offset, *src, src.getCount() * sizeof(T));
+	}
+
+	/// Table columns
+	Array<Column> columns;
+
+	/// Storage of string values
+	MallocArena arena;
+
+	/// Number of rows
+	uint64 numRows;
+
+	/// Number of errors
+	uint64 numErrors;
+};
+
+/**
+ * Parses CSV files (RFC 4180) into typed
+ * columns. The reader parses the header
+ * and infers the type of each column from
+ * the first rows: integer, float or
+ * string.
+ *
+ * Rows are parsed 64 Bytes at a time: the
+ * quotes, delimiters and newlines of a
+ * block are found as bitmasks (with AVX2
+ * if available, otherwise 8 Bytes at a
+ * time with word operations), quoted
+ * regions are
+ * computed with a prefix xor of the quote
+ * mask, and the fields are the bits of
+ * the delimiters outside quotes.
+ *
+ * The body can be split in chunks that
+ * start on a row, to be parsed by multiple
+ * threads and appended in order:
+ *
+ * ```cpp
+ * CsvReader reader{text};
+ * Array<StringView> chunks;
+ * reader.split(numThreads, chunks);
+ *
+ * // On thread i
+ * reader.parse(chunks[i], tables[i]);
+ *
+ * // Then
+ * for (auto & table : tables) result.append(move(table));
+ * ```
+ *
+ * Values that don't match the column type
+ * are stored as 0 (integers) or NaN
+ * (floats) and counted as errors. Empty
+ * lines are skipped.
+ */
+class CsvReader
+{
+public:
+	/// Max number of rows used to infer the
+	/// column types
+	static constexpr uint32 numSampleRows = 64;
+
+	/**
+	 * Creates a reader and parses the header.
+	 *
+	 * @param inData CSV text, must outlive
+	 * 	the reader
+	 * @param [inDelimiter] field delimiter
+	 * @param [hasHeader] true if the first
+	 * 	row has the column names
+	 */
+	explicit CsvReader(const StringView & inData, ansichar inDelimiter = ',', bool hasHeader = true)
+		: delimiter{inDelimiter}
+		, body{}
+		, names{}
+		, types{}
+		, bytesPerRow{64}
+	{
+		CHECKF(delimiter != '"' && delimiter != '\n', "Invalid CSV delimiter")
+
+		const ansichar * it = *inData;
+		const ansichar * end = it + inData.getLength();
+
+		Array<StringView> fields;
+		if (hasHeader)
+		{
+			it = readRecord(it, end, fields);
+			names.reserve(fields.getCount());
+			for (const StringView & field : fields) names.add(unescape(field));
+		}
+
+		body = StringView{it, static_cast<sizet>(end - it)};
+		inferTypes();
+	}
+
+	/**
+	 * Returns the number of columns.
+	 */
+	FORCE_INLINE uint64 getNumColumns() const
+	{
+		return types.getCount();
+	}
+
+	/**
+	 * Returns the name of a column.
+	 */
+	FORCE_INLINE const String & getName(uint64 column) const
+	{
+		return names[column];
+	}
+
+	/**
+	 * Returns the type of a column.
+	 */
+	FORCE_INLINE CsvColumnType getType(uint64 column) const
+	{
+		return types[column];
+	}
+
+	/**
+	 * Overrides the inferred type of a
+	 * column.
+	 */
+	FORCE_INLINE void setColumnType(uint64 column, CsvColumnType type)
+	{
+		types[column] = type;
+	}
+
+	/**
+	 * Returns the rows, without the header.
+	 */
+	FORCE_INLINE const StringView & getBody() const
+	{
+		return body;
+	}
+
+	/**
+	 * Splits the rows in chunks of about
+	 * the same size. Chunks end after a
+	 * newline that is not quoted. Finding
+	 * quoted newlines requires a sequential
+	 * scan of the quotes, which is much
+	 * faster than parsing.
+	 *
+	 * @param numChunks max number of chunks
+	 * @param outChunks chunks, in order
+	 */
+	void split(uint32 numChunks, Array<StringView> & outChunks) const
+	{
+		outChunks.empty();
+
+		const ansichar * begin = *body;
+		const ansichar * end = begin + body.getLength();
+		const ansichar * chunkBegin = begin;
+
+		const CharFinder quoteFinder{'"'};
+		bool quoted = false;
+
+		for (uint32 i = 1; i < numChunks; ++i)
+		{
+			const ansichar * target = begin + body.getLength() * i / numChunks;
+			if (target <= chunkBegin) continue;
+
+			// Quote parity up to the target
+			for (const ansichar * q = quoteFinder.find(chunkBegin, target); q < target; q = quoteFinder.find(q + 1, target)) quoted = !quoted;
+
+			// Next newline outside quotes
+			const ansichar * it = target;
+			for (; it < end; ++it)
+			{
+				if (*it == '"') quoted = !quoted;
+				else if (*it == '\n' && !quoted) break;
+			}
+
+			if (it == end) break;
+
+			outChunks.add(StringView{chunkBegin, static_cast<sizet>(it + 1 - chunkBegin)});
+			chunkBegin = it + 1;
+		}
+
+		if (chunkBegin < end) outChunks.add(StringView{chunkBegin, static_cast<sizet>(end - chunkBegin)});
+	}
+
+	/**
+	 * Parses rows and appends them to a
+	 * table. The chunk must start on a row.
+	 * Safe to call from multiple threads
+	 * with different tables.
+	 *
+	 * @param chunk rows to parse
+	 * @param outTable table to fill
+	 */
+	void parse(const StringView & chunk, CsvTable & outTable) const
+	{
+		if (outTable.columns.isEmpty()) initTable(outTable);
+		CHECKF(outTable.columns.getCount() == types.getCount(), "Table has different columns")
+
+		reserveRows(outTable, chunk.getLength() / bytesPerRow + 1);
+
+		const ansichar * begin = *chunk;
+		const ansichar * end = begin + chunk.getLength();
+		const ansichar * fieldBegin = begin;
+		uint64 column = 0;
+		uint64 quoteCarry = 0;
+
+		for (const ansichar * block = begin; block < end; block += CharBlock::size)
+		{
+			uint64 quotes, delimiters, newlines;
+			if (block + CharBlock::size <= end) findStructurals(block, quotes, delimiters, newlines);
+			else
+			{
+				// Pad the last block
+				ansichar tail[CharBlock::size] = {};
+				Memory::memcpy(tail, block, end - block);
+				findStructurals(tail, quotes, delimiters, newlines);
+			}
+
+			// Bits inside quotes, including the
+			// opening quote
+			const uint64 inQuotes = CharBlock::prefixXor(quotes) ^ quoteCarry;
+			quoteCarry = 0ull - (inQuotes >> 63);
+
+			for (uint64 bits = (delimiters | newlines) & ~inQuotes; bits; bits &= bits - 1)
+			{
+				const ansichar * it = block + __builtin_ctzll(bits);
+				if (*it == '\n')
+				{
+					endRow(outTable, column, fieldBegin, it);
+					column = 0;
+				}
+				else addField(outTable, column++, StringView{fieldBegin, static_cast<sizet>(it - fieldBegin)});
+
+				fieldBegin = it + 1;
+			}
+		}
+
+		// Last row may not end with a newline
+		if (fieldBegin < end || column > 0) endRow(outTable, column, fieldBegin, end);
+	}
+
+	/**
+	 * Parses all rows.
+	 *
+	 * @param outTable table to fill
+	 */
+	FORCE_INLINE void parse(CsvTable & outTable) const
+	{
+		parse(body, outTable);
+	}
+
+protected:
+	/**
+	 * Computes the masks of quotes,
+	 * delimiters and newlines of a block of
+	 * 64 Bytes.
+	 */
+	FORCE_INLINE void findStructurals(const ansichar * data, uint64 & outQuotes, uint64 & outDelimiters, uint64 & outNewlines) const
+	{
+		const CharBlock block{data};
+		outQuotes = block.match('"');
+		outDelimiters = block.match(delimiter);
+		outNewlines = block.match('\n');
+	}
+
+	/**
+	 * Returns the field without a trailing
+	 * carriage return.
+	 */
+	static FORCE_INLINE StringView trimField(const ansichar * begin, const ansichar * end)
+	{
+		if (end > begin && end[-1] == '\r') --end;
+		return StringView{begin, static_cast<sizet>(end - begin)};
+	}
+
+	/**
+	 * Returns the field without the
+	 * enclosing quotes, escaped quotes are
+	 * not replaced.
+	 */
+	static FORCE_INLINE StringView unquote(const StringView & field)
+	{
+		const sizet length = field.getLength();
+		if (length >= 2 && field[0] == '"' && field[length - 1] == '"') return StringView{*field + 1, length - 2};
+		return field;
+	}
+
+	/**
+	 * Returns the field without quotes and
+	 * with escaped quotes replaced.
+	 */
+	static String unescape(const StringView & field)
+	{
+		const StringView value = unquote(field);
+
+		String out;
+		for (sizet i = 0; i < value.getLength(); ++i)
+		{
+			out += value[i];
+			i += value[i] == '"' && i + 1 < value.getLength() && value[i + 1] == '"';
+		}
+
+		return out;
+	}
+
+	/**
+	 * Reads the fields of a record, without
+	 * parsing them.
+	 *
+	 * @return start of the next record
+	 */
+	const ansichar * readRecord(const ansichar * it, const ansichar * end, Array<StringView> & outFields) const
+	{
+		outFields.empty();
+
+		const ansichar * fieldBegin = it;
+		bool quoted = false;
+
+		for (; it < end; ++it)
+		{
+			if (*it == '"') quoted = !quoted;
+			else if (!quoted && (*it == delimiter || *it == '\n'))
+			{
+				outFields.add(trimField(fieldBegin, it));
+				fieldBegin = it + 1;
+
+				if (*it == '\n') return it + 1;
+			}
+		}
+
+		if (fieldBegin < end || !outFields.isEmpty()) outFields.add(trimField(fieldBegin, end));
+		return end;
+	}
+
+	/**
+	 * Infers the type of each column from
+	 * the first rows. A column is an integer
+	 * column if all values are integers, a
+	 * float column if all values are
+	 * numbers, otherwise a string column.
+	 * Empty values are ignored.
+	 */
+	void inferTypes()
+	{
+		const ansichar * it = *body;
+		const ansichar * end = it + body.getLength();
+
+		Array<StringView> fields;
+		Array<bool> hasValues;
+		uint32 row = 0;
+
+		for (; row < numSampleRows && it < end;)
+		{
+			it = readRecord(it, end, fields);
+			if (fields.getCount() == 1 && fields[0].isEmpty()) continue;
+
+			if (types.isEmpty())
+			{
+				// No header, the first row has
+				// the number of columns
+				const uint64 numColumns = names.isEmpty() ? fields.getCount() : names.getCount();
+				for (uint64 i = 0; i < numColumns; ++i)
+				{
+					types.add(CsvColumnType::Int64);
+					hasValues.add(false);
+				}
+			}
+
+			for (uint64 i = 0; i < fields.getCount() && i < types.getCount(); ++i)
+			{
+				const StringView value = unquote(fields[i]);
+				if (value.isEmpty()) continue;
+
+				int64 intValue;
+				float64 floatValue;
+				if (types[i] == CsvColumnType::Int64 && !NumberParser::parse(value, intValue)) types[i] = CsvColumnType::Float64;
+				if (types[i] == CsvColumnType::Float64 && !NumberParser::parse(value, floatValue)) types[i] = CsvColumnType::String;
+
+				hasValues[i] = true;
+			}
+
+			++row;
+		}
+
+		if (types.isEmpty()) for (uint64 i = 0; i < names.getCount(); ++i) types.add(CsvColumnType::String);
+		if (row > 0) bytesPerRow = PlatformMath::max(static_cast<uint64>(it - *body) / row, 1ull);
+
+		// Columns without values are strings
+		for (uint64 i = 0; i < hasValues.getCount(); ++i) if (!hasValues[i]) types[i] = CsvColumnType::String;
+
+		// Unnamed columns
+		names.reserve(types.getCount());
+		while (names.getCount() < types.getCount()) names.add(String{});
+	}
+
+	/**
+	 * Creates the columns of a table.
+	 */
+	void initTable(CsvTable & outTable) const
+	{
+		outTable.columns.resize(types.getCount());
+		for (uint64 i = 0; i < types.getCount(); ++i)
+		{
+			outTable.columns[i].name = names[i];
+			outTable.columns[i].type = types[i];
+		}
+	}
+
+	/**
+	 * Makes room for the estimated number
+	 * of rows of a chunk, so that columns
+	 * don't grow while parsing.
+	 */
+	static void reserveRows(CsvTable & outTable, uint64 numRows)
+	{
+		for (CsvTable::Column & values : outTable.columns)
+		{
+			switch (values.type)
+			{
+				case CsvColumnType::Int64: values.ints.reserve(values.ints.getCount() + numRows); break;
+				case CsvColumnType::Float64: values.floats.reserve(values.floats.getCount() + numRows); break;
+				case CsvColumnType::String: values.strings.reserve(values.strings.getCount() + numRows); break;
+			}
+		}
+	}
+
+	/**
+	 * Parses a field and adds it to its
+	 * column. Fields past the last column
+	 * are ignored.
+	 */
+	FORCE_INLINE void addField(CsvTable & outTable, uint64 column, const StringView & field) const
+	{
+		if (UNLIKELY(column >= outTable.columns.getCount())) return;
+
+		CsvTable::Column & values = outTable.columns[column];
+		switch (values.type)
+		{
+			case CsvColumnType::Int64:
+			{
+				int64 value = 0;
+				const StringView number = unquote(field);
+				if (UNLIKELY(!NumberParser::parse(number, value) && !number.isEmpty()))
+				{
+					value = 0;
+					++outTable.numErrors;
+				}
+
+				values.ints.add(value);
+				break;
+			}
+
+			case CsvColumnType::Float64:
+			{
+				float64 value = __builtin_nan("");
+				const StringView number = unquote(field);
+				if (UNLIKELY(!NumberParser::parse(number, value) && !number.isEmpty()))
+				{
+					value = __builtin_nan("");
+					++outTable.numErrors;
+				}
+
+				values.floats.add(value);
+				break;
+			}
+
+			case CsvColumnType::String:
+			{
+				values.strings.add(copyString(outTable.arena, field));
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Adds the last field of a row and
+	 * fills missing fields.
+	 */
+	FORCE_INLINE void endRow(CsvTable & outTable, uint64 column, const ansichar * fieldBegin, const ansichar * fieldEnd) const
+	{
+		const StringView field = trimField(fieldBegin, fieldEnd);
+		if (column == 0 && field.isEmpty()) return;
+
+		addField(outTable, column++, field);
+
+		if (UNLIKELY(column != outTable.columns.getCount()))
+		{
+			// Wrong number of fields
+			for (; column < outTable.columns.getCount(); ++column) addField(outTable, column, StringView{});
+			++outTable.numErrors;
+		}
+
+		++outTable.numRows;
+	}
+
+	/**
+	 * Copies a field in the arena, without
+	 * quotes and null-terminated.
+	 */
+	static StringView copyString(MallocArena & arena, const StringView & field)
+	{
+		const bool quoted = field.getLength() > 0 && field[0] == '"';
+		const StringView value = quoted ? unquote(field) : field;
+
+		ansichar * out = static_cast<ansichar*>(arena.alloc(value.getLength() + 1, 1));
+		sizet length = 0;
+
+		if (quoted)
+		{
+			for (sizet i = 0; i < value.getLength(); ++i)
+			{
+				out[length++] = value[i];
+				i += value[i] == '"' && i + 1 < value.getLength() && value[i + 1] == '"';
+			}
+		}
+		else
+		{
+			Memory::memcpy(out, *value, value.getLength());
+			length = value.getLength();
+		}
+
+		out[length] = '\0';
+		return StringView{out, length};
+	}
+
+	/// Field delimiter
+	ansichar delimiter;
+
+	/// Rows, without the header
+	StringView body;
+
+	/// Column names
+	Array<String> names;
+
+	/// Column types
+	Array<CsvColumnType> types;
+
+	/// Average size of the sampled rows,
+	/// used to preallocate the columns
+	uint64 bytesPerRow;
+};
@@ -0,0 +1,1036 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "hal/platform_memory.h"
+#include "hal/memory_base.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "templates/optional.h"
+#include "templates/string_view.h"
+#include "templates/utility.h"
+#include "./char_block.h"
+#include "./number_parser.h"
+
+class JsonValue;
+
+/**
+ * Type of a JSON value.
+ */
+enum class JsonType : ubyte
+{
+	Invalid,
+	Null,
+	Bool,
+	Number,
+	String,
+	Array,
+	Object
+};
+
+/**
+ * Reads JSON documents on demand. Parsing
+ * only builds an index of the structural
+ * characters of the document, 64 Bytes at
+ * a time (see CharBlock): brackets, colons
+ * and commas outside strings, and the
+ * first character of each string, number
+ * and literal. Brackets are matched, so
+ * that nested values can be skipped in
+ * constant time.
+ *
+ * Values are cursors into the index, and
+ * are only parsed when read:
+ *
+ * ```cpp
+ * JsonReader reader;
+ * if (reader.parse(text))
+ * {
+ * 	int64 port = reader.getRoot()["server"]["port"].getOr(8080ll);
+ * 	for (JsonValue item : reader.getRoot()["items"].getItems()) ...
+ * }
+ * ```
+ *
+ * Parsing checks the structure of the
+ * document: strings are closed, brackets
+ * are balanced, items are separated by
+ * commas, fields are a string key and a
+ * value separated by a colon, and there
+ * is a single root value. Numbers and
+ * literals are checked when read. The
+ * text must outlive the reader and its
+ * values.
+ */
+class JsonReader
+{
+	friend class JsonValue;
+	friend class JsonItemIterator;
+	friend class JsonFieldIterator;
+
+public:
+	/// Max nesting depth
+	static constexpr uint32 maxDepth = 1024;
+
+	/**
+	 * Creates an empty reader.
+	 */
+	FORCE_INLINE JsonReader()
+		: malloc{gMalloc}
+		, json{nullptr}
+		, length{0}
+		, tokens{nullptr}
+		, jumps{nullptr}
+		, numTokens{0}
+		, capacity{0}
+		, errorPos{0}
+		, valid{false}
+	{
+		//
+	}
+
+	JsonReader(const JsonReader&) = delete;
+	JsonReader & operator=(const JsonReader&) = delete;
+
+	/**
+	 * Frees the index.
+	 */
+	FORCE_INLINE ~JsonReader()
+	{
+		malloc->free(tokens);
+		malloc->free(jumps);
+	}
+
+	/**
+	 * Indexes a document. The index memory
+	 * is reused by the following calls.
+	 *
+	 * @param text JSON text, up to 4 GiB
+	 * @return true if the document is
+	 * 	well-formed
+	 */
+	bool parse(const StringView & text)
+	{
+		json = *text;
+		length = text.getLength();
+		numTokens = 0;
+		errorPos = 0;
+
+		// Token positions are 32 bits
+		if (UNLIKELY(length >= (1ull << 32)))
+		{
+			valid = false;
+			return setError(0);
+		}
+
+		// At most one token per character,
+		// plus the end
+		if (capacity < length + 1)
+		{
+			capacity = length + 1;
+			tokens = static_cast<uint32*>(malloc->realloc(tokens, capacity * sizeof(uint32)));
+			jumps = static_cast<uint32*>(malloc->realloc(jumps, capacity * sizeof(uint32)));
+		}
+
+		valid = indexTokens() && matchBrackets();
+		return valid;
+	}
+
+	/**
+	 * Returns true if the last document is
+	 * well-formed.
+	 */
+	FORCE_INLINE bool isValid() const
+	{
+		return valid;
+	}
+
+	/**
+	 * Returns the position of the first
+	 * error of the last document.
+	 */
+	FORCE_INLINE uint64 getErrorPos() const
+	{
+		return errorPos;
+	}
+
+	/**
+	 * Returns the number of indexed tokens.
+	 */
+	FORCE_INLINE uint64 getNumTokens() const
+	{
+		return numTokens;
+	}
+
+	/**
+	 * Returns the root value, invalid if
+	 * the document is not well-formed.
+	 */
+	FORCE_INLINE JsonValue getRoot() const;
+
+protected:
+	/**
+	 * Returns the first character of a
+	 * token, or 0 past the last token.
+	 */
+	FORCE_INLINE ansichar getChar(uint32 token) const
+	{
+		return token < numTokens ? json[tokens[token]] : '\0';
+	}
+
+	/**
+	 * Returns the token after the value
+	 * that starts at the given token.
+	 */
+	FORCE_INLINE uint32 skip(uint32 token) const
+	{
+		const ansichar c = getChar(token);
+		return c == '{' || c == '[' ? jumps[token] + 1 : token + 1;
+	}
+
+	/**
+	 * Returns the text of the value that
+	 * starts at the given token. Scalars end
+	 * at the last non-space character
+	 * before the next token.
+	 */
+	StringView getText(uint32 token) const
+	{
+		const ansichar c = getChar(token);
+		const uint64 begin = tokens[token];
+
+		if (c == '{' || c == '[') return StringView{json + begin, tokens[jumps[token]] + 1 - begin};
+
+		uint64 end = token + 1 < numTokens ? tokens[token + 1] : length;
+		while (end > begin + 1 && isSpace(json[end - 1])) --end;
+
+		return StringView{json + begin, end - begin};
+	}
+
+	/**
+	 * Returns true for JSON whitespace.
+	 */
+	static FORCE_INLINE bool isSpace(ansichar c)
+	{
+		return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+	}
+
+	/**
+	 * Returns the mask of the characters
+	 * escaped by a backslash. Runs of
+	 * backslashes escape each other, and may
+	 * continue from the previous block.
+	 */
+	static FORCE_INLINE uint64 findEscaped(uint64 backslashes, uint64 & prevEscaped)
+	{
+		constexpr uint64 evenBits = 0x5555555555555555ull;
+
+		backslashes &= ~prevEscaped;
+		const uint64 followsEscape = (backslashes << 1) | prevEscaped;
+
+		// Runs that start on odd bits, the
+		// add carries through each run
+		const uint64 oddStarts = backslashes & ~evenBits & ~followsEscape;
+		uint64 evenStartRuns;
+		prevEscaped = __builtin_add_overflow(oddStarts, backslashes, &evenStartRuns);
+
+		const uint64 invertMask = evenStartRuns << 1;
+		return (evenBits ^ invertMask) & followsEscape;
+	}
+
+	/**
+	 * Finds the position of all structural
+	 * characters.
+	 */
+	bool indexTokens()
+	{
+		uint64 prevEscaped = 0;
+		uint64 stringCarry = 0;
+		uint64 scalarCarry = 0;
+
+		for (uint64 pos = 0; pos < length; pos += CharBlock::size)
+		{
+			const ansichar * data = json + pos;
+
+			ansichar tail[CharBlock::size];
+			if (pos + CharBlock::size > length)
+			{
+				// Pad the last block with spaces
+				Memory::memset(tail, ' ', sizeof(tail));
+				Memory::memcpy(tail, data, length - pos);
+				data = tail;
+			}
+
+			const CharBlock block{data};
+
+			const uint64 escaped = findEscaped(block.match('\\'), prevEscaped);
+			const uint64 quotes = block.match('"') & ~escaped;
+
+			// Strings with the opening quote
+			const uint64 inString = CharBlock::prefixXor(quotes) ^ stringCarry;
+			stringCarry = 0ull - (inString >> 63);
+
+			const uint64 operators = block.match('{') | block.match('}') | block.match('[') | block.match(']') | block.match(':') | block.match(',');
+			const uint64 spaces = block.match(' ') | block.match('\n') | block.match('\t') | block.match('\r');
+
+			// Numbers and literals start after
+			// an operator or a space
+			const uint64 scalars = ~(operators | spaces | quotes | inString);
+			const uint64 scalarStarts = scalars & ~((scalars << 1) | scalarCarry);
+			scalarCarry = scalars >> 63;
+
+			for (uint64 bits = (operators & ~inString) | (quotes & inString) | scalarStarts; bits; bits &= bits - 1)
+			{
+				tokens[numTokens++] = static_cast<uint32>(pos + __builtin_ctzll(bits));
+			}
+		}
+
+		if (stringCarry)
+		{
+			// Unterminated string
+			errorPos = length;
+			return false;
+		}
+
+		return numTokens > 0;
+	}
+
+	/**
+	 * Matches brackets and checks the
+	 * structure of the document, i.e. the
+	 * sequence of tokens.
+	 */
+	bool matchBrackets()
+	{
+		/// Tokens accepted next
+		enum Expect : ubyte
+		{
+			ExpectValue,
+			ExpectValueOrClose,
+			ExpectKey,
+			ExpectKeyOrClose,
+			ExpectColon,
+			ExpectCommaOrClose,
+			ExpectEnd
+		};
+
+		uint32 stack[maxDepth];
+		uint32 depth = 0;
+		Expect expect = ExpectValue;
+
+		for (uint32 token = 0; token < numTokens; ++token)
+		{
+			const ansichar c = json[tokens[token]];
+			const bool isValueExpected = expect == ExpectValue || expect == ExpectValueOrClose;
+
+			switch (c)
+			{
+				case '{':
+				case '[':
+				{
+					if (UNLIKELY(!isValueExpected || depth == maxDepth)) return setError(token);
+
+					stack[depth++] = token;
+					expect = c == '{' ? ExpectKeyOrClose : ExpectValueOrClose;
+					break;
+				}
+
+				case '}':
+				case ']':
+				{
+					if (UNLIKELY(depth == 0)) return setError(token);
+
+					// Close after a value, or right
+					// after the open bracket
+					const uint32 open = stack[depth - 1];
+					const ansichar openChar = c == '}' ? '{' : '[';
+					const Expect emptyExpect = c == '}' ? ExpectKeyOrClose : ExpectValueOrClose;
+					if (UNLIKELY(json[tokens[open]] != openChar || (expect != ExpectCommaOrClose && expect != emptyExpect))) return setError(token);
+
+					jumps[open] = token;
+					expect = --depth > 0 ? ExpectCommaOrClose : ExpectEnd;
+					break;
+				}
+
+				case ':':
+				{
+					if (UNLIKELY(expect != ExpectColon)) return setError(token);
+					expect = ExpectValue;
+					break;
+				}
+
+				case ',':
+				{
+					if (UNLIKELY(expect != ExpectCommaOrClose)) return setError(token);
+					expect = json[tokens[stack[depth - 1]]] == '{' ? ExpectKey : ExpectValue;
+					break;
+				}
+
+				case '"':
+				{
+					if (expect == ExpectKey || expect == ExpectKeyOrClose) expect = ExpectColon;
+					else if (isValueExpected) expect = depth > 0 ? ExpectCommaOrClose : ExpectEnd;
+					else return setError(token);
+					break;
+				}
+
+				default:
+				{
+					// Number or literal
+					if (UNLIKELY(!isValueExpected)) return setError(token);
+					expect = depth > 0 ? ExpectCommaOrClose : ExpectEnd;
+					break;
+				}
+			}
+		}
+
+		if (depth > 0) return setError(stack[depth - 1]);
+		if (expect != ExpectEnd) return setError(numTokens);
+
+		return true;
+	}
+
+	/**
+	 * Records the position of an error.
+	 */
+	FORCE_INLINE bool setError(uint32 token)
+	{
+		errorPos = token < numTokens ? tokens[token] : length;
+		return false;
+	}
+
+	/// Allocator of the index, gMalloc at
+	/// construction
+	MallocBase * malloc;
+
+	/// Document text
+	const ansichar * json;
+
+	/// Length of the text
+	uint64 length;
+
+	/// Positions of the tokens
+	uint32 * tokens;
+
+	/// Matching close bracket of each
+	/// open bracket
+	uint32 * jumps;
+
+	/// Number of tokens
+	uint64 numTokens;
+
+	/// Capacity of the index
+	uint64 capacity;
+
+	/// Position of the first error
+	uint64 errorPos;
+
+	/// True if the document is valid
+	bool valid;
+};
+
+/**
+ * Iterates over the items of an array.
+ */
+class JsonItemIterator
+{
+public:
+	FORCE_INLINE JsonItemIterator(const JsonReader * inReader, uint32 inToken, uint32 inEnd)
+		: reader{inReader}
+		, token{inToken}
+		, end{inEnd}
+	{
+		//
+	}
+
+	FORCE_INLINE JsonValue operator*() const;
+
+	FORCE_INLINE JsonItemIterator & operator++()
+	{
+		const uint32 next = reader->skip(token);
+		token = next < end && reader->getChar(next) == ',' ? next + 1 : end;
+
+		return *this;
+	}
+
+	FORCE_INLINE bool operator!=(const JsonItemIterator & other) const
+	{
+		return token != other.token;
+	}
+
+protected:
+	/// Document index
+	const JsonReader * reader;
+
+	/// Current item
+	uint32 token;
+
+	/// Close bracket
+	uint32 end;
+};
+
+/**
+ * A field of an object.
+ */
+struct JsonField;
+
+/**
+ * Iterates over the fields of an object.
+ */
+class JsonFieldIterator
+{
+public:
+	FORCE_INLINE JsonFieldIterator(const JsonReader * inReader, uint32 inToken, uint32 inEnd)
+		: reader{inReader}
+		, token{inToken}
+		, end{inEnd}
+	{
+		//
+	}
+
+	FORCE_INLINE JsonField operator*() const;
+
+	FORCE_INLINE JsonFieldIterator & operator++()
+	{
+		// Skip key, colon and value
+		const uint32 next = reader->skip(token + 2);
+		token = next < end && reader->getChar(next) == ',' ? next + 1 : end;
+
+		return *this;
+	}
+
+	FORCE_INLINE bool operator!=(const JsonFieldIterator & other) const
+	{
+		return token != other.token;
+	}
+
+protected:
+	/// Document index
+	const JsonReader * reader;
+
+	/// Key of the current field
+	uint32 token;
+
+	/// Close bracket
+	uint32 end;
+};
+
+/**
+ * A pair of iterators, for range loops.
+ */
+template<typename IteratorT>
+struct JsonRange
+{
+	/// First and end iterator
+	IteratorT first, last;
+
+	FORCE_INLINE IteratorT begin() const
+	{
+		return first;
+	}
+
+	FORCE_INLINE IteratorT end() const
+	{
+		return last;
+	}
+};
+
+/**
+ * A value of a JSON document. Values are
+ * cheap to copy and are valid as long as
+ * the reader doesn't parse another
+ * document. Reading a value of the wrong
+ * type fails, so do all reads of an
+ * invalid value, e.g. a missing field.
+ */
+class JsonValue
+{
+	friend class JsonReader;
+	friend class JsonItemIterator;
+	friend class JsonFieldIterator;
+
+public:
+	/**
+	 * Creates an invalid value.
+	 */
+	FORCE_INLINE JsonValue()
+		: reader{nullptr}
+		, token{0}
+	{
+		//
+	}
+
+	/**
+	 * Returns true if the value exists.
+	 */
+	FORCE_INLINE bool isValid() const
+	{
+		return reader != nullptr;
+	}
+
+	/**
+	 * Returns the type of the value.
+	 */
+	JsonType getType() const
+	{
+		if (!reader) return JsonType::Invalid;
+
+		switch (reader->getChar(token))
+		{
+			case '{': return JsonType::Object;
+			case '[': return JsonType::Array;
+			case '"': return JsonType::String;
+			case 't': case 'f': return JsonType::Bool;
+			case 'n': return JsonType::Null;
+			case '-': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': return JsonType::Number;
+			default: return JsonType::Invalid;
+		}
+	}
+
+	/**
+	 * Returns true if the value is null.
+	 */
+	FORCE_INLINE bool isNull() const
+	{
+		return getType() == JsonType::Null && getText() == "null";
+	}
+
+	/**
+	 * Returns the text of the value, e.g.
+	 * to copy a nested object as is.
+	 */
+	FORCE_INLINE StringView getText() const
+	{
+		return reader ? reader->getText(token) : StringView{};
+	}
+
+	/**
+	 * Returns the items of an array, or an
+	 * empty range.
+	 */
+	FORCE_INLINE JsonRange<JsonItemIterator> getItems() const
+	{
+		if (getType() != JsonType::Array) return {{reader, 0, 0}, {reader, 0, 0}};
+
+		const uint32 end = reader->jumps[token];
+		return {{reader, token + 1, end}, {reader, end, end}};
+	}
+
+	/**
+	 * Returns the fields of an object, or
+	 * an empty range.
+	 */
+	FORCE_INLINE JsonRange<JsonFieldIterator> getFields() const
+	{
+		if (getType() != JsonType::Object) return {{reader, 0, 0}, {reader, 0, 0}};
+
+		const uint32 end = reader->jumps[token];
+		return {{reader, token + 1, end}, {reader, end, end}};
+	}
+
+	/**
+	 * Returns the number of items of an
+	 * array or fields of an object.
+	 */
+	uint64 getCount() const;
+
+	/**
+	 * Returns the i-th item of an array, or
+	 * an invalid value.
+	 */
+	JsonValue getItem(uint64 idx) const;
+
+	/**
+	 * Returns the field of an object with
+	 * the given key, or an invalid value.
+	 * Fields are searched in order.
+	 */
+	JsonValue operator[](const StringView & key) const;
+
+	/**
+	 * Returns true if the value is a string
+	 * equal to the given one.
+	 */
+	bool equals(const StringView & str) const
+	{
+		StringView raw;
+		if (get(raw)) return raw == str;
+
+		String value;
+		return get(value) && StringView{value} == str;
+	}
+
+	/**
+	 * Reads a boolean.
+	 */
+	FORCE_INLINE bool get(bool & outValue) const
+	{
+		if (getType() != JsonType::Bool) return false;
+
+		const StringView text = getText();
+		if (text == "true") outValue = true;
+		else if (text == "false") outValue = false;
+		else return false;
+
+		return true;
+	}
+
+	/**
+	 * Reads a number. Integers fail if the
+	 * value has a fraction or an exponent,
+	 * or doesn't fit the type.
+	 * @{
+	 */
+	FORCE_INLINE bool get(int64 & outValue) const
+	{
+		return getType() == JsonType::Number && NumberParser::parse(getText(), outValue);
+	}
+
+	FORCE_INLINE bool get(float64 & outValue) const
+	{
+		return getType() == JsonType::Number && NumberParser::parse(getText(), outValue);
+	}
+
+	FORCE_INLINE bool get(int32 & outValue) const
+	{
+		int64 value;
+		if (!get(value) || value < -0x80000000ll || value > 0x7fffffffll) return false;
+
+		outValue = static_cast<int32>(value);
+		return true;
+	}
+
+	FORCE_INLINE bool get(uint32 & outValue) const
+	{
+		int64 value;
+		if (!get(value) || value < 0 || value > 0xffffffffll) return false;
+
+		outValue = static_cast<uint32>(value);
+		return true;
+	}
+
+	FORCE_INLINE bool get(uint64 & outValue) const
+	{
+		int64 value;
+		if (!get(value) || value < 0) return false;
+
+		outValue = static_cast<uint64>(value);
+		return true;
+	}
+
+	FORCE_INLINE bool get(float32 & outValue) const
+	{
+		float64 value;
+		if (!get(value)) return false;
+
+		outValue = static_cast<float32>(value);
+		return true;
+	}
+	/// @}
+
+	/**
+	 * Reads a string without copying. Fails
+	 * if the string has escape sequences.
+	 */
+	FORCE_INLINE bool get(StringView & outValue) const
+	{
+		if (getType() != JsonType::String) return false;
+
+		const StringView text = getText();
+		if (text.getLength() < 2 || text[text.getLength() - 1] != '"') return false;
+
+		const StringView value{*text + 1, text.getLength() - 2};
+		if (value.findIndex('\\') >= 0) return false;
+
+		outValue = value;
+		return true;
+	}
+
+	/**
+	 * Reads a string, replacing escape
+	 * sequences. Unicode escapes are
+	 * encoded as UTF-8.
+	 */
+	bool get(String & outValue) const;
+
+	/**
+	 * Reads an array, fails if any item
+	 * can't be read.
+	 */
+	template<typename T, typename MallocT>
+	bool get(Array<T, MallocT> & outValue) const
+	{
+		if (getType() != JsonType::Array) return false;
+
+		outValue.empty();
+		for (const JsonValue & item : getItems())
+		{
+			T value{};
+			if (!item.get(value)) return false;
+
+			outValue.add(move(value));
+		}
+
+		return true;
+	}
+
+	/**
+	 * Reads an object in a map with string
+	 * keys, fails if any value can't be
+	 * read. Duplicate keys keep the last
+	 * value.
+	 */
+	template<typename T, typename CompareT, typename MallocT>
+	bool get(Map<String, T, CompareT, MallocT> & outValue) const;
+
+	/**
+	 * Reads an optional value, null resets
+	 * the optional.
+	 */
+	template<typename T>
+	bool get(Optional<T> & outValue) const
+	{
+		if (isNull())
+		{
+			outValue.reset();
+			return true;
+		}
+
+		T value{};
+		if (!get(value)) return false;
+
+		outValue = move(value);
+		return true;
+	}
+
+	/**
+	 * Returns the value, or the given
+	 * default if it can't be read.
+	 */
+	template<typename T>
+	FORCE_INLINE T getOr(T defaultValue) const
+	{
+		T value{};
+		return get(value) ? value : defaultValue;
+	}
+
+protected:
+	/**
+	 * Creates a value from a token.
+	 */
+	FORCE_INLINE JsonValue(const JsonReader * inReader, uint32 inToken)
+		: reader{inReader}
+		, token{inToken}
+	{
+		//
+	}
+
+	/**
+	 * Reads the key and the value of a
+	 * field.
+	 */
+	template<typename T>
+	static bool readField(const JsonField & field, String & outKey, T & outValue);
+
+	/**
+	 * Appends characters to a string.
+	 */
+	static FORCE_INLINE void appendChars(String & out, const ansichar * chars, sizet n)
+	{
+		const sizet length = out.getLength();
+		out.getArray()(length + n) = '\0';
+		Memory::memcpy(*out + length, chars, n);
+	}
+
+	/**
+	 * Appends a code point as UTF-8.
+	 */
+	static void appendUtf8(String & out, uint32 codePoint)
+	{
+		if (codePoint < 0x80) out += static_cast<ansichar>(codePoint);
+		else if (codePoint < 0x800)
+		{
+			out += static_cast<ansichar>(0xc0 | (codePoint >> 6));
+			out += static_cast<ansichar>(0x80 | (codePoint & 0x3f));
+		}
+		else if (codePoint < 0x10000)
+		{
+			out += static_cast<ansichar>(0xe0 | (codePoint >> 12));
+			out += static_cast<ansichar>(0x80 | ((codePoint >> 6) & 0x3f));
+			out += static_cast<ansichar>(0x80 | (codePoint & 0x3f));
+		}
+		else
+		{
+			out += static_cast<ansichar>(0xf0 | (codePoint >> 18));
+			out += static_cast<ansichar>(0x80 | ((codePoint >> 12) & 0x3f));
+			out += static_cast<ansichar>(0x80 | ((codePoint >> 6) & 0x3f));
+			out += static_cast<ansichar>(0x80 | (codePoint & 0x3f));
+		}
+	}
+
+	/**
+	 * Parses the 4 hex digits of a unicode
+	 * escape.
+	 */
+	static bool parseHex4(const ansichar * it, const ansichar * end, uint32 & outValue)
+	{
+		if (end - it < 4) return false;
+
+		outValue = 0;
+		for (uint32 i = 0; i < 4; ++i)
+		{
+			const ansichar c = it[i];
+			const uint32 digit = c >= '0' && c <= '9' ? c - '0' : (c | 0x20) >= 'a' && (c | 0x20) <= 'f' ? (c | 0x20) - 'a' + 10 : 16;
+			if (digit > 15) return false;
+
+			outValue = outValue << 4 | digit;
+		}
+
+		return true;
+	}
+
+	/// Document index
+	const JsonReader * reader;
+
+	/// First token of the value
+	uint32 token;
+};
+
+/**
+ * A field of an object.
+ */
+struct JsonField
+{
+	/// Field key, a string
+	JsonValue key;
+
+	/// Field value
+	JsonValue value;
+};
+
+FORCE_INLINE JsonValue JsonReader::getRoot() const
+{
+	return valid ? JsonValue{this, 0} : JsonValue{};
+}
+
+FORCE_INLINE JsonValue JsonItemIterator::operator*() const
+{
+	return JsonValue{reader, token};
+}
+
+FORCE_INLINE JsonField JsonFieldIterator::operator*() const
+{
+	return JsonField{JsonValue{reader, token}, JsonValue{reader, token + 2}};
+}
+
+inline uint64 JsonValue::getCount() const
+{
+	uint64 count = 0;
+	if (getType() == JsonType::Array) for (const JsonValue & item : getItems()) (void)item, ++count;
+	else for (const JsonField & field : getFields()) (void)field, ++count;
+
+	return count;
+}
+
+inline JsonValue JsonValue::getItem(uint64 idx) const
+{
+	for (const JsonValue & item : getItems()) if (idx-- == 0) return item;
+	return JsonValue{};
+}
+
+inline JsonValue JsonValue::operator[](const StringView & key) const
+{
+	for (const JsonField & field : getFields())
+	{
+		if (reader->getChar(field.key.token + 1) != ':') return JsonValue{};
+		if (field.key.equals(key)) return field.value;
+	}
+
+	return JsonValue{};
+}
+
+inline bool JsonValue::get(String & outValue) const
+{
+	if (getType() != JsonType::String) return false;
+
+	const StringView text = getText();
+	if (text.getLength() < 2 || text[text.getLength() - 1] != '"') return false;
+
+	const ansichar * it = *text + 1;
+	const ansichar * end = *text + text.getLength() - 1;
+
+	outValue = String{};
+	outValue.getArray().reserve(end - it + 1);
+
+	while (it < end)
+	{
+		// Copy the run before the escape
+		const ansichar * escape = static_cast<const ansichar*>(::memchr(it, '\\', end - it));
+		if (!escape) escape = end;
+
+		if (escape > it) appendChars(outValue, it, escape - it);
+		if (escape == end) break;
+
+		it = escape + 1;
+		if (it == end) return false;
+
+		switch (*it++)
+		{
+			case '"': outValue += '"'; break;
+			case '\\': outValue += '\\'; break;
+			case '/': outValue += '/'; break;
+			case 'b': outValue += '\b'; break;
+			case 'f': outValue += '\f'; break;
+			case 'n': outValue += '\n'; break;
+			case 'r': outValue += '\r'; break;
+			case 't': outValue += '\t'; break;
+			case 'u':
+			{
+				uint32 codePoint;
+				if (!parseHex4(it, end, codePoint)) return false;
+				it += 4;
+
+				if (codePoint >= 0xd800 && codePoint < 0xdc00)
+				{
+					// Surrogate pair
+					uint32 low;
+					if (end - it < 6 || it[0] != '\\' || it[1] != 'u' || !parseHex4(it + 2, end, low) || low < 0xdc00 || low >= 0xe000) return false;
+
+					codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+					it += 6;
+				}
+				else if (codePoint >= 0xdc00 && codePoint < 0xe000) return false;
+
+				appendUtf8(outValue, codePoint);
+				break;
+			}
+			default: return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+bool JsonValue::readField(const JsonField & field, String & outKey, T & outValue)
+{
+	return field.key.reader->getChar(field.key.token + 1) == ':' && field.key.get(outKey) && field.value.get(outValue);
+}
+
+template<typename T, typename CompareT, typename MallocT>
+bool JsonValue::get(Map<String, T, CompareT, MallocT> & outValue) const
+{
+	if (getType() != JsonType::Object) return false;
+
+	outValue.getTree().empty();
+	for (const JsonField & field : getFields())
+	{
+		String key;
+		T value{};
+		if (!readField(field, key, value)) return false;
+
+		outValue.insert(move(key), move(value));
+	}
+
+	return true;
+}
@@ -0,0 +1,489 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "hal/platform_memory.h"
+#include "hal/file.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "templates/optional.h"
+#include "templates/string_view.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Writes JSON to a string or a file,
+ * without building a document. Commas are
+ * inserted automatically, containers are
+ * written recursively:
+ *
+ * ```cpp
+ * String out;
+ * JsonWriter json{out};
+ *
+ * json.beginObject();
+ * json.field("name", name);
+ * json.field("scores", scores); // Array<float64>
+ * json.field("tags", tags); // Map<String, String>
+ * json.endObject();
+ * json.flush();
+ * ```
+ *
+ * Output is buffered and flushed when the
+ * buffer is full, on flush and when the
+ * writer is destroyed. Non-finite floats
+ * are written as null.
+ */
+class JsonWriter
+{
+public:
+	/// Size of the output buffer
+	static constexpr uint32 bufferSize = 1 << 12;
+
+	/// Max nesting depth
+	static constexpr uint32 maxDepth = 256;
+
+	/**
+	 * Creates a writer that appends to a
+	 * string.
+	 */
+	explicit FORCE_INLINE JsonWriter(String & inString)
+		: string{&inString}
+		, file{nullptr}
+		, used{0}
+		, depth{0}
+		, afterKey{false}
+	{
+		hasItems[0] = false;
+	}
+
+	/**
+	 * Creates a writer that writes to a
+	 * file.
+	 */
+	explicit FORCE_INLINE JsonWriter(File & inFile)
+		: string{nullptr}
+		, file{&inFile}
+		, used{0}
+		, depth{0}
+		, afterKey{false}
+	{
+		hasItems[0] = false;
+	}
+
+	JsonWriter(const JsonWriter&) = delete;
+	JsonWriter & operator=(const JsonWriter&) = delete;
+
+	/**
+	 * Flushes the buffer.
+	 */
+	FORCE_INLINE ~JsonWriter()
+	{
+		flush();
+	}
+
+	/**
+	 * Returns the current nesting depth.
+	 */
+	FORCE_INLINE uint32 getDepth() const
+	{
+		return depth;
+	}
+
+	/**
+	 * Writes the buffered output.
+	 */
+	void flush()
+	{
+		if (used == 0) return;
+
+		if (string)
+		{
+			const sizet length = string->getLength();
+			string->getArray()(length + used) = '\0';
+			Memory::memcpy(**string + length, buffer, used);
+		}
+		else file->write(buffer, used);
+
+		used = 0;
+	}
+
+	/**
+	 * Begins and ends an object or an
+	 * array.
+	 * @{
+	 */
+	FORCE_INLINE JsonWriter & beginObject()
+	{
+		return beginScope('{');
+	}
+
+	FORCE_INLINE JsonWriter & endObject()
+	{
+		return endScope('}');
+	}
+
+	FORCE_INLINE JsonWriter & beginArray()
+	{
+		return beginScope('[');
+	}
+
+	FORCE_INLINE JsonWriter & endArray()
+	{
+		return endScope(']');
+	}
+	/// @}
+
+	/**
+	 * Writes the key of the next field.
+	 * Integer keys are written as strings.
+	 * @{
+	 */
+	FORCE_INLINE JsonWriter & key(const StringView & name)
+	{
+		CHECKF(!afterKey, "Key without a value")
+
+		beginValue();
+		writeString(name);
+		put(':');
+		afterKey = true;
+
+		return *this;
+	}
+
+	FORCE_INLINE JsonWriter & key(const ansichar * name)
+	{
+		return key(StringView{name});
+	}
+
+	FORCE_INLINE JsonWriter & key(int64 name)
+	{
+		beginValue();
+		put('"');
+		writeInt(name);
+		put('"');
+		put(':');
+		afterKey = true;
+
+		return *this;
+	}
+
+	FORCE_INLINE JsonWriter & key(int32 name)
+	{
+		return key(static_cast<int64>(name));
+	}
+
+	FORCE_INLINE JsonWriter & key(uint32 name)
+	{
+		return key(static_cast<int64>(name));
+	}
+	/// @}
+
+	/**
+	 * Writes a key and a value.
+	 */
+	template<typename KeyT, typename T>
+	FORCE_INLINE JsonWriter & field(const KeyT & name, const T & value)
+	{
+		key(name);
+		return write(value);
+	}
+
+	/**
+	 * Writes null.
+	 */
+	FORCE_INLINE JsonWriter & writeNull()
+	{
+		beginValue();
+		putChars("null", 4);
+
+		return *this;
+	}
+
+	/**
+	 * Writes a value.
+	 * @{
+	 */
+	FORCE_INLINE JsonWriter & write(bool value)
+	{
+		beginValue();
+		if (value) putChars("true", 4);
+		else putChars("false", 5);
+
+		return *this;
+	}
+
+	FORCE_INLINE JsonWriter & write(int64 value)
+	{
+		beginValue();
+		writeInt(value);
+
+		return *this;
+	}
+
+	FORCE_INLINE JsonWriter & write(int32 value)
+	{
+		return write(static_cast<int64>(value));
+	}
+
+	FORCE_INLINE JsonWriter & write(uint32 value)
+	{
+		return write(static_cast<int64>(value));
+	}
+
+	FORCE_INLINE JsonWriter & write(uint64 value)
+	{
+		beginValue();
+		writeUint(value);
+
+		return *this;
+	}
+
+	JsonWriter & write(float64 value)
+	{
+		beginValue();
+
+		if (!__builtin_isfinite(value))
+		{
+			putChars("null", 4);
+			return *this;
+		}
+
+		// Shortest of the two precisions
+		// that reads back the same value
+		ansichar digits[32];
+		int32 n = ::snprintf(digits, sizeof(digits), "%.15g", value);
+		if (::strtod(digits, nullptr) != value) n = ::snprintf(digits, sizeof(digits), "%.17g", value);
+
+		putChars(digits, n);
+		return *this;
+	}
+
+	FORCE_INLINE JsonWriter & write(float32 value)
+	{
+		return write(static_cast<float64>(value));
+	}
+
+	FORCE_INLINE JsonWriter & write(const StringView & value)
+	{
+		beginValue();
+		writeString(value);
+
+		return *this;
+	}
+
+	FORCE_INLINE JsonWriter & write(const ansichar * value)
+	{
+		return write(StringView{value});
+	}
+
+	FORCE_INLINE JsonWriter & write(const String & value)
+	{
+		return write(StringView{value});
+	}
+
+	template<typename T, typename MallocT>
+	JsonWriter & write(const Array<T, MallocT> & value)
+	{
+		beginArray();
+		for (uint64 i = 0; i < value.getCount(); ++i) write(value[i]);
+
+		return endArray();
+	}
+
+	template<typename KeyT, typename T, typename CompareT, typename MallocT>
+	JsonWriter & write(const Map<KeyT, T, CompareT, MallocT> & value)
+	{
+		beginObject();
+		for (const auto & pair : value) field(pair.first, pair.second);
+
+		return endObject();
+	}
+
+	template<typename T>
+	JsonWriter & write(const Optional<T> & value)
+	{
+		return value ? write(*value) : writeNull();
+	}
+	/// @}
+
+protected:
+	/**
+	 * Writes a comma if the value is not
+	 * the first of its scope.
+	 */
+	FORCE_INLINE void beginValue()
+	{
+		if (afterKey)
+		{
+			afterKey = false;
+			return;
+		}
+
+		if (hasItems[depth]) put(',');
+		hasItems[depth] = true;
+	}
+
+	/**
+	 * Opens a scope.
+	 */
+	FORCE_INLINE JsonWriter & beginScope(ansichar bracket)
+	{
+		CHECKF(depth + 1 < maxDepth, "JSON nesting too deep")
+
+		beginValue();
+		put(bracket);
+		hasItems[++depth] = false;
+
+		return *this;
+	}
+
+	/**
+	 * Closes a scope.
+	 */
+	FORCE_INLINE JsonWriter & endScope(ansichar bracket)
+	{
+		CHECKF(depth > 0 && !afterKey, "Unbalanced JSON scope")
+
+		--depth;
+		put(bracket);
+
+		return *this;
+	}
+
+	/**
+	 * Appends a character to the buffer.
+	 */
+	FORCE_INLINE void put(ansichar c)
+	{
+		if (UNLIKELY(used == bufferSize)) flush();
+		buffer[used++] = c;
+	}
+
+	/**
+	 * Appends characters to the buffer.
+	 */
+	FORCE_INLINE void putChars(const ansichar * chars, sizet n)
+	{
+		if (UNLIKELY(used + n > bufferSize))
+		{
+			flush();
+
+			if (n > bufferSize)
+			{
+				// Write long runs directly
+				if (string)
+				{
+					const sizet length = string->getLength();
+					string->getArray()(length + n) = '\0';
+					Memory::memcpy(**string + length, chars, n);
+				}
+				else file->write(chars, n);
+
+				return;
+			}
+		}
+
+		Memory::memcpy(buffer + used, chars, n);
+		used += n;
+	}
+
+	/**
+	 * Writes a signed integer.
+	 */
+	FORCE_INLINE void writeInt(int64 value)
+	{
+		if (value < 0)
+		{
+			put('-');
+			writeUint(0ull - static_cast<uint64>(value));
+		}
+		else writeUint(value);
+	}
+
+	/**
+	 * Writes an unsigned integer.
+	 */
+	FORCE_INLINE void writeUint(uint64 value)
+	{
+		ansichar digits[20];
+		ansichar * it = digits + sizeof(digits);
+
+		do
+		{
+			*--it = '0' + value % 10;
+			value /= 10;
+		} while (value);
+
+		putChars(it, digits + sizeof(digits) - it);
+	}
+
+	/**
+	 * Writes a quoted string, escaping
+	 * quotes, backslashes and control
+	 * characters. Runs of characters that
+	 * need no escape are copied at once.
+	 */
+	void writeString(const StringView & value)
+	{
+		static constexpr ansichar hexDigits[] = "0123456789abcdef";
+
+		put('"');
+
+		const ansichar * it = *value;
+		const ansichar * end = it + value.getLength();
+		const ansichar * run = it;
+
+		for (; it < end; ++it)
+		{
+			const ubyte c = static_cast<ubyte>(*it);
+			if (LIKELY(c >= 0x20 && c != '"' && c != '\\')) continue;
+
+			putChars(run, it - run);
+			run = it + 1;
+
+			put('\\');
+			switch (c)
+			{
+				case '"': put('"'); break;
+				case '\\': put('\\'); break;
+				case '\n': put('n'); break;
+				case '\r': put('r'); break;
+				case '\t': put('t'); break;
+				case '\b': put('b'); break;
+				case '\f': put('f'); break;
+				default:
+				{
+					const ansichar escape[] = {'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xf]};
+					putChars(escape, sizeof(escape));
+				}
+			}
+		}
+
+		putChars(run, it - run);
+		put('"');
+	}
+
+	/// Target string
+	String * string;
+
+	/// Target file
+	File * file;
+
+	/// Output buffer
+	ansichar buffer[bufferSize];
+
+	/// Number of buffered characters
+	uint32 used;
+
+	/// Number of open scopes
+	uint32 depth;
+
+	/// True if each scope has items
+	bool hasItems[maxDepth];
+
+	/// True after a key
+	bool afterKey;
+};
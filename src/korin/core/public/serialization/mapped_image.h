@@ -0,0 +1,544 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "templates/types.h"
+#include "templates/utility.h"
+#include "templates/string_view.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_files.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "containers/mapped_array.h"
+#include "containers/mapped_flat_map.h"
+
+/**
+ * Sets type to the type used to store
+ * values of type T in a mapped image.
+ * Trivially copyable types are stored as
+ * they are, strings as MappedString.
+ * @{
+ */
+template<typename T>
+struct MappedType
+{
+	static_assert(IsTriviallyCopyable<T>::value, "Type cannot be stored in a mapped image");
+	using Type = T;
+};
+
+template<typename CharT>
+struct MappedType<StringBase<CharT>>
+{
+	using Type = MappedString;
+};
+
+template<>
+struct MappedType<StringView>
+{
+	using Type = MappedString;
+};
+/// @}
+
+/**
+ * Header at the start of a mapped image.
+ */
+struct MappedImageHeader
+{
+	/// Magic number, "KRNM"
+	static constexpr uint32 magicValue = 0x4d4e524b;
+
+	/// Magic number
+	uint32 magic;
+
+	/// Version of the data
+	uint32 version;
+
+	/// Size of the image in Bytes
+	uint64 size;
+
+	/// Position of the root object
+	uint64 rootPos;
+
+	/// Size of the root object
+	uint64 rootSize;
+};
+
+/**
+ * Builds a mapped image in memory. The
+ * image starts with a root object, whose
+ * views are then filled with arrays,
+ * strings and maps.
+ *
+ * Objects are addressed by their position
+ * in the image, because pointers are
+ * invalidated when the image grows.
+ *
+ * ```cpp
+ * struct Root
+ * {
+ * 	MappedArray<uint64> ids;
+ * 	MappedFlatMap<MappedString, uint32> index;
+ * };
+ *
+ * MappedImageWriter writer;
+ * const uint64 root = writer.allocateRoot<Root>();
+ * writer.writeArray(writer.getFieldPos(root, &Root::ids), ids);
+ * writer.writeFlatMap(writer.getFieldPos(root, &Root::index), index);
+ * writer.save("table.bin");
+ * ```
+ */
+class MappedImageWriter
+{
+public:
+	/// Alignment of all objects
+	static constexpr sizet minAlignment = 8;
+
+	/**
+	 * Creates an image with an empty
+	 * header.
+	 *
+	 * @param [inVersion] version of the
+	 * 	data
+	 */
+	explicit MappedImageWriter(uint32 inVersion = 0)
+		: bytes{}
+	{
+		const uint64 pos = allocate(sizeof(MappedImageHeader), alignof(MappedImageHeader));
+		MappedImageHeader & header = at<MappedImageHeader>(pos);
+		header.magic = MappedImageHeader::magicValue;
+		header.version = inVersion;
+	}
+
+	/**
+	 * Allocates zeroed memory at the end of
+	 * the image.
+	 *
+	 * @param size size in Bytes
+	 * @param alignment required alignment
+	 * @return position of the memory
+	 */
+	uint64 allocate(sizet size, sizet alignment = minAlignment)
+	{
+		alignment = alignment < minAlignment ? minAlignment : alignment;
+
+		const uint64 end = bytes.getCount();
+		const uint64 pos = (end + alignment - 1) & ~(alignment - 1);
+
+		// Padding is zeroed too
+		bytes.resize(pos + size);
+		Memory::memset(*bytes + end, 0, pos + size - end);
+
+		return pos;
+	}
+
+	/**
+	 * Allocates n objects of type T.
+	 *
+	 * @param [n] number of objects
+	 * @return position of the first object
+	 */
+	template<typename T>
+	FORCE_INLINE uint64 allocate(uint64 n = 1)
+	{
+		return allocate(n * sizeof(T), alignof(T));
+	}
+
+	/**
+	 * Allocates the root object.
+	 *
+	 * @return position of the root
+	 */
+	template<typename RootT>
+	uint64 allocateRoot()
+	{
+		CHECKF(at<MappedImageHeader>(0).rootSize == 0, "Image already has a root")
+
+		const uint64 pos = allocate<RootT>();
+		MappedImageHeader & header = at<MappedImageHeader>(0);
+		header.rootPos = pos;
+		header.rootSize = sizeof(RootT);
+
+		return pos;
+	}
+
+	/**
+	 * Returns a ref to the object at the
+	 * given position. The ref is valid until
+	 * the next allocation.
+	 */
+	template<typename T>
+	FORCE_INLINE T & at(uint64 pos)
+	{
+		return *reinterpret_cast<T*>(*bytes + pos);
+	}
+
+	/**
+	 * Returns the position of a member of
+	 * an object.
+	 *
+	 * @param pos position of the object
+	 * @param field pointer to member
+	 * @return position of the member
+	 */
+	template<typename OwnerT, typename FieldT>
+	FORCE_INLINE uint64 getFieldPos(uint64 pos, FieldT OwnerT::* field)
+	{
+		return reinterpret_cast<const ubyte*>(&(at<OwnerT>(pos).*field)) - *bytes;
+	}
+
+	/**
+	 * Writes a value at the given position.
+	 * Strings are written as MappedString
+	 * views, other values are copied.
+	 *
+	 * @param pos position of the value
+	 * @param value value to write
+	 * @{
+	 */
+	template<typename T>
+	FORCE_INLINE void writeValue(uint64 pos, const T & value)
+	{
+		static_assert(IsTriviallyCopyable<typename MappedType<T>::Type>::value, "Type cannot be stored in a mapped image");
+		Memory::memcpy(*bytes + pos, &value, sizeof(T));
+	}
+
+	template<typename CharT>
+	FORCE_INLINE void writeValue(uint64 pos, const StringBase<CharT> & value)
+	{
+		writeString(pos, StringView{value});
+	}
+
+	FORCE_INLINE void writeValue(uint64 pos, const StringView & value)
+	{
+		writeString(pos, value);
+	}
+	/// @}
+
+	/**
+	 * Writes the characters of a string and
+	 * sets the MappedString at the given
+	 * position.
+	 *
+	 * @param pos position of the string
+	 * @param string characters to write
+	 */
+	void writeString(uint64 pos, const StringView & string)
+	{
+		const uint64 dataPos = allocate(string.getLength(), 1);
+		if (!string.isEmpty()) Memory::memcpy(*bytes + dataPos, *string, string.getLength());
+
+		MappedString & view = at<MappedString>(pos);
+		view.offset = getOffset(pos, dataPos);
+		view.length = string.getLength();
+	}
+
+	/**
+	 * Writes the items of an array and sets
+	 * the MappedArray at the given
+	 * position.
+	 *
+	 * @param pos position of the array
+	 * @param items pointer to the items
+	 * @param n number of items
+	 */
+	template<typename T>
+	void writeArray(uint64 pos, const T * items, uint64 n)
+	{
+		using MappedT = typename MappedType<T>::Type;
+
+		const uint64 dataPos = allocate<MappedT>(n);
+		writeItems(dataPos, items, n);
+
+		setView(at<MappedArray<MappedT>>(pos), dataPos, n);
+	}
+
+	/**
+	 * Writes the items of an array.
+	 *
+	 * @param pos position of the array
+	 * @param array source array
+	 */
+	template<typename T, typename MallocT>
+	FORCE_INLINE void writeArray(uint64 pos, const Array<T, MallocT> & array)
+	{
+		writeArray(pos, *array, array.getCount());
+	}
+
+	/**
+	 * Writes a table of strings and sets the
+	 * MappedStringTable at the given
+	 * position.
+	 *
+	 * @param pos position of the table
+	 * @param strings pointer to the strings
+	 * @param n number of strings
+	 */
+	template<typename StringT>
+	void writeStringTable(uint64 pos, const StringT * strings, uint64 n)
+	{
+		uint64 numChars = 0;
+		for (uint64 i = 0; i < n; ++i) numChars += StringView{strings[i]}.getLength();
+
+		const uint64 offsetsPos = allocate<uint64>(n + 1);
+		const uint64 charsPos = allocate(numChars, 1);
+
+		uint64 offset = 0;
+		for (uint64 i = 0; i < n; ++i)
+		{
+			const StringView string{strings[i]};
+			at<uint64>(offsetsPos + i * sizeof(uint64)) = offset;
+			if (!string.isEmpty()) Memory::memcpy(*bytes + charsPos + offset, *string, string.getLength());
+			offset += string.getLength();
+		}
+
+		at<uint64>(offsetsPos + n * sizeof(uint64)) = offset;
+
+		MappedStringTable & table = at<MappedStringTable>(pos);
+		setView(table.offsets, offsetsPos, n + 1);
+		setView(table.chars, charsPos, numChars);
+	}
+
+	template<typename StringT, typename MallocT>
+	FORCE_INLINE void writeStringTable(uint64 pos, const Array<StringT, MallocT> & strings)
+	{
+		writeStringTable(pos, *strings, strings.getCount());
+	}
+
+	/**
+	 * Writes the pairs of a map and sets the
+	 * MappedFlatMap at the given position.
+	 *
+	 * @param pos position of the map
+	 * @param map source map
+	 */
+	template<typename KeyT, typename ValT, typename CompareT, typename MallocT>
+	void writeFlatMap(uint64 pos, const Map<KeyT, ValT, CompareT, MallocT> & map)
+	{
+		using MappedKeyT = typename MappedType<KeyT>::Type;
+		using MappedValT = typename MappedType<ValT>::Type;
+
+		const uint64 n = map.getCount();
+		const uint64 keysPos = allocate<MappedKeyT>(n);
+		const uint64 valuesPos = allocate<MappedValT>(n);
+
+		// Map is already sorted
+		uint64 i = 0;
+		for (const auto & pair : map)
+		{
+			writeValue(keysPos + i * sizeof(MappedKeyT), pair.first);
+			writeValue(valuesPos + i * sizeof(MappedValT), pair.second);
+			++i;
+		}
+
+		auto & view = at<MappedFlatMap<MappedKeyT, MappedValT, CompareT>>(pos);
+		setView(view.keys, keysPos, n);
+		setView(view.values, valuesPos, n);
+	}
+
+	/**
+	 * Returns the image bytes, with the
+	 * header updated.
+	 */
+	const Array<ubyte> & getBytes()
+	{
+		at<MappedImageHeader>(0).size = bytes.getCount();
+		return bytes;
+	}
+
+	/**
+	 * Writes the image to a file.
+	 *
+	 * @param path path of the file
+	 * @return true if image was written
+	 */
+	bool save(const ansichar * path)
+	{
+		const Array<ubyte> & image = getBytes();
+		return PlatformFiles::writeFile(path, *image, image.getCount());
+	}
+
+protected:
+	/**
+	 * Writes n values, one after the other.
+	 */
+	template<typename T>
+	void writeItems(uint64 pos, const T * items, uint64 n)
+	{
+		using MappedT = typename MappedType<T>::Type;
+
+		for (uint64 i = 0; i < n; ++i) writeValue(pos + i * sizeof(MappedT), items[i]);
+	}
+
+	/**
+	 * Returns the offset of the data
+	 * relative to the view.
+	 */
+	static FORCE_INLINE int64 getOffset(uint64 viewPos, uint64 dataPos)
+	{
+		return static_cast<int64>(dataPos) - static_cast<int64>(viewPos);
+	}
+
+	/**
+	 * Sets a view of n items. The view must
+	 * be inside the image.
+	 */
+	template<typename T>
+	FORCE_INLINE void setView(MappedArray<T> & view, uint64 dataPos, uint64 n)
+	{
+		view.offset = getOffset(reinterpret_cast<const ubyte*>(&view) - *bytes, dataPos);
+		view.count = n;
+	}
+
+	/// Image bytes
+	Array<ubyte> bytes;
+};
+
+/**
+ * A read-only image, mapped from a file
+ * or backed by a buffer. Opening an image
+ * only checks its header, data is paged
+ * in on first access.
+ */
+class MappedImage
+{
+public:
+	/**
+	 * Creates an empty image.
+	 */
+	FORCE_INLINE MappedImage()
+		: region{}
+		, mapped{false}
+	{
+		//
+	}
+
+	/**
+	 * Creates an image backed by a buffer,
+	 * which must outlive the image and be
+	 * aligned to 8 Bytes.
+	 *
+	 * @param data pointer to the image
+	 * @param size size of the image
+	 */
+	FORCE_INLINE MappedImage(const void * data, uint64 size)
+		: region{data, size}
+		, mapped{false}
+	{
+		if (!isValid()) region = {};
+	}
+
+	MappedImage(const MappedImage&) = delete;
+	MappedImage & operator=(const MappedImage&) = delete;
+
+	/**
+	 * Move constructor.
+	 */
+	FORCE_INLINE MappedImage(MappedImage && other)
+		: region{other.region}
+		, mapped{other.mapped}
+	{
+		other.region = {};
+		other.mapped = false;
+	}
+
+	/**
+	 * Unmaps the image.
+	 */
+	FORCE_INLINE ~MappedImage()
+	{
+		close();
+	}
+
+	/**
+	 * Maps an image file.
+	 *
+	 * @param path path of the file
+	 * @return true if file was mapped and
+	 * 	has a valid header
+	 */
+	bool open(const ansichar * path)
+	{
+		close();
+
+		region = PlatformFiles::mapFile(path);
+		mapped = region.data != nullptr;
+
+		if (!isValid())
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Unmaps the image.
+	 */
+	void close()
+	{
+		if (mapped) PlatformFiles::unmapFile(region);
+
+		region = {};
+		mapped = false;
+	}
+
+	/**
+	 * Returns true if image is open.
+	 */
+	FORCE_INLINE bool isOpen() const
+	{
+		return region.data != nullptr;
+	}
+
+	/**
+	 * Returns the header of the image.
+	 */
+	FORCE_INLINE const MappedImageHeader & getHeader() const
+	{
+		return *static_cast<const MappedImageHeader*>(region.data);
+	}
+
+	/**
+	 * Returns the version of the data.
+	 */
+	FORCE_INLINE uint32 getVersion() const
+	{
+		return getHeader().version;
+	}
+
+	/**
+	 * Returns the root object, or null if
+	 * image is not open or the size of the
+	 * root does not match.
+	 */
+	template<typename RootT>
+	FORCE_INLINE const RootT * getRoot() const
+	{
+		if (!isOpen() || getHeader().rootSize != sizeof(RootT)) return nullptr;
+		return reinterpret_cast<const RootT*>(static_cast<const ubyte*>(region.data) + getHeader().rootPos);
+	}
+
+protected:
+	/**
+	 * Returns true if the header is valid.
+	 */
+	bool isValid() const
+	{
+		if (!region.data || region.size < sizeof(MappedImageHeader)) return false;
+		if ((reinterpret_cast<uintp>(region.data) & (MappedImageWriter::minAlignment - 1)) != 0) return false;
+
+		const MappedImageHeader & header = getHeader();
+		return header.magic == MappedImageHeader::magicValue
+			&& header.size == region.size
+			&& header.rootPos + header.rootSize <= region.size;
+	}
+
+	/// Mapped region
+	MappedFileRegion region;
+
+	/// True if region was mapped from a
+	/// file
+	bool mapped;
+};
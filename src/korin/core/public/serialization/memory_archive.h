@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_memory.h"
+#include "containers/array.h"
+#include "./archive.h"
+
+/**
+ * An archive that saves values to the end
+ * of an array of bytes.
+ */
+class MemoryWriter final : public Archive
+{
+public:
+	/**
+	 * Creates a writer that appends to the
+	 * given array.
+	 *
+	 * @param inBytes destination array
+	 */
+	FORCE_INLINE explicit MemoryWriter(Array<ubyte> & inBytes)
+		: Archive{false}
+		, bytes{inBytes}
+	{
+		//
+	}
+
+	/**
+	 * @copydoc Archive::serializeBytes
+	 */
+	virtual void serializeBytes(void * data, sizet size) override
+	{
+		const uint64 pos = bytes.getCount();
+		bytes.resize(pos + size);
+		Memory::memcpy(*bytes + pos, data, size);
+	}
+
+protected:
+	/// Destination array
+	Array<ubyte> & bytes;
+};
+
+/**
+ * An archive that loads values from a
+ * buffer of bytes. The buffer must
+ * outlive the reader.
+ */
+class MemoryReader final : public Archive
+{
+public:
+	/**
+	 * Creates a reader of a buffer.
+	 *
+	 * @param inData pointer to the bytes
+	 * @param inSize number of bytes
+	 */
+	FORCE_INLINE MemoryReader(const void * inData, uint64 inSize)
+		: Archive{true}
+		, data{static_cast<const ubyte*>(inData)}
+		, size{inSize}
+		, pos{0}
+	{
+		//
+	}
+
+	/**
+	 * Creates a reader of an array.
+	 *
+	 * @param inBytes source array
+	 */
+	FORCE_INLINE explicit MemoryReader(const Array<ubyte> & inBytes)
+		: MemoryReader{*inBytes, inBytes.getCount()}
+	{
+		//
+	}
+
+	/**
+	 * @copydoc Archive::serializeBytes
+	 */
+	virtual void serializeBytes(void * dst, sizet numBytes) override
+	{
+		if (error || numBytes > size - pos)
+		{
+			Memory::memset(dst, 0, numBytes);
+			setError();
+			return;
+		}
+
+		Memory::memcpy(dst, data + pos, numBytes);
+		pos += numBytes;
+	}
+
+	/**
+	 * @copydoc Archive::getRemainingBytes
+	 */
+	virtual uint64 getRemainingBytes() const override
+	{
+		return size - pos;
+	}
+
+	/**
+	 * Returns the number of bytes read.
+	 */
+	FORCE_INLINE uint64 getPos() const
+	{
+		return pos;
+	}
+
+protected:
+	/// Pointer to the bytes
+	const ubyte * data;
+
+	/// Number of bytes
+	uint64 size;
+
+	/// Read position
+	uint64 pos;
+};
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_math.h"
+#include "hal/memory_base.h"
+#include "templates/string_view.h"
+
+#include <stdlib.h>
+#include <locale.h>
+#if PLATFORM_APPLE
+	#include <xlocale.h>
+#endif
+
+/**
+ * Parses integers and floating point
+ * numbers from a range of characters,
+ * without requiring a terminator and
+ * without locale lookups.
+ *
+ * Floats with at most 19 significant
+ * digits and a small exponent are
+ * computed exactly with a single multiply
+ * or divide by a power of ten. Other
+ * floats fall back to strtod, always in
+ * the C locale.
+ */
+struct NumberParser
+{
+	/**
+	 * Parses a signed decimal integer.
+	 *
+	 * @param it start of the number, moved
+	 * 	past the last parsed character
+	 * @param end end of the range
+	 * @param outValue parsed value
+	 * @return false if there are no digits
+	 * 	or the value overflows
+	 */
+	static bool parseInt64(const ansichar *& it, const ansichar * end, int64 & outValue)
+	{
+		const ansichar * p = it;
+		const bool negative = p < end && *p == '-';
+		p += p < end && (*p == '-' || *p == '+');
+
+		const ansichar * digits = p;
+		uint64 value = 0;
+		for (; p < end && isDigit(*p); ++p)
+		{
+			const uint64 digit = *p - '0';
+			if (UNLIKELY(value > (~0ull - digit) / 10)) return false;
+
+			value = value * 10 + digit;
+		}
+
+		if (p == digits) return false;
+
+		// -2^63 fits, 2^63 doesn't
+		if (value > (1ull << 63) - !negative) return false;
+
+		outValue = negative ? static_cast<int64>(0ull - value) : static_cast<int64>(value);
+		it = p;
+
+		return true;
+	}
+
+	/**
+	 * Parses a decimal floating point
+	 * number, with optional fraction and
+	 * exponent. Also accepts inf and nan.
+	 *
+	 * @param it start of the number, moved
+	 * 	past the last parsed character
+	 * @param end end of the range
+	 * @param outValue parsed value
+	 * @return false if there are no digits
+	 */
+	static bool parseFloat64(const ansichar *& it, const ansichar * end, float64 & outValue)
+	{
+		const ansichar * p = it;
+		const bool negative = p < end && *p == '-';
+		p += p < end && (*p == '-' || *p == '+');
+
+		uint64 mantissa = 0;
+		int32 numDigits = 0;
+		int32 exponent = 0;
+
+		// Leading zeros are not significant
+		const ansichar * digits = p;
+		for (; p < end && *p == '0'; ++p);
+
+		for (; p < end && isDigit(*p); ++p, ++numDigits) mantissa = mantissa * 10 + (*p - '0');
+		bool hasDigits = p > digits;
+
+		if (p < end && *p == '.')
+		{
+			const ansichar * fraction = ++p;
+			if (numDigits == 0) for (; p < end && *p == '0'; ++p);
+
+			for (; p < end && isDigit(*p); ++p, ++numDigits) mantissa = mantissa * 10 + (*p - '0');
+
+			exponent -= p - fraction;
+			hasDigits |= p > fraction;
+		}
+
+		if (!hasDigits) return parseSpecial(it, end, outValue);
+
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			const ansichar * expIt = p + 1;
+			const bool expNegative = expIt < end && *expIt == '-';
+			expIt += expIt < end && (*expIt == '-' || *expIt == '+');
+
+			if (expIt < end && isDigit(*expIt))
+			{
+				// Saturate, larger exponents give
+				// inf or 0 anyway
+				int32 expValue = 0;
+				for (; expIt < end && isDigit(*expIt); ++expIt) expValue = PlatformMath::min(expValue * 10 + (*expIt - '0'), 100000);
+
+				exponent += expNegative ? -expValue : expValue;
+				p = expIt;
+			}
+		}
+
+		if (LIKELY(numDigits <= 19 && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22))
+		{
+			// Both the mantissa and the power of
+			// ten are exact, so is the result
+			float64 value = static_cast<float64>(mantissa);
+			value = exponent < 0 ? value / powersOfTen()[-exponent] : value * powersOfTen()[exponent];
+
+			outValue = negative ? -value : value;
+			it = p;
+
+			return true;
+		}
+
+		return parseSlow(it, p, outValue);
+	}
+
+	/**
+	 * Parses a whole string as a number.
+	 *
+	 * @param str string to parse
+	 * @param outValue parsed value
+	 * @return false if the string is not
+	 * 	a number or has trailing characters
+	 * @{
+	 */
+	static FORCE_INLINE bool parse(const StringView & str, int64 & outValue)
+	{
+		const ansichar * it = *str;
+		const ansichar * end = it + str.getLength();
+		return parseInt64(it, end, outValue) && it == end;
+	}
+
+	static FORCE_INLINE bool parse(const StringView & str, float64 & outValue)
+	{
+		const ansichar * it = *str;
+		const ansichar * end = it + str.getLength();
+		return parseFloat64(it, end, outValue) && it == end;
+	}
+	/// @}
+
+protected:
+	/**
+	 * Returns true if the character is a
+	 * decimal digit.
+	 */
+	static FORCE_INLINE bool isDigit(ansichar c)
+	{
+		return static_cast<ubyte>(c - '0') < 10;
+	}
+
+	/**
+	 * Returns the powers of ten that are
+	 * exactly representable.
+	 */
+	static FORCE_INLINE const float64 * powersOfTen()
+	{
+		static constexpr float64 powers[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		return powers;
+	}
+
+	/**
+	 * Parses inf and nan, case insensitive.
+	 */
+	static bool parseSpecial(const ansichar *& it, const ansichar * end, float64 & outValue)
+	{
+		const ansichar * p = it;
+		const bool negative = p < end && *p == '-';
+		p += p < end && (*p == '-' || *p == '+');
+
+		auto matches = [p, end](const ansichar * word) {
+
+			for (const ansichar * q = p; *word; ++q, ++word) if (q == end || (*q | 0x20) != *word) return false;
+			return true;
+		};
+
+		if (matches("inf"))
+		{
+			outValue = negative ? -__builtin_inf() : __builtin_inf();
+			it = p + (matches("infinity") ? 8 : 3);
+			return true;
+		}
+
+		if (matches("nan"))
+		{
+			outValue = negative ? -__builtin_nan("") : __builtin_nan("");
+			it = p + 3;
+			return true;
+		}
+
+		return false;
+	}
+
+#if PLATFORM_WINDOWS
+	using LocaleT = _locale_t;
+#else
+	using LocaleT = locale_t;
+#endif
+
+	/**
+	 * Returns the C locale, created once,
+	 * so that the decimal point does not
+	 * depend on LC_NUMERIC.
+	 */
+	static LocaleT getCLocale()
+	{
+#if PLATFORM_WINDOWS
+		static const LocaleT locale = ::_create_locale(LC_ALL, "C");
+#else
+		static const LocaleT locale = ::newlocale(LC_ALL_MASK, "C", LocaleT{});
+#endif
+		return locale;
+	}
+
+	/**
+	 * Parses the number in the range with
+	 * strtod, which is always correctly
+	 * rounded.
+	 */
+	static bool parseSlow(const ansichar *& it, const ansichar * end, float64 & outValue)
+	{
+		// strtod needs a terminator
+		ansichar local[64];
+		const sizet length = end - it;
+		ansichar * buffer = length < sizeof(local) ? local : static_cast<ansichar*>(gMalloc->alloc(length + 1));
+
+		Memory::memcpy(buffer, it, length);
+		buffer[length] = '\0';
+
+		ansichar * parsedEnd;
+#if PLATFORM_WINDOWS
+		outValue = ::_strtod_l(buffer, &parsedEnd, getCLocale());
+#else
+		outValue = ::strtod_l(buffer, &parsedEnd, getCLocale());
+#endif
+		it += parsedEnd - buffer;
+
+		if (buffer != local) gMalloc->free(buffer);
+
+		return true;
+	}
+};
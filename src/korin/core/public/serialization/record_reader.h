@@ -0,0 +1,279 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/assert.h"
+#include "hal/platform_memory.h"
+#include "hal/memory_base.h"
+#include "hal/file.h"
+#include "templates/string_view.h"
+#include "./char_finder.h"
+
+/**
+ * Splits a string into the tokens between
+ * delimiters, without copying. Empty
+ * tokens are kept, so that fields of a
+ * record keep their position.
+ *
+ * ```cpp
+ * StringSplitter fields{"a,,b", ","};
+ * StringView field;
+ * while (fields.next(field)) ; // "a", "", "b"
+ * ```
+ */
+class StringSplitter
+{
+public:
+	/**
+	 * Creates a splitter.
+	 *
+	 * @param inInput string to split
+	 * @param delimiters up to 4 delimiter
+	 * 	characters
+	 */
+	FORCE_INLINE StringSplitter(const StringView & inInput, const StringView & delimiters)
+		: finder{delimiters}
+		, it{*inInput}
+		, end{*inInput + inInput.getLength()}
+		, done{false}
+	{
+		//
+	}
+
+	/**
+	 * Returns the next token.
+	 *
+	 * @param outToken view of the token
+	 * @return false if there are no more
+	 * 	tokens
+	 */
+	FORCE_INLINE bool next(StringView & outToken)
+	{
+		if (done) return false;
+
+		const ansichar * found = finder.find(it, end);
+		outToken = StringView{it, static_cast<sizet>(found - it)};
+
+		if (found == end) done = true;
+		else it = found + 1;
+
+		return true;
+	}
+
+	/**
+	 * Returns the rest of the string, not
+	 * split yet.
+	 */
+	FORCE_INLINE StringView getRemaining() const
+	{
+		return done ? StringView{} : StringView{it, static_cast<sizet>(end - it)};
+	}
+
+protected:
+	/// Delimiter finder
+	CharFinder finder;
+
+	/// Start of the next token
+	const ansichar * it;
+
+	/// End of the string
+	const ansichar * end;
+
+	/// True after the last token
+	bool done;
+};
+
+/**
+ * Reads records separated by a delimiter
+ * from a file, e.g. the lines of a log.
+ * Records are views into an internal
+ * buffer and are valid until the next
+ * call. A record that spans two reads is
+ * moved to the start of the buffer, and
+ * the buffer grows to fit records longer
+ * than the buffer.
+ *
+ * Records are null-terminated in place,
+ * so they can be passed to functions that
+ * expect C strings, like Re::Regex:
+ *
+ * ```cpp
+ * File file{"server.log"};
+ * RecordReader lines{file};
+ *
+ * StringView line;
+ * while (lines.next(line)) if (regex.accept(*line)) ++numErrors;
+ * ```
+ *
+ * When the delimiter is a newline, a
+ * trailing carriage return is dropped.
+ */
+class RecordReader
+{
+public:
+	/// Default size of the buffer
+	static constexpr uint64 defaultBufferSize = 1 << 20;
+
+	/**
+	 * Creates a reader that reads from the
+	 * current position of a file.
+	 *
+	 * @param inFile file to read
+	 * @param [delimiter] record delimiter
+	 * @param [bufferSize] initial size of
+	 * 	the buffer
+	 */
+	explicit RecordReader(File & inFile, ansichar delimiter = '\n', uint64 bufferSize = defaultBufferSize)
+		: file{inFile}
+		, finder{delimiter}
+		, malloc{gMalloc}
+		, buffer{nullptr}
+		, capacity{PlatformMath::max(bufferSize, 16ull)}
+		, pos{0}
+		, scanPos{0}
+		, end{0}
+		, numRecords{0}
+		, eof{false}
+		, trimCarriageReturn{delimiter == '\n'}
+	{
+		// One more byte to terminate the
+		// last record
+		buffer = static_cast<ansichar*>(malloc->alloc(capacity + 1));
+		file.setAccessHint(FileAccessHint::Sequential);
+	}
+
+	RecordReader(const RecordReader&) = delete;
+	RecordReader & operator=(const RecordReader&) = delete;
+
+	/**
+	 * Frees the buffer.
+	 */
+	FORCE_INLINE ~RecordReader()
+	{
+		malloc->free(buffer);
+	}
+
+	/**
+	 * Returns the number of records read.
+	 */
+	FORCE_INLINE uint64 getNumRecords() const
+	{
+		return numRecords;
+	}
+
+	/**
+	 * Returns the next record.
+	 *
+	 * @param outRecord view of the record,
+	 * 	without the delimiter
+	 * @return false if there are no more
+	 * 	records
+	 */
+	bool next(StringView & outRecord)
+	{
+		for (;;)
+		{
+			ansichar * found = finder.find(buffer + scanPos, buffer + end);
+			if (found != buffer + end)
+			{
+				emitRecord(outRecord, found);
+				pos = scanPos = found - buffer + 1;
+
+				return true;
+			}
+
+			if (eof)
+			{
+				// Last record may not have a
+				// delimiter
+				if (pos == end) return false;
+
+				emitRecord(outRecord, buffer + end);
+				pos = scanPos = end;
+
+				return true;
+			}
+
+			// Don't scan the partial record
+			// again
+			scanPos = end;
+			fillBuffer();
+		}
+	}
+
+protected:
+	/**
+	 * Terminates the record that ends at
+	 * the given position.
+	 */
+	FORCE_INLINE void emitRecord(StringView & outRecord, ansichar * recordEnd)
+	{
+		if (trimCarriageReturn && recordEnd > buffer + pos && recordEnd[-1] == '\r') --recordEnd;
+
+		*recordEnd = '\0';
+		outRecord = StringView{buffer + pos, static_cast<sizet>(recordEnd - (buffer + pos))};
+		++numRecords;
+	}
+
+	/**
+	 * Moves the partial record to the start
+	 * of the buffer and reads more bytes.
+	 */
+	void fillBuffer()
+	{
+		const uint64 partialSize = end - pos;
+		if (pos > 0)
+		{
+			Memory::memmov(buffer, buffer + pos, partialSize);
+			scanPos -= pos;
+			end = partialSize;
+			pos = 0;
+		}
+
+		if (end == capacity)
+		{
+			// Record is longer than the buffer
+			capacity *= 2;
+			buffer = static_cast<ansichar*>(malloc->realloc(buffer, capacity + 1));
+		}
+
+		const uint64 numRead = file.read(buffer + end, capacity - end);
+		end += numRead;
+		eof = numRead == 0;
+	}
+
+	/// Source file
+	File & file;
+
+	/// Delimiter finder
+	CharFinder finder;
+
+	/// Allocator of the buffer, gMalloc
+	/// at construction
+	MallocBase * malloc;
+
+	/// Buffer, with room for a terminator
+	ansichar * buffer;
+
+	/// Size of the buffer
+	uint64 capacity;
+
+	/// Start of the next record
+	uint64 pos;
+
+	/// Position of the first byte not
+	/// scanned yet
+	uint64 scanPos;
+
+	/// End of the valid bytes
+	uint64 end;
+
+	/// Number of records read
+	uint64 numRecords;
+
+	/// True if the file has no more bytes
+	bool eof;
+
+	/// True if carriage returns before the
+	/// delimiter are dropped
+	bool trimCarriageReturn;
+};
@@ -3,6 +3,7 @@
 #include "core_types.h"
 #include "templates/types.h"
 #include "templates/utility.h"
+#include "hal/malloc_ansi.h"
 
 /**
  * @{
@@ -344,7 +345,14 @@ public:
 	 */
 	FORCE_INLINE Function & operator=(Function && other)
 	{
-		swap(*this, other);
+		if (this != &other)
+		{
+			// Generic swap would call this
+			// operator again
+			this->~Function();
+			new (this) Function{move(other)};
+		}
+
 		return *this;
 	}
 
@@ -43,4 +43,26 @@ struct ThreeWayCompare
 	{
 		return *this(forward<A>(*a), forward<B>(*b));
 	}
-};
\ No newline at end of file
+};
+
+/**
+ * Compare type that inverts the order
+ * defined by another compare object,
+ * e.g. to turn a max-heap into a
+ * min-heap. It only holds a ref to
+ * the wrapped compare object.
+ * 
+ * @param CompareT wrapped compare type
+ */
+template<typename CompareT>
+struct InverseCompare
+{
+	/// Wrapped compare object
+	const CompareT & cmp;
+
+	template<typename A, typename B>
+	FORCE_INLINE int32 operator()(A && a, B && b) const
+	{
+		return cmp(forward<B>(b), forward<A>(a));
+	}
+};
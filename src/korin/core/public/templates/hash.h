@@ -0,0 +1,466 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_memory.h"
+#include "./enable_if.h"
+#include "./types.h"
+#include "./utility.h"
+#include "./string_view.h"
+
+#if PLATFORM_USE_SIMD && defined(__AVX2__)
+	#define HASH_USE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define HASH_USE_AVX2 0
+#endif
+
+/**
+ * Hash utilities.
+ */
+struct HashUtils
+{
+	/// Inputs longer than this are hashed
+	/// with the striped long hash
+	static constexpr sizet longInputLength = 256;
+
+	/**
+	 * Finalizer of MurmurHash3, mixes
+	 * all the bits of the input so that
+	 * flipping one bit flips each output
+	 * bit with probability 1/2.
+	 *
+	 * @param x value to mix
+	 * @return mixed value
+	 */
+	static constexpr FORCE_INLINE uint64 fmix64(uint64 x)
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
+	}
+
+	/**
+	 * Multiplies two 64-bit values and
+	 * folds the 128-bit product with a
+	 * xor of its halves.
+	 */
+	static FORCE_INLINE uint64 mix(uint64 a, uint64 b)
+	{
+		const __uint128_t product = static_cast<__uint128_t>(a) * b;
+		return static_cast<uint64>(product) ^ static_cast<uint64>(product >> 64);
+	}
+
+	/**
+	 * Combines a hash into a seed, the
+	 * result depends on the order of the
+	 * combined hashes.
+	 *
+	 * @param seed current hash
+	 * @param hash hash to combine
+	 * @return combined hash
+	 */
+	static FORCE_INLINE uint64 combine(uint64 seed, uint64 hash)
+	{
+		return mix(seed ^ secret[0], hash ^ secret[1]);
+	}
+
+	/**
+	 * Hashes a sequence of bytes. Short
+	 * inputs use wyhash, long inputs a
+	 * striped hash in the style of XXH3,
+	 * vectorized with AVX2. Both produce
+	 * the same values with and without
+	 * AVX2.
+	 *
+	 * @param data pointer to the bytes
+	 * @param length number of bytes
+	 * @param [seed] hash seed
+	 * @return 64-bit hash
+	 */
+	static FORCE_INLINE uint64 hashBytes(const void * data, sizet length, uint64 seed = 0)
+	{
+		return length <= longInputLength ? hashShort(static_cast<const ubyte*>(data), length, seed) : hashLong(static_cast<const ubyte*>(data), length, seed);
+	}
+
+	/**
+	 * Hashes any number of values and
+	 * combines their hashes.
+	 *
+	 * @param values values to hash
+	 * @return combined hash
+	 */
+	template<typename ...ValuesT>
+	static FORCE_INLINE uint64 hashValues(const ValuesT & ...values);
+
+	/**
+	 * Hash of short inputs, wyhash final
+	 * version 4.
+	 */
+	static uint64 hashShort(const ubyte * p, sizet length, uint64 seed)
+	{
+		seed ^= mix(seed ^ secret[0], secret[1]);
+
+		uint64 a, b;
+		if (length <= 16)
+		{
+			if (length >= 4)
+			{
+				a = (read32(p) << 32) | read32(p + ((length >> 3) << 2));
+				b = (read32(p + length - 4) << 32) | read32(p + length - 4 - ((length >> 3) << 2));
+			}
+			else if (length > 0)
+			{
+				a = (static_cast<uint64>(p[0]) << 16) | (static_cast<uint64>(p[length >> 1]) << 8) | p[length - 1];
+				b = 0;
+			}
+			else a = b = 0;
+		}
+		else
+		{
+			sizet i = length;
+			if (i >= 48)
+			{
+				uint64 see1 = seed, see2 = seed;
+				do
+				{
+					seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+					see1 = mix(read64(p + 16) ^ secret[2], read64(p + 24) ^ see1);
+					see2 = mix(read64(p + 32) ^ secret[3], read64(p + 40) ^ see2);
+					p += 48, i -= 48;
+				} while (i >= 48);
+
+				seed ^= see1 ^ see2;
+			}
+
+			while (i > 16)
+			{
+				seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+				p += 16, i -= 16;
+			}
+
+			a = read64(p + i - 16);
+			b = read64(p + i - 8);
+		}
+
+		a ^= secret[1];
+		b ^= seed;
+
+		const __uint128_t product = static_cast<__uint128_t>(a) * b;
+		a = static_cast<uint64>(product), b = static_cast<uint64>(product >> 64);
+
+		return mix(a ^ secret[0] ^ length, b ^ secret[1]);
+	}
+
+	/**
+	 * Hash of long inputs. The input is
+	 * split in 64-byte stripes, each
+	 * accumulated in eight 64-bit lanes,
+	 * and the accumulators are scrambled
+	 * every 16 stripes.
+	 * @{
+	 */
+	static uint64 hashLong(const ubyte * p, sizet length, uint64 seed)
+	{
+#if HASH_USE_AVX2
+		return hashLongAvx2(p, length, seed);
+#else
+		return hashLongScalar(p, length, seed);
+#endif
+	}
+
+	static uint64 hashLongScalar(const ubyte * p, sizet length, uint64 seed)
+	{
+		uint64 keys[numLongKeys];
+		uint64 acc[8];
+		initLong(keys, acc, seed);
+
+		const sizet numStripes = (length - 1) / 64;
+		for (sizet stripe = 0; stripe < numStripes; ++stripe)
+		{
+			accumulateScalar(acc, p + stripe * 64, keys + (stripe % stripesPerBlock));
+			if (stripe % stripesPerBlock == stripesPerBlock - 1) scrambleScalar(acc, keys + stripesPerBlock);
+		}
+
+		// Last stripe overlaps the previous
+		accumulateScalar(acc, p + length - 64, keys + lastStripeKey);
+
+		return finalizeLong(acc, keys, length);
+	}
+
+#if HASH_USE_AVX2
+	static uint64 hashLongAvx2(const ubyte * p, sizet length, uint64 seed)
+	{
+		uint64 keys[numLongKeys];
+		alignas(32) uint64 acc[8];
+		initLong(keys, acc, seed);
+
+		__m256i acc0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc));
+		__m256i acc1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + 4));
+
+		const sizet numStripes = (length - 1) / 64;
+		for (sizet stripe = 0; stripe < numStripes; ++stripe)
+		{
+			accumulateAvx2(acc0, acc1, p + stripe * 64, keys + (stripe % stripesPerBlock));
+			if (stripe % stripesPerBlock == stripesPerBlock - 1) scrambleAvx2(acc0, acc1, keys + stripesPerBlock);
+		}
+
+		accumulateAvx2(acc0, acc1, p + length - 64, keys + lastStripeKey);
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(acc), acc0);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(acc + 4), acc1);
+
+		return finalizeLong(acc, keys, length);
+	}
+#endif
+	/// @}
+
+protected:
+	/// Secret of wyhash
+	static constexpr uint64 secret[4] = {
+		0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+	};
+
+	/// Number of stripes between two
+	/// scrambles
+	static constexpr uint32 stripesPerBlock = 16;
+
+	/// Number of keys of the long hash,
+	/// stripe i uses keys [i % 16, i % 16
+	/// + 8), the scramble uses keys [16,
+	/// 24)
+	static constexpr uint32 numLongKeys = stripesPerBlock + 8;
+
+	/// Keys used by the last stripe
+	static constexpr uint32 lastStripeKey = 7;
+
+	/// Keys of the long hash, derived from
+	/// the digits of pi
+	static constexpr uint64 longKeys[numLongKeys] = {
+		0x243f6a8885a308d3ull, 0x13198a2e03707344ull, 0xa4093822299f31d0ull, 0x082efa98ec4e6c89ull,
+		0x452821e638d01377ull, 0xbe5466cf34e90c6cull, 0xc0ac29b7c97c50ddull, 0x3f84d5b5b5470917ull,
+		0x9216d5d98979fb1bull, 0xd1310ba698dfb5acull, 0x2ffd72dbd01adfb7ull, 0xb8e1afed6a267e96ull,
+		0xba7c9045f12c7f99ull, 0x24a19947b3916cf7ull, 0x0801f2e2858efc16ull, 0x636920d871574e69ull,
+		0xa458fea3f4933d7eull, 0x0d95748f728eb658ull, 0x718bcd5882154aeeull, 0x7b54a41dc25a59b5ull,
+		0x9c30d5392af26013ull, 0xc5d1b023286085f0ull, 0xca417918b8db38efull, 0x8e79dcb0603a180eull
+	};
+
+	/// 32-bit prime used by the scramble
+	static constexpr uint64 scramblePrime = 0x9e3779b1ull;
+
+	/**
+	 * Unaligned little endian reads.
+	 * @{
+	 */
+	static FORCE_INLINE uint64 read64(const ubyte * p)
+	{
+		uint64 value;
+		Memory::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	static FORCE_INLINE uint64 read32(const ubyte * p)
+	{
+		uint32 value;
+		Memory::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+	/// @}
+
+	/**
+	 * Derives the keys from the seed and
+	 * initializes the accumulators.
+	 */
+	static FORCE_INLINE void initLong(uint64 * keys, uint64 * acc, uint64 seed)
+	{
+		for (uint32 i = 0; i < numLongKeys; ++i) keys[i] = i & 1 ? longKeys[i] - seed : longKeys[i] + seed;
+		for (uint32 i = 0; i < 8; ++i) acc[i] = secret[i & 3] ^ (0x9e3779b97f4a7c15ull * (i + 1));
+	}
+
+	/**
+	 * Accumulates one stripe. Each lane
+	 * adds the product of the halves of
+	 * the data xor the key, and the data
+	 * of the adjacent lane.
+	 */
+	static FORCE_INLINE void accumulateScalar(uint64 * acc, const ubyte * p, const uint64 * keys)
+	{
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			const uint64 data = read64(p + i * 8);
+			const uint64 dataKey = data ^ keys[i];
+			acc[i ^ 1] += data;
+			acc[i] += (dataKey & 0xffffffffull) * (dataKey >> 32);
+		}
+	}
+
+	/**
+	 * Scrambles the accumulators.
+	 */
+	static FORCE_INLINE void scrambleScalar(uint64 * acc, const uint64 * keys)
+	{
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			uint64 value = acc[i];
+			value ^= value >> 47;
+			value ^= keys[i];
+			acc[i] = value * scramblePrime;
+		}
+	}
+
+#if HASH_USE_AVX2
+	/**
+	 * AVX2 version of accumulateScalar.
+	 */
+	static FORCE_INLINE void accumulateAvx2(__m256i & acc0, __m256i & acc1, const ubyte * p, const uint64 * keys)
+	{
+		const __m256i data0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		const __m256i data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+		const __m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)));
+		const __m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 4)));
+
+		const __m256i product0 = _mm256_mul_epu32(dataKey0, _mm256_srli_epi64(dataKey0, 32));
+		const __m256i product1 = _mm256_mul_epu32(dataKey1, _mm256_srli_epi64(dataKey1, 32));
+
+		// Swap adjacent 64-bit lanes
+		const __m256i swapped0 = _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2));
+		const __m256i swapped1 = _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2));
+
+		acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(product0, swapped0));
+		acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(product1, swapped1));
+	}
+
+	/**
+	 * AVX2 version of scrambleScalar.
+	 */
+	static FORCE_INLINE __m256i scrambleAvx2(__m256i acc, const uint64 * keys)
+	{
+		const __m256i prime = _mm256_set1_epi32(static_cast<int32>(scramblePrime));
+
+		acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+		acc = _mm256_xor_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)));
+
+		// 64x32-bit multiplication
+		const __m256i lo = _mm256_mul_epu32(acc, prime);
+		const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime);
+		return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+	}
+
+	static FORCE_INLINE void scrambleAvx2(__m256i & acc0, __m256i & acc1, const uint64 * keys)
+	{
+		acc0 = scrambleAvx2(acc0, keys);
+		acc1 = scrambleAvx2(acc1, keys + 4);
+	}
+#endif
+
+	/**
+	 * Merges the accumulators into the
+	 * final hash.
+	 */
+	static FORCE_INLINE uint64 finalizeLong(const uint64 * acc, const uint64 * keys, sizet length)
+	{
+		uint64 result = length * 0x9e3779b185ebca87ull;
+		for (uint32 i = 0; i < 4; ++i) result += mix(acc[2 * i] ^ keys[2 * i + 3], acc[2 * i + 1] ^ keys[2 * i + 4]);
+
+		return fmix64(result);
+	}
+};
+
+/**
+ * Hash function object. Specializations
+ * define a const call operator that
+ * returns a 64-bit hash of the value.
+ *
+ * To make a type hashable, specialize
+ * Hash for it next to its definition,
+ * and use HashUtils::combine or
+ * HashUtils::hashValues to hash its
+ * members.
+ *
+ * @param T type of the hashed values
+ */
+template<typename T, typename = void>
+struct Hash;
+
+/**
+ * Hash of integral values.
+ */
+template<typename T>
+struct Hash<T, typename EnableIf<IsIntegral<T>::value>::Type>
+{
+	constexpr FORCE_INLINE uint64 operator()(T value) const
+	{
+		return HashUtils::fmix64(static_cast<uint64>(value));
+	}
+};
+
+/**
+ * Hash of floating point values. Zero
+ * and negative zero, which compare
+ * equal, have the same hash.
+ * @{
+ */
+template<>
+struct Hash<float32>
+{
+	FORCE_INLINE uint64 operator()(float32 value) const
+	{
+		uint32 bits = 0;
+		if (value != 0.f) Memory::memcpy(&bits, &value, sizeof(bits));
+
+		return HashUtils::fmix64(bits);
+	}
+};
+
+template<>
+struct Hash<float64>
+{
+	FORCE_INLINE uint64 operator()(float64 value) const
+	{
+		uint64 bits = 0;
+		if (value != 0.0) Memory::memcpy(&bits, &value, sizeof(bits));
+
+		return HashUtils::fmix64(bits);
+	}
+};
+/// @}
+
+/**
+ * Hash of pointers, hashes the address.
+ * C strings are hashed by address too,
+ * wrap them in a StringView to hash the
+ * characters.
+ */
+template<typename T>
+struct Hash<T*>
+{
+	FORCE_INLINE uint64 operator()(const T * value) const
+	{
+		return HashUtils::fmix64(reinterpret_cast<uintp>(value));
+	}
+};
+
+/**
+ * Hash of string types, such as String,
+ * Name and StringView. Strings with the
+ * same characters have the same hash.
+ */
+template<typename T>
+struct Hash<T, typename EnableIf<!IsPointer<T>::value, decltype(void(StringView{declVal<const T&>()}))>::Type>
+{
+	FORCE_INLINE uint64 operator()(const StringView & value) const
+	{
+		return HashUtils::hashBytes(*value, value.getLength());
+	}
+};
+
+template<typename ...ValuesT>
+FORCE_INLINE uint64 HashUtils::hashValues(const ValuesT & ...values)
+{
+	uint64 seed = 0;
+	((seed = combine(seed, Hash<ValuesT>{}(values))), ...);
+
+	return seed;
+}
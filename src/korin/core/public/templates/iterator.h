@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core_types.h"
+#include "./types.h"
+#include "./utility.h"
 
 /**
  * Struct that defines the traits of
@@ -80,3 +82,28 @@ struct ContiguousIterator : RandomAccessIterator<T>
 {
 
 };
+
+/**
+ * Sets type to the type of the items of
+ * an iterator. This is the type of the
+ * dereferenced iterator, unless the
+ * iterator defines a ValueT type. Proxy
+ * iterators, whose dereference returns
+ * a reference object, must define it.
+ * @{
+ */
+struct Private_IteratorValue
+{
+	template<typename It>
+	static auto getValueType(int) -> TypeIdentity<typename It::ValueT>;
+
+	template<typename It>
+	static auto getValueType(...) -> TypeIdentity<typename NakedType<decltype(*declVal<It>())>::Type>;
+};
+
+template<typename It>
+struct IteratorValue : public decltype(Private_IteratorValue::getValueType<It>(0))
+{
+	//
+};
+/// @}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core_types.h"
+#include "hal/platform_atomics.h"
+
+/**
+ * A lock that busy-waits until it is
+ * released. Use it to protect short
+ * critical sections, where sleeping
+ * would cost more than spinning.
+ */
+struct SpinLock
+{
+	using AtomicOrder = PlatformAtomics::AtomicOrder;
+
+	/**
+	 * Creates an unlocked lock.
+	 */
+	constexpr FORCE_INLINE SpinLock()
+		: flag{0}
+	{
+		//
+	}
+
+	/**
+	 * Locks are not copyable.
+	 * @{
+	 */
+	SpinLock(const SpinLock&) = delete;
+	SpinLock & operator=(const SpinLock&) = delete;
+	/// @}
+
+	/**
+	 * Tries to acquire the lock once.
+	 *
+	 * @return true if lock was acquired
+	 */
+	FORCE_INLINE bool tryLock()
+	{
+		return PlatformAtomics::exchange(&flag, 1) == 0;
+	}
+
+	/**
+	 * Acquires the lock, spins until it
+	 * is released by the owner. While
+	 * waiting it only reads the flag, to
+	 * avoid bouncing the cache line.
+	 */
+	FORCE_INLINE void lock()
+	{
+		while (!tryLock())
+		{
+			while (PlatformAtomics::read<AtomicOrder::Relaxed>(&flag))
+			{
+#if defined(__x86_64__) || defined(__i386__)
+				__builtin_ia32_pause();
+#endif
+			}
+		}
+	}
+
+	/**
+	 * Releases the lock.
+	 */
+	FORCE_INLINE void unlock()
+	{
+		PlatformAtomics::store(&flag, 0);
+	}
+
+	/**
+	 * Returns true if lock is held.
+	 */
+	FORCE_INLINE bool isLocked() const
+	{
+		return PlatformAtomics::read<AtomicOrder::Relaxed>(&flag) != 0;
+	}
+
+protected:
+	/// One if lock is held
+	volatile int32 flag;
+};
+
+/**
+ * Holds a lock for the lifetime of the
+ * object.
+ *
+ * @param LockT type of the lock
+ */
+template<typename LockT>
+struct ScopeLock
+{
+	/**
+	 * Acquires the lock.
+	 */
+	FORCE_INLINE explicit ScopeLock(LockT & inLock)
+		: lock{inLock}
+	{
+		lock.lock();
+	}
+
+	/**
+	 * Releases the lock.
+	 */
+	FORCE_INLINE ~ScopeLock()
+	{
+		lock.unlock();
+	}
+
+	ScopeLock(const ScopeLock&) = delete;
+	ScopeLock & operator=(const ScopeLock&) = delete;
+
+protected:
+	/// Held lock
+	LockT & lock;
+};
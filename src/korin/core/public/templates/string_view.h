@@ -0,0 +1,254 @@
+#pragma once
+
+#include "core_types.h"
+#include "misc/utility.h"
+#include "hal/platform_memory.h"
+#include "hal/platform_strings.h"
+#include "hal/platform_math.h"
+#include "./enable_if.h"
+#include "./types.h"
+#include "./utility.h"
+#include "./name.h"
+
+/**
+ * A non-owning view of a sequence of
+ * characters. Unlike Name it can be
+ * created at runtime, and it does not
+ * need to be terminated.
+ *
+ * It can be constructed from any string
+ * type that exposes its buffer with
+ * operator* and its length with
+ * getLength, such as String and Name.
+ */
+class StringView
+{
+	using CharT = ansichar;
+
+public:
+	/**
+	 * Creates an empty view.
+	 */
+	constexpr FORCE_INLINE StringView()
+		: buffer{""}
+		, length{0}
+	{
+		//
+	}
+
+	/**
+	 * Creates a view of a buffer.
+	 *
+	 * @param inBuffer pointer to the
+	 * 	first character
+	 * @param inLength length in Bytes
+	 */
+	constexpr FORCE_INLINE StringView(const CharT * inBuffer, sizet inLength)
+		: buffer{inBuffer}
+		, length{inLength}
+	{
+		//
+	}
+
+	/**
+	 * Creates a view of a terminated C
+	 * string.
+	 *
+	 * @param inString C string
+	 */
+	FORCE_INLINE StringView(const CharT * inString)
+		: StringView{inString, PlatformStrings::getLength(inString)}
+	{
+		//
+	}
+
+	/**
+	 * Creates a view of a string object.
+	 *
+	 * @param inString string object
+	 */
+	template<typename StringT, typename = decltype(*declVal<const StringT&>() + declVal<const StringT&>().getLength())>
+	constexpr FORCE_INLINE StringView(const StringT & inString)
+		: buffer{*inString}
+		, length{inString.getLength()}
+	{
+		//
+	}
+
+	/**
+	 * Returns pointer to the first
+	 * character.
+	 * @{
+	 */
+	constexpr FORCE_INLINE const CharT * operator*() const
+	{
+		return buffer;
+	}
+
+	METHOD_ALIAS_CONST(getData, operator*)
+	/// @}
+
+	/**
+	 * Returns the length of the view.
+	 * @{
+	 */
+	constexpr FORCE_INLINE sizet getLength() const
+	{
+		return length;
+	}
+
+	METHOD_ALIAS_CONST(getSize, getLength)
+	/// @}
+
+	/**
+	 * Returns true if view is empty.
+	 */
+	constexpr FORCE_INLINE bool isEmpty() const
+	{
+		return length == 0;
+	}
+
+	/**
+	 * Returns the i-th character.
+	 */
+	constexpr FORCE_INLINE const CharT & operator[](sizet idx) const
+	{
+		return buffer[idx];
+	}
+
+	/**
+	 * Returns the i-th character as an
+	 * unsigned byte.
+	 */
+	constexpr FORCE_INLINE ubyte getByte(sizet idx) const
+	{
+		return static_cast<ubyte>(buffer[idx]);
+	}
+
+	/**
+	 * Returns iterators to the first and
+	 * past the last character.
+	 * @{
+	 */
+	constexpr FORCE_INLINE const CharT * begin() const
+	{
+		return buffer;
+	}
+
+	constexpr FORCE_INLINE const CharT * end() const
+	{
+		return buffer + length;
+	}
+	/// @}
+
+	/**
+	 * Returns a view of part of this
+	 * view. The range is clamped to the
+	 * view.
+	 *
+	 * @param pos index of the first
+	 * 	character
+	 * @param [len] max length of the view
+	 * @return sub view
+	 */
+	FORCE_INLINE StringView getSubView(sizet pos, sizet len = static_cast<sizet>(-1)) const
+	{
+		pos = PlatformMath::min(pos, length);
+		return StringView{buffer + pos, PlatformMath::min(len, length - pos)};
+	}
+
+	/**
+	 * Compares two views as sequences of
+	 * unsigned bytes. A view that is a
+	 * prefix of the other comes first.
+	 *
+	 * @param other other view
+	 * @return zero if equal, negative if
+	 * 	this view comes first, positive
+	 * 	otherwise
+	 */
+	FORCE_INLINE int32 compare(const StringView & other) const
+	{
+		const sizet minLength = PlatformMath::min(length, other.length);
+		if (const int32 cmp = minLength ? Memory::memcmp(buffer, other.buffer, minLength) : 0) return cmp;
+
+		return (length > other.length) - (length < other.length);
+	}
+
+	/**
+	 * Returns true if this view starts
+	 * with the given prefix.
+	 */
+	FORCE_INLINE bool startsWith(const StringView & prefix) const
+	{
+		return prefix.length <= length && (prefix.length == 0 || Memory::memcmp(buffer, prefix.buffer, prefix.length) == 0);
+	}
+
+	/**
+	 * Returns true if this view ends with
+	 * the given suffix.
+	 */
+	FORCE_INLINE bool endsWith(const StringView & suffix) const
+	{
+		return suffix.length <= length && (suffix.length == 0 || Memory::memcmp(buffer + length - suffix.length, suffix.buffer, suffix.length) == 0);
+	}
+
+	/**
+	 * Returns the index of the first
+	 * occurence of a character, or -1.
+	 *
+	 * @param c character to find
+	 * @param [startPos] index of the
+	 * 	first character to test
+	 * @return index of character or -1
+	 */
+	FORCE_INLINE int64 findIndex(CharT c, sizet startPos = 0) const
+	{
+		if (startPos >= length) return -1;
+
+		const void * found = ::memchr(buffer + startPos, c, length - startPos);
+		return found ? static_cast<const CharT*>(found) - buffer : -1;
+	}
+
+	/**
+	 * Compares two views.
+	 * @{
+	 */
+	FORCE_INLINE bool operator==(const StringView & other) const
+	{
+		return length == other.length && (length == 0 || Memory::memcmp(buffer, other.buffer, length) == 0);
+	}
+
+	FORCE_INLINE bool operator!=(const StringView & other) const
+	{
+		return !(*this == other);
+	}
+
+	FORCE_INLINE bool operator<(const StringView & other) const
+	{
+		return compare(other) < 0;
+	}
+
+	FORCE_INLINE bool operator>(const StringView & other) const
+	{
+		return compare(other) > 0;
+	}
+
+	FORCE_INLINE bool operator<=(const StringView & other) const
+	{
+		return compare(other) <= 0;
+	}
+
+	FORCE_INLINE bool operator>=(const StringView & other) const
+	{
+		return compare(other) >= 0;
+	}
+	/// @}
+
+protected:
+	/// Pointer to the first character
+	const CharT * buffer;
+
+	/// Length of the view
+	sizet length;
+};
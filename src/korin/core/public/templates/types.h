@@ -363,6 +363,35 @@ public:
 	>::Type;
 };
 
+/**
+ * A compile-time sequence of indices,
+ * used to expand parameter packs by
+ * position.
+ */
+template<uint64 ...idxs>
+struct IndexSequence
+{
+	//
+};
+
+/**
+ * Sets type to the sequence of indices
+ * from 0 to n - 1.
+ * @{
+ */
+template<uint64 n, uint64 ...idxs>
+struct MakeIndexSequence : public MakeIndexSequence<n - 1, n - 1, idxs...>
+{
+	//
+};
+
+template<uint64 ...idxs>
+struct MakeIndexSequence<0, idxs...>
+{
+	using Type = IndexSequence<idxs...>;
+};
+/// @}
+
 /**
  * Base class for non copyable objects.
  */
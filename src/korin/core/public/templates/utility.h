@@ -44,3 +44,11 @@ FORCE_INLINE void swap(T & a, T & b)
 {
 	T t{move(a)}; a = move(b), b = move(t);
 }
+
+/**
+ * Returns a reference to a value of
+ * type T, for use in unevaluated
+ * contexts only (e.g. decltype).
+ */
+template<typename T>
+T && declVal();
@@ -69,3 +69,5 @@ struct UnixPlatformAtomics : public GenericPlatformAtomics
 
 template<> struct UnixPlatformAtomics::GetPlatformAtomicOrder<UnixPlatformAtomics::AtomicOrder::Sequential>	{ enum {value = __ATOMIC_SEQ_CST}; };
 template<> struct UnixPlatformAtomics::GetPlatformAtomicOrder<UnixPlatformAtomics::AtomicOrder::Relaxed>	{ enum {value = __ATOMIC_RELAXED}; };
+template<> struct UnixPlatformAtomics::GetPlatformAtomicOrder<UnixPlatformAtomics::AtomicOrder::Acquire>		{ enum {value = __ATOMIC_ACQUIRE}; };
+template<> struct UnixPlatformAtomics::GetPlatformAtomicOrder<UnixPlatformAtomics::AtomicOrder::Release>		{ enum {value = __ATOMIC_RELEASE}; };
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "generic/generic_platform_files.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Unix file utilities, based on POSIX
+ * calls.
+ */
+struct UnixPlatformFiles : public GenericPlatformFiles
+{
+	/// Type of a file handle
+	using FileHandle = int32;
+
+	/// Value of an invalid handle
+	static constexpr FileHandle invalidHandle = -1;
+
+	/**
+	 * Opens a file.
+	 *
+	 * @param path path of the file
+	 * @param mode open mode
+	 * @return handle of the file, or
+	 * 	invalidHandle on failure
+	 */
+	static FileHandle open(const ansichar * path, FileOpenMode mode)
+	{
+		int32 flags = O_CLOEXEC;
+		switch (mode)
+		{
+			case FileOpenMode::Read: flags |= O_RDONLY; break;
+			case FileOpenMode::Write: flags |= O_WRONLY | O_CREAT | O_TRUNC; break;
+			case FileOpenMode::Append: flags |= O_WRONLY | O_CREAT | O_APPEND; break;
+			case FileOpenMode::ReadWrite: flags |= O_RDWR | O_CREAT; break;
+		}
+
+		FileHandle handle;
+		do handle = ::open(path, flags, 0644); while (handle < 0 && errno == EINTR);
+
+		return handle;
+	}
+
+	/**
+	 * Closes a file.
+	 *
+	 * @param handle handle of the file
+	 * @return true if file was closed
+	 */
+	static FORCE_INLINE bool close(FileHandle handle)
+	{
+		return ::close(handle) == 0;
+	}
+
+	/**
+	 * Reads from the current position of a
+	 * file. Reads are retried until the
+	 * buffer is full or the end of the
+	 * file.
+	 *
+	 * @param handle handle of the file
+	 * @param dst destination buffer
+	 * @param size number of bytes
+	 * @return number of bytes read, or -1
+	 * 	on error
+	 */
+	static int64 read(FileHandle handle, void * dst, uint64 size)
+	{
+		uint64 numRead = 0;
+		while (numRead < size)
+		{
+			const ssize_t res = ::read(handle, static_cast<ubyte*>(dst) + numRead, size - numRead);
+			if (res > 0) numRead += res;
+			else if (res == 0) break;
+			else if (errno != EINTR) return -1;
+		}
+
+		return numRead;
+	}
+
+	/**
+	 * Writes to the current position of a
+	 * file.
+	 *
+	 * @param handle handle of the file
+	 * @param src source buffer
+	 * @param size number of bytes
+	 * @return number of bytes written, or
+	 * 	-1 on error
+	 */
+	static int64 write(FileHandle handle, const void * src, uint64 size)
+	{
+		uint64 numWritten = 0;
+		while (numWritten < size)
+		{
+			const ssize_t res = ::write(handle, static_cast<const ubyte*>(src) + numWritten, size - numWritten);
+			if (res >= 0) numWritten += res;
+			else if (errno != EINTR) return -1;
+		}
+
+		return numWritten;
+	}
+
+	/**
+	 * Reads at the given offset, without
+	 * moving the position of the file.
+	 *
+	 * @see read
+	 * @param offset offset in the file
+	 */
+	static int64 readAt(FileHandle handle, void * dst, uint64 size, uint64 offset)
+	{
+		uint64 numRead = 0;
+		while (numRead < size)
+		{
+			const ssize_t res = ::pread(handle, static_cast<ubyte*>(dst) + numRead, size - numRead, offset + numRead);
+			if (res > 0) numRead += res;
+			else if (res == 0) break;
+			else if (errno != EINTR) return -1;
+		}
+
+		return numRead;
+	}
+
+	/**
+	 * Writes at the given offset, without
+	 * moving the position of the file.
+	 *
+	 * @see write
+	 * @param offset offset in the file
+	 */
+	static int64 writeAt(FileHandle handle, const void * src, uint64 size, uint64 offset)
+	{
+		uint64 numWritten = 0;
+		while (numWritten < size)
+		{
+			const ssize_t res = ::pwrite(handle, static_cast<const ubyte*>(src) + numWritten, size - numWritten, offset + numWritten);
+			if (res >= 0) numWritten += res;
+			else if (errno != EINTR) return -1;
+		}
+
+		return numWritten;
+	}
+
+	/**
+	 * Moves the position of a file.
+	 *
+	 * @param handle handle of the file
+	 * @param offset new position
+	 * @return true on success
+	 */
+	static FORCE_INLINE bool seek(FileHandle handle, uint64 offset)
+	{
+		return ::lseek(handle, offset, SEEK_SET) >= 0;
+	}
+
+	/**
+	 * Returns the size of a file, or -1
+	 * on error.
+	 */
+	static FORCE_INLINE int64 getSize(FileHandle handle)
+	{
+		struct stat info;
+		return ::fstat(handle, &info) == 0 ? info.st_size : -1;
+	}
+
+	/**
+	 * Tells the system how a range of a
+	 * file will be accessed.
+	 *
+	 * @param handle handle of the file
+	 * @param hint access pattern
+	 * @param [offset,size] range of the
+	 * 	file, whole file by default
+	 */
+	static FORCE_INLINE void advise(FileHandle handle, FileAccessHint hint, uint64 offset = 0, uint64 size = 0)
+	{
+#if defined(POSIX_FADV_SEQUENTIAL)
+		const int32 advice = hint == FileAccessHint::Sequential ? POSIX_FADV_SEQUENTIAL : hint == FileAccessHint::Random ? POSIX_FADV_RANDOM : POSIX_FADV_NORMAL;
+		::posix_fadvise(handle, offset, size, advice);
+#endif
+	}
+
+	/**
+	 * Starts reading a range of a file in
+	 * the background.
+	 *
+	 * @param handle handle of the file
+	 * @param offset,size range of the file
+	 */
+	static FORCE_INLINE void prefetch(FileHandle handle, uint64 offset, uint64 size)
+	{
+#if defined(POSIX_FADV_WILLNEED)
+		::posix_fadvise(handle, offset, size, POSIX_FADV_WILLNEED);
+#endif
+	}
+
+	/**
+	 * @copydoc GenericPlatformFiles::mapFile
+	 */
+	static MappedFileRegion mapFile(const ansichar * path)
+	{
+		const int32 fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) return {};
+
+		struct stat info;
+		if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+		{
+			::close(fd);
+			return {};
+		}
+
+		void * data = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		// The mapping keeps the file alive
+		::close(fd);
+
+		if (data == MAP_FAILED) return {};
+		return {data, static_cast<uint64>(info.st_size)};
+	}
+
+	/**
+	 * @copydoc GenericPlatformFiles::unmapFile
+	 */
+	static FORCE_INLINE void unmapFile(const MappedFileRegion & region)
+	{
+		if (region.data) ::munmap(const_cast<void*>(region.data), region.size);
+	}
+};
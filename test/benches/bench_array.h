@@ -1,6 +1,7 @@
 #pragma once
 
 #include "benchmark/benchmark.h"
+#include "./bench_util.h"
 
 #include "core_types.h"
 #include "containers/array.h"
@@ -23,6 +24,7 @@ void sglArray(benchmark::State & state)
 {
 	constexpr uint32 dim = 512;
 
+	BenchPerfCounters counters{state, dim * dim};
 	for (auto _ : state)
 	{
 		Array<Array<uint32>> a{dim, 0};
@@ -52,6 +54,7 @@ void stdArray(benchmark::State & state)
 {
 	constexpr uint32 dim = 512;
 
+	BenchPerfCounters counters{state, dim * dim};
 	for (auto _ : state)
 	{
 		std::vector<std::vector<uint32>> a;
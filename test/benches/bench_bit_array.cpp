@@ -0,0 +1,4 @@
+#include "bench_bit_array.h"
+
+BENCHMARK_MAIN();
+
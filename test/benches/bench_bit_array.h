@@ -0,0 +1,134 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/set.h"
+#include "containers/bit_array.h"
+
+/**
+ * Korin bit array used as a set of
+ * visited indices
+ */
+void korinBitArrayVisit(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	BitArray visited{numItems};
+
+	for (auto _ : state)
+	{
+		uint32 numNew = 0;
+		for (uint32 i = 0; i < numItems; ++i)
+			numNew += !visited.testAndSet(rand() % numItems);
+
+		visited.unsetAll();
+		benchmark::DoNotOptimize(numNew);
+	}
+}
+
+/**
+ * Korin array of bools used as a set
+ * of visited indices
+ */
+void korinBoolArrayVisit(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<bool> visited;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		visited.add(false);
+
+	for (auto _ : state)
+	{
+		uint32 numNew = 0;
+		for (uint32 i = 0; i < numItems; ++i)
+		{
+			bool & bit = visited[rand() % numItems];
+			numNew += !bit;
+			bit = true;
+		}
+
+		for (bool & bit : visited) bit = false;
+		benchmark::DoNotOptimize(numNew);
+	}
+}
+
+/**
+ * Korin ordered set used as a set of
+ * visited indices
+ */
+void korinSetVisit(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	for (auto _ : state)
+	{
+		Set<uint32> visited;
+		uint32 numNew = 0;
+		for (uint32 i = 0; i < numItems; ++i)
+		{
+			const uint32 idx = rand() % numItems;
+			if (!visited.get(idx))
+			{
+				visited.set(idx);
+				++numNew;
+			}
+		}
+
+		benchmark::DoNotOptimize(numNew);
+	}
+}
+
+/**
+ * Korin bit array, bitwise and of two
+ * arrays followed by a popcount
+ */
+void korinBitArrayAndCount(benchmark::State & state)
+{
+	const uint32 numBits = state.range(0);
+	BitArray a{numBits}, b{numBits};
+
+	for (uint32 i = 0; i < numBits; ++i)
+	{
+		a.set(i, rand() & 1);
+		b.set(i, rand() & 1);
+	}
+
+	for (auto _ : state)
+	{
+		BitArray c = a;
+		c &= b;
+
+		benchmark::DoNotOptimize(c.countSet());
+	}
+
+	state.SetBytesProcessed(state.iterations() * numBits / 8);
+}
+
+/**
+ * Korin bit array, iterates over the
+ * set bits
+ */
+void korinBitArrayIterate(benchmark::State & state)
+{
+	const uint32 numBits = state.range(0);
+	BitArray bits{numBits};
+
+	// One bit out of 16 set
+	for (uint32 i = 0; i < numBits; ++i)
+		bits.set(i, (rand() & 15) == 0);
+
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (uint64 idx : bits) sum += idx;
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+BENCHMARK(korinBitArrayVisit)->RangeMultiplier(0x4)->Ranges({{0x100, 0x100000}});
+BENCHMARK(korinBoolArrayVisit)->RangeMultiplier(0x4)->Ranges({{0x100, 0x100000}});
+BENCHMARK(korinSetVisit)->RangeMultiplier(0x4)->Ranges({{0x100, 0x100000}});
+BENCHMARK(korinBitArrayAndCount)->RangeMultiplier(0x8)->Ranges({{0x100, 0x1000000}});
+BENCHMARK(korinBitArrayIterate)->RangeMultiplier(0x8)->Ranges({{0x100, 0x1000000}});
@@ -0,0 +1,4 @@
+#include "bench_cache.h"
+
+BENCHMARK_MAIN();
+
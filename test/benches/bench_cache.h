@@ -0,0 +1,201 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/lru_cache.h"
+#include "containers/clock_cache.h"
+#include "containers/sharded_cache.h"
+#include "hal/platform_math.h"
+
+#include <list>
+#include <unordered_map>
+
+/// Number of distinct keys in the trace
+static constexpr uint64 benchCacheNumKeys = 1 << 20;
+
+/// Number of accesses in the trace
+static constexpr uint64 benchCacheTraceLength = 1 << 20;
+
+/**
+ * Creates a trace of keys drawn from a
+ * Zipfian distribution with exponent
+ * 0.99, the skew of typical cache
+ * workloads. Keys are scrambled so that
+ * popular keys are not adjacent.
+ */
+static Array<uint64> makeCacheTrace()
+{
+	// Cumulative distribution function
+	Array<float64> cdf{benchCacheNumKeys, benchCacheNumKeys};
+	float64 sum = 0.0;
+	for (uint64 i = 0; i < benchCacheNumKeys; ++i)
+	{
+		sum += 1.0 / PlatformMath::pow(static_cast<float32>(i + 1), 0.99f);
+		cdf[i] = sum;
+	}
+
+	Array<uint64> trace{benchCacheTraceLength};
+	uint64 seed = 0x9e3779b97f4a7c15ull;
+	for (uint64 i = 0; i < benchCacheTraceLength; ++i)
+	{
+		seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+		const float64 u = static_cast<float64>(seed >> 11) / static_cast<float64>(1ull << 53) * sum;
+
+		uint64 lo = 0, hi = benchCacheNumKeys - 1;
+		while (lo < hi)
+		{
+			const uint64 mid = (lo + hi) / 2;
+			if (cdf[mid] < u) lo = mid + 1;
+			else hi = mid;
+		}
+
+		trace.add(lo * 0x9e3779b97f4a7c15ull);
+	}
+
+	return trace;
+}
+
+/**
+ * Returns the shared trace, created on
+ * first use.
+ */
+static const Array<uint64> & getCacheTrace()
+{
+	static const Array<uint64> trace = makeCacheTrace();
+	return trace;
+}
+
+/**
+ * Runs the trace against a cache. Each
+ * miss inserts the key.
+ */
+template<typename CacheT>
+static void runCacheTrace(benchmark::State & state, CacheT & cache)
+{
+	const Array<uint64> & trace = getCacheTrace();
+
+	uint64 numHits = 0;
+	for (auto _ : state)
+	{
+		numHits = 0;
+		for (uint64 key : trace)
+		{
+			if (uint64 * value = cache.get(key))
+			{
+				numHits += *value == key;
+			}
+			else cache.insert(key, key);
+		}
+	}
+
+	state.counters["hitRate"] = static_cast<float64>(numHits) / benchCacheTraceLength;
+	state.SetItemsProcessed(state.iterations() * benchCacheTraceLength);
+}
+
+/**
+ * Korin LRU cache, Zipfian trace
+ */
+void korinLRUCacheZipf(benchmark::State & state)
+{
+	LRUCache<uint64, uint64> cache{static_cast<uint32>(state.range(0))};
+	runCacheTrace(state, cache);
+}
+
+/**
+ * Korin CLOCK cache, Zipfian trace
+ */
+void korinClockCacheZipf(benchmark::State & state)
+{
+	ClockCache<uint64, uint64> cache{static_cast<uint32>(state.range(0))};
+	runCacheTrace(state, cache);
+}
+
+/**
+ * Textbook LRU cache built on std
+ * containers, used as baseline.
+ */
+struct StdLRUCache
+{
+	using ListT = std::list<std::pair<uint64, uint64>>;
+
+	uint64 capacity;
+	ListT items;
+	std::unordered_map<uint64, ListT::iterator> index;
+
+	uint64 * get(uint64 key)
+	{
+		auto it = index.find(key);
+		if (it == index.end()) return nullptr;
+
+		items.splice(items.begin(), items, it->second);
+		return &it->second->second;
+	}
+
+	void insert(uint64 key, uint64 value)
+	{
+		if (items.size() == capacity)
+		{
+			index.erase(items.back().first);
+			items.pop_back();
+		}
+
+		items.emplace_front(key, value);
+		index[key] = items.begin();
+	}
+};
+
+/**
+ * Std list and unordered map LRU cache,
+ * Zipfian trace
+ */
+void stdLRUCacheZipf(benchmark::State & state)
+{
+	StdLRUCache cache{static_cast<uint64>(state.range(0))};
+	cache.index.reserve(state.range(0));
+	runCacheTrace(state, cache);
+}
+
+/**
+ * Korin sharded LRU cache, shared by
+ * all threads
+ */
+void korinShardedLRUCacheZipf(benchmark::State & state)
+{
+	static ShardedCache<LRUCache<uint64, uint64>> * cache = nullptr;
+	if (state.thread_index() == 0) cache = new ShardedCache<LRUCache<uint64, uint64>>{1 << 16};
+
+	const Array<uint64> & trace = getCacheTrace();
+	const uint64 offset = state.thread_index() * (benchCacheTraceLength / 8);
+
+	// Threads wait for each other before
+	// the first iteration
+	for (auto _ : state)
+	{
+		uint64 numHits = 0;
+		for (uint64 i = 0; i < benchCacheTraceLength; ++i)
+		{
+			const uint64 key = trace[(i + offset) & (benchCacheTraceLength - 1)];
+
+			uint64 value;
+			if (cache->get(key, value)) numHits += value == key;
+			else cache->insert(key, key);
+		}
+
+		benchmark::DoNotOptimize(numHits);
+	}
+
+	state.SetItemsProcessed(state.iterations() * benchCacheTraceLength);
+
+	if (state.thread_index() == 0)
+	{
+		delete cache;
+		cache = nullptr;
+	}
+}
+
+BENCHMARK(korinLRUCacheZipf)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinClockCacheZipf)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(stdLRUCacheZipf)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinShardedLRUCacheZipf)->Threads(1)->Threads(4)->UseRealTime()->Unit(benchmark::kMillisecond);
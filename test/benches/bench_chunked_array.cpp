@@ -0,0 +1,4 @@
+#include "bench_chunked_array.h"
+
+BENCHMARK_MAIN();
+
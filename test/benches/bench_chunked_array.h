@@ -0,0 +1,217 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/chunked_array.h"
+
+/**
+ * Particle stored in the arrays
+ */
+struct BenchParticle
+{
+	float32 position[3];
+	float32 velocity[3];
+};
+
+/**
+ * Korin chunked array, appends items
+ */
+void korinChunkedArrayAdd(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		ChunkedArray<BenchParticle> array;
+
+		for (uint32 i = 0; i < numItems; ++i)
+			array.add(BenchParticle{});
+
+		doNotOptimizeAway(&array);
+	}
+}
+
+/**
+ * Korin array, appends items
+ */
+void korinArrayAddParticles(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		Array<BenchParticle> array;
+
+		for (uint32 i = 0; i < numItems; ++i)
+			array.add(BenchParticle{});
+
+		doNotOptimizeAway(&array);
+	}
+}
+
+/**
+ * Korin array of individually allocated
+ * items, appends items. This is the
+ * usual way to get stable addresses
+ */
+void korinPtrArrayAdd(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		Array<BenchParticle*> array;
+
+		for (uint32 i = 0; i < numItems; ++i)
+			array.add(new BenchParticle{});
+
+		doNotOptimizeAway(&array);
+
+		for (BenchParticle * particle : array)
+			delete particle;
+	}
+}
+
+/**
+ * Korin chunked array, iterates over
+ * all items
+ */
+void korinChunkedArrayIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	ChunkedArray<BenchParticle> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(BenchParticle{});
+
+	for (auto _ : state)
+	{
+		for (BenchParticle & particle : array)
+			particle.position[0] += particle.velocity[0];
+	}
+
+	doNotOptimizeAway(&array);
+}
+
+/**
+ * Korin chunked array, iterates over
+ * all items one chunk at a time
+ */
+void korinChunkedArrayIterateChunks(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	ChunkedArray<BenchParticle> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(BenchParticle{});
+
+	for (auto _ : state)
+	{
+		for (uint64 i = 0; i < array.getNumChunks(); ++i)
+		{
+			BenchParticle * chunk = array.getChunk(i);
+			const uint64 chunkCount = array.getChunkCount(i);
+
+			for (uint64 j = 0; j < chunkCount; ++j)
+				chunk[j].position[0] += chunk[j].velocity[0];
+		}
+	}
+
+	doNotOptimizeAway(&array);
+}
+
+/**
+ * Korin array, iterates over all items
+ */
+void korinArrayIterateParticles(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<BenchParticle> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(BenchParticle{});
+
+	for (auto _ : state)
+	{
+		for (BenchParticle & particle : array)
+			particle.position[0] += particle.velocity[0];
+	}
+
+	doNotOptimizeAway(&array);
+}
+
+/**
+ * Korin array of individually allocated
+ * items, iterates over all items
+ */
+void korinPtrArrayIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<BenchParticle*> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(new BenchParticle{});
+
+	for (auto _ : state)
+	{
+		for (BenchParticle * particle : array)
+			particle->position[0] += particle->velocity[0];
+	}
+
+	doNotOptimizeAway(&array);
+
+	for (BenchParticle * particle : array)
+		delete particle;
+}
+
+/**
+ * Korin chunked array, random access
+ */
+void korinChunkedArrayRandomAccess(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	ChunkedArray<BenchParticle> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(BenchParticle{});
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			array[rand() % numItems].position[0] += 1.f;
+	}
+
+	doNotOptimizeAway(&array);
+}
+
+/**
+ * Korin array, random access
+ */
+void korinArrayRandomAccessParticles(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<BenchParticle> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(BenchParticle{});
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			array[rand() % numItems].position[0] += 1.f;
+	}
+
+	doNotOptimizeAway(&array);
+}
+
+BENCHMARK(korinChunkedArrayAdd)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinArrayAddParticles)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinPtrArrayAdd)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinChunkedArrayIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinChunkedArrayIterateChunks)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinArrayIterateParticles)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinPtrArrayIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinChunkedArrayRandomAccess)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinArrayRandomAccessParticles)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
@@ -0,0 +1,304 @@
+/**
+ * Prints the results of a benchmark run as
+ * a table, or compares two runs and flags
+ * the regressions. Runs are the JSON
+ * output of google benchmark:
+ *
+ * ```
+ * korin-bench_containers --benchmark_out=base.json --benchmark_out_format=json
+ * korin-bench_compare [--threshold=0.05] [--metric=cpu_time] base.json [new.json]
+ * ```
+ *
+ * Benchmarks are matched by name. With
+ * repetitions the median is used. The
+ * exit code is 1 if any benchmark is
+ * slower than the threshold, 2 if a file
+ * can't be read.
+ */
+
+#include "core_types.h"
+#include "hal/file.h"
+#include "hal/platform_math.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "serialization/json_reader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+namespace
+{
+	/**
+	 * Time of a benchmark, in nanoseconds.
+	 */
+	struct BenchResult
+	{
+		/// Benchmark name
+		String name;
+
+		/// Sum of the times of the runs
+		float64 time;
+
+		/// Number of runs
+		uint32 numRuns;
+
+		/// True if time is a median
+		bool isMedian;
+
+		FORCE_INLINE float64 getTime() const
+		{
+			return time / numRuns;
+		}
+	};
+
+	/**
+	 * Results of a run, in file order.
+	 */
+	struct BenchRun
+	{
+		/// Results
+		Array<BenchResult> results;
+
+		/// Index of each result by name
+		Map<String, uint64> indices;
+
+		/**
+		 * Returns the result with the given
+		 * name, or nullptr.
+		 */
+		FORCE_INLINE const BenchResult * find(const String & name) const
+		{
+			uint64 idx;
+			return indices.find(name, idx) ? &results[idx] : nullptr;
+		}
+	};
+
+	/**
+	 * Returns the nanoseconds in a time unit.
+	 */
+	float64 getUnitScale(const StringView & unit)
+	{
+		if (unit == "us") return 1e3;
+		if (unit == "ms") return 1e6;
+		if (unit == "s") return 1e9;
+		return 1.0;
+	}
+
+	/**
+	 * Reads a run. Aggregates other than the
+	 * median and failed benchmarks are
+	 * skipped.
+	 */
+	bool readRun(const ansichar * path, const ansichar * metric, BenchRun & out)
+	{
+		File file{path};
+		if (!file.isOpen())
+		{
+			::fprintf(stderr, "cannot open %s\n", path);
+			return false;
+		}
+
+		String text;
+		file.readAll(text);
+
+		JsonReader reader;
+		if (!reader.parse(text))
+		{
+			::fprintf(stderr, "%s is not valid JSON (error at %llu)\n", path, reader.getErrorPos());
+			return false;
+		}
+
+		const JsonValue benchmarks = reader.getRoot()["benchmarks"];
+		if (benchmarks.getType() != JsonType::Array)
+		{
+			::fprintf(stderr, "%s is not a google benchmark output\n", path);
+			return false;
+		}
+
+		for (JsonValue bench : benchmarks.getItems())
+		{
+			if (bench["error_occurred"].getOr(false)) continue;
+
+			const bool isAggregate = bench["run_type"].equals("aggregate");
+			if (isAggregate && !bench["aggregate_name"].equals("median")) continue;
+
+			String name;
+			if (!bench["run_name"].get(name) && !bench["name"].get(name)) continue;
+
+			float64 time;
+			if (!bench[metric].get(time)) continue;
+
+			StringView unit{"ns"};
+			bench["time_unit"].get(unit);
+			time *= getUnitScale(unit);
+
+			uint64 idx;
+			if (!out.indices.find(name, idx))
+			{
+				idx = out.results.getCount();
+				out.results.add(BenchResult{name, 0.0, 0, false});
+				out.indices.insert(name, idx);
+			}
+
+			// Medians replace the single runs
+			BenchResult & result = out.results[idx];
+			if (isAggregate) result = BenchResult{name, time, 1, true};
+			else if (!result.isMedian)
+			{
+				result.time += time;
+				++result.numRuns;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Formats a time with its unit.
+	 */
+	void formatTime(ansichar * buffer, sizet size, float64 ns)
+	{
+		if (ns < 1e3) ::snprintf(buffer, size, "%.3g ns", ns);
+		else if (ns < 1e6) ::snprintf(buffer, size, "%.3g us", ns / 1e3);
+		else if (ns < 1e9) ::snprintf(buffer, size, "%.3g ms", ns / 1e6);
+		else ::snprintf(buffer, size, "%.3g s", ns / 1e9);
+	}
+
+	/**
+	 * Returns the width of the name column.
+	 */
+	int32 getNameWidth(const BenchRun & run, int32 width)
+	{
+		for (uint64 idx = 0; idx < run.results.getCount(); ++idx)
+			width = PlatformMath::max(width, static_cast<int32>(run.results[idx].name.getLength()));
+
+		return width;
+	}
+
+	/**
+	 * Prints the results of a run.
+	 */
+	void printRun(const BenchRun & run)
+	{
+		const int32 width = getNameWidth(run, 9);
+		::printf("%-*s  %12s\n", width, "Benchmark", "Time");
+
+		for (uint64 idx = 0; idx < run.results.getCount(); ++idx)
+		{
+			const BenchResult & result = run.results[idx];
+
+			ansichar time[32];
+			formatTime(time, sizeof(time), result.getTime());
+			::printf("%-*s  %12s\n", width, *result.name, time);
+		}
+	}
+
+	/**
+	 * Prints the comparison of two runs,
+	 * returns the number of regressions.
+	 */
+	uint32 printComparison(const BenchRun & base, const BenchRun & next, float64 threshold)
+	{
+		const int32 width = getNameWidth(next, getNameWidth(base, 9));
+		::printf("%-*s  %12s  %12s  %8s\n", width, "Benchmark", "Base", "New", "Change");
+
+		uint32 numCompared = 0, numRegressions = 0, numImprovements = 0;
+		float64 sumLogRatios = 0.0;
+
+		for (uint64 idx = 0; idx < base.results.getCount(); ++idx)
+		{
+			const BenchResult & before = base.results[idx];
+			const BenchResult * after = next.find(before.name);
+
+			ansichar beforeTime[32], afterTime[32];
+			formatTime(beforeTime, sizeof(beforeTime), before.getTime());
+
+			if (!after)
+			{
+				::printf("%-*s  %12s  %12s  %8s  removed\n", width, *before.name, beforeTime, "-", "-");
+				continue;
+			}
+
+			formatTime(afterTime, sizeof(afterTime), after->getTime());
+
+			const float64 ratio = after->getTime() / before.getTime();
+			const ansichar * flag = "";
+
+			if (ratio > 1.0 + threshold)
+			{
+				flag = "REGRESSION";
+				++numRegressions;
+			}
+			else if (ratio < 1.0 - threshold)
+			{
+				flag = "improved";
+				++numImprovements;
+			}
+
+			if (ratio > 0.0)
+			{
+				sumLogRatios += ::log(ratio);
+				++numCompared;
+			}
+
+			::printf("%-*s  %12s  %12s  %+7.1f%%  %s\n", width, *before.name, beforeTime, afterTime, (ratio - 1.0) * 100.0, flag);
+		}
+
+		for (uint64 idx = 0; idx < next.results.getCount(); ++idx)
+		{
+			const BenchResult & after = next.results[idx];
+			if (base.find(after.name)) continue;
+
+			ansichar afterTime[32];
+			formatTime(afterTime, sizeof(afterTime), after.getTime());
+			::printf("%-*s  %12s  %12s  %8s  added\n", width, *after.name, "-", afterTime, "-");
+		}
+
+		::printf("\n%u compared, %u regressions, %u improvements over %.1f%%", numCompared, numRegressions, numImprovements, threshold * 100.0);
+		if (numCompared) ::printf(", geometric mean change %+.1f%%", (::exp(sumLogRatios / numCompared) - 1.0) * 100.0);
+		::printf("\n");
+
+		return numRegressions;
+	}
+} // namespace
+
+int main(int argc, char ** argv)
+{
+	float64 threshold = 0.05;
+	const ansichar * metric = "cpu_time";
+	const ansichar * paths[2] = {nullptr, nullptr};
+	uint32 numPaths = 0;
+
+	for (int32 idx = 1; idx < argc; ++idx)
+	{
+		const ansichar * arg = argv[idx];
+
+		if (::strncmp(arg, "--threshold=", 12) == 0) threshold = ::strtod(arg + 12, nullptr);
+		else if (::strncmp(arg, "--metric=", 9) == 0) metric = arg + 9;
+		else if (arg[0] != '-' && numPaths < 2) paths[numPaths++] = arg;
+		else numPaths = 3;
+	}
+
+	if (numPaths == 0 || numPaths > 2)
+	{
+		::fprintf(stderr, "usage: %s [--threshold=0.05] [--metric=cpu_time|real_time] base.json [new.json]\n", argv[0]);
+		return 2;
+	}
+
+	BenchRun base;
+	if (!readRun(paths[0], metric, base)) return 2;
+
+	if (numPaths == 1)
+	{
+		printRun(base);
+		return 0;
+	}
+
+	BenchRun next;
+	if (!readRun(paths[1], metric, next)) return 2;
+
+	return printComparison(base, next, threshold) ? 1 : 0;
+}
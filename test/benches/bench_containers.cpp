@@ -0,0 +1,4 @@
+#include "bench_containers.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,653 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "core_types.h"
+#include "hal/malloc_ansi.h"
+#include "hal/malloc_binned.h"
+#include "hal/malloc_arena.h"
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <map>
+
+/**
+ * Container benchmark matrix. Each
+ * benchmark is named
+ * container/key/op/pattern/allocator/size,
+ * e.g. "Map/String/lookup/zipf/binned/1000":
+ *
+ * - containers: Array and Map, with
+ *   std::vector and std::map baselines;
+ * - keys: uint64, String and a 64 Bytes
+ *   struct;
+ * - ops: insert, lookup, iterate, erase
+ *   and copy (including the destruction
+ *   of the copy);
+ * - patterns: the order of the keys, seq,
+ *   random or zipf (skewed, lookups only);
+ * - allocators: the one installed as
+ *   gMalloc while the benchmark runs,
+ *   ansi, binned or arena, std for the
+ *   std containers.
+ *
+ * Sizes go from 10 to 10^4 by default, up
+ * to KORIN_BENCH_MAX_SIZE if set (e.g.
+ * 100000000). Filter the matrix with
+ * --benchmark_filter and compare two runs
+ * saved with --benchmark_out with
+ * korin-bench_compare.
+ */
+
+/**
+ * A large key, compared by id.
+ */
+struct BenchLargeKey
+{
+	/// Key id
+	uint64 id;
+
+	/// Payload
+	uint64 data[7];
+
+	FORCE_INLINE bool operator==(const BenchLargeKey & other) const
+	{
+		return id == other.id;
+	}
+
+	FORCE_INLINE bool operator<(const BenchLargeKey & other) const
+	{
+		return id < other.id;
+	}
+
+	FORCE_INLINE bool operator>(const BenchLargeKey & other) const
+	{
+		return id > other.id;
+	}
+};
+
+/**
+ * Creates and reads the keys of the
+ * matrix. Keys are created in ascending
+ * order.
+ */
+template<typename>
+struct BenchKeyTraits;
+
+template<>
+struct BenchKeyTraits<uint64>
+{
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "uint64";
+	}
+
+	static FORCE_INLINE uint64 create(uint64 idx)
+	{
+		return idx * 2 + 1;
+	}
+
+	static FORCE_INLINE uint64 read(const uint64 & key)
+	{
+		return key;
+	}
+};
+
+template<>
+struct BenchKeyTraits<String>
+{
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "String";
+	}
+
+	static FORCE_INLINE String create(uint64 idx)
+	{
+		ansichar buffer[32];
+		::snprintf(buffer, sizeof(buffer), "key:%012llu", idx);
+		return String{buffer};
+	}
+
+	static FORCE_INLINE uint64 read(const String & key)
+	{
+		return static_cast<uint64>((*key)[key.getLength() - 1]);
+	}
+};
+
+template<>
+struct BenchKeyTraits<BenchLargeKey>
+{
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "LargeKey";
+	}
+
+	static FORCE_INLINE BenchLargeKey create(uint64 idx)
+	{
+		return BenchLargeKey{idx, {idx, idx, idx, idx, idx, idx, idx}};
+	}
+
+	static FORCE_INLINE uint64 read(const BenchLargeKey & key)
+	{
+		return key.data[6];
+	}
+};
+
+/**
+ * Operations of the matrix.
+ */
+enum class BenchOp : ubyte
+{
+	Insert,
+	Lookup,
+	Iterate,
+	Erase,
+	Copy
+};
+
+/**
+ * Order in which keys are accessed.
+ */
+enum class BenchPattern : ubyte
+{
+	Sequential,
+	Random,
+	Zipfian
+};
+
+/**
+ * Allocator installed as gMalloc.
+ */
+enum class BenchAllocator : ubyte
+{
+	Ansi,
+	Binned,
+	Arena,
+	Std
+};
+
+FORCE_INLINE const ansichar * getBenchOpName(BenchOp op)
+{
+	switch (op)
+	{
+		case BenchOp::Insert: return "insert";
+		case BenchOp::Lookup: return "lookup";
+		case BenchOp::Iterate: return "iterate";
+		case BenchOp::Erase: return "erase";
+		default: return "copy";
+	}
+}
+
+FORCE_INLINE const ansichar * getBenchPatternName(BenchPattern pattern)
+{
+	switch (pattern)
+	{
+		case BenchPattern::Sequential: return "seq";
+		case BenchPattern::Random: return "random";
+		default: return "zipf";
+	}
+}
+
+FORCE_INLINE const ansichar * getBenchAllocatorName(BenchAllocator allocator)
+{
+	switch (allocator)
+	{
+		case BenchAllocator::Ansi: return "ansi";
+		case BenchAllocator::Binned: return "binned";
+		case BenchAllocator::Arena: return "arena";
+		default: return "std";
+	}
+}
+
+/**
+ * Installs an allocator as gMalloc for
+ * the lifetime of the object. Containers
+ * created meanwhile keep using it.
+ */
+class BenchAllocatorScope
+{
+public:
+	explicit BenchAllocatorScope(BenchAllocator inAllocator)
+		: allocator{inAllocator}
+		, prev{gMalloc}
+		, malloc{nullptr}
+	{
+		switch (allocator)
+		{
+			case BenchAllocator::Ansi: malloc = new MallocAnsi; break;
+			case BenchAllocator::Binned: malloc = new MallocBinned; break;
+			case BenchAllocator::Arena: malloc = new MallocArena{MallocArena::defaultBlockSize, prev}; break;
+			default: return;
+		}
+
+		gMalloc = malloc;
+	}
+
+	BenchAllocatorScope(const BenchAllocatorScope&) = delete;
+	BenchAllocatorScope & operator=(const BenchAllocatorScope&) = delete;
+
+	~BenchAllocatorScope()
+	{
+		gMalloc = prev;
+		delete malloc;
+	}
+
+	/**
+	 * Releases the memory of an arena, once
+	 * all containers are destroyed.
+	 */
+	FORCE_INLINE void reset()
+	{
+		if (allocator == BenchAllocator::Arena) static_cast<MallocArena*>(malloc)->reset();
+	}
+
+protected:
+	/// Installed allocator
+	BenchAllocator allocator;
+
+	/// Previous gMalloc
+	MallocBase * prev;
+
+	/// Allocator instance
+	MallocBase * malloc;
+};
+
+/**
+ * Korin array, keys are accessed by
+ * index.
+ */
+template<typename KeyT>
+struct BenchKorinArray
+{
+	using ContainerT = Array<KeyT>;
+
+	static constexpr bool isKeyed = false;
+
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "Array";
+	}
+
+	static FORCE_INLINE void insert(ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		container.add(key);
+	}
+
+	static FORCE_INLINE uint64 lookup(const ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		return BenchKeyTraits<KeyT>::read(container[idx]);
+	}
+
+	static FORCE_INLINE uint64 iterate(const ContainerT & container)
+	{
+		uint64 sum = 0;
+		for (uint64 idx = 0, count = container.getCount(); idx < count; ++idx)
+			sum += BenchKeyTraits<KeyT>::read(container[idx]);
+
+		return sum;
+	}
+
+	static FORCE_INLINE void erase(ContainerT & container, const KeyT & key)
+	{
+		container.removeLast();
+	}
+};
+
+/**
+ * Std vector, keys are accessed by index.
+ */
+template<typename KeyT>
+struct BenchStdVector
+{
+	using ContainerT = std::vector<KeyT>;
+
+	static constexpr bool isKeyed = false;
+
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "std::vector";
+	}
+
+	static FORCE_INLINE void insert(ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		container.push_back(key);
+	}
+
+	static FORCE_INLINE uint64 lookup(const ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		return BenchKeyTraits<KeyT>::read(container[idx]);
+	}
+
+	static FORCE_INLINE uint64 iterate(const ContainerT & container)
+	{
+		uint64 sum = 0;
+		for (const KeyT & key : container) sum += BenchKeyTraits<KeyT>::read(key);
+
+		return sum;
+	}
+
+	static FORCE_INLINE void erase(ContainerT & container, const KeyT & key)
+	{
+		container.pop_back();
+	}
+};
+
+/**
+ * Korin ordered map, from key to index.
+ */
+template<typename KeyT>
+struct BenchKorinMap
+{
+	using ContainerT = Map<KeyT, uint64>;
+
+	static constexpr bool isKeyed = true;
+
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "Map";
+	}
+
+	static FORCE_INLINE void insert(ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		container.insert(key, idx);
+	}
+
+	static FORCE_INLINE uint64 lookup(const ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		uint64 value = 0;
+		container.find(key, value);
+
+		return value;
+	}
+
+	static FORCE_INLINE uint64 iterate(const ContainerT & container)
+	{
+		uint64 sum = 0;
+		for (const auto & pair : container) sum += BenchKeyTraits<KeyT>::read(pair.first) + pair.second;
+
+		return sum;
+	}
+
+	static FORCE_INLINE void erase(ContainerT & container, const KeyT & key)
+	{
+		container.remove(key);
+	}
+};
+
+/**
+ * Std ordered map, from key to index.
+ */
+template<typename KeyT>
+struct BenchStdMap
+{
+	using ContainerT = std::map<KeyT, uint64>;
+
+	static constexpr bool isKeyed = true;
+
+	static FORCE_INLINE const ansichar * getName()
+	{
+		return "std::map";
+	}
+
+	static FORCE_INLINE void insert(ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		container.emplace(key, idx);
+	}
+
+	static FORCE_INLINE uint64 lookup(const ContainerT & container, const KeyT & key, uint64 idx)
+	{
+		auto it = container.find(key);
+		return it != container.end() ? it->second : 0;
+	}
+
+	static FORCE_INLINE uint64 iterate(const ContainerT & container)
+	{
+		uint64 sum = 0;
+		for (const auto & pair : container) sum += BenchKeyTraits<KeyT>::read(pair.first) + pair.second;
+
+		return sum;
+	}
+
+	static FORCE_INLINE void erase(ContainerT & container, const KeyT & key)
+	{
+		container.erase(key);
+	}
+};
+
+/**
+ * Returns n keys, in ascending order.
+ */
+template<typename KeyT>
+Array<KeyT> createBenchKeys(uint64 n)
+{
+	Array<KeyT> keys;
+	keys.reserve(n);
+
+	for (uint64 idx = 0; idx < n; ++idx) keys.add(BenchKeyTraits<KeyT>::create(idx));
+
+	return keys;
+}
+
+/**
+ * Returns the indices of the keys in the
+ * order they are accessed. Zipfian draws
+ * n ranks, hot ranks are spread over the
+ * keys with a random permutation.
+ */
+Array<uint64> createBenchOrder(uint64 n, BenchPattern pattern)
+{
+	Array<uint64> order;
+	order.reserve(n);
+
+	for (uint64 idx = 0; idx < n; ++idx) order.add(idx);
+	if (pattern == BenchPattern::Sequential) return order;
+
+	// Fisher-Yates shuffle
+	BenchRandom random;
+	for (uint64 idx = n; idx > 1; --idx)
+	{
+		const uint64 other = random.next(idx);
+		const uint64 tmp = order[idx - 1];
+		order[idx - 1] = order[other];
+		order[other] = tmp;
+	}
+
+	if (pattern == BenchPattern::Random) return order;
+
+	const BenchZipfian zipfian{n};
+	Array<uint64> draws;
+	draws.reserve(n);
+
+	for (uint64 idx = 0; idx < n; ++idx) draws.add(order[zipfian.next(random)]);
+
+	return draws;
+}
+
+/**
+ * Returns the number of containers built
+ * between two pauses of the timer, so
+ * that small sizes are not dominated by
+ * the cost of pausing.
+ */
+FORCE_INLINE uint64 getBenchMatrixBatch(uint64 n)
+{
+	return n < 1024 ? 1024 / n : 1;
+}
+
+/**
+ * Runs a cell of the matrix.
+ */
+template<template<typename> class AdapterT, typename KeyT>
+void benchContainerMatrix(benchmark::State & state, BenchOp op, BenchPattern pattern, BenchAllocator allocator)
+{
+	using AdapterType = AdapterT<KeyT>;
+	using ContainerT = typename AdapterType::ContainerT;
+
+	const uint64 n = state.range(0);
+	const uint64 numBatch = op == BenchOp::Insert || op == BenchOp::Erase ? getBenchMatrixBatch(n) : 1;
+
+	// Create the keys with the default
+	// allocator
+	const Array<KeyT> keys = createBenchKeys<KeyT>(n);
+	const Array<uint64> order = createBenchOrder(n, pattern);
+
+	BenchAllocatorScope scope{allocator};
+	uint64 sum = 0;
+
+	{
+		std::vector<ContainerT> containers(op == BenchOp::Insert ? 0 : 1);
+		if (op != BenchOp::Insert)
+		{
+			for (uint64 idx = 0; idx < n; ++idx) AdapterType::insert(containers[0], keys[idx], idx);
+		}
+
+		BenchPerfCounters counters{state, n * numBatch};
+		for (auto _ : state)
+		{
+			switch (op)
+			{
+				case BenchOp::Insert:
+				{
+					state.PauseTiming();
+					containers.clear();
+					scope.reset();
+					containers.resize(numBatch);
+					state.ResumeTiming();
+
+					for (ContainerT & container : containers)
+					{
+						for (uint64 idx = 0; idx < n; ++idx) AdapterType::insert(container, keys[order[idx]], order[idx]);
+					}
+
+					break;
+				}
+
+				case BenchOp::Lookup:
+				{
+					const ContainerT & container = containers[0];
+					for (uint64 idx = 0; idx < n; ++idx) sum += AdapterType::lookup(container, keys[order[idx]], order[idx]);
+
+					break;
+				}
+
+				case BenchOp::Iterate:
+				{
+					sum += AdapterType::iterate(containers[0]);
+					break;
+				}
+
+				case BenchOp::Erase:
+				{
+					state.PauseTiming();
+					containers.clear();
+					scope.reset();
+					containers.resize(numBatch);
+
+					for (ContainerT & container : containers)
+					{
+						for (uint64 idx = 0; idx < n; ++idx) AdapterType::insert(container, keys[idx], idx);
+					}
+
+					state.ResumeTiming();
+
+					for (ContainerT & container : containers)
+					{
+						for (uint64 idx = 0; idx < n; ++idx) AdapterType::erase(container, keys[order[idx]]);
+					}
+
+					break;
+				}
+
+				case BenchOp::Copy:
+				{
+					ContainerT copy{containers[0]};
+					benchmark::DoNotOptimize(&copy);
+
+					break;
+				}
+			}
+
+			benchmark::ClobberMemory();
+		}
+	}
+
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations() * n * numBatch);
+}
+
+/**
+ * Sets the sizes of a benchmark, powers
+ * of 10 from 10 to KORIN_BENCH_MAX_SIZE.
+ */
+FORCE_INLINE void setBenchMatrixSizes(benchmark::internal::Benchmark * bench)
+{
+	uint64 maxSize = 10000;
+	if (const ansichar * value = ::getenv("KORIN_BENCH_MAX_SIZE")) maxSize = ::strtoull(value, nullptr, 10);
+
+	for (uint64 size = 10; size <= maxSize; size *= 10) bench->Arg(static_cast<int64_t>(size));
+}
+
+/**
+ * Registers the cells of a container and
+ * key type. Positional ops (insert and
+ * erase of sequences), iteration and copy
+ * only run sequentially. Copies are not
+ * run with the arena, which can't free
+ * them.
+ */
+template<template<typename> class AdapterT, typename KeyT>
+void registerBenchMatrix(std::initializer_list<BenchAllocator> allocators)
+{
+	using AdapterType = AdapterT<KeyT>;
+
+	for (BenchOp op : {BenchOp::Insert, BenchOp::Lookup, BenchOp::Iterate, BenchOp::Erase, BenchOp::Copy})
+	{
+		for (BenchPattern pattern : {BenchPattern::Sequential, BenchPattern::Random, BenchPattern::Zipfian})
+		{
+			const bool isKeyedOp = AdapterType::isKeyed && (op == BenchOp::Insert || op == BenchOp::Erase);
+			if (pattern == BenchPattern::Random && op != BenchOp::Lookup && !isKeyedOp) continue;
+			if (pattern == BenchPattern::Zipfian && op != BenchOp::Lookup) continue;
+
+			for (BenchAllocator allocator : allocators)
+			{
+				if (allocator == BenchAllocator::Arena && op == BenchOp::Copy) continue;
+
+				ansichar name[128];
+				::snprintf(name, sizeof(name), "%s/%s/%s/%s/%s", AdapterType::getName(), BenchKeyTraits<KeyT>::getName(), getBenchOpName(op), getBenchPatternName(pattern), getBenchAllocatorName(allocator));
+
+				benchmark::RegisterBenchmark(name, [op, pattern, allocator](benchmark::State & state) {
+
+					benchContainerMatrix<AdapterT, KeyT>(state, op, pattern, allocator);
+				})->Apply(setBenchMatrixSizes);
+			}
+		}
+	}
+}
+
+/**
+ * Registers the whole matrix. Arrays don't
+ * run with the binned allocator, whose
+ * largest block is 32 KiB.
+ */
+template<typename KeyT>
+void registerBenchMatrix()
+{
+	registerBenchMatrix<BenchKorinArray, KeyT>({BenchAllocator::Ansi, BenchAllocator::Arena});
+	registerBenchMatrix<BenchStdVector, KeyT>({BenchAllocator::Std});
+	registerBenchMatrix<BenchKorinMap, KeyT>({BenchAllocator::Ansi, BenchAllocator::Binned, BenchAllocator::Arena});
+	registerBenchMatrix<BenchStdMap, KeyT>({BenchAllocator::Std});
+}
+
+static const bool benchMatrixRegistered = []() {
+
+	registerBenchMatrix<uint64>();
+	registerBenchMatrix<String>();
+	registerBenchMatrix<BenchLargeKey>();
+
+	return true;
+}();
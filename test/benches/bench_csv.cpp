@@ -0,0 +1,4 @@
+#include "bench_csv.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "serialization/csv_reader.h"
+#include "serialization/number_parser.h"
+#include "serialization/record_reader.h"
+
+/**
+ * Returns a synthetic CSV with rows like
+ * "4242,17.25,item-4242,GET,\"note, with comma\"".
+ */
+static String makeBenchCsv(uint64 size)
+{
+	static const ansichar * methods[] = {"GET", "GET", "POST", "PUT", "DELETE"};
+
+	String text = "id,price,name,method,note\n";
+	ansichar line[256];
+	uint64 seed = 1;
+
+	while (text.getLength() < size)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const uint32 r = seed >> 33;
+
+		::snprintf(line, sizeof(line), r % 5 ? "%u,%u.%02u,item-%u,%s,plain\n" : "%u,%u.%02u,item-%u,%s,\"note, with \"\"quotes\"\"\"\n",
+			r, r % 1000, r % 100, r % 100000, methods[r / 7 % 5]);
+
+		text += static_cast<const ansichar*>(line);
+	}
+
+	return text;
+}
+
+/**
+ * Korin CSV reader, single thread
+ */
+void korinCsvParse(benchmark::State & state)
+{
+	const String text = makeBenchCsv(state.range(0));
+
+	for (auto _ : state)
+	{
+		CsvReader reader{text};
+		CsvTable table;
+		reader.parse(table);
+
+		benchmark::DoNotOptimize(table.getNumRows());
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.getLength());
+}
+
+/**
+ * Korin CSV reader, chunks parsed by
+ * multiple threads
+ */
+void korinCsvParseParallel(benchmark::State & state)
+{
+	const String text = makeBenchCsv(state.range(0));
+	const uint32 numThreads = state.range(1);
+
+	for (auto _ : state)
+	{
+		CsvReader reader{text};
+		Array<StringView> chunks;
+		reader.split(numThreads, chunks);
+
+		CsvTable tables[16];
+		std::thread threads[16];
+		for (uint32 i = 0; i < chunks.getCount(); ++i) threads[i] = std::thread{[&reader, &chunks, &tables, i]() {
+
+			reader.parse(chunks[i], tables[i]);
+		}};
+
+		CsvTable table;
+		for (uint32 i = 0; i < chunks.getCount(); ++i)
+		{
+			threads[i].join();
+			table.append(move(tables[i]));
+		}
+
+		benchmark::DoNotOptimize(table.getNumRows());
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.getLength());
+}
+
+/**
+ * Lines and fields split with a string
+ * splitter, numbers parsed with strtoll
+ * and strtod, strings copied in String.
+ * Doesn't handle quoted delimiters.
+ */
+void korinCsvSplitStrtod(benchmark::State & state)
+{
+	const String text = makeBenchCsv(state.range(0));
+
+	for (auto _ : state)
+	{
+		Array<int64> ids;
+		Array<float64> prices;
+		Array<String> names, methods, notes;
+
+		StringSplitter lines{text, "\n"};
+		StringView line, field;
+		lines.next(line);
+
+		while (lines.next(line))
+		{
+			if (line.isEmpty()) continue;
+
+			StringSplitter fields{line, ","};
+			fields.next(field);
+			ids.add(::strtoll(*field, nullptr, 10));
+			fields.next(field);
+			prices.add(::strtod(*field, nullptr));
+			fields.next(field);
+			names.add(String{*field, field.getLength()});
+			fields.next(field);
+			methods.add(String{*field, field.getLength()});
+			fields.next(field);
+			notes.add(String{*field, field.getLength()});
+		}
+
+		benchmark::DoNotOptimize(ids.getCount());
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.getLength());
+}
+
+/**
+ * Number parser and strtod on the same
+ * decimal numbers
+ * @{
+ */
+static Array<String> makeBenchNumbers(uint32 n)
+{
+	Array<String> numbers;
+	ansichar buffer[64];
+	uint64 seed = 1;
+
+	for (uint32 i = 0; i < n; ++i)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		::snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int32>(seed % 7), static_cast<float64>(seed >> 40) / 1000.0);
+		numbers.add(String{buffer});
+	}
+
+	return numbers;
+}
+
+void korinNumberParserFloats(benchmark::State & state)
+{
+	const Array<String> numbers = makeBenchNumbers(state.range(0));
+
+	for (auto _ : state)
+	{
+		float64 sum = 0.0;
+		for (const String & number : numbers)
+		{
+			float64 value;
+			NumberParser::parse(number, value);
+			sum += value;
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * numbers.getCount());
+}
+
+void stdStrtodFloats(benchmark::State & state)
+{
+	const Array<String> numbers = makeBenchNumbers(state.range(0));
+
+	for (auto _ : state)
+	{
+		float64 sum = 0.0;
+		for (const String & number : numbers) sum += ::strtod(*number, nullptr);
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * numbers.getCount());
+}
+/// @}
+
+BENCHMARK(korinCsvParse)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinCsvParseParallel)->Args({1 << 26, 4})->Unit(benchmark::kMillisecond);
+BENCHMARK(korinCsvSplitStrtod)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinNumberParserFloats)->Arg(1 << 16);
+BENCHMARK(stdStrtodFloats)->Arg(1 << 16);
@@ -0,0 +1,4 @@
+#include "bench_deque.h"
+
+BENCHMARK_MAIN();
+
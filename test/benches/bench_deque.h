@@ -0,0 +1,125 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/list.h"
+#include "containers/deque.h"
+
+#include <deque>
+
+/**
+ * Korin deque used as a FIFO queue
+ */
+void korinDequeFifo(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Deque<uint32> deque;
+	uint32 item;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			deque.pushBack(i);
+		
+		for (uint32 i = 0; i < numItems; ++i)
+			deque.popFront(item);
+	}
+
+	doNotOptimizeAway(&deque);
+}
+
+/**
+ * Korin list used as a FIFO queue
+ */
+void korinListFifo(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	List<uint32> list;
+	uint32 item;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			list.pushBack(i);
+		
+		for (uint32 i = 0; i < numItems; ++i)
+			list.popFront(item);
+	}
+
+	doNotOptimizeAway(&list);
+}
+
+/**
+ * Std deque used as a FIFO queue
+ */
+void stdDequeFifo(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	std::deque<uint32> deque;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			deque.push_back(i);
+		
+		for (uint32 i = 0; i < numItems; ++i)
+			deque.pop_front();
+	}
+
+	doNotOptimizeAway(&deque);
+}
+
+/**
+ * Korin deque used as a sliding
+ * window, summing all the items
+ * in the window at each step
+ */
+void korinDequeWindow(benchmark::State & state)
+{
+	const uint32 windowSize = state.range(0);
+	Deque<uint32> deque;
+
+	for (uint32 i = 0; i < windowSize; ++i)
+		deque.pushBack(i);
+
+	for (auto _ : state)
+	{
+		deque.removeFront();
+		deque.pushBack(static_cast<uint32>(rand()));
+
+		uint32 sum = 0;
+		for (uint32 item : deque) sum += item;
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+/**
+ * Std deque used as a sliding window
+ */
+void stdDequeWindow(benchmark::State & state)
+{
+	const uint32 windowSize = state.range(0);
+	std::deque<uint32> deque;
+
+	for (uint32 i = 0; i < windowSize; ++i)
+		deque.push_back(i);
+
+	for (auto _ : state)
+	{
+		deque.pop_front();
+		deque.push_back(rand());
+
+		uint32 sum = 0;
+		for (uint32 item : deque) sum += item;
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+BENCHMARK(korinDequeFifo)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinListFifo)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(stdDequeFifo)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinDequeWindow)->RangeMultiplier(0x4)->Ranges({{0x10, 0x1000}});
+BENCHMARK(stdDequeWindow)->RangeMultiplier(0x4)->Ranges({{0x10, 0x1000}});
@@ -0,0 +1,4 @@
+#include "bench_files.h"
+
+BENCHMARK_MAIN();
+
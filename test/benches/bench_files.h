@@ -0,0 +1,227 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include <stdio.h>
+
+#include "containers/array.h"
+#include "hal/file.h"
+
+/// Path of the file used by the benchmarks
+static const ansichar * benchFilePath = "korin_bench_file.bin";
+
+/**
+ * Creates the file read by the benchmarks,
+ * it stays in the page cache afterwards.
+ */
+static void makeBenchFile(uint64 size)
+{
+	Array<ubyte> chunk{1 << 20};
+	chunk.resize(1 << 20);
+	for (uint64 i = 0; i < chunk.getCount(); ++i) chunk[i] = static_cast<ubyte>(i * 0x9e3779b1u >> 24);
+
+	File file{benchFilePath, FileOpenMode::Write};
+	for (uint64 pos = 0; pos < size; pos += chunk.getCount()) file.write(*chunk, PlatformMath::min(chunk.getCount(), size - pos));
+}
+
+/**
+ * Korin file, sequential read with views
+ * into the buffer
+ */
+void korinFileReadInto(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchFile(size);
+
+	for (auto _ : state)
+	{
+		File file{benchFilePath};
+		file.setAccessHint(FileAccessHint::Sequential);
+
+		uint64 sum = 0;
+		StringView view;
+		while (file.readInto(view)) sum += view[view.getLength() - 1];
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+/**
+ * Korin file, sequential read of small
+ * records
+ */
+void korinFileReadRecords(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchFile(size);
+
+	for (auto _ : state)
+	{
+		File file{benchFilePath};
+
+		uint64 sum = 0;
+		ubyte record[100];
+		while (file.read(record, sizeof(record)) == sizeof(record)) sum += record[0];
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+/**
+ * Std FILE, sequential read of small
+ * records
+ */
+void stdFileReadRecords(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchFile(size);
+
+	for (auto _ : state)
+	{
+		FILE * fp = ::fopen(benchFilePath, "rb");
+		::setvbuf(fp, nullptr, _IOFBF, File::defaultBufferSize);
+
+		uint64 sum = 0;
+		ubyte record[100];
+		while (::fread(record, 1, sizeof(record), fp) == sizeof(record)) sum += record[0];
+
+		::fclose(fp);
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+/**
+ * Korin file, read whole file into an
+ * array
+ */
+void korinFileReadAll(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchFile(size);
+
+	for (auto _ : state)
+	{
+		File file{benchFilePath};
+
+		Array<ubyte> bytes;
+		file.readAll(bytes);
+
+		benchmark::DoNotOptimize(*bytes);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+/**
+ * Korin file, sequential write of small
+ * records
+ */
+void korinFileWriteRecords(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+
+	ubyte record[100];
+	for (uint32 i = 0; i < sizeof(record); ++i) record[i] = i;
+
+	for (auto _ : state)
+	{
+		File file{benchFilePath, FileOpenMode::Write};
+		for (uint64 pos = 0; pos + sizeof(record) <= size; pos += sizeof(record)) file.write(record, sizeof(record));
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+/**
+ * Std FILE, sequential write of small
+ * records
+ */
+void stdFileWriteRecords(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+
+	ubyte record[100];
+	for (uint32 i = 0; i < sizeof(record); ++i) record[i] = i;
+
+	for (auto _ : state)
+	{
+		FILE * fp = ::fopen(benchFilePath, "wb");
+		::setvbuf(fp, nullptr, _IOFBF, File::defaultBufferSize);
+
+		for (uint64 pos = 0; pos + sizeof(record) <= size; pos += sizeof(record)) ::fwrite(record, 1, sizeof(record), fp);
+		::fclose(fp);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+/**
+ * Korin async file IO, batch of 4K reads
+ * at random offsets. The first argument
+ * is the batch size, the second selects
+ * io_uring (1) or pread (0)
+ */
+void korinAsyncFileRandomRead(benchmark::State & state)
+{
+	const uint64 size = 1ull << 28, blockSize = 4096;
+	const uint64 batchSize = state.range(0);
+	makeBenchFile(size);
+
+	AsyncFileIO io{64, state.range(1) != 0};
+	if (state.range(1) != 0 && !io.isUsingIoUring())
+	{
+		state.SkipWithError("io_uring not supported");
+		PlatformFiles::deleteFile(benchFilePath);
+		return;
+	}
+
+	File file{benchFilePath};
+	file.setAccessHint(FileAccessHint::Random);
+
+	Array<ubyte> blocks{batchSize * blockSize};
+	blocks.resize(batchSize * blockSize);
+
+	Array<FileIORequest> requests{batchSize};
+	requests.resize(batchSize);
+
+	uint64 seed = 1;
+	for (auto _ : state)
+	{
+		for (uint64 i = 0; i < batchSize; ++i)
+		{
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+
+			requests[i].data = *blocks + i * blockSize;
+			requests[i].size = blockSize;
+			requests[i].offset = (seed >> 33) % (size / blockSize) * blockSize;
+		}
+
+		io.read(file, *requests, batchSize);
+		benchmark::DoNotOptimize(*blocks);
+	}
+
+	state.SetBytesProcessed(state.iterations() * batchSize * blockSize);
+	state.SetItemsProcessed(state.iterations() * batchSize);
+	PlatformFiles::deleteFile(benchFilePath);
+}
+
+BENCHMARK(korinFileReadInto)->Arg(1 << 28)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinFileReadRecords)->Arg(1 << 28)->Unit(benchmark::kMillisecond);
+BENCHMARK(stdFileReadRecords)->Arg(1 << 28)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinFileReadAll)->Arg(1 << 28)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinFileWriteRecords)->Arg(1 << 28)->Unit(benchmark::kMillisecond);
+BENCHMARK(stdFileWriteRecords)->Arg(1 << 28)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinAsyncFileRandomRead)->ArgsProduct({{16, 256}, {0, 1}})->Unit(benchmark::kMicrosecond);
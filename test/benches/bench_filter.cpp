@@ -0,0 +1,4 @@
+#include "bench_filter.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/set.h"
+#include "containers/bloom_filter.h"
+#include "containers/cuckoo_filter.h"
+
+/// Number of keys inserted in the filters
+static constexpr uint64 benchFilterNumKeys = 1 << 20;
+
+/**
+ * Korin Bloom filter, false positive
+ * rate for a given number of bits per
+ * key
+ */
+void korinBloomFilterFpr(benchmark::State & state)
+{
+	const uint32 bitsPerKey = state.range(0);
+	BloomFilter<uint64> filter{benchFilterNumKeys, bitsPerKey};
+
+	for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+		filter.insert(i * 2);
+
+	uint64 numFalsePositives = 0;
+	for (auto _ : state)
+	{
+		numFalsePositives = 0;
+		for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+			numFalsePositives += filter.contains(i * 2 + 1);
+	}
+
+	state.counters["bitsPerKey"] = static_cast<float64>(filter.getNumBits()) / benchFilterNumKeys;
+	state.counters["fpr"] = static_cast<float64>(numFalsePositives) / benchFilterNumKeys;
+	state.SetItemsProcessed(state.iterations() * benchFilterNumKeys);
+}
+
+/**
+ * Korin Bloom filter, batch queries
+ */
+void korinBloomFilterBatch(benchmark::State & state)
+{
+	const uint32 bitsPerKey = state.range(0);
+	BloomFilter<uint64> filter{benchFilterNumKeys, bitsPerKey};
+	Array<uint64> keys;
+	Array<bool> results{benchFilterNumKeys, benchFilterNumKeys};
+
+	for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+		keys.add(i * 2);
+
+	filter.insert(*keys, keys.getCount());
+
+	for (uint64 & key : keys) key += 1;
+
+	uint64 numFalsePositives = 0;
+	for (auto _ : state)
+	{
+		numFalsePositives = filter.contains(*keys, keys.getCount(), *results);
+		doNotOptimizeAway(*results);
+	}
+
+	state.counters["bitsPerKey"] = static_cast<float64>(filter.getNumBits()) / benchFilterNumKeys;
+	state.counters["fpr"] = static_cast<float64>(numFalsePositives) / benchFilterNumKeys;
+	state.SetItemsProcessed(state.iterations() * benchFilterNumKeys);
+}
+
+/**
+ * Korin cuckoo filter, false positive
+ * rate at a given load factor (in %)
+ */
+void korinCuckooFilterFpr(benchmark::State & state)
+{
+	CuckooFilter<uint64> filter{benchFilterNumKeys};
+	const uint64 numKeys = filter.getCapacity() * state.range(0) / 100;
+
+	for (uint64 i = 0; i < numKeys; ++i)
+		filter.insert(i * 2);
+
+	uint64 numFalsePositives = 0;
+	for (auto _ : state)
+	{
+		numFalsePositives = 0;
+		for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+			numFalsePositives += filter.contains(i * 2 + 1);
+	}
+
+	state.counters["bitsPerKey"] = static_cast<float64>(filter.getCapacity() * 16) / filter.getCount();
+	state.counters["fpr"] = static_cast<float64>(numFalsePositives) / benchFilterNumKeys;
+	state.SetItemsProcessed(state.iterations() * benchFilterNumKeys);
+}
+
+/**
+ * Korin cuckoo filter, batch queries
+ * at a given load factor (in %)
+ */
+void korinCuckooFilterBatch(benchmark::State & state)
+{
+	CuckooFilter<uint64> filter{benchFilterNumKeys};
+	const uint64 numKeys = filter.getCapacity() * state.range(0) / 100;
+	Array<uint64> keys;
+	Array<bool> results{benchFilterNumKeys, benchFilterNumKeys};
+
+	for (uint64 i = 0; i < numKeys; ++i)
+		keys.add(i * 2);
+
+	filter.insert(*keys, keys.getCount());
+
+	keys.empty();
+	for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+		keys.add(i * 2 + 1);
+
+	uint64 numFalsePositives = 0;
+	for (auto _ : state)
+	{
+		numFalsePositives = filter.contains(*keys, keys.getCount(), *results);
+		doNotOptimizeAway(*results);
+	}
+
+	state.counters["bitsPerKey"] = static_cast<float64>(filter.getCapacity() * 16) / filter.getCount();
+	state.counters["fpr"] = static_cast<float64>(numFalsePositives) / benchFilterNumKeys;
+	state.SetItemsProcessed(state.iterations() * benchFilterNumKeys);
+}
+
+/**
+ * Korin set, negative lookups. This is
+ * the cost that filters save
+ */
+void korinSetNegativeLookup(benchmark::State & state)
+{
+	Set<uint64> set;
+
+	for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+		set.set(i * 2);
+
+	uint64 numFound = 0;
+	for (auto _ : state)
+	{
+		numFound = 0;
+		for (uint64 i = 0; i < benchFilterNumKeys; ++i)
+			numFound += set.get(i * 2 + 1);
+	}
+
+	benchmark::DoNotOptimize(numFound);
+	state.SetItemsProcessed(state.iterations() * benchFilterNumKeys);
+}
+
+BENCHMARK(korinBloomFilterFpr)->DenseRange(4, 20, 4)->Arg(10)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinBloomFilterBatch)->DenseRange(4, 20, 4)->Arg(10)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinCuckooFilterFpr)->Arg(25)->Arg(50)->Arg(75)->Arg(95)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinCuckooFilterBatch)->Arg(25)->Arg(50)->Arg(75)->Arg(95)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinSetNegativeLookup)->Unit(benchmark::kMillisecond);
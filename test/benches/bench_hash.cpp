@@ -0,0 +1,4 @@
+#include "bench_hash.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "templates/hash.h"
+
+#include <string_view>
+#include <functional>
+
+/**
+ * Returns a buffer of random bytes, large
+ * enough for the longest input.
+ */
+static const Array<ubyte> & getHashBytes()
+{
+	static const Array<ubyte> bytes = []() {
+
+		Array<ubyte> out{1 << 16};
+		uint64 seed = 0x2545f4914f6cdd1dull;
+		for (uint32 i = 0; i < (1 << 16); ++i)
+		{
+			seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+			out.add(static_cast<ubyte>(seed));
+		}
+
+		return out;
+	}();
+
+	return bytes;
+}
+
+/**
+ * Korin byte hash, throughput
+ */
+void korinHashBytes(benchmark::State & state)
+{
+	const Array<ubyte> & bytes = getHashBytes();
+	const sizet length = state.range(0);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(HashUtils::hashBytes(*bytes, length));
+	}
+
+	state.SetBytesProcessed(state.iterations() * length);
+}
+
+/**
+ * Std string view hash, throughput
+ */
+void stdHashBytes(benchmark::State & state)
+{
+	const Array<ubyte> & bytes = getHashBytes();
+	const std::string_view view{reinterpret_cast<const char*>(*bytes), static_cast<sizet>(state.range(0))};
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(std::hash<std::string_view>{}(view));
+	}
+
+	state.SetBytesProcessed(state.iterations() * view.size());
+}
+
+/**
+ * Korin integer hash
+ */
+void korinHashIntegers(benchmark::State & state)
+{
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (uint64 i = 0; i < 1024; ++i) sum += Hash<uint64>{}(i);
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+/**
+ * Std integer hash, which is the
+ * identity in libstdc++
+ */
+void stdHashIntegers(benchmark::State & state)
+{
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (uint64 i = 0; i < 1024; ++i) sum += std::hash<uint64>{}(i);
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK(korinHashBytes)->RangeMultiplier(8)->Range(8, 1 << 16);
+BENCHMARK(stdHashBytes)->RangeMultiplier(8)->Range(8, 1 << 16);
+BENCHMARK(korinHashIntegers);
+BENCHMARK(stdHashIntegers);
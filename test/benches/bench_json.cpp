@@ -0,0 +1,4 @@
+#include "bench_json.h"
+
+BENCHMARK_MAIN();
+
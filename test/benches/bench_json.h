@@ -0,0 +1,211 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "serialization/json_reader.h"
+#include "serialization/json_writer.h"
+
+/**
+ * A telemetry sample.
+ */
+struct BenchSample
+{
+	int64 id;
+	String host;
+	float64 value;
+	Array<String> tags;
+};
+
+/**
+ * Returns the given number of samples.
+ */
+static Array<BenchSample> makeBenchSamples(uint32 n)
+{
+	static const ansichar * hosts[] = {"eu-west-1a", "eu-west-1b", "us-east-2c", "ap-south-1a"};
+	static const ansichar * tags[] = {"cpu", "memory", "disk", "net \"primary\"", "gpu"};
+
+	Array<BenchSample> samples;
+	samples.reserve(n);
+
+	uint64 seed = 1;
+	for (uint32 i = 0; i < n; ++i)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const uint32 r = seed >> 33;
+
+		BenchSample sample{static_cast<int64>(r), String{hosts[r % 4]}, (r % 100000) / 64.0, Array<String>{}};
+		for (uint32 j = 0; j <= r % 3; ++j) sample.tags.add(String{tags[(r >> j) % 5]});
+
+		samples.add(move(sample));
+	}
+
+	return samples;
+}
+
+/**
+ * Writes samples with the JSON writer.
+ */
+static void writeBenchSamples(const Array<BenchSample> & samples, String & out)
+{
+	JsonWriter json{out};
+	json.beginArray();
+
+	for (const BenchSample & sample : samples)
+	{
+		json.beginObject();
+		json.field("id", sample.id);
+		json.field("host", sample.host);
+		json.field("value", sample.value);
+		json.field("tags", sample.tags);
+		json.field("meta", Map<String, int32>{});
+		json.endObject();
+	}
+
+	json.endArray();
+}
+
+/**
+ * Korin JSON writer
+ */
+void korinJsonWrite(benchmark::State & state)
+{
+	const Array<BenchSample> samples = makeBenchSamples(state.range(0));
+	uint64 numBytes = 0;
+
+	for (auto _ : state)
+	{
+		String out;
+		writeBenchSamples(samples, out);
+
+		numBytes += out.getLength();
+		benchmark::DoNotOptimize(*out);
+	}
+
+	state.SetBytesProcessed(numBytes);
+}
+
+/**
+ * Korin string formatting, without escapes
+ */
+void korinStringFormatJson(benchmark::State & state)
+{
+	const Array<BenchSample> samples = makeBenchSamples(state.range(0));
+	uint64 numBytes = 0;
+
+	for (auto _ : state)
+	{
+		String out = "[";
+		for (const BenchSample & sample : samples)
+		{
+			if (out.getLength() > 1) out += ',';
+
+			out += "{\"id\":";
+			out += sample.id;
+			out += ",\"host\":\"";
+			out += sample.host;
+			out += "\",\"value\":";
+			out += sample.value;
+			out += ",\"tags\":[";
+			for (uint64 i = 0; i < sample.tags.getCount(); ++i)
+			{
+				if (i > 0) out += ',';
+				out += '"';
+				out += sample.tags[i];
+				out += '"';
+			}
+			out += "],\"meta\":{}}";
+		}
+		out += ']';
+
+		numBytes += out.getLength();
+		benchmark::DoNotOptimize(*out);
+	}
+
+	state.SetBytesProcessed(numBytes);
+}
+
+/**
+ * Korin JSON reader, index only
+ */
+void korinJsonParse(benchmark::State & state)
+{
+	String text;
+	writeBenchSamples(makeBenchSamples(state.range(0)), text);
+
+	JsonReader reader;
+	for (auto _ : state)
+	{
+		reader.parse(text);
+		benchmark::DoNotOptimize(reader.getNumTokens());
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.getLength());
+}
+
+/**
+ * Korin JSON reader, one field of each
+ * object
+ */
+void korinJsonSumField(benchmark::State & state)
+{
+	String text;
+	writeBenchSamples(makeBenchSamples(state.range(0)), text);
+
+	JsonReader reader;
+	for (auto _ : state)
+	{
+		reader.parse(text);
+
+		float64 sum = 0.0;
+		for (const JsonValue & sample : reader.getRoot().getItems()) sum += sample["value"].getOr(0.0);
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.getLength());
+}
+
+/**
+ * Korin JSON reader, all fields into
+ * samples
+ */
+void korinJsonReadSamples(benchmark::State & state)
+{
+	String text;
+	writeBenchSamples(makeBenchSamples(state.range(0)), text);
+
+	JsonReader reader;
+	for (auto _ : state)
+	{
+		reader.parse(text);
+
+		Array<BenchSample> samples;
+		for (const JsonValue & item : reader.getRoot().getItems())
+		{
+			BenchSample sample{};
+			for (const JsonField & field : item.getFields())
+			{
+				if (field.key.equals("id")) field.value.get(sample.id);
+				else if (field.key.equals("host")) field.value.get(sample.host);
+				else if (field.key.equals("value")) field.value.get(sample.value);
+				else if (field.key.equals("tags")) field.value.get(sample.tags);
+			}
+
+			samples.add(move(sample));
+		}
+
+		benchmark::DoNotOptimize(*samples);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.getLength());
+}
+
+BENCHMARK(korinJsonWrite)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinStringFormatJson)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinJsonParse)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinJsonSumField)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinJsonReadSamples)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "benchmark/benchmark.h"
+#include "./bench_util.h"
 
 #include "core_types.h"
 #include "containers/tree.h"
@@ -35,6 +36,7 @@ void sglMap(benchmark::State & state)
 	const uint32 numNodes = state.range(0);
 	Map<uint32, uint32, LessThan> map;
 
+	BenchPerfCounters counters{state, numNodes};
 	for (auto _ : state)
 	{
 		for (uint32 i = 0; i < numNodes; ++i)
@@ -58,6 +60,7 @@ void stdMap(benchmark::State & state)
 	const uint32 numNodes = state.range(0);
 	std::map<uint32, uint32> map;
 
+	BenchPerfCounters counters{state, numNodes};
 	for (auto _ : state)
 	{
 		for (uint32 i = 0; i < numNodes; ++i)
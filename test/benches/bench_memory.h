@@ -6,6 +6,17 @@
 #include "hal/malloc_ansi.h"
 #include "hal/malloc_pool.h"
 #include "hal/malloc_binned.h"
+#include "hal/malloc_arena.h"
+#include "hal/malloc_tracer.h"
+#include "hal/file.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "serialization/json_writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <malloc.h>
 
 #ifndef DO_NOT_OPTIMIZE_AWAY_IMPL
 #define DO_NOT_OPTIMIZE_AWAY_IMPL
@@ -50,6 +61,12 @@ FORCE_INLINE MallocBase * createAllocator<MallocBinned>(uint32 n, sizet size, si
 	return new MallocBinned;
 }
 
+template<>
+FORCE_INLINE MallocBase * createAllocator<MallocArena>(uint32 n, sizet size, sizet align)
+{
+	return new MallocArena;
+}
+
 template<typename MallocT>
 void uniformAlloc(benchmark::State & state)
 {
@@ -101,6 +118,164 @@ void ListAlloc(benchmark::State & state)
 	destroyAllocator(malloc);
 }
 
+/**
+ * Returns the resident memory of the
+ * process, in Bytes.
+ */
+static uint64 getBenchRss()
+{
+	uint64 numPages = 0;
+	if (FILE * statm = ::fopen("/proc/self/statm", "r"))
+	{
+		if (::fscanf(statm, "%*u %llu", &numPages) != 1) numPages = 0;
+		::fclose(statm);
+	}
+
+	return numPages * ::sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * Allocation heavy workload: an index
+ * of arrays with churn, a log of strings
+ * cleared periodically and JSON documents.
+ */
+static void runBenchMallocWorkload(uint32 numRequests)
+{
+	Map<String, Array<int32>> index;
+	Array<String> log;
+	uint64 seed = 1;
+
+	for (uint32 i = 0; i < numRequests; ++i)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const uint32 r = seed >> 33;
+
+		String key = "key-";
+		key += static_cast<int64>(r % 4096);
+
+		if (r % 8 == 0) index.remove(key);
+		else index[key].add(static_cast<int32>(r));
+
+		String line;
+		for (uint32 j = 0; j < 1 + r % 12; ++j) line += "request handled ";
+		log.add(move(line));
+		if (log.getCount() == 512) log.empty();
+
+		if (r % 64 == 0)
+		{
+			String document;
+			JsonWriter json{document};
+			json.beginArray();
+			for (uint32 j = 0; j < r % 256; ++j) json.write(static_cast<int64>(j * r));
+			json.endArray();
+		}
+	}
+}
+
+/**
+ * Returns the trace replayed by the
+ * benchmarks: the file pointed by
+ * KORIN_MALLOC_TRACE if set, otherwise
+ * the trace of the workload above.
+ */
+static const MallocTrace & getBenchMallocTrace()
+{
+	static MallocTrace trace;
+	if (trace.getOps().getCount()) return trace;
+
+	if (const ansichar * path = ::getenv("KORIN_MALLOC_TRACE"))
+	{
+		File file{path};
+		if (!trace.load(file)) ::fprintf(stderr, "Invalid malloc trace %s\n", path);
+
+		return trace;
+	}
+
+	const ansichar * path = "korin_bench_malloc.trace";
+	{
+		File file{path, FileOpenMode::Write};
+		MallocTracer tracer{gMalloc, file};
+
+		MallocBase * prev = gMalloc;
+		gMalloc = &tracer;
+		runBenchMallocWorkload(100000);
+		gMalloc = prev;
+	}
+
+	File file{path};
+	trace.load(file);
+	PlatformFiles::deleteFile(path);
+
+	return trace;
+}
+
+/**
+ * Creates an allocator for the trace. The
+ * pooled allocator has a single block size,
+ * the largest request.
+ */
+template<typename MallocT>
+FORCE_INLINE MallocBase * createTraceAllocator(const MallocTrace & trace)
+{
+	return createAllocator<MallocT>(PlatformMath::max(trace.getNumSlots(), 8u), trace.getMaxSize(), 16);
+}
+
+/**
+ * Replays an allocation trace. Reports
+ * requests per second, the peak resident
+ * memory and the fragmentation, i.e. the
+ * peak resident memory over the peak
+ * requested memory, measured in a first
+ * untimed replay.
+ */
+template<typename MallocT>
+void traceReplay(benchmark::State & state)
+{
+	const MallocTrace & trace = getBenchMallocTrace();
+	uint64 numFailed = 0;
+
+	// Free memory cached by the C allocator,
+	// so that it's not reused
+	::malloc_trim(0);
+
+	const uint64 baseRss = getBenchRss();
+	uint64 peakRss = baseRss;
+	{
+		MallocBase * malloc = createTraceAllocator<MallocT>(trace);
+		{
+			MallocReplay replay{trace, *malloc};
+			while (!replay.isDone())
+			{
+				replay.run(1024);
+				peakRss = PlatformMath::max(peakRss, getBenchRss());
+			}
+		}
+		destroyAllocator(malloc);
+	}
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		MallocBase * malloc = createTraceAllocator<MallocT>(trace);
+		state.ResumeTiming();
+
+		{
+			MallocReplay replay{trace, *malloc};
+			replay.run();
+			numFailed = replay.getNumFailed();
+		}
+
+		state.PauseTiming();
+		destroyAllocator(malloc);
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() * trace.getOps().getCount());
+	state.counters["peakRssMB"] = (peakRss - baseRss) / static_cast<float64>(1 << 20);
+	state.counters["fragmentation"] = trace.getPeakBytes() ? static_cast<float64>(peakRss - baseRss) / trace.getPeakBytes() : 0.0;
+	state.counters["failed"] = numFailed;
+}
+
 BENCHMARK_TEMPLATE(uniformAlloc, MallocAnsi)->Ranges({{1u << 3, 1u << 15}, {1u << 3, 1u << 9}});
 BENCHMARK_TEMPLATE(uniformAlloc, MallocPool)->Ranges({{1u << 3, 1u << 15}, {1u << 3, 1u << 9}});
 BENCHMARK_TEMPLATE(uniformAlloc, MallocPooled)->Ranges({{1u << 3, 1u << 15}, {1u << 3, 1u << 9}});
@@ -109,4 +284,9 @@ BENCHMARK_TEMPLATE(uniformAlloc, MallocBinned)->Ranges({{1u << 3, 1u << 15}, {1u
 BENCHMARK_TEMPLATE(ListAlloc, MallocAnsi)->Ranges({{1u << 3, 1u << 15}});
 BENCHMARK_TEMPLATE(ListAlloc, MallocPool)->Ranges({{1u << 3, 1u << 15}});
 BENCHMARK_TEMPLATE(ListAlloc, MallocPooled)->Ranges({{1u << 3, 1u << 15}});
-BENCHMARK_TEMPLATE(ListAlloc, MallocBinned)->Ranges({{1u << 3, 1u << 15}});
\ No newline at end of file
+BENCHMARK_TEMPLATE(ListAlloc, MallocBinned)->Ranges({{1u << 3, 1u << 15}});
+
+BENCHMARK_TEMPLATE(traceReplay, MallocAnsi)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(traceReplay, MallocPooled)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(traceReplay, MallocBinned)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(traceReplay, MallocArena)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,4 @@
+#include "bench_priority_queue.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "templates/functional.h"
+#include "containers/array.h"
+#include "containers/set.h"
+#include "containers/priority_queue.h"
+
+#include <queue>
+#include <vector>
+
+/**
+ * Korin priority queue, with the
+ * given arity
+ */
+template<uint32 arity>
+void korinPriorityQueue(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	PriorityQueue<uint32, ThreeWayCompare, void, arity> queue;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			queue.push(static_cast<uint32>(rand()));
+		
+		for (uint32 i = 0; i < numItems; ++i)
+			queue.pop();
+	}
+
+	doNotOptimizeAway(&queue);
+}
+
+/**
+ * Korin ordered set used as a
+ * priority queue
+ */
+void korinSetQueue(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Set<uint32> set;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			set.set(static_cast<uint32>(rand()));
+		
+		while (set.getCount() > 0)
+			set.remove(*set.begin());
+	}
+
+	doNotOptimizeAway(&set);
+}
+
+/**
+ * Std priority queue
+ */
+void stdPriorityQueue(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	std::priority_queue<uint32, std::vector<uint32>, std::greater<uint32>> queue;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			queue.push(rand());
+		
+		for (uint32 i = 0; i < numItems; ++i)
+			queue.pop();
+	}
+
+	doNotOptimizeAway(&queue);
+}
+
+/**
+ * Korin priority queue, bulk heapify
+ */
+void korinPriorityQueueHeapify(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	PriorityQueue<uint32> queue;
+	Array<uint32> items;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		items.add(static_cast<uint32>(rand()));
+
+	for (auto _ : state)
+	{
+		queue.pushRange(items);
+		queue.empty();
+	}
+
+	doNotOptimizeAway(&queue);
+}
+
+/**
+ * Korin indexed priority queue, with
+ * decrease-key operations
+ */
+void korinIndexedPriorityQueue(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	IndexedPriorityQueue<uint32> queue;
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			queue.push(i, static_cast<uint32>(rand()));
+		
+		for (uint32 i = 0; i < numItems; ++i)
+			queue.pushOrDecrease(rand() % numItems, static_cast<uint32>(rand()));
+
+		while (!queue.isEmpty())
+			queue.pop();
+	}
+
+	doNotOptimizeAway(&queue);
+}
+
+BENCHMARK_TEMPLATE(korinPriorityQueue, 2)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK_TEMPLATE(korinPriorityQueue, 4)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinSetQueue)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(stdPriorityQueue)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinPriorityQueueHeapify)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinIndexedPriorityQueue)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
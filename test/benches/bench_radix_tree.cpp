@@ -0,0 +1,4 @@
+#include "bench_radix_tree.h"
+
+BENCHMARK_MAIN();
+
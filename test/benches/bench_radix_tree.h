@@ -0,0 +1,157 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "containers/radix_tree.h"
+
+/// Number of keys in the trees
+static constexpr uint32 benchRadixTreeNumKeys = 1 << 16;
+
+/**
+ * Returns a set of path-like keys that
+ * share long prefixes, as in routing
+ * tables or file systems.
+ */
+static const Array<String> & getRadixTreeKeys()
+{
+	static const Array<String> keys = []() {
+
+		const char * roots[] = {"/usr/share/", "/usr/lib/", "/home/user/projects/", "/var/log/"};
+		Array<String> out{benchRadixTreeNumKeys};
+
+		uint64 seed = 0x2545f4914f6cdd1dull;
+		for (uint32 i = 0; i < benchRadixTreeNumKeys; ++i)
+		{
+			seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+
+			String key = roots[seed & 3];
+			key += static_cast<uint32>((seed >> 8) % 1000);
+			key += "/file_";
+			key += i;
+			out.add(key);
+		}
+
+		return out;
+	}();
+
+	return keys;
+}
+
+/**
+ * Korin radix tree, point lookups
+ */
+void korinRadixTreeFind(benchmark::State & state)
+{
+	const Array<String> & keys = getRadixTreeKeys();
+	RadixTree<uint32> tree;
+
+	for (uint32 i = 0; i < keys.getCount(); ++i)
+		tree.insert(keys[i], i);
+
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (const String & key : keys)
+		{
+			uint32 value = 0;
+			tree.find(key, value);
+			sum += value;
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.getCount());
+}
+
+/**
+ * Korin map with string keys, point
+ * lookups
+ */
+void korinStringMapFind(benchmark::State & state)
+{
+	const Array<String> & keys = getRadixTreeKeys();
+	Map<String, uint32> map;
+
+	for (uint32 i = 0; i < keys.getCount(); ++i)
+		map.insert(keys[i], i);
+
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (const String & key : keys)
+		{
+			uint32 value = 0;
+			map.find(key, value);
+			sum += value;
+		}
+
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetItemsProcessed(state.iterations() * keys.getCount());
+}
+
+/**
+ * Korin radix tree, prefix scan of one
+ * directory
+ */
+void korinRadixTreePrefixScan(benchmark::State & state)
+{
+	const Array<String> & keys = getRadixTreeKeys();
+	RadixTree<uint32> tree;
+
+	for (uint32 i = 0; i < keys.getCount(); ++i)
+		tree.insert(keys[i], i);
+
+	uint64 numFound = 0;
+	for (auto _ : state)
+	{
+		numFound = 0;
+		tree.forEachPrefix("/usr/lib/42", [&numFound](const StringView & key, const uint32 & value) {
+
+			numFound += value != 0;
+		});
+
+		benchmark::DoNotOptimize(numFound);
+	}
+
+	state.counters["numFound"] = numFound;
+}
+
+/**
+ * Korin map with string keys, prefix
+ * scan by full iteration
+ */
+void korinStringMapPrefixScan(benchmark::State & state)
+{
+	const Array<String> & keys = getRadixTreeKeys();
+	Map<String, uint32> map;
+
+	for (uint32 i = 0; i < keys.getCount(); ++i)
+		map.insert(keys[i], i);
+
+	const StringView prefix = "/usr/lib/42";
+	uint64 numFound = 0;
+	for (auto _ : state)
+	{
+		numFound = 0;
+		for (const auto & it : map)
+		{
+			if (StringView{it.first}.startsWith(prefix)) numFound += it.second != 0;
+		}
+
+		benchmark::DoNotOptimize(numFound);
+	}
+
+	state.counters["numFound"] = numFound;
+}
+
+BENCHMARK(korinRadixTreeFind)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinStringMapFind)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinRadixTreePrefixScan)->Unit(benchmark::kMicrosecond);
+BENCHMARK(korinStringMapPrefixScan)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,4 @@
+#include "bench_records.h"
+
+BENCHMARK_MAIN();
+
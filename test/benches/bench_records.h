@@ -0,0 +1,216 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include <fstream>
+#include <string>
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "hal/file.h"
+#include "serialization/record_reader.h"
+#include "regex/regex.h"
+
+/// Path of the log used by the benchmarks
+static const ansichar * benchLogPath = "korin_bench_records.log";
+
+/**
+ * Writes a synthetic log with lines like
+ * "2024-05-01T12:00:07 INFO worker-3 GET /api/v1/items/4242 200 17ms".
+ */
+static void makeBenchLog(uint64 size)
+{
+	static const ansichar * levels[] = {"INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+	static const ansichar * methods[] = {"GET", "GET", "POST", "PUT", "DELETE"};
+
+	File file{benchLogPath, FileOpenMode::Write};
+	ansichar line[256];
+	uint64 seed = 1;
+
+	for (uint64 pos = 0; pos < size;)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const uint32 r = seed >> 33;
+
+		const int32 n = ::snprintf(line, sizeof(line), "2024-05-01T%02u:%02u:%02u %s worker-%u %s /api/v1/items/%u %u %ums\n",
+			r % 24, r / 24 % 60, r / 1440 % 60, levels[r % 6], r % 16, methods[r / 7 % 5], r % 100000, r % 9 ? 200 : 500, r % 1000);
+
+		file.write(line, n);
+		pos += n;
+	}
+}
+
+/**
+ * Korin record reader, zero-copy lines
+ */
+void korinRecordReaderLines(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchLog(size);
+
+	for (auto _ : state)
+	{
+		File file{benchLogPath};
+		RecordReader lines{file};
+
+		uint64 numChars = 0;
+		StringView line;
+		while (lines.next(line)) numChars += line.getLength();
+
+		benchmark::DoNotOptimize(numChars);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchLogPath);
+}
+
+/**
+ * Korin string per line, splitting the
+ * whole file
+ */
+void korinStringLines(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchLog(size);
+
+	for (auto _ : state)
+	{
+		File file{benchLogPath};
+		String text;
+		file.readAll(text);
+
+		uint64 numChars = 0;
+		for (int64 pos = 0, next; pos < static_cast<int64>(text.getLength()); pos = next + 1)
+		{
+			next = StringView{text}.findIndex('\n', pos);
+			if (next < 0) next = text.getLength();
+
+			String line{*text + pos, static_cast<sizet>(next - pos)};
+			numChars += line.getLength();
+		}
+
+		benchmark::DoNotOptimize(numChars);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchLogPath);
+}
+
+/**
+ * Std getline into std::string
+ */
+void stdGetlineLines(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchLog(size);
+
+	for (auto _ : state)
+	{
+		std::ifstream stream{benchLogPath};
+
+		uint64 numChars = 0;
+		std::string line;
+		while (std::getline(stream, line)) numChars += line.size();
+
+		benchmark::DoNotOptimize(numChars);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchLogPath);
+}
+
+/**
+ * Korin record reader, zero-copy fields
+ */
+void korinRecordReaderFields(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchLog(size);
+
+	for (auto _ : state)
+	{
+		File file{benchLogPath};
+		RecordReader lines{file};
+
+		uint64 numErrors = 0;
+		StringView line, field;
+		while (lines.next(line))
+		{
+			// Third field is the level
+			StringSplitter fields{line, " "};
+			fields.next(field);
+			fields.next(field);
+			numErrors += field == "ERROR";
+		}
+
+		benchmark::DoNotOptimize(numErrors);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchLogPath);
+}
+
+/**
+ * Korin string per field
+ */
+void korinStringFields(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchLog(size);
+
+	for (auto _ : state)
+	{
+		File file{benchLogPath};
+		RecordReader lines{file};
+
+		uint64 numErrors = 0;
+		StringView line, field;
+		while (lines.next(line))
+		{
+			Array<String> fields;
+			StringSplitter splitter{line, " "};
+			while (splitter.next(field)) fields.add(String{*field, field.getLength()});
+
+			numErrors += fields[1] == "ERROR";
+		}
+
+		benchmark::DoNotOptimize(numErrors);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchLogPath);
+}
+
+/**
+ * Korin record reader feeding a regex
+ */
+void korinRecordReaderRegex(benchmark::State & state)
+{
+	const uint64 size = state.range(0);
+	makeBenchLog(size);
+
+	const Re::Regex regex{"\\S+ ERROR .*"};
+
+	for (auto _ : state)
+	{
+		File file{benchLogPath};
+		RecordReader lines{file};
+
+		uint64 numErrors = 0;
+		StringView line;
+		while (lines.next(line)) numErrors += regex.accept(*line);
+
+		benchmark::DoNotOptimize(numErrors);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+	PlatformFiles::deleteFile(benchLogPath);
+}
+
+BENCHMARK(korinRecordReaderLines)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinStringLines)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(stdGetlineLines)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinRecordReaderFields)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinStringFields)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinRecordReaderRegex)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,4 @@
+#include "bench_serialization.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/map.h"
+#include "hal/malloc_binned.h"
+#include "serialization/memory_archive.h"
+#include "serialization/container_serialization.h"
+#include "serialization/mapped_image.h"
+
+/**
+ * Korin array of integers, save to
+ * memory
+ */
+void korinSerializeArraySave(benchmark::State & state)
+{
+	const uint64 count = state.range(0);
+	Array<uint64> numbers{count};
+	for (uint64 i = 0; i < count; ++i) numbers.add(i * 0x9e3779b97f4a7c15ull);
+
+	Array<ubyte> bytes{count * sizeof(uint64) + 64};
+	for (auto _ : state)
+	{
+		bytes.empty();
+		MemoryWriter writer{bytes};
+		writer << numbers;
+
+		benchmark::DoNotOptimize(*bytes);
+	}
+
+	state.SetBytesProcessed(state.iterations() * count * sizeof(uint64));
+}
+
+/**
+ * Korin array of integers, load from
+ * memory
+ */
+void korinSerializeArrayLoad(benchmark::State & state)
+{
+	const uint64 count = state.range(0);
+	Array<uint64> numbers{count};
+	for (uint64 i = 0; i < count; ++i) numbers.add(i * 0x9e3779b97f4a7c15ull);
+
+	Array<ubyte> bytes;
+	MemoryWriter writer{bytes};
+	writer << numbers;
+
+	for (auto _ : state)
+	{
+		Array<uint64> outNumbers;
+		MemoryReader reader{bytes};
+		reader << outNumbers;
+
+		benchmark::DoNotOptimize(*outNumbers);
+	}
+
+	state.SetBytesProcessed(state.iterations() * count * sizeof(uint64));
+}
+
+/**
+ * Korin array of strings, load from
+ * memory
+ */
+void korinSerializeStringsLoad(benchmark::State & state)
+{
+	const uint64 count = state.range(0);
+	Array<String> words{count};
+	for (uint64 i = 0; i < count; ++i)
+	{
+		String word = "word_";
+		word += i;
+		words.add(word);
+	}
+
+	Array<ubyte> bytes;
+	MemoryWriter writer{bytes};
+	writer << words;
+
+	for (auto _ : state)
+	{
+		Array<String> outWords;
+		MemoryReader reader{bytes};
+		reader << outWords;
+
+		benchmark::DoNotOptimize(*outWords);
+	}
+
+	state.SetBytesProcessed(state.iterations() * bytes.getCount());
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Map used by the load benchmarks. Each
+/// map has its own allocator, as a map
+/// loaded at startup would get fresh
+/// memory from the system allocator
+using BenchSerializedMapT = Map<uint64, uint64, ThreeWayCompare, MallocBinned>;
+
+/**
+ * Creates the serialized map used by the
+ * map benchmarks.
+ */
+static Array<ubyte> makeSerializedMap(uint64 count)
+{
+	Map<uint64, uint64> map;
+	for (uint64 i = 0; i < count; ++i) map.insert(i * 0x9e3779b97f4a7c15ull, i);
+
+	Array<ubyte> bytes;
+	MemoryWriter writer{bytes};
+	writer << map;
+
+	return bytes;
+}
+
+/**
+ * Korin map, load from memory with a
+ * bulk tree rebuild
+ */
+void korinSerializeMapLoad(benchmark::State & state)
+{
+	const Array<ubyte> bytes = makeSerializedMap(state.range(0));
+
+	for (auto _ : state)
+	{
+		BenchSerializedMapT outMap;
+		MemoryReader reader{bytes};
+		reader << outMap;
+
+		benchmark::DoNotOptimize(outMap.getCount());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Korin map, load from memory with one
+ * insert per pair
+ */
+void korinSerializeMapInsertLoad(benchmark::State & state)
+{
+	const Array<ubyte> bytes = makeSerializedMap(state.range(0));
+
+	for (auto _ : state)
+	{
+		BenchSerializedMapT outMap;
+		MemoryReader reader{bytes};
+
+		uint64 count = 0;
+		reader << count;
+		for (uint64 i = 0; i < count; ++i)
+		{
+			uint64 key, value;
+			reader << key << value;
+			outMap.insert(key, value);
+		}
+
+		benchmark::DoNotOptimize(outMap.getCount());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Creates a mapped image with a flat map,
+ * with the same pairs of the serialized
+ * map, and saves it to a file.
+ */
+static const ansichar * makeMappedMapFile(uint64 count)
+{
+	Map<uint64, uint64> map;
+	for (uint64 i = 0; i < count; ++i) map.insert(i * 0x9e3779b97f4a7c15ull, i);
+
+	MappedImageWriter writer;
+	writer.writeFlatMap(writer.allocateRoot<MappedFlatMap<uint64, uint64>>(), map);
+
+	const ansichar * path = "korin_bench_mapped.bin";
+	writer.save(path);
+
+	return path;
+}
+
+/**
+ * Korin map, load from memory and find
+ * the first key
+ */
+void korinSerializeMapLoadFirstFind(benchmark::State & state)
+{
+	const Array<ubyte> bytes = makeSerializedMap(state.range(0));
+
+	for (auto _ : state)
+	{
+		BenchSerializedMapT outMap;
+		MemoryReader reader{bytes};
+		reader << outMap;
+
+		uint64 value = 0;
+		outMap.find(0x9e3779b97f4a7c15ull, value);
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Korin mapped flat map, map file and
+ * find the first key
+ */
+void korinMappedMapOpenFirstFind(benchmark::State & state)
+{
+	const ansichar * path = makeMappedMapFile(state.range(0));
+
+	for (auto _ : state)
+	{
+		MappedImage image;
+		image.open(path);
+
+		uint64 value = 0;
+		image.getRoot<MappedFlatMap<uint64, uint64>>()->find(0x9e3779b97f4a7c15ull, value);
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	PlatformFiles::deleteFile(path);
+}
+
+/**
+ * Korin map, random lookups
+ */
+void korinSerializeMapFind(benchmark::State & state)
+{
+	const uint64 count = state.range(0);
+	const Array<ubyte> bytes = makeSerializedMap(count);
+
+	BenchSerializedMapT map;
+	MemoryReader reader{bytes};
+	reader << map;
+
+	uint64 i = 0;
+	for (auto _ : state)
+	{
+		uint64 value = 0;
+		map.find((i++ * 0x2545f4914f6cdd1dull % count) * 0x9e3779b97f4a7c15ull, value);
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Korin mapped flat map, random lookups
+ */
+void korinMappedMapFind(benchmark::State & state)
+{
+	const uint64 count = state.range(0);
+	const ansichar * path = makeMappedMapFile(count);
+
+	MappedImage image;
+	image.open(path);
+	const auto * map = image.getRoot<MappedFlatMap<uint64, uint64>>();
+
+	uint64 i = 0;
+	for (auto _ : state)
+	{
+		uint64 value = 0;
+		map->find((i++ * 0x2545f4914f6cdd1dull % count) * 0x9e3779b97f4a7c15ull, value);
+		benchmark::DoNotOptimize(value);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	PlatformFiles::deleteFile(path);
+}
+
+BENCHMARK(korinSerializeArraySave)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinSerializeArrayLoad)->RangeMultiplier(16)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinSerializeStringsLoad)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinSerializeMapLoad)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinSerializeMapInsertLoad)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(korinSerializeMapLoadFirstFind)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(korinMappedMapOpenFirstFind)->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(korinSerializeMapFind)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+BENCHMARK(korinMappedMapFind)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
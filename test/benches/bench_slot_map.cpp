@@ -0,0 +1,4 @@
+#include "bench_slot_map.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/map.h"
+#include "containers/slot_map.h"
+
+/**
+ * Entity stored in the tables
+ */
+struct BenchEntity
+{
+	float32 position[3];
+	float32 velocity[3];
+};
+
+/**
+ * Korin slot map, random lookups by
+ * handle
+ */
+void korinSlotMapLookup(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	SlotMap<BenchEntity> map;
+	Array<SlotHandle> handles;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		handles.add(map.insert(BenchEntity{}));
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			map[handles[rand() % numItems]].position[0] += 1.f;
+	}
+
+	doNotOptimizeAway(&map);
+}
+
+/**
+ * Korin ordered map, random lookups
+ * by id
+ */
+void korinMapLookup(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Map<uint64, BenchEntity> map;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		map.insert(i, BenchEntity{});
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+			map.find(static_cast<uint64>(rand() % numItems))->second.position[0] += 1.f;
+	}
+
+	doNotOptimizeAway(&map);
+}
+
+/**
+ * Korin slot map, iterates over all
+ * items
+ */
+void korinSlotMapIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	SlotMap<BenchEntity> map;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		map.insert(BenchEntity{});
+
+	for (auto _ : state)
+	{
+		for (BenchEntity & entity : map)
+			entity.position[0] += entity.velocity[0];
+	}
+
+	doNotOptimizeAway(&map);
+}
+
+/**
+ * Korin ordered map, iterates over
+ * all items
+ */
+void korinMapIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Map<uint64, BenchEntity> map;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		map.insert(i, BenchEntity{});
+
+	for (auto _ : state)
+	{
+		for (auto & pair : map)
+			pair.second.position[0] += pair.second.velocity[0];
+	}
+
+	doNotOptimizeAway(&map);
+}
+
+/**
+ * Korin slot map, removes and inserts
+ * items
+ */
+void korinSlotMapChurn(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	SlotMap<BenchEntity> map;
+	Array<SlotHandle> handles;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		handles.add(map.insert(BenchEntity{}));
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < numItems; ++i)
+		{
+			SlotHandle & handle = handles[rand() % numItems];
+			map.remove(handle);
+			handle = map.insert(BenchEntity{});
+		}
+	}
+
+	doNotOptimizeAway(&map);
+}
+
+BENCHMARK(korinSlotMapLookup)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinMapLookup)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinSlotMapIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinMapIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinSlotMapChurn)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
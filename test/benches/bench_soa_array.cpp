@@ -0,0 +1,4 @@
+#include "bench_soa_array.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/soa_array.h"
+#include "algorithm/sort.h"
+
+/**
+ * Body stored in the array of structs
+ */
+struct BenchBody
+{
+	uint32 id;
+	float32 mass;
+	float32 position[3];
+	float32 velocity[3];
+};
+
+/**
+ * Korin array of structs, integrates
+ * one coordinate of all bodies
+ */
+void korinAoSIntegrate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<BenchBody> bodies;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		bodies.add(BenchBody{i, 1.f, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}});
+
+	for (auto _ : state)
+	{
+		for (BenchBody & body : bodies)
+			body.position[0] += body.velocity[0] * 0.1f;
+	}
+
+	doNotOptimizeAway(&bodies);
+}
+
+/**
+ * Korin SoA array, integrates one
+ * coordinate of all bodies
+ */
+void korinSoAIntegrate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	SoAArray<uint32, float32, float32, float32> bodies;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		bodies.add(i, 1.f, 0.f, 1.f);
+
+	for (auto _ : state)
+	{
+		float32 * RESTRICT positions = bodies.getColumnData<2>();
+		const float32 * RESTRICT velocities = bodies.getColumnData<3>();
+
+		for (uint64 i = 0, count = bodies.getCount(); i < count; ++i)
+			positions[i] += velocities[i] * 0.1f;
+	}
+
+	doNotOptimizeAway(&bodies);
+}
+
+/**
+ * Korin array of structs, sorts by id
+ */
+void korinAoSSort(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<BenchBody> bodies;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		bodies.add(BenchBody{static_cast<uint32>(rand()), 1.f, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}});
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		Array<BenchBody> items{bodies};
+		state.ResumeTiming();
+
+		Sort::introsort(items.begin(), items.end(), [](const BenchBody & a, const BenchBody & b) {
+
+			return ThreeWayCompare{}(a.id, b.id);
+		});
+
+		doNotOptimizeAway(&items);
+	}
+}
+
+/**
+ * Korin SoA array, sorts rows by id
+ */
+void korinSoASort(benchmark::State & state)
+{
+	using SoAArrayT = SoAArray<uint32, float32, float32, float32>;
+
+	const uint32 numItems = state.range(0);
+	SoAArrayT bodies;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		bodies.add(static_cast<uint32>(rand()), 1.f, 0.f, 1.f);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		SoAArrayT items{bodies};
+		state.ResumeTiming();
+
+		Sort::introsort(items.begin(), items.end(), [](const auto & a, const auto & b) {
+
+			return ThreeWayCompare{}(a.template get<0>(), b.template get<0>());
+		});
+
+		doNotOptimizeAway(&items);
+	}
+}
+
+BENCHMARK(korinAoSIntegrate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinSoAIntegrate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinAoSSort)->RangeMultiplier(0x4)->Ranges({{0x10, 0x10000}});
+BENCHMARK(korinSoASort)->RangeMultiplier(0x4)->Ranges({{0x10, 0x10000}});
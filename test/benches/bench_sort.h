@@ -5,6 +5,7 @@
 #include "core_types.h"
 #include "containers/array.h"
 #include "algorithm/sort.h"
+#include "algorithm/top_k.h"
 
 #include <vector>
 #include <list>
@@ -74,5 +75,243 @@ void stdQuicksort(benchmark::State & state)
 	}
 }
 
+/**
+ * Korin stable merge sort
+ */
+template<typename ContainerT>
+void korinMergesort(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		Sort::mergesort(arr.begin(), arr.end(), [](int32 a, int32 b) { return a - b; });
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Stdlib stable sort
+ */
+template<typename ContainerT>
+void stdMergesort(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		std::stable_sort(arr.begin(), arr.end());
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Korin top 100 with introselect
+ */
+template<typename ContainerT>
+void korinNthElement(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		Sort::nthElement(arr.begin(), arr.end() - 100, arr.end(), [](int32 a, int32 b) { return a - b; });
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Stdlib top 100 with introselect
+ */
+template<typename ContainerT>
+void stdNthElement(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		std::nth_element(arr.begin(), arr.end() - 100, arr.end());
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Korin sorted top 100
+ */
+template<typename ContainerT>
+void korinPartialSort(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		Sort::partialSort(arr.begin(), arr.begin() + 100, arr.end(), [](int32 a, int32 b) { return b - a; });
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Stdlib sorted top 100
+ */
+template<typename ContainerT>
+void stdPartialSort(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		std::partial_sort(arr.begin(), arr.begin() + 100, arr.end(), [](int32 a, int32 b) { return a > b; });
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Korin streaming top 100, input
+ * is not modified
+ */
+template<typename ContainerT>
+void korinTopK(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		TopK<int32, 100> top;
+		top.pushRange(arr.begin(), arr.end());
+
+		doNotOptimizeAway(&top);
+	}
+}
+
+/**
+ * Korin introsort, with sorting
+ * network base case
+ */
+template<typename ContainerT>
+void korinIntrosort(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	ContainerT arr;
+	
+	initContainer(arr, dim);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		std::random_shuffle(arr.begin(), arr.end());
+		state.ResumeTiming();
+
+		Sort::introsort(arr.data(), arr.data() + arr.size(), ThreeWayCompare{});
+
+		doNotOptimizeAway(&arr);
+	}
+}
+
+/**
+ * Korin sorting network on small
+ * arrays
+ */
+template<typename T>
+void korinSortingNetwork(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	T src[SortingNetwork::maxCount], dst[SortingNetwork::maxCount];
+
+	for (uint32 i = 0; i < dim; ++i) src[i] = static_cast<T>(rand());
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < dim; ++i) dst[i] = src[i];
+		SortingNetwork::sort(dst, dim);
+
+		doNotOptimizeAway(dst);
+	}
+}
+
+/**
+ * Stdlib sort on small arrays
+ */
+template<typename T>
+void stdSmallSort(benchmark::State & state)
+{
+	const uint32 dim = state.range(0);
+	T src[SortingNetwork::maxCount], dst[SortingNetwork::maxCount];
+
+	for (uint32 i = 0; i < dim; ++i) src[i] = static_cast<T>(rand());
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < dim; ++i) dst[i] = src[i];
+		std::sort(dst, dst + dim);
+
+		doNotOptimizeAway(dst);
+	}
+}
+
 BENCHMARK_TEMPLATE(korinQuicksort, std::vector<int32>)->Range(1u << 6u, 100000000);
-BENCHMARK_TEMPLATE(stdQuicksort, std::vector<int32>)->Range(1u << 6u, 100000000);
\ No newline at end of file
+BENCHMARK_TEMPLATE(stdQuicksort, std::vector<int32>)->Range(1u << 6u, 100000000);
+BENCHMARK_TEMPLATE(korinMergesort, std::vector<int32>)->Range(1u << 6u, 100000000);
+BENCHMARK_TEMPLATE(stdMergesort, std::vector<int32>)->Range(1u << 6u, 100000000);
+BENCHMARK_TEMPLATE(korinNthElement, std::vector<int32>)->Range(1u << 10u, 10000000);
+BENCHMARK_TEMPLATE(stdNthElement, std::vector<int32>)->Range(1u << 10u, 10000000);
+BENCHMARK_TEMPLATE(korinPartialSort, std::vector<int32>)->Range(1u << 10u, 10000000);
+BENCHMARK_TEMPLATE(stdPartialSort, std::vector<int32>)->Range(1u << 10u, 10000000);
+BENCHMARK_TEMPLATE(korinTopK, std::vector<int32>)->Range(1u << 10u, 10000000);
+BENCHMARK_TEMPLATE(korinIntrosort, std::vector<int32>)->Range(1u << 6u, 100000000);
+BENCHMARK_TEMPLATE(korinSortingNetwork, int32)->DenseRange(4, 64, 12);
+BENCHMARK_TEMPLATE(stdSmallSort, int32)->DenseRange(4, 64, 12);
+BENCHMARK_TEMPLATE(korinSortingNetwork, float32)->DenseRange(4, 64, 12);
+BENCHMARK_TEMPLATE(stdSmallSort, float32)->DenseRange(4, 64, 12);
+BENCHMARK_TEMPLATE(korinSortingNetwork, uint64)->DenseRange(4, 64, 12);
+BENCHMARK_TEMPLATE(stdSmallSort, uint64)->DenseRange(4, 64, 12);
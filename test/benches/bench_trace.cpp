@@ -0,0 +1,4 @@
+#include "bench_trace.h"
+
+BENCHMARK_MAIN();
+
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include <chrono>
+
+#include "profiling/trace.h"
+
+/**
+ * Cost of reading the clock
+ * @{
+ */
+void korinTraceNow(benchmark::State & state)
+{
+	for (auto _ : state) benchmark::DoNotOptimize(Trace::now());
+}
+
+void stdSteadyClockNow(benchmark::State & state)
+{
+	for (auto _ : state) benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+}
+/// @}
+
+/**
+ * Cost of a timed scope, buffers are
+ * cleared before they fill up
+ */
+void korinScopedTimer(benchmark::State & state)
+{
+	Trace::reset();
+
+	for (auto _ : state)
+	{
+		for (uint32 i = 0; i < 1000; ++i) ScopedTimer timer{"bench"};
+
+		if (Trace::getNumEvents() > TraceBuffer::chunkSize * (TraceBuffer::maxNumChunks / 2))
+		{
+			state.PauseTiming();
+			Trace::reset();
+			state.ResumeTiming();
+		}
+	}
+
+	Trace::reset();
+	state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+/**
+ * Cost of adding a duration to a
+ * histogram
+ */
+void korinTraceHistogramAdd(benchmark::State & state)
+{
+	TraceHistogram histogram;
+	benchmark::DoNotOptimize(&histogram);
+	uint64 seed = 1;
+
+	for (auto _ : state)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		histogram.add(seed >> 44);
+		benchmark::ClobberMemory();
+	}
+}
+
+BENCHMARK(korinTraceNow);
+BENCHMARK(stdSteadyClockNow);
+BENCHMARK(korinScopedTimer);
+BENCHMARK(korinTraceHistogramAdd);
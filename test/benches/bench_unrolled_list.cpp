@@ -0,0 +1,4 @@
+#include "bench_unrolled_list.h"
+
+BENCHMARK_MAIN();
+
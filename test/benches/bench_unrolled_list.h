@@ -0,0 +1,171 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+#include "./bench_util.h"
+
+#include "containers/array.h"
+#include "containers/list.h"
+#include "containers/unrolled_list.h"
+
+/**
+ * Korin unrolled list, inserts items
+ * at random positions
+ */
+void korinUnrolledListInsert(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		UnrolledList<uint32> list;
+
+		for (uint32 i = 0; i < numItems; ++i)
+			list.insert(list.findAt(rand() % (i + 1)), i);
+
+		doNotOptimizeAway(&list);
+	}
+}
+
+/**
+ * Korin array, inserts items at
+ * random positions
+ */
+void korinArrayInsert(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		Array<uint32> array;
+
+		for (uint32 i = 0; i < numItems; ++i)
+		{
+			const uint32 idx = rand() % (i + 1);
+			if (idx < i) array.insertAt(idx, i);
+			else array.add(i);
+		}
+
+		doNotOptimizeAway(&array);
+	}
+}
+
+/**
+ * Korin unrolled list, inserts a new
+ * item after each existing item while
+ * iterating
+ */
+void korinUnrolledListInterleave(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		UnrolledList<uint32> list;
+		for (uint32 i = 0; i < numItems; ++i)
+			list.pushBack(i);
+		state.ResumeTiming();
+
+		for (auto it = list.begin(); it != list.end(); ++it)
+			it = list.insert(++it, 0u);
+
+		doNotOptimizeAway(&list);
+	}
+}
+
+/**
+ * Korin array, inserts a new item
+ * after each existing item
+ */
+void korinArrayInterleave(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		Array<uint32> array;
+		for (uint32 i = 0; i < numItems; ++i)
+			array.add(i);
+		state.ResumeTiming();
+
+		for (uint64 i = 0; i < array.getCount(); i += 2)
+		{
+			if (i + 1 < array.getCount()) array.insertAt(i + 1, 0u);
+			else array.add(0u);
+		}
+
+		doNotOptimizeAway(&array);
+	}
+}
+
+/**
+ * Korin unrolled list, iterates over
+ * all the items
+ */
+void korinUnrolledListIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	UnrolledList<uint32> list;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		list.pushBack(i);
+
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (uint32 item : list) sum += item;
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+/**
+ * Korin list, iterates over all the
+ * items
+ */
+void korinListIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	List<uint32> list;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		list.pushBack(i);
+
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (uint32 item : list) sum += item;
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+/**
+ * Korin array, iterates over all the
+ * items
+ */
+void korinArrayIterate(benchmark::State & state)
+{
+	const uint32 numItems = state.range(0);
+	Array<uint32> array;
+
+	for (uint32 i = 0; i < numItems; ++i)
+		array.add(i);
+
+	for (auto _ : state)
+	{
+		uint64 sum = 0;
+		for (uint32 item : array) sum += item;
+
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+BENCHMARK(korinUnrolledListInsert)->RangeMultiplier(0x4)->Ranges({{0x10, 0x10000}});
+BENCHMARK(korinArrayInsert)->RangeMultiplier(0x4)->Ranges({{0x10, 0x10000}});
+BENCHMARK(korinUnrolledListInterleave)->RangeMultiplier(0x4)->Ranges({{0x10, 0x10000}});
+BENCHMARK(korinArrayInterleave)->RangeMultiplier(0x4)->Ranges({{0x10, 0x10000}});
+BENCHMARK(korinUnrolledListIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinListIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
+BENCHMARK(korinArrayIterate)->RangeMultiplier(0x4)->Ranges({{0x10, 0x100000}});
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "benchmark/benchmark.h"
+
 #include "core_types.h"
+#include "profiling/perf_counters.h"
+
+#include <math.h>
 
 #ifndef DO_NOT_OPTIMIZE_AWAY_IMPL
 #define DO_NOT_OPTIMIZE_AWAY_IMPL
@@ -10,4 +15,182 @@
 		asm volatile("" : : "g" (p) : "memory");
 	}
 
-#endif
\ No newline at end of file
+#endif
+
+/**
+ * Counts hardware events while a
+ * benchmark runs and reports them as
+ * benchmark counters: IPC and events per
+ * item. Create it right before the
+ * benchmark loop, it reports when it
+ * goes out of scope:
+ *
+ * ```cpp
+ * void bench(benchmark::State & state)
+ * {
+ * 	BenchPerfCounters counters{state, numItems};
+ * 	for (auto _ : state) ...
+ * }
+ * ```
+ *
+ * Events not supported by the machine
+ * are not reported. Paused time is
+ * counted too.
+ */
+class BenchPerfCounters
+{
+public:
+	/**
+	 * Starts the counters.
+	 *
+	 * @param inState benchmark state
+	 * @param inNumItems items processed in
+	 * 	each iteration
+	 */
+	FORCE_INLINE BenchPerfCounters(benchmark::State & inState, uint64 inNumItems = 1)
+		: state{inState}
+		, numItems{inNumItems}
+	{
+		counters.start();
+	}
+
+	/**
+	 * Stops the counters and reports them.
+	 */
+	~BenchPerfCounters()
+	{
+		counters.stop();
+
+		const float64 numTotalItems = static_cast<float64>(state.iterations()) * numItems;
+		if (numTotalItems == 0.0) return;
+
+		if (counters.isAvailable(PerfEvent::Cycles) && counters.isAvailable(PerfEvent::Instructions))
+			state.counters["IPC"] = counters.getIpc();
+
+		for (uint32 idx = 0; idx < PerfCounters::numEvents; ++idx)
+		{
+			const PerfEvent event = static_cast<PerfEvent>(idx);
+			if (event == PerfEvent::TaskClock || !counters.isAvailable(event)) continue;
+
+			state.counters[std::string{PerfCounters::getName(event)} + "/item"] = counters.get(event) / numTotalItems;
+		}
+	}
+
+protected:
+	/// Benchmark state
+	benchmark::State & state;
+
+	/// Items per iteration
+	uint64 numItems;
+
+	/// Event counters
+	PerfCounters counters;
+};
+
+/**
+ * Deterministic random numbers
+ * (splitmix64), so that two runs of a
+ * benchmark see the same data.
+ */
+class BenchRandom
+{
+public:
+	/**
+	 * Creates a generator with the given
+	 * seed.
+	 */
+	FORCE_INLINE explicit BenchRandom(uint64 inSeed = 0x2545f4914f6cdd1dull)
+		: state{inSeed}
+	{
+		//
+	}
+
+	/**
+	 * Returns the next random number.
+	 */
+	FORCE_INLINE uint64 next()
+	{
+		uint64 z = state += 0x9e3779b97f4a7c15ull;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	/**
+	 * Returns a number in [0, n).
+	 */
+	FORCE_INLINE uint64 next(uint64 n)
+	{
+		return static_cast<uint64>((static_cast<unsigned __int128>(next()) * n) >> 64);
+	}
+
+	/**
+	 * Returns a number in [0, 1).
+	 */
+	FORCE_INLINE float64 nextUnit()
+	{
+		return (next() >> 11) * (1.0 / (1ull << 53));
+	}
+
+protected:
+	/// Generator state
+	uint64 state;
+};
+
+/**
+ * Draws ranks in [0, n) with a Zipfian
+ * distribution, rank 0 being the most
+ * frequent, as in Gray et al., "Quickly
+ * generating billion-record synthetic
+ * databases". Setup is O(n), each draw is
+ * O(1). With the default skew of 0.99
+ * (the one used by YCSB) the top 1% of
+ * ranks gets about half of the draws.
+ */
+class BenchZipfian
+{
+public:
+	/**
+	 * Creates a distribution.
+	 *
+	 * @param inN number of ranks
+	 * @param inTheta skew, in (0, 1)
+	 */
+	BenchZipfian(uint64 inN, float64 inTheta = 0.99)
+		: n{inN}
+		, theta{inTheta}
+		, alpha{1.0 / (1.0 - inTheta)}
+		, zetan{0.0}
+		, eta{0.0}
+	{
+		for (uint64 i = 1; i <= n; ++i) zetan += 1.0 / ::pow(static_cast<float64>(i), theta);
+
+		const float64 zeta2 = 1.0 + ::pow(0.5, theta);
+		eta = n > 2 ? (1.0 - ::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan) : 0.0;
+	}
+
+	/**
+	 * Returns the next rank.
+	 */
+	FORCE_INLINE uint64 next(BenchRandom & random) const
+	{
+		const float64 u = random.nextUnit();
+		const float64 uz = u * zetan;
+
+		if (n < 2 || uz < 1.0) return 0;
+		if (n == 2 || uz < 1.0 + ::pow(0.5, theta)) return 1;
+
+		const uint64 rank = static_cast<uint64>(n * ::pow(eta * u - eta + 1.0, alpha));
+		return rank < n ? rank : n - 1;
+	}
+
+protected:
+	/// Number of ranks
+	uint64 n;
+
+	/// Skew and its derived constants
+	float64 theta;
+	float64 alpha;
+	float64 zetan;
+	float64 eta;
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include "algorithm/sort.h"
+#include "algorithm/heap.h"
+#include "algorithm/top_k.h"
+#include "algorithm/sorting_network.h"
+#include "containers/array.h"
+#include "containers/pair.h"
+
+TEST(algorithm, mergesort)
+{
+	auto cmp = [](int32 a, int32 b) { return int32(a > b) - int32(a < b); };
+
+	for (uint32 dim : {0u, 1u, 2u, 31u, 64u, 1000u, 0x10000u})
+	{
+		Array<int32> a, b, c, d;
+		for (uint32 i = 0; i < dim; ++i)
+		{
+			a.add(rand() % 1000);
+			b.add(static_cast<int32>(i / 4));
+			c.add(static_cast<int32>(dim - i));
+			d.add((i & 0xff) < 0x80 ? static_cast<int32>(i) : rand());
+		}
+
+		// Random, sorted, reverse sorted and partially sorted
+		Sort::mergesort(a.begin(), a.end(), cmp);
+		Sort::mergesort(b.begin(), b.end(), cmp);
+		Sort::mergesort(c.begin(), c.end(), cmp);
+		Sort::mergesort(d.begin(), d.end(), cmp);
+
+		for (uint32 i = 1; i < dim; ++i)
+		{
+			ASSERT_LE(a[i - 1], a[i]);
+			ASSERT_LE(b[i - 1], b[i]);
+			ASSERT_LE(c[i - 1], c[i]);
+			ASSERT_LE(d[i - 1], d[i]);
+		}
+	}
+
+	// Stability, with and without buffer
+	using PairT = Pair<int32, int32>;
+	auto cmpKey = [](const PairT & a, const PairT & b) { return int32(a.first > b.first) - int32(a.first < b.first); };
+
+	for (MallocBase * malloc : {gMalloc, static_cast<MallocBase*>(nullptr)})
+	{
+		Array<PairT> e;
+		for (int32 i = 0; i < 0x4000; ++i)
+			e.add(PairT{rand() % 64, i});
+
+		Sort::mergesort(e.begin(), e.end(), cmpKey, malloc);
+
+		for (uint32 i = 1; i < e.getCount(); ++i)
+		{
+			ASSERT_LE(e[i - 1].first, e[i].first);
+			if (e[i - 1].first == e[i].first) ASSERT_LT(e[i - 1].second, e[i].second);
+		}
+	}
+
+	SUCCEED();
+}
+
+TEST(algorithm, heap)
+{
+	auto cmp = [](int32 a, int32 b) { return int32(a > b) - int32(a < b); };
+
+	Array<int32> a;
+	for (int32 i = 0; i < 1000; ++i) a.add(rand() % 100);
+
+	Heap::make(a.begin(), a.end(), cmp);
+	ASSERT_TRUE(Heap::isHeap(a.begin(), a.end(), cmp));
+
+	Heap::pop(a.begin(), a.end(), cmp);
+	ASSERT_TRUE(Heap::isHeap(a.begin(), a.end() - 1, cmp));
+	a.removeLast();
+
+	a.add(1000);
+	Heap::push(a.begin(), a.end(), cmp);
+	ASSERT_TRUE(Heap::isHeap(a.begin(), a.end(), cmp));
+	ASSERT_EQ(a[0], 1000);
+
+	Heap::sort(a.begin(), a.end(), cmp);
+	for (uint32 i = 1; i < a.getCount(); ++i) ASSERT_LE(a[i - 1], a[i]);
+
+	// 4-ary heap
+	Array<int32> b;
+	for (int32 i = 0; i < 1000; ++i) b.add(rand() % 100);
+
+	Heap::make<4>(b.begin(), b.end(), cmp);
+	ASSERT_TRUE(Heap::isHeap<4>(b.begin(), b.end(), cmp));
+
+	Heap::sort<4>(b.begin(), b.end(), cmp);
+	for (uint32 i = 1; i < b.getCount(); ++i) ASSERT_LE(b[i - 1], b[i]);
+}
+
+TEST(algorithm, selection)
+{
+	auto cmp = [](int32 a, int32 b) { return int32(a > b) - int32(a < b); };
+
+	for (uint32 dim : {1u, 2u, 17u, 100u, 10000u})
+	{
+		Array<int32> a, sorted;
+		for (uint32 i = 0; i < dim; ++i) a.add(static_cast<int32>(rand() % (dim / 2 + 1)));
+
+		sorted = a;
+		Sort::mergesort(sorted.begin(), sorted.end(), cmp);
+
+		for (uint32 k : {0u, dim / 3, dim - 1})
+		{
+			Array<int32> b = a;
+			Sort::nthElement(b.begin(), b.begin() + k, b.end(), cmp);
+			ASSERT_EQ(b[k], sorted[k]);
+			for (uint32 i = 0; i < k; ++i) ASSERT_LE(b[i], b[k]);
+			for (uint32 i = k + 1; i < dim; ++i) ASSERT_GE(b[i], b[k]);
+
+			Array<int32> c = a;
+			Sort::partialSort(c.begin(), c.begin() + k, c.end(), cmp);
+			for (uint32 i = 0; i < k; ++i) ASSERT_EQ(c[i], sorted[i]);
+		}
+	}
+
+	// Adversarial inputs
+	Array<int32> d;
+	for (int32 i = 0; i < 10000; ++i) d.add(i % 2 ? i : 10000 - i);
+	Sort::nthElement(d.begin(), d.begin() + 5000, d.end(), cmp);
+	for (int32 i = 0; i < 5000; ++i) ASSERT_LE(d[i], d[5000]);
+
+	TopK<int32, 10> top;
+	ASSERT_TRUE(top.isEmpty());
+
+	Array<int32> e;
+	for (int32 i = 0; i < 10000; ++i) e.add(rand());
+
+	top.pushRange(e.begin(), e.end());
+	ASSERT_TRUE(top.isFull());
+
+	Sort::mergesort(e.begin(), e.end(), cmp);
+	Array<int32> best = top.getSorted();
+	ASSERT_EQ(best.getCount(), 10);
+	for (uint32 i = 0; i < 10; ++i) ASSERT_EQ(best[i], e[e.getCount() - 1 - i]);
+	ASSERT_EQ(top.getThreshold(), best[9]);
+
+	ASSERT_FALSE(top.push(top.getThreshold()));
+	ASSERT_TRUE(top.push(e[e.getCount() - 1] + 1));
+}
+
+TEST(algorithm, sortingNetwork)
+{
+	auto cmp = [](auto a, auto b) { return int32(a > b) - int32(a < b); };
+
+	for (uint32 dim = 0; dim <= SortingNetwork::maxCount; ++dim)
+	{
+		Array<int32> a, ea;
+		Array<float32> b, eb;
+		Array<uint64> c, ec;
+		for (uint32 i = 0; i < dim; ++i)
+		{
+			a.add(rand() % 32 - 16);
+			b.add((rand() % 1000) / 10.f - 50.f);
+			c.add(static_cast<uint64>(rand()) << (rand() % 34));
+		}
+
+		ea = a, eb = b, ec = c;
+		Sort::mergesort(ea.begin(), ea.end(), cmp);
+		Sort::mergesort(eb.begin(), eb.end(), cmp);
+		Sort::mergesort(ec.begin(), ec.end(), cmp);
+
+		SortingNetwork::sort(*a, dim);
+		SortingNetwork::sort(*b, dim);
+		SortingNetwork::sort(*c, dim);
+
+		for (uint32 i = 0; i < dim; ++i)
+		{
+			ASSERT_EQ(a[i], ea[i]);
+			ASSERT_EQ(b[i], eb[i]);
+			ASSERT_EQ(c[i], ec[i]);
+		}
+	}
+
+	// Fixed size
+	uint64 d[] = {~0ull, 3, 1ull << 63, 0, 7, 1};
+	SortingNetwork::sort<6>(d);
+	ASSERT_EQ(d[0], 0);
+	ASSERT_EQ(d[3], 7);
+	ASSERT_EQ(d[5], ~0ull);
+}
+
+TEST(algorithm, introsort)
+{
+	auto cmp = [](int32 a, int32 b) { return int32(a > b) - int32(a < b); };
+
+	for (uint32 dim : {0u, 1u, 10u, 100u, 10000u})
+	{
+		Array<int32> a, b, c;
+		for (uint32 i = 0; i < dim; ++i)
+		{
+			a.add(rand() % 1000);
+			b.add(static_cast<int32>(i % 2 ? i : dim - i));
+		}
+
+		c = a;
+		Sort::introsort(a.begin(), a.end(), cmp);
+		Sort::introsort(b.begin(), b.end(), cmp);
+		Sort::introsort(c.begin(), c.end(), ThreeWayCompare{});
+
+		for (uint32 i = 1; i < dim; ++i)
+		{
+			ASSERT_LE(a[i - 1], a[i]);
+			ASSERT_LE(b[i - 1], b[i]);
+			ASSERT_EQ(a[i], c[i]);
+		}
+	}
+
+	// Quicksort with sorting network base case
+	Array<float32> d;
+	for (uint32 i = 0; i < 1000; ++i) d.add(rand() / float32(RAND_MAX));
+	Sort::quicksort(*d, *d + d.getCount(), ThreeWayCompare{});
+	for (uint32 i = 1; i < d.getCount(); ++i) ASSERT_LE(d[i - 1], d[i]);
+}
@@ -5,13 +5,30 @@
 #include "containers/array.h"
 #include "containers/string.h"
 #include "containers/list.h"
+#include "containers/deque.h"
+#include "containers/intrusive_list.h"
+#include "containers/unrolled_list.h"
 #include "containers/tree.h"
 #include "containers/pair.h"
 #include "containers/map.h"
 #include "containers/set.h"
+#include "containers/priority_queue.h"
+#include "containers/bit_array.h"
+#include "containers/slot_map.h"
+#include "containers/chunked_array.h"
+#include "containers/soa_array.h"
+#include "containers/bloom_filter.h"
+#include "containers/cuckoo_filter.h"
+#include "containers/lru_cache.h"
+#include "containers/clock_cache.h"
+#include "containers/sharded_cache.h"
+#include "containers/radix_tree.h"
+#include "algorithm/sort.h"
 
 #include "hal/malloc_ansi.h"
 #include "hal/malloc_pool.h"
+#include "templates/atomic.h"
+#include <thread>
 
 TEST(containers, array)
 {
@@ -316,6 +333,336 @@ TEST(containers, list)
 	SUCCEED();
 }
 
+TEST(containers, deque)
+{
+	Deque<uint32> deque;
+	uint32 n;
+
+	ASSERT_EQ(deque.getCount(), 0);
+	ASSERT_TRUE(deque.isEmpty());
+	ASSERT_FALSE(deque.popFront(n));
+	ASSERT_FALSE(deque.removeBack());
+
+	deque.pushBack(4u);
+	deque.pushFront(3u);
+	deque.pushBack(5u);
+	deque.pushFront(2u);
+
+	ASSERT_EQ(deque.getCount(), 4);
+	ASSERT_EQ(deque.getCapacity(), Deque<uint32>::minCapacity);
+	ASSERT_EQ(deque.getFront(), 2);
+	ASSERT_EQ(deque.getBack(), 5);
+	ASSERT_EQ(deque[1], 3);
+	ASSERT_EQ(deque[2], 4);
+
+	// Items wrap around the buffer
+	for (uint32 i = 0; i < 16; ++i)
+	{
+		deque.pushBack(6u + i);
+		deque.popFront(n);
+		ASSERT_EQ(n, 2 + i);
+	}
+
+	ASSERT_EQ(deque.getCount(), 4);
+	ASSERT_EQ(deque.getCapacity(), Deque<uint32>::minCapacity);
+	ASSERT_EQ(deque.getFront(), 18);
+	ASSERT_EQ(deque.getBack(), 21);
+
+	// Grow while wrapped
+	for (uint32 i = 0; i < 8; ++i) deque.pushFront(17u - i);
+
+	ASSERT_EQ(deque.getCount(), 12);
+	ASSERT_EQ(deque.getCapacity(), 16);
+	for (uint32 i = 0; i < 12; ++i) ASSERT_EQ(deque[i], 10 + i);
+
+	// Random access iterators
+	auto it = deque.begin();
+	ASSERT_EQ(deque.end() - it, 12);
+	ASSERT_EQ(*(it + 3), 13);
+	ASSERT_EQ(it[11], 21);
+
+	it = deque.end();
+	--it;
+	ASSERT_EQ(*it, 21);
+	ASSERT_TRUE(deque.begin() < it);
+
+	uint32 expected = 10;
+	for (uint32 item : deque) ASSERT_EQ(item, expected++);
+
+	ASSERT_TRUE(deque.popBack(n));
+	ASSERT_EQ(n, 21);
+	ASSERT_TRUE(deque.removeFront());
+	ASSERT_EQ(deque.getFront(), 11);
+	ASSERT_EQ(deque.getBack(), 20);
+
+	Deque<uint32> copy{deque};
+
+	ASSERT_EQ(copy.getCount(), 10);
+	for (uint32 i = 0; i < 10; ++i) ASSERT_EQ(copy[i], 11 + i);
+
+	deque.empty();
+	deque.pushFront(1u);
+	copy = deque;
+
+	ASSERT_EQ(copy.getCount(), 1);
+	ASSERT_EQ(copy.getFront(), 1);
+
+	Deque<String> strings;
+	strings.pushBack("sneppy");
+	strings.pushFront("korin");
+
+	Deque<String> moved{move(strings)};
+
+	ASSERT_TRUE(strings.isEmpty());
+	ASSERT_EQ(moved.getFront(), "korin");
+	ASSERT_EQ(moved.getBack(), "sneppy");
+
+	Deque<uint64, MallocAnsi> pooled;
+	for (uint64 i = 0; i < 0x1000; ++i) pooled.pushBack(i);
+	for (uint64 i = 0; i < 0x800; ++i) pooled.removeFront();
+
+	ASSERT_EQ(pooled.getCount(), 0x800);
+	ASSERT_EQ(pooled.getFront(), 0x800);
+
+	pooled.reset();
+
+	ASSERT_EQ(pooled.getCapacity(), 0);
+}
+
+namespace
+{
+	struct Connection
+	{
+		uint32 id;
+		IntrusiveLink activeLink;
+		IntrusiveLink idleLink;
+
+		Connection(uint32 inId)
+			: id{inId}
+		{
+			//
+		}
+	};
+
+	class Timer
+	{
+	public:
+		IntrusiveLink link;
+
+		Timer(uint64 inDeadline)
+			: deadline{inDeadline}
+		{
+			//
+		}
+
+		virtual ~Timer()
+		{
+			//
+		}
+
+		FORCE_INLINE uint64 getDeadline() const
+		{
+			return deadline;
+		}
+
+	private:
+		uint64 deadline;
+	};
+}
+
+TEST(containers, intrusiveList)
+{
+	using ActiveListT = IntrusiveList<Connection, &Connection::activeLink>;
+	using IdleListT = IntrusiveList<Connection, &Connection::idleLink>;
+
+	Connection a{1}, b{2}, c{3}, d{4};
+	ActiveListT active;
+	IdleListT idle;
+
+	ASSERT_EQ(active.getLength(), 0);
+	ASSERT_TRUE(active.isEmpty());
+	ASSERT_EQ(active.getHead(), nullptr);
+	ASSERT_EQ(active.getTail(), nullptr);
+	ASSERT_EQ(active.popFront(), nullptr);
+	ASSERT_TRUE(active.begin() == active.end());
+
+	active.pushBack(b);
+	active.pushFront(a);
+	active.pushBack(d);
+	active.insert(--active.end(), c);
+
+	ASSERT_EQ(active.getLength(), 4);
+	ASSERT_EQ(active.getHead(), &a);
+	ASSERT_EQ(active.getTail(), &d);
+	ASSERT_EQ(ActiveListT::getOwner(&c.activeLink), &c);
+
+	uint32 id = 1;
+	for (const Connection & conn : active) ASSERT_EQ(conn.id, id++);
+
+	auto it = active.end();
+	--it;
+	ASSERT_EQ(it->id, 4);
+	it--;
+	ASSERT_EQ((*it).id, 3);
+
+	// Same items in two lists
+	idle.pushBack(c);
+	idle.pushBack(a);
+
+	ASSERT_TRUE(IdleListT::isLinked(a));
+	ASSERT_FALSE(IdleListT::isLinked(b));
+	ASSERT_EQ(idle.getHead(), &c);
+
+	active.remove(c);
+
+	ASSERT_EQ(active.getLength(), 3);
+	ASSERT_FALSE(ActiveListT::isLinked(c));
+	ASSERT_TRUE(IdleListT::isLinked(c));
+	ASSERT_EQ(active.getHead()->activeLink.next, &b.activeLink);
+
+	it = active.remove(active.begin());
+
+	ASSERT_EQ(it->id, 2);
+	ASSERT_EQ(active.getLength(), 2);
+	ASSERT_EQ(active.popBack(), &d);
+	ASSERT_EQ(active.popFront(), &b);
+	ASSERT_TRUE(active.isEmpty());
+	ASSERT_FALSE(ActiveListT::isLinked(b));
+
+	// Copies are unlinked
+	Connection e{c};
+
+	ASSERT_FALSE(IdleListT::isLinked(e));
+
+	IdleListT moved{move(idle)};
+
+	ASSERT_TRUE(idle.isEmpty());
+	ASSERT_EQ(moved.getLength(), 2);
+	ASSERT_EQ(moved.getTail(), &a);
+	ASSERT_EQ(moved.getTail()->idleLink.next, moved.getHead()->idleLink.prev);
+
+	moved.empty();
+
+	ASSERT_FALSE(IdleListT::isLinked(a));
+	ASSERT_FALSE(IdleListT::isLinked(c));
+
+	// Items need not be standard layout
+	using TimerListT = IntrusiveList<Timer, &Timer::link>;
+
+	Timer t0{10}, t1{20};
+	TimerListT timers;
+	timers.pushBack(t1);
+	timers.pushFront(t0);
+
+	ASSERT_EQ(TimerListT::getOwner(&t1.link), &t1);
+	ASSERT_EQ(timers.getHead()->getDeadline(), 10);
+	ASSERT_EQ(timers.getTail()->getDeadline(), 20);
+	ASSERT_EQ(timers.popFront(), &t0);
+	ASSERT_EQ((*timers.begin()).getDeadline(), 20);
+}
+
+TEST(containers, unrolledList)
+{
+	UnrolledList<uint32> list;
+	uint32 n;
+
+	ASSERT_EQ(list.getCount(), 0);
+	ASSERT_EQ(list.getNumNodes(), 0);
+	ASSERT_TRUE(list.begin() == list.end());
+	ASSERT_FALSE(list.popFront(n));
+
+	for (uint32 i = 0; i < 100; ++i) list.pushBack(i);
+
+	ASSERT_EQ(list.getCount(), 100);
+	ASSERT_EQ(list.getFront(), 0);
+	ASSERT_EQ(list.getBack(), 99);
+	ASSERT_LE(list.getNumNodes(), 100 / (UnrolledList<uint32>::itemsPerNode / 2) + 1);
+	ASSERT_EQ(list[57], 57);
+
+	uint32 expected = 0;
+	for (uint32 item : list) ASSERT_EQ(item, expected++);
+
+	auto it = list.end();
+	for (uint32 i = 100; i > 0; --i) ASSERT_EQ(*(--it), i - 1);
+	ASSERT_TRUE(it == list.begin());
+
+	ASSERT_TRUE(list.popBack(n));
+	ASSERT_EQ(n, 99);
+	ASSERT_TRUE(list.popFront(n));
+	ASSERT_EQ(n, 0);
+
+	list.empty();
+
+	ASSERT_EQ(list.getCount(), 0);
+	ASSERT_EQ(list.getNumNodes(), 0);
+
+	// Random inserts and removes with
+	// small nodes, to trigger splits
+	// and merges, checked against a
+	// dynamic array
+	UnrolledList<uint32, MallocAnsi, 4> numbers;
+	UnrolledList<String, MallocAnsi, 4> strings;
+	Array<uint32> reference;
+	uint64 seed = 0x1234;
+
+	for (uint32 i = 0; i < 2000; ++i)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const uint64 r = seed >> 33;
+
+		if (r % 3 != 0 || reference.getCount() == 0)
+		{
+			const uint64 idx = r % (reference.getCount() + 1);
+
+			auto jt = numbers.insert(numbers.findAt(idx), i);
+			auto kt = strings.insert(strings.findAt(idx), String::format("%u", i));
+			if (idx < reference.getCount()) reference.insertAt(idx, i);
+			else reference.add(i);
+
+			ASSERT_EQ(*jt, i);
+			ASSERT_EQ(*kt, String::format("%u", i));
+		}
+		else
+		{
+			const uint64 idx = r % reference.getCount();
+
+			auto jt = numbers.remove(numbers.findAt(idx));
+			auto kt = strings.remove(strings.findAt(idx));
+			reference.removeAt(idx);
+
+			if (idx < reference.getCount())
+			{
+				ASSERT_EQ(*jt, reference[idx]);
+				ASSERT_EQ(*kt, String::format("%u", reference[idx]));
+			}
+			else
+			{
+				ASSERT_TRUE(jt == numbers.end());
+				ASSERT_TRUE(kt == strings.end());
+			}
+		}
+
+		ASSERT_EQ(numbers.getCount(), reference.getCount());
+		ASSERT_EQ(strings.getCount(), reference.getCount());
+	}
+
+	uint64 idx = 0;
+	for (uint32 item : numbers) ASSERT_EQ(item, reference[idx++]);
+
+	idx = 0;
+	for (const String & item : strings) ASSERT_EQ(item, String::format("%u", reference[idx++]));
+
+	UnrolledList<String, MallocAnsi, 4> copy;
+	copy = strings;
+
+	ASSERT_EQ(copy.getCount(), strings.getCount());
+	ASSERT_EQ(copy.getBack(), strings.getBack());
+
+	UnrolledList<String> moved{UnrolledList<String>{}};
+
+	ASSERT_TRUE(moved.isEmpty());
+}
+
 template<typename T>
 struct LessThan
 {
@@ -701,4 +1048,1044 @@ TEST(containers, set)
 	}
 
 	ASSERT_EQ(kdx, 1);
-}
\ No newline at end of file
+}
+
+TEST(containers, priorityQueue)
+{
+	PriorityQueue<int32> a;
+
+	ASSERT_TRUE(a.isEmpty());
+
+	a.push(5);
+	a.push(3);
+	a.push(8);
+	a.push(1);
+
+	ASSERT_EQ(a.getCount(), 4);
+	ASSERT_EQ(a.top(), 1);
+
+	int32 x = 0;
+	a.pop(x);
+
+	ASSERT_EQ(x, 1);
+	ASSERT_EQ(a.top(), 3);
+
+	a.pop();
+	a.pop();
+
+	ASSERT_EQ(a.top(), 8);
+	ASSERT_EQ(a.getCount(), 1);
+
+	a.pop();
+
+	ASSERT_TRUE(a.isEmpty());
+
+	// Bulk insertion
+	Array<int32> b;
+	for (int32 i = 0; i < 1000; ++i) b.add(rand() % 500);
+
+	a.pushRange(b);
+	a.push(-1);
+
+	ASSERT_EQ(a.getCount(), 1001);
+	ASSERT_EQ(a.top(), -1);
+
+	int32 prev = -1; for (a.pop(); !a.isEmpty(); a.pop())
+	{
+		ASSERT_LE(prev, a.top());
+		prev = a.top();
+	}
+
+	// Binary queue with external allocator
+	MallocAnsi malloc;
+	PriorityQueue<String, ThreeWayCompare, void, 2> c{&malloc};
+	c.push("b");
+	c.push("a");
+	c.push("c");
+
+	ASSERT_EQ(c.top(), "a");
+
+	String y;
+	c.pop(y);
+
+	ASSERT_EQ(y, "a");
+	ASSERT_EQ(c.top(), "b");
+
+	// Queue with managed allocator
+	PriorityQueue<int32, ThreeWayCompare, MallocAnsi> d;
+	d.pushRange(b.begin(), b.end());
+
+	ASSERT_EQ(d.getCount(), 1000);
+	ASSERT_TRUE(Heap::isHeap<4>(*d.getArray(), *d.getArray() + d.getCount(), InverseCompare<ThreeWayCompare>{ThreeWayCompare{}}));
+}
+
+TEST(containers, indexedPriorityQueue)
+{
+	IndexedPriorityQueue<float32> a;
+
+	a.push(3, 3.f);
+	a.push(1, 1.f);
+	a.push(7, 7.f);
+	a.push(5, 5.f);
+
+	ASSERT_EQ(a.getCount(), 4);
+	ASSERT_TRUE(a.contains(5));
+	ASSERT_FALSE(a.contains(2));
+	ASSERT_FALSE(a.contains(100));
+	ASSERT_EQ(a.top().key, 1);
+
+	a.decreaseKey(7, 0.5f);
+
+	ASSERT_EQ(a.top().key, 7);
+	ASSERT_EQ(a.getPriority(7), 0.5f);
+
+	a.update(7, 10.f);
+
+	ASSERT_EQ(a.top().key, 1);
+
+	ASSERT_FALSE(a.pushOrDecrease(3, 4.f));
+	ASSERT_TRUE(a.pushOrDecrease(3, 0.f));
+	ASSERT_TRUE(a.pushOrDecrease(2, 2.f));
+	ASSERT_EQ(a.top().key, 3);
+
+	ASSERT_TRUE(a.remove(1));
+	ASSERT_FALSE(a.remove(1));
+
+	IndexedPriorityQueue<float32>::Entry e;
+	uint32 keys[] = {3, 2, 5, 7};
+	for (uint32 key : keys)
+	{
+		a.pop(e);
+		ASSERT_EQ(e.key, key);
+		ASSERT_FALSE(a.contains(key));
+	}
+
+	ASSERT_TRUE(a.isEmpty());
+
+	// Random operations
+	IndexedPriorityQueue<int32> b;
+	int32 priorities[256];
+	for (uint32 i = 0; i < 256; ++i) b.push(i, priorities[i] = rand() % 1000);
+	for (uint32 i = 0; i < 256; i += 3) b.update(i, priorities[i] = rand() % 1000);
+	for (uint32 i = 1; i < 256; i += 5) b.remove(i), priorities[i] = -1;
+
+	int32 prev = -1; while (!b.isEmpty())
+	{
+		ASSERT_EQ(b.top().priority, priorities[b.top().key]);
+		ASSERT_LE(prev, b.top().priority);
+
+		prev = b.top().priority;
+		b.pop();
+	}
+}
+
+TEST(containers, bitArray)
+{
+	BitArray bits{200};
+
+	ASSERT_EQ(bits.getCount(), 200);
+	ASSERT_EQ(bits.getNumWords(), 4);
+	ASSERT_EQ(bits.countSet(), 0);
+	ASSERT_EQ(bits.findFirstSet(), -1);
+	ASSERT_EQ(bits.findFirstUnset(), 0);
+	ASSERT_TRUE(bits.begin() == bits.end());
+
+	bits.set(3);
+	bits.set(64);
+	bits.set(199);
+
+	ASSERT_TRUE(bits[3]);
+	ASSERT_FALSE(bits.test(4));
+	ASSERT_EQ(bits.countSet(), 3);
+	ASSERT_EQ(bits.findFirstSet(), 3);
+	ASSERT_EQ(bits.findNextSet(4), 64);
+	ASSERT_EQ(bits.findNextSet(65), 199);
+	ASSERT_EQ(bits.findNextSet(200), -1);
+
+	ASSERT_FALSE(bits.testAndSet(5));
+	ASSERT_TRUE(bits.testAndSet(5));
+
+	bits.unset(5);
+	bits.flip(64);
+	bits.flip(65);
+
+	uint64 expected[] = {3, 65, 199};
+	uint32 i = 0;
+	for (uint64 idx : bits) ASSERT_EQ(idx, expected[i++]);
+	ASSERT_EQ(i, 3);
+
+	// Rank and select
+	ASSERT_EQ(bits.rank(0), 0);
+	ASSERT_EQ(bits.rank(4), 1);
+	ASSERT_EQ(bits.rank(66), 2);
+	ASSERT_EQ(bits.rank(200), 3);
+	ASSERT_EQ(bits.select(0), 3);
+	ASSERT_EQ(bits.select(2), 199);
+	ASSERT_EQ(bits.select(3), -1);
+
+	// Ranges
+	bits.unsetAll();
+	bits.setRange(10, 150);
+
+	ASSERT_EQ(bits.countSet(), 140);
+	ASSERT_EQ(bits.findFirstSet(), 10);
+	ASSERT_EQ(bits.findNextUnset(10), 150);
+
+	bits.unsetRange(20, 30);
+	bits.setRange(60, 61);
+
+	ASSERT_EQ(bits.countSet(), 130);
+	ASSERT_EQ(bits.findNextUnset(10), 20);
+	ASSERT_EQ(bits.findNextSet(20), 30);
+
+	bits.setAll();
+
+	ASSERT_EQ(bits.countSet(), 200);
+	ASSERT_EQ(bits.findFirstUnset(), -1);
+
+	// Resize keeps trailing bits clear
+	bits.resize(70);
+
+	ASSERT_EQ(bits.countSet(), 70);
+	ASSERT_EQ(bits.getWords()[1], (1ull << 6) - 1);
+
+	bits.resize(300, true);
+	bits.add(false);
+	bits.add(true);
+
+	ASSERT_EQ(bits.getCount(), 302);
+	ASSERT_EQ(bits.countSet(), 301);
+	ASSERT_FALSE(bits[300]);
+
+	// Bitwise operations, large enough
+	// to use the vector path
+	BitArray a{1000}, b{1000};
+	for (uint64 idx = 0; idx < 1000; idx += 2) a.set(idx);
+	for (uint64 idx = 0; idx < 1000; idx += 3) b.set(idx);
+
+	BitArray c = a;
+	c &= b;
+
+	ASSERT_EQ(c.countSet(), 167);
+	for (uint64 idx : c) ASSERT_EQ(idx % 6, 0);
+
+	c = a;
+	c |= b;
+
+	ASSERT_EQ(c.countSet(), 500 + 334 - 167);
+
+	c = a;
+	c ^= b;
+
+	ASSERT_EQ(c.countSet(), 500 + 334 - 2 * 167);
+
+	c = a;
+	c.andNot(b);
+
+	ASSERT_EQ(c.countSet(), 500 - 167);
+	ASSERT_TRUE(c != a);
+
+	BitArray d = c;
+	d ^= c;
+
+	ASSERT_TRUE(d == BitArray{1000});
+
+	d |= b;
+	d ^= b;
+
+	ASSERT_TRUE(d == BitArray{1000});
+
+	// Rank index agrees with linear
+	// rank and select
+	BitRankIndex index{b};
+
+	ASSERT_EQ(index.getNumSet(), 334);
+	for (uint64 idx = 0; idx <= 1000; idx += 7) ASSERT_EQ(index.rank(idx), b.rank(idx));
+	for (uint64 k = 0; k < 334; ++k) ASSERT_EQ(index.select(k), 3 * k);
+	ASSERT_EQ(index.select(334), -1);
+}
+
+TEST(containers, slotMap)
+{
+	SlotMap<String> map;
+	String item;
+
+	ASSERT_EQ(map.getCount(), 0);
+	ASSERT_FALSE(map.contains(SlotHandle{}));
+	ASSERT_EQ(map.get(SlotHandle{}), nullptr);
+
+	SlotHandle a = map.insert("a");
+	SlotHandle b = map.insert("b");
+	SlotHandle c = map.insert("c");
+
+	ASSERT_EQ(map.getCount(), 3);
+	ASSERT_TRUE(a.isValid());
+	ASSERT_NE(a, b);
+	ASSERT_EQ(map[a], "a");
+	ASSERT_EQ(*map.get(b), "b");
+	ASSERT_EQ(map.getHandle(2), c);
+	ASSERT_EQ(SlotHandle::fromValue(c.value), c);
+
+	// Remove moves last item in the
+	// hole, handles stay valid
+	ASSERT_TRUE(map.remove(a, item));
+	ASSERT_EQ(item, "a");
+	ASSERT_EQ(map.getCount(), 2);
+	ASSERT_FALSE(map.contains(a));
+	ASSERT_EQ(map.get(a), nullptr);
+	ASSERT_FALSE(map.remove(a));
+	ASSERT_EQ(map[b], "b");
+	ASSERT_EQ(map[c], "c");
+	ASSERT_EQ(map.getItems()[0], "c");
+	ASSERT_EQ(map.getHandle(0), c);
+
+	// Freed slot is reused with a new
+	// generation
+	SlotHandle d = map.insert("d");
+
+	ASSERT_EQ(d.getIndex(), a.getIndex());
+	ASSERT_NE(d.getGeneration(), a.getGeneration());
+	ASSERT_FALSE(map.contains(a));
+	ASSERT_EQ(map[d], "d");
+
+	uint32 numItems = 0;
+	for (const String & it : map)
+	{
+		ASSERT_TRUE(it == "b" || it == "c" || it == "d");
+		++numItems;
+	}
+	ASSERT_EQ(numItems, 3);
+
+	map.empty();
+
+	ASSERT_TRUE(map.isEmpty());
+	ASSERT_FALSE(map.contains(b));
+	ASSERT_FALSE(map.contains(d));
+
+	// Random inserts and removes,
+	// checked against a map of handles
+	SlotMap<uint64, MallocAnsi> numbers;
+	Array<SlotHandle> handles;
+	Array<uint64> values;
+	uint64 seed = 0x4321;
+
+	for (uint64 i = 0; i < 5000; ++i)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const uint64 r = seed >> 33;
+
+		if (r % 3 != 0 || handles.getCount() == 0)
+		{
+			handles.add(numbers.insert(i));
+			values.add(i);
+		}
+		else
+		{
+			const uint64 idx = r % handles.getCount();
+			uint64 value;
+
+			ASSERT_TRUE(numbers.remove(handles[idx], value));
+			ASSERT_EQ(value, values[idx]);
+			ASSERT_FALSE(numbers.contains(handles[idx]));
+
+			handles[idx] = handles[handles.getCount() - 1];
+			values[idx] = values[values.getCount() - 1];
+			handles.removeLast();
+			values.removeLast();
+		}
+	}
+
+	ASSERT_EQ(numbers.getCount(), handles.getCount());
+	for (uint64 i = 0; i < handles.getCount(); ++i) ASSERT_EQ(numbers[handles[i]], values[i]);
+	for (uint64 i = 0; i < numbers.getCount(); ++i) ASSERT_EQ(*numbers.get(numbers.getHandle(i)), numbers.getItems()[i]);
+}
+
+TEST(containers, chunkedArray)
+{
+	ChunkedArray<uint64, 16> array;
+
+	ASSERT_EQ(array.getCount(), 0);
+	ASSERT_EQ(array.getNumChunks(), 0);
+	ASSERT_TRUE(array.begin() == array.end());
+
+	uint64 * first = &array.add(0ull);
+	for (uint64 i = 1; i < 100; ++i) array.add(i);
+
+	// Items are never relocated
+	ASSERT_EQ(first, &array[0]);
+	ASSERT_EQ(array.getCount(), 100);
+	ASSERT_EQ(array.getNumChunks(), 7);
+	ASSERT_EQ(array.getCapacity(), 112);
+	ASSERT_EQ(array.getChunkCount(6), 4);
+	ASSERT_EQ(array.getChunk(1)[3], 19);
+	ASSERT_EQ(array[57], 57);
+	ASSERT_EQ(array.getLast(), 99);
+
+	uint64 expected = 0;
+	for (uint64 item : array) ASSERT_EQ(item, expected++);
+
+	auto it = array.begin() + 10;
+	ASSERT_EQ(*it, 10);
+	ASSERT_EQ(it[20], 30);
+	ASSERT_EQ(array.end() - it, 90);
+
+	array.removeAtSwap(5);
+
+	ASSERT_EQ(array[5], 99);
+	ASSERT_EQ(array.getCount(), 99);
+
+	// Remove odd items
+	const uint64 numRemoved = array.removeIf([](uint64 item) { return item & 1; });
+
+	ASSERT_EQ(numRemoved, 49);
+	ASSERT_EQ(array.getCount(), 50);
+	ASSERT_EQ(array.getNumChunks(), 4);
+	ASSERT_EQ(array[0], 0);
+	ASSERT_EQ(array[1], 2);
+	ASSERT_EQ(array[2], 4);
+	ASSERT_EQ(array[3], 6);
+	ASSERT_EQ(array.getLast(), 98);
+
+	array.empty();
+
+	ASSERT_EQ(array.getCount(), 0);
+	ASSERT_EQ(array.getNumChunks(), 4);
+
+	array.compact();
+
+	ASSERT_EQ(array.getNumChunks(), 0);
+
+	// Non trivial items
+	ChunkedArray<String> strings;
+	for (uint32 i = 0; i < 1000; ++i) strings.add(String::format("%u", i));
+
+	const String * ptr = &strings[10];
+	strings.add("last");
+
+	ASSERT_EQ(ptr, &strings[10]);
+	ASSERT_EQ(strings[999], "999");
+
+	ChunkedArray<String> copy{strings};
+
+	ASSERT_EQ(copy.getCount(), 1001);
+	ASSERT_EQ(copy.getLast(), "last");
+
+	String last;
+	copy.popLast(last);
+
+	ASSERT_EQ(last, "last");
+
+	ChunkedArray<String> moved{move(copy)};
+
+	ASSERT_TRUE(copy.isEmpty());
+	ASSERT_EQ(moved.getCount(), 1000);
+
+	// Chunks served by a memory pool
+	using PooledArrayT = ChunkedArray<uint32, 64, MallocPool>;
+	PooledArrayT pooled{4u, PooledArrayT::chunkBytes};
+
+	for (uint32 i = 0; i < 256; ++i) pooled.add(i);
+
+	ASSERT_EQ(pooled.getNumChunks(), 4);
+	ASSERT_EQ(pooled[255], 255);
+}
+
+TEST(containers, soaArray)
+{
+	SoAArray<uint32, float32, String> soa;
+
+	ASSERT_EQ(soa.getCount(), 0);
+	ASSERT_TRUE(soa.begin() == soa.end());
+
+	for (uint32 i = 0; i < 100; ++i)
+		soa.add((i * 37) % 100, i * 0.5f, String::format("%u", i));
+
+	ASSERT_EQ(soa.getCount(), 100);
+	ASSERT_GE(soa.getCapacity(), 100);
+
+	// Columns are contiguous and aligned
+	auto keys = soa.getColumn<0>();
+	auto values = soa.getColumn<1>();
+
+	ASSERT_EQ(keys.getCount(), 100);
+	ASSERT_EQ(reinterpret_cast<uintp>(keys.getData()) % decltype(soa)::columnAlignment, 0);
+	ASSERT_EQ(reinterpret_cast<uintp>(values.getData()) % decltype(soa)::columnAlignment, 0);
+	ASSERT_EQ(reinterpret_cast<uintp>(soa.getColumnData<2>()) % decltype(soa)::columnAlignment, 0);
+	ASSERT_EQ(keys[3], 11);
+	ASSERT_EQ(values[3], 1.5f);
+
+	float32 sum = 0.f;
+	for (float32 value : values) sum += value;
+
+	ASSERT_EQ(sum, 2475.f);
+
+	// Row access
+	auto row = soa[10];
+
+	ASSERT_EQ(row.get<0>(), 70);
+	ASSERT_EQ(row.get<1>(), 5.f);
+	ASSERT_EQ(row.get<2>(), "10");
+
+	row.get<1>() = 6.f;
+
+	ASSERT_EQ(values[10], 6.f);
+
+	// Sort rows by key
+	auto cmp = [](const auto & a, const auto & b) {
+
+		return ThreeWayCompare{}(a.template get<0>(), b.template get<0>());
+	};
+
+	Sort::introsort(soa.begin(), soa.end(), cmp);
+
+	for (uint32 i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(soa[i].get<0>(), i);
+		ASSERT_EQ(soa[i].get<2>(), String::format("%u", (i * 73) % 100));
+	}
+
+	auto cmpDesc = [](const auto & a, const auto & b) {
+
+		return ThreeWayCompare{}(b.template get<0>(), a.template get<0>());
+	};
+
+	Sort::mergesort(soa.begin(), soa.end(), cmpDesc);
+
+	for (uint32 i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(soa[i].get<0>(), 99 - i);
+		ASSERT_EQ(soa[i].get<2>(), String::format("%u", ((99 - i) * 73) % 100));
+	}
+
+	// Iterate rows
+	uint32 expected = 99;
+	for (auto it = soa.begin(); it != soa.end(); ++it) ASSERT_EQ((*it).get<0>(), expected--);
+
+	// Copy and move
+	SoAArray<uint32, float32, String> copy{soa};
+
+	ASSERT_EQ(copy.getCount(), 100);
+	ASSERT_EQ(copy[0].get<2>(), soa[0].get<2>());
+	ASSERT_NE(copy.getColumnData<0>(), soa.getColumnData<0>());
+
+	SoAArray<uint32, float32, String> moved{move(copy)};
+
+	ASSERT_TRUE(copy.isEmpty());
+	ASSERT_EQ(moved.getCount(), 100);
+	ASSERT_EQ(moved.getLast().get<0>(), 0);
+
+	// Remove rows
+	moved.removeAtSwap(0);
+
+	ASSERT_EQ(moved.getCount(), 99);
+	ASSERT_EQ(moved[0].get<0>(), 0);
+	ASSERT_EQ(moved[0].get<2>(), "0");
+
+	moved.removeLast();
+	moved.empty();
+
+	ASSERT_TRUE(moved.isEmpty());
+
+	moved.reset();
+
+	ASSERT_EQ(moved.getCapacity(), 0);
+}
+
+TEST(containers, bloomFilter)
+{
+	BloomFilter<uint64> filter{1000};
+
+	ASSERT_EQ(filter.getCount(), 0);
+	ASSERT_EQ(filter.getNumBits(), 10240);
+	ASSERT_FALSE(filter.contains(1));
+
+	for (uint64 i = 0; i < 1000; ++i) filter.insert(i * 2);
+
+	ASSERT_EQ(filter.getCount(), 1000);
+
+	// No false negatives
+	for (uint64 i = 0; i < 1000; ++i) ASSERT_TRUE(filter.contains(i * 2));
+
+	uint32 numFalsePositives = 0;
+	for (uint64 i = 0; i < 10000; ++i) numFalsePositives += filter.contains(i * 2 + 1);
+
+	ASSERT_LT(numFalsePositives, 300);
+
+	// Batch operations
+	Array<uint64> keys;
+	for (uint64 i = 0; i < 1000; ++i) keys.add(i * 2 + 100000);
+
+	BloomFilter<uint64> batched{1000};
+	batched.insert(*keys, keys.getCount());
+
+	bool results[1000];
+	ASSERT_EQ(batched.contains(*keys, keys.getCount(), results), 1000);
+	for (uint64 i = 0; i < 1000; ++i) ASSERT_TRUE(results[i]);
+
+	ASSERT_EQ(filter.contains(*keys, keys.getCount(), results), [&]() {
+
+		uint64 numPositives = 0;
+		for (uint64 key : keys) numPositives += filter.contains(key);
+		return numPositives;
+	}());
+
+	filter.empty();
+
+	ASSERT_FALSE(filter.contains(2));
+}
+
+TEST(containers, cuckooFilter)
+{
+	CuckooFilter<uint64> filter{1000};
+
+	ASSERT_EQ(filter.getCount(), 0);
+	ASSERT_GE(filter.getCapacity(), 1000);
+	ASSERT_FALSE(filter.contains(1));
+
+	for (uint64 i = 0; i < 1000; ++i) ASSERT_TRUE(filter.insert(i * 2));
+
+	ASSERT_EQ(filter.getCount(), 1000);
+	for (uint64 i = 0; i < 1000; ++i) ASSERT_TRUE(filter.contains(i * 2));
+
+	uint32 numFalsePositives = 0;
+	for (uint64 i = 0; i < 10000; ++i) numFalsePositives += filter.contains(i * 2 + 1);
+
+	ASSERT_LT(numFalsePositives, 30);
+
+	// Remove half of the keys
+	for (uint64 i = 0; i < 1000; i += 2) ASSERT_TRUE(filter.remove(i * 2));
+
+	ASSERT_EQ(filter.getCount(), 500);
+	for (uint64 i = 1; i < 1000; i += 2) ASSERT_TRUE(filter.contains(i * 2));
+
+	numFalsePositives = 0;
+	for (uint64 i = 0; i < 1000; i += 2) numFalsePositives += filter.contains(i * 2);
+
+	ASSERT_LT(numFalsePositives, 10);
+
+	// Fill up filter
+	CuckooFilter<uint64> full{256};
+	uint64 numInserted = 0;
+	while (full.insert(numInserted)) ++numInserted;
+
+	ASSERT_TRUE(full.isFull());
+	ASSERT_GT(full.getLoadFactor(), 0.9f);
+	for (uint64 i = 0; i < numInserted; ++i) ASSERT_TRUE(full.contains(i));
+
+	// Removing a key makes room
+	ASSERT_TRUE(full.remove(0));
+	ASSERT_EQ(full.getCount(), numInserted - 1);
+	for (uint64 i = 1; i < numInserted; ++i) ASSERT_TRUE(full.contains(i));
+
+	// Batch operations
+	Array<uint64> keys;
+	for (uint64 i = 0; i < 500; ++i) keys.add(i * 3);
+
+	CuckooFilter<uint64> batched{500};
+
+	ASSERT_EQ(batched.insert(*keys, keys.getCount()), 500);
+
+	bool results[500];
+	ASSERT_EQ(batched.contains(*keys, keys.getCount(), results), 500);
+	for (uint64 i = 0; i < 500; ++i) ASSERT_TRUE(results[i]);
+}
+
+TEST(containers, lruCache)
+{
+	LRUCache<uint64, String> cache{4};
+
+	ASSERT_EQ(cache.getCapacity(), 4);
+	ASSERT_TRUE(cache.isEmpty());
+	ASSERT_EQ(cache.get(1ull), nullptr);
+
+	Array<uint64> evicted;
+	cache.setEvictionCallback([&evicted](const uint64 & key, String & value) {
+
+		evicted.add(key);
+	});
+
+	cache.insert(1ull, String{"one"});
+	cache.insert(2ull, String{"two"});
+	cache.insert(3ull, String{"three"});
+	cache.insert(4ull, String{"four"});
+
+	ASSERT_TRUE(cache.isFull());
+	ASSERT_EQ(*cache.get(1ull), "one");
+
+	// 2 is the least recently used
+	cache.insert(5ull, String{"five"});
+
+	ASSERT_EQ(cache.getCount(), 4);
+	ASSERT_EQ(evicted.getCount(), 1);
+	ASSERT_EQ(evicted[0], 2);
+	ASSERT_FALSE(cache.has(2ull));
+	ASSERT_TRUE(cache.has(1ull));
+
+	// Peek does not change recency
+	ASSERT_EQ(*cache.peek(3ull), "three");
+	cache.insert(6ull, String{"six"});
+
+	ASSERT_EQ(evicted[1], 3);
+
+	// Update promotes the entry
+	cache.insert(4ull, String{"FOUR"});
+	cache.insert(7ull, String{"seven"});
+
+	ASSERT_EQ(evicted[2], 1);
+	ASSERT_EQ(*cache.get(4ull), "FOUR");
+
+	Array<uint64> order;
+	cache.forEach([&order](const uint64 & key, const String & value) {
+
+		order.add(key);
+	});
+
+	ASSERT_EQ(order.getCount(), 4);
+	ASSERT_EQ(order[0], 4);
+	ASSERT_EQ(order[1], 7);
+	ASSERT_EQ(order[2], 6);
+	ASSERT_EQ(order[3], 5);
+
+	// Remove does not call the callback
+	ASSERT_TRUE(cache.remove(6ull));
+	ASSERT_FALSE(cache.remove(6ull));
+	ASSERT_EQ(cache.getCount(), 3);
+	ASSERT_EQ(evicted.getCount(), 3);
+
+	cache.empty();
+
+	ASSERT_TRUE(cache.isEmpty());
+	ASSERT_FALSE(cache.has(4ull));
+
+	// Stress against many keys
+	LRUCache<uint64, uint64, Hash<uint64>, MallocAnsi> big{1000};
+	for (uint64 i = 0; i < 10000; ++i) big.insert(i, i * i);
+
+	ASSERT_EQ(big.getCount(), 1000);
+	for (uint64 i = 0; i < 9000; ++i) ASSERT_FALSE(big.has(i));
+	for (uint64 i = 9000; i < 10000; ++i) ASSERT_EQ(*big.get(i), i * i);
+
+	for (uint64 i = 9000; i < 10000; i += 2) ASSERT_TRUE(big.remove(i));
+	for (uint64 i = 9001; i < 10000; i += 2) ASSERT_EQ(*big.get(i), i * i);
+}
+
+TEST(containers, clockCache)
+{
+	ClockCache<uint64, String> cache{4};
+
+	Array<uint64> evicted;
+	cache.setEvictionCallback([&evicted](const uint64 & key, String & value) {
+
+		evicted.add(key);
+	});
+
+	cache.insert(1ull, String{"one"});
+	cache.insert(2ull, String{"two"});
+	cache.insert(3ull, String{"three"});
+	cache.insert(4ull, String{"four"});
+
+	ASSERT_TRUE(cache.isFull());
+
+	// Referenced entries get a second chance
+	ASSERT_EQ(*cache.get(1ull), "one");
+	ASSERT_EQ(*cache.get(3ull), "three");
+	cache.insert(5ull, String{"five"});
+
+	ASSERT_EQ(evicted.getCount(), 1);
+	ASSERT_EQ(evicted[0], 2);
+	ASSERT_TRUE(cache.has(1ull));
+	ASSERT_TRUE(cache.has(3ull));
+
+	cache.insert(6ull, String{"six"});
+
+	ASSERT_EQ(evicted[1], 4);
+
+	// Reference bits were cleared by the
+	// first sweep
+	cache.insert(7ull, String{"seven"});
+
+	ASSERT_EQ(evicted[2], 1);
+	ASSERT_EQ(cache.getCount(), 4);
+
+	ASSERT_TRUE(cache.remove(3ull));
+	ASSERT_FALSE(cache.has(3ull));
+	ASSERT_EQ(cache.getCount(), 3);
+
+	// Removed slot is reused without
+	// evicting
+	cache.insert(8ull, String{"eight"});
+
+	ASSERT_EQ(evicted.getCount(), 3);
+	ASSERT_EQ(*cache.peek(8ull), "eight");
+
+	uint64 numEntries = 0;
+	cache.forEach([&numEntries](const uint64 & key, const String & value) {
+
+		++numEntries;
+	});
+
+	ASSERT_EQ(numEntries, 4);
+
+	// Stress against many keys
+	ClockCache<uint64, uint64> big{1000};
+	for (uint64 i = 0; i < 10000; ++i)
+	{
+		big.insert(i, i * i);
+		if (i % 4 == 0) big.get(i / 2);
+	}
+
+	ASSERT_EQ(big.getCount(), 1000);
+
+	uint64 numFound = 0;
+	for (uint64 i = 0; i < 10000; ++i)
+	{
+		if (const uint64 * value = big.peek(i))
+		{
+			ASSERT_EQ(*value, i * i);
+			++numFound;
+		}
+	}
+
+	ASSERT_EQ(numFound, 1000);
+}
+
+TEST(containers, shardedCache)
+{
+	ShardedCache<LRUCache<uint64, uint64>, 8> cache{800};
+
+	ASSERT_EQ(cache.getNumShards(), 8);
+	ASSERT_EQ(cache.getCapacity(), 800);
+
+	for (uint64 i = 0; i < 100; ++i) cache.insert(i, i + 1);
+
+	ASSERT_EQ(cache.getCount(), 100);
+
+	uint64 value = 0;
+	ASSERT_TRUE(cache.get(10ull, value));
+	ASSERT_EQ(value, 11);
+	ASSERT_TRUE(cache.remove(10ull));
+	ASSERT_FALSE(cache.get(10ull, value));
+
+	Atomic<int32> numEvicted = 0;
+	cache.setEvictionCallback([&numEvicted](const uint64 & key, uint64 & value) {
+
+		++numEvicted;
+	});
+
+	// Hammer the cache from many threads
+	std::thread threads[4];
+	for (uint32 t = 0; t < 4; ++t)
+	{
+		threads[t] = std::thread{[&cache, t]() {
+
+			for (uint64 i = 0; i < 10000; ++i)
+			{
+				const uint64 key = (i * 7 + t) % 2000;
+				uint64 found = 0;
+				if (!cache.get(key, found)) cache.insert(key, key + 1);
+				else ASSERT_EQ(found, key + 1);
+			}
+		}};
+	}
+
+	for (uint32 t = 0; t < 4; ++t) threads[t].join();
+
+	ASSERT_LE(cache.getCount(), 800);
+	ASSERT_GT(numEvicted.load(), 0);
+
+	cache.empty();
+
+	ASSERT_EQ(cache.getCount(), 0);
+}
+
+TEST(containers, radixTree)
+{
+	RadixTree<int32> tree;
+
+	ASSERT_TRUE(tree.isEmpty());
+	ASSERT_EQ(tree.begin(), tree.end());
+	ASSERT_FALSE(tree.has("a"));
+
+	tree.insert("romane", 1);
+	tree.insert("romanus", 2);
+	tree.insert("romulus", 3);
+	tree.insert("rubens", 4);
+	tree.insert("ruber", 5);
+	tree.insert("rubicon", 6);
+	tree.insert("rubicundus", 7);
+	tree.insert("rom", 8);
+	tree.insert("", 9);
+
+	ASSERT_EQ(tree.getCount(), 9);
+
+	int32 value = 0;
+	ASSERT_TRUE(tree.find("romanus", value));
+	ASSERT_EQ(value, 2);
+	ASSERT_TRUE(tree.find("", value));
+	ASSERT_EQ(value, 9);
+	ASSERT_FALSE(tree.has("roman"));
+	ASSERT_FALSE(tree.has("romanusx"));
+	ASSERT_FALSE(tree.has("r"));
+
+	// Keys from String and Name
+	const String key = "rubicon";
+	constexpr Name name = "rubens";
+
+	ASSERT_EQ(tree.find(key)->getValue(), 6);
+	ASSERT_EQ(tree.find(name)->getValue(), 4);
+
+	// Update existing key
+	tree.insert(key, 60);
+
+	ASSERT_EQ(tree.getCount(), 9);
+	ASSERT_EQ(tree.find(key)->getValue(), 60);
+
+	// Ordered iteration
+	const char * sorted[] = {"", "rom", "romane", "romanus", "romulus", "rubens", "ruber", "rubicon", "rubicundus"};
+	uint32 idx = 0;
+	for (const auto & entry : tree) ASSERT_EQ(entry.getKey(), sorted[idx++]);
+
+	ASSERT_EQ(idx, 9);
+
+	idx = 0;
+	tree.forEach([&](const StringView & entryKey, const int32 & entryValue) {
+
+		ASSERT_EQ(entryKey, sorted[idx++]);
+	});
+
+	ASSERT_EQ(idx, 9);
+
+	// Prefix scans
+	idx = 0;
+	for (auto it = tree.begin("rom"), end = tree.end("rom"); it != end; ++it) ASSERT_EQ(it->getKey(), sorted[1 + idx++]);
+
+	ASSERT_EQ(idx, 4);
+
+	idx = 0;
+	tree.forEachPrefix("rubi", [&](const StringView & entryKey, const int32 & entryValue) {
+
+		ASSERT_EQ(entryKey, sorted[7 + idx++]);
+	});
+
+	ASSERT_EQ(idx, 2);
+	ASSERT_EQ(tree.begin("x"), tree.end("x"));
+	ASSERT_EQ(tree.begin("romb"), tree.end("romb"));
+
+	// Longest prefix match
+	ASSERT_EQ(tree.findLongestPrefix("romanesque")->getKey(), "romane");
+	ASSERT_EQ(tree.findLongestPrefix("roman")->getKey(), "rom");
+	ASSERT_EQ(tree.findLongestPrefix("rubicundusss")->getKey(), "rubicundus");
+	ASSERT_EQ(tree.findLongestPrefix("x")->getKey(), "");
+
+	// Remove
+	ASSERT_TRUE(tree.remove("rom"));
+	ASSERT_FALSE(tree.remove("rom"));
+	ASSERT_TRUE(tree.remove(""));
+	ASSERT_TRUE(tree.remove("romulus"));
+	ASSERT_EQ(tree.getCount(), 6);
+	ASSERT_FALSE(tree.has("rom"));
+	ASSERT_TRUE(tree.has("romane"));
+	ASSERT_TRUE(tree.has("romanus"));
+	ASSERT_EQ(tree.findLongestPrefix("x"), tree.end());
+
+	tree.empty();
+
+	ASSERT_TRUE(tree.isEmpty());
+	ASSERT_EQ(tree.begin(), tree.end());
+
+	// Many keys, grows and shrinks all
+	// node types and long prefixes
+	RadixTree<uint32, MallocAnsi> big;
+	for (uint32 i = 0; i < 2000; ++i)
+	{
+		String str = "key/with/a/long/shared/prefix/";
+		str += (int32)(i * 7919 % 2000);
+		if (i % 3 == 0) str += "/tail";
+
+		big.insert(str, i);
+	}
+
+	ASSERT_EQ(big.getCount(), 2000);
+
+	StringView prevKey;
+	uint64 numVisited = 0;
+	for (const auto & entry : big)
+	{
+		if (numVisited++) ASSERT_LT(prevKey, entry.getKey());
+		prevKey = entry.getKey();
+	}
+
+	ASSERT_EQ(numVisited, 2000);
+
+	for (uint32 i = 0; i < 2000; i += 2)
+	{
+		String str = "key/with/a/long/shared/prefix/";
+		str += (int32)(i * 7919 % 2000);
+		if (i % 3 == 0) str += "/tail";
+
+		ASSERT_TRUE(big.remove(str));
+		ASSERT_FALSE(big.has(str));
+	}
+
+	ASSERT_EQ(big.getCount(), 1000);
+	for (uint32 i = 1; i < 2000; i += 2)
+	{
+		String str = "key/with/a/long/shared/prefix/";
+		str += (int32)(i * 7919 % 2000);
+		if (i % 3 == 0) str += "/tail";
+
+		uint32 found = 0;
+		ASSERT_TRUE(big.find(str, found));
+		ASSERT_EQ(found, i);
+	}
+
+	numVisited = 0;
+	big.forEachPrefix("key/with/a/long/shared/prefix/1", [&numVisited](const StringView & entryKey, const uint32 & entryValue) {
+
+		ASSERT_TRUE(entryKey.startsWith("key/with/a/long/shared/prefix/1"));
+		++numVisited;
+	});
+
+	uint64 numScanned = 0;
+	for (auto it = big.begin("key/with/a/long/shared/prefix/1"); it != big.end("key/with/a/long/shared/prefix/1"); ++it) ++numScanned;
+
+	ASSERT_GT(numVisited, 0);
+	ASSERT_EQ(numVisited, numScanned);
+
+	// Binary keys, fill a Node256 and
+	// shrink it back to a leaf
+	RadixTree<uint32> wide;
+	ansichar bytes[2];
+	for (uint32 i = 0; i < 256; ++i)
+	{
+		bytes[0] = static_cast<ansichar>(i), bytes[1] = static_cast<ansichar>(i ^ 0x5a);
+		wide.insert(StringView{bytes, 2}, i);
+	}
+
+	ASSERT_EQ(wide.getCount(), 256);
+
+	uint32 prevByte = 0;
+	numVisited = 0;
+	for (const auto & entry : wide)
+	{
+		if (numVisited++) ASSERT_LT(prevByte, entry.getKey().getByte(0));
+		prevByte = entry.getKey().getByte(0);
+	}
+
+	ASSERT_EQ(numVisited, 256);
+
+	for (uint32 i = 0; i < 255; ++i)
+	{
+		bytes[0] = static_cast<ansichar>(i), bytes[1] = static_cast<ansichar>(i ^ 0x5a);
+		ASSERT_TRUE(wide.remove(StringView{bytes, 2}));
+
+		for (uint32 j = i + 1; j < 256; j += 17)
+		{
+			bytes[0] = static_cast<ansichar>(j), bytes[1] = static_cast<ansichar>(j ^ 0x5a);
+			ASSERT_EQ(wide.find(StringView{bytes, 2})->getValue(), j);
+		}
+	}
+
+	ASSERT_EQ(wide.getCount(), 1);
+	ASSERT_EQ(wide.begin()->getValue(), 255);
+}
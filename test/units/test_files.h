@@ -0,0 +1,240 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "hal/file.h"
+
+/**
+ * Returns the i-th byte of the data
+ * written in tests.
+ */
+static FORCE_INLINE ubyte getFileTestByte(uint64 i)
+{
+	return static_cast<ubyte>(i * 31 + (i >> 8));
+}
+
+TEST(files, buffered)
+{
+	const ansichar * path = "korin_test_file.bin";
+	const uint64 size = 10000;
+
+	Array<ubyte> data;
+	for (uint64 i = 0; i < size; ++i) data.add(getFileTestByte(i));
+
+	// Small buffer, so that writes both fill
+	// and skip the buffer
+	{
+		File file{path, FileOpenMode::Write, 64};
+		ASSERT_TRUE(file.isOpen());
+
+		uint64 pos = 0;
+		for (uint64 chunk = 1; pos < size; chunk = chunk * 3 % 200 + 1)
+		{
+			const uint64 n = PlatformMath::min(chunk, size - pos);
+			ASSERT_EQ(file.write(*data + pos, n), n);
+
+			pos += n;
+			ASSERT_EQ(file.tell(), pos);
+		}
+
+		ASSERT_EQ(file.getSize(), size);
+		ASSERT_TRUE(file.close());
+	}
+
+	{
+		File file{path, FileOpenMode::Read, 64};
+		ASSERT_TRUE(file.isOpen());
+		ASSERT_EQ(file.getSize(), size);
+
+		Array<ubyte> out{size};
+		out.resize(size);
+
+		uint64 pos = 0;
+		for (uint64 chunk = 1; pos < size; chunk = chunk * 7 % 150 + 1)
+		{
+			const uint64 n = PlatformMath::min(chunk, size - pos);
+			ASSERT_EQ(file.read(*out + pos, n), n);
+
+			pos += n;
+			ASSERT_EQ(file.tell(), pos);
+		}
+
+		ASSERT_EQ(Memory::memcmp(*out, *data, size), 0);
+
+		// Reads past the end are short
+		ubyte tmp[16];
+		ASSERT_EQ(file.read(tmp, 16), 0);
+		ASSERT_FALSE(file.hasError());
+
+		// Seek inside and outside the buffer
+		ASSERT_TRUE(file.seek(size - 10));
+		ASSERT_EQ(file.read(tmp, 16), 10);
+		ASSERT_EQ(tmp[0], getFileTestByte(size - 10));
+
+		ASSERT_TRUE(file.seek(1234));
+		ASSERT_EQ(file.read(tmp, 4), 4);
+		ASSERT_EQ(tmp[3], getFileTestByte(1237));
+		ASSERT_TRUE(file.seek(1230));
+		ASSERT_EQ(file.read(tmp, 1), 1);
+		ASSERT_EQ(tmp[0], getFileTestByte(1230));
+
+		// Positional reads don't move the file
+		ASSERT_EQ(file.readAt(tmp, 8, 5000), 8);
+		ASSERT_EQ(tmp[0], getFileTestByte(5000));
+		ASSERT_EQ(file.tell(), 1231);
+	}
+
+	// Views into the buffer
+	{
+		File file{path, FileOpenMode::Read, 256};
+		file.setAccessHint(FileAccessHint::Sequential);
+
+		StringView view;
+		uint64 pos = 0;
+		while (file.readInto(view, 100))
+		{
+			ASSERT_LE(view.getLength(), 100);
+			for (uint64 i = 0; i < view.getLength(); ++i) ASSERT_EQ(static_cast<ubyte>(view[i]), getFileTestByte(pos + i));
+			pos += view.getLength();
+		}
+
+		ASSERT_EQ(pos, size);
+		ASSERT_TRUE(view.isEmpty());
+	}
+
+	// Read whole file
+	{
+		File file{path};
+		ASSERT_TRUE(file.seek(16));
+
+		Array<ubyte> out;
+		out.add(ubyte{0xff});
+		ASSERT_EQ(file.readAll(out), size - 16);
+		ASSERT_EQ(out.getCount(), size - 15);
+		ASSERT_EQ(out[0], 0xff);
+		ASSERT_EQ(Memory::memcmp(*out + 1, *data + 16, size - 16), 0);
+	}
+
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+	ASSERT_FALSE(File{path}.isOpen());
+}
+
+TEST(files, text)
+{
+	const ansichar * path = "korin_test_file.txt";
+
+	{
+		File file{path, FileOpenMode::Write};
+		file.write("hello ");
+		file.write(StringView{"world"});
+	}
+
+	{
+		File file{path, FileOpenMode::Append};
+		ASSERT_EQ(file.tell(), 11);
+		file.write("!\n");
+	}
+
+	{
+		File file{path};
+		String text = "> ";
+		ASSERT_EQ(file.readAll(text), 13);
+		ASSERT_EQ(text, "> hello world!\n");
+		ASSERT_EQ(text.getLength(), 15);
+	}
+
+	// Mixed reads and writes
+	{
+		File file{path, FileOpenMode::ReadWrite, 4};
+
+		ansichar tmp[8] = {};
+		ASSERT_EQ(file.read(tmp, 5), 5);
+		ASSERT_EQ(StringView(tmp, 5), "hello");
+
+		file.write("_");
+		ASSERT_EQ(file.tell(), 6);
+		ASSERT_EQ(file.read(tmp, 5), 5);
+		ASSERT_EQ(StringView(tmp, 5), "world");
+
+		ASSERT_EQ(file.writeAt("W", 1, 6), 1);
+		ASSERT_TRUE(file.seek(0));
+
+		String text;
+		file.readAll(text);
+		ASSERT_EQ(text, "hello_World!\n");
+	}
+
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+}
+
+TEST(files, async)
+{
+	const ansichar * path = "korin_test_file_async.bin";
+	const uint64 blockSize = 4096, numBlocks = 100;
+
+	for (bool useIoUring : {true, false})
+	{
+		AsyncFileIO io{8, useIoUring};
+		if (!useIoUring) ASSERT_FALSE(io.isUsingIoUring());
+
+		Array<ubyte> data;
+		for (uint64 i = 0; i < numBlocks * blockSize; ++i) data.add(getFileTestByte(i));
+
+		// Write blocks in random order
+		{
+			File file{path, FileOpenMode::Write};
+			file.write(*data, 10);
+
+			Array<FileIORequest> requests;
+			for (uint64 i = 0; i < numBlocks; ++i)
+			{
+				const uint64 block = i * 37 % numBlocks;
+
+				FileIORequest request;
+				request.data = *data + block * blockSize;
+				request.size = blockSize;
+				request.offset = block * blockSize;
+				requests.add(request);
+			}
+
+			ASSERT_TRUE(io.write(file, *requests, requests.getCount()));
+			for (const FileIORequest & request : requests) ASSERT_EQ(request.result, blockSize);
+		}
+
+		// Read them back, plus a read past
+		// the end
+		{
+			File file{path};
+			ASSERT_EQ(file.getSize(), numBlocks * blockSize);
+
+			Array<ubyte> out{numBlocks * blockSize + blockSize};
+			out.resize(numBlocks * blockSize + blockSize);
+
+			Array<FileIORequest> requests;
+			for (uint64 i = 0; i <= numBlocks; ++i)
+			{
+				const uint64 block = i * 13 % (numBlocks + 1);
+
+				FileIORequest request;
+				request.data = *out + block * blockSize;
+				request.size = block == numBlocks ? blockSize : blockSize - 100;
+				request.offset = block == numBlocks ? numBlocks * blockSize - 50 : block * blockSize;
+				requests.add(request);
+			}
+
+			ASSERT_TRUE(io.read(file, *requests, requests.getCount()));
+			for (const FileIORequest & request : requests) ASSERT_EQ(request.result, request.offset + blockSize > numBlocks * blockSize ? 50 : blockSize - 100);
+
+			for (uint64 block = 0; block < numBlocks; ++block)
+			{
+				ASSERT_EQ(Memory::memcmp(*out + block * blockSize, *data + block * blockSize, blockSize - 100), 0);
+			}
+
+			ASSERT_EQ(Memory::memcmp(*out + numBlocks * blockSize, *data + numBlocks * blockSize - 50, 50), 0);
+		}
+	}
+
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+}
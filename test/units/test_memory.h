@@ -6,7 +6,10 @@
 #include "hal/malloc_ansi.h"
 #include "hal/malloc_pool.h"
 #include "hal/malloc_binned.h"
+#include "hal/malloc_arena.h"
 #include "hal/malloc_object.h"
+#include "hal/malloc_tracer.h"
+#include "hal/file.h"
 
 TEST(memory, malloc_ansi)
 {
@@ -138,6 +141,72 @@ TEST(memory, malloc_binned)
 	SUCCEED();
 }
 
+TEST(memory, malloc_arena)
+{
+	MallocArena arena{256};
+
+	// Small allocations are aligned and
+	// don't overlap
+	ubyte * a = static_cast<ubyte*>(arena.alloc(3, 1));
+	ubyte * b = static_cast<ubyte*>(arena.alloc(16, 16));
+	Memory::memset(a, 0xaa, 3);
+	Memory::memset(b, 0xbb, 16);
+
+	ASSERT_EQ(reinterpret_cast<uintp>(b) & 15, 0x0);
+	ASSERT_TRUE(b >= a + 3);
+	ASSERT_EQ(a[2], 0xaa);
+	ASSERT_EQ(arena.getNumBytes(), 19);
+
+	// Last allocation grows in place
+	ubyte * c = static_cast<ubyte*>(arena.realloc(b, 32, 16));
+	ASSERT_EQ(c, b);
+	ASSERT_EQ(c[15], 0xbb);
+
+	// Other allocations are copied
+	ubyte * d = static_cast<ubyte*>(arena.realloc(a, 8, 1));
+	ASSERT_NE(d, a);
+	ASSERT_EQ(d[0], 0xaa);
+	ASSERT_EQ(d[2], 0xaa);
+
+	// Large allocations get their own block
+	ubyte * e = static_cast<ubyte*>(arena.alloc(4096));
+	Memory::memset(e, 0xee, 4096);
+	ASSERT_EQ(b[0], 0xbb);
+
+	for (uint32 i = 0; i < 1000; ++i) *static_cast<uint32*>(arena.alloc(sizeof(uint32), alignof(uint32))) = i;
+	ASSERT_EQ(e[4095], 0xee);
+
+	// Other arena memory stays valid
+	MallocArena other;
+	uint64 * f = static_cast<uint64*>(other.alloc(sizeof(uint64)));
+	*f = 42;
+
+	const sizet numBytes = arena.getNumBytes();
+	arena.absorb(other);
+	ASSERT_EQ(other.getNumBytes(), 0);
+	ASSERT_EQ(arena.getNumBytes(), numBytes + sizeof(uint64));
+	ASSERT_EQ(*f, 42);
+
+	arena.reset();
+	ASSERT_EQ(arena.getNumBytes(), 0);
+	ASSERT_NE(arena.alloc(64), nullptr);
+
+	// Can be installed as gMalloc, blocks
+	// come from the backing allocator
+	MallocArena global{256};
+	MallocBase * prev = gMalloc;
+	gMalloc = &global;
+
+	{
+		Array<uint32> items;
+		for (uint32 i = 0; i < 1000; ++i) items.add(i);
+		ASSERT_EQ(items[999], 999);
+	}
+
+	gMalloc = prev;
+	ASSERT_GE(global.getNumBytes(), 1000 * sizeof(uint32));
+}
+
 TEST(memory, malloc_object)
 {
 	struct Foo
@@ -165,4 +234,167 @@ TEST(memory, malloc_object)
 	delete innerMalloc;
 
 	SUCCEED();
-}
\ No newline at end of file
+}
+
+TEST(memory, malloc_tracer)
+{
+	const ansichar * path = "korin_test_malloc.trace";
+	MallocAnsi ansi;
+	void * foreign = ansi.alloc(16);
+	void * live = nullptr;
+
+	{
+		File file{path, FileOpenMode::Write};
+		MallocTracer tracer{&ansi, file};
+
+		void * a = tracer.alloc(100);
+		void * b = tracer.alloc(2000, 64);
+		a = tracer.realloc(a, 300);
+		tracer.free(b);
+		void * c = tracer.realloc(nullptr, 50);
+		live = tracer.alloc(10);
+		tracer.free(a);
+		tracer.free(nullptr);
+
+		// Allocated before tracing
+		foreign = tracer.realloc(foreign, 32);
+		tracer.free(foreign);
+
+		tracer.free(c);
+		ASSERT_EQ(tracer.getNumRecords(), 11);
+	}
+
+	// Not freed in the trace
+	ansi.free(live);
+
+	MallocTrace trace;
+	{
+		File file{path};
+		ASSERT_TRUE(trace.load(file));
+	}
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+
+	const Array<MallocTraceOp> & ops = trace.getOps();
+	ASSERT_EQ(ops.getCount(), 10);
+	ASSERT_EQ(ops[0].type, MallocTracer::Alloc);
+	ASSERT_EQ(ops[0].size, 100);
+	ASSERT_EQ(ops[1].alignmentLog2, 6);
+	ASSERT_EQ(ops[2].type, MallocTracer::Realloc);
+	ASSERT_EQ(ops[2].slot, ops[0].slot);
+	ASSERT_EQ(ops[3].type, MallocTracer::Free);
+	ASSERT_EQ(ops[3].slot, ops[1].slot);
+
+	// Freed slots are reused
+	ASSERT_EQ(ops[4].type, MallocTracer::Alloc);
+	ASSERT_EQ(ops[4].slot, ops[1].slot);
+	ASSERT_EQ(ops[7].type, MallocTracer::Alloc);
+	ASSERT_EQ(ops[7].size, 32);
+
+	ASSERT_EQ(trace.getNumSlots(), 3);
+	ASSERT_EQ(trace.getPeakBytes(), 2300);
+	ASSERT_EQ(trace.getMaxSize(), 2000);
+
+	// Invalid traces
+	const ubyte bad[] = {'K', 'M', 'T', 'X', 1};
+	ASSERT_FALSE(trace.load(bad, sizeof(bad)));
+	const ubyte truncated[] = {'K', 'M', 'T', 'R', 1, MallocTracer::Alloc, 0x80};
+	ASSERT_FALSE(trace.load(truncated, sizeof(truncated)));
+	const ubyte empty[] = {'K', 'M', 'T', 'R', 1};
+	ASSERT_TRUE(trace.load(empty, sizeof(empty)));
+	ASSERT_EQ(trace.getOps().getCount(), 0);
+}
+
+TEST(memory, malloc_replay)
+{
+	// Record a trace of random requests
+	const ansichar * path = "korin_test_malloc_replay.trace";
+	MallocAnsi ansi;
+	uint64 numLive = 0, liveBytes = 0;
+
+	{
+		File file{path, FileOpenMode::Write};
+		MallocTracer tracer{&ansi, file};
+
+		void * blocks[256] = {};
+		sizet sizes[256] = {};
+		uint64 seed = 1;
+
+		for (uint32 i = 0; i < 10000; ++i)
+		{
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			const uint32 r = seed >> 33;
+			const uint32 idx = r % 256;
+			const sizet size = 1 + (r >> 8) % 4000;
+
+			if (!blocks[idx]) blocks[idx] = tracer.alloc(sizes[idx] = size);
+			else if (r & 0x10000) blocks[idx] = tracer.realloc(blocks[idx], sizes[idx] = size);
+			else
+			{
+				tracer.free(blocks[idx]);
+				blocks[idx] = nullptr;
+			}
+		}
+
+		for (uint32 idx = 0; idx < 256; ++idx)
+		{
+			if (blocks[idx])
+			{
+				++numLive;
+				liveBytes += sizes[idx];
+				if (idx % 2) tracer.free(blocks[idx]);
+				else ansi.free(blocks[idx]);
+			}
+		}
+	}
+
+	MallocTrace trace;
+	{
+		File file{path};
+		ASSERT_TRUE(trace.load(file));
+	}
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+	ASSERT_LE(trace.getNumSlots(), 256);
+	ASSERT_LE(trace.getMaxSize(), 4000);
+
+	// Replay all at once and in steps
+	MallocAnsi replayAnsi;
+	MallocBinned binned;
+	MallocBase * allocators[] = {&replayAnsi, &binned};
+
+	for (MallocBase * malloc : allocators)
+	{
+		MallocReplay replay{trace, *malloc};
+		ASSERT_FALSE(replay.isDone());
+		ASSERT_EQ(replay.run(), trace.getOps().getCount());
+		ASSERT_TRUE(replay.isDone());
+		ASSERT_EQ(replay.getNumFailed(), 0);
+		ASSERT_LT(replay.getLiveBytes(), liveBytes);
+		ASSERT_GT(replay.getLiveBytes(), 0);
+	}
+
+	MallocReplay replay{trace, binned};
+	uint64 numOps = 0;
+	while (!replay.isDone()) numOps += replay.run(100);
+	ASSERT_EQ(numOps, trace.getOps().getCount());
+	ASSERT_EQ(replay.getNumFailed(), 0);
+}
+
+TEST(memory, malloc_binned_realloc)
+{
+	MallocBinned malloc;
+
+	ubyte * a = static_cast<ubyte*>(malloc.realloc(nullptr, 6));
+	ASSERT_NE(a, nullptr);
+	Memory::memset(a, 0xaa, 6);
+
+	// Same bucket, same block
+	ASSERT_EQ(malloc.realloc(a, 8), a);
+
+	// Larger bucket, data is moved
+	ubyte * b = static_cast<ubyte*>(malloc.realloc(a, 1000));
+	ASSERT_NE(b, a);
+	ASSERT_EQ(b[0], 0xaa);
+	ASSERT_EQ(b[5], 0xaa);
+
+	ASSERT_EQ(malloc.realloc(b, 0), nullptr);
+}
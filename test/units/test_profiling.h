@@ -0,0 +1,199 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <stdlib.h>
+
+#include "containers/string.h"
+#include "containers/map.h"
+#include "profiling/trace.h"
+#include "profiling/perf_counters.h"
+#include "serialization/json_reader.h"
+#include "serialization/json_writer.h"
+
+TEST(profiling, histogram)
+{
+	// Buckets cover all durations without
+	// gaps
+	for (uint32 idx = 0; idx + 1 < TraceHistogram::numBuckets; ++idx)
+	{
+		ASSERT_EQ(TraceHistogram::getBucketIdx(TraceHistogram::getBucketMin(idx)), idx);
+		ASSERT_EQ(TraceHistogram::getBucketIdx(TraceHistogram::getBucketMin(idx + 1) - 1), idx);
+	}
+	ASSERT_EQ(TraceHistogram::getBucketIdx(~0ull), TraceHistogram::numBuckets - 1);
+
+	TraceHistogram histogram;
+	ASSERT_EQ(histogram.getPercentile(0.5), 0);
+	ASSERT_EQ(histogram.getMin(), 0);
+
+	for (uint64 ns = 1; ns <= 10000; ++ns) histogram.add(ns);
+	ASSERT_EQ(histogram.getCount(), 10000);
+	ASSERT_EQ(histogram.getTotal(), 10000ull * 10001 / 2);
+	ASSERT_EQ(histogram.getMin(), 1);
+	ASSERT_EQ(histogram.getMax(), 10000);
+	ASSERT_DOUBLE_EQ(histogram.getMean(), 5000.5);
+
+	for (float64 p : {0.1, 0.5, 0.9, 0.99})
+	{
+		const float64 estimate = histogram.getPercentile(p);
+		ASSERT_NEAR(estimate, p * 10000, p * 10000 * 0.125);
+	}
+	ASSERT_EQ(histogram.getPercentile(1.0), 10000);
+
+	TraceHistogram other;
+	other.add(1ull << 40);
+	histogram.merge(other);
+	ASSERT_EQ(histogram.getCount(), 10001);
+	ASSERT_EQ(histogram.getMax(), 1ull << 40);
+}
+
+TEST(profiling, trace)
+{
+	Trace::reset();
+	ASSERT_EQ(Trace::getNumEvents(), 0);
+	ASSERT_GT(Trace::getTicksPerSecond(), 0.0);
+
+	Trace::setThreadName("main");
+	{
+		ScopedTimer outer{"outer"};
+		for (uint32 i = 0; i < 10; ++i) ScopedTimer inner{"inner"};
+	}
+	ASSERT_EQ(Trace::getNumEvents(), 11);
+
+	// More events than fit in a chunk,
+	// recorded by other threads
+	std::thread threads[2];
+	for (std::thread & thread : threads) thread = std::thread{[]() {
+
+		Trace::setThreadName("worker");
+		for (uint32 i = 0; i < TraceBuffer::chunkSize + 100; ++i) ScopedTimer timer{"worker"};
+	}};
+	for (std::thread & thread : threads) thread.join();
+	ASSERT_EQ(Trace::getNumEvents(), 11 + 2 * (TraceBuffer::chunkSize + 100));
+	ASSERT_EQ(Trace::getNumDropped(), 0);
+
+	// Disabled at runtime
+	Trace::setEnabled(false);
+	{ ScopedTimer timer{"disabled"}; }
+	Trace::setEnabled(true);
+	ASSERT_EQ(Trace::getNumEvents(), 11 + 2 * (TraceBuffer::chunkSize + 100));
+
+	Map<String, TraceHistogram> stats;
+	Trace::collect(stats);
+	ASSERT_EQ(stats.getCount(), 3);
+	ASSERT_EQ(stats["outer"].getCount(), 1);
+	ASSERT_EQ(stats["inner"].getCount(), 10);
+	ASSERT_EQ(stats["worker"].getCount(), 2 * (TraceBuffer::chunkSize + 100));
+	ASSERT_GE(stats["outer"].getTotal(), stats["inner"].getTotal());
+
+	// Macro is removed unless enabled
+	{ SCOPED_TIMER("macro"); }
+	ASSERT_EQ(Trace::getNumEvents(), 12 + 2 * (TraceBuffer::chunkSize + 100) - !BUILD_TRACE);
+
+	Trace::reset();
+	ASSERT_EQ(Trace::getNumEvents(), 0);
+}
+
+TEST(profiling, chrome_trace)
+{
+	Trace::reset();
+	Trace::setThreadName("main");
+	{
+		ScopedTimer outer{"outer"};
+		ScopedTimer inner{"inner \"quoted\""};
+	}
+
+	String text;
+	Trace::exportChromeTrace(text);
+
+	JsonReader reader;
+	ASSERT_TRUE(reader.parse(text));
+
+	const JsonValue root = reader.getRoot();
+	ASSERT_TRUE(root["displayTimeUnit"].equals("ns"));
+
+	const JsonValue events = root["traceEvents"];
+	ASSERT_EQ(events.getType(), JsonType::Array);
+
+	uint32 numScopes = 0, numThreadNames = 0;
+	float64 outerBegin = -1.0, outerEnd = -1.0, innerBegin = -1.0, innerEnd = -1.0;
+	for (const JsonValue & event : events.getItems())
+	{
+		if (event["ph"].equals("M"))
+		{
+			// Other tests may have named other
+			// threads
+			ASSERT_TRUE(event["name"].equals("thread_name"));
+			++numThreadNames;
+			continue;
+		}
+
+		ASSERT_TRUE(event["ph"].equals("X"));
+		ASSERT_EQ(event["pid"].getOr(0), 1);
+		ASSERT_GT(event["tid"].getOr(0), 0);
+
+		const float64 ts = event["ts"].getOr(-1.0);
+		const float64 dur = event["dur"].getOr(-1.0);
+		ASSERT_GE(ts, 0.0);
+		ASSERT_GE(dur, 0.0);
+
+		String name;
+		ASSERT_TRUE(event["name"].get(name));
+		if (name == "outer") outerBegin = ts, outerEnd = ts + dur;
+		else if (name == "inner \"quoted\"") innerBegin = ts, innerEnd = ts + dur;
+
+		++numScopes;
+	}
+
+	ASSERT_EQ(numScopes, 2);
+	ASSERT_GE(numThreadNames, 1);
+	ASSERT_EQ(outerBegin, 0.0);
+	ASSERT_LE(outerBegin, innerBegin);
+	ASSERT_LE(innerEnd, outerEnd + 1e-3);
+
+	Trace::reset();
+}
+
+TEST(profiling, perf_counters)
+{
+	for (uint32 idx = 0; idx < PerfCounters::numEvents; ++idx)
+		ASSERT_STRNE(PerfCounters::getName(static_cast<PerfEvent>(idx)), "unknown");
+
+	PerfCounters counters;
+	for (uint32 idx = 0; idx < PerfCounters::numEvents; ++idx)
+		ASSERT_EQ(counters.get(static_cast<PerfEvent>(idx)), 0);
+
+	// Touch fresh pages and run a loop
+	// that can't be folded
+	constexpr sizet size = 1 << 22;
+	counters.start();
+
+	ubyte * pages = static_cast<ubyte*>(::malloc(size));
+	for (sizet i = 0; i < size; i += 4096) pages[i] = static_cast<ubyte>(i);
+
+	volatile uint64 sum = 0;
+	for (uint64 i = 0; i < 1000000; ++i) sum = sum + i;
+
+	counters.stop();
+	::free(pages);
+
+	if (!counters.isAnyAvailable())
+	{
+		// Not supported on this platform,
+		// or forbidden by the kernel
+		ASSERT_EQ(counters.getIpc(), 0.0);
+		return;
+	}
+
+	if (counters.isAvailable(PerfEvent::Instructions)) ASSERT_GT(counters.get(PerfEvent::Instructions), 1000000);
+	if (counters.isAvailable(PerfEvent::Cycles)) ASSERT_GT(counters.get(PerfEvent::Cycles), 0);
+	if (counters.isAvailable(PerfEvent::Cycles) && counters.isAvailable(PerfEvent::Instructions)) ASSERT_GT(counters.getIpc(), 0.0);
+	if (counters.isAvailable(PerfEvent::TaskClock)) ASSERT_GT(counters.get(PerfEvent::TaskClock), 0);
+	if (counters.isAvailable(PerfEvent::PageFaults)) ASSERT_GT(counters.get(PerfEvent::PageFaults), 0);
+
+	// Values are reset on start
+	counters.start();
+	counters.stop();
+	if (counters.isAvailable(PerfEvent::PageFaults)) ASSERT_LT(counters.get(PerfEvent::PageFaults), 16);
+}
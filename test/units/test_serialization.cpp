@@ -0,0 +1,7 @@
+#include "test_serialization.h"
+
+int main(int argc, char ** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,1015 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+
+#include "containers/array.h"
+#include "containers/string.h"
+#include "containers/set.h"
+#include "containers/map.h"
+#include "serialization/archive.h"
+#include "serialization/memory_archive.h"
+#include "serialization/container_serialization.h"
+#include "serialization/mapped_image.h"
+#include "serialization/char_finder.h"
+#include "serialization/record_reader.h"
+#include "serialization/number_parser.h"
+#include "serialization/csv_reader.h"
+#include "serialization/json_reader.h"
+#include "serialization/json_writer.h"
+#include "regex/regex.h"
+
+/**
+ * A type with a custom serialize function,
+ * that added a field in version 2.
+ */
+struct SerializedRecord
+{
+	uint32 id = 0;
+	String name;
+	Array<float32> weights;
+	uint64 flags = 0;
+
+	void serialize(Archive & ar)
+	{
+		ar << id << name << weights;
+		if (ar.getVersion() >= 2) ar << flags;
+	}
+};
+
+/**
+ * Checks the red-black properties of a
+ * subtree and returns its black height,
+ * or -1 if invalid.
+ */
+template<typename NodeT>
+static int32 checkSerializedTree(const NodeT * node, const NodeT * parent = nullptr)
+{
+	if (!node) return 1;
+	if (node->parent != parent) return -1;
+	if (NodeT::isRed(node) && NodeT::isRed(parent)) return -1;
+
+	const int32 left = checkSerializedTree(node->left, node);
+	const int32 right = checkSerializedTree(node->right, node);
+	if (left < 0 || left != right) return -1;
+
+	return left + NodeT::isBlack(node);
+}
+
+/**
+ * Root object of the mapped image used
+ * in tests.
+ */
+struct MappedTestRoot
+{
+	uint32 tag;
+	MappedArray<uint64> numbers;
+	MappedArray<MappedString> words;
+	MappedStringTable table;
+	MappedFlatMap<MappedString, uint64> index;
+	MappedFlatMap<uint64, uint64> squares;
+};
+
+/**
+ * Checks the content of the mapped image
+ * used in tests.
+ */
+static void checkMappedTestRoot(const MappedTestRoot * root)
+{
+	ASSERT_NE(root, nullptr);
+	ASSERT_EQ(root->tag, 0xabcd);
+
+	ASSERT_EQ(root->numbers.getCount(), 1000);
+	for (uint64 i = 0; i < 1000; ++i) ASSERT_EQ(root->numbers[i], i * 2);
+	ASSERT_EQ(root->numbers.findSorted(uint64{500}), 250);
+	ASSERT_EQ(root->numbers.findSorted(uint64{501}), -1);
+	ASSERT_EQ(root->numbers.findLowerBound(uint64{501}), 251);
+
+	ASSERT_EQ(root->words.getCount(), 3);
+	ASSERT_EQ(root->words[0], "foo");
+	ASSERT_EQ(root->words[1].getLength(), 0);
+	ASSERT_EQ(root->words[2], "a longer string");
+
+	ASSERT_EQ(root->table.getCount(), 4);
+	ASSERT_EQ(root->table[0], "apple");
+	ASSERT_EQ(root->table[1], "banana");
+	ASSERT_EQ(root->table[3], "date");
+	ASSERT_EQ(root->table.findSorted("cherry"), 2);
+	ASSERT_EQ(root->table.findSorted("coconut"), -1);
+
+	ASSERT_EQ(root->index.getCount(), 100);
+	for (uint64 i = 0; i < 100; ++i)
+	{
+		String key = "key_";
+		key += i;
+
+		uint64 value = 0;
+		ASSERT_TRUE(root->index.find(StringView{key}, value));
+		ASSERT_EQ(value, i);
+	}
+
+	ASSERT_FALSE(root->index.has(StringView{"key_100"}));
+	ASSERT_EQ(root->index.find(StringView{"key"}), nullptr);
+
+	ASSERT_EQ(root->squares.getCount(), 256);
+	ASSERT_EQ(*root->squares.find(uint64{17}), 289);
+	ASSERT_FALSE(root->squares.has(uint64{256}));
+
+	// Keys are sorted
+	for (uint64 i = 0; i < 256; ++i) ASSERT_EQ(root->squares.getKeys()[i], i);
+}
+
+TEST(serialization, archive)
+{
+	Array<ubyte> bytes;
+
+	{
+		MemoryWriter writer{bytes};
+		ASSERT_TRUE(writer.isSaving());
+		ASSERT_TRUE(writer.serializeHeader(3));
+
+		uint32 a = 42;
+		float64 b = 3.5;
+		writer << a << b << static_cast<int16>(-7) << true;
+		ASSERT_FALSE(writer.hasError());
+	}
+
+	ASSERT_EQ(bytes.getCount(), 8 + 4 + 8 + 2 + 1);
+
+	{
+		MemoryReader reader{bytes};
+		ASSERT_TRUE(reader.isLoading());
+		ASSERT_TRUE(reader.serializeHeader(3));
+		ASSERT_EQ(reader.getVersion(), 3);
+
+		uint32 a = 0;
+		float64 b = 0.0;
+		int16 c = 0;
+		bool d = false;
+		reader << a << b << c << d;
+
+		ASSERT_FALSE(reader.hasError());
+		ASSERT_EQ(a, 42);
+		ASSERT_EQ(b, 3.5);
+		ASSERT_EQ(c, -7);
+		ASSERT_TRUE(d);
+		ASSERT_EQ(reader.getRemainingBytes(), 0);
+
+		// Reading past the end fails
+		reader << a;
+		ASSERT_TRUE(reader.hasError());
+		ASSERT_EQ(a, 0);
+	}
+
+	// Newer versions are rejected
+	{
+		MemoryReader reader{bytes};
+		ASSERT_FALSE(reader.serializeHeader(2));
+		ASSERT_TRUE(reader.hasError());
+	}
+
+	// Wrong magic number
+	{
+		bytes[0] ^= 0xff;
+		MemoryReader reader{bytes};
+		ASSERT_FALSE(reader.serializeHeader(3));
+	}
+}
+
+TEST(serialization, containers)
+{
+	Array<uint64> numbers;
+	for (uint64 i = 0; i < 1000; ++i) numbers.add(i * i);
+
+	Array<String> words;
+	words.add("foo");
+	words.add("");
+	words.add("a longer string");
+
+	SerializedRecord record;
+	record.id = 7;
+	record.name = "record";
+	record.weights.add(0.5f);
+	record.weights.add(1.5f);
+	record.flags = 0xff;
+
+	Array<ubyte> bytes;
+	{
+		MemoryWriter writer{bytes};
+		writer.serializeHeader(2);
+		writer << numbers << words << record;
+	}
+
+	// Numbers are copied in bulk
+	ASSERT_EQ(bytes.getCount() - 8, 8 + 1000 * 8 + 8 + (8 + 3) + 8 + (8 + 15) + 4 + 8 + 6 + 8 + 8 + 8);
+
+	{
+		MemoryReader reader{bytes};
+		ASSERT_TRUE(reader.serializeHeader(2));
+
+		Array<uint64> outNumbers;
+		outNumbers.add(5ull);
+		Array<String> outWords;
+		SerializedRecord outRecord;
+		reader << outNumbers << outWords << outRecord;
+
+		ASSERT_FALSE(reader.hasError());
+		ASSERT_EQ(reader.getRemainingBytes(), 0);
+
+		ASSERT_EQ(outNumbers.getCount(), 1000);
+		for (uint64 i = 0; i < 1000; ++i) ASSERT_EQ(outNumbers[i], i * i);
+
+		ASSERT_EQ(outWords.getCount(), 3);
+		ASSERT_EQ(outWords[0], "foo");
+		ASSERT_EQ(outWords[1], "");
+		ASSERT_EQ(outWords[2], "a longer string");
+		ASSERT_EQ(outWords[2].getLength(), 15);
+
+		ASSERT_EQ(outRecord.id, 7);
+		ASSERT_EQ(outRecord.name, "record");
+		ASSERT_EQ(outRecord.weights.getCount(), 2);
+		ASSERT_EQ(outRecord.weights[1], 1.5f);
+		ASSERT_EQ(outRecord.flags, 0xff);
+	}
+
+	// Version 1 data has no flags
+	bytes.empty();
+	{
+		MemoryWriter writer{bytes};
+		writer.serializeHeader(1);
+		writer << record;
+	}
+
+	{
+		MemoryReader reader{bytes};
+		ASSERT_TRUE(reader.serializeHeader(2));
+		ASSERT_EQ(reader.getVersion(), 1);
+
+		SerializedRecord outRecord;
+		reader << outRecord;
+		ASSERT_FALSE(reader.hasError());
+		ASSERT_EQ(outRecord.name, "record");
+		ASSERT_EQ(outRecord.flags, 0);
+	}
+
+	// Truncated data
+	{
+		MemoryReader reader{*bytes, bytes.getCount() - 3};
+		reader.serializeHeader(2);
+
+		SerializedRecord outRecord;
+		reader << outRecord;
+		ASSERT_TRUE(reader.hasError());
+	}
+
+	// Counts larger than the data are
+	// rejected before allocating
+	{
+		Array<ubyte> badBytes;
+		MemoryWriter writer{badBytes};
+		writer << static_cast<uint64>(1ull << 60);
+
+		MemoryReader reader{badBytes};
+		Array<uint64> outNumbers;
+		reader << outNumbers;
+		ASSERT_TRUE(reader.hasError());
+		ASSERT_EQ(outNumbers.getCount(), 0);
+	}
+}
+
+TEST(serialization, trees)
+{
+	for (uint32 n : {0u, 1u, 2u, 3u, 7u, 8u, 100u, 1023u, 1024u, 5000u})
+	{
+		Set<uint32> set;
+		Map<String, uint64> map;
+		for (uint32 i = 0; i < n; ++i)
+		{
+			set.set(i * 3);
+
+			String key = "key_";
+			key += i;
+			map.insert(key, i);
+		}
+
+		Array<ubyte> bytes;
+		{
+			MemoryWriter writer{bytes};
+			writer << set << map;
+		}
+
+		Set<uint32> outSet;
+		outSet.set(1u);
+		Map<String, uint64> outMap;
+		{
+			MemoryReader reader{bytes};
+			reader << outSet << outMap;
+			ASSERT_FALSE(reader.hasError());
+		}
+
+		// Trees are valid red-black trees
+		ASSERT_EQ(outSet.getCount(), n);
+		ASSERT_EQ(outMap.getCount(), n);
+		ASSERT_GT(checkSerializedTree(outSet.getTree().getRoot()), 0);
+		ASSERT_GT(checkSerializedTree(outMap.getTree().getRoot()), 0);
+		if (n > 0) ASSERT_TRUE(outSet.getTree().getRoot()->isBlack(outSet.getTree().getRoot()));
+
+		// Same content and order
+		uint32 i = 0;
+		for (uint32 item : outSet) ASSERT_EQ(item, 3 * i++);
+		ASSERT_EQ(i, n);
+
+		for (uint32 j = 0; j < n; ++j)
+		{
+			String key = "key_";
+			key += j;
+
+			uint64 value = 0;
+			ASSERT_TRUE(outMap.find(key, value));
+			ASSERT_EQ(value, j);
+			ASSERT_TRUE(outSet.get(j * 3));
+		}
+
+		// Trees can be modified after loading
+		for (uint32 j = 0; j < n; j += 2) outSet.remove(j * 3);
+		for (uint32 j = 0; j < n; ++j) outSet.set(j * 3 + 1);
+		ASSERT_EQ(outSet.getCount(), n - (n + 1) / 2 + n);
+		ASSERT_GT(checkSerializedTree(outSet.getTree().getRoot()), 0);
+	}
+
+	// Unsorted data is rejected
+	{
+		Array<ubyte> bytes;
+		MemoryWriter writer{bytes};
+		writer << static_cast<uint64>(3) << 1u << 3u << 2u;
+
+		Set<uint32> outSet;
+		MemoryReader reader{bytes};
+		reader << outSet;
+		ASSERT_TRUE(reader.hasError());
+		ASSERT_EQ(outSet.getCount(), 0);
+	}
+}
+
+TEST(serialization, mapped)
+{
+	Array<uint64> numbers;
+	for (uint64 i = 0; i < 1000; ++i) numbers.add(i * 2);
+
+	Array<String> words;
+	words.add("foo");
+	words.add("");
+	words.add("a longer string");
+
+	Array<String> table;
+	table.add("apple");
+	table.add("banana");
+	table.add("cherry");
+	table.add("date");
+
+	Map<String, uint64> index;
+	for (uint64 i = 0; i < 100; ++i)
+	{
+		String key = "key_";
+		key += i;
+		index.insert(key, i);
+	}
+
+	Map<uint64, uint64> squares;
+	for (uint64 i = 256; i-- > 0;) squares.insert(i, i * i);
+
+	MappedImageWriter writer{3};
+	const uint64 root = writer.allocateRoot<MappedTestRoot>();
+	writer.at<MappedTestRoot>(root).tag = 0xabcd;
+	writer.writeArray(writer.getFieldPos(root, &MappedTestRoot::numbers), numbers);
+	writer.writeArray(writer.getFieldPos(root, &MappedTestRoot::words), words);
+	writer.writeStringTable(writer.getFieldPos(root, &MappedTestRoot::table), table);
+	writer.writeFlatMap(writer.getFieldPos(root, &MappedTestRoot::index), index);
+	writer.writeFlatMap(writer.getFieldPos(root, &MappedTestRoot::squares), squares);
+
+	const Array<ubyte> & bytes = writer.getBytes();
+
+	{
+		MappedImage image{*bytes, bytes.getCount()};
+		ASSERT_TRUE(image.isOpen());
+		ASSERT_EQ(image.getVersion(), 3);
+		checkMappedTestRoot(image.getRoot<MappedTestRoot>());
+
+		// Wrong root type
+		ASSERT_EQ(image.getRoot<uint64>(), nullptr);
+	}
+
+	// Image does not depend on its address
+	{
+		Array<ubyte> copy{bytes};
+		MappedImage image{*copy, copy.getCount()};
+		checkMappedTestRoot(image.getRoot<MappedTestRoot>());
+	}
+
+	// Truncated and corrupted images are
+	// rejected
+	{
+		MappedImage image{*bytes, bytes.getCount() - 8};
+		ASSERT_FALSE(image.isOpen());
+		ASSERT_EQ(image.getRoot<MappedTestRoot>(), nullptr);
+
+		Array<ubyte> copy{bytes};
+		copy[0] ^= 0xff;
+		ASSERT_FALSE(MappedImage(*copy, copy.getCount()).isOpen());
+	}
+
+	// Map image from file
+	{
+		const ansichar * path = "korin_test_mapped.bin";
+		ASSERT_TRUE(writer.save(path));
+
+		MappedImage image;
+		ASSERT_TRUE(image.open(path));
+		checkMappedTestRoot(image.getRoot<MappedTestRoot>());
+
+		MappedImage other{move(image)};
+		ASSERT_FALSE(image.isOpen());
+		checkMappedTestRoot(other.getRoot<MappedTestRoot>());
+
+		other.close();
+		ASSERT_TRUE(PlatformFiles::deleteFile(path));
+		ASSERT_FALSE(MappedImage{}.open(path));
+	}
+}
+
+TEST(serialization, char_finder)
+{
+	ansichar text[100];
+	for (uint32 i = 0; i < 100; ++i) text[i] = 'a' + i % 7;
+
+	for (const ansichar * chars : {"x", "x,", "x,;", "x,;\n"})
+	{
+		const CharFinder finder{chars};
+		for (uint32 i = 0; i < 100; ++i)
+		{
+			// Place each character of the set
+			// at every position
+			for (uint32 j = 0; chars[j] != '\0'; ++j)
+			{
+				const ansichar prev = text[i];
+				text[i] = chars[j];
+
+				ASSERT_TRUE(finder.has(chars[j]));
+				ASSERT_EQ(finder.find(text, text + 100), text + i);
+				ASSERT_EQ(finder.find(text + i + 1, text + 100), text + 100);
+				ASSERT_EQ(finder.find(text, text + i), text + i);
+
+				text[i] = prev;
+			}
+		}
+
+		ASSERT_FALSE(finder.has('a'));
+		ASSERT_EQ(finder.find(text, text), text);
+	}
+}
+
+TEST(serialization, string_splitter)
+{
+	Array<String> tokens;
+	StringView token;
+
+	StringSplitter fields{"a,,bc;d,", ",;"};
+	while (fields.next(token)) tokens.add(String{*token, token.getLength()});
+
+	ASSERT_EQ(tokens.getCount(), 5);
+	ASSERT_EQ(tokens[0], "a");
+	ASSERT_EQ(tokens[1], "");
+	ASSERT_EQ(tokens[2], "bc");
+	ASSERT_EQ(tokens[3], "d");
+	ASSERT_EQ(tokens[4], "");
+	ASSERT_TRUE(fields.getRemaining().isEmpty());
+
+	StringSplitter words{"one two three", " "};
+	ASSERT_TRUE(words.next(token));
+	ASSERT_EQ(token, "one");
+	ASSERT_EQ(words.getRemaining(), "two three");
+
+	// Empty input has one empty token
+	StringSplitter empty{"", ","};
+	ASSERT_TRUE(empty.next(token));
+	ASSERT_TRUE(token.isEmpty());
+	ASSERT_FALSE(empty.next(token));
+}
+
+TEST(serialization, record_reader)
+{
+	const ansichar * path = "korin_test_records.txt";
+
+	Array<String> lines;
+	for (uint32 i = 0; i < 200; ++i)
+	{
+		String line = i % 10 == 0 ? "ERROR " : "INFO ";
+		line += i;
+
+		// Some records are longer than the
+		// buffer
+		if (i % 50 == 7) for (uint32 j = 0; j < 10; ++j) line += " padding";
+
+		lines.add(line);
+	}
+
+	lines.add("");
+	lines.add("last");
+
+	{
+		File file{path, FileOpenMode::Write};
+		for (uint32 i = 0; i < lines.getCount(); ++i)
+		{
+			file.write(lines[i]);
+
+			// Windows line endings in some
+			// lines, no newline at the end
+			if (i % 3 == 0) file.write("\r");
+			if (i + 1 < lines.getCount()) file.write("\n");
+		}
+	}
+
+	{
+		File file{path};
+		RecordReader records{file, '\n', 16};
+
+		StringView record;
+		uint32 i = 0;
+		while (records.next(record))
+		{
+			ASSERT_LT(i, lines.getCount());
+			ASSERT_EQ(record, StringView{lines[i]});
+
+			// Records are terminated
+			ASSERT_EQ((*record)[record.getLength()], '\0');
+			++i;
+		}
+
+		ASSERT_EQ(i, lines.getCount());
+		ASSERT_EQ(records.getNumRecords(), lines.getCount());
+		ASSERT_FALSE(records.next(record));
+	}
+
+	// Feed records to a regex
+	{
+		File file{path};
+		RecordReader records{file};
+		Re::Regex regex{"ERROR \\d+"};
+
+		uint32 numErrors = 0;
+		StringView record;
+		while (records.next(record)) numErrors += regex.accept(*record);
+
+		ASSERT_EQ(numErrors, 20);
+	}
+
+	// Other delimiters keep carriage returns
+	{
+		File file{path};
+		RecordReader records{file, '\r'};
+
+		StringView record;
+		ASSERT_TRUE(records.next(record));
+		ASSERT_EQ(record, "ERROR 0");
+		ASSERT_TRUE(records.next(record));
+		ASSERT_EQ(record, "\nINFO 1\nINFO 2\nINFO 3");
+	}
+
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+}
+
+TEST(serialization, number_parser)
+{
+	int64 i;
+	ASSERT_TRUE(NumberParser::parse("0", i));
+	ASSERT_EQ(i, 0);
+	ASSERT_TRUE(NumberParser::parse("-42", i));
+	ASSERT_EQ(i, -42);
+	ASSERT_TRUE(NumberParser::parse("+7", i));
+	ASSERT_EQ(i, 7);
+	ASSERT_TRUE(NumberParser::parse("9223372036854775807", i));
+	ASSERT_EQ(i, 9223372036854775807ll);
+	ASSERT_TRUE(NumberParser::parse("-9223372036854775808", i));
+	ASSERT_EQ(i, -9223372036854775807ll - 1);
+	ASSERT_FALSE(NumberParser::parse("9223372036854775808", i));
+	ASSERT_FALSE(NumberParser::parse("99999999999999999999", i));
+	ASSERT_FALSE(NumberParser::parse("", i));
+	ASSERT_FALSE(NumberParser::parse("-", i));
+	ASSERT_FALSE(NumberParser::parse("12a", i));
+	ASSERT_FALSE(NumberParser::parse("1.0", i));
+
+	// Stops at the first invalid character
+	const ansichar * text = "123,456";
+	const ansichar * it = text;
+	ASSERT_TRUE(NumberParser::parseInt64(it, text + 7, i));
+	ASSERT_EQ(i, 123);
+	ASSERT_EQ(it, text + 3);
+
+	float64 f;
+	ASSERT_TRUE(NumberParser::parse("0.05", f));
+	ASSERT_EQ(f, 0.05);
+	ASSERT_TRUE(NumberParser::parse("-1.5e3", f));
+	ASSERT_EQ(f, -1500.0);
+	ASSERT_TRUE(NumberParser::parse(".5", f));
+	ASSERT_EQ(f, 0.5);
+	ASSERT_TRUE(NumberParser::parse("3.", f));
+	ASSERT_EQ(f, 3.0);
+	ASSERT_TRUE(NumberParser::parse("1E+2", f));
+	ASSERT_EQ(f, 100.0);
+	ASSERT_TRUE(NumberParser::parse("inf", f));
+	ASSERT_EQ(f, __builtin_inf());
+	ASSERT_TRUE(NumberParser::parse("-Infinity", f));
+	ASSERT_EQ(f, -__builtin_inf());
+	ASSERT_TRUE(NumberParser::parse("NaN", f));
+	ASSERT_NE(f, f);
+	ASSERT_FALSE(NumberParser::parse("", f));
+	ASSERT_FALSE(NumberParser::parse(".", f));
+	ASSERT_FALSE(NumberParser::parse("1e", f));
+	ASSERT_FALSE(NumberParser::parse("1.2.3", f));
+	ASSERT_FALSE(NumberParser::parse("abc", f));
+
+	// Matches strtod, on both the fast and
+	// the slow path
+	const ansichar * numbers[] = {
+		"3.141592653589793", "2.2250738585072014e-308", "1.7976931348623157e308", "123456789012345678901234567890",
+		"0.1", "1e22", "1e23", "9007199254740993", "0.000001234", "-0.0", "4.9e-324", "12345.6789e-10",
+		"1e999999", "-1e999999", "1e-999999", "0e99999999999999999999", "1e+0000000000000000000001"
+	};
+
+	for (const ansichar * number : numbers)
+	{
+		ASSERT_TRUE(NumberParser::parse(number, f));
+		ASSERT_EQ(f, ::strtod(number, nullptr)) << number;
+	}
+
+	uint64 seed = 1;
+	ansichar buffer[64];
+	for (uint32 n = 0; n < 10000; ++n)
+	{
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		const float64 value = static_cast<float64>(seed >> 11) / (1ull << (seed % 53));
+		::snprintf(buffer, sizeof(buffer), n % 2 ? "%.17g" : "%.6f", value);
+
+		ASSERT_TRUE(NumberParser::parse(buffer, f)) << buffer;
+		ASSERT_EQ(f, ::strtod(buffer, nullptr)) << buffer;
+	}
+
+	// The slow path ignores a comma decimal
+	// locale, if the host has one
+	for (const ansichar * name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "it_IT.UTF-8"})
+	{
+		if (!::setlocale(LC_NUMERIC, name)) continue;
+
+		const bool parsed = NumberParser::parse("3.1415926535897932384626", f);
+		::setlocale(LC_NUMERIC, "C");
+
+		ASSERT_TRUE(parsed);
+		ASSERT_EQ(f, 3.141592653589793);
+		break;
+	}
+}
+
+TEST(serialization, csv)
+{
+	const String text = "id,name,score,note\r\n"
+		"1,alice,3.5,\"hello, world\"\r\n"
+		"2,bob,4,\"say \"\"hi\"\"\"\n"
+		"\n"
+		"3,\"carol\",,\"multi\nline\"\n"
+		"-4,dave,1e2,";
+
+	CsvReader reader{text};
+	ASSERT_EQ(reader.getNumColumns(), 4);
+	ASSERT_EQ(reader.getName(0), "id");
+	ASSERT_EQ(reader.getName(3), "note");
+	ASSERT_EQ(reader.getType(0), CsvColumnType::Int64);
+	ASSERT_EQ(reader.getType(1), CsvColumnType::String);
+	ASSERT_EQ(reader.getType(2), CsvColumnType::Float64);
+	ASSERT_EQ(reader.getType(3), CsvColumnType::String);
+
+	CsvTable table;
+	reader.parse(table);
+
+	ASSERT_EQ(table.getNumRows(), 4);
+	ASSERT_EQ(table.getNumErrors(), 0);
+	ASSERT_EQ(table.findColumn("score"), 2);
+	ASSERT_EQ(table.findColumn("missing"), -1);
+
+	const Array<int64> & ids = table.getInts(0);
+	ASSERT_EQ(ids.getCount(), 4);
+	ASSERT_EQ(ids[0], 1);
+	ASSERT_EQ(ids[3], -4);
+
+	const Array<StringView> & names = table.getStrings(1);
+	ASSERT_EQ(names[0], "alice");
+	ASSERT_EQ(names[2], "carol");
+	ASSERT_EQ((*names[3])[names[3].getLength()], '\0');
+
+	const Array<float64> & scores = table.getFloats(2);
+	ASSERT_EQ(scores[0], 3.5);
+	ASSERT_EQ(scores[1], 4.0);
+	ASSERT_NE(scores[2], scores[2]);
+	ASSERT_EQ(scores[3], 100.0);
+
+	const Array<StringView> & notes = table.getStrings(3);
+	ASSERT_EQ(notes[0], "hello, world");
+	ASSERT_EQ(notes[1], "say \"hi\"");
+	ASSERT_EQ(notes[2], "multi\nline");
+	ASSERT_EQ(notes[3], "");
+
+	// Bad values and wrong number of fields
+	{
+		CsvReader reader{"a;b\n1;2\n3;x\n4\n5;6;7", ';'};
+		reader.setColumnType(1, CsvColumnType::Int64);
+
+		CsvTable table;
+		reader.parse(table);
+
+		ASSERT_EQ(table.getNumRows(), 4);
+		ASSERT_EQ(table.getNumErrors(), 3);
+		ASSERT_EQ(table.getInts(1)[0], 2);
+		ASSERT_EQ(table.getInts(1)[1], 0);
+		ASSERT_EQ(table.getInts(1)[2], 0);
+		ASSERT_EQ(table.getInts(1)[3], 6);
+	}
+
+	// No header
+	{
+		CsvReader reader{"1,x\n2,y\n", ',', false};
+		ASSERT_EQ(reader.getNumColumns(), 2);
+		ASSERT_EQ(reader.getName(0), "");
+
+		CsvTable table;
+		reader.parse(table);
+
+		ASSERT_EQ(table.getNumRows(), 2);
+		ASSERT_EQ(table.getStrings(1)[1], "y");
+	}
+}
+
+TEST(serialization, csv_parallel)
+{
+	// Long rows with quoted newlines and
+	// delimiters, that cross blocks
+	String text = "key,value,label\n";
+	for (uint32 i = 0; i < 20000; ++i)
+	{
+		text += static_cast<int64>(i);
+		text += ",";
+		text += static_cast<float64>(i) * 0.25;
+		text += i % 7 ? ",plain\n" : ",\"quoted,\n\"\"label\"\"\"\n";
+	}
+
+	CsvReader reader{text};
+
+	CsvTable serial;
+	reader.parse(serial);
+	ASSERT_EQ(serial.getNumRows(), 20000);
+	ASSERT_EQ(serial.getNumErrors(), 0);
+
+	for (uint32 numChunks : {1u, 3u, 8u, 100u})
+	{
+		Array<StringView> chunks;
+		reader.split(numChunks, chunks);
+		ASSERT_LE(chunks.getCount(), numChunks);
+
+		CsvTable tables[100];
+		std::thread threads[100];
+		for (uint32 i = 0; i < chunks.getCount(); ++i) threads[i] = std::thread{[&reader, &chunks, &tables, i]() {
+
+			reader.parse(chunks[i], tables[i]);
+		}};
+
+		for (uint32 i = 0; i < chunks.getCount(); ++i) threads[i].join();
+
+		CsvTable table;
+		for (uint32 i = 0; i < chunks.getCount(); ++i) table.append(move(tables[i]));
+
+		ASSERT_EQ(table.getNumRows(), 20000);
+		ASSERT_EQ(table.getNumErrors(), 0);
+
+		for (uint32 i = 0; i < 20000; ++i)
+		{
+			ASSERT_EQ(table.getInts(0)[i], i);
+			ASSERT_EQ(table.getFloats(1)[i], i * 0.25);
+			ASSERT_EQ(table.getStrings(2)[i], i % 7 ? "plain" : "quoted,\n\"label\"");
+		}
+	}
+}
+
+TEST(serialization, json_reader)
+{
+	const String text = R"({
+		"name": "korin",
+		"version": 3,
+		"ratio": -1.5e-3,
+		"enabled": true,
+		"missing": null,
+		"escaped": "a\"b\\c\n\u00e9\ud83d\ude00",
+		"tricky": "\\\\\"},[",
+		"items": [1, 2, 3, [4, 5], {"six": 6}],
+		"empty": {},
+		"tags": {"a": "x", "b": "y"}
+	})";
+
+	JsonReader reader;
+	ASSERT_TRUE(reader.parse(text));
+
+	const JsonValue root = reader.getRoot();
+	ASSERT_EQ(root.getType(), JsonType::Object);
+	ASSERT_EQ(root.getCount(), 10);
+
+	String name;
+	ASSERT_TRUE(root["name"].get(name));
+	ASSERT_EQ(name, "korin");
+	ASSERT_TRUE(root["name"].equals("korin"));
+
+	StringView view;
+	ASSERT_TRUE(root["name"].get(view));
+	ASSERT_EQ(view, "korin");
+	ASSERT_FALSE(root["escaped"].get(view));
+
+	ASSERT_EQ(root["version"].getOr(0ll), 3);
+	ASSERT_EQ(root["version"].getOr(0u), 3);
+	ASSERT_EQ(root["ratio"].getOr(0.0), -1.5e-3);
+	ASSERT_EQ(root["ratio"].getOr(7ll), 7);
+	ASSERT_TRUE(root["enabled"].getOr(false));
+	ASSERT_TRUE(root["missing"].isNull());
+	ASSERT_FALSE(root["nope"].isValid());
+	ASSERT_EQ(root["nope"]["deeper"].getOr(42ll), 42);
+
+	ASSERT_TRUE(root["escaped"].get(name));
+	ASSERT_EQ(name, "a\"b\\c\n\xc3\xa9\xf0\x9f\x98\x80");
+	ASSERT_TRUE(root["tricky"].get(name));
+	ASSERT_EQ(name, "\\\\\"},[");
+
+	const JsonValue items = root["items"];
+	ASSERT_EQ(items.getType(), JsonType::Array);
+	ASSERT_EQ(items.getCount(), 5);
+	ASSERT_EQ(items.getItem(1).getOr(0ll), 2);
+	ASSERT_EQ(items.getItem(3).getItem(1).getOr(0ll), 5);
+	ASSERT_EQ(items.getItem(4)["six"].getOr(0ll), 6);
+	ASSERT_FALSE(items.getItem(5).isValid());
+	ASSERT_EQ(items.getItem(3).getText(), "[4, 5]");
+
+	int64 sum = 0;
+	for (const JsonValue & item : items.getItems()) sum += item.getOr(0ll);
+	ASSERT_EQ(sum, 6);
+
+	ASSERT_EQ(root["empty"].getCount(), 0);
+	ASSERT_EQ(JsonValue{}.getCount(), 0);
+
+	// Into containers
+	Map<String, String> tags;
+	ASSERT_TRUE(root["tags"].get(tags));
+	ASSERT_EQ(tags.getCount(), 2);
+	ASSERT_EQ(tags["b"], "y");
+
+	Array<int64> ints;
+	ASSERT_FALSE(items.get(ints));
+	ASSERT_TRUE(items.getItem(3).get(ints));
+	ASSERT_EQ(ints.getCount(), 2);
+	ASSERT_EQ(ints[1], 5);
+
+	Optional<int64> maybe{1ll};
+	ASSERT_TRUE(root["missing"].get(maybe));
+	ASSERT_FALSE(maybe.hasValue());
+	ASSERT_TRUE(root["version"].get(maybe));
+	ASSERT_EQ(*maybe, 3);
+
+	// Scalar documents
+	ASSERT_TRUE(reader.parse("  42 "));
+	ASSERT_EQ(reader.getRoot().getOr(0ll), 42);
+	ASSERT_TRUE(reader.parse("\"x\""));
+	ASSERT_TRUE(reader.getRoot().equals("x"));
+
+	// Malformed documents
+	ASSERT_FALSE(reader.parse(""));
+	ASSERT_FALSE(reader.parse("{\"a\": 1"));
+	ASSERT_FALSE(reader.parse("[1, 2]]"));
+	ASSERT_FALSE(reader.parse("[1, 2}"));
+	ASSERT_FALSE(reader.parse("[\"abc]"));
+	ASSERT_FALSE(reader.parse("1 2"));
+	ASSERT_EQ(reader.getErrorPos(), 2);
+	ASSERT_FALSE(reader.parse("[1 2]"));
+	ASSERT_EQ(reader.getErrorPos(), 3);
+	ASSERT_FALSE(reader.parse("{1:2}"));
+	ASSERT_FALSE(reader.parse("[,,]"));
+	ASSERT_FALSE(reader.parse("{\"a\" \"b\"}"));
+	ASSERT_FALSE(reader.parse("{\"a\": 1,}"));
+	ASSERT_FALSE(reader.parse("[1, 2,]"));
+	ASSERT_FALSE(reader.parse("{\"a\": }"));
+	ASSERT_FALSE(reader.parse("{\"a\": 1 \"b\": 2}"));
+	ASSERT_FALSE(reader.parse("[\"a\": 1]"));
+	ASSERT_FALSE(reader.parse(":"));
+	ASSERT_TRUE(reader.parse("{\"a\": [], \"b\": {}, \"c\": [{\"d\": null}, \"e\"]}"));
+	ASSERT_FALSE(reader.parse("[1 2]"));
+	ASSERT_FALSE(reader.getRoot().isValid());
+}
+
+TEST(serialization, json_writer)
+{
+	Map<String, Array<int32>> groups;
+	groups["odd"] = Array<int32>{};
+	groups["odd"].add(1, 3, 5);
+	groups["even"] = Array<int32>{};
+
+	Array<Optional<float64>> values;
+	values.add(Optional<float64>{0.1});
+	values.add(Optional<float64>{});
+	values.add(Optional<float64>{-2.0});
+	values.add(Optional<float64>{__builtin_inf()});
+
+	String out;
+	{
+		JsonWriter json{out};
+		json.beginObject();
+		json.field("name", "say \"hi\"\n\x01");
+		json.field("count", -9223372036854775807ll - 1);
+		json.field("big", 18446744073709551615ull);
+		json.field("on", true);
+		json.field("groups", groups);
+		json.field("values", values);
+		json.key(7).beginArray().endArray();
+		json.endObject();
+	}
+
+	ASSERT_EQ(out, R"({"name":"say \"hi\"\n\u0001","count":-9223372036854775808,"big":18446744073709551615,"on":true,)"
+		R"("groups":{"even":[],"odd":[1,3,5]},"values":[0.1,null,-2,null],"7":[]})");
+
+	// Read back
+	JsonReader reader;
+	ASSERT_TRUE(reader.parse(out));
+
+	Map<String, Array<int32>> readGroups;
+	ASSERT_TRUE(reader.getRoot()["groups"].get(readGroups));
+	ASSERT_EQ(readGroups.getCount(), 2);
+	ASSERT_EQ(readGroups["odd"].getCount(), 3);
+	ASSERT_EQ(readGroups["odd"][2], 5);
+
+	Array<Optional<float64>> readValues;
+	ASSERT_TRUE(reader.getRoot()["values"].get(readValues));
+	ASSERT_EQ(readValues.getCount(), 4);
+	ASSERT_EQ(*readValues[0], 0.1);
+	ASSERT_FALSE(readValues[1].hasValue());
+
+	// Strings with random escapes, quotes
+	// and brackets that cross blocks
+	uint64 seed = 1;
+	for (uint32 n = 0; n < 200; ++n)
+	{
+		Array<String> strings;
+		for (uint32 i = 0; i < 20; ++i)
+		{
+			String str;
+			const uint32 length = (seed >> 40) % 100;
+			for (uint32 j = 0; j < length; ++j)
+			{
+				seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+				static const ansichar chars[] = "\\\"{}[],: ab\n\x01";
+				str += chars[(seed >> 33) % (sizeof(chars) - 1)];
+			}
+
+			strings.add(str);
+		}
+
+		String text;
+		{
+			JsonWriter json{text};
+			json.write(strings);
+		}
+
+		ASSERT_TRUE(reader.parse(text)) << *text;
+
+		Array<String> readStrings;
+		ASSERT_TRUE(reader.getRoot().get(readStrings));
+		ASSERT_EQ(readStrings.getCount(), strings.getCount());
+		for (uint32 i = 0; i < strings.getCount(); ++i) ASSERT_EQ(readStrings[i], strings[i]);
+	}
+
+	// Long output through a file
+	const ansichar * path = "korin_test_json.json";
+	{
+		File file{path, FileOpenMode::Write};
+		JsonWriter json{file};
+		json.beginArray();
+		for (int64 i = 0; i < 10000; ++i) json.write(i);
+		json.endArray();
+	}
+
+	{
+		File file{path};
+		String text;
+		file.readAll(text);
+
+		ASSERT_TRUE(reader.parse(text));
+		ASSERT_EQ(reader.getRoot().getCount(), 10000);
+		ASSERT_EQ(reader.getRoot().getItem(9999).getOr(0ll), 9999);
+	}
+
+	ASSERT_TRUE(PlatformFiles::deleteFile(path));
+}
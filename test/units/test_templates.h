@@ -5,6 +5,14 @@
 #include "templates/types.h"
 #include "templates/atomic.h"
 #include "templates/optional.h"
+#include "templates/function.h"
+#include "templates/spin_lock.h"
+#include "templates/hash.h"
+#include "containers/pair.h"
+#include "containers/tuple.h"
+#include "containers/string.h"
+#include "math/vec3.h"
+#include <thread>
 
 TEST(templates, types)
 {
@@ -153,3 +161,180 @@ TEST(templates, optional)
 
 	SUCCEED();
 }
+
+TEST(templates, function)
+{
+	int32 calls = 0;
+	Function<int32(int32)> fn = [&calls](int32 x) {
+
+		++calls;
+		return x * 2;
+	};
+
+	ASSERT_TRUE(fn);
+	ASSERT_EQ(fn(3), 6);
+
+	Function<int32(int32)> other;
+
+	ASSERT_FALSE(other);
+
+	other = move(fn);
+
+	ASSERT_TRUE(other);
+	ASSERT_FALSE(fn);
+	ASSERT_EQ(other(4), 8);
+	ASSERT_EQ(calls, 2);
+
+	// Assign over a bound function
+	other = Function<int32(int32)>{[](int32 x) { return x + 1; }};
+
+	ASSERT_EQ(other(4), 5);
+}
+
+TEST(templates, spinLock)
+{
+	SpinLock lock;
+
+	ASSERT_FALSE(lock.isLocked());
+	ASSERT_TRUE(lock.tryLock());
+	ASSERT_TRUE(lock.isLocked());
+	ASSERT_FALSE(lock.tryLock());
+
+	lock.unlock();
+
+	ASSERT_FALSE(lock.isLocked());
+
+	{
+		ScopeLock<SpinLock> scopeLock{lock};
+
+		ASSERT_TRUE(lock.isLocked());
+	}
+
+	ASSERT_FALSE(lock.isLocked());
+
+	// Protect a non-atomic counter
+	uint64 counter = 0;
+	std::thread threads[4];
+	for (auto & thread : threads)
+	{
+		thread = std::thread{[&lock, &counter]() {
+
+			for (uint32 i = 0; i < 100000; ++i)
+			{
+				ScopeLock<SpinLock> scopeLock{lock};
+				++counter;
+			}
+		}};
+	}
+
+	for (auto & thread : threads) thread.join();
+
+	ASSERT_EQ(counter, 400000);
+}
+
+TEST(templates, hash)
+{
+	ubyte bytes[4096];
+	uint64 seed = 0x2545f4914f6cdd1dull;
+	for (ubyte & byte : bytes)
+	{
+		seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+		byte = static_cast<ubyte>(seed);
+	}
+
+	// Deterministic, seed and length
+	// dependent
+	ASSERT_EQ(HashUtils::hashBytes(bytes, 100), HashUtils::hashBytes(bytes, 100));
+	ASSERT_NE(HashUtils::hashBytes(bytes, 100), HashUtils::hashBytes(bytes, 100, 1));
+	ASSERT_NE(HashUtils::hashBytes(bytes, 100), HashUtils::hashBytes(bytes, 99));
+	ASSERT_NE(HashUtils::hashBytes(bytes, 1000), HashUtils::hashBytes(bytes, 1000, 1));
+	ASSERT_NE(HashUtils::hashBytes(bytes, 0), HashUtils::hashBytes(bytes, 0, 1));
+
+#if HASH_USE_AVX2
+	// AVX2 and scalar long hashes agree
+	for (sizet length = HashUtils::longInputLength + 1; length <= sizeof(bytes); length += 37)
+	{
+		ASSERT_EQ(HashUtils::hashLongAvx2(bytes, length, length), HashUtils::hashLongScalar(bytes, length, length));
+	}
+#endif
+
+	// Avalanche: flipping one input bit
+	// flips each output bit with
+	// probability close to 1/2
+	const sizet lengths[] = {3, 8, 13, 16, 31, 48, 100, 256, 257, 1024, 4096};
+	for (sizet length : lengths)
+	{
+		uint32 numFlips[64] = {};
+		uint32 numSamples = 0;
+		for (uint32 i = 0; i < 64; ++i)
+		{
+			for (uint32 bit = 0; bit < length * 8; bit += (length * 8 + 63) / 64)
+			{
+				ubyte input[4096];
+				Memory::memcpy(input, bytes + i * 16, length > 4096 - i * 16 ? 4096 - i * 16 : length);
+				if (length > 4096 - i * 16) Memory::memcpy(input + 4096 - i * 16, bytes, length - (4096 - i * 16));
+
+				const uint64 hash = HashUtils::hashBytes(input, length);
+				input[bit / 8] ^= 1 << (bit % 8);
+				const uint64 diff = hash ^ HashUtils::hashBytes(input, length);
+
+				for (uint32 j = 0; j < 64; ++j) numFlips[j] += (diff >> j) & 1;
+				++numSamples;
+			}
+		}
+
+		for (uint32 j = 0; j < 64; ++j)
+		{
+			const float32 bias = static_cast<float32>(numFlips[j]) / numSamples;
+			ASSERT_GT(bias, 0.4f) << "length " << length << ", bit " << j;
+			ASSERT_LT(bias, 0.6f) << "length " << length << ", bit " << j;
+		}
+	}
+
+	// Integers
+	{
+		uint32 numFlips[64] = {};
+		for (uint64 i = 0; i < 256; ++i)
+		{
+			const uint64 value = i * 0x9e3779b97f4a7c15ull;
+			for (uint32 bit = 0; bit < 64; ++bit)
+			{
+				const uint64 diff = Hash<uint64>{}(value) ^ Hash<uint64>{}(value ^ (1ull << bit));
+				for (uint32 j = 0; j < 64; ++j) numFlips[j] += (diff >> j) & 1;
+			}
+		}
+
+		for (uint32 j = 0; j < 64; ++j)
+		{
+			const float32 bias = static_cast<float32>(numFlips[j]) / (256 * 64);
+			ASSERT_GT(bias, 0.45f);
+			ASSERT_LT(bias, 0.55f);
+		}
+	}
+
+	// Floating point
+	ASSERT_EQ(Hash<float32>{}(0.f), Hash<float32>{}(-0.f));
+	ASSERT_EQ(Hash<float64>{}(0.0), Hash<float64>{}(-0.0));
+	ASSERT_NE(Hash<float32>{}(1.f), Hash<float32>{}(2.f));
+
+	// Strings hash their characters
+	const String str = "hello, world";
+	ASSERT_EQ(Hash<String>{}(str), Hash<StringView>{}(StringView{"hello, world"}));
+	ASSERT_EQ(Hash<String>{}(str), HashUtils::hashBytes("hello, world", 12));
+	ASSERT_NE(Hash<String>{}(str), Hash<String>{}(String{"hello, World"}));
+
+	// Composite types depend on the
+	// order of the elements
+	using PairT = Pair<uint32, uint32>;
+	ASSERT_EQ(Hash<PairT>{}(PairT{1u, 2u}), HashUtils::hashValues(1u, 2u));
+	ASSERT_NE(Hash<PairT>{}(PairT{1u, 2u}), Hash<PairT>{}(PairT{2u, 1u}));
+
+	using TupleT = Tuple<uint32, String, float32>;
+	const TupleT tup{1u, String{"a"}, 2.f};
+	ASSERT_EQ(Hash<TupleT>{}(tup), HashUtils::hashValues(1u, String{"a"}, 2.f));
+	ASSERT_NE(Hash<TupleT>{}(tup), Hash<TupleT>{}(TupleT{1u, String{"b"}, 2.f}));
+
+	ASSERT_EQ(Hash<ivec3>{}(ivec3{1, 2, 3}), Hash<ivec3>{}(ivec3{1, 2, 3}));
+	ASSERT_NE(Hash<ivec3>{}(ivec3{1, 2, 3}), Hash<ivec3>{}(ivec3{3, 2, 1}));
+	ASSERT_NE(Hash<vec3>{}(vec3{1.f, 0.f, 0.f}), Hash<vec3>{}(vec3{0.f, 1.f, 0.f}));
+}